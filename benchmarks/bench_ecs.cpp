@@ -0,0 +1,50 @@
+#include "benchmark.h"
+
+#include "core/system/subsystem.h"
+#include "runtime/ecs/components/transform_component.h"
+#include "runtime/ecs/ecs.h"
+
+namespace bench
+{
+void bench_ecs()
+{
+	auto& ecs = core::add_subsystem<runtime::entity_component_system>();
+
+	const std::size_t entity_count = 10000;
+	std::vector<runtime::entity> entities;
+	entities.reserve(entity_count);
+	for(std::size_t i = 0; i < entity_count; ++i)
+	{
+		auto e = ecs.create();
+		e.assign<transform_component>().lock()->set_local_position(
+			{float(i % 100), 0.0f, float(i / 100)});
+		entities.push_back(e);
+	}
+
+	run("ecs/for_each 10k transform entities", 1000, [&ecs]() {
+		math::vec3 accum(0.0f, 0.0f, 0.0f);
+		ecs.for_each<transform_component>([&accum](runtime::entity, transform_component& t) {
+			accum += t.get_local_position();
+		});
+		do_not_optimize(accum);
+	});
+
+	run("ecs/create+destroy 1k empty entities", 1000, [&ecs]() {
+		runtime::entity created[1000];
+		for(auto& e : created)
+		{
+			e = ecs.create();
+		}
+		for(auto& e : created)
+		{
+			e.destroy();
+		}
+	});
+
+	for(auto& e : entities)
+	{
+		e.destroy();
+	}
+	core::remove_subsystem<runtime::entity_component_system>();
+}
+}
@@ -0,0 +1,44 @@
+#include "benchmark.h"
+
+#include "core/math/math_includes.h"
+
+#include <vector>
+
+namespace bench
+{
+void bench_frustum()
+{
+	math::transform view;
+	view.look_at({0.0f, 5.0f, -10.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f});
+	const math::transform proj =
+		math::perspectiveNO<float>(math::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+	const math::frustum frustum(view, proj, true);
+
+	// a grid of boxes straddling the frustum so all classification
+	// outcomes (inside / outside / intersect) are exercised
+	const std::size_t box_count = 4096;
+	std::vector<math::bbox> boxes;
+	boxes.reserve(box_count);
+	for(std::size_t i = 0; i < box_count; ++i)
+	{
+		const float x = float(i % 64) * 4.0f - 128.0f;
+		const float z = float(i / 64) * 4.0f - 128.0f;
+		boxes.emplace_back(math::vec3{x - 1.0f, -1.0f, z - 1.0f}, math::vec3{x + 1.0f, 1.0f, z + 1.0f});
+	}
+
+	std::vector<math::volume_query> results(box_count);
+
+	run("frustum/classify_aabb 4096 boxes", 1000, [&]() {
+		for(std::size_t i = 0; i < box_count; ++i)
+		{
+			results[i] = frustum.classify_aabb(boxes[i]);
+		}
+		do_not_optimize(results);
+	});
+
+	run("frustum/classify_aabb_batch 4096 boxes", 1000, [&]() {
+		frustum.classify_aabb_batch(boxes.data(), box_count, results.data());
+		do_not_optimize(results);
+	});
+}
+}
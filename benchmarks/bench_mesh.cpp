@@ -0,0 +1,106 @@
+#include "benchmark.h"
+
+#include "core/math/math_includes.h"
+#include "runtime/rendering/mesh.h"
+
+#include <vector>
+
+namespace bench
+{
+namespace
+{
+struct canned_sphere
+{
+	std::vector<std::uint8_t> vertex_data;
+	std::uint32_t vertex_count = 0;
+	mesh::triangle_array_t triangles;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : build_canned_sphere () (Local)
+/// <summary>
+/// Generates the same uv-sphere data mesh::create_sphere would feed the
+/// preparation pipeline, packed into the given vertex format, so the
+/// benchmark exercises prepare/weld/optimize on deterministic input.
+/// </summary>
+//-----------------------------------------------------------------------------
+canned_sphere build_canned_sphere(const gfx::vertex_layout& format, std::uint32_t stacks,
+								  std::uint32_t slices)
+{
+	canned_sphere data;
+	data.vertex_count = (slices + 1) * (stacks + 1);
+
+	const std::uint16_t stride = format.getStride();
+	data.vertex_data.resize(data.vertex_count * stride);
+
+	std::uint8_t* vertex_ptr = data.vertex_data.data();
+	for(std::uint32_t stack = 0; stack <= stacks; ++stack)
+	{
+		for(std::uint32_t slice = 0; slice <= slices; ++slice)
+		{
+			const float a = (math::pi<float>() / float(stacks)) * float(stack);
+			const float b = (math::two_pi<float>() / float(slices)) * float(slice);
+			const float xz = math::sin(a);
+
+			math::vec3 normal(xz * math::sin(b), math::cos(a), xz * math::cos(b));
+			math::vec3 position = normal * 0.5f;
+			math::vec2 texcoord(float(slice) / float(slices), float(stack) / float(stacks));
+
+			if(format.has(gfx::attribute::Position))
+				gfx::vertex_pack(&position[0], false, gfx::attribute::Position, format, vertex_ptr);
+			if(format.has(gfx::attribute::Normal))
+				gfx::vertex_pack(&normal[0], true, gfx::attribute::Normal, format, vertex_ptr);
+			if(format.has(gfx::attribute::TexCoord0))
+				gfx::vertex_pack(&texcoord[0], true, gfx::attribute::TexCoord0, format, vertex_ptr);
+
+			vertex_ptr += stride;
+		}
+	}
+
+	data.triangles.reserve((slices * stacks) * 2);
+	for(std::uint32_t stack = 0; stack < stacks; ++stack)
+	{
+		for(std::uint32_t slice = 0; slice < slices; ++slice)
+		{
+			mesh::triangle tri;
+			tri.indices[0] = (stack * (slices + 1)) + slice;
+			tri.indices[1] = ((stack + 1) * (slices + 1)) + slice;
+			tri.indices[2] = (stack * (slices + 1)) + slice + 1;
+			data.triangles.push_back(tri);
+
+			tri.indices[0] = ((stack + 1) * (slices + 1)) + slice;
+			tri.indices[1] = ((stack + 1) * (slices + 1)) + slice + 1;
+			tri.indices[2] = (stack * (slices + 1)) + slice + 1;
+			data.triangles.push_back(tri);
+		}
+	}
+	return data;
+}
+}
+
+void bench_mesh()
+{
+	const auto& format = gfx::mesh_vertex::get_layout();
+	auto sphere = build_canned_sphere(format, 50, 50);
+
+	// build_buffers=false keeps the run on the cpu preparation path -
+	// no renderer is initialized in this process
+	run("mesh/prepare 5k-tri sphere (weld+optimize)", 100, [&]() {
+		mesh m;
+		m.prepare_mesh(format);
+		m.set_vertex_source(sphere.vertex_data.data(), sphere.vertex_count, format);
+		m.add_primitives(sphere.triangles);
+		m.end_prepare(true, true, true, false);
+		do_not_optimize(m);
+	});
+
+	run("mesh/prepare 5k-tri sphere (no optimize)", 100, [&]() {
+		mesh m;
+		m.prepare_mesh(format);
+		m.set_vertex_source(sphere.vertex_data.data(), sphere.vertex_count, format);
+		m.add_primitives(sphere.triangles);
+		m.end_prepare(true, false, false, false);
+		do_not_optimize(m);
+	});
+}
+}
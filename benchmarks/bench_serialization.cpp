@@ -0,0 +1,88 @@
+#include "benchmark.h"
+
+#include "core/serialization/associative_archive.h"
+#include "core/serialization/binary_archive.h"
+#include "core/serialization/serialization.h"
+#include "core/serialization/types/string.hpp"
+#include "core/serialization/types/vector.hpp"
+
+#include <sstream>
+#include <vector>
+
+namespace bench
+{
+namespace
+{
+// representative of the small component records the scene formats are
+// full of - a handful of scalars, a name and a short array
+struct record
+{
+	std::uint32_t id = 0;
+	float x = 0.0f;
+	float y = 0.0f;
+	float z = 0.0f;
+	std::string name;
+	std::vector<float> weights;
+};
+
+template <typename Archive>
+void serialize(Archive& ar, record& obj)
+{
+	ar(cereal::make_nvp("id", obj.id));
+	ar(cereal::make_nvp("x", obj.x));
+	ar(cereal::make_nvp("y", obj.y));
+	ar(cereal::make_nvp("z", obj.z));
+	ar(cereal::make_nvp("name", obj.name));
+	ar(cereal::make_nvp("weights", obj.weights));
+}
+
+std::vector<record> make_records(std::size_t count)
+{
+	std::vector<record> records(count);
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		auto& obj = records[i];
+		obj.id = std::uint32_t(i);
+		obj.x = float(i) * 0.25f;
+		obj.y = float(i) * 0.5f;
+		obj.z = float(i) * 0.75f;
+		obj.name = "record_" + std::to_string(i);
+		obj.weights = {0.1f, 0.2f, 0.3f, 0.4f};
+	}
+	return records;
+}
+}
+
+void bench_serialization()
+{
+	auto records = make_records(1000);
+
+	run("serialization/binary round-trip 1k records", 100, [&]() {
+		std::stringstream stream;
+		{
+			cereal::oarchive_binary_t ar(stream);
+			ar(records);
+		}
+		std::vector<record> loaded;
+		{
+			cereal::iarchive_binary_t ar(stream);
+			ar(loaded);
+		}
+		do_not_optimize(loaded);
+	});
+
+	run("serialization/associative round-trip 1k records", 100, [&]() {
+		std::stringstream stream;
+		{
+			cereal::oarchive_associative_t ar(stream);
+			ar(records);
+		}
+		std::vector<record> loaded;
+		{
+			cereal::iarchive_associative_t ar(stream);
+			ar(loaded);
+		}
+		do_not_optimize(loaded);
+	});
+}
+}
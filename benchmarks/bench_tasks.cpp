@@ -0,0 +1,30 @@
+#include "benchmark.h"
+
+#include "core/tasks/task_system.h"
+
+#include <atomic>
+
+namespace bench
+{
+void bench_tasks()
+{
+	core::task_system ts;
+
+	run("tasks/round-trip latency (push + wait)", 10000, [&]() {
+		auto future = ts.push_on_worker_thread([]() {});
+		future.wait();
+	});
+
+	run("tasks/dispatch throughput 1k empty tasks", 100, [&]() {
+		std::atomic<std::size_t> remaining{1000};
+		for(std::size_t i = 0; i < 1000; ++i)
+		{
+			ts.push_on_worker_thread([&remaining]() { remaining.fetch_sub(1, std::memory_order_relaxed); });
+		}
+		while(remaining.load(std::memory_order_relaxed) != 0)
+		{
+			// spin - the cost being measured is the queue, not the waiter
+		}
+	});
+}
+}
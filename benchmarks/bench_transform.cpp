@@ -0,0 +1,54 @@
+#include "benchmark.h"
+
+#include "core/system/subsystem.h"
+#include "runtime/ecs/components/transform_component.h"
+#include "runtime/ecs/ecs.h"
+
+namespace bench
+{
+void bench_transform()
+{
+	auto& ecs = core::add_subsystem<runtime::entity_component_system>();
+
+	// one deep parent chain - the worst case for resolve, every world
+	// transform depends on the full ancestor path
+	const std::size_t depth = 512;
+	std::vector<runtime::entity> chain;
+	chain.reserve(depth);
+
+	auto root = ecs.create();
+	root.assign<transform_component>();
+	chain.push_back(root);
+	for(std::size_t i = 1; i < depth; ++i)
+	{
+		auto e = ecs.create();
+		e.assign<transform_component>().lock()->set_parent(chain.back()).set_local_position(
+			{0.0f, 1.0f, 0.0f});
+		chain.push_back(e);
+	}
+
+	auto root_transform = root.get_component<transform_component>().lock();
+	auto leaf_transform = chain.back().get_component<transform_component>().lock();
+
+	run("transform/resolve 512-deep dirty chain", 10000, [&]() {
+		// moving the root invalidates every descendant; reading the leaf
+		// world transform forces the full chain to resolve
+		root_transform->set_local_position({0.0f, 0.0f, 0.0f});
+		const auto& world = leaf_transform->get_transform();
+		do_not_optimize(world);
+	});
+
+	run("transform/resolve 512-deep clean chain", 10000, [&]() {
+		const auto& world = leaf_transform->get_transform();
+		do_not_optimize(world);
+	});
+
+	root_transform.reset();
+	leaf_transform.reset();
+	for(auto it = chain.rbegin(); it != chain.rend(); ++it)
+	{
+		it->destroy();
+	}
+	core::remove_subsystem<runtime::entity_component_system>();
+}
+}
@@ -0,0 +1,36 @@
+#include "benchmark.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace bench
+{
+void run(const char* name, std::size_t iterations, const std::function<void()>& fn)
+{
+	using clock_t = std::chrono::steady_clock;
+
+	// warm caches and fault in any lazily initialized state
+	fn();
+
+	const auto start = clock_t::now();
+	for(std::size_t i = 0; i < iterations; ++i)
+	{
+		fn();
+	}
+	const auto elapsed = clock_t::now() - start;
+
+	const double total_ms = std::chrono::duration<double, std::milli>(elapsed).count();
+	const double ns_per_iter =
+		std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+
+	std::printf("%-48s %12.3f ms %16.1f ns/iter\n", name, total_ms, ns_per_iter);
+}
+
+#if defined(_MSC_VER)
+#pragma optimize("", off)
+void sink(const void*)
+{
+}
+#pragma optimize("", on)
+#endif
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace bench
+{
+//-----------------------------------------------------------------------------
+//  Name : run ()
+/// <summary>
+/// Runs 'fn' once to warm caches, then 'iterations' timed repetitions,
+/// and prints the total time and the per-iteration cost. Keep the work
+/// inside 'fn' deterministic so runs are comparable between commits.
+/// </summary>
+//-----------------------------------------------------------------------------
+void run(const char* name, std::size_t iterations, const std::function<void()>& fn);
+
+//-----------------------------------------------------------------------------
+//  Name : do_not_optimize ()
+/// <summary>
+/// Forces the compiler to consider 'value' used so benchmark loops whose
+/// results are otherwise dead do not get optimized away.
+/// </summary>
+//-----------------------------------------------------------------------------
+#if defined(_MSC_VER)
+void sink(const void* ptr);
+
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+	sink(&value);
+}
+#else
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+	asm volatile("" : : "g"(&value) : "memory");
+}
+#endif
+
+// benchmark suites, one per translation unit
+void bench_ecs();
+void bench_frustum();
+void bench_transform();
+void bench_mesh();
+void bench_serialization();
+void bench_tasks();
+}
@@ -0,0 +1,33 @@
+#include "benchmark.h"
+
+#include "core/logging/logging.h"
+#include "core/system/subsystem.h"
+#include "runtime/ecs/ecs.h"
+
+#include <cstdio>
+
+int main(int /*argc*/, char* /*argv*/ [])
+{
+	// Mirror the minimal engine bootstrap the benchmarked code expects -
+	// a logger for the error paths and a frame getter for component touch
+	// tracking. No renderer, no windows.
+	auto logging_container = logging::get_mutable_logging_container();
+	logging_container->add_sink(std::make_shared<logging::sinks::platform_sink_mt>());
+	logging::create(APPLOG, logging_container);
+
+	runtime::ecs::set_frame_getter([]() { return std::uint64_t(0); });
+
+	core::details::initialize();
+
+	std::printf("%-48s %15s %24s\n", "benchmark", "total", "per iteration");
+
+	bench::bench_ecs();
+	bench::bench_frustum();
+	bench::bench_transform();
+	bench::bench_mesh();
+	bench::bench_serialization();
+	bench::bench_tasks();
+
+	core::details::dispose();
+	return 0;
+}
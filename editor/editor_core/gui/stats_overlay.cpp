@@ -0,0 +1,78 @@
+#include "stats_overlay.h"
+#include "gui.h"
+
+namespace gui
+{
+void draw_stats_overlay(const stats_snapshot& stats)
+{
+	const float margin = 10.0f;
+	const auto display_size = GetIO().DisplaySize;
+	SetNextWindowPos(ImVec2(display_size.x - margin, margin + GetFrameHeightWithSpacing()),
+					 ImGuiCond_Always, ImVec2(1.0f, 0.0f));
+
+	PushStyleColor(ImGuiCol_WindowBg, ImVec4(0.0f, 0.0f, 0.0f, 0.6f));
+	if(Begin("STATISTICS", nullptr,
+			 ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove |
+				 ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_AlwaysAutoResize |
+				 ImGuiWindowFlags_NoFocusOnAppearing))
+	{
+		Text("FRAME %.2f ms (%.0f fps)", double(stats.frame_time_ms),
+			 stats.frame_time_ms > 0.0f ? 1000.0 / double(stats.frame_time_ms) : 0.0);
+		Text("DRAWS %u  TRIS %llu", stats.draw_calls,
+			 static_cast<unsigned long long>(stats.triangles));
+		Text("ASSET LOADS IN FLIGHT %u  UPLOADS PENDING %u",
+			 static_cast<unsigned>(stats.asset_loads_in_flight),
+			 static_cast<unsigned>(stats.asset_uploads_pending));
+
+		for(const auto& line : stats.imports)
+		{
+			Text("IMPORT %s  %s %3.0f%%", line.name.c_str(), line.stage.c_str(),
+				 double(line.progress) * 100.0);
+		}
+
+		if(!stats.cpu_samples.empty())
+		{
+			Separator();
+			Text("CPU");
+			std::uint32_t current_thread = stats.cpu_samples.front().thread_index + 1;
+			for(const auto& line : stats.cpu_samples)
+			{
+				if(line.thread_index != current_thread)
+				{
+					current_thread = line.thread_index;
+					Text("thread %u", current_thread);
+				}
+				Text("%*s%s  %.3f ms  x%u", int(line.depth + 1) * 2, "", line.name.c_str(),
+					 line.total_ms, line.call_count);
+			}
+		}
+
+		if(!stats.gpu_passes.empty())
+		{
+			Separator();
+			Text("GPU");
+			for(const auto& pass : stats.gpu_passes)
+			{
+				Text("  %s  %.3f ms (cpu %.3f ms) x%u", pass.name.c_str(), pass.gpu_time_ms,
+					 pass.cpu_time_ms, pass.pass_count);
+			}
+		}
+
+		if(!stats.task_queues.empty())
+		{
+			Separator();
+			Text("TASKS");
+			for(std::size_t i = 0; i < stats.task_queues.size(); ++i)
+			{
+				const auto& queue = stats.task_queues[i];
+				// queue 0 is the owner thread in the task system's layout
+				Text("  %s %u  pending %u  busy %3.0f%%", i == 0 ? "owner " : "worker",
+					 static_cast<unsigned>(i), static_cast<unsigned>(queue.pending),
+					 queue.utilization * 100.0);
+			}
+		}
+	}
+	End();
+	PopStyleColor();
+}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gui
+{
+//-----------------------------------------------------------------------------
+//  Name : stats_snapshot (Struct)
+/// <summary>
+/// One frame's worth of runtime statistics for the overlay. Plain data -
+/// the caller fills it from whatever engine services it has, so the
+/// drawing code stays free of engine dependencies and any build with the
+/// imgui integration can show the overlay.
+/// </summary>
+//-----------------------------------------------------------------------------
+struct stats_snapshot
+{
+	/// one aggregated cpu profiler node
+	struct profiler_line
+	{
+		std::string name;
+		std::uint32_t depth = 0;
+		std::uint32_t thread_index = 0;
+		std::uint32_t call_count = 0;
+		double total_ms = 0.0;
+	};
+
+	/// one render pass name with its resolved timings
+	struct gpu_pass_line
+	{
+		std::string name;
+		double gpu_time_ms = 0.0;
+		double cpu_time_ms = 0.0;
+		std::uint32_t pass_count = 0;
+	};
+
+	/// one in-flight asset import with its progress
+	struct import_line
+	{
+		std::string name;
+		std::string stage;
+		/// 0..1
+		float progress = 0.0f;
+	};
+
+	/// one task system queue
+	struct task_queue_line
+	{
+		std::size_t pending = 0;
+		/// 0..1, fraction of the sampled interval spent running tasks
+		double utilization = 0.0;
+	};
+
+	float frame_time_ms = 0.0f;
+	std::uint32_t draw_calls = 0;
+	std::uint64_t triangles = 0;
+	std::size_t asset_loads_in_flight = 0;
+	std::size_t asset_uploads_pending = 0;
+	std::vector<import_line> imports;
+	std::vector<profiler_line> cpu_samples;
+	std::vector<gpu_pass_line> gpu_passes;
+	std::vector<task_queue_line> task_queues;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : draw_stats_overlay ()
+/// <summary>
+/// Draws the statistics overlay as a semi-transparent window in the top
+/// right corner of the current context.
+/// </summary>
+//-----------------------------------------------------------------------------
+void draw_stats_overlay(const stats_snapshot& stats);
+}
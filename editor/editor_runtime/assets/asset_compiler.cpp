@@ -1,10 +1,8 @@
 #include "asset_compiler.h"
 #include "../assets/mesh_importer.h"
-#include "bx/error.h"
-#include "bx/process.h"
-#include "bx/string.h"
 #include "core/audio/loaders/loader.h"
 #include "core/audio/sound.h"
+#include "core/filesystem/chunked_reader.h"
 #include "core/filesystem/filesystem.h"
 #include "core/graphics/graphics.h"
 #include "core/graphics/shader.h"
@@ -17,81 +15,535 @@
 #include "core/serialization/types/unordered_map.hpp"
 #include "core/serialization/types/vector.hpp"
 #include "core/string_utils/string_utils.h"
+#include "core/system/subsystem.h"
+#include "core/tasks/task_system.h"
 #include "core/uuid/uuid.hpp"
 #include "runtime/assets/impl/asset_extensions.h"
+#include "runtime/ecs/components/model_component.h"
+#include "runtime/ecs/components/transform_component.h"
 #include "runtime/ecs/constructs/prefab.h"
 #include "runtime/ecs/constructs/scene.h"
+#include "runtime/ecs/constructs/utils.h"
 #include "runtime/meta/animation/animation.hpp"
 #include "runtime/meta/audio/sound.hpp"
 #include "runtime/meta/rendering/material.hpp"
 #include "runtime/meta/rendering/mesh.hpp"
+#include "runtime/rendering/mesh_tools.h"
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cstring>
 #include <fstream>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#if $on($windows)
+#include <windows.h>
+#else
+#include <cerrno>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
 
 namespace project_compiler
 {
+namespace
+{
+/// guards the active import table
+std::mutex import_progress_mutex;
+/// imports currently in flight, in start order
+std::vector<import_progress> active_imports;
+
+//-----------------------------------------------------------------------------
+//  Name : scoped_import_progress (Class)
+/// <summary>
+/// Registers one import in the active table for its lifetime and relays
+/// progress updates into it, so the UI can poll get_active_imports.
+/// </summary>
+//-----------------------------------------------------------------------------
+class scoped_import_progress
+{
+public:
+	scoped_import_progress(const std::string& name)
+		: _name(name)
+	{
+		std::lock_guard<std::mutex> lock(import_progress_mutex);
+		import_progress entry;
+		entry.name = _name;
+		active_imports.push_back(std::move(entry));
+	}
+
+	~scoped_import_progress()
+	{
+		std::lock_guard<std::mutex> lock(import_progress_mutex);
+		auto it = std::find_if(std::begin(active_imports), std::end(active_imports),
+							   [this](const import_progress& entry) { return entry.name == _name; });
+		if(it != std::end(active_imports))
+		{
+			active_imports.erase(it);
+		}
+	}
+
+	void update(float progress, const std::string& stage) const
+	{
+		std::lock_guard<std::mutex> lock(import_progress_mutex);
+		for(auto& entry : active_imports)
+		{
+			if(entry.name == _name)
+			{
+				entry.progress = progress;
+				entry.stage = stage;
+				break;
+			}
+		}
+	}
+
+private:
+	/// table key - the source file name
+	std::string _name;
+};
+}
+
+std::vector<import_progress> get_active_imports()
+{
+	std::lock_guard<std::mutex> lock(import_progress_mutex);
+	return active_imports;
+}
+
+#if $on($windows)
 static std::string escape_str(const std::string& str)
 {
 	return "\"" + str + "\"";
 }
+#endif
 
+//-----------------------------------------------------------------------------
+//  Name : run_compile_process ()
+/// <summary>
+/// Runs one of the external compile tools to completion and captures its
+/// combined output. The tool is spawned directly rather than through the
+/// platform shell, so each compile pays for exactly one process startup -
+/// that startup is most of the cost of a small shader compile, and the
+/// shell intermediary used to double it.
+/// </summary>
+//-----------------------------------------------------------------------------
 static bool run_compile_process(const std::string& process, const std::vector<std::string>& args_array,
 								std::string& err)
 {
+	auto executable_dir = fs::resolve_protocol("binary:/");
+	auto process_full = executable_dir / process;
 
-	std::string args;
-	size_t i = 0;
+	std::string output;
+	int exit_code = -1;
+
+#if $on($windows)
+	std::string cmd = escape_str(process_full.string());
 	for(const auto& arg : args_array)
 	{
-		if(arg.front() == '-')
-		{
-			args += arg;
-		}
-		else
-		{
-			args += escape_str(arg);
-		}
+		cmd += " ";
+		cmd += arg.front() == '-' ? arg : escape_str(arg);
+	}
+
+	SECURITY_ATTRIBUTES security_attributes;
+	std::memset(&security_attributes, 0, sizeof(security_attributes));
+	security_attributes.nLength = sizeof(security_attributes);
+	security_attributes.bInheritHandle = TRUE;
 
-		if(i++ != args_array.size() - 1)
-			args += " ";
+	HANDLE pipe_read = nullptr;
+	HANDLE pipe_write = nullptr;
+	if(FALSE == CreatePipe(&pipe_read, &pipe_write, &security_attributes, 0))
+	{
+		err = "Failed to create output pipe for " + process;
+		return false;
 	}
+	SetHandleInformation(pipe_read, HANDLE_FLAG_INHERIT, 0);
 
-	bx::Error error;
-	bx::ProcessReader process_reader;
+	STARTUPINFOA startup_info;
+	std::memset(&startup_info, 0, sizeof(startup_info));
+	startup_info.cb = sizeof(startup_info);
+	startup_info.dwFlags = STARTF_USESTDHANDLES;
+	startup_info.hStdOutput = pipe_write;
+	startup_info.hStdError = pipe_write;
 
-	auto executable_dir = fs::resolve_protocol("binary:/");
-	auto process_full = executable_dir / process;
-#if($on($windows))
-	process_reader.open((process_full.string() + " " + args).c_str(), "", &error);
+	PROCESS_INFORMATION process_info;
+	std::memset(&process_info, 0, sizeof(process_info));
+
+	std::vector<char> cmd_buffer(cmd.begin(), cmd.end());
+	cmd_buffer.push_back('\0');
+	if(FALSE == CreateProcessA(nullptr, cmd_buffer.data(), nullptr, nullptr, TRUE, CREATE_NO_WINDOW,
+							   nullptr, nullptr, &startup_info, &process_info))
+	{
+		CloseHandle(pipe_write);
+		CloseHandle(pipe_read);
+		err = "Failed to launch " + process;
+		return false;
+	}
+	CloseHandle(pipe_write);
+
+	std::array<char, 2048> buffer;
+	DWORD read_bytes = 0;
+	while(FALSE != ReadFile(pipe_read, buffer.data(), DWORD(buffer.size()), &read_bytes, nullptr) &&
+		  read_bytes > 0)
+	{
+		output.append(buffer.data(), std::size_t(read_bytes));
+	}
+	CloseHandle(pipe_read);
+
+	WaitForSingleObject(process_info.hProcess, INFINITE);
+	DWORD windows_exit_code = DWORD(-1);
+	GetExitCodeProcess(process_info.hProcess, &windows_exit_code);
+	exit_code = int(windows_exit_code);
+	CloseHandle(process_info.hThread);
+	CloseHandle(process_info.hProcess);
 #else
-	process_reader.open(process_full.string().c_str(), args.c_str(), &error);
+	std::vector<std::string> argv_storage;
+	argv_storage.reserve(args_array.size() + 1);
+	argv_storage.push_back(process_full.string());
+	argv_storage.insert(std::end(argv_storage), std::begin(args_array), std::end(args_array));
+
+	std::vector<char*> argv;
+	argv.reserve(argv_storage.size() + 1);
+	for(auto& arg : argv_storage)
+	{
+		argv.push_back(const_cast<char*>(arg.c_str()));
+	}
+	argv.push_back(nullptr);
+
+	int pipe_fds[2] = {-1, -1};
+	if(0 != pipe(pipe_fds))
+	{
+		err = "Failed to create output pipe for " + process;
+		return false;
+	}
+
+	posix_spawn_file_actions_t file_actions;
+	posix_spawn_file_actions_init(&file_actions);
+	posix_spawn_file_actions_adddup2(&file_actions, pipe_fds[1], STDOUT_FILENO);
+	posix_spawn_file_actions_adddup2(&file_actions, pipe_fds[1], STDERR_FILENO);
+	posix_spawn_file_actions_addclose(&file_actions, pipe_fds[0]);
+	posix_spawn_file_actions_addclose(&file_actions, pipe_fds[1]);
+
+	pid_t pid = -1;
+	const int spawn_result = posix_spawn(&pid, argv[0], &file_actions, nullptr, argv.data(), environ);
+	posix_spawn_file_actions_destroy(&file_actions);
+	close(pipe_fds[1]);
+
+	if(0 != spawn_result)
+	{
+		close(pipe_fds[0]);
+		err = "Failed to launch " + process;
+		return false;
+	}
+
+	std::array<char, 2048> buffer;
+	ssize_t read_bytes = 0;
+	while((read_bytes = read(pipe_fds[0], buffer.data(), buffer.size())) > 0)
+	{
+		output.append(buffer.data(), std::size_t(read_bytes));
+	}
+	close(pipe_fds[0]);
+
+	int status = 0;
+	while(waitpid(pid, &status, 0) < 0 && errno == EINTR)
+	{
+	}
+	exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
 #endif
-	if(!error.isOk())
+
+	if(0 != exit_code)
 	{
-		err = std::string(error.getMessage().getPtr());
+		err = process + " exited with code " + std::to_string(exit_code);
+		if(!output.empty())
+		{
+			err += " " + output;
+		}
 		return false;
 	}
-	else
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : hash_files ()
+/// <summary>
+/// 64 bit FNV-1a over the contents of the specified files, in order.
+/// Missing files mix in a marker so appearing or disappearing inputs
+/// change the hash.
+/// </summary>
+//-----------------------------------------------------------------------------
+static std::uint64_t hash_files(const std::vector<fs::path>& files)
+{
+	std::uint64_t hash = 0xCBF29CE484222325ull;
+	const auto mix = [&hash](const char* data, std::size_t size) {
+		for(std::size_t i = 0; i < size; ++i)
+		{
+			hash ^= static_cast<std::uint8_t>(data[i]);
+			hash *= 0x100000001B3ull;
+		}
+	};
+
+	std::array<char, 65536> buffer;
+	for(const auto& file : files)
 	{
-		std::array<char, 2048> buffer;
-		buffer.fill(0);
-		int32_t sz = process_reader.read(buffer.data(), static_cast<std::int32_t>(buffer.size()), &error);
+		std::ifstream stream(file.string(), std::ios::in | std::ios::binary);
+		if(!stream.good())
+		{
+			const char missing = '\0';
+			mix(&missing, 1);
+			continue;
+		}
 
-		process_reader.close();
-		int32_t result = process_reader.getExitCode();
+		while(stream)
+		{
+			stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			mix(buffer.data(), static_cast<std::size_t>(stream.gcount()));
+		}
+	}
+	return hash;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : is_up_to_date ()
+/// <summary>
+/// Returns whether the compiled output exists and was produced from
+/// sources hashing to the value recorded next to it ('<output>.hash').
+/// Timestamps play no part, so touched-but-unchanged files - a git
+/// checkout - do not recompile. The computed hash is returned so a
+/// subsequent compile can record it.
+/// </summary>
+//-----------------------------------------------------------------------------
+static bool is_up_to_date(const fs::path& output, const std::vector<fs::path>& sources,
+						  std::uint64_t& out_hash)
+{
+	out_hash = hash_files(sources);
+
+	fs::error_code err;
+	if(!fs::exists(output, err))
+		return false;
 
-		if(0 != result)
+	fs::path hash_file = output;
+	hash_file += ".hash";
+
+	std::ifstream stream(hash_file.string());
+	if(!stream.good())
+		return false;
+
+	std::uint64_t recorded = 0;
+	stream >> recorded;
+	return stream && recorded == out_hash;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : write_hash ()
+/// <summary>
+/// Records the source hash the compiled output was produced from.
+/// </summary>
+//-----------------------------------------------------------------------------
+static void write_hash(const fs::path& output, std::uint64_t hash)
+{
+	fs::path hash_file = output;
+	hash_file += ".hash";
+
+	std::ofstream stream(hash_file.string(), std::ios::out | std::ios::trunc);
+	stream << hash;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : parse_shader_includes ()
+/// <summary>
+/// Collects the transitive '#include' closure of a shader source file.
+/// Includes resolve against the including file's directory first, then
+/// the supplied search directories; unresolved names are still recorded
+/// against the first search directory so the hash changes when the file
+/// appears. Already collected files are skipped, which also breaks
+/// include cycles.
+/// </summary>
+//-----------------------------------------------------------------------------
+static void parse_shader_includes(const fs::path& file, const std::vector<fs::path>& search_dirs,
+								  std::vector<fs::path>& out_includes)
+{
+	std::ifstream stream(file.string());
+	if(!stream.good())
+		return;
+
+	std::string line;
+	while(std::getline(stream, line))
+	{
+		const std::size_t directive = line.find("#include");
+		if(directive == std::string::npos)
+			continue;
+
+		// Both quote styles show up in bgfx-style shaders.
+		std::size_t open = line.find_first_of("\"<", directive + 8);
+		if(open == std::string::npos)
+			continue;
+
+		const std::size_t close = line.find_first_of("\">", open + 1);
+		if(close == std::string::npos)
+			continue;
+
+		const std::string name = line.substr(open + 1, close - open - 1);
+		if(name.empty())
+			continue;
+
+		fs::error_code err;
+		fs::path resolved = file.parent_path() / name;
+		if(!fs::exists(resolved, err))
 		{
-			err = std::string(error.getMessage().getPtr());
-			if(sz > 0)
+			for(const auto& search_dir : search_dirs)
 			{
-				err += " " + std::string(buffer.data());
+				fs::path candidate = search_dir / name;
+				if(fs::exists(candidate, err))
+				{
+					resolved = candidate;
+					break;
+				}
+			}
+
+			if(!fs::exists(resolved, err) && !search_dirs.empty())
+			{
+				resolved = search_dirs.front() / name;
 			}
-			return false;
 		}
 
-		return true;
+		if(std::find(out_includes.begin(), out_includes.end(), resolved) != out_includes.end())
+			continue;
+
+		out_includes.push_back(resolved);
+		parse_shader_includes(resolved, search_dirs, out_includes);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//  Name : read_recorded_includes ()
+/// <summary>
+/// Reads the include closure recorded next to a compiled shader
+/// ('<output>.incl', one path per line) by the compile that produced it.
+/// Empty when the output has never been compiled with include tracking.
+/// </summary>
+//-----------------------------------------------------------------------------
+static std::vector<fs::path> read_recorded_includes(const fs::path& output)
+{
+	fs::path incl_file = output;
+	incl_file += ".incl";
+
+	std::vector<fs::path> includes;
+	std::ifstream stream(incl_file.string());
+	std::string line;
+	while(std::getline(stream, line))
+	{
+		if(!line.empty())
+			includes.emplace_back(line);
+	}
+	return includes;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : write_includes ()
+/// <summary>
+/// Records the include closure the compiled shader was produced from, so
+/// the next up-to-date check hashes exactly the files that fed this
+/// output - editing a shared header recompiles its dependents and
+/// nothing else.
+/// </summary>
+//-----------------------------------------------------------------------------
+static void write_includes(const fs::path& output, const std::vector<fs::path>& includes)
+{
+	fs::error_code err;
+	fs::path incl_file = output;
+	incl_file += ".incl";
+
+	if(includes.empty())
+	{
+		fs::remove(incl_file, err);
+		return;
+	}
+
+	std::ofstream stream(incl_file.string(), std::ios::out | std::ios::trunc);
+	for(const auto& include : includes)
+	{
+		stream << include.string() << "\n";
+	}
+}
+
+//-----------------------------------------------------------------------------
+//  Name : write_dependencies ()
+/// <summary>
+/// Scans the serialized source text for asset keys and records them next
+/// to the compiled output ('<output>.deps', one key per line). The
+/// runtime fans the recorded keys out as parallel loads when the parent
+/// asset is requested, instead of discovering them one deserialization
+/// wave at a time.
+/// </summary>
+//-----------------------------------------------------------------------------
+static void write_dependencies(const fs::path& absolute_key, const fs::path& output)
+{
+	fs::error_code err;
+
+	std::string text;
+	{
+		std::ifstream stream(absolute_key.string());
+		if(!stream.good())
+			return;
+
+		text.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+
+	const auto is_supported = [](const std::string& extension) {
+		const std::array<const std::vector<std::string>*, 7> lists = {
+			{&ex::get_suported_texture_formats(), &ex::get_suported_mesh_formats(),
+			 &ex::get_suported_sound_formats(), &ex::get_suported_material_formats(),
+			 &ex::get_suported_animation_formats(), &ex::get_suported_prefab_formats(),
+			 &ex::get_suported_scene_formats()}};
+
+		for(const auto* list : lists)
+		{
+			if(ex::is_format(extension, *list))
+				return true;
+		}
+		return false;
+	};
+
+	// Dependency keys show up in the associative archives as quoted
+	// protocol paths - e.g. "app:/data/textures/stone.png".
+	std::vector<std::string> dependencies;
+	std::size_t pos = 0;
+	while((pos = text.find('"', pos)) != std::string::npos)
+	{
+		const std::size_t end = text.find('"', pos + 1);
+		if(end == std::string::npos)
+			break;
+
+		std::string candidate = text.substr(pos + 1, end - pos - 1);
+		pos = end + 1;
+
+		if(candidate.find(":/data") == std::string::npos)
+			continue;
+
+		if(!is_supported(fs::path(candidate).extension().string()))
+			continue;
+
+		if(std::find(dependencies.begin(), dependencies.end(), candidate) == dependencies.end())
+			dependencies.push_back(candidate);
+	}
+
+	fs::path deps_output = output;
+	deps_output += ".deps";
+
+	if(dependencies.empty())
+	{
+		fs::remove(deps_output, err);
+		return;
+	}
+
+	std::ofstream stream(deps_output.string(), std::ios::out | std::ios::trunc);
+	for(const auto& dependency : dependencies)
+	{
+		stream << dependency << "\n";
 	}
 }
 
@@ -114,6 +566,36 @@ void compile_shader(const fs::path& absolute_meta_key, const fs::path& output)
 	fs::path varying = dir / (file + ".io");
 	std::string str_varying = varying.string();
 
+	// Content hash over the shader, its varying definition, the meta file
+	// and the include closure recorded at the last compile; a matching
+	// record means the output is already current. Hashing the recorded
+	// closure is what catches edits to shared headers without touching
+	// the shaders that include them.
+	const std::vector<fs::path> search_dirs = {dir, include};
+	std::vector<fs::path> includes = read_recorded_includes(output);
+	if(includes.empty())
+	{
+		parse_shader_includes(absolute_key, search_dirs, includes);
+	}
+
+	std::vector<fs::path> sources = {absolute_key, varying, absolute_meta_key};
+	sources.insert(sources.end(), includes.begin(), includes.end());
+
+	std::uint64_t source_hash = 0;
+	if(is_up_to_date(output, sources, source_hash))
+	{
+		return;
+	}
+
+	// The edit may have added or removed includes - re-resolve the
+	// closure so the recorded hash covers what this compile actually
+	// reads.
+	includes.clear();
+	parse_shader_includes(absolute_key, search_dirs, includes);
+	sources.resize(3);
+	sources.insert(sources.end(), includes.begin(), includes.end());
+	source_hash = hash_files(sources);
+
 	std::string str_platform;
 	std::string str_profile;
 	std::string str_type;
@@ -180,6 +662,8 @@ void compile_shader(const fs::path& absolute_meta_key, const fs::path& output)
 	{
 		APPLOG_INFO("Successful compilation of {0}", str_input);
 		fs::copy_file(temp, output, fs::copy_options::overwrite_if_exists, err);
+		write_hash(output, source_hash);
+		write_includes(output, includes);
 	}
 	fs::remove(temp, err);
 }
@@ -192,6 +676,15 @@ void compile_texture(const fs::path& absolute_meta_key, const fs::path& output)
     absolute_key.replace_extension();
 	std::string str_input = absolute_key.string();
 
+	// Skip when neither the source nor its importer settings changed -
+	// timestamp-only touches (a git checkout) would otherwise recompile
+	// the whole texture set.
+	std::uint64_t source_hash = 0;
+	if(is_up_to_date(output, {absolute_key, absolute_meta_key}, source_hash))
+	{
+		return;
+	}
+
 	fs::path temp = fs::temp_directory_path(err);
 	temp /= uuids::random_uuid(str_input).to_string() + ".buildtemp";
 
@@ -216,10 +709,146 @@ void compile_texture(const fs::path& absolute_meta_key, const fs::path& output)
 	{
 		APPLOG_INFO("Successful compilation of {0}", str_input);
 		fs::copy_file(temp, output, fs::copy_options::overwrite_if_exists, err);
+		write_hash(output, source_hash);
+
+		// Also bake a low-mip proxy ('<output>.lomip') capped at 64 pixels.
+		// The runtime fulfills texture handles from the proxy after a tiny
+		// read and streams the full chain in behind it, so large textures
+		// stop dominating the load-time IO.
+		fs::path lomip_output = output;
+		lomip_output += ".lomip";
+
+		const std::vector<std::string> lomip_args_array = {
+			"-f", str_input.c_str(), "-o",	str_output.c_str(), "--as", "ktx",
+			"-m", "-t",				 "BGRA8", "--max",			"64",
+		};
+
+		{
+			std::ofstream output_file(str_output);
+			(void)output_file;
+		}
+
+		std::string lomip_error;
+		if(!run_compile_process("texturec", lomip_args_array, lomip_error))
+		{
+			APPLOG_WARNING("Failed low-mip proxy generation of {0} with error: {1}", str_input,
+						   lomip_error);
+			fs::remove(lomip_output, err);
+		}
+		else
+		{
+			fs::copy_file(temp, lomip_output, fs::copy_options::overwrite_if_exists, err);
+		}
 	}
 	fs::remove(temp, err);
 }
 
+//-----------------------------------------------------------------------------
+//  Name : compile_mesh_lods ()
+/// <summary>
+/// Generates an automatic LOD chain for a prepared container mesh by
+/// simplifying each subset with the quadric error metric and writes each
+/// level as its own container next to the base one ('<name>.lod1' etc).
+/// The runtime picks the chain up when the base mesh is assigned to a
+/// model.
+/// </summary>
+//-----------------------------------------------------------------------------
+static void compile_mesh_lods(mesh& compiled, std::uint32_t material_count, const fs::path& output,
+							  const fs::path& temp)
+{
+	fs::error_code err;
+	const std::uint32_t max_auto_lods = 3;
+	const std::uint32_t min_face_count = 64;
+
+	// Unpack the positions once - the simplifier snaps vertices onto each
+	// other so every level shares the base vertex buffer.
+	const auto& format = compiled.get_vertex_format();
+	const std::uint32_t vertex_count = compiled.get_vertex_count();
+	std::vector<math::vec3> positions(vertex_count);
+	for(std::uint32_t i = 0; i < vertex_count; ++i)
+	{
+		float pos[4];
+		gfx::vertex_unpack(pos, gfx::attribute::Position, format, compiled.get_system_vb(), i);
+		positions[i] = math::vec3(pos[0], pos[1], pos[2]);
+	}
+
+	std::uint32_t generated = 0;
+	std::size_t previous_face_count = compiled.get_face_count();
+	for(std::uint32_t lod = 1; lod <= max_auto_lods; ++lod)
+	{
+		// Halve the face budget per level, distributed across subsets so
+		// material partitions survive.
+		const float ratio = 1.0f / static_cast<float>(1u << lod);
+		if(static_cast<std::size_t>(compiled.get_face_count() * ratio) < min_face_count)
+			break;
+
+		mesh::triangle_array_t lod_triangles;
+		for(std::uint32_t group = 0; group < material_count; ++group)
+		{
+			const auto* sub = compiled.get_subset(group);
+			if(sub == nullptr || sub->face_count == 0)
+				continue;
+
+			const std::uint32_t* indices_ptr = compiled.get_system_ib() + (sub->face_start * 3);
+			std::vector<std::uint32_t> subset_indices(indices_ptr, indices_ptr + sub->face_count * 3);
+			std::vector<std::uint32_t> simplified;
+			triangle_mesh_tools::simplify(positions, subset_indices,
+										  static_cast<std::size_t>(sub->face_count * ratio), simplified);
+
+			for(std::size_t i = 0; i < simplified.size(); i += 3)
+			{
+				mesh::triangle tri;
+				tri.data_group_id = group;
+				tri.indices[0] = simplified[i];
+				tri.indices[1] = simplified[i + 1];
+				tri.indices[2] = simplified[i + 2];
+				lod_triangles.push_back(tri);
+			}
+
+		} // Next data group
+
+		// Stop once the simplifier cannot shed a meaningful amount.
+		if(lod_triangles.empty() || lod_triangles.size() >= (previous_face_count * 9) / 10)
+			break;
+		previous_face_count = lod_triangles.size();
+
+		mesh lod_mesh;
+		lod_mesh.prepare_mesh(format);
+		lod_mesh.set_vertex_source(compiled.get_system_vb(), vertex_count, format);
+		lod_mesh.add_primitives(lod_triangles);
+		lod_mesh.set_subset_count(material_count);
+		if(!lod_mesh.end_prepare(false, false, true, false))
+			break;
+
+		fs::path lod_output = output;
+		lod_output.replace_extension();
+		lod_output += ".lod" + std::to_string(lod) + ".asset";
+		{
+			std::ofstream soutput(temp.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+			if(!lod_mesh.save_prepared(soutput))
+				break;
+		}
+		fs::copy_file(temp, lod_output, fs::copy_options::overwrite_if_exists, err);
+		fs::remove(temp, err);
+		generated = lod;
+
+		APPLOG_INFO("Generated lod{0} with {1} faces (base {2})", lod, lod_triangles.size(),
+					compiled.get_face_count());
+
+	} // Next lod
+
+	// Drop stale levels from a previous, longer chain.
+	for(std::uint32_t lod = generated + 1; lod <= max_auto_lods; ++lod)
+	{
+		fs::path lod_output = output;
+		lod_output.replace_extension();
+		lod_output += ".lod" + std::to_string(lod) + ".asset";
+		if(!fs::exists(lod_output, err))
+			break;
+		fs::remove(lod_output, err);
+	}
+}
+
 void compile_mesh(const fs::path& absolute_meta_key, const fs::path& output)
 {
     fs::error_code err;
@@ -228,27 +857,80 @@ void compile_mesh(const fs::path& absolute_meta_key, const fs::path& output)
     absolute_key.replace_extension();
 	std::string str_input = absolute_key.string();
 
+	// Mesh imports are by far the most expensive compiles; a content hash
+	// match means a timestamp-only touch and the import is skipped whole.
+	std::uint64_t source_hash = 0;
+	if(is_up_to_date(output, {absolute_key, absolute_meta_key}, source_hash))
+	{
+		return;
+	}
+
 	fs::path temp = fs::temp_directory_path(err);
 	temp /= uuids::random_uuid(str_input).to_string() + ".buildtemp";
 
+	// Publish progress for the duration of the compile - the import
+	// reports parse/conversion stages, the remaining slice covers the
+	// prepare-and-write phase below.
+	scoped_import_progress progress_tracker(absolute_key.filename().string());
+
 	mesh::load_data data;
 	std::vector<runtime::animation> animations;
-	if(!importer::load_mesh_data_from_file(str_input, data, animations))
+	if(!importer::load_mesh_data_from_file(str_input, data, animations,
+										   [&progress_tracker](float progress, const std::string& stage) {
+											   progress_tracker.update(progress * 0.9f, stage);
+										   }))
 	{
 		APPLOG_ERROR("Failed compilation of {0}", str_input);
 		return;
 	}
 
+	progress_tracker.update(0.9f, "compiling");
+
 	if(data.vertex_data.empty() == false)
 	{
+		// Meshes without skinning or armature data can be fully prepared
+		// (welded, sorted and vertex cache optimized) here at compile time and
+		// written in the layout-final runtime container, which the runtime
+		// memory-maps and renders from without deserializing.
+		mesh compiled;
+		bool saved_prepared = false;
+		if(!data.skin_data.has_bones() && data.root_node == nullptr)
 		{
-			std::ofstream soutput(temp.string(), std::ios::out | std::ios::binary);
+			compiled.prepare_mesh(data.vertex_format);
+			compiled.set_vertex_source(&data.vertex_data[0], data.vertex_count, data.vertex_format);
+			compiled.add_primitives(data.triangle_data);
+			compiled.set_subset_count(data.material_count);
+			if(compiled.end_prepare(false, true, true, false))
+			{
+				// Requantize texture coordinates to half floats when the
+				// device can fetch them. Re-preparing with the compressed
+				// layout converts the vertex data in place and keeps the
+				// already optimized face order.
+				if((gfx::get_caps()->supported & BGFX_CAPS_VERTEX_ATTRIB_HALF) != 0 &&
+				   data.vertex_format.m_hash == gfx::mesh_vertex::get_layout().m_hash)
+				{
+					compiled.prepare_mesh(gfx::compressed_mesh_vertex::get_layout());
+					compiled.end_prepare(false, false, false, false);
+				}
+
+				std::ofstream soutput(temp.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+				saved_prepared = compiled.save_prepared(soutput);
+			}
+		}
+
+		if(!saved_prepared)
+		{
+			std::ofstream soutput(temp.string(), std::ios::out | std::ios::binary | std::ios::trunc);
 			cereal::oarchive_binary_t ar(soutput);
 			try_save(ar, cereal::make_nvp("mesh", data));
 		}
 		fs::copy_file(temp, output, fs::copy_options::overwrite_if_exists, err);
 		fs::remove(temp, err);
 
+		if(saved_prepared)
+			compile_mesh_lods(compiled, data.material_count, output, temp);
+
+		write_hash(output, source_hash);
 		APPLOG_INFO("Successful compilation of {0}", str_input);
 	}
 	//	{
@@ -288,24 +970,44 @@ void compile_sound(const fs::path& absolute_meta_key, const fs::path& output)
     
 	std::string str_input = absolute_key.string();
 
+	std::uint64_t source_hash = 0;
+	if(is_up_to_date(output, {absolute_key, absolute_meta_key}, source_hash))
+	{
+		return;
+	}
+
 	fs::path temp = fs::temp_directory_path(err);
 	temp /= uuids::random_uuid(str_input).to_string() + ".buildtemp";
 
-	std::ifstream f(str_input, std::ios::in | std::ios::binary);
+	fs::chunked_reader reader(absolute_key);
 
-	if(!f.is_open())
+	if(reader.size() == 0)
 	{
 		APPLOG_ERROR("Cant open file {0}", str_input);
 		return;
 	}
 
-	auto file_data = fs::read_stream(f);
-
 	auto ext = absolute_key.extension();
 	audio::sound_data data;
+	fs::byte_array_t file_data;
 
 	if(ext == ".ogg")
 	{
+		// stb_vorbis decodes out of one contiguous buffer, so ogg still
+		// assembles the whole file - but through the reader, so the IO of
+		// the next chunk overlaps each copy.
+		file_data.reserve(static_cast<std::size_t>(reader.size()));
+		while(true)
+		{
+			auto chunk = reader.next();
+			if(chunk.empty())
+			{
+				break;
+			}
+			file_data.insert(file_data.end(), chunk.begin(), chunk.end());
+			reader.recycle(std::move(chunk));
+		}
+
 		std::string load_err;
 		if(!audio::load_ogg_from_memory(file_data.data(), file_data.size(), data, load_err))
 		{
@@ -315,8 +1017,29 @@ void compile_sound(const fs::path& absolute_meta_key, const fs::path& output)
 	}
 	else if(ext == ".wav")
 	{
+		// Wav decodes straight out of the chunk stream - only the pcm and
+		// one chunk are resident instead of the whole file beside the pcm.
+		fs::byte_array_t chunk;
+		std::size_t chunk_offset = 0;
+		const auto pull = [&](std::uint8_t* dst, std::size_t max_bytes) -> std::size_t {
+			if(chunk_offset >= chunk.size())
+			{
+				reader.recycle(std::move(chunk));
+				chunk = reader.next();
+				chunk_offset = 0;
+				if(chunk.empty())
+				{
+					return 0;
+				}
+			}
+			const std::size_t to_copy = std::min(max_bytes, chunk.size() - chunk_offset);
+			std::memcpy(dst, chunk.data() + chunk_offset, to_copy);
+			chunk_offset += to_copy;
+			return to_copy;
+		};
+
 		std::string load_err;
-		if(!audio::load_wav_from_memory(file_data.data(), file_data.size(), data, load_err))
+		if(!audio::load_wav_from_stream(pull, data, load_err))
 		{
 			APPLOG_ERROR("Failed compilation of {0} with error : {1}", str_input, load_err);
 			return;
@@ -328,6 +1051,23 @@ void compile_sound(const fs::path& absolute_meta_key, const fs::path& output)
 		return;
 	}
 
+	// Long sounds ship their encoded bytes and stream at playback - a
+	// few minutes of decoded pcm is tens of megabytes held resident and
+	// a noticeable stall at load time. Short ones stay fully decoded.
+	const auto streaming_threshold = audio::sound_info::duration_t(30.0);
+	if(data.info.duration >= streaming_threshold)
+	{
+		data.data.clear();
+		if(file_data.empty())
+		{
+			// Long wavs are rare - music ships as ogg - so re-reading their
+			// encoded bytes here beats carrying every wav through
+			// compilation at file-size peak memory.
+			file_data = fs::read_async(absolute_key).get();
+		}
+		data.encoded_data = std::move(file_data);
+	}
+
 	{
 		std::ofstream soutput(temp.string(), std::ios::out | std::ios::binary);
 		cereal::oarchive_binary_t ar(soutput);
@@ -335,6 +1075,7 @@ void compile_sound(const fs::path& absolute_meta_key, const fs::path& output)
 	}
 	fs::copy_file(temp, output, fs::copy_options::overwrite_if_exists, err);
 	fs::remove(temp, err);
+	write_hash(output, source_hash);
 
 	APPLOG_INFO("Successful compilation of {0}", str_input);
 }
@@ -346,7 +1087,13 @@ void compile_material(const fs::path& absolute_meta_key, const fs::path& output)
     absolute_key = fs::resolve_protocol(fs::replace(absolute_key, ":/meta", ":/data"));
     absolute_key.replace_extension();
     std::string str_input = absolute_key.string();
-    
+
+	std::uint64_t source_hash = 0;
+	if(is_up_to_date(output, {absolute_key, absolute_meta_key}, source_hash))
+	{
+		return;
+	}
+
 	std::shared_ptr<::material> material;
 	{
 		std::ifstream stream(absolute_key.string());
@@ -366,30 +1113,413 @@ void compile_material(const fs::path& absolute_meta_key, const fs::path& output)
 			cereal::oarchive_binary_t ar(stream);
 
 			try_save(ar, cereal::make_nvp("material", material));
-            
+
             APPLOG_INFO("Successful compilation of {0}", str_input);
-            
+
+		}
+
+		write_dependencies(absolute_key, output);
+		write_hash(output, source_hash);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//  Name : static_batch_scene ()
+/// <summary>
+/// Offline static batching for scene compiles. Groups the instantiated
+/// scene's static, non-skinned, opaque model entities by material set,
+/// vertex layout and render flags, merges each group's meshes into one
+/// pre-transformed (world space) combined mesh and writes it as a
+/// cache-only container next to the compiled scene
+/// ('<name>.batch<n>.asset'). A batch entity referencing the
+/// merged mesh replaces the member draws - the members keep their
+/// entities but lose their model components. The merged mesh goes
+/// through the regular preparation path, so subset bounds and cluster
+/// data for the meshlet cull are rebuilt for the combined geometry.
+/// </summary>
+//-----------------------------------------------------------------------------
+static void static_batch_scene(std::vector<runtime::entity>& roots, const fs::path& absolute_key,
+							   const fs::path& output)
+{
+	// Gather batch candidates from the whole hierarchy.
+	struct batch_candidate
+	{
+		runtime::entity e;
+		math::transform world;
+		const model* mdl = nullptr;
+		mesh* mesh_ptr = nullptr;
+	};
+	std::unordered_map<std::string, std::vector<batch_candidate>> groups;
+
+	std::vector<runtime::entity> stack(roots.begin(), roots.end());
+	while(!stack.empty())
+	{
+		auto e = stack.back();
+		stack.pop_back();
+		if(!e.valid())
+			continue;
+
+		auto transform_comp = e.get_component<transform_component>().lock();
+		if(transform_comp)
+		{
+			for(const auto& child : transform_comp->get_children())
+				stack.push_back(child);
+		}
+
+		auto model_comp = e.get_component<model_component>().lock();
+		if(!model_comp || !transform_comp)
+			continue;
+		if(!model_comp->is_static() || !model_comp->get_bone_entities().empty())
+			continue;
+
+		const auto& mdl = model_comp->get_model();
+		// Transparent subsets need per-draw depth sorting and models with
+		// authored LOD chains would lose them in a merge - both stay
+		// individual draws.
+		if(mdl.has_transparency() || mdl.get_lods().size() > 1)
+			continue;
+
+		auto lod = mdl.get_lod(0);
+		if(!lod)
+			continue;
+		auto* mesh_ptr = lod.get();
+		if(mesh_ptr->get_vertex_count() == 0 || mesh_ptr->get_system_vb() == nullptr ||
+		   mesh_ptr->get_system_ib() == nullptr)
+			continue;
+
+		std::ostringstream signature;
+		signature << mesh_ptr->get_vertex_format().m_hash << '|' << model_comp->casts_shadow() << '|'
+				  << model_comp->casts_reflection();
+		for(std::size_t group = 0; group < mesh_ptr->get_subset_count(); ++group)
+			signature << '|' << mdl.get_material_for_group(group).id();
+
+		groups[signature.str()].push_back(
+			{e, transform_comp->get_transform(), &mdl, mesh_ptr});
+	}
+
+	auto& ecs = core::get_subsystem<runtime::entity_component_system>();
+	const auto scene_key = fs::convert_to_protocol(absolute_key).generic_string();
+	fs::error_code err;
+
+	std::uint32_t batch_index = 0;
+	for(auto& pair : groups)
+	{
+		auto& members = pair.second;
+		if(members.size() < 2)
+			continue;
+
+		const auto& format = members.front().mesh_ptr->get_vertex_format();
+		const std::uint16_t stride = format.getStride();
+		const auto subset_count = std::uint32_t(members.front().mesh_ptr->get_subset_count());
+
+		// Concatenate the member meshes with vertices pre-transformed into
+		// world space; the batch entity then renders with an identity
+		// transform. Triangles keep their data group so the merged mesh
+		// partitions into the same material subsets.
+		std::vector<std::uint8_t> vertex_data;
+		mesh::triangle_array_t triangles;
+		for(const auto& member : members)
+		{
+			auto* member_mesh = member.mesh_ptr;
+			const auto vertex_count = member_mesh->get_vertex_count();
+			const auto base_vertex = std::uint32_t(vertex_data.size() / stride);
+			const std::size_t offset = vertex_data.size();
+			vertex_data.resize(offset + std::size_t(vertex_count) * stride);
+			std::memcpy(&vertex_data[offset], member_mesh->get_system_vb(),
+						std::size_t(vertex_count) * stride);
+
+			std::uint8_t* member_data = &vertex_data[offset];
+			for(std::uint32_t v = 0; v < vertex_count; ++v)
+			{
+				float pos[4];
+				gfx::vertex_unpack(pos, gfx::attribute::Position, format, member_data, v);
+				const auto world_pos =
+					member.world.transform_coord(math::vec3(pos[0], pos[1], pos[2]));
+				float packed_pos[4] = {world_pos.x, world_pos.y, world_pos.z, 1.0f};
+				gfx::vertex_pack(packed_pos, false, gfx::attribute::Position, format, member_data, v);
+
+				const gfx::attribute frame_attributes[] = {gfx::attribute::Normal,
+														   gfx::attribute::Tangent,
+														   gfx::attribute::Bitangent};
+				for(const auto attribute : frame_attributes)
+				{
+					if(!format.has(attribute))
+						continue;
+					float vec[4];
+					gfx::vertex_unpack(vec, attribute, format, member_data, v);
+					auto world_vec =
+						member.world.transform_normal(math::vec3(vec[0], vec[1], vec[2]));
+					const float len = math::length(world_vec);
+					if(len > 0.0f)
+						world_vec /= len;
+					float packed_vec[4] = {world_vec.x, world_vec.y, world_vec.z, vec[3]};
+					gfx::vertex_pack(packed_vec, true, attribute, format, member_data, v);
+				}
+			}
+
+			for(std::uint32_t group = 0; group < subset_count; ++group)
+			{
+				const auto* sub = member_mesh->get_subset(group);
+				if(sub == nullptr || sub->face_count == 0)
+					continue;
+
+				const std::uint32_t* indices_ptr =
+					member_mesh->get_system_ib() + (sub->face_start * 3);
+				for(std::uint32_t face = 0; face < sub->face_count; ++face)
+				{
+					mesh::triangle tri;
+					tri.data_group_id = group;
+					tri.indices[0] = base_vertex + indices_ptr[face * 3 + 0];
+					tri.indices[1] = base_vertex + indices_ptr[face * 3 + 1];
+					tri.indices[2] = base_vertex + indices_ptr[face * 3 + 2];
+					triangles.push_back(tri);
+				}
+			}
 		}
+
+		if(triangles.empty())
+			continue;
+
+		auto merged = std::make_shared<mesh>();
+		merged->prepare_mesh(format);
+		merged->set_vertex_source(vertex_data.data(), std::uint32_t(vertex_data.size() / stride),
+								  format);
+		merged->add_primitives(triangles);
+		merged->set_subset_count(subset_count);
+		if(!merged->end_prepare(false, false, true, false))
+			continue;
+
+		fs::path batch_output = output;
+		batch_output.replace_extension();
+		batch_output += ".batch" + std::to_string(batch_index) + ".asset";
+		{
+			std::ofstream soutput(batch_output.string(),
+								  std::ios::out | std::ios::binary | std::ios::trunc);
+			if(!merged->save_prepared(soutput))
+			{
+				fs::remove(batch_output, err);
+				continue;
+			}
+		}
+
+		// The handle carries both the cache-only key the runtime resolves
+		// and the live instance, so model::set_lod can size its material
+		// table without a load.
+		asset_handle<mesh> merged_handle;
+		merged_handle.link->id = scene_key + ".batch" + std::to_string(batch_index);
+		merged_handle.link->asset = merged;
+
+		model batch_model;
+		batch_model.set_lod(merged_handle, 0);
+		batch_model.set_materials(members.front().mdl->get_materials());
+
+		auto object = ecs.create();
+		object.set_name("static_batch_" + std::to_string(batch_index));
+		object.assign<transform_component>();
+		object.assign<model_component>()
+			.lock()
+			->set_static(true)
+			.set_casts_shadow(members.front().e.get_component<model_component>().lock()->casts_shadow())
+			.set_casts_reflection(
+				members.front().e.get_component<model_component>().lock()->casts_reflection())
+			.set_model(batch_model);
+		roots.push_back(object);
+
+		// The members stay (children, scripts, colliders...) but no longer
+		// draw on their own.
+		for(auto& member : members)
+			member.e.remove<model_component>();
+
+		APPLOG_INFO("Static batch {0}: {1} draws merged into {2} subsets", batch_index,
+					members.size(), subset_count);
+		++batch_index;
+	}
+
+	// Drop stale batch meshes from a previous, larger compile.
+	for(std::uint32_t stale = batch_index;; ++stale)
+	{
+		fs::path batch_output = output;
+		batch_output.replace_extension();
+		batch_output += ".batch" + std::to_string(stale) + ".asset";
+		if(!fs::exists(batch_output, err))
+			break;
+		fs::remove(batch_output, err);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//  Name : compile_entity_data ()
+/// <summary>
+/// Shared body of the scene and prefab compiles - transcodes the
+/// associative source into the tagged binary archive so the runtime
+/// never parses text or field names. Entity serialization goes through
+/// the live ecs, so the transcode itself is marshalled to the owner
+/// thread; the entities it creates are destroyed inside that task. If
+/// the transcode fails the source form is copied verbatim as before -
+/// deserialize_data accepts either.
+/// </summary>
+//-----------------------------------------------------------------------------
+static void compile_entity_data(const fs::path& absolute_key, const fs::path& output,
+								const std::function<void(std::vector<runtime::entity>&)>& post_load = {})
+{
+	fs::error_code err;
+	std::string str_input = absolute_key.string();
+
+	fs::path temp = fs::temp_directory_path(err);
+	temp /= uuids::random_uuid(str_input).to_string() + ".buildtemp";
+
+	auto& ts = core::get_subsystem<core::task_system>();
+	auto transcoded = ts.push_or_execute_on_owner_thread([absolute_key, temp, post_load]() {
+		return ecs::utils::resave_entities_as_binary(absolute_key, temp, post_load);
+	});
+
+	if(transcoded.get())
+	{
+		fs::copy_file(temp, output, fs::copy_options::overwrite_if_exists, err);
+		fs::remove(temp, err);
+		write_dependencies(absolute_key, output);
+
+		APPLOG_INFO("Successful compilation of {0}", str_input);
+	}
+	else
+	{
+		fs::remove(temp, err);
+		fs::copy_file(absolute_key, output, fs::copy_options::overwrite_if_exists, err);
+		write_dependencies(absolute_key, output);
 	}
 }
 
 void compile_scene(const fs::path& absolute_meta_key, const fs::path& output)
 {
-    fs::error_code err;
     fs::path absolute_key = fs::convert_to_protocol(absolute_meta_key);
     absolute_key = fs::resolve_protocol(fs::replace(absolute_key, ":/meta", ":/data"));
     absolute_key.replace_extension();
-	fs::copy_file(absolute_key, output, fs::copy_options::overwrite_if_exists, err);
+	compile_entity_data(absolute_key, output,
+						[absolute_key, output](std::vector<runtime::entity>& roots) {
+							static_batch_scene(roots, absolute_key, output);
+						});
 }
 
 void compile_prefab(const fs::path& absolute_meta_key, const fs::path& output)
 {
-    fs::error_code err;
     fs::path absolute_key = fs::convert_to_protocol(absolute_meta_key);
     absolute_key = fs::resolve_protocol(fs::replace(absolute_key, ":/meta", ":/data"));
     absolute_key.replace_extension();
-    fs::copy_file(absolute_key, output, fs::copy_options::overwrite_if_exists, err);
+    compile_entity_data(absolute_key, output);
+}
+
+compile_scheduler::compile_scheduler()
+{
+	_running.fill(0);
+
+	// Process based compiles scale with the core count - the heavy work
+	// happens inside shaderc/texturec. In-process imports hold large
+	// intermediate buffers, so they get half. Shader compiles are short
+	// and dominated by process startup, so oversubscribing them keeps
+	// cores busy while spawns are in flight.
+	const std::size_t hw = std::max<std::size_t>(2, std::thread::hardware_concurrency());
+	_limits.fill(std::max<std::size_t>(1, hw / 2));
+	_limits[static_cast<std::size_t>(job_type::shader)] = hw * 2;
+	_limits[static_cast<std::size_t>(job_type::texture)] = hw;
+}
+
+compile_scheduler::~compile_scheduler()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for(auto& queue : _queues)
+			queue.clear();
+	}
+
+	// keep draining owner-thread tasks while waiting - scene and prefab
+	// jobs marshal their transcode here and would otherwise never finish
+	auto& ts = core::get_subsystem<core::task_system>();
+	while(get_pending_count() != 0)
+	{
+		ts.run_on_owner_thread(std::chrono::milliseconds(10));
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+}
+
+void compile_scheduler::enqueue(job_type type, std::function<void()> job)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_queues[static_cast<std::size_t>(type)].push_back(std::move(job));
+	dispatch_pending();
+}
+
+void compile_scheduler::set_concurrency_limit(job_type type, std::size_t limit)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_limits[static_cast<std::size_t>(type)] = std::max<std::size_t>(1, limit);
+	dispatch_pending();
+}
+
+std::size_t compile_scheduler::get_pending_count() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	std::size_t count = 0;
+	for(std::size_t type = 0; type < type_count; ++type)
+	{
+		count += _queues[type].size();
+		count += _running[type];
+	}
+	return count;
+}
+
+void compile_scheduler::dispatch_pending()
+{
+	auto& ts = core::get_subsystem<core::task_system>();
+
+	for(std::size_t type = 0; type < type_count; ++type)
+	{
+		// A class may only start once every earlier stage fully drained,
+		// so the inputs its outputs reference are final.
+		const auto stage = get_stage(static_cast<job_type>(type));
+		bool blocked = false;
+		for(std::size_t other = 0; other < type_count; ++other)
+		{
+			if(get_stage(static_cast<job_type>(other)) < stage &&
+			   (!_queues[other].empty() || _running[other] != 0))
+			{
+				blocked = true;
+				break;
+			}
+		}
+		if(blocked)
+			continue;
+
+		auto& queue = _queues[type];
+		while(!queue.empty() && _running[type] < _limits[type])
+		{
+			auto job = std::move(queue.front());
+			queue.pop_front();
+			++_running[type];
+
+			ts.push_on_worker_thread([ this, type, job = std::move(job) ]() {
+				if(job)
+					job();
+
+				std::lock_guard<std::mutex> lock(_mutex);
+				--_running[type];
+				dispatch_pending();
+			});
+		}
+	}
 }
 
+std::size_t compile_scheduler::get_stage(job_type type)
+{
+	switch(type)
+	{
+		case job_type::material:
+			return 1;
+		case job_type::prefab:
+		case job_type::scene:
+			return 2;
+		default:
+			return 0;
+	}
+}
 
 }
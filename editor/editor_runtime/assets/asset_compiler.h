@@ -1,6 +1,13 @@
 #pragma once
 #include "core/filesystem/filesystem.h"
 
+#include <array>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
 namespace project_compiler
 {
 void compile_texture(const fs::path& absolute_meta_key, const fs::path& output);
@@ -11,4 +18,126 @@ void compile_shader(const fs::path& absolute_meta_key, const fs::path& output);
 void compile_material(const fs::path& absolute_meta_key, const fs::path& output);
 void compile_scene(const fs::path& absolute_meta_key, const fs::path& output);
 void compile_prefab(const fs::path& absolute_meta_key, const fs::path& output);
+
+//-----------------------------------------------------------------------------
+//  Name : import_progress (Struct)
+/// <summary>
+/// One import currently running, with its progress, for UI display.
+/// Only the expensive imports that report progress (meshes) show up.
+/// </summary>
+//-----------------------------------------------------------------------------
+struct import_progress
+{
+	/// source file name being imported
+	std::string name;
+	/// short label of the stage currently running
+	std::string stage;
+	/// 0..1
+	float progress = 0.0f;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : get_active_imports ()
+/// <summary>
+/// Snapshot of the imports currently in flight. Thread safe - imports
+/// run on workers while the UI polls from the owner thread.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::vector<import_progress> get_active_imports();
+
+/// Job classes the scheduler balances. The order encodes the coarse
+/// dependency graph between asset types - later classes reference the
+/// outputs of earlier ones.
+enum class job_type : std::size_t
+{
+	shader,
+	texture,
+	mesh,
+	sound,
+	animation,
+	material,
+	prefab,
+	scene,
+	count
+};
+
+//-----------------------------------------------------------------------------
+//  Name : compile_scheduler (Class)
+/// <summary>
+/// Runs compile jobs concurrently on the task system with a per-type
+/// concurrency cap, so a full recompile saturates the machine without
+/// flooding it with shaderc/texturec processes. Types form a coarse
+/// dependency graph (sources, then materials, then prefabs/scenes); a
+/// job only dispatches once every earlier stage drained, which keeps
+/// recorded dependency lists pointing at finished outputs.
+/// </summary>
+//-----------------------------------------------------------------------------
+class compile_scheduler
+{
+public:
+	compile_scheduler();
+
+	//-----------------------------------------------------------------------------
+	//  Name : ~compile_scheduler ()
+	/// <summary>
+	/// Drops queued jobs and waits for running ones - they reference this
+	/// scheduler from their completion hooks.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	~compile_scheduler();
+
+	//-----------------------------------------------------------------------------
+	//  Name : enqueue ()
+	/// <summary>
+	/// Queues a compile job of the specified class and dispatches as much
+	/// pending work as the limits and stage ordering allow.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void enqueue(job_type type, std::function<void()> job);
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_concurrency_limit ()
+	/// <summary>
+	/// Caps how many jobs of one class may run at the same time.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_concurrency_limit(job_type type, std::size_t limit);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_pending_count ()
+	/// <summary>
+	/// Returns the number of queued plus running jobs.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t get_pending_count() const;
+
+private:
+	//-----------------------------------------------------------------------------
+	//  Name : dispatch_pending ()
+	/// <summary>
+	/// Starts queued jobs, respecting the per-type caps and the stage
+	/// ordering. Expects the mutex to be held.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void dispatch_pending();
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_stage ()
+	/// <summary>
+	/// Returns the dependency stage a job class belongs to.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	static std::size_t get_stage(job_type type);
+
+	static const std::size_t type_count = static_cast<std::size_t>(job_type::count);
+
+	/// Guards the queues and counters.
+	mutable std::mutex _mutex;
+	/// Queued jobs per class, in arrival order.
+	std::array<std::deque<std::function<void()>>, type_count> _queues;
+	/// Jobs currently running per class.
+	std::array<std::size_t, type_count> _running;
+	/// Concurrency cap per class.
+	std::array<std::size_t, type_count> _limits;
+};
 };
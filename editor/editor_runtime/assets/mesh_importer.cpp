@@ -2,10 +2,50 @@
 #include "core/graphics/graphics.h"
 #include "core/logging/logging.h"
 #include "core/math/math_includes.h"
+#include "core/system/subsystem.h"
+#include "core/tasks/task_system.h"
 #include "editor_core/mesh_import/mesh_import.h"
+#include "runtime/animation/animation_compression.h"
 #include "runtime/rendering/mesh.h"
 #include <algorithm>
 
+namespace
+{
+/// fraction of the reported progress the assimp parse occupies
+const float parse_share = 0.6f;
+/// fraction the parallel per-mesh conversion occupies
+const float convert_share = 0.3f;
+
+//-----------------------------------------------------------------------------
+//  Name : import_progress_handler (Class)
+/// <summary>
+/// Adapts assimp's parse progress callbacks onto the importer's own.
+/// The Importer takes ownership of the instance once it is installed.
+/// </summary>
+//-----------------------------------------------------------------------------
+class import_progress_handler : public Assimp::ProgressHandler
+{
+public:
+	import_progress_handler(importer::progress_callback_t callback)
+		: _callback(std::move(callback))
+	{
+	}
+
+	bool Update(float percentage = -1.0f) override
+	{
+		if(_callback && percentage >= 0.0f)
+		{
+			_callback(std::min(percentage, 1.0f) * parse_share, "parsing");
+		}
+		return true;
+	}
+
+private:
+	/// relayed progress sink
+	importer::progress_callback_t _callback;
+};
+}
+
 math::transform process_matrix(const aiMatrix4x4& assimp_matrix)
 {
 	math::transform matrix;
@@ -33,7 +73,7 @@ math::transform process_matrix(const aiMatrix4x4& assimp_matrix)
 	return matrix;
 }
 
-void process_vertices(aiMesh* mesh, mesh::load_data& load_data)
+void process_vertices(aiMesh* mesh, std::uint32_t vertex_offset, mesh::load_data& load_data)
 {
 	// Determine the correct offset to any relevant elements in the vertex
 	bool has_position = load_data.vertex_format.has(gfx::attribute::Position);
@@ -43,11 +83,9 @@ void process_vertices(aiMesh* mesh, mesh::load_data& load_data)
 	bool has_texcoord0 = load_data.vertex_format.has(gfx::attribute::TexCoord0);
 	auto vertex_stride = load_data.vertex_format.getStride();
 
-	std::uint32_t current_vertex = load_data.vertex_count;
-	load_data.vertex_count += mesh->mNumVertices;
-	load_data.vertex_data.resize(load_data.vertex_count * vertex_stride);
-
-	std::uint8_t* current_vertex_ptr = &load_data.vertex_data[0] + current_vertex * vertex_stride;
+	// The buffer is laid out and sized up front by process_meshes - this
+	// only packs into the mesh's own slice, so meshes convert in parallel.
+	std::uint8_t* current_vertex_ptr = &load_data.vertex_data[0] + vertex_offset * vertex_stride;
 
 	for(size_t i = 0; i < mesh->mNumVertices; ++i, current_vertex_ptr += vertex_stride)
 	{
@@ -111,18 +149,18 @@ void process_vertices(aiMesh* mesh, mesh::load_data& load_data)
 	}
 }
 
-void process_faces(aiMesh* mesh, std::uint32_t subset_offset, mesh::load_data& load_data)
+void process_faces(aiMesh* mesh, std::uint32_t subset_offset, std::uint32_t triangle_offset,
+				   mesh::load_data& load_data)
 {
-	load_data.triangle_count += mesh->mNumFaces;
-
 	for(size_t i = 0; i < mesh->mNumFaces; ++i)
 	{
 		aiFace face = mesh->mFaces[i];
 
-		mesh::triangle triangle;
+		// writes into this mesh's preallocated slice - material_count is
+		// accumulated by the serial layout pass in process_meshes
+		mesh::triangle& triangle = load_data.triangle_data[triangle_offset + i];
 
 		triangle.data_group_id = mesh->mMaterialIndex;
-		load_data.material_count = std::max(load_data.material_count, triangle.data_group_id + 1);
 
 		auto num_indices = std::min<size_t>(face.mNumIndices, 3);
 
@@ -130,17 +168,14 @@ void process_faces(aiMesh* mesh, std::uint32_t subset_offset, mesh::load_data& l
 		{
 			triangle.indices[j] = face.mIndices[j] + subset_offset;
 		}
-
-		load_data.triangle_data.push_back(triangle);
 	}
 }
 
-void process_bones(aiMesh* mesh, std::uint32_t subset_offset, mesh::load_data& load_data)
+void process_bones(aiMesh* mesh, std::uint32_t subset_offset,
+				   skin_bind_data::bone_influence_array_t& bone_influences)
 {
 	if(mesh->mBones)
 	{
-		auto& bone_influences = load_data.skin_data.get_bones();
-
 		for(size_t i = 0; i < mesh->mNumBones; ++i)
 		{
 			aiBone* assimp_bone = mesh->mBones[i];
@@ -181,20 +216,111 @@ void process_bones(aiMesh* mesh, std::uint32_t subset_offset, mesh::load_data& l
 	}
 }
 
-void process_mesh(aiMesh* mesh, mesh::load_data& load_data)
+void merge_bone_influences(skin_bind_data::bone_influence_array_t& mesh_bones, mesh::load_data& load_data)
+{
+	auto& bone_influences = load_data.skin_data.get_bones();
+
+	for(auto& mesh_bone : mesh_bones)
+	{
+		auto it = std::find_if(std::begin(bone_influences), std::end(bone_influences),
+							   [&mesh_bone](const auto& bone) { return mesh_bone.bone_id == bone.bone_id; });
+
+		if(it != std::end(bone_influences))
+		{
+			it->influences.insert(std::end(it->influences), std::begin(mesh_bone.influences),
+								  std::end(mesh_bone.influences));
+		}
+		else
+		{
+			bone_influences.emplace_back(std::move(mesh_bone));
+		}
+	}
+}
+
+void process_mesh(aiMesh* mesh, std::uint32_t vertex_offset, std::uint32_t triangle_offset,
+				  mesh::load_data& load_data, skin_bind_data::bone_influence_array_t& bone_influences)
 {
-	const auto mesh_vertices_offset = load_data.vertex_count;
-	process_faces(mesh, mesh_vertices_offset, load_data);
-	process_bones(mesh, mesh_vertices_offset, load_data);
-	process_vertices(mesh, load_data);
+	process_faces(mesh, vertex_offset, triangle_offset, load_data);
+	process_bones(mesh, vertex_offset, bone_influences);
+	process_vertices(mesh, vertex_offset, load_data);
 }
 
-void process_meshes(const aiScene* scene, mesh::load_data& load_data)
+void process_meshes(const aiScene* scene, mesh::load_data& load_data,
+					const importer::progress_callback_t& progress)
 {
-	for(size_t i = 0; i < scene->mNumMeshes; ++i)
+	const size_t mesh_count = scene->mNumMeshes;
+	if(mesh_count == 0)
+		return;
+
+	// Serial layout pass - assign every mesh its slice of the shared
+	// vertex and triangle buffers up front, so the per-mesh conversions
+	// can run in parallel without touching each other's memory.
+	std::vector<std::uint32_t> vertex_offsets(mesh_count);
+	std::vector<std::uint32_t> triangle_offsets(mesh_count);
+	for(size_t i = 0; i < mesh_count; ++i)
 	{
 		aiMesh* mesh = scene->mMeshes[i];
-		process_mesh(mesh, load_data);
+		vertex_offsets[i] = load_data.vertex_count;
+		triangle_offsets[i] = load_data.triangle_count;
+		load_data.vertex_count += mesh->mNumVertices;
+		load_data.triangle_count += mesh->mNumFaces;
+		if(mesh->mNumFaces > 0)
+			load_data.material_count = std::max(load_data.material_count, mesh->mMaterialIndex + 1);
+	}
+	load_data.vertex_data.resize(size_t(load_data.vertex_count) * load_data.vertex_format.getStride());
+	load_data.triangle_data.resize(load_data.triangle_count);
+
+	// Each mesh collects bone influences into its own slot; the slots are
+	// merged serially afterwards in mesh order, so the resulting bone
+	// order matches what the old serial loop produced.
+	std::vector<skin_bind_data::bone_influence_array_t> mesh_bones(mesh_count);
+
+	auto convert = [&](size_t i) {
+		process_mesh(scene->mMeshes[i], vertex_offsets[i], triangle_offsets[i], load_data, mesh_bones[i]);
+	};
+
+	auto report = [&](size_t converted) {
+		if(progress)
+		{
+			progress(parse_share + convert_share * (float(converted) / float(mesh_count)),
+					 "converting meshes");
+		}
+	};
+
+	if(mesh_count > 1 && core::has_subsystems<core::task_system>())
+	{
+		// Fan the conversions out across the workers. The first mesh
+		// converts on the calling thread, and waiting processes queued
+		// tasks, so importing from a worker thread cannot deadlock.
+		auto& ts = core::get_subsystem<core::task_system>();
+		std::vector<core::task_future<void>> pending;
+		pending.reserve(mesh_count - 1);
+		for(size_t i = 1; i < mesh_count; ++i)
+		{
+			pending.emplace_back(ts.push_on_worker_thread(convert, i));
+		}
+		convert(0);
+
+		size_t converted = 1;
+		report(converted);
+		for(auto& future : pending)
+		{
+			future.wait();
+			report(++converted);
+		}
+	}
+	else
+	{
+		for(size_t i = 0; i < mesh_count; ++i)
+		{
+			convert(i);
+			report(i + 1);
+		}
+	}
+
+	for(auto& bones : mesh_bones)
+	{
+		merge_bone_influences(bones, load_data);
 	}
 }
 
@@ -277,7 +403,8 @@ void process_animation(const aiAnimation* assimp_anim, runtime::animation& anim)
 		}
 	}
 }
-void process_animations(const aiScene* scene, std::vector<runtime::animation>& animations)
+void process_animations(const aiScene* scene, std::vector<runtime::animation>& animations,
+						const importer::progress_callback_t& progress)
 {
 	if(scene->mNumAnimations > 0)
 		animations.resize(scene->mNumAnimations);
@@ -287,23 +414,46 @@ void process_animations(const aiScene* scene, std::vector<runtime::animation>& a
 		const aiAnimation* assimp_anim = scene->mAnimations[i];
 		auto& anim = animations[i];
 		process_animation(assimp_anim, anim);
+
+		// Raw imports key every frame on every bone; drop the keys the
+		// sampler reconstructs within tolerance before anything is stored.
+		runtime::compress_animation(anim);
+
+		if(progress)
+		{
+			progress(parse_share + convert_share +
+						 (1.0f - parse_share - convert_share) *
+							 (float(i + 1) / float(scene->mNumAnimations)),
+					 "compressing animations");
+		}
 	}
 }
 
 void process_imported_scene(const aiScene* scene, mesh::load_data& load_data,
-							std::vector<runtime::animation>& animations)
+							std::vector<runtime::animation>& animations,
+							const importer::progress_callback_t& progress)
 {
 	load_data.vertex_format = gfx::mesh_vertex::get_layout();
-	process_meshes(scene, load_data);
+	process_meshes(scene, load_data, progress);
+	if(progress)
+	{
+		progress(parse_share + convert_share, "building armature");
+	}
 	process_nodes(scene, load_data);
-	process_animations(scene, animations);
+	process_animations(scene, animations, progress);
 }
 
 bool importer::load_mesh_data_from_file(const std::string& path, mesh::load_data& load_data,
-										std::vector<runtime::animation>& animations)
+										std::vector<runtime::animation>& animations,
+										const progress_callback_t& progress)
 {
 	Assimp::Importer importer;
 	importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, aiComponent_CAMERAS | aiComponent_LIGHTS);
+	if(progress)
+	{
+		// the importer takes ownership of the handler
+		importer.SetProgressHandler(new import_progress_handler(progress));
+	}
 
 	const aiScene* scene = importer.ReadFile(
 		path, aiProcess_ConvertToLeftHanded | aiProcess_CalcTangentSpace | aiProcess_GenSmoothNormals |
@@ -318,7 +468,11 @@ bool importer::load_mesh_data_from_file(const std::string& path, mesh::load_data
 		APPLOG_ERROR(importer.GetErrorString());
 		return false;
 	}
-	process_imported_scene(scene, load_data, animations);
+	process_imported_scene(scene, load_data, animations, progress);
 
+	if(progress)
+	{
+		progress(1.0f, "done");
+	}
 	return true;
 }
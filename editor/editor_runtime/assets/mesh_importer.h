@@ -2,8 +2,26 @@
 #include "runtime/animation/animation.h"
 #include "runtime/rendering/mesh.h"
 
+#include <functional>
+#include <string>
+
 namespace importer
 {
+/// Import progress report - a 0..1 fraction plus a short stage label.
+/// Invoked from whatever thread happens to be driving that stage of the
+/// import, so implementations must be thread safe.
+using progress_callback_t = std::function<void(float, const std::string&)>;
+
+//-----------------------------------------------------------------------------
+//  Name : load_mesh_data_from_file ()
+/// <summary>
+/// Parses the source file with assimp and converts the result into the
+/// runtime load_data form. Per-mesh conversion fans out across the task
+/// system workers, so a multi-mesh scene file uses all cores. 'progress'
+/// is optional and is fed through the parse and conversion stages.
+/// </summary>
+//-----------------------------------------------------------------------------
 bool load_mesh_data_from_file(const std::string& path, mesh::load_data& load_data,
-							  std::vector<runtime::animation>& animations);
+							  std::vector<runtime::animation>& animations,
+							  const progress_callback_t& progress = {});
 }
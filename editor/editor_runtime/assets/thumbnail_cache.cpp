@@ -0,0 +1,286 @@
+#include "thumbnail_cache.h"
+#include "core/graphics/frame_buffer.h"
+#include "core/graphics/render_pass.h"
+#include "core/graphics/texture.h"
+#include "core/system/subsystem.h"
+#include "runtime/assets/asset_manager.h"
+#include "runtime/rendering/renderer.h"
+#include "runtime/system/events.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace editor
+{
+namespace
+{
+/// cache file layout: magic, dimensions, source write time, raw rgba8
+const std::uint32_t cache_magic = 0x4d485445; // "ETHM"
+
+struct cache_header
+{
+	std::uint32_t magic = cache_magic;
+	std::uint16_t width = 0;
+	std::uint16_t height = 0;
+	std::uint64_t source_write_time = 0;
+};
+
+std::uint64_t write_time_of(const fs::path& absolute_path)
+{
+	fs::error_code err;
+	return static_cast<std::uint64_t>(fs::last_write_time(absolute_path, err).time_since_epoch().count());
+}
+}
+
+asset_handle<gfx::texture> thumbnail_cache::get_thumbnail(const std::string& key,
+														  const fs::path& absolute_path)
+{
+	auto it = _resident.find(key);
+	if(it != _resident.end())
+	{
+		// bump to the front of the lru order
+		_lru.splice(_lru.begin(), _lru, it->second.lru_it);
+		return it->second.thumbnail;
+	}
+
+	if(_pending.count(key) != 0)
+	{
+		return {};
+	}
+	_pending.insert(key);
+
+	const auto source_write_time = write_time_of(absolute_path);
+	const auto cache_file = cache_file_for(key);
+
+	// The disk probe and pixel read happen on a worker; only the GPU
+	// upload (or the downscale render when no valid cache file exists)
+	// comes back to the render thread.
+	auto& ts = core::get_subsystem<core::task_system>();
+	ts.push_on_worker_thread([this, key, source_write_time, cache_file]() {
+		std::ifstream stream(cache_file.string(), std::ios::in | std::ios::binary);
+		cache_header header;
+		if(stream.is_open())
+		{
+			stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+		}
+
+		if(stream.is_open() && header.magic == cache_magic && header.width == thumb_dim &&
+		   header.height == thumb_dim && header.source_write_time == source_write_time)
+		{
+			pending_upload upload;
+			upload.key = key;
+			upload.pixels.resize(std::size_t(thumb_dim) * thumb_dim * 4);
+			stream.read(reinterpret_cast<char*>(upload.pixels.data()),
+						static_cast<std::streamsize>(upload.pixels.size()));
+			if(stream)
+			{
+				std::lock_guard<std::mutex> lock(_queue_mutex);
+				_uploads.push_back(std::move(upload));
+				return;
+			}
+		}
+
+		// stale or missing - regenerate on the GPU
+		std::lock_guard<std::mutex> lock(_queue_mutex);
+		_generate_queue.emplace_back(key, source_write_time);
+	});
+
+	return {};
+}
+
+void thumbnail_cache::frame_render(std::chrono::duration<float>)
+{
+	pump_uploads();
+	pump_generation();
+}
+
+void thumbnail_cache::pump_uploads()
+{
+	// batch - a burst of cache hits after opening a folder spreads its
+	// uploads across frames instead of stalling one
+	std::vector<pending_upload> batch;
+	{
+		std::lock_guard<std::mutex> lock(_queue_mutex);
+		const auto count = std::min(uploads_per_frame, _uploads.size());
+		batch.assign(std::make_move_iterator(_uploads.begin()),
+					 std::make_move_iterator(_uploads.begin() + static_cast<std::ptrdiff_t>(count)));
+		_uploads.erase(_uploads.begin(), _uploads.begin() + static_cast<std::ptrdiff_t>(count));
+	}
+
+	for(auto& upload : batch)
+	{
+		const auto* mem =
+			gfx::copy(upload.pixels.data(), static_cast<std::uint32_t>(upload.pixels.size()));
+		auto thumbnail = std::make_shared<gfx::texture>(thumb_dim, thumb_dim, false, 1,
+														gfx::texture_format::RGBA8,
+														BGFX_TEXTURE_U_CLAMP | BGFX_TEXTURE_V_CLAMP, mem);
+		insert_resident(upload.key, std::move(thumbnail));
+	}
+}
+
+void thumbnail_cache::pump_generation()
+{
+	auto& renderer = core::get_subsystem<runtime::renderer>();
+
+	if(!_gpu_job)
+	{
+		std::pair<std::string, std::uint64_t> next;
+		{
+			std::lock_guard<std::mutex> lock(_queue_mutex);
+			if(_generate_queue.empty())
+			{
+				return;
+			}
+			next = std::move(_generate_queue.back());
+			_generate_queue.pop_back();
+		}
+
+		auto& am = core::get_subsystem<runtime::asset_manager>();
+		_gpu_job = std::make_unique<gpu_job>();
+		_gpu_job->key = next.first;
+		_gpu_job->source_write_time = next.second;
+		_gpu_job->source = am.load<gfx::texture>(next.first, runtime::load_mode::async);
+	}
+
+	if(!_gpu_job->rendered)
+	{
+		if(!_program || !_gpu_job->source.is_ready())
+		{
+			return;
+		}
+
+		auto source = _gpu_job->source.get();
+		if(!source)
+		{
+			_pending.erase(_gpu_job->key);
+			_gpu_job.reset();
+			return;
+		}
+
+		auto color = std::make_shared<gfx::texture>(
+			thumb_dim, thumb_dim, false, 1, gfx::texture_format::RGBA8,
+			0 | BGFX_TEXTURE_RT | BGFX_TEXTURE_MIN_POINT | BGFX_TEXTURE_MAG_POINT |
+				BGFX_TEXTURE_MIP_POINT | BGFX_TEXTURE_U_CLAMP | BGFX_TEXTURE_V_CLAMP);
+		_gpu_job->surface =
+			std::make_shared<gfx::frame_buffer>(std::vector<std::shared_ptr<gfx::texture>>{color});
+		_gpu_job->blit_tex = std::make_shared<gfx::texture>(
+			thumb_dim, thumb_dim, false, 1, gfx::texture_format::RGBA8,
+			0 | BGFX_TEXTURE_BLIT_DST | BGFX_TEXTURE_READ_BACK | BGFX_TEXTURE_MIN_POINT |
+				BGFX_TEXTURE_MAG_POINT | BGFX_TEXTURE_MIP_POINT | BGFX_TEXTURE_U_CLAMP |
+				BGFX_TEXTURE_V_CLAMP);
+		_gpu_job->readback.resize(std::size_t(thumb_dim) * thumb_dim * 4);
+
+		gfx::render_pass pass("thumbnail_downscale");
+		pass.bind(_gpu_job->surface.get());
+		pass.clear(BGFX_CLEAR_COLOR, 0x000000ff, 1.0f, 0);
+
+		_program->begin();
+		_program->set_texture(0, "s_input", source.get());
+		gfx::set_scissor(0, 0, thumb_dim, thumb_dim);
+		auto topology = gfx::clip_quad(1.0f);
+		gfx::set_state(topology | BGFX_STATE_RGB_WRITE | BGFX_STATE_ALPHA_WRITE);
+		gfx::submit(pass.id, _program->native_handle());
+		gfx::set_state(BGFX_STATE_DEFAULT);
+		_program->end();
+
+		gfx::render_pass blit_pass("thumbnail_readback");
+		gfx::blit(blit_pass.id, _gpu_job->blit_tex->native_handle(), 0, 0,
+				  _gpu_job->surface->get_texture()->native_handle());
+		_gpu_job->reading = gfx::read_texture(_gpu_job->blit_tex->native_handle(),
+											  _gpu_job->readback.data());
+		_gpu_job->rendered = true;
+
+		// the render target itself is the thumbnail - usable right away,
+		// the readback below only feeds the disk cache
+		insert_resident(_gpu_job->key, _gpu_job->surface->get_texture());
+		return;
+	}
+
+	if(_gpu_job->reading <= renderer.get_render_frame())
+	{
+		// persist on a worker - the render thread only hands the pixels off
+		auto key = std::move(_gpu_job->key);
+		auto pixels = std::move(_gpu_job->readback);
+		auto source_write_time = _gpu_job->source_write_time;
+		_gpu_job.reset();
+
+		auto& ts = core::get_subsystem<core::task_system>();
+		ts.push_on_worker_thread([key, pixels, source_write_time]() {
+			const auto cache_file = cache_file_for(key);
+			std::ofstream stream(cache_file.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+			if(!stream.is_open())
+			{
+				return;
+			}
+
+			cache_header header;
+			header.width = thumb_dim;
+			header.height = thumb_dim;
+			header.source_write_time = source_write_time;
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			stream.write(reinterpret_cast<const char*>(pixels.data()),
+						 static_cast<std::streamsize>(pixels.size()));
+		});
+	}
+}
+
+void thumbnail_cache::insert_resident(const std::string& key, std::shared_ptr<gfx::texture> thumbnail)
+{
+	asset_handle<gfx::texture> handle;
+	handle.link->asset = std::move(thumbnail);
+
+	auto it = _resident.find(key);
+	if(it != _resident.end())
+	{
+		it->second.thumbnail = handle;
+		_lru.splice(_lru.begin(), _lru, it->second.lru_it);
+	}
+	else
+	{
+		_lru.push_front(key);
+		_resident[key] = {handle, _lru.begin()};
+
+		while(_resident.size() > max_resident)
+		{
+			_resident.erase(_lru.back());
+			_lru.pop_back();
+		}
+	}
+
+	_pending.erase(key);
+}
+
+fs::path thumbnail_cache::cache_file_for(const std::string& key)
+{
+	const auto hash = std::hash<std::string>()(key);
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.thumb", static_cast<unsigned long long>(hash));
+	return fs::resolve_protocol("editor:/cache/thumbnails") / name;
+}
+
+thumbnail_cache::thumbnail_cache()
+{
+	fs::error_code err;
+	fs::create_directories(fs::resolve_protocol("editor:/cache/thumbnails"), err);
+
+	auto& ts = core::get_subsystem<core::task_system>();
+	auto& am = core::get_subsystem<runtime::asset_manager>();
+
+	auto vs_clip_quad = am.load<gfx::shader>("engine:/data/shaders/vs_clip_quad.sc");
+	auto fs_thumbnail = am.load<gfx::shader>("editor:/data/shaders/fs_thumbnail.sc");
+
+	ts.push_or_execute_on_owner_thread(
+		[this](asset_handle<gfx::shader> vs, asset_handle<gfx::shader> fs) {
+			_program = std::make_unique<gpu_program>(vs, fs);
+		},
+		vs_clip_quad, fs_thumbnail);
+
+	runtime::on_frame_render.connect(this, &thumbnail_cache::frame_render);
+}
+
+thumbnail_cache::~thumbnail_cache()
+{
+	runtime::on_frame_render.disconnect(this, &thumbnail_cache::frame_render);
+}
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "core/filesystem/filesystem.h"
+#include "core/tasks/task_system.h"
+#include "runtime/assets/asset_handle.h"
+#include "runtime/rendering/gpu_program.h"
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace gfx
+{
+struct frame_buffer;
+struct texture;
+}
+
+namespace editor
+{
+//-----------------------------------------------------------------------------
+//  Name : thumbnail_cache (Class)
+/// <summary>
+/// Background thumbnail pipeline for the asset browser. Thumbnails are
+/// generated once on the GPU (a downscale pass into a small render target),
+/// persisted under editor_data/cache/thumbnails, and on later runs read back
+/// from disk on worker threads with GPU uploads batched per frame - so
+/// scrolling a folder never decodes or uploads full textures on the UI
+/// thread. Resident thumbnails are kept in an LRU map capped at
+/// max_resident.
+/// </summary>
+//-----------------------------------------------------------------------------
+class thumbnail_cache
+{
+public:
+	thumbnail_cache();
+	~thumbnail_cache();
+
+	/// pixel dimension of generated thumbnails
+	static const std::uint16_t thumb_dim = 128;
+
+	/// resident thumbnails kept before the least recently requested drop
+	static const std::size_t max_resident = 512;
+
+	/// texture uploads performed per frame when draining the disk cache
+	static const std::size_t uploads_per_frame = 8;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_thumbnail ()
+	/// <summary>
+	/// The thumbnail for an asset, or a null handle while one is still
+	/// being read or generated - callers fall back to their type icon.
+	/// Requesting is what schedules the background work, so only assets
+	/// actually scrolled into view ever get processed.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	asset_handle<gfx::texture> get_thumbnail(const std::string& key, const fs::path& absolute_path);
+
+	//-----------------------------------------------------------------------------
+	//  Name : frame_render ()
+	/// <summary>
+	/// Per-frame pump - batches pending GPU uploads, advances the single
+	/// in-flight generation job and kicks the next queued one.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void frame_render(std::chrono::duration<float> dt);
+
+private:
+	/// decoded cache file waiting for its batched GPU upload
+	struct pending_upload
+	{
+		std::string key;
+		std::vector<std::uint8_t> pixels;
+	};
+
+	/// a thumbnail generation in flight - render, readback, persist
+	struct gpu_job
+	{
+		std::string key;
+		std::uint64_t source_write_time = 0;
+		core::task_future<asset_handle<gfx::texture>> source;
+		std::shared_ptr<gfx::frame_buffer> surface;
+		std::shared_ptr<gfx::texture> blit_tex;
+		std::vector<std::uint8_t> readback;
+		std::uint32_t reading = 0;
+		bool rendered = false;
+	};
+
+	void insert_resident(const std::string& key, std::shared_ptr<gfx::texture> thumbnail);
+	void pump_uploads();
+	void pump_generation();
+
+	static fs::path cache_file_for(const std::string& key);
+
+	/// resident thumbnails and their position in the lru order
+	struct resident
+	{
+		asset_handle<gfx::texture> thumbnail;
+		std::list<std::string>::iterator lru_it;
+	};
+	std::unordered_map<std::string, resident> _resident;
+
+	/// most recently requested keys first
+	std::list<std::string> _lru;
+
+	/// keys with background work in flight
+	std::unordered_set<std::string> _pending;
+
+	/// guards the queues the worker threads push into
+	std::mutex _queue_mutex;
+
+	/// cache files read on workers, waiting for their batched upload
+	std::vector<pending_upload> _uploads;
+
+	/// keys with no valid cache file - they need the GPU path
+	std::vector<std::pair<std::string, std::uint64_t>> _generate_queue;
+
+	/// the single generation job in flight
+	std::unique_ptr<gpu_job> _gpu_job;
+
+	/// downscale program - clip quad + passthrough sample
+	std::unique_ptr<gpu_program> _program;
+};
+}
@@ -3,10 +3,17 @@
 
 void console_log::_sink_it(const logging::details::log_msg& msg)
 {
+	const auto enqueue_pos = _enqueue_pos.load(std::memory_order_relaxed);
+	const auto dequeue_pos = _dequeue_pos.load(std::memory_order_acquire);
+	if(enqueue_pos - dequeue_pos >= queue_capacity)
 	{
-		std::lock_guard<std::recursive_mutex> lock(_entries_mutex);
-		_entries.push_back({msg.formatted.c_str(), msg.level});
+		// queue full - never block the producer, just count the loss
+		_dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
 	}
+
+	_queue[enqueue_pos & (queue_capacity - 1)] = {msg.formatted.c_str(), msg.level};
+	_enqueue_pos.store(enqueue_pos + 1, std::memory_order_release);
 	_has_new_entries = true;
 }
 
@@ -14,22 +21,35 @@ void console_log::_flush()
 {
 }
 
-console_log::entries_t console_log::get_items()
+const console_log::entries_t& console_log::get_items()
 {
-	entries_t items_copy;
+	// batched consumption - everything queued since the last call moves into
+	// the display buffer in one pass
+	auto dequeue_pos = _dequeue_pos.load(std::memory_order_relaxed);
+	const auto enqueue_pos = _enqueue_pos.load(std::memory_order_acquire);
+	while(dequeue_pos != enqueue_pos)
+	{
+		_entries.push_back(std::move(_queue[dequeue_pos & (queue_capacity - 1)]));
+		++dequeue_pos;
+	}
+	_dequeue_pos.store(dequeue_pos, std::memory_order_release);
+
+	const auto dropped = _dropped.exchange(0, std::memory_order_relaxed);
+	if(dropped > 0)
 	{
-		std::lock_guard<std::recursive_mutex> lock(_entries_mutex);
-		items_copy = _entries;
+		_entries.push_back(
+			{"[console] dropped " + std::to_string(dropped) + " message(s)", logging::level::warn});
 	}
-	return items_copy;
+
+	return _entries;
 }
 
 void console_log::clear_log()
 {
-	{
-		std::lock_guard<std::recursive_mutex> lock(_entries_mutex);
-		_entries.clear();
-	}
+	// discard whatever is still queued, then the display buffer
+	_dequeue_pos.store(_enqueue_pos.load(std::memory_order_acquire), std::memory_order_release);
+	_dropped.store(0, std::memory_order_relaxed);
+	_entries.clear();
 	_has_new_entries = false;
 }
 
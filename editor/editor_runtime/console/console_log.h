@@ -3,6 +3,7 @@
 #include "core/logging/logging.h"
 #include <array>
 #include <atomic>
+#include <cstdint>
 #include "core/console/console.h"
 #include "core/common/nonstd/ring_buffer.hpp"
 #include <string>
@@ -12,14 +13,17 @@ class console_log : public logging::sinks::base_sink<std::mutex>, public console
 public:
     template<typename T>
     using ring_buffer = nonstd::stack_ringbuffer<T, 150>;
-	using entries_t = ring_buffer<std::pair<std::string, logging::level::level_enum>>;
+	using entry_t = std::pair<std::string, logging::level::level_enum>;
+	using entries_t = ring_buffer<entry_t>;
+
+	/// capacity of the sink-to-ui queue, power of two
+	static const std::size_t queue_capacity = 512;
 
 	//-----------------------------------------------------------------------------
 	//  Name : _sink_it ()
 	/// <summary>
-	///
-	///
-	///
+	/// Pushes into the fixed queue without blocking - when the ui falls
+	/// behind and the queue is full the message is counted as dropped.
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	void _sink_it(const logging::details::log_msg& msg) override;
@@ -37,12 +41,11 @@ public:
 	//-----------------------------------------------------------------------------
 	//  Name : get_items ()
 	/// <summary>
-	///
-	///
-	///
+	/// Drains everything queued since the last call into the display
+	/// buffer. Call from the ui thread only.
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	entries_t get_items();
+	const entries_t& get_items();
 
 	//-----------------------------------------------------------------------------
 	//  Name : clearLog ()
@@ -82,8 +85,16 @@ public:
 	}
 
 private:
-	std::recursive_mutex _entries_mutex;
+	/// fixed queue slots - producers are serialized by the sink mutex, the
+	/// ui thread consumes without ever taking it
+	std::array<entry_t, queue_capacity> _queue;
+	///
+	std::atomic<std::size_t> _enqueue_pos = {0};
 	///
+	std::atomic<std::size_t> _dequeue_pos = {0};
+	/// messages discarded because the queue was full
+	std::atomic<std::uint64_t> _dropped = {0};
+	/// display buffer, owned by the ui thread
 	entries_t _entries;
 	///
 	std::atomic<bool> _has_new_entries = {false};
@@ -111,10 +111,18 @@ struct editing_system
 	runtime::entity camera;
 	/// current scene
 	std::string scene;
+	/// frame of the last full scene save - components touched after it
+	/// are what the incremental autosave journals
+	std::uint32_t last_save_frame = 0;
+	/// root count at the last full save - a change means entities were
+	/// removed or restored, which the journal cannot express
+	std::size_t last_save_roots = 0;
 	/// enable editor grid
 	bool show_grid = true;
 	/// enable wireframe selection
 	bool wireframe_selection = true;
+	/// show the runtime statistics overlay
+	bool show_stats = false;
 	/// current manipulation gizmo operation.
 	imguizmo::operation operation = imguizmo::translate;
 	/// current manipulation gizmo space.
@@ -0,0 +1,224 @@
+#include "hlod_builder.h"
+
+#include "core/logging/logging.h"
+#include "core/system/subsystem.h"
+#include "runtime/assets/asset_manager.h"
+#include "runtime/ecs/components/hlod_component.h"
+#include "runtime/ecs/components/model_component.h"
+#include "runtime/ecs/components/transform_component.h"
+#include "runtime/ecs/ecs.h"
+#include "runtime/rendering/mesh.h"
+#include "runtime/rendering/mesh_tools.h"
+#include "runtime/rendering/model.h"
+
+#include <cmath>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace editor
+{
+namespace
+{
+//-----------------------------------------------------------------------------
+//  Name : cell_key () (Local)
+/// <summary>
+/// Packs a signed 3d grid cell into one hashable key (21 bits per axis).
+/// </summary>
+//-----------------------------------------------------------------------------
+std::uint64_t cell_key(std::int32_t x, std::int32_t y, std::int32_t z)
+{
+	const std::uint64_t bias = 0x100000;
+	const std::uint64_t mask = 0x1FFFFF;
+	return ((std::uint64_t(x) + bias) & mask) | (((std::uint64_t(y) + bias) & mask) << 21) |
+		   (((std::uint64_t(z) + bias) & mask) << 42);
+}
+
+/// Running build count, so rebuilt proxies register under fresh embedded
+/// keys instead of resolving to the previous build's cached instances.
+std::uint32_t s_build_generation = 0;
+}
+
+std::size_t build_hlod_clusters(float cell_size, std::size_t target_face_count,
+								float screen_size_threshold)
+{
+	clear_hlod_clusters();
+	++s_build_generation;
+
+	auto& ecs = core::get_subsystem<runtime::entity_component_system>();
+	auto& am = core::get_subsystem<runtime::asset_manager>();
+
+	// Bucket static models into grid cells by world bounds center.
+	struct cluster_info
+	{
+		std::vector<runtime::entity> members;
+		math::bbox bounds;
+	};
+	std::unordered_map<std::uint64_t, cluster_info> clusters;
+
+	ecs.for_each<transform_component, model_component>(
+		[&clusters, cell_size](runtime::entity e, transform_component& transform_comp,
+							   model_component& model_comp) {
+			if(!model_comp.is_static())
+				return;
+
+			const auto& bounds = model_comp.get_world_bounds(transform_comp);
+			if(!bounds.is_populated())
+				return;
+
+			const auto center = bounds.get_center();
+			auto& cluster =
+				clusters[cell_key(std::int32_t(std::floor(center.x / cell_size)),
+								  std::int32_t(std::floor(center.y / cell_size)),
+								  std::int32_t(std::floor(center.z / cell_size)))];
+			cluster.members.push_back(e);
+			cluster.bounds.add_point(bounds.min);
+			cluster.bounds.add_point(bounds.max);
+		});
+
+	const auto& format = gfx::mesh_vertex::get_layout();
+	const std::uint16_t stride = format.getStride();
+
+	std::size_t built = 0;
+	for(auto& pair : clusters)
+	{
+		auto& cluster = pair.second;
+		// A single model gains nothing from a merged stand-in; its own LOD
+		// chain already covers it.
+		if(cluster.members.size() < 2)
+			continue;
+
+		// Merge every member's base mesh into one triangle soup, in world
+		// space relative to the cluster center so the proxy transform stays
+		// a plain translation.
+		const auto cluster_center = cluster.bounds.get_center();
+		std::vector<math::vec3> positions;
+		std::vector<std::uint32_t> indices;
+		for(const auto& member : cluster.members)
+		{
+			auto transform_comp = member.get_component<transform_component>().lock();
+			auto model_comp = member.get_component<model_component>().lock();
+			if(!transform_comp || !model_comp)
+				continue;
+
+			auto lod = model_comp->get_model().get_lod(0);
+			if(!lod)
+				continue;
+			auto* member_mesh = lod.get();
+			const auto& member_format = member_mesh->get_vertex_format();
+			if(member_mesh->get_vertex_count() == 0 || member_mesh->get_system_vb() == nullptr ||
+			   member_mesh->get_system_ib() == nullptr || !member_format.has(gfx::attribute::Position))
+				continue;
+
+			const auto& world = transform_comp->get_transform();
+			const auto base_vertex = std::uint32_t(positions.size());
+			for(std::uint32_t i = 0; i < member_mesh->get_vertex_count(); ++i)
+			{
+				float pos[4];
+				gfx::vertex_unpack(pos, gfx::attribute::Position, member_format,
+								   member_mesh->get_system_vb(), i);
+				positions.push_back(world.transform_coord(math::vec3(pos[0], pos[1], pos[2])) -
+									cluster_center);
+			}
+
+			const std::uint32_t* indices_ptr = member_mesh->get_system_ib();
+			const std::uint32_t index_count = member_mesh->get_face_count() * 3;
+			for(std::uint32_t i = 0; i < index_count; ++i)
+				indices.push_back(base_vertex + indices_ptr[i]);
+		}
+
+		if(indices.size() < 3)
+			continue;
+
+		// Collapse the soup down to the proxy budget.
+		std::vector<std::uint32_t> simplified;
+		triangle_mesh_tools::simplify(positions, indices, target_face_count, simplified);
+		if(simplified.empty())
+			simplified = indices;
+
+		// Area-weighted vertex normals from the simplified faces; the soup
+		// carries no other attributes worth preserving at proxy distances.
+		std::vector<math::vec3> normals(positions.size(), math::vec3(0.0f, 0.0f, 0.0f));
+		for(std::size_t i = 0; i < simplified.size(); i += 3)
+		{
+			const auto& a = positions[simplified[i]];
+			const auto& b = positions[simplified[i + 1]];
+			const auto& c = positions[simplified[i + 2]];
+			const auto face_normal = math::cross(b - a, c - a);
+			normals[simplified[i]] += face_normal;
+			normals[simplified[i + 1]] += face_normal;
+			normals[simplified[i + 2]] += face_normal;
+		}
+
+		std::vector<std::uint8_t> vertex_data(positions.size() * stride, 0);
+		for(std::size_t i = 0; i < positions.size(); ++i)
+		{
+			float pos[4] = {positions[i].x, positions[i].y, positions[i].z, 1.0f};
+			gfx::vertex_pack(pos, false, gfx::attribute::Position, format, vertex_data.data(),
+							 std::uint32_t(i));
+
+			auto normal_vec = normals[i];
+			const float len = math::length(normal_vec);
+			normal_vec = len > 0.0f ? normal_vec / len : math::vec3(0.0f, 1.0f, 0.0f);
+			float normal[4] = {normal_vec.x, normal_vec.y, normal_vec.z, 0.0f};
+			gfx::vertex_pack(normal, true, gfx::attribute::Normal, format, vertex_data.data(),
+							 std::uint32_t(i));
+		}
+
+		mesh::triangle_array_t faces;
+		faces.reserve(simplified.size() / 3);
+		for(std::size_t i = 0; i < simplified.size(); i += 3)
+		{
+			mesh::triangle tri;
+			tri.indices[0] = simplified[i];
+			tri.indices[1] = simplified[i + 1];
+			tri.indices[2] = simplified[i + 2];
+			faces.push_back(tri);
+		}
+
+		auto proxy_mesh = std::make_shared<mesh>();
+		if(!proxy_mesh->prepare_mesh(format, vertex_data.data(), std::uint32_t(positions.size()), faces))
+			continue;
+
+		std::ostringstream key;
+		key << "embedded:/hlod?" << s_build_generation << '/' << std::hex << pair.first;
+		auto proxy_handle = am.load_asset_from_instance(key.str(), proxy_mesh).get();
+
+		model proxy_model;
+		proxy_model.set_lod(proxy_handle, 0);
+
+		auto object = ecs.create();
+		object.set_name("HLOD Cluster");
+		object.assign<transform_component>().lock()->set_position(cluster_center);
+		object.assign<model_component>()
+			.lock()
+			->set_static(true)
+			.set_casts_shadow(true)
+			.set_casts_reflection(false)
+			.set_model(proxy_model);
+		object.assign<hlod_component>()
+			.lock()
+			->set_members(cluster.members)
+			.set_cluster_bounds(cluster.bounds)
+			.set_screen_size_threshold(screen_size_threshold);
+
+		++built;
+		APPLOG_INFO("HLOD cluster with {0} members merged to {1} faces", cluster.members.size(),
+					faces.size());
+	}
+
+	return built;
+}
+
+void clear_hlod_clusters()
+{
+	auto& ecs = core::get_subsystem<runtime::entity_component_system>();
+
+	std::vector<runtime::entity> proxies;
+	ecs.for_each<hlod_component>(
+		[&proxies](runtime::entity e, hlod_component&) { proxies.push_back(e); });
+
+	for(auto& proxy : proxies)
+		proxy.destroy();
+}
+}
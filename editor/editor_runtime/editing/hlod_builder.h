@@ -0,0 +1,32 @@
+#pragma once
+#include "core/math/math_includes.h"
+
+#include <cstddef>
+
+namespace editor
+{
+//-----------------------------------------------------------------------------
+//  Name : build_hlod_clusters ()
+/// <summary>
+/// Builds hierarchical LOD proxies for the current scene: static model
+/// entities are clustered into world-space grid cells of 'cell_size'
+/// meters, each cluster's meshes are merged into one world-space
+/// triangle soup, simplified down to roughly 'target_face_count' faces
+/// and registered as an embedded proxy mesh. A proxy entity carrying the
+/// merged model and an hlod_component is created per cluster; at runtime
+/// the renderer swaps between proxy and members by projected screen
+/// size. Any previously built clusters are rebuilt from scratch.
+/// Returns the number of clusters created.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::size_t build_hlod_clusters(float cell_size = 50.0f, std::size_t target_face_count = 500,
+								float screen_size_threshold = 0.05f);
+
+//-----------------------------------------------------------------------------
+//  Name : clear_hlod_clusters ()
+/// <summary>
+/// Destroys all HLOD proxy entities in the current scene.
+/// </summary>
+//-----------------------------------------------------------------------------
+void clear_hlod_clusters();
+}
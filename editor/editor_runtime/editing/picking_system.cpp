@@ -8,6 +8,7 @@
 #include "runtime/ecs/components/camera_component.h"
 #include "runtime/ecs/components/model_component.h"
 #include "runtime/ecs/components/transform_component.h"
+#include "runtime/ecs/systems/spatial_index.h"
 #include "runtime/input/input.h"
 #include "runtime/rendering/camera.h"
 #include "runtime/rendering/material.h"
@@ -17,6 +18,8 @@
 #include "runtime/rendering/renderer.h"
 #include "runtime/system/events.h"
 
+#include <unordered_set>
+
 namespace editor
 {
 constexpr int picking_system::tex_id_dim;
@@ -32,10 +35,23 @@ void picking_system::frame_render(std::chrono::duration<float>)
 
 	if(input.is_mouse_button_pressed(mml::mouse::left))
 	{
-		auto& editor_camera = es.camera;
-		if(imguizmo::is_over() && es.selection_data.object)
-			return;
+		const bool over_gizmo = imguizmo::is_over() && es.selection_data.object;
+		if(!over_gizmo)
+		{
+			// Record the click only - the render kicks off below once no
+			// readback is in flight. A newer click simply overwrites a
+			// pending one, so queued picks coalesce to the latest.
+			const auto& mouse_pos = input.get_current_cursor_position();
+			_pick_cursor = math::vec2{mouse_pos.x, mouse_pos.y};
+			_pick_requested = true;
+		}
+	}
 
+	if(_pick_requested && !_reading && !_start_readback)
+	{
+		_pick_requested = false;
+
+		auto& editor_camera = es.camera;
 		if(!editor_camera || !editor_camera.has_component<camera_component>())
 			return;
 
@@ -44,22 +60,19 @@ void picking_system::frame_render(std::chrono::duration<float>)
 		const auto& current_camera = camera_comp_ptr->get_camera();
 		const auto near_clip = current_camera.get_near_clip();
 		const auto far_clip = current_camera.get_far_clip();
-		const auto& mouse_pos = input.get_current_cursor_position();
 		const auto& frustum = current_camera.get_frustum();
-		math::vec2 cursor_pos = math::vec2{mouse_pos.x, mouse_pos.y};
 		math::vec3 pick_eye;
 		math::vec3 pick_at;
 		math::vec3 pick_up = {0.0f, 1.0f, 0.0f};
 
-		if(!current_camera.viewport_to_world(cursor_pos, frustum.planes[math::volume_plane::near_plane],
-											 pick_eye, true))
+		if(!current_camera.viewport_to_world(
+			   _pick_cursor, frustum.planes[math::volume_plane::near_plane], pick_eye, true))
 			return;
 
-		if(!current_camera.viewport_to_world(cursor_pos, frustum.planes[math::volume_plane::far_plane],
-											 pick_at, true))
+		if(!current_camera.viewport_to_world(
+			   _pick_cursor, frustum.planes[math::volume_plane::far_plane], pick_at, true))
 			return;
 
-		_reading = 0;
 		_start_readback = true;
 
 		camera pick_camera;
@@ -80,34 +93,63 @@ void picking_system::frame_render(std::chrono::duration<float>)
 
 		pass.set_view_proj(pick_view, pick_proj);
 
-		ecs.for_each<transform_component, model_component>(
-			[this, &pass, &pick_frustum](runtime::entity e, transform_component& transform_comp_ref,
-										 model_component& model_comp_ref) {
-				auto& model = model_comp_ref.get_model();
-				if(!model.is_valid())
-					return;
-
-				const auto& world_transform = transform_comp_ref.get_transform();
-
-				auto mesh = model.get_lod(0);
-				if(!mesh)
-					return;
-
-				const auto& bounds = mesh->get_bounds();
+		auto draw_pickable = [this, &pass, &pick_frustum,
+							  &pick_camera](runtime::entity e, transform_component& transform_comp_ref,
+											model_component& model_comp_ref) {
+			auto& model = model_comp_ref.get_model();
+			if(!model.is_valid())
+				return;
+
+			const auto& world_transform = transform_comp_ref.get_transform();
+
+			auto mesh = model.get_lod(0);
+			if(!mesh)
+				return;
+
+			const auto& bounds = mesh->get_bounds();
+
+			// Test the bounding box of the mesh
+			if(!math::frustum::test_obb(pick_frustum, bounds, world_transform))
+				return;
+
+			auto entity_index = e.id().index();
+			std::uint32_t rr = (entity_index)&0xff;
+			std::uint32_t gg = (entity_index >> 8) & 0xff;
+			std::uint32_t bb = (entity_index >> 16) & 0xff;
+			math::vec4 color_id = {rr / 255.0f, gg / 255.0f, bb / 255.0f, 1.0f};
+
+			auto& skinning = model_comp_ref.get_skinning_data();
+			model.render(pass.id, world_transform, &skinning, true, true, true, 0, 0, _program.get(),
+						 [&color_id](auto& p) { p.set_uniform("u_id", &color_id); },
+						 {gfx::invalid_handle}, &pick_camera);
+		};
+
+		// Broad phase: the pick frustum is a sliver around the pick ray,
+		// so asking the spatial index which entities it may touch submits
+		// a handful of draws instead of the whole pickable scene.
+		// Entities the index does not know about fall through to the fine
+		// test untouched, same as the renderer's visibility gather.
+		std::unordered_set<runtime::entity> broad_hit;
+		runtime::spatial_index* spatial = nullptr;
+		if(core::has_subsystems<runtime::spatial_index>())
+		{
+			spatial = &core::get_subsystem<runtime::spatial_index>();
+			std::vector<runtime::entity> query_result;
+			spatial->query_frustum(pick_frustum, query_result);
+			broad_hit.insert(query_result.begin(), query_result.end());
+		}
 
-				// Test the bounding box of the mesh
-				if(!math::frustum::test_obb(pick_frustum, bounds, world_transform))
+		ecs.for_each<transform_component, model_component>(
+			[&](runtime::entity e, transform_component& transform_comp_ref,
+				model_component& model_comp_ref) {
+				math::bbox indexed_bounds;
+				if(spatial != nullptr && broad_hit.find(e) == broad_hit.end() &&
+				   spatial->get_bounds(e, indexed_bounds))
+				{
+					// Indexed and rejected by the broad phase.
 					return;
-
-				auto entity_index = e.id().index();
-				std::uint32_t rr = (entity_index)&0xff;
-				std::uint32_t gg = (entity_index >> 8) & 0xff;
-				std::uint32_t bb = (entity_index >> 16) & 0xff;
-				math::vec4 color_id = {rr / 255.0f, gg / 255.0f, bb / 255.0f, 1.0f};
-
-				const auto& bone_transforms = model_comp_ref.get_bone_transforms();
-				model.render(pass.id, world_transform, bone_transforms, true, true, true, 0, 0,
-							 _program.get(), [&color_id](auto& p) { p.set_uniform("u_id", &color_id); });
+				}
+				draw_pickable(e, transform_comp_ref, model_comp_ref);
 			});
 	}
 
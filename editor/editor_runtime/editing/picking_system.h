@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/math/math_includes.h"
 #include "runtime/assets/asset_handle.h"
 #include "runtime/rendering/gpu_program.h"
 #include <chrono>
@@ -42,5 +43,10 @@ private:
 	std::uint32_t _reading = 0;
 	///
 	bool _start_readback = false;
+	/// a click waiting for the in-flight pick to finish - newer clicks
+	/// overwrite it, so queued picks coalesce to the latest
+	bool _pick_requested = false;
+	/// cursor position of the pending pick request
+	math::vec2 _pick_cursor = {0.0f, 0.0f};
 };
 }
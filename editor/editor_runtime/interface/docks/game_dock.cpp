@@ -18,6 +18,14 @@ void game_dock::render(const ImVec2&)
 		auto size = gui::GetContentRegionAvail();
 		if(size.x > 0.0f && size.y > 0.0f)
 		{
+			// Game cameras are presenter gated on dock visibility only: the
+			// running simulation animates the view, so a visible game dock
+			// keeps the full refresh rate while a hidden one skips rendering
+			// entirely.
+			camera_comp.set_render_on_demand(true);
+			camera_comp.request_present();
+			camera_comp.request_refresh();
+
 			camera_comp.set_viewport_size(
 				{static_cast<std::uint32_t>(size.x), static_cast<std::uint32_t>(size.y)});
 			const auto& camera = camera_comp.get_camera();
@@ -198,7 +198,28 @@ void check_drag(runtime::entity entity)
 	}
 }
 
-void hierarchy_dock::draw_entity(runtime::entity entity)
+void hierarchy_dock::build_rows(runtime::entity entity, int depth)
+{
+	if(!entity)
+		return;
+
+	row_cache.push_back({entity, depth});
+
+	if(expanded.count(entity.id().index()) == 0)
+		return;
+
+	auto transform_comp = entity.get_component<transform_component>().lock();
+	if(!transform_comp)
+		return;
+
+	for(const auto& child : transform_comp->get_children())
+	{
+		if(child.valid())
+			build_rows(child, depth + 1);
+	}
+}
+
+void hierarchy_dock::draw_entity(runtime::entity entity, int depth)
 {
 	if(!entity)
 		return;
@@ -216,8 +237,11 @@ void hierarchy_dock::draw_entity(runtime::entity entity)
 		is_selected = selected.get_value<runtime::entity>() == entity;
 	}
 
+	// Rows are flat - depth becomes indentation and opening never pushes
+	// the id/indent stacks, which is what lets the clipper skip rows.
 	std::string name = entity.to_string();
-	ImGuiTreeNodeFlags flags = 0 | ImGuiTreeNodeFlags_AllowOverlapMode | ImGuiTreeNodeFlags_OpenOnArrow;
+	ImGuiTreeNodeFlags flags = 0 | ImGuiTreeNodeFlags_AllowOverlapMode | ImGuiTreeNodeFlags_OpenOnArrow |
+							   ImGuiTreeNodeFlags_NoTreePushOnOpen;
 
 	if(is_selected)
 		flags |= ImGuiTreeNodeFlags_Selected;
@@ -238,10 +262,25 @@ void hierarchy_dock::draw_entity(runtime::entity entity)
 	if(no_children)
 		flags |= ImGuiTreeNodeFlags_Leaf;
 
+	const bool was_expanded = expanded.count(entity.id().index()) != 0;
+	const float indent = depth * gui::GetTreeNodeToLabelSpacing();
+	if(indent > 0.0f)
+		gui::Indent(indent);
+
+	gui::SetNextTreeNodeOpen(was_expanded, ImGuiCond_Always);
+
 	auto pos = gui::GetCursorScreenPos();
 	gui::AlignTextToFramePadding();
 	bool opened = gui::TreeNodeEx(name.c_str(), flags);
 
+	if(!no_children && opened != was_expanded)
+	{
+		if(opened)
+			expanded.insert(entity.id().index());
+		else
+			expanded.erase(entity.id().index());
+	}
+
 	if(!edit_label)
 	{
 		check_drag(entity);
@@ -307,20 +346,8 @@ void hierarchy_dock::draw_entity(runtime::entity entity)
 		}
 	}
 
-	if(opened)
-	{
-		if(!no_children)
-		{
-			const auto& children = entity.get_component<transform_component>().lock()->get_children();
-			for(auto& child : children)
-			{
-				if(child.valid())
-					draw_entity(child);
-			}
-		}
-
-		gui::TreePop();
-	}
+	if(indent > 0.0f)
+		gui::Unindent(indent);
 
 	gui::PopID();
 	gui::PopID();
@@ -380,16 +407,32 @@ void hierarchy_dock::render(const ImVec2&)
 
 	if(editor_camera.valid())
 	{
-		draw_entity(editor_camera);
+		draw_entity(editor_camera, 0);
 		gui::Separator();
 	}
 
+	// Flatten the expanded tree first - no imgui work, no name formatting
+	// - then let the clipper materialize only the rows that fall inside
+	// the visible scroll region, so cost tracks visible rows rather than
+	// scene size.
+	row_cache.clear();
 	for(auto& root : roots)
 	{
 		if(root.valid())
 		{
 			if(root != editor_camera)
-				draw_entity(root);
+				build_rows(root, 0);
+		}
+	}
+
+	ImGuiListClipper clipper(static_cast<int>(row_cache.size()), gui::GetFrameHeightWithSpacing());
+	while(clipper.Step())
+	{
+		for(int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+		{
+			const auto& entry = row_cache[static_cast<std::size_t>(i)];
+			if(entry.entity.valid())
+				draw_entity(entry.entity, entry.depth);
 		}
 	}
 
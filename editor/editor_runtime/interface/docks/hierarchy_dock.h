@@ -3,14 +3,46 @@
 #include "imguidock.h"
 #include "runtime/ecs/ecs.h"
 
+#include <unordered_set>
+#include <vector>
+
 struct hierarchy_dock : public imguidock::dock
 {
 	hierarchy_dock(const std::string& dtitle, bool close_button, const ImVec2& min_size);
 
 	void render(const ImVec2& area);
-    
-    void draw_entity(runtime::entity entity);
-    
-    bool edit_label = false;
-    ImGuiID id = 0;    
+
+	//-----------------------------------------------------------------------------
+	//  Name : draw_entity ()
+	/// <summary>
+	/// Draws one flat tree row at the given depth. Expansion is owned by
+	/// this dock (not imgui) so the tree can be flattened without touching
+	/// every node's imgui state.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void draw_entity(runtime::entity entity, int depth);
+
+	//-----------------------------------------------------------------------------
+	//  Name : build_rows ()
+	/// <summary>
+	/// Flattens the subtree into row_cache, recursing only into expanded
+	/// nodes. Does no imgui work and formats no names, so it stays cheap
+	/// even with tens of thousands of entities.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void build_rows(runtime::entity entity, int depth);
+
+	/// one visible row of the flattened tree
+	struct row
+	{
+		runtime::entity entity;
+		int depth = 0;
+	};
+
+	bool edit_label = false;
+	ImGuiID id = 0;
+	/// entity indices whose tree node is expanded
+	std::unordered_set<std::uint32_t> expanded;
+	/// flattened visible rows, rebuilt every frame
+	std::vector<row> row_cache;
 };
@@ -1,4 +1,5 @@
 #include "project_dock.h"
+#include "../../assets/thumbnail_cache.h"
 #include "../../editing/editing_system.h"
 #include "core/audio/sound.h"
 #include "core/common/nonstd/function_traits.hpp"
@@ -224,6 +225,18 @@ void project_dock::render(const ImVec2&)
 	fs::error_code err;
 	if(_root != root_path || !fs::exists(_cache.get_path(), err))
 	{
+		// Each project carries its own listing snapshot; swap it along
+		// with the root so a reopened project starts warm instead of
+		// re-stat-ing the whole data tree.
+		if(_snapshot)
+		{
+			_snapshot->save(_snapshot_file);
+		}
+		_snapshot = std::make_shared<fs::directory_snapshot>();
+		_snapshot_file = fs::resolve_protocol("app:/settings") / "project_dock.fscache";
+		_snapshot->load(_snapshot_file);
+		_cache.set_snapshot(_snapshot);
+
 		_root = root_path;
 		_cache.set_path(_root);
 	}
@@ -345,290 +358,248 @@ void project_dock::render(const ImVec2&)
 			{
 
 				bool processed = false;
-				for(const auto& ext : ex::get_suported_texture_formats())
+				if(!processed && ex::is_format(file_ext, ex::get_suported_texture_formats()))
 				{
-					if(processed)
-						break;
-
-					if(file_ext == ext)
+					processed = true;
+					using asset_t = gfx::texture;
+					using entry_t = asset_handle<asset_t>;
+					auto entry = entry_t{};
+					auto entry_future = am.find_asset_entry<asset_t>(relative);
+					if(entry_future.is_ready())
 					{
-						processed = true;
-						using asset_t = gfx::texture;
-						using entry_t = asset_handle<asset_t>;
-						auto entry = entry_t{};
-						auto entry_future = am.find_asset_entry<asset_t>(relative);
-						if(entry_future.is_ready())
-						{
-							entry = entry_future.get();
-						}
-						auto icon = get_preview(entry, "icon", es);
-						bool is_loading = !entry;
-						draw_entry(icon, is_loading, name, absolute_path, is_selected(entry), is_dragging,
-								   size,
-								   [&]() // on_click
-								   {
-									   es.select(entry);
-
-								   },
-								   nullptr, // on_double_click
-								   on_rename, on_delete,
-								   [&]() // on_drag
-								   {
-									   es.drag(entry, relative);
-
-								   });
+						entry = entry_future.get();
 					}
+					// Downscaled thumbnail instead of the full texture -
+					// generation and cache reads happen in the background,
+					// the type icon covers the frames in between.
+					auto& tc = core::get_subsystem<editor::thumbnail_cache>();
+					auto icon = tc.get_thumbnail(relative, absolute_path);
+					if(!icon)
+						icon = get_preview(entry, "icon", es);
+					bool is_loading = !entry;
+					draw_entry(icon, is_loading, name, absolute_path, is_selected(entry), is_dragging,
+							   size,
+							   [&]() // on_click
+							   {
+								   es.select(entry);
+
+							   },
+							   nullptr, // on_double_click
+							   on_rename, on_delete,
+							   [&]() // on_drag
+							   {
+								   es.drag(entry, relative);
+
+							   });
 				}
 
-				for(const auto& ext : ex::get_suported_mesh_formats())
+				if(!processed && ex::is_format(file_ext, ex::get_suported_mesh_formats()))
 				{
-					if(processed)
-						break;
-
-					if(file_ext == ext)
+					processed = true;
+					using asset_t = mesh;
+					using entry_t = asset_handle<asset_t>;
+					auto entry = entry_t{};
+					auto entry_future = am.find_asset_entry<asset_t>(relative);
+					if(entry_future.is_ready())
 					{
-						processed = true;
-						using asset_t = mesh;
-						using entry_t = asset_handle<asset_t>;
-						auto entry = entry_t{};
-						auto entry_future = am.find_asset_entry<asset_t>(relative);
-						if(entry_future.is_ready())
-						{
-							entry = entry_future.get();
-						}
-						auto icon = get_preview(entry, "mesh", es);
-						bool is_loading = !entry;
-						draw_entry(icon, is_loading, name, absolute_path, is_selected(entry), is_dragging,
-								   size,
-								   [&]() // on_click
-								   {
-									   es.select(entry);
-
-								   },
-								   nullptr, // on_double_click
-								   on_rename, on_delete,
-								   [&]() // on_drag
-								   {
-									   es.drag(entry, relative);
-
-								   });
+						entry = entry_future.get();
 					}
+					auto icon = get_preview(entry, "mesh", es);
+					bool is_loading = !entry;
+					draw_entry(icon, is_loading, name, absolute_path, is_selected(entry), is_dragging,
+							   size,
+							   [&]() // on_click
+							   {
+								   es.select(entry);
+
+							   },
+							   nullptr, // on_double_click
+							   on_rename, on_delete,
+							   [&]() // on_drag
+							   {
+								   es.drag(entry, relative);
+
+							   });
 				}
 
-				for(const auto& ext : ex::get_suported_sound_formats())
+				if(!processed && ex::is_format(file_ext, ex::get_suported_sound_formats()))
 				{
-					if(processed)
-						break;
-
-					if(file_ext == ext)
+					processed = true;
+					using asset_t = audio::sound;
+					using entry_t = asset_handle<asset_t>;
+					auto entry = entry_t{};
+					auto entry_future = am.find_asset_entry<asset_t>(relative);
+					if(entry_future.is_ready())
 					{
-						processed = true;
-						using asset_t = audio::sound;
-						using entry_t = asset_handle<asset_t>;
-						auto entry = entry_t{};
-						auto entry_future = am.find_asset_entry<asset_t>(relative);
-						if(entry_future.is_ready())
-						{
-							entry = entry_future.get();
-						}
-						auto icon = get_preview(entry, "sound", es);
-						bool is_loading = !entry;
-						draw_entry(icon, is_loading, name, absolute_path, is_selected(entry), is_dragging,
-								   size,
-								   [&]() // on_click
-								   {
-									   es.select(entry);
-
-								   },
-								   nullptr, // on_double_click
-								   on_rename, on_delete,
-								   [&]() // on_drag
-								   {
-									   es.drag(entry, relative);
-
-								   });
+						entry = entry_future.get();
 					}
+					auto icon = get_preview(entry, "sound", es);
+					bool is_loading = !entry;
+					draw_entry(icon, is_loading, name, absolute_path, is_selected(entry), is_dragging,
+							   size,
+							   [&]() // on_click
+							   {
+								   es.select(entry);
+
+							   },
+							   nullptr, // on_double_click
+							   on_rename, on_delete,
+							   [&]() // on_drag
+							   {
+								   es.drag(entry, relative);
+
+							   });
 				}
-				for(const auto& ext : ex::get_suported_shader_formats())
+				if(!processed && ex::is_format(file_ext, ex::get_suported_shader_formats()))
 				{
-					if(processed)
-						break;
-
-					if(file_ext == ext)
+					processed = true;
+					using asset_t = gfx::shader;
+					using entry_t = asset_handle<asset_t>;
+					auto entry = entry_t{};
+					auto entry_future = am.find_asset_entry<asset_t>(relative);
+					if(entry_future.is_ready())
 					{
-						processed = true;
-						using asset_t = gfx::shader;
-						using entry_t = asset_handle<asset_t>;
-						auto entry = entry_t{};
-						auto entry_future = am.find_asset_entry<asset_t>(relative);
-						if(entry_future.is_ready())
-						{
-							entry = entry_future.get();
-						}
-						auto icon = get_preview(entry, "shader", es);
-						bool is_loading = !entry;
-						draw_entry(icon, is_loading, name, absolute_path, is_selected(entry), is_dragging,
-								   size,
-								   [&]() // on_click
-								   {
-									   es.select(entry);
-
-								   },
-								   nullptr, // on_double_click
-								   on_rename, on_delete,
-								   [&]() // on_drag
-								   {
-									   es.drag(entry, relative);
-
-								   });
+						entry = entry_future.get();
 					}
+					auto icon = get_preview(entry, "shader", es);
+					bool is_loading = !entry;
+					draw_entry(icon, is_loading, name, absolute_path, is_selected(entry), is_dragging,
+							   size,
+							   [&]() // on_click
+							   {
+								   es.select(entry);
+
+							   },
+							   nullptr, // on_double_click
+							   on_rename, on_delete,
+							   [&]() // on_drag
+							   {
+								   es.drag(entry, relative);
+
+							   });
 				}
-				for(const auto& ext : ex::get_suported_material_formats())
+				if(!processed && ex::is_format(file_ext, ex::get_suported_material_formats()))
 				{
-					if(processed)
-						break;
-
-					if(file_ext == ext)
+					processed = true;
+					using asset_t = material;
+					using entry_t = asset_handle<asset_t>;
+					auto entry = entry_t{};
+					auto entry_future = am.find_asset_entry<asset_t>(relative);
+					if(entry_future.is_ready())
 					{
-						processed = true;
-						using asset_t = material;
-						using entry_t = asset_handle<asset_t>;
-						auto entry = entry_t{};
-						auto entry_future = am.find_asset_entry<asset_t>(relative);
-						if(entry_future.is_ready())
-						{
-							entry = entry_future.get();
-						}
-						auto icon = get_preview(entry, "material", es);
-						bool is_loading = !entry;
-						draw_entry(icon, is_loading, name, absolute_path, is_selected(entry), is_dragging,
-								   size,
-								   [&]() // on_click
-								   {
-									   es.select(entry);
-
-								   },
-								   nullptr, // on_double_click
-								   on_rename, on_delete,
-								   [&]() // on_drag
-								   {
-									   es.drag(entry, relative);
-
-								   });
+						entry = entry_future.get();
 					}
+					auto icon = get_preview(entry, "material", es);
+					bool is_loading = !entry;
+					draw_entry(icon, is_loading, name, absolute_path, is_selected(entry), is_dragging,
+							   size,
+							   [&]() // on_click
+							   {
+								   es.select(entry);
+
+							   },
+							   nullptr, // on_double_click
+							   on_rename, on_delete,
+							   [&]() // on_drag
+							   {
+								   es.drag(entry, relative);
+
+							   });
 				}
 
-				for(const auto& ext : ex::get_suported_animation_formats())
+				if(!processed && ex::is_format(file_ext, ex::get_suported_animation_formats()))
 				{
-					if(processed)
-						break;
-
-					if(file_ext == ext)
+					processed = true;
+					using asset_t = runtime::animation;
+					using entry_t = asset_handle<asset_t>;
+					auto entry = entry_t{};
+					auto entry_future = am.find_asset_entry<asset_t>(relative);
+					if(entry_future.is_ready())
 					{
-						processed = true;
-						using asset_t = runtime::animation;
-						using entry_t = asset_handle<asset_t>;
-						auto entry = entry_t{};
-						auto entry_future = am.find_asset_entry<asset_t>(relative);
-						if(entry_future.is_ready())
-						{
-							entry = entry_future.get();
-						}
-						auto icon = get_preview(entry, "animation", es);
-						bool is_loading = !entry;
-						draw_entry(icon, is_loading, name, absolute_path, is_selected(entry), is_dragging,
-								   size,
-								   [&]() // on_click
-								   {
-									   es.select(entry);
-
-								   },
-								   nullptr, // on_double_click
-								   on_rename, on_delete,
-								   [&]() // on_drag
-								   {
-									   es.drag(entry, relative);
-
-								   });
+						entry = entry_future.get();
 					}
+					auto icon = get_preview(entry, "animation", es);
+					bool is_loading = !entry;
+					draw_entry(icon, is_loading, name, absolute_path, is_selected(entry), is_dragging,
+							   size,
+							   [&]() // on_click
+							   {
+								   es.select(entry);
+
+							   },
+							   nullptr, // on_double_click
+							   on_rename, on_delete,
+							   [&]() // on_drag
+							   {
+								   es.drag(entry, relative);
+
+							   });
 				}
 
-				for(const auto& ext : ex::get_suported_prefab_formats())
+				if(!processed && ex::is_format(file_ext, ex::get_suported_prefab_formats()))
 				{
-					if(processed)
-						break;
-
-					if(file_ext == ext)
+					processed = true;
+					using asset_t = prefab;
+					using entry_t = asset_handle<asset_t>;
+					auto entry = entry_t{};
+					auto entry_future = am.find_asset_entry<asset_t>(relative);
+					if(entry_future.is_ready())
 					{
-						processed = true;
-						using asset_t = prefab;
-						using entry_t = asset_handle<asset_t>;
-						auto entry = entry_t{};
-						auto entry_future = am.find_asset_entry<asset_t>(relative);
-						if(entry_future.is_ready())
-						{
-							entry = entry_future.get();
-						}
-						auto icon = get_preview(entry, "prefab", es);
-						bool is_loading = !entry;
-						draw_entry(icon, is_loading, name, absolute_path, is_selected(entry), is_dragging,
-								   size,
-								   [&]() // on_click
-								   {
-									   es.select(entry);
-
-								   },
-								   nullptr, // on_double_click
-								   on_rename, on_delete,
-								   [&]() // on_drag
-								   {
-									   es.drag(entry, relative);
-
-								   });
+						entry = entry_future.get();
 					}
+					auto icon = get_preview(entry, "prefab", es);
+					bool is_loading = !entry;
+					draw_entry(icon, is_loading, name, absolute_path, is_selected(entry), is_dragging,
+							   size,
+							   [&]() // on_click
+							   {
+								   es.select(entry);
+
+							   },
+							   nullptr, // on_double_click
+							   on_rename, on_delete,
+							   [&]() // on_drag
+							   {
+								   es.drag(entry, relative);
+
+							   });
 				}
-				for(const auto& ext : ex::get_suported_scene_formats())
+				if(!processed && ex::is_format(file_ext, ex::get_suported_scene_formats()))
 				{
-					if(processed)
-						break;
-
-					if(file_ext == ext)
+					processed = true;
+					using asset_t = scene;
+					using entry_t = asset_handle<asset_t>;
+					auto entry = entry_t{};
+					auto entry_future = am.find_asset_entry<asset_t>(relative);
+					if(entry_future.is_ready())
 					{
-						processed = true;
-						using asset_t = scene;
-						using entry_t = asset_handle<asset_t>;
-						auto entry = entry_t{};
-						auto entry_future = am.find_asset_entry<asset_t>(relative);
-						if(entry_future.is_ready())
-						{
-							entry = entry_future.get();
-						}
-						auto icon = get_preview(entry, "scene", es);
-						bool is_loading = !entry;
-						draw_entry(icon, is_loading, name, absolute_path, is_selected(entry), is_dragging,
-								   size,
-								   [&]() // on_click
-								   {
-									   es.select(entry);
-
-								   },
-								   [&]() // on_double_click
-								   {
-									   if(!entry)
-										   return;
-
-									   entry->instantiate(scene::mode::standard);
-									   es.scene = fs::resolve_protocol(entry.id()).string();
-									   es.load_editor_camera();
-
-								   },
-								   on_rename, on_delete,
-								   [&]() // on_drag
-								   {
-									   es.drag(entry, relative);
-
-								   });
+						entry = entry_future.get();
 					}
+					auto icon = get_preview(entry, "scene", es);
+					bool is_loading = !entry;
+					draw_entry(icon, is_loading, name, absolute_path, is_selected(entry), is_dragging,
+							   size,
+							   [&]() // on_click
+							   {
+								   es.select(entry);
+
+							   },
+							   [&]() // on_double_click
+							   {
+								   if(!entry)
+									   return;
+
+								   entry->instantiate(scene::mode::standard);
+								   es.scene = fs::resolve_protocol(entry.id()).string();
+								   es.load_editor_camera();
+
+							   },
+							   on_rename, on_delete,
+							   [&]() // on_drag
+							   {
+								   es.drag(entry, relative);
+
+							   });
 				}
 			}
 		}
@@ -712,6 +683,18 @@ void project_dock::context_create_menu()
 			am.save(asset);
 		}
 
+		if(gui::MenuItem("MATERIAL INSTANCE"))
+		{
+			const auto available = get_new_file(_cache.get_path(), "New Material Instance", ".mat");
+			const auto key = fs::convert_to_protocol(available).generic_string();
+
+			auto& am = core::get_subsystem<runtime::asset_manager>();
+			auto new_mat_future =
+				am.load_asset_from_instance<material>(key, std::make_shared<material_instance>());
+			auto asset = new_mat_future.get();
+			am.save(asset);
+		}
+
 		gui::EndMenu();
 	}
 }
@@ -754,3 +737,11 @@ project_dock::project_dock(const std::string& dtitle, bool close_button, const I
 {
 	initialize(dtitle, close_button, min_size, std::bind(&project_dock::render, this, std::placeholders::_1));
 }
+
+project_dock::~project_dock()
+{
+	if(_snapshot)
+	{
+		_snapshot->save(_snapshot_file);
+	}
+}
@@ -6,6 +6,7 @@ class project_dock : public imguidock::dock
 {
 public:
 	project_dock(const std::string& dtitle, bool close_button, const ImVec2& min_size);
+	~project_dock();
 	void render(const ImVec2& area);
 
 private:
@@ -14,6 +15,10 @@ private:
     void set_cache_path(const fs::path& path);
     void import();
     fs::directory_cache _cache;
+    /// Persistent listing metadata for the open project, saved to its
+    /// settings directory so navigation stays warm across sessions.
+    std::shared_ptr<fs::directory_snapshot> _snapshot;
+    fs::path _snapshot_file;
     fs::path _cache_path_with_protocol;
     fs::path _root;
     float _scale = 0.8f;
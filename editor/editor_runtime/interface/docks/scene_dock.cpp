@@ -270,6 +270,10 @@ void draw_selected_camera(const ImVec2& size)
 		if(sel && (editor_camera != sel) && sel.has_component<camera_component>())
 		{
 			const auto selected_camera = sel.get_component<camera_component>().lock();
+			// The preview panel presents this camera's output as well, so a
+			// gated game camera keeps rendering while previewed here.
+			selected_camera->request_present();
+			selected_camera->request_refresh();
 			const auto& camera = selected_camera->get_camera();
 			auto& render_view = selected_camera->get_render_view();
 			const auto& viewport_size = camera.get_viewport_size();
@@ -523,6 +527,24 @@ void scene_dock::render(const ImVec2& area)
 	draw_selected_camera(size);
 
 	auto camera_comp = editor_camera.get_component<camera_component>().lock();
+
+	// The scene view is presenter gated: it only renders while this dock is
+	// actually visible (this callback does not run for a hidden tab) and
+	// drops to a reduced refresh rate while idle. Interaction, camera
+	// movement or a touched editor camera lift it back to full rate.
+	camera_comp->set_render_on_demand(true);
+	camera_comp->request_present();
+	{
+		auto transform_comp = editor_camera.get_component<transform_component>().lock();
+		const auto& io = gui::GetIO();
+		const bool user_active = io.MouseDown[0] || io.MouseDown[1] || io.MouseDown[2] ||
+								 io.MouseWheel != 0.0f || gui::IsAnyItemActive() || imguizmo::is_using();
+		const bool camera_changed =
+			camera_comp->is_touched() || (transform_comp && transform_comp->is_touched());
+		if(user_active || camera_changed)
+			camera_comp->request_refresh();
+	}
+
 	if(size.x > 0 && size.y > 0)
 	{
 		camera_comp->get_camera().set_viewport_pos(
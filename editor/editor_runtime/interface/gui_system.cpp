@@ -1,6 +1,8 @@
 #include "gui_system.h"
 
 #include "core/filesystem/filesystem.h"
+#include "core/filesystem/memory_mapped_file.h"
+#include "core/graphics/graphics.h"
 #include "core/graphics/index_buffer.h"
 #include "core/graphics/render_pass.h"
 #include "core/graphics/shader.h"
@@ -14,7 +16,10 @@
 #include "runtime/input/input.h"
 #include "runtime/rendering/gpu_program.h"
 #include "runtime/rendering/render_window.h"
+#include <cstring>
+#include <fstream>
 #include <unordered_map>
+#include <vector>
 
 #include "editor_core/gui/embedded/editor_default.ttf.h"
 #include "editor_core/gui/embedded/fontawesome_webfont.ttf.h"
@@ -36,9 +41,69 @@ static std::unique_ptr<gpu_program> s_program;
 static asset_handle<gfx::texture> s_font_texture;
 static std::uint32_t s_draw_calls = 0;
 
+namespace
+{
+/// Retained GPU copy of one ImGui draw list, keyed by the list pointer
+/// (stable per window per context). Geometry is only re-uploaded when the
+/// vertex or index bytes actually changed; draw commands are cheap and
+/// re-submitted every frame.
+struct draw_list_cache_entry
+{
+	std::uint64_t geometry_hash = 0;
+	std::uint32_t num_vertices = 0;
+	std::uint32_t num_indices = 0;
+	gfx::dynamic_vertex_buffer_handle vb = {gfx::invalid_handle};
+	gfx::dynamic_index_buffer_handle ib = {gfx::invalid_handle};
+	std::uint64_t last_used_frame = 0;
+};
+
+std::unordered_map<const ImDrawList*, draw_list_cache_entry> s_draw_list_cache;
+std::uint64_t s_gui_frame = 0;
+/// render_func invocations a cached list may sit unused before its
+/// buffers are released (covers closed windows and collapsed docks)
+const std::uint64_t cache_eviction_age = 600;
+
+//-----------------------------------------------------------------------------
+//  Name : hash_bytes () (Local)
+/// <summary>
+/// FNV-1a over a byte range, chained through the seed so the vertex and
+/// index streams of a draw list fold into a single geometry hash.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::uint64_t hash_bytes(const void* data, std::size_t size, std::uint64_t seed)
+{
+	const auto* bytes = static_cast<const std::uint8_t*>(data);
+	std::uint64_t hash = seed;
+	for(std::size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+void release_cache_entry(draw_list_cache_entry& entry)
+{
+	if(entry.vb.idx != gfx::invalid_handle)
+		gfx::destroy(entry.vb);
+	if(entry.ib.idx != gfx::invalid_handle)
+		gfx::destroy(entry.ib);
+	entry.vb = {gfx::invalid_handle};
+	entry.ib = {gfx::invalid_handle};
+}
+
+void clear_draw_list_cache()
+{
+	for(auto& entry : s_draw_list_cache)
+		release_cache_entry(entry.second);
+	s_draw_list_cache.clear();
+}
+}
+
 void render_func(ImDrawData* _drawData)
 {
 	s_draw_calls = 0;
+	++s_gui_frame;
 	auto prog = s_program.get();
 	if(!prog)
 		return;
@@ -46,30 +111,47 @@ void render_func(ImDrawData* _drawData)
 	// Render command lists
 	for(int32_t ii = 0, num = _drawData->CmdListsCount; ii < num; ++ii)
 	{
-		gfx::transient_vertex_buffer tvb;
-		gfx::transient_index_buffer tib;
-
 		const ImDrawList* drawList = _drawData->CmdLists[ii];
 		std::uint32_t numVertices = static_cast<std::uint32_t>(drawList->VtxBuffer.size());
 		std::uint32_t numIndices = static_cast<std::uint32_t>(drawList->IdxBuffer.size());
+		if(numVertices == 0 || numIndices == 0)
+			continue;
 
 		const auto& layout = gfx::pos_texcoord0_color0_vertex::get_layout();
 
-		if(!(gfx::get_avail_transient_vertex_buffer(numVertices, layout) == numVertices) ||
-		   !(gfx::get_avail_transient_index_buffer(numIndices) == numIndices))
+		// Retained geometry per draw list: hash the current vertex and
+		// index bytes and only upload when they differ from the cached
+		// copy, so static windows cost no per-frame translation.
+		std::uint64_t geometry_hash = 14695981039346656037ull;
+		geometry_hash = hash_bytes(drawList->VtxBuffer.begin(), numVertices * sizeof(ImDrawVert), geometry_hash);
+		geometry_hash = hash_bytes(drawList->IdxBuffer.begin(), numIndices * sizeof(ImDrawIdx), geometry_hash);
+
+		auto& entry = s_draw_list_cache[drawList];
+		if(entry.vb.idx == gfx::invalid_handle)
 		{
-			// not enough space in transient buffer just quit drawing the rest...
-			break;
+			// The resize flag lets the update below grow the buffers when
+			// a window's geometry outgrows its first allocation.
+			entry.vb = gfx::create_dynamic_vertex_buffer(numVertices, layout, BGFX_BUFFER_ALLOW_RESIZE);
+			entry.ib = gfx::create_dynamic_index_buffer(numIndices, BGFX_BUFFER_ALLOW_RESIZE);
+			entry.geometry_hash = 0;
 		}
 
-		gfx::alloc_transient_vertex_buffer(&tvb, numVertices, layout);
-		gfx::alloc_transient_index_buffer(&tib, numIndices);
-
-		ImDrawVert* verts = reinterpret_cast<ImDrawVert*>(tvb.data);
-		std::memcpy(verts, drawList->VtxBuffer.begin(), numVertices * sizeof(ImDrawVert));
-
-		ImDrawIdx* indices = reinterpret_cast<ImDrawIdx*>(tib.data);
-		std::memcpy(indices, drawList->IdxBuffer.begin(), numIndices * sizeof(ImDrawIdx));
+		if(entry.geometry_hash != geometry_hash || entry.num_vertices != numVertices ||
+		   entry.num_indices != numIndices)
+		{
+			gfx::update_dynamic_vertex_buffer(
+				entry.vb, 0,
+				gfx::copy(drawList->VtxBuffer.begin(),
+						  numVertices * static_cast<std::uint32_t>(sizeof(ImDrawVert))));
+			gfx::update_dynamic_index_buffer(
+				entry.ib, 0,
+				gfx::copy(drawList->IdxBuffer.begin(),
+						  numIndices * static_cast<std::uint32_t>(sizeof(ImDrawIdx))));
+			entry.geometry_hash = geometry_hash;
+			entry.num_vertices = numVertices;
+			entry.num_indices = numIndices;
+		}
+		entry.last_used_frame = s_gui_frame;
 
 		std::uint64_t state =
 			0 | BGFX_STATE_RGB_WRITE | BGFX_STATE_ALPHA_WRITE | BGFX_STATE_MSAA |
@@ -101,8 +183,8 @@ void render_func(ImDrawData* _drawData)
 
 				gfx::set_scissor(x, y, width, height);
 				gfx::set_state(state);
-				gfx::set_vertex_buffer(0, &tvb, 0, numVertices);
-				gfx::set_index_buffer(&tib, offset, cmd->ElemCount);
+				gfx::set_vertex_buffer(0, entry.vb, 0, numVertices);
+				gfx::set_index_buffer(entry.ib, offset, cmd->ElemCount);
 				gfx::submit(gfx::render_pass::get_pass(), prog->native_handle());
 				s_draw_calls++;
 			}
@@ -110,6 +192,21 @@ void render_func(ImDrawData* _drawData)
 			offset += cmd->ElemCount;
 		}
 	}
+
+	// Drop the retained buffers of draw lists that have not been seen for a
+	// while (closed windows, collapsed docks, destroyed contexts).
+	for(auto it = s_draw_list_cache.begin(); it != s_draw_list_cache.end();)
+	{
+		if(it->second.last_used_frame + cache_eviction_age < s_gui_frame)
+		{
+			release_cache_entry(it->second);
+			it = s_draw_list_cache.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
 	prog->end();
 }
 
@@ -198,6 +295,213 @@ void imgui_frame_begin()
 	gui::CleanupTextures();
 }
 
+namespace
+{
+/// Prebaked font atlas cache: the alpha8 atlas pixels plus every font's
+/// glyph table, keyed by a hash of the font data, sizes and glyph ranges.
+/// Warm starts map the file and skip the stb_truetype bake entirely; any
+/// change to the font setup changes the key and triggers a clean rebake.
+const std::uint32_t font_cache_magic = 0x45474641;
+const std::uint32_t font_cache_version = 1;
+
+struct font_cache_header
+{
+	std::uint32_t magic = 0;
+	std::uint32_t version = 0;
+	std::uint64_t key = 0;
+	std::int32_t tex_width = 0;
+	std::int32_t tex_height = 0;
+	float uv_white_x = 0.0f;
+	float uv_white_y = 0.0f;
+	std::uint32_t font_count = 0;
+};
+
+struct font_cache_font
+{
+	float font_size = 0.0f;
+	float ascent = 0.0f;
+	float descent = 0.0f;
+	std::uint32_t fallback_char = 0;
+	float display_offset_x = 0.0f;
+	float display_offset_y = 0.0f;
+	std::uint32_t glyph_count = 0;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : compute_font_atlas_key () (Local)
+/// <summary>
+/// Hash of everything that shapes the baked atlas: the raw font bytes,
+/// pixel sizes, merge flags and requested glyph ranges of every added
+/// font config.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::uint64_t compute_font_atlas_key(ImFontAtlas* atlas)
+{
+	std::uint64_t key = 14695981039346656037ull;
+	key = hash_bytes(&font_cache_version, sizeof(font_cache_version), key);
+	for(int i = 0; i < atlas->ConfigData.Size; ++i)
+	{
+		const ImFontConfig& cfg = atlas->ConfigData[i];
+		if(cfg.FontData != nullptr && cfg.FontDataSize > 0)
+			key = hash_bytes(cfg.FontData, static_cast<std::size_t>(cfg.FontDataSize), key);
+		key = hash_bytes(&cfg.SizePixels, sizeof(cfg.SizePixels), key);
+		key = hash_bytes(&cfg.MergeMode, sizeof(cfg.MergeMode), key);
+		key = hash_bytes(&cfg.PixelSnapH, sizeof(cfg.PixelSnapH), key);
+		if(cfg.GlyphRanges != nullptr)
+		{
+			for(const ImWchar* range = cfg.GlyphRanges; range[0] != 0 && range[1] != 0; range += 2)
+				key = hash_bytes(range, 2 * sizeof(ImWchar), key);
+		}
+	}
+	return key;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : try_load_font_atlas_cache () (Local)
+/// <summary>
+/// Restores the atlas pixels and per-font glyph tables from a mapped
+/// cache file. The whole blob is validated before the atlas is touched;
+/// the fonts must already have been added (they carry the configs). On
+/// success the later GetTexData call converts the restored pixels
+/// instead of baking.
+/// </summary>
+//-----------------------------------------------------------------------------
+bool try_load_font_atlas_cache(ImFontAtlas* atlas, const fs::path& file, std::uint64_t key)
+{
+	fs::memory_mapped_file mapped;
+	if(!mapped.open(file))
+		return false;
+
+	const std::uint8_t* cursor = mapped.data();
+	std::uint64_t remaining = mapped.size();
+	auto read = [&cursor, &remaining](void* dst, std::uint64_t size) {
+		if(size > remaining)
+			return false;
+		std::memcpy(dst, cursor, static_cast<std::size_t>(size));
+		cursor += size;
+		remaining -= size;
+		return true;
+	};
+
+	font_cache_header header;
+	if(!read(&header, sizeof(header)) || header.magic != font_cache_magic ||
+	   header.version != font_cache_version || header.key != key ||
+	   header.font_count != static_cast<std::uint32_t>(atlas->Fonts.Size) || header.tex_width <= 0 ||
+	   header.tex_height <= 0)
+		return false;
+
+	const std::uint64_t pixel_count =
+		std::uint64_t(header.tex_width) * std::uint64_t(header.tex_height);
+	if(pixel_count > remaining)
+		return false;
+	const std::uint8_t* pixels = cursor;
+	cursor += pixel_count;
+	remaining -= pixel_count;
+
+	struct pending_font
+	{
+		font_cache_font info;
+		const std::uint8_t* glyphs = nullptr;
+	};
+	std::vector<pending_font> fonts(header.font_count);
+	for(auto& pending : fonts)
+	{
+		if(!read(&pending.info, sizeof(pending.info)) || pending.info.glyph_count == 0)
+			return false;
+		const std::uint64_t glyph_bytes =
+			std::uint64_t(pending.info.glyph_count) * sizeof(ImFontGlyph);
+		if(glyph_bytes > remaining)
+			return false;
+		pending.glyphs = cursor;
+		cursor += glyph_bytes;
+		remaining -= glyph_bytes;
+	}
+
+	atlas->TexWidth = header.tex_width;
+	atlas->TexHeight = header.tex_height;
+	atlas->TexUvWhitePixel = ImVec2(header.uv_white_x, header.uv_white_y);
+	atlas->TexPixelsAlpha8 =
+		static_cast<unsigned char*>(ImGui::MemAlloc(static_cast<std::size_t>(pixel_count)));
+	std::memcpy(atlas->TexPixelsAlpha8, pixels, static_cast<std::size_t>(pixel_count));
+
+	for(std::uint32_t i = 0; i < header.font_count; ++i)
+	{
+		const auto& pending = fonts[i];
+		ImFont* font = atlas->Fonts[static_cast<int>(i)];
+		font->FontSize = pending.info.font_size;
+		font->Ascent = pending.info.ascent;
+		font->Descent = pending.info.descent;
+		font->FallbackChar = static_cast<ImWchar>(pending.info.fallback_char);
+		font->DisplayOffset = ImVec2(pending.info.display_offset_x, pending.info.display_offset_y);
+		font->Glyphs.resize(static_cast<int>(pending.info.glyph_count));
+		std::memcpy(font->Glyphs.Data, pending.glyphs,
+					static_cast<std::size_t>(pending.info.glyph_count) * sizeof(ImFontGlyph));
+		font->BuildLookupTable();
+	}
+
+	// The builder normally wires each font to its config; restored fonts
+	// need the same linkage for the debug name and clear paths.
+	for(int i = 0; i < atlas->ConfigData.Size; ++i)
+	{
+		ImFontConfig& cfg = atlas->ConfigData[i];
+		if(cfg.DstFont == nullptr)
+			continue;
+		if(cfg.DstFont->ConfigData == nullptr)
+			cfg.DstFont->ConfigData = &cfg;
+		++cfg.DstFont->ConfigDataCount;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : save_font_atlas_cache () (Local)
+/// <summary>
+/// Writes the freshly baked atlas out so the next start skips the bake.
+/// Best effort; a failed write simply means a cold bake again next run.
+/// </summary>
+//-----------------------------------------------------------------------------
+void save_font_atlas_cache(ImFontAtlas* atlas, const fs::path& file, std::uint64_t key)
+{
+	if(atlas->TexPixelsAlpha8 == nullptr)
+		return;
+
+	std::ofstream output(file.string(), std::ios::binary | std::ios::trunc);
+	if(!output.is_open())
+		return;
+
+	font_cache_header header;
+	header.magic = font_cache_magic;
+	header.version = font_cache_version;
+	header.key = key;
+	header.tex_width = atlas->TexWidth;
+	header.tex_height = atlas->TexHeight;
+	header.uv_white_x = atlas->TexUvWhitePixel.x;
+	header.uv_white_y = atlas->TexUvWhitePixel.y;
+	header.font_count = static_cast<std::uint32_t>(atlas->Fonts.Size);
+	output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	output.write(reinterpret_cast<const char*>(atlas->TexPixelsAlpha8),
+				 std::streamsize(atlas->TexWidth) * std::streamsize(atlas->TexHeight));
+
+	for(int i = 0; i < atlas->Fonts.Size; ++i)
+	{
+		const ImFont* font = atlas->Fonts[i];
+		font_cache_font info;
+		info.font_size = font->FontSize;
+		info.ascent = font->Ascent;
+		info.descent = font->Descent;
+		info.fallback_char = font->FallbackChar;
+		info.display_offset_x = font->DisplayOffset.x;
+		info.display_offset_y = font->DisplayOffset.y;
+		info.glyph_count = static_cast<std::uint32_t>(font->Glyphs.Size);
+		output.write(reinterpret_cast<const char*>(&info), sizeof(info));
+		output.write(reinterpret_cast<const char*>(font->Glyphs.Data),
+					 std::streamsize(font->Glyphs.Size) *
+						 std::streamsize(sizeof(ImFontGlyph)));
+	}
+}
+}
+
 void set_initial_context(ImGuiContext* context)
 {
 	s_initial_context = context;
@@ -349,6 +653,23 @@ void imgui_init()
 				 io.Fonts->AddFontFromMemoryTTF((void*)fontawesome_webfont_ttf,
 												sizeof(fontawesome_webfont_ttf), 50, &config, icons_ranges));
 
+	// Warm starts restore the prebaked atlas and glyph tables from the
+	// cache instead of baking through stb_truetype; a cold start bakes
+	// once and prebakes the cache for the next run.
+	const auto atlas_key = compute_font_atlas_key(io.Fonts);
+	fs::error_code err;
+	const auto cache_dir = fs::resolve_protocol("editor:/cache");
+	fs::create_directory(cache_dir, err);
+	const auto cache_file = cache_dir / "font_atlas.cache";
+	if(!try_load_font_atlas_cache(io.Fonts, cache_file, atlas_key))
+	{
+		std::uint8_t* baked = nullptr;
+		int baked_width = 0;
+		int baked_height = 0;
+		io.Fonts->GetTexDataAsAlpha8(&baked, &baked_width, &baked_height);
+		save_font_atlas_cache(io.Fonts, cache_file, atlas_key);
+	}
+
 	io.Fonts->GetTexDataAsRGBA32(&data, &width, &height);
 
 	s_font_texture = std::make_shared<gfx::texture>(
@@ -362,6 +683,7 @@ void imgui_init()
 
 void imgui_dispose()
 {
+	clear_draw_list_cache();
 	gui::CleanupTextures();
 	restore_initial_context();
 	s_program.reset();
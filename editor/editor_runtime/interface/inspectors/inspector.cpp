@@ -82,7 +82,8 @@ property_layout::property_layout(const std::string& name, const std::string& too
 	gui::AlignTextToFramePadding();
 	gui::TextUnformatted(name.c_str());
 
-	Tooltip(tooltip);
+	if(!tooltip.empty())
+		Tooltip(tooltip);
 
 	gui::NextColumn();
 
@@ -1,5 +1,35 @@
 #include "inspector_entity.h"
 #include "inspectors.h"
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+//-----------------------------------------------------------------------------
+//  Name : get_pretty_name () (Local)
+/// <summary>
+/// Display name of a reflected type, preferring its "pretty_name" metadata.
+/// Resolved through rttr once per type and cached; the component headers
+/// and the add-component menu re-read these names every frame.
+/// </summary>
+//-----------------------------------------------------------------------------
+const std::string& get_pretty_name(const rttr::type& type)
+{
+	static std::unordered_map<rttr::type, std::string> names;
+	const auto it = names.find(type);
+	if(it != names.end())
+		return it->second;
+
+	std::string name = type.get_name().data();
+	auto meta_id = type.get_metadata("pretty_name");
+	if(meta_id)
+	{
+		name = meta_id.to_string();
+	}
+
+	return names.emplace(type, std::move(name)).first->second;
+}
+}
 
 bool inspector_entity::inspect(rttr::variant& var, bool read_only, const meta_getter& get_metadata)
 {
@@ -27,12 +57,7 @@ bool inspector_entity::inspect(rttr::variant& var, bool read_only, const meta_ge
 		auto component = component_ptr.lock().get();
 		auto component_type = rttr::type::get(*component);
 
-		std::string name = component_type.get_name().data();
-		auto meta_id = component_type.get_metadata("pretty_name");
-		if(meta_id)
-		{
-			name = meta_id.to_string();
-		}
+		const std::string& name = get_pretty_name(component_type);
 		gui::PushID(component);
 		gui::SetNextTreeNodeOpen(true, ImGuiCond_FirstUseEver);
 		if(gui::CollapsingHeader(name.c_str(), &opened))
@@ -75,12 +100,7 @@ bool inspector_entity::inspect(rttr::variant& var, bool read_only, const meta_ge
 			auto cstructor = component_type.get_constructor();
 			if(cstructor)
 			{
-				std::string name = component_type.get_name().data();
-				auto meta_id = component_type.get_metadata("pretty_name");
-				if(meta_id)
-				{
-					name = meta_id.to_string();
-				}
+				const std::string& name = get_pretty_name(component_type);
 				if(!filter.PassFilter(name.c_str()))
 					continue;
 
@@ -1,4 +1,5 @@
 #include "inspectors.h"
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -27,7 +28,90 @@ struct inspector_registry
 std::shared_ptr<inspector> get_inspector(rttr::type type)
 {
 	static inspector_registry registry;
-	return registry.type_map[type];
+	const auto it = registry.type_map.find(type);
+	if(it == registry.type_map.end())
+		return nullptr;
+	return it->second;
+}
+
+namespace
+{
+/// Value-independent data for one reflected property: flags, display
+/// strings and metadata are resolved once per type instead of every
+/// inspected frame. Only the current value is read per frame.
+struct property_entry
+{
+	property_entry(const rttr::property& p)
+		: prop(p)
+	{
+		pretty_name = prop.get_name().to_string();
+		auto meta_pretty_name = prop.get_metadata("pretty_name");
+		if(meta_pretty_name)
+			pretty_name = meta_pretty_name.get_value<std::string>();
+
+		auto meta_tooltip = prop.get_metadata("tooltip");
+		if(meta_tooltip)
+			tooltip = meta_tooltip.to_string();
+
+		is_readonly = prop.is_readonly();
+		is_enum = prop.is_enumeration();
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_metadata ()
+	/// <summary>
+	/// Metadata lookup with memoization. Leaf inspectors query string keyed
+	/// UI hints ("min", "max", "format", ...) every frame; each key is
+	/// resolved through rttr once and answered from the cache afterwards.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	rttr::variant get_metadata(const rttr::variant& name) const
+	{
+		if(!name.can_convert<std::string>())
+			return prop.get_metadata(name);
+
+		const std::string key = name.to_string();
+		const auto it = metadata.find(key);
+		if(it != metadata.end())
+			return it->second;
+
+		auto resolved = prop.get_metadata(name);
+		metadata.emplace(key, resolved);
+		return resolved;
+	}
+
+	rttr::property prop;
+	std::string pretty_name;
+	std::string tooltip;
+	bool is_readonly = false;
+	bool is_enum = false;
+	/// resolved metadata by string key; filled lazily
+	mutable std::unordered_map<std::string, rttr::variant> metadata;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : get_type_layout () (Local)
+/// <summary>
+/// Returns the cached inspector layout for a reflected type, building it on
+/// first request. Entries stay valid for the application lifetime, so the
+/// per frame property walk is a plain vector sweep.
+/// </summary>
+//-----------------------------------------------------------------------------
+const std::vector<property_entry>& get_type_layout(rttr::type type)
+{
+	static std::unordered_map<rttr::type, std::vector<property_entry>> layouts;
+	const auto it = layouts.find(type);
+	if(it != layouts.end())
+		return it->second;
+
+	std::vector<property_entry> layout;
+	auto properties = type.get_properties();
+	layout.reserve(properties.size());
+	for(auto& prop : properties)
+		layout.emplace_back(prop);
+
+	return layouts.emplace(type, std::move(layout)).first->second;
+}
 }
 
 bool inspect_var(rttr::variant& var, bool skip_custom, bool read_only,
@@ -35,7 +119,7 @@ bool inspect_var(rttr::variant& var, bool skip_custom, bool read_only,
 {
 	rttr::instance object = var;
 	auto type = object.get_derived_type();
-	auto properties = type.get_properties();
+	const auto& layout_entries = get_type_layout(type);
 
 	bool changed = false;
 
@@ -44,7 +128,7 @@ bool inspect_var(rttr::variant& var, bool skip_custom, bool read_only,
 	{
 		changed |= inspector->inspect(var, read_only, get_metadata);
 	}
-	else if(properties.empty())
+	else if(layout_entries.empty())
 	{
 		if(type.is_enumeration())
 		{
@@ -54,18 +138,19 @@ bool inspect_var(rttr::variant& var, bool skip_custom, bool read_only,
 	}
 	else
 	{
-		for(auto& prop : properties)
+		for(const auto& entry : layout_entries)
 		{
+			const auto& prop = entry.prop;
 			bool prop_changed = false;
 			auto prop_var = prop.get_value(object);
-			bool is_readonly = prop.is_readonly();
+			bool is_readonly = entry.is_readonly;
 			bool is_array = prop_var.is_sequential_container();
 			bool is_associative_container = prop_var.is_associative_container();
-			bool is_enum = prop.is_enumeration();
+			bool is_enum = entry.is_enum;
 			rttr::instance prop_object = prop_var;
 			bool has_inspector = !!get_inspector(prop_object.get_derived_type());
 			bool details = !has_inspector && !is_enum;
-			property_layout layout(prop);
+			property_layout layout(entry.pretty_name, entry.tooltip);
 			bool open = true;
 			if(details)
 			{
@@ -75,8 +160,8 @@ bool inspect_var(rttr::variant& var, bool skip_custom, bool read_only,
 
 			if(open)
 			{
-				auto get_meta = [&prop](const rttr::variant& name) -> rttr::variant {
-					return prop.get_metadata(name);
+				auto get_meta = [&entry](const rttr::variant& name) -> rttr::variant {
+					return entry.get_metadata(name);
 				};
 				if(is_array)
 				{
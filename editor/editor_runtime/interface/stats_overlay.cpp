@@ -0,0 +1,108 @@
+#include "stats_overlay.h"
+#include "../assets/asset_compiler.h"
+#include "core/graphics/graphics.h"
+#include "core/graphics/render_pass.h"
+#include "core/profiler/profiler.h"
+#include "core/system/subsystem.h"
+#include "core/tasks/task_system.h"
+#include "editor_core/gui/stats_overlay.h"
+#include "runtime/assets/impl/load_queue.h"
+#include "runtime/assets/impl/upload_queue.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace editor
+{
+void draw_stats_overlay(std::chrono::duration<float> dt)
+{
+	gui::stats_snapshot snapshot;
+	snapshot.frame_time_ms = dt.count() * 1000.0f;
+
+	const auto* stats = gfx::get_stats();
+	if(stats != nullptr)
+	{
+		snapshot.draw_calls = stats->numDraw;
+		snapshot.triangles = stats->numPrims[0];
+	}
+
+	const auto& samples = core::profiler::get_instance().get_last_frame_samples();
+	snapshot.cpu_samples.reserve(samples.size());
+	for(const auto& sample : samples)
+	{
+		gui::stats_snapshot::profiler_line line;
+		line.name = sample.name;
+		line.depth = sample.depth;
+		line.thread_index = sample.thread_index;
+		line.call_count = sample.call_count;
+		line.total_ms = sample.total_ms;
+		snapshot.cpu_samples.push_back(std::move(line));
+	}
+
+	const auto gpu_timings = gfx::render_pass::get_gpu_timings();
+	snapshot.gpu_passes.reserve(gpu_timings.size());
+	for(const auto& timing : gpu_timings)
+	{
+		gui::stats_snapshot::gpu_pass_line pass;
+		pass.name = timing.first;
+		pass.gpu_time_ms = timing.second.gpu_time_ms;
+		pass.cpu_time_ms = timing.second.cpu_time_ms;
+		pass.pass_count = timing.second.pass_count;
+		snapshot.gpu_passes.push_back(std::move(pass));
+	}
+	std::sort(std::begin(snapshot.gpu_passes), std::end(snapshot.gpu_passes),
+			  [](const auto& lhs, const auto& rhs) { return lhs.gpu_time_ms > rhs.gpu_time_ms; });
+
+	auto& ts = core::get_subsystem<core::task_system>();
+	const auto info = ts.get_info();
+
+	// Utilization needs a delta - keep last frame's busy times and compare
+	// against wall time elapsed since then.
+	using clock_t = std::chrono::steady_clock;
+	static std::vector<clock_t::duration> previous_busy;
+	static clock_t::time_point previous_time = clock_t::now();
+
+	const auto now = clock_t::now();
+	const auto wall = std::chrono::duration<double>(now - previous_time).count();
+	previous_time = now;
+	previous_busy.resize(info.queue_infos.size(), clock_t::duration(0));
+
+	snapshot.task_queues.reserve(info.queue_infos.size());
+	for(std::size_t i = 0; i < info.queue_infos.size(); ++i)
+	{
+		const auto& queue = info.queue_infos[i];
+		gui::stats_snapshot::task_queue_line line;
+		line.pending = queue.pending_tasks;
+		if(wall > 0.0)
+		{
+			const auto busy = std::chrono::duration<double>(queue.busy_time - previous_busy[i]).count();
+			line.utilization = std::min(std::max(busy / wall, 0.0), 1.0);
+		}
+		previous_busy[i] = queue.busy_time;
+		snapshot.task_queues.push_back(line);
+	}
+
+	if(core::has_subsystems<runtime::load_queue>())
+	{
+		snapshot.asset_loads_in_flight = core::get_subsystem<runtime::load_queue>().get_pending_count();
+	}
+
+	if(core::has_subsystems<runtime::upload_queue>())
+	{
+		snapshot.asset_uploads_pending = core::get_subsystem<runtime::upload_queue>().get_pending_count();
+	}
+
+	const auto imports = project_compiler::get_active_imports();
+	snapshot.imports.reserve(imports.size());
+	for(const auto& entry : imports)
+	{
+		gui::stats_snapshot::import_line line;
+		line.name = entry.name;
+		line.stage = entry.stage;
+		line.progress = entry.progress;
+		snapshot.imports.push_back(std::move(line));
+	}
+
+	gui::draw_stats_overlay(snapshot);
+}
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <chrono>
+
+namespace editor
+{
+//-----------------------------------------------------------------------------
+//  Name : draw_stats_overlay ()
+/// <summary>
+/// Gathers one frame's worth of statistics - cpu profiler samples, bgfx
+/// draw counts, resolved gpu pass timings, task system utilization and
+/// pending asset IO - and draws them via the gui overlay.
+/// </summary>
+//-----------------------------------------------------------------------------
+void draw_stats_overlay(std::chrono::duration<float> dt);
+}
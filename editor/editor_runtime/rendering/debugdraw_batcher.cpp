@@ -0,0 +1,147 @@
+#include "debugdraw_batcher.h"
+#include "core/graphics/debugdraw.h"
+
+#include <algorithm>
+
+namespace editor
+{
+namespace
+{
+//-----------------------------------------------------------------------------
+//  Name : basis_for_normal () (Local)
+/// <summary>
+/// Two unit vectors spanning the plane perpendicular to the normal.
+/// </summary>
+//-----------------------------------------------------------------------------
+void basis_for_normal(const math::vec3& normal, math::vec3& tangent, math::vec3& bitangent)
+{
+	const auto reference =
+		math::abs(normal.y) < 0.99f ? math::vec3{0.0f, 1.0f, 0.0f} : math::vec3{1.0f, 0.0f, 0.0f};
+	tangent = math::normalize(math::cross(reference, normal));
+	bitangent = math::cross(normal, tangent);
+}
+}
+
+void debugdraw_batcher::add_line(const math::vec3& from, const math::vec3& to, std::uint32_t abgr)
+{
+	_lines.push_back({from, to, abgr});
+}
+
+void debugdraw_batcher::add_aabb(const math::bbox& bounds, const math::transform& world, std::uint32_t abgr)
+{
+	const auto& mn = bounds.min;
+	const auto& mx = bounds.max;
+	math::vec3 corners[8] = {
+		{mn.x, mn.y, mn.z}, {mx.x, mn.y, mn.z}, {mx.x, mx.y, mn.z}, {mn.x, mx.y, mn.z},
+		{mn.x, mn.y, mx.z}, {mx.x, mn.y, mx.z}, {mx.x, mx.y, mx.z}, {mn.x, mx.y, mx.z},
+	};
+	world.transform_coord_array(corners, corners, 8);
+
+	static const std::uint32_t edges[12][2] = {
+		{0, 1}, {1, 2}, {2, 3}, {3, 0}, // near face
+		{4, 5}, {5, 6}, {6, 7}, {7, 4}, // far face
+		{0, 4}, {1, 5}, {2, 6}, {3, 7}, // connecting edges
+	};
+	for(const auto& edge : edges)
+	{
+		add_line(corners[edge[0]], corners[edge[1]], abgr);
+	}
+}
+
+void debugdraw_batcher::add_circle(const math::vec3& center, const math::vec3& normal, float radius,
+								   std::uint32_t abgr, std::uint32_t segments)
+{
+	math::vec3 tangent;
+	math::vec3 bitangent;
+	basis_for_normal(normal, tangent, bitangent);
+
+	const float step = math::two_pi<float>() / float(segments);
+	auto point_at = [&](std::uint32_t i) {
+		const float angle = step * float(i);
+		return center + (tangent * math::cos(angle) + bitangent * math::sin(angle)) * radius;
+	};
+
+	auto previous = point_at(0);
+	for(std::uint32_t i = 1; i <= segments; ++i)
+	{
+		const auto current = point_at(i);
+		add_line(previous, current, abgr);
+		previous = current;
+	}
+}
+
+void debugdraw_batcher::add_cone(const math::vec3& apex, const math::vec3& base_center, float radius,
+								 std::uint32_t abgr, std::uint32_t segments)
+{
+	const auto normal = math::normalize(apex - base_center);
+	add_circle(base_center, normal, radius, abgr, segments);
+
+	math::vec3 tangent;
+	math::vec3 bitangent;
+	basis_for_normal(normal, tangent, bitangent);
+
+	const std::uint32_t spokes = 8;
+	const float step = math::two_pi<float>() / float(spokes);
+	for(std::uint32_t i = 0; i < spokes; ++i)
+	{
+		const float angle = step * float(i);
+		const auto rim =
+			base_center + (tangent * math::cos(angle) + bitangent * math::sin(angle)) * radius;
+		add_line(apex, rim, abgr);
+	}
+}
+
+void debugdraw_batcher::add_cylinder(const math::vec3& from, const math::vec3& to, float radius,
+									 std::uint32_t abgr, std::uint32_t segments)
+{
+	const auto normal = math::normalize(to - from);
+	add_circle(from, normal, radius, abgr, segments);
+	add_circle(to, normal, radius, abgr, segments);
+
+	math::vec3 tangent;
+	math::vec3 bitangent;
+	basis_for_normal(normal, tangent, bitangent);
+
+	const std::uint32_t spokes = 4;
+	const float step = math::two_pi<float>() / float(spokes);
+	for(std::uint32_t i = 0; i < spokes; ++i)
+	{
+		const float angle = step * float(i);
+		const auto offset = (tangent * math::cos(angle) + bitangent * math::sin(angle)) * radius;
+		add_line(from + offset, to + offset, abgr);
+	}
+}
+
+void debugdraw_batcher::flush()
+{
+	if(_lines.empty())
+	{
+		return;
+	}
+
+	// group segments by color so the replay below is one state change per
+	// run instead of one per shape
+	std::sort(std::begin(_lines), std::end(_lines),
+			  [](const line& a, const line& b) { return a.abgr < b.abgr; });
+
+	ddPush();
+	ddSetTransform(nullptr);
+	ddSetWireframe(true);
+
+	std::uint32_t current_color = _lines.front().abgr + 1;
+	for(const auto& l : _lines)
+	{
+		if(l.abgr != current_color)
+		{
+			current_color = l.abgr;
+			ddSetColor(current_color);
+		}
+		ddMoveTo(&l.from);
+		ddLineTo(&l.to);
+	}
+
+	ddPop();
+
+	_lines.clear();
+}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "core/math/math_includes.h"
+#include <cstdint>
+#include <vector>
+
+namespace editor
+{
+//-----------------------------------------------------------------------------
+//  Name : debugdraw_batcher (Class)
+/// <summary>
+/// Accumulates wireframe debug shapes as colored line segments with their
+/// transforms resolved on the CPU, then emits the whole frame's worth in
+/// one push/pop with a single state change per color run. Issuing shapes
+/// individually forces the underlying debug draw to flush per shape, which
+/// floods submission once more than a handful of entities are outlined.
+/// </summary>
+//-----------------------------------------------------------------------------
+class debugdraw_batcher
+{
+public:
+	//-----------------------------------------------------------------------------
+	//  Name : add_line ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void add_line(const math::vec3& from, const math::vec3& to, std::uint32_t abgr);
+
+	//-----------------------------------------------------------------------------
+	//  Name : add_aabb ()
+	/// <summary>
+	/// The twelve edges of a local-space box, transformed into world space
+	/// here rather than through a per-shape transform on the draw side.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void add_aabb(const math::bbox& bounds, const math::transform& world, std::uint32_t abgr);
+
+	//-----------------------------------------------------------------------------
+	//  Name : add_circle ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void add_circle(const math::vec3& center, const math::vec3& normal, float radius, std::uint32_t abgr,
+					std::uint32_t segments = 36);
+
+	//-----------------------------------------------------------------------------
+	//  Name : add_cone ()
+	/// <summary>
+	/// Base circle around base_center plus spokes up to the apex.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void add_cone(const math::vec3& apex, const math::vec3& base_center, float radius, std::uint32_t abgr,
+				  std::uint32_t segments = 24);
+
+	//-----------------------------------------------------------------------------
+	//  Name : add_cylinder ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void add_cylinder(const math::vec3& from, const math::vec3& to, float radius, std::uint32_t abgr,
+					  std::uint32_t segments = 12);
+
+	//-----------------------------------------------------------------------------
+	//  Name : flush ()
+	/// <summary>
+	/// Sorts the accumulated segments by color and replays them inside one
+	/// push/pop - one ddSetColor per color run, identity transform, no
+	/// other state traffic. Clears the batch; capacity is kept so the
+	/// next frame does not reallocate.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void flush();
+
+private:
+	struct line
+	{
+		math::vec3 from;
+		math::vec3 to;
+		std::uint32_t abgr = 0;
+	};
+
+	/// this frame's segments, world space
+	std::vector<line> _lines;
+};
+}
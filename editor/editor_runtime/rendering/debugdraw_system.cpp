@@ -110,29 +110,19 @@ void debugdraw_system::frame_render(std::chrono::duration<float>)
 		auto& selected_camera = selected_camera_comp_ptr->get_camera();
 		const auto view_proj = selected_camera.get_view_projection();
 		const auto bounds = selected_camera.get_local_bounding_box();
-		ddPush();
-		ddSetColor(0xffffffff);
-		ddSetWireframe(true);
 		if(selected_camera.get_projection_mode() == projection_mode::perspective)
 		{
+			ddPush();
+			ddSetColor(0xffffffff);
+			ddSetWireframe(true);
 			ddSetTransform(nullptr);
 			ddDrawFrustum(&view_proj);
+			ddPop();
 		}
 		else
 		{
-			Aabb aabb;
-			aabb.m_min[0] = bounds.min.x;
-			aabb.m_min[1] = bounds.min.y;
-			aabb.m_min[2] = bounds.min.z;
-			aabb.m_max[0] = bounds.max.x;
-			aabb.m_max[1] = bounds.max.y;
-			aabb.m_max[2] = bounds.max.z;
-			ddSetTransform(&world_transform);
-			ddDraw(aabb);
-			ddSetTransform(nullptr);
+			_batcher.add_aabb(bounds, world_transform, 0xffffffff);
 		}
-
-		ddPop();
 	}
 
 	if(selected_entity.has_component<light_component>())
@@ -147,55 +137,35 @@ void debugdraw_system::frame_render(std::chrono::duration<float>)
 				auto tan_angle = math::tan(math::radians(light.spot_data.get_outer_angle() * 0.5f));
 				// oposite = tan * adjacent
 				auto oposite = tan_angle * adjacent;
-				ddPush();
-				ddSetColor(0xff00ff00);
-				ddSetWireframe(true);
-				ddSetLod(3);
 				math::vec3 from = transform_comp_ptr->get_position();
 				math::vec3 to = from + transform_comp_ptr->get_z_axis() * adjacent;
-				ddDrawCone(&to, &from, oposite);
-				ddPop();
+				_batcher.add_cone(from, to, oposite, 0xff00ff00);
 			}
 			{
 				auto tan_angle = math::tan(math::radians(light.spot_data.get_inner_angle() * 0.5f));
 				// oposite = tan * adjacent
 				auto oposite = tan_angle * adjacent;
-				ddPush();
-				ddSetColor(0xff00ffff);
-				ddSetWireframe(true);
-				ddSetLod(3);
 				math::vec3 from = transform_comp_ptr->get_position();
 				math::vec3 to = from + transform_comp_ptr->get_z_axis() * adjacent;
-				ddDrawCone(&to, &from, oposite);
-				ddPop();
+				_batcher.add_cone(from, to, oposite, 0xff00ffff);
 			}
 		}
 		else if(light.type == light_type::point)
 		{
 			auto radius = light.point_data.range;
-			ddPush();
-			ddSetColor(0xff00ff00);
-			ddSetWireframe(true);
 			math::vec3 center = transform_comp_ptr->get_position();
-			ddDrawCircle(Axis::X, center.x, center.y, center.z, radius);
-			ddDrawCircle(Axis::Y, center.x, center.y, center.z, radius);
-			ddDrawCircle(Axis::Z, center.x, center.y, center.z, radius);
-			ddPop();
+			_batcher.add_circle(center, {1.0f, 0.0f, 0.0f}, radius, 0xff00ff00);
+			_batcher.add_circle(center, {0.0f, 1.0f, 0.0f}, radius, 0xff00ff00);
+			_batcher.add_circle(center, {0.0f, 0.0f, 1.0f}, radius, 0xff00ff00);
 		}
 		else if(light.type == light_type::directional)
 		{
-			ddPush();
-			ddSetLod(255);
-			ddSetColor(0xff00ff00);
-			ddSetWireframe(true);
 			math::vec3 from1 = transform_comp_ptr->get_position();
 			math::vec3 to1 = from1 + transform_comp_ptr->get_z_axis() * 2.0f;
-			ddDrawCylinder(&from1, &to1, 0.1f);
+			_batcher.add_cylinder(from1, to1, 0.1f, 0xff00ff00);
 			math::vec3 from2 = to1;
 			math::vec3 to2 = from2 + transform_comp_ptr->get_z_axis() * 1.5f;
-			;
-			ddDrawCone(&from2, &to2, 0.5f);
-			ddPop();
+			_batcher.add_cone(to2, from2, 0.5f, 0xff00ff00);
 		}
 	}
 
@@ -206,32 +176,18 @@ void debugdraw_system::frame_render(std::chrono::duration<float>)
 		const auto& probe = probe_comp_ptr->get_probe();
 		if(probe.type == probe_type::box)
 		{
-			ddPush();
-			ddSetColor(0xff00ff00);
-			ddSetWireframe(true);
-			ddSetTransform(&world_transform);
-			Aabb aabb;
-			aabb.m_min[0] = -probe.box_data.extents.x;
-			aabb.m_min[1] = -probe.box_data.extents.y;
-			aabb.m_min[2] = -probe.box_data.extents.z;
-			aabb.m_max[0] = probe.box_data.extents.x;
-			aabb.m_max[1] = probe.box_data.extents.y;
-			aabb.m_max[2] = probe.box_data.extents.z;
-			ddDraw(aabb);
-			ddSetTransform(nullptr);
-			ddPop();
+			math::bbox bounds;
+			bounds.min = -probe.box_data.extents;
+			bounds.max = probe.box_data.extents;
+			_batcher.add_aabb(bounds, world_transform, 0xff00ff00);
 		}
 		else
 		{
 			auto radius = probe.sphere_data.range;
-			ddPush();
-			ddSetColor(0xff00ff00);
-			ddSetWireframe(true);
 			math::vec3 center = transform_comp_ptr->get_position();
-			ddDrawCircle(Axis::X, center.x, center.y, center.z, radius);
-			ddDrawCircle(Axis::Y, center.x, center.y, center.z, radius);
-			ddDrawCircle(Axis::Z, center.x, center.y, center.z, radius);
-			ddPop();
+			_batcher.add_circle(center, {1.0f, 0.0f, 0.0f}, radius, 0xff00ff00);
+			_batcher.add_circle(center, {0.0f, 1.0f, 0.0f}, radius, 0xff00ff00);
+			_batcher.add_circle(center, {0.0f, 0.0f, 1.0f}, radius, 0xff00ff00);
 		}
 	}
 
@@ -240,16 +196,14 @@ void debugdraw_system::frame_render(std::chrono::duration<float>)
 		const auto model_comp = selected_entity.get_component<model_component>();
 		const auto model_comp_ptr = model_comp.lock().get();
 		const auto& model = model_comp_ptr->get_model();
-		if(!model.is_valid())
-			return;
-
-		const auto mesh = model.get_lod(0);
-		if(!mesh)
-			return;
+		asset_handle<mesh> lod;
+		if(model.is_valid())
+		{
+			lod = model.get_lod(0);
+		}
 		const auto& frustum = camera.get_frustum();
-		const auto& bounds = mesh->get_bounds();
 		// Test the bounding box of the mesh
-		if(math::frustum::test_obb(frustum, bounds, world_transform))
+		if(lod && math::frustum::test_obb(frustum, lod->get_bounds(), world_transform))
 		{
 			// if(es->wireframe_selection)
 			//{
@@ -276,23 +230,12 @@ void debugdraw_system::frame_render(std::chrono::duration<float>)
 			//}
 			// else
 			{
-				ddPush();
-				ddSetColor(0xff00ff00);
-				ddSetWireframe(true);
-				ddSetTransform(&world_transform);
-				Aabb aabb;
-				aabb.m_min[0] = bounds.min.x;
-				aabb.m_min[1] = bounds.min.y;
-				aabb.m_min[2] = bounds.min.z;
-				aabb.m_max[0] = bounds.max.x;
-				aabb.m_max[1] = bounds.max.y;
-				aabb.m_max[2] = bounds.max.z;
-				ddDraw(aabb);
-				ddSetTransform(nullptr);
-				ddPop();
+				_batcher.add_aabb(lod->get_bounds(), world_transform, 0xff00ff00);
 			}
 		}
 	}
+
+	_batcher.flush();
 }
 
 debugdraw_system::debugdraw_system()
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "debugdraw_batcher.h"
+
 #include <chrono>
 #include <memory>
 
@@ -26,5 +28,7 @@ public:
 private:
 	///
 	std::unique_ptr<gpu_program> _program;
+	/// collects the frame's outline shapes and submits them in one batch
+	debugdraw_batcher _batcher;
 };
 }
@@ -1,6 +1,8 @@
 #include "app.h"
+#include "../assets/thumbnail_cache.h"
 #include "../console/console_log.h"
 #include "../editing/editing_system.h"
+#include "../editing/hlod_builder.h"
 #include "../editing/picking_system.h"
 #include "../interface/docks/console_dock.h"
 #include "../interface/docks/docking.h"
@@ -11,10 +13,13 @@
 #include "../interface/docks/scene_dock.h"
 #include "../interface/docks/style_dock.h"
 #include "../interface/gui_system.h"
+#include "../interface/stats_overlay.h"
 #include "../rendering/debugdraw_system.h"
 #include "../system/project_manager.h"
 #include "core/filesystem/filesystem.h"
 #include "core/logging/logging.h"
+#include "core/memory/memory_tracker.h"
+#include "core/reflection/reflection.h"
 #include "editor_core/nativefd/filedialog.h"
 #include "runtime/assets/asset_manager.h"
 #include "runtime/assets/impl/asset_extensions.h"
@@ -29,6 +34,11 @@
 #include "runtime/input/input.h"
 #include "runtime/rendering/renderer.h"
 #include "runtime/system/events.h"
+#include "runtime/system/hitch_detector.h"
+#include "runtime/system/telemetry_recorder.h"
+
+#include <cmath>
+#include <map>
 namespace editor
 {
 
@@ -48,6 +58,30 @@ std::vector<runtime::entity> gather_scene_data()
 	return entities;
 }
 
+bool is_subtree_touched_since(const runtime::entity& e, std::uint32_t frame)
+{
+	if(!e.valid())
+		return false;
+
+	for(const auto& component_shared : e.all_components_shared())
+	{
+		if(component_shared && component_shared->get_last_touched() > frame)
+			return true;
+	}
+
+	auto transform_shared = e.get_component<transform_component>().lock();
+	if(transform_shared)
+	{
+		for(const auto& child : transform_shared->get_children())
+		{
+			if(is_subtree_touched_since(child, frame))
+				return true;
+		}
+	}
+
+	return false;
+}
+
 void default_scene()
 {
 	auto& am = core::get_subsystem<runtime::asset_manager>();
@@ -178,13 +212,64 @@ auto save_scene()
 	if(path != "")
 	{
 		auto entities = gather_scene_data();
+		es.last_save_roots = entities.size();
 		ecs::utils::save_entities_to_file(path, std::move(entities));
+		es.last_save_frame = static_cast<std::uint32_t>(runtime::ecs::get_frame());
 		APPLOG_INFO("Saving scene successful.");
 	}
 
 	es.save_editor_camera();
 }
 
+//-----------------------------------------------------------------------------
+//  Name : save_scene_cells ()
+/// <summary>
+/// Splits the current scene into spatial streaming cells and writes each
+/// one as its own scene file next to the base scene
+/// ('<scene>.cell_<x>_<z>.sgr'), bucketing root entities by world
+/// position on an xz grid. The cell files go through the regular scene
+/// compile, and the runtime's world_streaming system loads them back in
+/// around the camera.
+/// </summary>
+//-----------------------------------------------------------------------------
+auto save_scene_cells()
+{
+	auto& es = core::get_subsystem<editor::editing_system>();
+	const auto& path = es.scene;
+	if(path == "")
+		return;
+
+	const float cell_size = 100.0f;
+
+	// Bucket scene roots by world position; roots without a transform have
+	// no place in space and land in the origin cell.
+	std::map<std::pair<std::int32_t, std::int32_t>, std::vector<runtime::entity>> cells;
+	for(auto& root : gather_scene_data())
+	{
+		std::pair<std::int32_t, std::int32_t> cell(0, 0);
+		auto transform_comp = root.get_component<transform_component>().lock();
+		if(transform_comp)
+		{
+			const auto position = transform_comp->get_transform().get_position();
+			cell.first = std::int32_t(std::floor(position.x / cell_size));
+			cell.second = std::int32_t(std::floor(position.z / cell_size));
+		}
+		cells[cell].push_back(root);
+	}
+
+	for(const auto& pair : cells)
+	{
+		fs::path cell_path = path;
+		cell_path.replace_extension();
+		cell_path += ".cell_" + std::to_string(pair.first.first) + "_" +
+					 std::to_string(pair.first.second) + ".sgr";
+		ecs::utils::save_entities_to_file(cell_path, pair.second);
+	}
+
+	APPLOG_INFO("Saved scene as {0} streaming cells.", cells.size());
+	es.save_editor_camera();
+}
+
 void save_scene_as()
 {
 	auto& es = core::get_subsystem<editor::editing_system>();
@@ -288,6 +373,11 @@ void app::draw_menubar(render_window& window)
 			{
 				save_scene_as();
 			}
+			if(gui::MenuItem("SAVE AS STREAMING CELLS", nullptr, false,
+							 es.scene != "" && current_project != ""))
+			{
+				save_scene_cells();
+			}
 
 			gui::EndMenu();
 		}
@@ -309,6 +399,15 @@ void app::draw_menubar(render_window& window)
 			if(gui::MenuItem("PASTE", "CTRL+V"))
 			{
 			}
+			gui::Separator();
+			if(gui::MenuItem("BUILD HLOD CLUSTERS", nullptr, false, current_project != ""))
+			{
+				editor::build_hlod_clusters();
+			}
+			if(gui::MenuItem("CLEAR HLOD CLUSTERS", nullptr, false, current_project != ""))
+			{
+				editor::clear_hlod_clusters();
+			}
 			gui::EndMenu();
 		}
 		if(gui::BeginMenu("WINDOWS"))
@@ -337,6 +436,10 @@ void app::draw_menubar(render_window& window)
 			{
 				create_window_with_dock<style_dock>("STYLE");
 			}
+			if(gui::MenuItem("STATS", nullptr, es.show_stats))
+			{
+				es.show_stats = !es.show_stats;
+			}
 			gui::EndMenu();
 		}
 		float offset = gui::GetWindowHeight();
@@ -408,9 +511,16 @@ void app::draw_toolbar()
 
 void app::setup(cmd_line::parser& parser)
 {
+	// The editor genuinely needs the full reflection metadata - the
+	// inspectors and component enumeration query every registered type -
+	// so run all the registrations deferred from static init up front.
+	// The shipped runtime never reflects and never pays for this.
+	reflection::warm_up();
+
 	runtime::app::setup(parser);
 
 	runtime::on_frame_update.connect(this, &editor::app::draw_docks);
+	runtime::on_frame_update.connect(this, &editor::app::autosave);
 }
 
 void app::start(cmd_line::parser& parser)
@@ -429,6 +539,7 @@ void app::start(cmd_line::parser& parser)
 	core::add_subsystem<picking_system>();
 	core::add_subsystem<debugdraw_system>();
 	core::add_subsystem<project_manager>();
+	core::add_subsystem<thumbnail_cache>();
 
 	auto& rend = core::get_subsystem<runtime::renderer>();
 	auto& main_window = rend.get_main_window();
@@ -465,15 +576,131 @@ void app::start(cmd_line::parser& parser)
 	std::function<void()> log_version = []() { APPLOG_INFO("Version 1.0"); };
 	_console_log->register_command("version", "Returns the current version of the Editor.", {}, {},
 								   log_version);
+
+	std::function<void()> dump_memory = []() { APPLOG_INFO(memory::memory_tracker::get().dump()); };
+	_console_log->register_command("memory_dump", "Dumps per-subsystem memory accounting.", {}, {},
+								   dump_memory);
+
+	std::function<void()> log_stats = []() {
+		const auto stats = logging::get_async_logging_container()->get_stats();
+		APPLOG_INFO("Log queue: {0} enqueued, {1} dropped, {2} pending.", stats.enqueued, stats.dropped,
+					stats.pending);
+	};
+	_console_log->register_command("log_stats", "Prints async log queue statistics.", {}, {}, log_stats);
+
+	std::function<void()> dump_hitches = []() {
+		APPLOG_INFO(core::get_subsystem<runtime::hitch_detector>().dump());
+	};
+	_console_log->register_command("hitch_dump", "Dumps the recent hitch captures.", {}, {}, dump_hitches);
+
+	std::function<void(float)> hitch_threshold = [](float multiple) {
+		core::get_subsystem<runtime::hitch_detector>().set_threshold(multiple);
+		APPLOG_INFO("Hitch threshold set to {0}x the rolling median.", multiple);
+	};
+	_console_log->register_command("hitch_threshold",
+								   "Sets the hitch threshold as a multiple of the median frame time.",
+								   {"multiple"}, {}, hitch_threshold);
+
+	std::function<void(int, int)> track_callstacks = [](int enable, int min_bytes) {
+		memory::memory_tracker::get().set_callstack_capture(enable != 0,
+															std::size_t(min_bytes < 0 ? 0 : min_bytes));
+		APPLOG_INFO("Memory callstack capture {0}.", enable != 0 ? "enabled" : "disabled");
+	};
+	_console_log->register_command("memory_callstacks",
+								   "Toggles callstack capture for allocations above min_bytes.",
+								   {"enable", "min_bytes"}, {"4096"}, track_callstacks);
+
+	std::function<void(std::string)> telemetry_start = [](std::string file) {
+		auto& recorder = core::get_subsystem<runtime::telemetry_recorder>();
+		if(recorder.start(file))
+			APPLOG_INFO("Recording telemetry to {0}.", file);
+		else if(recorder.is_recording())
+			APPLOG_ERROR("Telemetry is already recording - telemetry_stop first.");
+		else
+			APPLOG_ERROR("Could not open telemetry file {0}.", file);
+	};
+	_console_log->register_command("telemetry_start",
+								   "Records per-frame telemetry to a file (.csv or binary).", {"file"},
+								   {"telemetry.csv"}, telemetry_start);
+
+	std::function<void()> telemetry_stop = []() {
+		const auto rows = core::get_subsystem<runtime::telemetry_recorder>().stop();
+		APPLOG_INFO("Telemetry recording stopped after {0} frames.", rows);
+	};
+	_console_log->register_command("telemetry_stop", "Stops the telemetry recording and closes the file.",
+								   {}, {}, telemetry_stop);
 }
 
 void app::stop()
 {
+	runtime::on_frame_update.disconnect(this, &editor::app::autosave);
 	runtime::on_frame_update.disconnect(this, &editor::app::draw_docks);
 
 	runtime::app::stop();
 }
 
+void app::autosave(std::chrono::duration<float> dt)
+{
+	// Flushes unsaved edits periodically without the full-scene freeze.
+	// Only subtrees touched since the last full save are serialized,
+	// into a journal next to the scene file; loading merges the journal
+	// back over the base snapshot. The regular full save stays the
+	// compaction point - once a decent share of the scene is dirty (or
+	// entities were removed, which the journal cannot express) a full
+	// save is written instead.
+	_time_since_autosave += dt.count();
+	if(_time_since_autosave < 30.0f)
+		return;
+	_time_since_autosave = 0.0f;
+
+	auto& es = core::get_subsystem<editing_system>();
+	if(es.scene.empty())
+		return;
+
+	auto roots = gather_scene_data();
+	std::vector<runtime::entity> dirty;
+	for(const auto& root : roots)
+	{
+		if(is_subtree_touched_since(root, es.last_save_frame))
+			dirty.push_back(root);
+	}
+
+	if(dirty.empty() && roots.size() == es.last_save_roots)
+		return;
+
+	// the journal on disk already covers everything dirty - skip the
+	// rewrite until something is touched again
+	bool changed = roots.size() != es.last_save_roots;
+	for(const auto& root : dirty)
+	{
+		if(changed)
+			break;
+		changed = is_subtree_touched_since(root, _last_autosave_frame);
+	}
+	if(_last_autosave_frame > es.last_save_frame && !changed)
+		return;
+
+	if(roots.size() != es.last_save_roots || dirty.size() * 4 >= roots.size())
+	{
+		// Full compaction without the freeze: the scene is snapshotted into
+		// memory through the fast binary form and a worker writes the file,
+		// so the editor thread no longer stalls proportionally to scene
+		// size. Manual saves keep the synchronous associative form.
+		es.last_save_roots = roots.size();
+		if(ecs::utils::save_entities_to_file_async(es.scene, roots))
+		{
+			es.last_save_frame = static_cast<std::uint32_t>(runtime::ecs::get_frame());
+			APPLOG_INFO("Autosaved full scene snapshot ({0} entities) in the background.", roots.size());
+		}
+	}
+	else
+	{
+		ecs::utils::save_entities_journal(es.scene, dirty);
+		APPLOG_INFO("Autosaved {0} of {1} scene entities.", dirty.size(), roots.size());
+	}
+	_last_autosave_frame = static_cast<std::uint32_t>(runtime::ecs::get_frame());
+}
+
 void app::draw_docks(std::chrono::duration<float> dt)
 {
 	auto& gui = core::get_subsystem<gui_system>();
@@ -500,6 +727,15 @@ void app::draw_docks(std::chrono::duration<float> dt)
 		else
 		{
 			draw_dockspace(i == 0, *window, dockspace);
+
+			if(i == 0)
+			{
+				auto& es = core::get_subsystem<editor::editing_system>();
+				if(es.show_stats)
+				{
+					editor::draw_stats_overlay(dt);
+				}
+			}
 		}
 
 		handle_drag_and_drop();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "runtime/system/app.h"
+#include <cstdint>
 #include <string>
 
 namespace imguidock
@@ -25,6 +26,8 @@ public:
 
 	void draw_docks(std::chrono::duration<float>);
 
+	void autosave(std::chrono::duration<float> dt);
+
 	void draw_header(render_window& window);
 	void draw_dockspace(bool is_main, render_window& window, imguidock::dockspace& dockspace);
 	void draw_footer(render_window& window, imguidock::dockspace& dockspace);
@@ -36,6 +39,10 @@ public:
 private:
 	bool _show_start_page = true;
 	///
+	float _time_since_autosave = 0.0f;
+	///
+	std::uint32_t _last_autosave_frame = 0;
+	///
 	std::shared_ptr<console_log> _console_log;
 	///
 	std::string _console_dock_name;
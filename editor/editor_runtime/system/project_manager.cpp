@@ -6,9 +6,11 @@
 #include "core/graphics/graphics.h"
 #include "core/logging/logging.h"
 #include "core/serialization/associative_archive.h"
+#include "core/string_utils/string_utils.h"
 #include "core/system/subsystem.h"
 #include "core/tasks/task_system.h"
 #include "runtime/assets/asset_manager.h"
+#include "runtime/assets/asset_manifest.h"
 #include "runtime/assets/impl/asset_extensions.h"
 #include "runtime/ecs/ecs.h"
 #include "runtime/system/events.h"
@@ -95,8 +97,31 @@ void project_manager::close_project()
 	es.close_project();
 	ecs.dispose();
 	am.clear("app:/data");
+
+	// the deferred open scan may still be walking the project - let it
+	// finish before tearing the syncers down, then record the final state
+	// of the trees for the next open to diff against
+	if(_app_scan_task.valid())
+	{
+		_app_scan_task.wait();
+		save_scan_state();
+	}
+
 	_app_meta_syncer.unsync();
 	_app_cache_syncer.unsync();
+
+	// Re-cook the compiled cache's manifest so the next session (and the
+	// shipped runtime) resolves assets from one index instead of a
+	// per-key stat storm.
+	if(core::has_subsystems<runtime::asset_manifest>())
+	{
+		fs::error_code err;
+		const auto cache_dir = fs::resolve_protocol("app:/cache");
+		if(fs::exists(cache_dir, err))
+			runtime::asset_manifest::build(cache_dir / "assets.manifest", cache_dir);
+
+		core::get_subsystem<runtime::asset_manifest>().unload();
+	}
 }
 
 bool project_manager::open_project(const fs::path& project_path)
@@ -116,8 +141,33 @@ bool project_manager::open_project(const fs::path& project_path)
 
 	save_config();
 
-	setup_meta_syncer(_app_meta_syncer, "app:/data", "app:/meta");
-	setup_cache_syncer(_app_cache_syncer, "app:/meta", "app:/cache");
+	// The full walk of the project trees used to happen right here and
+	// kept the editor frozen until every file had been pushed through the
+	// syncers. Load last session's scan so the initial listings only
+	// process files that actually changed, and run the walk itself on a
+	// worker - the editor is interactive immediately.
+	load_scan_state();
+
+	auto& ts = core::get_subsystem<core::task_system>();
+	_app_scan_task = ts.push_on_worker_thread([this]() {
+		setup_meta_syncer(_app_meta_syncer, "app:/data", "app:/meta");
+		setup_cache_syncer(_app_cache_syncer, "app:/meta", "app:/cache");
+
+		// initial listings are done - refresh the snapshot and drop it,
+		// live watcher callbacks never consult it
+		save_scan_state();
+		_last_scan_state.clear();
+	});
+
+	// Pick up the manifest cooked when this project last closed. It is
+	// advisory - assets compiled this session miss it and fall back to
+	// probing - but it spares the bulk of the resolution stats.
+	if(core::has_subsystems<runtime::asset_manifest>())
+	{
+		const auto manifest_path = fs::resolve_protocol("app:/cache/assets.manifest");
+		if(fs::exists(manifest_path, err))
+			core::get_subsystem<runtime::asset_manifest>().load(manifest_path);
+	}
 
 	auto& es = core::get_subsystem<editing_system>();
 	es.load_editor_camera();
@@ -216,8 +266,13 @@ void project_manager::setup_meta_syncer(fs::syncer& syncer, const fs::path& data
 		}
 	};
 
-	const auto on_file_modified = [](const auto& ref_path, const auto& synced_paths,
-									 bool is_initial_listing) {
+	const auto on_file_modified = [this](const auto& ref_path, const auto& synced_paths,
+										 bool is_initial_listing) {
+
+		if(is_unchanged_since_last_scan(ref_path, is_initial_listing))
+		{
+			return;
+		}
 
 		for(const auto& synced_path : synced_paths)
 		{
@@ -246,6 +301,7 @@ void project_manager::setup_meta_syncer(fs::syncer& syncer, const fs::path& data
 		}
 	}
 
+	syncer.set_task_system(&core::get_subsystem<core::task_system>());
 	syncer.sync(fs::resolve_protocol(data_dir_protocol), fs::resolve_protocol(meta_dir_protocol));
 }
 
@@ -263,8 +319,6 @@ static std::vector<fs::path> remove_meta_tag(const std::vector<fs::path>& synced
 void project_manager::setup_cache_syncer(fs::syncer& syncer, const fs::path& meta_dir_protocol,
 										 const fs::path& cache_dir_protocol)
 {
-	auto& ts = core::get_subsystem<core::task_system>();
-
 	setup_directory(syncer);
 	static const std::string wildcard = "*";
 
@@ -287,9 +341,15 @@ void project_manager::setup_cache_syncer(fs::syncer& syncer, const fs::path& met
 		}
 	};
 
-	auto on_image_modified = [&ts](const auto& ref_path, const auto& synced_paths, bool is_initial_listing) {
+	auto on_image_modified = [this](const auto& ref_path, const auto& synced_paths, bool is_initial_listing) {
+
+		if(is_unchanged_since_last_scan(ref_path, is_initial_listing))
+		{
+			return;
+		}
 
-		auto task = ts.push_on_worker_thread(
+		_compile_scheduler.enqueue(
+			project_compiler::job_type::texture,
 			[ ref_path, synced_paths = remove_meta_tag(synced_paths), is_initial_listing ]() {
 
 				fs::path output = synced_paths.front();
@@ -310,8 +370,14 @@ void project_manager::setup_cache_syncer(fs::syncer& syncer, const fs::path& met
 		watch_assets<gfx::texture>(cache_dir_protocol, wildcard + type, true);
 	}
 
-	auto on_mesh_modified = [&ts](const auto& ref_path, const auto& synced_paths, bool is_initial_listing) {
-		auto task = ts.push_on_worker_thread(
+	auto on_mesh_modified = [this](const auto& ref_path, const auto& synced_paths, bool is_initial_listing) {
+		if(is_unchanged_since_last_scan(ref_path, is_initial_listing))
+		{
+			return;
+		}
+
+		_compile_scheduler.enqueue(
+			project_compiler::job_type::mesh,
 			[ ref_path, synced_paths = remove_meta_tag(synced_paths), is_initial_listing ]() {
 				fs::path output = synced_paths.front();
 				fs::error_code err;
@@ -330,8 +396,14 @@ void project_manager::setup_cache_syncer(fs::syncer& syncer, const fs::path& met
 		watch_assets<mesh>(cache_dir_protocol, wildcard + type, true);
 	}
 
-	auto on_sound_modified = [&ts](const auto& ref_path, const auto& synced_paths, bool is_initial_listing) {
-		auto task = ts.push_on_worker_thread(
+	auto on_sound_modified = [this](const auto& ref_path, const auto& synced_paths, bool is_initial_listing) {
+		if(is_unchanged_since_last_scan(ref_path, is_initial_listing))
+		{
+			return;
+		}
+
+		_compile_scheduler.enqueue(
+			project_compiler::job_type::sound,
 			[ ref_path, synced_paths = remove_meta_tag(synced_paths), is_initial_listing ]() {
 				fs::path output = synced_paths.front();
 				fs::error_code err;
@@ -351,8 +423,14 @@ void project_manager::setup_cache_syncer(fs::syncer& syncer, const fs::path& met
 		watch_assets<audio::sound>(cache_dir_protocol, wildcard + type, true);
 	}
 
-	auto on_shader_modified = [&ts](const auto& ref_path, const auto& synced_paths, bool is_initial_listing) {
-		auto task = ts.push_on_worker_thread(
+	auto on_shader_modified = [this](const auto& ref_path, const auto& synced_paths, bool is_initial_listing) {
+		if(is_unchanged_since_last_scan(ref_path, is_initial_listing))
+		{
+			return;
+		}
+
+		_compile_scheduler.enqueue(
+			project_compiler::job_type::shader,
 			[ ref_path, synced_paths = remove_meta_tag(synced_paths), is_initial_listing ]() {
 				const auto& renderer_extension = gfx::get_renderer_filename_extension();
 				auto it = std::find_if(std::begin(synced_paths), std::end(synced_paths),
@@ -386,9 +464,15 @@ void project_manager::setup_cache_syncer(fs::syncer& syncer, const fs::path& met
 		watch_assets<gfx::shader>(cache_dir_protocol, wildcard + type, true);
 	}
 
-	auto on_material_modified = [&ts](const auto& ref_path, const auto& synced_paths,
-									  bool is_initial_listing) {
-		auto task = ts.push_on_worker_thread(
+	auto on_material_modified = [this](const auto& ref_path, const auto& synced_paths,
+									   bool is_initial_listing) {
+		if(is_unchanged_since_last_scan(ref_path, is_initial_listing))
+		{
+			return;
+		}
+
+		_compile_scheduler.enqueue(
+			project_compiler::job_type::material,
 			[ ref_path, synced_paths = remove_meta_tag(synced_paths), is_initial_listing ]() {
 				fs::path output = synced_paths.front();
 				fs::error_code err;
@@ -409,8 +493,14 @@ void project_manager::setup_cache_syncer(fs::syncer& syncer, const fs::path& met
 		watch_assets<material>(cache_dir_protocol, wildcard + type, true);
 	}
 
-	auto on_anim_modified = [&ts](const auto& ref_path, const auto& synced_paths, bool is_initial_listing) {
-		auto task = ts.push_on_worker_thread(
+	auto on_anim_modified = [this](const auto& ref_path, const auto& synced_paths, bool is_initial_listing) {
+		if(is_unchanged_since_last_scan(ref_path, is_initial_listing))
+		{
+			return;
+		}
+
+		_compile_scheduler.enqueue(
+			project_compiler::job_type::animation,
 			[ ref_path, synced_paths = remove_meta_tag(synced_paths), is_initial_listing ]() {
 				fs::path output = synced_paths.front();
 				fs::error_code err;
@@ -429,8 +519,14 @@ void project_manager::setup_cache_syncer(fs::syncer& syncer, const fs::path& met
 		watch_assets<runtime::animation>(cache_dir_protocol, wildcard + type, true);
 	}
 
-	auto on_prefab_modified = [&ts](const auto& ref_path, const auto& synced_paths, bool is_initial_listing) {
-		auto task = ts.push_on_worker_thread(
+	auto on_prefab_modified = [this](const auto& ref_path, const auto& synced_paths, bool is_initial_listing) {
+		if(is_unchanged_since_last_scan(ref_path, is_initial_listing))
+		{
+			return;
+		}
+
+		_compile_scheduler.enqueue(
+			project_compiler::job_type::prefab,
 			[ ref_path, synced_paths = remove_meta_tag(synced_paths), is_initial_listing ]() {
 				fs::path output = synced_paths.front();
 				fs::error_code err;
@@ -451,8 +547,14 @@ void project_manager::setup_cache_syncer(fs::syncer& syncer, const fs::path& met
 		watch_assets<prefab>(cache_dir_protocol, wildcard + type, true);
 	}
 
-	auto on_scene_modified = [&ts](const auto& ref_path, const auto& synced_paths, bool is_initial_listing) {
-		auto task = ts.push_on_worker_thread(
+	auto on_scene_modified = [this](const auto& ref_path, const auto& synced_paths, bool is_initial_listing) {
+		if(is_unchanged_since_last_scan(ref_path, is_initial_listing))
+		{
+			return;
+		}
+
+		_compile_scheduler.enqueue(
+			project_compiler::job_type::scene,
 			[ ref_path, synced_paths = remove_meta_tag(synced_paths), is_initial_listing ]() {
 				fs::path output = synced_paths.front();
 				fs::error_code err;
@@ -471,9 +573,87 @@ void project_manager::setup_cache_syncer(fs::syncer& syncer, const fs::path& met
 
 		watch_assets<scene>(cache_dir_protocol, wildcard + type, true);
 	}
+	syncer.set_task_system(&core::get_subsystem<core::task_system>());
 	syncer.sync(fs::resolve_protocol(meta_dir_protocol), fs::resolve_protocol(cache_dir_protocol));
 }
 
+bool project_manager::is_unchanged_since_last_scan(const fs::path& ref_path, bool is_initial_listing) const
+{
+	if(!is_initial_listing || _last_scan_state.empty())
+	{
+		return false;
+	}
+
+	auto it = _last_scan_state.find(ref_path.generic_string());
+	if(it == _last_scan_state.end())
+	{
+		return false;
+	}
+
+	fs::error_code err;
+	const auto time =
+		static_cast<std::uint64_t>(fs::last_write_time(ref_path, err).time_since_epoch().count());
+	return time == it->second;
+}
+
+static void record_tree(const fs::path& dir, std::unordered_map<std::string, std::uint64_t>& state)
+{
+	fs::error_code err;
+	fs::recursive_directory_iterator it(dir, err);
+	for(const auto& entry : it)
+	{
+		fs::error_code entry_err;
+		if(fs::is_regular_file(entry.path(), entry_err))
+		{
+			const auto time = static_cast<std::uint64_t>(
+				fs::last_write_time(entry.path(), entry_err).time_since_epoch().count());
+			state[entry.path().generic_string()] = time;
+		}
+	}
+}
+
+void project_manager::save_scan_state() const
+{
+	scan_state_t state;
+	record_tree(fs::resolve_protocol("app:/data"), state);
+	record_tree(fs::resolve_protocol("app:/meta"), state);
+
+	fs::error_code err;
+	fs::create_directory(fs::resolve_protocol("app:/settings"), err);
+	const auto scan_state_file = fs::resolve_protocol("app:/settings/scan.state");
+	std::ofstream output(scan_state_file.string(), std::ofstream::trunc);
+	for(const auto& pair : state)
+	{
+		output << pair.second << ' ' << pair.first << '\n';
+	}
+}
+
+void project_manager::load_scan_state()
+{
+	_last_scan_state.clear();
+
+	const auto scan_state_file = fs::resolve_protocol("app:/settings/scan.state");
+	std::ifstream input(scan_state_file.string());
+	std::string line;
+	while(std::getline(input, line))
+	{
+		const auto separator = line.find(' ');
+		if(separator == std::string::npos)
+		{
+			continue;
+		}
+
+		try
+		{
+			_last_scan_state[line.substr(separator + 1)] = std::stoull(line.substr(0, separator));
+		}
+		catch(const std::exception&)
+		{
+			// a corrupt line just means that file gets the full treatment
+		}
+	}
+}
+
 void project_manager::save_config()
 {
 	auto& rp = _options.recent_project_paths;
@@ -493,6 +673,41 @@ void project_manager::save_config()
 	try_save(ar, cereal::make_nvp("options", _options));
 }
 
+void project_manager::recompile_shader_dependents()
+{
+	const auto& renderer_extension = gfx::get_renderer_filename_extension();
+
+	static const std::vector<std::string> meta_protocols = {"engine:/meta", "editor:/meta", "app:/meta"};
+	for(const auto& meta_protocol : meta_protocols)
+	{
+		fs::error_code err;
+		const auto meta_dir = fs::resolve_protocol(meta_protocol);
+		if(!fs::exists(meta_dir, err))
+		{
+			continue;
+		}
+
+		fs::recursive_directory_iterator it(meta_dir, err);
+		for(const auto& entry : it)
+		{
+			const auto& ref_path = entry.path();
+			if(!string_utils::ends_with(ref_path.filename().string(), ".sc.meta"))
+			{
+				continue;
+			}
+
+			auto cache_key = fs::convert_to_protocol(ref_path);
+			cache_key = fs::replace(cache_key.generic(), ":/meta", ":/cache");
+			fs::path output =
+				fs::resolve_protocol(fs::replace(cache_key, ".meta", renderer_extension + ".asset"));
+
+			_compile_scheduler.enqueue(project_compiler::job_type::shader, [ref_path, output]() {
+				project_compiler::compile_shader(ref_path, output);
+			});
+		}
+	}
+}
+
 project_manager::project_manager()
 {
 	load_config();
@@ -500,10 +715,32 @@ project_manager::project_manager()
 	setup_cache_syncer(_engine_cache_syncer, "engine:/meta", "engine:/cache");
 	setup_meta_syncer(_editor_meta_syncer, "editor:/data", "editor:/meta");
 	setup_cache_syncer(_editor_cache_syncer, "editor:/meta", "editor:/cache");
+
+	// Shared shader headers are not assets - no syncer mapping covers
+	// them - yet editing one invalidates every shader that includes it.
+	// Fan a change out as compile checks; the compiler's include-closure
+	// hash lets the untouched shaders fall straight through.
+	const fs::path include_dir = fs::resolve_protocol("shader_include:/");
+	_shader_include_watch_id =
+		fs::watcher::watch(include_dir / "*.sh", true, false, 500ms,
+						   [this](const auto& entries, bool is_initial_list) {
+							   if(is_initial_list || entries.empty())
+							   {
+								   return;
+							   }
+							   recompile_shader_dependents();
+						   });
 }
 
 project_manager::~project_manager()
 {
+	fs::watcher::unwatch(_shader_include_watch_id);
+
+	// the deferred scan captures this - never outlive it
+	if(_app_scan_task.valid())
+	{
+		_app_scan_task.wait();
+	}
 	save_config();
 }
 }
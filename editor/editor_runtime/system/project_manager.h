@@ -1,8 +1,12 @@
 #pragma once
+#include "../assets/asset_compiler.h"
 #include "core/filesystem/filesystem_syncer.h"
 #include "core/math/math_includes.h"
+#include "core/tasks/task_system.h"
+#include <cstdint>
 #include <deque>
 #include <mutex>
+#include <unordered_map>
 
 namespace editor
 {
@@ -107,16 +111,63 @@ public:
 	}
     
 private:
+	/// path -> last write time, as recorded by the previous session
+	using scan_state_t = std::unordered_map<std::string, std::uint64_t>;
+
 	void setup_directory(fs::syncer& syncer);
 	void setup_meta_syncer(fs::syncer& syncer, const fs::path& data_dir_protocol,
 						   const fs::path& meta_dir_protocol);
 	void setup_cache_syncer(fs::syncer& syncer, const fs::path& meta_dir_protocol,
 							const fs::path& cache_dir_protocol);
+
+	//-----------------------------------------------------------------------------
+	//  Name : is_unchanged_since_last_scan ()
+	/// <summary>
+	/// Whether an initial listing entry matches last session's recorded
+	/// write time and can skip its synced-output work entirely. Always
+	/// false outside the initial listing.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool is_unchanged_since_last_scan(const fs::path& ref_path, bool is_initial_listing) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : save_scan_state ()
+	/// <summary>
+	/// Walks the project data and meta trees and persists their current
+	/// write times for the next open to diff against.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void save_scan_state() const;
+
+	void load_scan_state();
+
+	//-----------------------------------------------------------------------------
+	//  Name : recompile_shader_dependents ()
+	/// <summary>
+	/// Enqueues a compile check for every known shader. Called when a
+	/// shader include changes - shaders whose recorded include closure
+	/// hashes the same are skipped by the compiler's up-to-date gate, so
+	/// exactly the dependents of the edited header rebuild.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void recompile_shader_dependents();
+
 	/// Project options
 	options _options;
 	/// Current project name
 	std::string _project_name;
-    
+
+	/// Balances compile jobs across the task system with per-type
+	/// concurrency caps. Declared before the syncers - their callbacks
+	/// reference it and must be torn down first.
+	project_compiler::compile_scheduler _compile_scheduler;
+
+	/// Last session's scan, consulted by the initial listings only
+	scan_state_t _last_scan_state;
+
+	/// The deferred project scan - closing waits for it before unsyncing
+	core::task_future<void> _app_scan_task;
+
 	fs::syncer _app_meta_syncer;
 	fs::syncer _app_cache_syncer;
                    
@@ -125,5 +176,9 @@ private:
     
     fs::syncer _engine_meta_syncer;
 	fs::syncer _engine_cache_syncer;
+
+	/// Watch over the shared shader include directory; changes there fan
+	/// out as compile checks across all shaders
+	std::uint64_t _shader_include_watch_id = 0;
 };
 }
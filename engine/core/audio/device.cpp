@@ -36,6 +36,14 @@ void device::disable()
 	}
 }
 
+void device::submit_deferred()
+{
+	if(_impl)
+	{
+		_impl->submit_deferred();
+	}
+}
+
 bool device::is_valid() const
 {
 	return _impl && _impl->is_valid();
@@ -41,6 +41,16 @@ public:
 	//-----------------------------------------------------------------------------
 	void disable();
 
+	//-----------------------------------------------------------------------------
+	//  Name : submit_deferred ()
+	/// <summary>
+	/// Submits every source property latched since the last call in one
+	/// batch - one al call per property that actually changed, bracketed
+	/// by the context suspend/process entry points. Call once per frame.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void submit_deferred();
+
 	//-----------------------------------------------------------------------------
 	//  Name : is_valid ()
 	/// <summary>
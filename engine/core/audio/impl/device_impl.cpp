@@ -1,6 +1,7 @@
 #include "device_impl.h"
 #include "../logger.h"
 #include "check.h"
+#include "source_impl.h"
 #include <AL/alc.h>
 #include <AL/alext.h>
 #include <cstdint>
@@ -152,6 +153,20 @@ void device_impl::disable()
 	al_check(alcMakeContextCurrent(nullptr));
 }
 
+void device_impl::submit_deferred()
+{
+	if(!_context)
+	{
+		return;
+	}
+
+	// the suspend/process pair is openal's batch entry point - every
+	// property pushed in between reaches the mixer as one atomic block
+	alcSuspendContext(_context);
+	flush_deferred_source_state();
+	alcProcessContext(_context);
+}
+
 bool device_impl::is_valid() const
 {
 	return _device && _context;
@@ -18,6 +18,8 @@ public:
 	void enable();
 	void disable();
 
+	void submit_deferred();
+
 	bool is_valid() const;
 
 	const std::string& get_device_id() const;
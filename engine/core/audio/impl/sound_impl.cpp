@@ -63,6 +63,7 @@ static ALenum get_format_for_channels(std::uint32_t channels, std::uint32_t byte
 }
 
 sound_impl::sound_impl(std::vector<std::uint8_t>&& buffer, const sound_info& info)
+	: _info(info)
 {
 	if(buffer.empty())
 		return;
@@ -75,8 +76,17 @@ sound_impl::sound_impl(std::vector<std::uint8_t>&& buffer, const sound_info& inf
 	buffer.clear();
 }
 
+sound_impl::sound_impl(std::shared_ptr<const std::vector<std::uint8_t>> encoded_buffer,
+					   const sound_info& info)
+	: _encoded(std::move(encoded_buffer))
+	, _info(info)
+{
+}
+
 sound_impl::sound_impl(sound_impl&& rhs)
 	: _handle(std::move(rhs._handle))
+	, _encoded(std::move(rhs._encoded))
+	, _info(rhs._info)
 {
 	rhs.cleanup();
 }
@@ -84,6 +94,8 @@ sound_impl::sound_impl(sound_impl&& rhs)
 sound_impl& sound_impl::operator=(sound_impl&& rhs)
 {
 	_handle = std::move(rhs._handle);
+	_encoded = std::move(rhs._encoded);
+	_info = rhs._info;
 	rhs.cleanup();
 
 	return *this;
@@ -103,7 +115,27 @@ sound_impl::~sound_impl()
 
 bool sound_impl::is_valid() const
 {
-	return _handle != 0;
+	return _handle != 0 || is_stream();
+}
+
+bool sound_impl::is_stream() const
+{
+	return _encoded && !_encoded->empty();
+}
+
+const std::shared_ptr<const std::vector<std::uint8_t>>& sound_impl::get_encoded_buffer() const
+{
+	return _encoded;
+}
+
+const sound_info& sound_impl::get_info() const
+{
+	return _info;
+}
+
+ALenum sound_impl::native_format(std::uint32_t channels, std::uint32_t bytes_per_sample)
+{
+	return detail::get_format_for_channels(channels, bytes_per_sample);
 }
 
 sound_impl::native_handle_type sound_impl::native_handle() const
@@ -141,6 +173,7 @@ void sound_impl::unbind_from_all_sources()
 void sound_impl::cleanup()
 {
 	_handle = 0;
+	_encoded.reset();
 	unbind_from_all_sources();
 }
 }
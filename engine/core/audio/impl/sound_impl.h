@@ -2,6 +2,7 @@
 
 #include "../sound_data.h"
 #include <AL/al.h>
+#include <memory>
 #include <mutex>
 
 namespace audio
@@ -18,6 +19,7 @@ public:
 	sound_impl();
 	~sound_impl();
 	sound_impl(std::vector<std::uint8_t>&& buffer, const sound_info& info);
+	sound_impl(std::shared_ptr<const std::vector<std::uint8_t>> encoded_buffer, const sound_info& info);
 	sound_impl(sound_impl&& rhs);
 	sound_impl& operator=(sound_impl&& rhs);
 
@@ -26,6 +28,14 @@ public:
 
 	bool is_valid() const;
 
+	bool is_stream() const;
+
+	const std::shared_ptr<const std::vector<std::uint8_t>>& get_encoded_buffer() const;
+
+	const sound_info& get_info() const;
+
+	static ALenum native_format(std::uint32_t channels, std::uint32_t bytes_per_sample);
+
 	native_handle_type native_handle() const;
 
 private:
@@ -38,6 +48,15 @@ private:
 
 	native_handle_type _handle = 0;
 
+	/// encoded source bytes of a streaming sound - shared with every
+	/// source that binds it so a decoder mid-read never touches freed
+	/// memory while the sound tears down
+	std::shared_ptr<const std::vector<std::uint8_t>> _encoded;
+
+	/// info of the sound - needed by the streaming path which has no
+	/// openal buffer to query
+	sound_info _info;
+
     /// openal doesn't let us destroy sounds that are
     /// binded, so we have to keep this bookkeeping
 	std::mutex _mutex;
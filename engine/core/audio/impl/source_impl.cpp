@@ -3,10 +3,155 @@
 #include "check.h"
 #include "sound_impl.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+
 namespace audio
 {
 namespace priv
 {
+namespace
+{
+/// number of openal buffers in a streaming ring
+const std::size_t stream_ring_size = 4;
+
+/// pcm bytes per ring buffer - a quarter second each keeps a second of
+/// audio queued ahead of the play cursor
+std::size_t stream_chunk_bytes(const sound_info& info)
+{
+	const std::size_t bytes_per_second =
+		std::size_t(info.sample_rate) * info.channels * info.bytes_per_sample;
+	return std::max<std::size_t>(bytes_per_second / 4, 4096);
+}
+
+//-----------------------------------------------------------------------------
+//  Name : stream_feeder (Class)
+/// <summary>
+/// Decode thread shared by every streaming source. Wakes periodically,
+/// refills whatever ring buffers openal has finished with and goes back
+/// to sleep - the ring is deep enough that the period never starves a
+/// source. Sources register on bind and unregister on unbind; removal
+/// blocks while a service pass runs, so a removed source is never
+/// touched again.
+/// </summary>
+//-----------------------------------------------------------------------------
+class stream_feeder
+{
+public:
+	~stream_feeder()
+	{
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_running = false;
+		}
+		_cv.notify_all();
+		if(_thread.joinable())
+		{
+			_thread.join();
+		}
+	}
+
+	void add(source_impl* source)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if(!_running)
+		{
+			_running = true;
+			_thread = std::thread([this]() { run(); });
+		}
+		_sources.push_back(source);
+	}
+
+	void remove(source_impl* source)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_sources.erase(std::remove(std::begin(_sources), std::end(_sources), source),
+					   std::end(_sources));
+	}
+
+private:
+	void run()
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		while(_running)
+		{
+			for(auto& source : _sources)
+			{
+				source->update_stream();
+			}
+			_cv.wait_for(lock, std::chrono::milliseconds(100));
+		}
+	}
+
+	std::thread _thread;
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::vector<source_impl*> _sources;
+	bool _running = false;
+};
+
+stream_feeder& get_stream_feeder()
+{
+	static stream_feeder feeder;
+	return feeder;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : state_batcher (Class)
+/// <summary>
+/// Registry of sources with latched property changes awaiting the
+/// per-frame deferred submit. Sources enlist on their first dirty bit
+/// and leave on destruction; the flush drains the whole list in one run.
+/// </summary>
+//-----------------------------------------------------------------------------
+class state_batcher
+{
+public:
+	void add(const source_impl* source)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if(std::find(std::begin(_sources), std::end(_sources), source) == std::end(_sources))
+		{
+			_sources.push_back(source);
+		}
+	}
+
+	void remove(const source_impl* source)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_sources.erase(std::remove(std::begin(_sources), std::end(_sources), source),
+					   std::end(_sources));
+	}
+
+	void flush_all()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for(const auto& source : _sources)
+		{
+			source->flush_state();
+		}
+		_sources.clear();
+	}
+
+private:
+	std::mutex _mutex;
+	std::vector<const source_impl*> _sources;
+};
+
+state_batcher& get_state_batcher()
+{
+	static state_batcher batcher;
+	return batcher;
+}
+}
+
+void flush_deferred_source_state()
+{
+	get_state_batcher().flush_all();
+}
+
 source_impl::source_impl()
 {
 	create();
@@ -15,12 +160,26 @@ source_impl::source_impl()
 source_impl::~source_impl()
 {
 	purge();
+	// after the teardown - purging can itself latch state - the flush
+	// list must never see this address again
+	get_state_batcher().remove(this);
 }
 
 source_impl::source_impl(source_impl&& rhs)
 	: _handle(std::move(rhs._handle))
 {
 	rhs._handle = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(rhs._state_mutex);
+		_state = rhs._state;
+		rhs._state.dirty = 0;
+	}
+	if(_state.dirty != 0)
+	{
+		get_state_batcher().remove(&rhs);
+		get_state_batcher().add(this);
+	}
 }
 
 source_impl& source_impl::operator=(source_impl&& rhs)
@@ -28,6 +187,18 @@ source_impl& source_impl::operator=(source_impl&& rhs)
 	_handle = std::move(rhs._handle);
 	rhs._handle = 0;
 
+	{
+		std::lock_guard<std::mutex> lock(rhs._state_mutex);
+		std::lock_guard<std::mutex> this_lock(_state_mutex);
+		_state = rhs._state;
+		rhs._state.dirty = 0;
+	}
+	if(_state.dirty != 0)
+	{
+		get_state_batcher().remove(&rhs);
+		get_state_batcher().add(this);
+	}
+
 	return *this;
 }
 
@@ -52,6 +223,11 @@ bool source_impl::bind(sound_impl* sound)
 
 	bind_sound(sound);
 
+	if(sound->is_stream())
+	{
+		return bind_stream(sound);
+	}
+
 	const auto buffer = sound->native_handle();
 
 	al_check(alSourcei(_handle, AL_SOURCE_RELATIVE, AL_FALSE));
@@ -69,8 +245,121 @@ bool source_impl::bind(sound_impl* sound)
 	return true;
 }
 
+bool source_impl::bind_stream(sound_impl* sound)
+{
+	std::string err;
+	const auto& encoded = sound->get_encoded_buffer();
+	_decoder = open_stream_from_memory(encoded->data(), encoded->size(), err);
+	if(!_decoder)
+	{
+		log_error(err);
+		unbind_sound();
+		return false;
+	}
+
+	_stream_data = encoded;
+	_stream_info = _decoder->get_info();
+	_stream_scratch.resize(stream_chunk_bytes(_stream_info));
+
+	al_check(alSourcei(_handle, AL_SOURCE_RELATIVE, AL_FALSE));
+
+	// the ring loops by rewinding the decoder - native looping would
+	// repeat whichever single buffer happens to be playing
+	al_check(alSourcei(_handle, AL_LOOPING, AL_FALSE));
+
+	if(_stream_info.channels > 1)
+	{
+		log_info("Sound is not mono. 3D Attenuation will not work.");
+	}
+
+	_stream_ring.resize(stream_ring_size, 0);
+	al_check(alGenBuffers(ALsizei(_stream_ring.size()), _stream_ring.data()));
+	for(auto& buffer : _stream_ring)
+	{
+		if(fill_stream_buffer(buffer))
+		{
+			al_check(alSourceQueueBuffers(_handle, 1, &buffer));
+		}
+	}
+
+	get_stream_feeder().add(this);
+	return true;
+}
+
+void source_impl::unbind_stream()
+{
+	if(!_decoder)
+		return;
+
+	get_stream_feeder().remove(this);
+
+	al_check(alSourcei(_handle, AL_BUFFER, 0));
+	al_check(alDeleteBuffers(ALsizei(_stream_ring.size()), _stream_ring.data()));
+
+	_stream_ring.clear();
+	_decoder.reset();
+	_stream_data.reset();
+	_stream_scratch.clear();
+	_stream_intent_playing = false;
+
+	// native looping was forced off for the ring - resubmit the latched
+	// value now that this is a plain buffer source again
+	mark_dirty(deferred_state::dirty_loop);
+}
+
+bool source_impl::fill_stream_buffer(ALuint buffer)
+{
+	std::size_t read = _decoder->read_pcm(_stream_scratch.data(), _stream_scratch.size());
+	if(read == 0 && _stream_looping)
+	{
+		_decoder->seek_start();
+		read = _decoder->read_pcm(_stream_scratch.data(), _stream_scratch.size());
+	}
+	if(read == 0)
+	{
+		return false;
+	}
+
+	const ALenum format =
+		sound_impl::native_format(_stream_info.channels, _stream_info.bytes_per_sample);
+	al_check(alBufferData(buffer, format, _stream_scratch.data(), ALsizei(read),
+						  ALsizei(_stream_info.sample_rate)));
+	return true;
+}
+
+void source_impl::update_stream()
+{
+	if(!_decoder)
+		return;
+
+	ALint processed = 0;
+	al_check(alGetSourcei(_handle, AL_BUFFERS_PROCESSED, &processed));
+
+	bool fed = false;
+	while(processed-- > 0)
+	{
+		ALuint buffer = 0;
+		al_check(alSourceUnqueueBuffers(_handle, 1, &buffer));
+		if(fill_stream_buffer(buffer))
+		{
+			al_check(alSourceQueueBuffers(_handle, 1, &buffer));
+			fed = true;
+		}
+	}
+
+	// a starved source stops on its own - resume it if data was queued
+	// and nobody asked it to stop
+	if(fed && _stream_intent_playing && !is_playing() && !is_paused())
+	{
+		al_check(alSourcePlay(_handle));
+	}
+}
+
 bool source_impl::has_binded_sound() const
 {
+	if(_decoder)
+		return true;
+
 	ALint buffer = 0;
 	al_check(alGetSourcei(_handle, AL_BUFFER, &buffer));
 	return buffer != 0;
@@ -80,6 +369,8 @@ void source_impl::unbind()
 {
 	stop();
 
+	unbind_stream();
+
 	al_check(alSourcei(_handle, AL_BUFFER, 0));
 
 	unbind_sound();
@@ -99,6 +390,14 @@ void source_impl::purge()
 
 void source_impl::set_playing_offset(float seconds)
 {
+	if(_decoder)
+	{
+		// openal offsets are relative to the queued ring, not the whole
+		// stream - seeking a streaming source is not supported
+		log_info("Seeking is not supported on streaming sounds.");
+		return;
+	}
+
 	al_check(alSourcef(_handle, AL_SEC_OFFSET, seconds));
 }
 
@@ -111,6 +410,11 @@ float source_impl::get_playing_offset() const
 
 float source_impl::get_playing_duration() const
 {
+	if(_decoder)
+	{
+		return float(_stream_info.duration.count());
+	}
+
 	ALint buffer = 0;
 	al_check(alGetSourcei(_handle, AL_BUFFER, &buffer));
 
@@ -133,16 +437,25 @@ float source_impl::get_playing_duration() const
 
 void source_impl::play() const
 {
+	// never start with stale latched state - the gain or position set
+	// just before play must be audible from the first mixed sample
+	flush_state();
+
+	_stream_intent_playing = true;
 	al_check(alSourcePlay(_handle));
 }
 
 void source_impl::stop() const
 {
+	_stream_intent_playing = false;
 	al_check(alSourceStop(_handle));
 }
 
 void source_impl::pause() const
 {
+	flush_state();
+
+	_stream_intent_playing = false;
 	al_check(alSourcePause(_handle));
 }
 
@@ -169,6 +482,9 @@ bool source_impl::is_stopped() const
 
 bool source_impl::is_binded() const
 {
+	if(_decoder)
+		return true;
+
 	ALint buffer = 0;
 	al_check(alGetSourcei(_handle, AL_BUFFER, &buffer));
 	return (buffer != 0);
@@ -176,52 +492,193 @@ bool source_impl::is_binded() const
 
 void source_impl::set_loop(bool on)
 {
-	al_check(alSourcei(_handle, AL_LOOPING, on ? AL_TRUE : AL_FALSE));
+	_stream_looping = on;
+
+	bool changed = false;
+	{
+		std::lock_guard<std::mutex> lock(_state_mutex);
+		changed = _state.loop != on;
+		_state.loop = on;
+	}
+	if(changed)
+	{
+		mark_dirty(deferred_state::dirty_loop);
+	}
 }
 
 void source_impl::set_volume(float volume)
 {
-	al_check(alSourcef(_handle, AL_GAIN, volume));
+	bool changed = false;
+	{
+		std::lock_guard<std::mutex> lock(_state_mutex);
+		changed = _state.volume != volume;
+		_state.volume = volume;
+	}
+	if(changed)
+	{
+		mark_dirty(deferred_state::dirty_volume);
+	}
 }
 
 /* pitch, speed stretching */
 void source_impl::set_pitch(float pitch)
 {
 	// if pitch == 0.f pitch = 0.0001f;
-	al_check(alSourcef(_handle, AL_PITCH, pitch));
+	bool changed = false;
+	{
+		std::lock_guard<std::mutex> lock(_state_mutex);
+		changed = _state.pitch != pitch;
+		_state.pitch = pitch;
+	}
+	if(changed)
+	{
+		mark_dirty(deferred_state::dirty_pitch);
+	}
 }
 
 void source_impl::set_position(const float3& position)
 {
-	al_check(alSourcefv(_handle, AL_POSITION, position.data()));
+	bool changed = false;
+	{
+		std::lock_guard<std::mutex> lock(_state_mutex);
+		changed = _state.position != position;
+		_state.position = position;
+	}
+	if(changed)
+	{
+		mark_dirty(deferred_state::dirty_position);
+	}
 }
 
 void source_impl::set_velocity(const float3& velocity)
 {
-	al_check(alSourcefv(_handle, AL_VELOCITY, velocity.data()));
+	bool changed = false;
+	{
+		std::lock_guard<std::mutex> lock(_state_mutex);
+		changed = _state.velocity != velocity;
+		_state.velocity = velocity;
+	}
+	if(changed)
+	{
+		mark_dirty(deferred_state::dirty_velocity);
+	}
 }
 
 void source_impl::set_orientation(const float3& direction, const float3& up)
 {
-	float orientation6[] = {-direction[0], -direction[1], -direction[2], up[0], up[1], up[2]};
-	al_check(alSourcefv(_handle, AL_ORIENTATION, orientation6));
+	const float orientation6[] = {-direction[0], -direction[1], -direction[2], up[0], up[1], up[2]};
+
+	bool changed = false;
+	{
+		std::lock_guard<std::mutex> lock(_state_mutex);
+		changed = !std::equal(std::begin(orientation6), std::end(orientation6),
+							  std::begin(_state.orientation));
+		std::copy(std::begin(orientation6), std::end(orientation6), std::begin(_state.orientation));
+	}
+	if(changed)
+	{
+		mark_dirty(deferred_state::dirty_orientation);
+	}
 }
 
 void source_impl::set_volume_rolloff(float rolloff)
 {
-	al_check(alSourcef(_handle, AL_ROLLOFF_FACTOR, rolloff));
+	bool changed = false;
+	{
+		std::lock_guard<std::mutex> lock(_state_mutex);
+		changed = _state.rolloff != rolloff;
+		_state.rolloff = rolloff;
+	}
+	if(changed)
+	{
+		mark_dirty(deferred_state::dirty_rolloff);
+	}
 }
 
 void source_impl::set_distance(float mind, float maxd)
 {
+	bool changed = false;
+	{
+		std::lock_guard<std::mutex> lock(_state_mutex);
+		changed = _state.distance_min != mind || _state.distance_max != maxd;
+		_state.distance_min = mind;
+		_state.distance_max = maxd;
+	}
+	if(changed)
+	{
+		mark_dirty(deferred_state::dirty_distance);
+	}
+}
 
-	// The distance that the source will be the loudest (if the listener is
-	// closer, it won't be any louder than if they were at this distance)
-	al_check(alSourcef(_handle, AL_REFERENCE_DISTANCE, mind));
+void source_impl::mark_dirty(std::uint32_t bit)
+{
+	bool enlist = false;
+	{
+		std::lock_guard<std::mutex> lock(_state_mutex);
+		enlist = _state.dirty == 0;
+		_state.dirty |= bit;
+	}
+	// taken after the state lock is released - the flush locks in the
+	// opposite order
+	if(enlist)
+	{
+		get_state_batcher().add(this);
+	}
+}
+
+void source_impl::flush_state() const
+{
+	std::lock_guard<std::mutex> lock(_state_mutex);
+	if(_state.dirty == 0 || _handle == 0)
+	{
+		_state.dirty = 0;
+		return;
+	}
 
-	// The distance that the source will be the quietest (if the listener is
-	// farther, it won't be any quieter than if they were at this distance)
-	al_check(alSourcef(_handle, AL_MAX_DISTANCE, maxd));
+	if((_state.dirty & deferred_state::dirty_loop) != 0)
+	{
+		// a streaming ring loops by rewinding the decoder instead
+		if(!_decoder)
+		{
+			al_check(alSourcei(_handle, AL_LOOPING, _state.loop ? AL_TRUE : AL_FALSE));
+		}
+	}
+	if((_state.dirty & deferred_state::dirty_volume) != 0)
+	{
+		al_check(alSourcef(_handle, AL_GAIN, _state.volume));
+	}
+	if((_state.dirty & deferred_state::dirty_pitch) != 0)
+	{
+		al_check(alSourcef(_handle, AL_PITCH, _state.pitch));
+	}
+	if((_state.dirty & deferred_state::dirty_position) != 0)
+	{
+		al_check(alSourcefv(_handle, AL_POSITION, _state.position.data()));
+	}
+	if((_state.dirty & deferred_state::dirty_velocity) != 0)
+	{
+		al_check(alSourcefv(_handle, AL_VELOCITY, _state.velocity.data()));
+	}
+	if((_state.dirty & deferred_state::dirty_orientation) != 0)
+	{
+		al_check(alSourcefv(_handle, AL_ORIENTATION, _state.orientation));
+	}
+	if((_state.dirty & deferred_state::dirty_rolloff) != 0)
+	{
+		al_check(alSourcef(_handle, AL_ROLLOFF_FACTOR, _state.rolloff));
+	}
+	if((_state.dirty & deferred_state::dirty_distance) != 0)
+	{
+		// The distance that the source will be the loudest (if the listener is
+		// closer, it won't be any louder than if they were at this distance)
+		al_check(alSourcef(_handle, AL_REFERENCE_DISTANCE, _state.distance_min));
+
+		// The distance that the source will be the quietest (if the listener is
+		// farther, it won't be any quieter than if they were at this distance)
+		al_check(alSourcef(_handle, AL_MAX_DISTANCE, _state.distance_max));
+	}
+
+	_state.dirty = 0;
 }
 
 bool source_impl::is_valid() const
@@ -231,6 +688,18 @@ bool source_impl::is_valid() const
 
 bool source_impl::is_looping() const
 {
+	if(_decoder)
+		return _stream_looping;
+
+	{
+		// a latched change not yet flushed is the authoritative answer
+		std::lock_guard<std::mutex> lock(_state_mutex);
+		if((_state.dirty & deferred_state::dirty_loop) != 0)
+		{
+			return _state.loop;
+		}
+	}
+
 	ALint loop;
 	al_check(alGetSourcei(_handle, AL_LOOPING, &loop));
 	return loop != 0;
@@ -1,8 +1,12 @@
 #pragma once
 
+#include "../loaders/loader.h"
 #include "../types.h"
 #include <AL/al.h>
+#include <atomic>
 #include <cstdint>
+#include <limits>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -55,16 +59,117 @@ public:
 
 	native_handle_type native_handle() const;
 
+	//-----------------------------------------------------------------------------
+	//  Name : update_stream ()
+	/// <summary>
+	/// Refills processed ring buffers from the decoder. Called by the
+	/// shared stream feeder thread while the source is registered.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void update_stream();
+
+	//-----------------------------------------------------------------------------
+	//  Name : flush_state ()
+	/// <summary>
+	/// Pushes every property latched since the last flush to openal in
+	/// one run - one al call per property that actually changed. Called
+	/// by the device's deferred submit once per frame, and by the
+	/// playback controls so a voice never starts with stale state.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void flush_state() const;
+
 private:
 	void bind_sound(sound_impl* sound);
 	void unbind_sound();
 
+	bool bind_stream(sound_impl* sound);
+	void unbind_stream();
+	bool fill_stream_buffer(ALuint buffer);
+
+	//-----------------------------------------------------------------------------
+	//  Name : deferred_state (Struct) (Private)
+	/// <summary>
+	/// Latched property block. Setters write values and dirty bits here
+	/// instead of issuing an al call (plus error check) per touch; the
+	/// per-frame flush submits only the properties that changed since the
+	/// last one. The defaults mirror openal's own, so a never-touched
+	/// property is never submitted at all.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	struct deferred_state
+	{
+		enum dirty_bit : std::uint32_t
+		{
+			dirty_loop = 1u << 0,
+			dirty_volume = 1u << 1,
+			dirty_pitch = 1u << 2,
+			dirty_position = 1u << 3,
+			dirty_velocity = 1u << 4,
+			dirty_orientation = 1u << 5,
+			dirty_rolloff = 1u << 6,
+			dirty_distance = 1u << 7,
+		};
+
+		std::uint32_t dirty = 0;
+		bool loop = false;
+		float volume = 1.0f;
+		float pitch = 1.0f;
+		float3 position{{0.0f, 0.0f, 0.0f}};
+		float3 velocity{{0.0f, 0.0f, 0.0f}};
+		float orientation[6] = {0.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f};
+		float rolloff = 1.0f;
+		float distance_min = 1.0f;
+		float distance_max = std::numeric_limits<float>::max();
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : mark_dirty () (Private)
+	/// <summary>
+	/// Records the dirty bit and registers the source with the deferred
+	/// submit list. Call without the state lock held.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void mark_dirty(std::uint32_t bit);
+
 	native_handle_type _handle = 0;
 
+	/// guards the latched block - setters can come from the game thread
+	/// while the per-frame flush drains it
+	mutable std::mutex _state_mutex;
+	/// latched property values; doubles as the last-submitted cache, so a
+	/// setter repeating the current value costs no al traffic at all
+	mutable deferred_state _state;
+
+	/// Streaming state - the encoded bytes shared with the sound, a
+	/// per-source decoder and the ring of queued openal buffers. The
+	/// decoder and ring belong to the feeder thread between register
+	/// and unregister; binding and unbinding bracket that window.
+	std::shared_ptr<const std::vector<std::uint8_t>> _stream_data;
+	std::unique_ptr<stream_decoder> _decoder;
+	std::vector<ALuint> _stream_ring;
+	std::vector<std::uint8_t> _stream_scratch;
+	sound_info _stream_info;
+	std::atomic<bool> _stream_looping{false};
+
+	/// whether play was requested - the feeder restarts a source that
+	/// openal stopped because the ring briefly ran dry
+	mutable std::atomic<bool> _stream_intent_playing{false};
+
     /// openal doesn't let us destroy sounds that are
     /// binded, so we have to keep this bookkeeping
 	std::mutex _mutex;
 	sound_impl* _bound_sound = nullptr;
 };
+
+//-----------------------------------------------------------------------------
+//  Name : flush_deferred_source_state ()
+/// <summary>
+/// Flushes every source with latched property changes. The device calls
+/// this from its per-frame deferred submit, bracketed by the context
+/// suspend/process batch entry points.
+/// </summary>
+//-----------------------------------------------------------------------------
+void flush_deferred_source_state();
 }
 }
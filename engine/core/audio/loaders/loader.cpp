@@ -0,0 +1,29 @@
+#include "loader.h"
+#include <cstring>
+
+namespace audio
+{
+
+std::unique_ptr<stream_decoder> open_stream_from_memory(const std::uint8_t* data, std::size_t data_size,
+														std::string& err)
+{
+	if(!data || data_size < 4)
+	{
+		err = "ERROR : No data to load from.";
+		return nullptr;
+	}
+
+	if(std::memcmp(data, "OggS", 4) == 0)
+	{
+		return open_ogg_stream_from_memory(data, data_size, err);
+	}
+
+	if(std::memcmp(data, "RIFF", 4) == 0)
+	{
+		return open_wav_stream_from_memory(data, data_size, err);
+	}
+
+	err = "ERROR : Unsupported sound container.";
+	return nullptr;
+}
+}
@@ -1,4 +1,8 @@
+#pragma once
+
 #include "../sound_data.h"
+#include <functional>
+#include <memory>
 
 namespace audio
 {
@@ -7,4 +11,73 @@ bool load_ogg_from_memory(const std::uint8_t* data, std::size_t data_size, sound
 						  std::string& err);
 bool load_wav_from_memory(const std::uint8_t* data, std::size_t data_size, sound_data& result,
 						  std::string& err);
+
+/// Fills the destination with up to the requested byte count from the
+/// encoded input and returns how many bytes it produced - 0 at the end.
+using pull_source_t = std::function<std::size_t(std::uint8_t*, std::size_t)>;
+
+//-----------------------------------------------------------------------------
+//  Name : load_wav_from_stream ()
+/// <summary>
+/// Incremental flavour of load_wav_from_memory - the encoded bytes come
+/// from 'pull' instead of one contiguous buffer, so only the header span
+/// is staged and the pcm lands straight in the result. Peak memory stays
+/// at output-plus-chunk instead of holding the whole file beside it.
+/// </summary>
+//-----------------------------------------------------------------------------
+bool load_wav_from_stream(const pull_source_t& pull, sound_data& result, std::string& err);
+
+//-----------------------------------------------------------------------------
+//  Name : stream_decoder (Class)
+/// <summary>
+/// Incremental decoder over in-memory encoded sound data. The streaming
+/// playback path pulls pcm out of it chunk by chunk instead of decoding
+/// the whole file up front. The caller owns the encoded bytes and must
+/// keep them alive for the decoder's lifetime.
+/// </summary>
+//-----------------------------------------------------------------------------
+class stream_decoder
+{
+public:
+	virtual ~stream_decoder() = default;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_info (virtual )
+	/// <summary>
+	/// Info about the decoded stream.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	virtual const sound_info& get_info() const = 0;
+
+	//-----------------------------------------------------------------------------
+	//  Name : read_pcm (virtual )
+	/// <summary>
+	/// Decodes up to max_bytes of pcm into dst. Returns the number of
+	/// bytes written - 0 at the end of the stream.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	virtual std::size_t read_pcm(std::uint8_t* dst, std::size_t max_bytes) = 0;
+
+	//-----------------------------------------------------------------------------
+	//  Name : seek_start (virtual )
+	/// <summary>
+	/// Rewinds the decoder to the first sample.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	virtual void seek_start() = 0;
+};
+
+std::unique_ptr<stream_decoder> open_ogg_stream_from_memory(const std::uint8_t* data,
+															std::size_t data_size, std::string& err);
+std::unique_ptr<stream_decoder> open_wav_stream_from_memory(const std::uint8_t* data,
+															std::size_t data_size, std::string& err);
+
+//-----------------------------------------------------------------------------
+//  Name : open_stream_from_memory ()
+/// <summary>
+/// Sniffs the container magic and opens the matching stream decoder.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::unique_ptr<stream_decoder> open_stream_from_memory(const std::uint8_t* data, std::size_t data_size,
+														std::string& err);
 }
@@ -49,4 +49,73 @@ bool load_ogg_from_memory(const std::uint8_t* data, std::size_t data_size, sound
 	stb_vorbis_close(oss);
 	return true;
 }
+
+namespace
+{
+class ogg_stream_decoder : public stream_decoder
+{
+public:
+	ogg_stream_decoder(stb_vorbis* handle, const sound_info& info)
+		: _handle(handle)
+		, _info(info)
+	{
+	}
+
+	~ogg_stream_decoder() override
+	{
+		stb_vorbis_close(_handle);
+	}
+
+	const sound_info& get_info() const override
+	{
+		return _info;
+	}
+
+	std::size_t read_pcm(std::uint8_t* dst, std::size_t max_bytes) override
+	{
+		const int max_shorts = int(max_bytes / sizeof(std::int16_t));
+		const int samples_per_channel = stb_vorbis_get_samples_short_interleaved(
+			_handle, int(_info.channels), reinterpret_cast<std::int16_t*>(dst), max_shorts);
+		return std::size_t(samples_per_channel) * _info.channels * sizeof(std::int16_t);
+	}
+
+	void seek_start() override
+	{
+		stb_vorbis_seek_start(_handle);
+	}
+
+private:
+	stb_vorbis* _handle = nullptr;
+	sound_info _info;
+};
+}
+
+std::unique_ptr<stream_decoder> open_ogg_stream_from_memory(const std::uint8_t* data,
+															std::size_t data_size, std::string& err)
+{
+	if(!data || !data_size)
+	{
+		err = "ERROR : No data to load from.";
+		return nullptr;
+	}
+
+	int vorb_err = 0;
+	auto* oss = stb_vorbis_open_memory(data, static_cast<int>(data_size), &vorb_err, nullptr);
+
+	if(!oss)
+	{
+		STBVorbisError decoded_err = STBVorbisError(vorb_err);
+		err = "ERROR : Vorbis error code : " + std::to_string(decoded_err);
+		return nullptr;
+	}
+
+	stb_vorbis_info info = stb_vorbis_get_info(oss);
+	sound_info snd_info;
+	snd_info.channels = std::uint32_t(info.channels);
+	snd_info.sample_rate = info.sample_rate;
+	snd_info.bytes_per_sample = sizeof(std::int16_t);
+	snd_info.duration = sound_info::duration_t(stb_vorbis_stream_length_in_seconds(oss));
+
+	return std::make_unique<ogg_stream_decoder>(oss, snd_info);
+}
 }
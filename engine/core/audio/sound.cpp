@@ -7,9 +7,17 @@ namespace audio
 sound::~sound() = default;
 
 sound::sound(sound_data&& data)
-	: _impl(std::make_unique<priv::sound_impl>(std::move(data.data), data.info))
-	, _info(std::move(data.info))
+	: _info(data.info)
 {
+	if(!data.encoded_data.empty())
+	{
+		_impl = std::make_unique<priv::sound_impl>(
+			std::make_shared<const std::vector<std::uint8_t>>(std::move(data.encoded_data)), data.info);
+	}
+	else
+	{
+		_impl = std::make_unique<priv::sound_impl>(std::move(data.data), data.info);
+	}
 }
 
 sound::sound(sound&& rhs)
@@ -40,4 +48,9 @@ const sound_info& sound::get_info() const
 {
 	return _info;
 }
+
+bool sound::is_stream() const
+{
+	return _impl && _impl->is_stream();
+}
 }
@@ -47,6 +47,15 @@ public:
 	//-----------------------------------------------------------------------------
 	const sound_info& get_info() const;
 
+	//-----------------------------------------------------------------------------
+	//  Name : is_stream ()
+	/// <summary>
+	/// Checks whether the sound streams - decoded chunk by chunk at
+	/// playback instead of held resident as pcm.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool is_stream() const;
+
 private:
 	friend class source;
 
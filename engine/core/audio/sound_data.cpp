@@ -30,4 +30,21 @@ void sound_data::convert_to_stereo()
 		log_error("Does not support mono conversion of buffers with more than 2 channels");
 	}
 }
+
+void sound_data::resample(std::uint32_t sample_rate)
+{
+	if(info.sample_rate == sample_rate || info.sample_rate == 0 || sample_rate == 0)
+	{
+		return;
+	}
+
+	if(!encoded_data.empty())
+	{
+		log_error("Does not support resampling of streaming sounds");
+		return;
+	}
+
+	data = utils::resample(data, info.bytes_per_sample, info.channels, info.sample_rate, sample_rate);
+	info.sample_rate = sample_rate;
+}
 }
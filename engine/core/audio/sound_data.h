@@ -28,10 +28,23 @@ struct sound_data
 	//-----------------------------------------------------------------------------
 	void convert_to_stereo();
 
+	//-----------------------------------------------------------------------------
+	//  Name : resample ()
+	/// <summary>
+	/// Resamples internal data to the given sample rate.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void resample(std::uint32_t sample_rate);
+
 	/// info about the sound
 	sound_info info;
 
 	/// data buffer of pcm sound stored in uint8_t buffer
 	std::vector<std::uint8_t> data;
+
+	/// encoded source bytes for streaming sounds - when non-empty the
+	/// pcm buffer stays empty and decoding happens incrementally at
+	/// playback through the streaming loaders
+	std::vector<std::uint8_t> encoded_data;
 };
 }
@@ -1,9 +1,19 @@
 #include "utils.h"
 #include "logger.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUDIO_UTILS_SSE2 1
+#include <emmintrin.h>
+#endif
+
 namespace audio
 {
 namespace utils
 {
+
 std::vector<std::uint8_t> convert_to_mono(const std::vector<std::uint8_t>& input,
 										  std::uint8_t bytes_per_sample)
 {
@@ -13,11 +23,11 @@ std::vector<std::uint8_t> convert_to_mono(const std::vector<std::uint8_t>& input
 		return input;
 	}
 
-	std::vector<std::uint8_t> output;
-	output.reserve(input.size() / 2);
-
 	if(bytes_per_sample == 1)
 	{
+		std::vector<std::uint8_t> output;
+		output.reserve(input.size() / 2);
+
 		for(std::size_t i = 0, sz = input.size(); i < sz; i += 2 * bytes_per_sample)
 		{
 			const std::uint8_t left = input[i];
@@ -26,20 +36,31 @@ std::vector<std::uint8_t> convert_to_mono(const std::vector<std::uint8_t>& input
 
 			output.push_back(mono_sample);
 		}
+		return output;
 	}
-	else if(bytes_per_sample == 2)
+
+	const std::size_t pairs = input.size() / 4;
+	std::vector<std::uint8_t> output(pairs * 2);
+	const auto* src = reinterpret_cast<const std::int16_t*>(input.data());
+	auto* dst = reinterpret_cast<std::int16_t*>(output.data());
+
+	std::size_t i = 0;
+#if defined(AUDIO_UTILS_SSE2)
+	// madd with unit weights sums each left/right pair into an int32 -
+	// four stereo pairs collapse to four mono samples per iteration
+	const __m128i ones = _mm_set1_epi16(1);
+	for(; i + 4 <= pairs; i += 4)
 	{
-		for(std::size_t i = 0, sz = input.size(); i < sz; i += 2 * bytes_per_sample)
-		{
-			const std::int16_t left = *reinterpret_cast<const std::int16_t*>(&input[i]);
-			const std::int16_t right = *reinterpret_cast<const std::int16_t*>(&input[i + bytes_per_sample]);
-			const std::int16_t mono_sample = std::int16_t((int(left) + right) / 2);
-
-			const std::uint8_t sample_part1 = std::uint8_t(mono_sample >> 0);
-			const std::uint8_t sample_part2 = std::uint8_t(mono_sample >> 8);
-			output.push_back(sample_part1);
-			output.push_back(sample_part2);
-		}
+		const __m128i interleaved = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+		const __m128i sums = _mm_madd_epi16(interleaved, ones);
+		const __m128i halves = _mm_srai_epi32(sums, 1);
+		const __m128i packed = _mm_packs_epi32(halves, halves);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), packed);
+	}
+#endif
+	for(; i < pairs; ++i)
+	{
+		dst[i] = std::int16_t((int(src[i * 2]) + src[i * 2 + 1]) >> 1);
 	}
 	return output;
 }
@@ -56,6 +77,33 @@ std::vector<std::uint8_t> convert_to_stereo(const std::vector<std::uint8_t>& inp
 	std::vector<std::uint8_t> output;
 	output.resize(input.size() * 2, 0);
 
+	if(bytes_per_sample == 2)
+	{
+		const std::size_t samples = input.size() / 2;
+		const auto* src = reinterpret_cast<const std::int16_t*>(input.data());
+		auto* dst = reinterpret_cast<std::int16_t*>(output.data());
+
+		std::size_t i = 0;
+#if defined(AUDIO_UTILS_SSE2)
+		// unpacking a register with itself duplicates every sample into
+		// a left/right pair
+		for(; i + 8 <= samples; i += 8)
+		{
+			const __m128i mono = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			const __m128i lo = _mm_unpacklo_epi16(mono, mono);
+			const __m128i hi = _mm_unpackhi_epi16(mono, mono);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), lo);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2 + 8), hi);
+		}
+#endif
+		for(; i < samples; ++i)
+		{
+			dst[i * 2 + 0] = src[i];
+			dst[i * 2 + 1] = src[i];
+		}
+		return output;
+	}
+
 	for(std::size_t i = 0, sz = input.size(); i < sz; i += bytes_per_sample)
 	{
 		for(std::uint8_t bps = 0; bps < bytes_per_sample; ++bps)
@@ -70,5 +118,197 @@ std::vector<std::uint8_t> convert_to_stereo(const std::vector<std::uint8_t>& inp
 
 	return output;
 }
+
+void convert_int16_to_float(const std::int16_t* input, float* output, std::size_t count)
+{
+	std::size_t i = 0;
+#if defined(AUDIO_UTILS_SSE2)
+	const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+	const __m128i zero = _mm_setzero_si128();
+	for(; i + 8 <= count; i += 8)
+	{
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+		// unpack into the high halves and shift back down to sign extend
+		const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(zero, v), 16);
+		const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(zero, v), 16);
+		_mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+		_mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+	}
+#endif
+	for(; i < count; ++i)
+	{
+		output[i] = float(input[i]) * (1.0f / 32768.0f);
+	}
+}
+
+void convert_float_to_int16(const float* input, std::int16_t* output, std::size_t count)
+{
+	std::size_t i = 0;
+#if defined(AUDIO_UTILS_SSE2)
+	const __m128 scale = _mm_set1_ps(32767.0f);
+	for(; i + 8 <= count; i += 8)
+	{
+		const __m128i lo = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(input + i), scale));
+		const __m128i hi = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(input + i + 4), scale));
+		// packing saturates, so out of range floats clamp for free
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(lo, hi));
+	}
+#endif
+	for(; i < count; ++i)
+	{
+		const float v = std::max(-32768.0f, std::min(32767.0f, input[i] * 32767.0f));
+		output[i] = std::int16_t(v);
+	}
+}
+
+namespace
+{
+/// filter length per output sample and fractional positions resolved
+const std::size_t resample_taps = 16;
+const std::size_t resample_phases = 32;
+
+float sinc(float x)
+{
+	const float pi = 3.14159265358979f;
+	if(std::abs(x) < 1e-6f)
+	{
+		return 1.0f;
+	}
+	return std::sin(pi * x) / (pi * x);
+}
+
+/// Windowed-sinc taps, one row per fractional phase. Each row is
+/// normalized to unity dc gain so the output level does not ripple with
+/// the phase the sample happens to land on.
+std::vector<float> build_polyphase_taps(float cutoff)
+{
+	const float pi = 3.14159265358979f;
+	const float half = float(resample_taps) / 2.0f;
+
+	std::vector<float> taps(resample_phases * resample_taps);
+	for(std::size_t p = 0; p < resample_phases; ++p)
+	{
+		float sum = 0.0f;
+		for(std::size_t t = 0; t < resample_taps; ++t)
+		{
+			const float x = float(t) - (half - 1.0f) - float(p) / float(resample_phases);
+			float window = 0.0f;
+			if(std::abs(x) <= half)
+			{
+				window = 0.5f + 0.5f * std::cos(pi * x / half);
+			}
+			const float tap = cutoff * sinc(cutoff * x) * window;
+			taps[p * resample_taps + t] = tap;
+			sum += tap;
+		}
+
+		if(sum != 0.0f)
+		{
+			for(std::size_t t = 0; t < resample_taps; ++t)
+			{
+				taps[p * resample_taps + t] /= sum;
+			}
+		}
+	}
+	return taps;
+}
+
+float dot(const float* x, const float* h, std::size_t count)
+{
+#if defined(AUDIO_UTILS_SSE2)
+	__m128 acc = _mm_setzero_ps();
+	for(std::size_t i = 0; i + 4 <= count; i += 4)
+	{
+		acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(h + i)));
+	}
+	__m128 sums = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+	sums = _mm_add_ss(sums, _mm_shuffle_ps(sums, sums, 1));
+	return _mm_cvtss_f32(sums);
+#else
+	float sum = 0.0f;
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		sum += x[i] * h[i];
+	}
+	return sum;
+#endif
+}
+}
+
+std::vector<std::uint8_t> resample(const std::vector<std::uint8_t>& input, std::uint8_t bytes_per_sample,
+								   std::uint32_t channels, std::uint32_t input_rate,
+								   std::uint32_t output_rate)
+{
+	if(bytes_per_sample != 2)
+	{
+		log_error("Sound buffer is not 16 bits per sample. Unsupported");
+		return input;
+	}
+	if(channels == 0 || input_rate == 0 || output_rate == 0 || input_rate == output_rate)
+	{
+		return input;
+	}
+
+	const auto* src = reinterpret_cast<const std::int16_t*>(input.data());
+	const std::size_t frames = input.size() / (std::size_t(channels) * bytes_per_sample);
+	const std::size_t output_frames =
+		std::size_t(double(frames) * double(output_rate) / double(input_rate));
+
+	const float cutoff = std::min(1.0f, float(output_rate) / float(input_rate));
+	const auto taps = build_polyphase_taps(cutoff);
+
+	std::vector<std::uint8_t> output(output_frames * channels * bytes_per_sample);
+	auto* dst = reinterpret_cast<std::int16_t*>(output.data());
+
+	// each channel filters in its own zero padded float lane, so the
+	// inner dot product never branches at the buffer edges
+	const std::size_t pad = resample_taps;
+	std::vector<float> lane(frames + pad * 2, 0.0f);
+	std::vector<float> out_lane(output_frames);
+
+	const double step = double(input_rate) / double(output_rate);
+	for(std::uint32_t c = 0; c < channels; ++c)
+	{
+		if(channels == 1)
+		{
+			convert_int16_to_float(src, &lane[pad], frames);
+		}
+		else
+		{
+			for(std::size_t f = 0; f < frames; ++f)
+			{
+				lane[pad + f] = float(src[f * channels + c]) * (1.0f / 32768.0f);
+			}
+		}
+
+		for(std::size_t n = 0; n < output_frames; ++n)
+		{
+			const double pos = double(n) * step;
+			const std::size_t base = std::size_t(pos);
+			const float frac = float(pos - double(base));
+			const std::size_t phase =
+				std::min<std::size_t>(resample_phases - 1, std::size_t(frac * resample_phases));
+
+			const float* h = &taps[phase * resample_taps];
+			const float* x = &lane[pad + base - (resample_taps / 2 - 1)];
+			out_lane[n] = dot(x, h, resample_taps);
+		}
+
+		if(channels == 1)
+		{
+			convert_float_to_int16(out_lane.data(), dst, output_frames);
+		}
+		else
+		{
+			for(std::size_t n = 0; n < output_frames; ++n)
+			{
+				const float v = std::max(-32768.0f, std::min(32767.0f, out_lane[n] * 32767.0f));
+				dst[n * channels + c] = std::int16_t(v);
+			}
+		}
+	}
+
+	return output;
+}
 }
 }
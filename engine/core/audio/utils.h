@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -26,5 +27,37 @@ std::vector<std::uint8_t> convert_to_mono(const std::vector<std::uint8_t>& input
 //-----------------------------------------------------------------------------
 std::vector<std::uint8_t> convert_to_stereo(const std::vector<std::uint8_t>& input,
 											std::uint8_t bytes_per_sample);
+
+//-----------------------------------------------------------------------------
+//  Name : convert_int16_to_float ()
+/// <summary>
+/// Batch converts signed 16 bit samples to normalized floats in [-1, 1].
+/// Vectorized where the hardware allows - convert whole buffers through
+/// it instead of looping per sample.
+/// </summary>
+//-----------------------------------------------------------------------------
+void convert_int16_to_float(const std::int16_t* input, float* output, std::size_t count);
+
+//-----------------------------------------------------------------------------
+//  Name : convert_float_to_int16 ()
+/// <summary>
+/// Batch converts normalized float samples back to signed 16 bit with
+/// saturation. Vectorized counterpart of convert_int16_to_float.
+/// </summary>
+//-----------------------------------------------------------------------------
+void convert_float_to_int16(const float* input, std::int16_t* output, std::size_t count);
+
+//-----------------------------------------------------------------------------
+//  Name : resample ()
+/// <summary>
+/// Resamples an interleaved 16 bit pcm buffer to another sample rate
+/// through a polyphase windowed-sinc filter with vectorized inner dot
+/// products. The cutoff tracks the lower of the two nyquist rates, so
+/// downsampling does not alias.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::vector<std::uint8_t> resample(const std::vector<std::uint8_t>& input, std::uint8_t bytes_per_sample,
+								   std::uint32_t channels, std::uint32_t input_rate,
+								   std::uint32_t output_rate);
 }
 }
@@ -57,13 +57,103 @@ inline void set_thread_name(std::thread& thread, const char* threadName)
 	DWORD threadId = ::GetThreadId(reinterpret_cast<HANDLE>(thread.native_handle()));
 	set_thread_name(threadId, threadName);
 }
+
+//-----------------------------------------------------------------------------
+//  Name : set_thread_affinity ()
+/// <summary>
+/// Pins the thread to a single logical core. Best effort - returns false
+/// when the OS refuses.
+/// </summary>
+//-----------------------------------------------------------------------------
+inline bool set_thread_affinity(std::thread& thread, std::size_t core_index)
+{
+	const DWORD_PTR mask = DWORD_PTR(1) << (core_index % (sizeof(DWORD_PTR) * 8));
+	return ::SetThreadAffinityMask(reinterpret_cast<HANDLE>(thread.native_handle()), mask) != 0;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : set_thread_priority ()
+/// <summary>
+/// Adjusts the thread's scheduling priority relative to normal: negative
+/// levels demote it to background work, positive levels elevate it. Best
+/// effort - returns false when the OS refuses.
+/// </summary>
+//-----------------------------------------------------------------------------
+inline bool set_thread_priority(std::thread& thread, int level)
+{
+	int priority = THREAD_PRIORITY_NORMAL;
+	if(level <= -2)
+		priority = THREAD_PRIORITY_LOWEST;
+	else if(level == -1)
+		priority = THREAD_PRIORITY_BELOW_NORMAL;
+	else if(level == 1)
+		priority = THREAD_PRIORITY_ABOVE_NORMAL;
+	else if(level >= 2)
+		priority = THREAD_PRIORITY_HIGHEST;
+
+	return ::SetThreadPriority(reinterpret_cast<HANDLE>(thread.native_handle()), priority) != 0;
+}
 }
 #else
+#include <pthread.h>
+#if $on($linux)
+#include <sched.h>
+#endif
+
 namespace platform
 {
 inline void set_thread_name(std::thread& thread, const char* threadName)
 {
 	pthread_setname_np(thread.native_handle(), threadName);
 }
+
+//-----------------------------------------------------------------------------
+//  Name : set_thread_affinity ()
+/// <summary>
+/// Pins the thread to a single logical core. Best effort - returns false
+/// when the OS refuses or has no per-thread affinity.
+/// </summary>
+//-----------------------------------------------------------------------------
+inline bool set_thread_affinity(std::thread& thread, std::size_t core_index)
+{
+#if $on($linux)
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+	CPU_SET(core_index % CPU_SETSIZE, &cpuset);
+	return pthread_setaffinity_np(thread.native_handle(), sizeof(cpuset), &cpuset) == 0;
+#else
+	(void)thread;
+	(void)core_index;
+	return false;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//  Name : set_thread_priority ()
+/// <summary>
+/// Adjusts the thread's scheduling priority relative to normal: negative
+/// levels demote it to background scheduling (no privileges needed on
+/// Linux), positive levels request a real-time class, which typically
+/// needs CAP_SYS_NICE. Best effort - returns false when the OS refuses.
+/// </summary>
+//-----------------------------------------------------------------------------
+inline bool set_thread_priority(std::thread& thread, int level)
+{
+	sched_param param{};
+	int policy = SCHED_OTHER;
+	if(level > 0)
+	{
+		policy = SCHED_RR;
+		param.sched_priority = sched_get_priority_min(SCHED_RR);
+	}
+#if $on($linux)
+	else if(level < 0)
+	{
+		policy = SCHED_BATCH;
+	}
+#endif
+
+	return pthread_setschedparam(thread.native_handle(), policy, &param) == 0;
+}
 }
 #endif
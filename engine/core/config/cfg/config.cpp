@@ -1,6 +1,7 @@
 #include "config.h"
 
 #include <cctype>
+#include <cstdint>
 #include <fstream>
 #include <regex>
 #include <sstream>
@@ -161,6 +162,142 @@ void config::save(const std::string& file)
 	}
 }
 
+std::uint64_t hash_text(const std::string& text)
+{
+	// FNV-1a, used to tie the compiled sidecar to the exact source text
+	std::uint64_t hash = 14695981039346656037ull;
+	for(unsigned char c : text)
+	{
+		hash ^= c;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+const std::uint32_t binary_magic = 0x47464342; // 'BCFG'
+const std::uint32_t binary_version = 1;
+
+bool read_u32(std::istream& in, std::uint32_t& value)
+{
+	in.read(reinterpret_cast<char*>(&value), sizeof(value));
+	return !in.fail();
+}
+
+bool read_u64(std::istream& in, std::uint64_t& value)
+{
+	in.read(reinterpret_cast<char*>(&value), sizeof(value));
+	return !in.fail();
+}
+
+bool read_string(std::istream& in, std::string& value)
+{
+	std::uint32_t length = 0;
+	if(!read_u32(in, length))
+	{
+		return false;
+	}
+	value.resize(length);
+	if(length > 0)
+	{
+		in.read(&value[0], length);
+	}
+	return !in.fail();
+}
+
+void write_u32(std::ostream& out, std::uint32_t value)
+{
+	out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void write_u64(std::ostream& out, std::uint64_t value)
+{
+	out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void write_string(std::ostream& out, const std::string& value)
+{
+	write_u32(out, static_cast<std::uint32_t>(value.size()));
+	out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+bool config::load_binary(const std::string& file, unsigned long long source_hash)
+{
+	std::ifstream in(file, std::fstream::in | std::fstream::binary);
+	if(!in.is_open())
+	{
+		return false;
+	}
+
+	std::uint32_t magic = 0;
+	std::uint32_t version = 0;
+	std::uint64_t hash = 0;
+	std::uint32_t section_count = 0;
+	if(!read_u32(in, magic) || magic != binary_magic || !read_u32(in, version) ||
+	   version != binary_version || !read_u64(in, hash) || hash != source_hash ||
+	   !read_u32(in, section_count))
+	{
+		return false;
+	}
+
+	// fully decode before touching this config, so a truncated or corrupt
+	// sidecar leaves it untouched
+	std::map<std::string, Section> loaded;
+	for(std::uint32_t s = 0; s < section_count; ++s)
+	{
+		std::string section;
+		std::uint32_t value_count = 0;
+		if(!read_string(in, section) || !read_u32(in, value_count))
+		{
+			return false;
+		}
+		auto& section_values = loaded[section];
+		for(std::uint32_t v = 0; v < value_count; ++v)
+		{
+			std::string name;
+			std::string value;
+			if(!read_string(in, name) || !read_string(in, value))
+			{
+				return false;
+			}
+			section_values[name] = value;
+		}
+	}
+
+	for(auto& section : loaded)
+	{
+		for(auto& value : section.second)
+		{
+			values[section.first][value.first] = value.second;
+		}
+	}
+	return true;
+}
+
+void config::save_binary(const std::string& file, unsigned long long source_hash) const
+{
+	std::ofstream out(file, std::fstream::out | std::fstream::trunc | std::fstream::binary);
+	if(!out.is_open())
+	{
+		// best effort; the next load simply text-parses again
+		return;
+	}
+
+	write_u32(out, binary_magic);
+	write_u32(out, binary_version);
+	write_u64(out, source_hash);
+	write_u32(out, static_cast<std::uint32_t>(values.size()));
+	for(const auto& section : values)
+	{
+		write_string(out, section.first);
+		write_u32(out, static_cast<std::uint32_t>(section.second.size()));
+		for(const auto& value : section.second)
+		{
+			write_string(out, value.first);
+			write_string(out, value.second);
+		}
+	}
+}
+
 void config::load(const std::string& file)
 {
 	std::ifstream in(file);
@@ -170,7 +307,35 @@ void config::load(const std::string& file)
 		throw std::runtime_error("Failed to open " + file + " for reading.");
 	}
 
-	parser parser(*this);
-	parser.parse(in, file);
+	// slurp the source once; the text both feeds the parser and keys the
+	// compiled sidecar written next to it
+	std::stringstream buffer;
+	buffer << in.rdbuf();
+	const std::string source = buffer.str();
+	const std::uint64_t source_hash = hash_text(source);
+	const std::string binary_file = file + ".bin";
+
+	if(load_binary(binary_file, source_hash))
+	{
+		return;
+	}
+
+	// parse into a scratch config so the sidecar only ever contains this
+	// file's values, even when several files are loaded into one config
+	config parsed;
+	{
+		std::istringstream stream(source);
+		parser parser(parsed);
+		parser.parse(stream, file);
+	}
+	parsed.save_binary(binary_file, source_hash);
+
+	for(const auto& section : parsed.values)
+	{
+		for(const auto& value : section.second)
+		{
+			values[section.first][value.first] = value.second;
+		}
+	}
 }
 }
@@ -51,6 +51,19 @@ public:
 	void load(const std::string& file);
 
 private:
+	/**
+	 * Load the compiled binary sidecar of a config file, if it exists and
+	 * its stored source hash matches. Returns false when the sidecar is
+	 * missing, stale or malformed; the caller then text-parses instead.
+	 **/
+	bool load_binary(const std::string& file, unsigned long long source_hash);
+
+	/**
+	 * Write the compiled binary sidecar for this config. Best effort; a
+	 * failed write only means the next load text-parses again.
+	 **/
+	void save_binary(const std::string& file, unsigned long long source_hash) const;
+
 	typedef std::map<std::string, std::string> Section;
 	std::map<std::string, Section> values;
 };
@@ -0,0 +1,893 @@
+#include "async_read.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <limits>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define FS_HAS_IO_URING 1
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#endif
+
+namespace fs
+{
+namespace
+{
+
+struct read_request
+{
+	/// File to read.
+	path file;
+	/// Fulfilled with the file contents, or an empty array on failure.
+	std::shared_ptr<std::promise<byte_array_t>> promise;
+	/// First byte of the range, clamped to the file end.
+	std::uint64_t offset = 0;
+	/// Range length; zero means the rest of the file from 'offset'.
+	std::uint64_t length = 0;
+	/// Donated buffer whose capacity the backend reuses for the result.
+	byte_array_t storage;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : read_range_blocking () (Local)
+/// <summary>
+/// Plain blocking fulfilment of a request, shared by the fallback pool
+/// and by backends degrading after a runtime failure.
+/// </summary>
+//-----------------------------------------------------------------------------
+byte_array_t read_range_blocking(read_request& request)
+{
+	byte_array_t buffer = std::move(request.storage);
+	buffer.clear();
+
+	std::ifstream stream{request.file.string(), std::ios::in | std::ios::binary};
+	stream.seekg(0, std::ios::end);
+	const std::streamoff end = stream.tellg();
+	if(!stream.good() || end < 0)
+	{
+		return buffer;
+	}
+
+	const std::uint64_t file_size = static_cast<std::uint64_t>(end);
+	const std::uint64_t start = std::min(request.offset, file_size);
+	const std::uint64_t want =
+		request.length != 0 ? std::min(request.length, file_size - start) : file_size - start;
+	buffer.resize(static_cast<std::size_t>(want));
+	if(want == 0)
+	{
+		return buffer;
+	}
+
+	stream.seekg(static_cast<std::streamoff>(start), std::ios::beg);
+	stream.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(want));
+	buffer.resize(stream.gcount() > 0 ? static_cast<std::size_t>(stream.gcount()) : 0);
+	return buffer;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : read_backend (Class) (Local)
+/// <summary>
+/// One platform flavour of the asynchronous reader. The facade picks the
+/// richest backend the runtime supports and funnels every read through
+/// it; backends own their threads and drain outstanding work before
+/// destruction so no promise is abandoned at shutdown.
+/// </summary>
+//-----------------------------------------------------------------------------
+class read_backend
+{
+public:
+	virtual ~read_backend() = default;
+
+	virtual void submit(read_request request) = 0;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : blocking_read_backend (Class) (Local)
+/// <summary>
+/// Fallback backend - a small pool of dedicated reader threads doing
+/// ordinary blocking reads. Disk latency still blocks a thread here, but
+/// it is a thread owned by this pool, never a task system worker.
+/// </summary>
+//-----------------------------------------------------------------------------
+class blocking_read_backend : public read_backend
+{
+public:
+	blocking_read_backend()
+	{
+		// Two threads let a long streaming read overlap a small urgent one
+		// without growing into a pool that competes with the task system.
+		for(std::size_t i = 0; i < 2; ++i)
+		{
+			_threads.emplace_back([this]() { run(); });
+		}
+	}
+
+	~blocking_read_backend() override
+	{
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_done = true;
+		}
+		_cv.notify_all();
+		for(auto& thread : _threads)
+		{
+			thread.join();
+		}
+	}
+
+	void submit(read_request request) override
+	{
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_queue.emplace_back(std::move(request));
+		}
+		_cv.notify_one();
+	}
+
+private:
+	void run()
+	{
+		while(true)
+		{
+			read_request request;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_cv.wait(lock, [this]() { return _done || !_queue.empty(); });
+
+				// Drain what is already queued even when shutting down.
+				if(_queue.empty())
+				{
+					return;
+				}
+
+				request = std::move(_queue.front());
+				_queue.pop_front();
+			}
+
+			request.promise->set_value(read_range_blocking(request));
+		}
+	}
+
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::deque<read_request> _queue;
+	bool _done = false;
+	std::vector<std::thread> _threads;
+};
+
+#if defined(_WIN32)
+
+//-----------------------------------------------------------------------------
+//  Name : overlapped_read_backend (Class) (Local)
+/// <summary>
+/// Windows backend - files open with FILE_FLAG_OVERLAPPED and attach to
+/// one completion port; a single completion thread issues the reads and
+/// harvests their completions, so any number of transfers overlap in the
+/// kernel while exactly one thread sleeps on the port.
+/// </summary>
+//-----------------------------------------------------------------------------
+class overlapped_read_backend : public read_backend
+{
+public:
+	static std::unique_ptr<read_backend> create()
+	{
+		HANDLE port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+		if(port == nullptr)
+		{
+			return nullptr;
+		}
+
+		return std::unique_ptr<read_backend>(new overlapped_read_backend(port));
+	}
+
+	~overlapped_read_backend() override
+	{
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_done = true;
+		}
+		PostQueuedCompletionStatus(_port, 0, wake_key, nullptr);
+		_thread.join();
+		CloseHandle(_port);
+	}
+
+	void submit(read_request request) override
+	{
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_queue.emplace_back(std::move(request));
+		}
+		PostQueuedCompletionStatus(_port, 0, wake_key, nullptr);
+	}
+
+private:
+	/// Completion key reserved for queue wakeups; transfers carry their
+	/// inflight record as the key instead.
+	static const ULONG_PTR wake_key = 0;
+
+	struct inflight
+	{
+		/// Must stay the first member - the completion thread maps the
+		/// dequeued OVERLAPPED pointer back to its record.
+		OVERLAPPED overlapped;
+		HANDLE file = INVALID_HANDLE_VALUE;
+		byte_array_t buffer;
+		/// Absolute file offset where the requested range starts.
+		std::uint64_t base = 0;
+		/// Bytes transferred so far; added to 'base' for the next read.
+		std::uint64_t transferred = 0;
+		std::shared_ptr<std::promise<byte_array_t>> promise;
+	};
+
+	explicit overlapped_read_backend(HANDLE port)
+		: _port(port)
+		, _thread([this]() { run(); })
+	{
+	}
+
+	void start(read_request request)
+	{
+		auto record = std::unique_ptr<inflight>(new inflight());
+		record->promise = std::move(request.promise);
+		record->file = CreateFileW(request.file.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+								   OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+		if(record->file == INVALID_HANDLE_VALUE)
+		{
+			record->promise->set_value({});
+			return;
+		}
+
+		LARGE_INTEGER size;
+		if(GetFileSizeEx(record->file, &size) == FALSE || size.QuadPart < 0)
+		{
+			fail(std::move(record));
+			return;
+		}
+
+		const std::uint64_t file_size = static_cast<std::uint64_t>(size.QuadPart);
+		record->base = std::min(request.offset, file_size);
+		const std::uint64_t want = request.length != 0
+									   ? std::min(request.length, file_size - record->base)
+									   : file_size - record->base;
+		if(want == 0)
+		{
+			complete(std::move(record));
+			return;
+		}
+
+		record->buffer = std::move(request.storage);
+		record->buffer.resize(static_cast<std::size_t>(want));
+
+		if(CreateIoCompletionPort(record->file, _port, reinterpret_cast<ULONG_PTR>(record.get()), 0) ==
+		   nullptr)
+		{
+			fail(std::move(record));
+			return;
+		}
+
+		issue(std::move(record));
+	}
+
+	void issue(std::unique_ptr<inflight> record)
+	{
+		const std::uint64_t remaining = record->buffer.size() - record->transferred;
+		const DWORD chunk =
+			static_cast<DWORD>(std::min<std::uint64_t>(remaining, std::numeric_limits<DWORD>::max()));
+
+		const std::uint64_t position = record->base + record->transferred;
+		std::memset(&record->overlapped, 0, sizeof(record->overlapped));
+		record->overlapped.Offset = static_cast<DWORD>(position & 0xffffffffull);
+		record->overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+		inflight* raw = record.get();
+		if(ReadFile(raw->file, raw->buffer.data() + raw->transferred, chunk, nullptr, &raw->overlapped) ==
+			   FALSE &&
+		   GetLastError() != ERROR_IO_PENDING)
+		{
+			fail(std::move(record));
+			return;
+		}
+
+		// The completion thread reclaims ownership through the key.
+		record.release();
+		++_inflight_count;
+	}
+
+	void complete(std::unique_ptr<inflight> record)
+	{
+		CloseHandle(record->file);
+		record->promise->set_value(std::move(record->buffer));
+	}
+
+	void fail(std::unique_ptr<inflight> record)
+	{
+		CloseHandle(record->file);
+		record->promise->set_value({});
+	}
+
+	void run()
+	{
+		while(true)
+		{
+			DWORD bytes = 0;
+			ULONG_PTR key = wake_key;
+			OVERLAPPED* overlapped = nullptr;
+			const BOOL result = GetQueuedCompletionStatus(_port, &bytes, &key, &overlapped, INFINITE);
+
+			if(key != wake_key)
+			{
+				--_inflight_count;
+				std::unique_ptr<inflight> record(reinterpret_cast<inflight*>(key));
+
+				if(result == FALSE)
+				{
+					fail(std::move(record));
+				}
+				else
+				{
+					record->transferred += bytes;
+					if(record->transferred >= record->buffer.size() || bytes == 0)
+					{
+						record->buffer.resize(static_cast<std::size_t>(record->transferred));
+						complete(std::move(record));
+					}
+					else
+					{
+						issue(std::move(record));
+					}
+				}
+			}
+
+			bool shutting_down = false;
+			std::deque<read_request> pending;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				pending.swap(_queue);
+				shutting_down = _done;
+			}
+
+			for(auto& request : pending)
+			{
+				start(std::move(request));
+			}
+
+			if(shutting_down && _inflight_count == 0)
+			{
+				return;
+			}
+		}
+	}
+
+	HANDLE _port;
+	std::mutex _mutex;
+	std::deque<read_request> _queue;
+	bool _done = false;
+	/// Touched only by the completion thread.
+	std::size_t _inflight_count = 0;
+	std::thread _thread;
+};
+
+#elif defined(FS_HAS_IO_URING)
+
+int io_uring_setup_call(unsigned entries, io_uring_params* params)
+{
+	return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter_call(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+	return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr,
+									std::size_t(0)));
+}
+
+//-----------------------------------------------------------------------------
+//  Name : uring_read_backend (Class) (Local)
+/// <summary>
+/// Linux backend over a raw io_uring (no liburing dependency). One
+/// thread owns the ring: it queues readv submissions for every pending
+/// request and sleeps in io_uring_enter until completions arrive, so all
+/// outstanding transfers overlap inside the kernel. An eventfd poll op
+/// sits permanently in the ring to wake the thread when callers submit.
+/// Construction fails cleanly on kernels without io_uring and the facade
+/// falls back to the blocking pool.
+/// </summary>
+//-----------------------------------------------------------------------------
+class uring_read_backend : public read_backend
+{
+public:
+	static std::unique_ptr<read_backend> create()
+	{
+		auto backend = std::unique_ptr<uring_read_backend>(new uring_read_backend());
+		if(!backend->init())
+		{
+			return nullptr;
+		}
+
+		backend->_thread = std::thread([raw = backend.get()]() { raw->run(); });
+		return std::unique_ptr<read_backend>(backend.release());
+	}
+
+	~uring_read_backend() override
+	{
+		if(_thread.joinable())
+		{
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_done = true;
+			}
+			wake();
+			_cv_fallback.notify_all();
+			_thread.join();
+		}
+
+		if(_sq_ring != MAP_FAILED)
+		{
+			munmap(_sq_ring, _sq_ring_size);
+		}
+		if(_cq_ring != MAP_FAILED)
+		{
+			munmap(_cq_ring, _cq_ring_size);
+		}
+		if(_sqes != MAP_FAILED)
+		{
+			munmap(_sqes, _sqes_size);
+		}
+		if(_ring_fd >= 0)
+		{
+			close(_ring_fd);
+		}
+		if(_event_fd >= 0)
+		{
+			close(_event_fd);
+		}
+	}
+
+	void submit(read_request request) override
+	{
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_queue.emplace_back(std::move(request));
+		}
+		wake();
+		_cv_fallback.notify_one();
+	}
+
+private:
+	/// user_data of the permanent eventfd wakeup poll; transfers use the
+	/// non-zero keys of their inflight records.
+	static const std::uint64_t wake_data = 0;
+	static const unsigned ring_entries = 64;
+	/// Leave submission headroom for remainder reads and the wakeup poll.
+	static const std::size_t max_inflight = ring_entries - 16;
+
+	struct inflight
+	{
+		int fd = -1;
+		byte_array_t buffer;
+		/// Absolute file offset where the requested range starts.
+		std::uint64_t base = 0;
+		/// Bytes transferred so far; added to 'base' for the next read.
+		std::uint64_t transferred = 0;
+		/// Lives here so its address stays valid while the op is queued.
+		iovec vec{};
+		std::shared_ptr<std::promise<byte_array_t>> promise;
+	};
+
+	uring_read_backend() = default;
+
+	bool init()
+	{
+		_event_fd = eventfd(0, EFD_CLOEXEC);
+		if(_event_fd < 0)
+		{
+			return false;
+		}
+
+		io_uring_params params;
+		std::memset(&params, 0, sizeof(params));
+		_ring_fd = io_uring_setup_call(ring_entries, &params);
+		if(_ring_fd < 0)
+		{
+			return false;
+		}
+
+		_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+		_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+		_sq_ring = mmap(nullptr, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+						_ring_fd, IORING_OFF_SQ_RING);
+		_cq_ring = mmap(nullptr, _cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+						_ring_fd, IORING_OFF_CQ_RING);
+		_sqes = mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd,
+					 IORING_OFF_SQES);
+		if(_sq_ring == MAP_FAILED || _cq_ring == MAP_FAILED || _sqes == MAP_FAILED)
+		{
+			return false;
+		}
+
+		auto sq_base = static_cast<std::uint8_t*>(_sq_ring);
+		_sq_tail = reinterpret_cast<unsigned*>(sq_base + params.sq_off.tail);
+		_sq_mask = reinterpret_cast<unsigned*>(sq_base + params.sq_off.ring_mask);
+		_sq_array = reinterpret_cast<unsigned*>(sq_base + params.sq_off.array);
+
+		auto cq_base = static_cast<std::uint8_t*>(_cq_ring);
+		_cq_head = reinterpret_cast<unsigned*>(cq_base + params.cq_off.head);
+		_cq_tail = reinterpret_cast<unsigned*>(cq_base + params.cq_off.tail);
+		_cq_mask = reinterpret_cast<unsigned*>(cq_base + params.cq_off.ring_mask);
+		_cqes = reinterpret_cast<io_uring_cqe*>(cq_base + params.cq_off.cqes);
+
+		return true;
+	}
+
+	void wake()
+	{
+		const std::uint64_t one = 1;
+		ssize_t written = 0;
+		do
+		{
+			written = write(_event_fd, &one, sizeof(one));
+		} while(written < 0 && errno == EINTR);
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : push_sqe () (Private)
+	/// <summary>
+	/// Appends a zeroed submission entry to the ring and publishes the new
+	/// tail. The inflight cap keeps the single-threaded submitter from
+	/// ever outrunning the ring, so no full check is needed.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	io_uring_sqe* push_sqe()
+	{
+		const unsigned tail = *_sq_tail;
+		const unsigned index = tail & *_sq_mask;
+		io_uring_sqe* sqe = static_cast<io_uring_sqe*>(_sqes) + index;
+		std::memset(sqe, 0, sizeof(*sqe));
+		_sq_array[index] = index;
+
+		std::atomic_thread_fence(std::memory_order_release);
+		*_sq_tail = tail + 1;
+		++_to_submit;
+		return sqe;
+	}
+
+	void push_wake_poll()
+	{
+		io_uring_sqe* sqe = push_sqe();
+		sqe->opcode = IORING_OP_POLL_ADD;
+		sqe->fd = _event_fd;
+		sqe->poll_events = POLLIN;
+		sqe->user_data = wake_data;
+	}
+
+	void push_read(std::uint64_t key, inflight& record)
+	{
+		record.vec.iov_base = record.buffer.data() + record.transferred;
+		record.vec.iov_len = static_cast<std::size_t>(record.buffer.size() - record.transferred);
+
+		io_uring_sqe* sqe = push_sqe();
+		sqe->opcode = IORING_OP_READV;
+		sqe->fd = record.fd;
+		sqe->addr = reinterpret_cast<std::uintptr_t>(&record.vec);
+		sqe->len = 1;
+		sqe->off = record.base + record.transferred;
+		sqe->user_data = key;
+	}
+
+	void start(read_request request)
+	{
+		inflight record;
+		record.promise = std::move(request.promise);
+		record.fd = open(request.file.string().c_str(), O_RDONLY | O_CLOEXEC);
+		if(record.fd < 0)
+		{
+			record.promise->set_value({});
+			return;
+		}
+
+		struct stat info;
+		if(fstat(record.fd, &info) != 0 || info.st_size < 0)
+		{
+			close(record.fd);
+			record.promise->set_value({});
+			return;
+		}
+
+		const std::uint64_t file_size = static_cast<std::uint64_t>(info.st_size);
+		record.base = std::min(request.offset, file_size);
+		const std::uint64_t want = request.length != 0
+									   ? std::min(request.length, file_size - record.base)
+									   : file_size - record.base;
+		if(want == 0)
+		{
+			close(record.fd);
+			record.promise->set_value({});
+			return;
+		}
+
+		record.buffer = std::move(request.storage);
+		record.buffer.resize(static_cast<std::size_t>(want));
+
+		const std::uint64_t key = _next_key++;
+		auto& slot = _inflight[key];
+		slot = std::move(record);
+		push_read(key, slot);
+	}
+
+	void finish(std::uint64_t key, inflight& record, bool success)
+	{
+		close(record.fd);
+		if(success)
+		{
+			record.buffer.resize(static_cast<std::size_t>(record.transferred));
+			record.promise->set_value(std::move(record.buffer));
+		}
+		else
+		{
+			record.promise->set_value({});
+		}
+		_inflight.erase(key);
+	}
+
+	void process_completion(const io_uring_cqe& cqe)
+	{
+		if(cqe.user_data == wake_data)
+		{
+			std::uint64_t value = 0;
+			ssize_t unused = read(_event_fd, &value, sizeof(value));
+			(void)unused;
+			_wake_armed = false;
+			return;
+		}
+
+		auto it = _inflight.find(cqe.user_data);
+		if(it == _inflight.end())
+		{
+			return;
+		}
+
+		inflight& record = it->second;
+		if(cqe.res == -EINTR || cqe.res == -EAGAIN)
+		{
+			push_read(it->first, record);
+			return;
+		}
+
+		if(cqe.res < 0)
+		{
+			finish(it->first, record, false);
+			return;
+		}
+
+		record.transferred += static_cast<std::uint64_t>(cqe.res);
+		if(cqe.res == 0 || record.transferred >= record.buffer.size())
+		{
+			finish(it->first, record, true);
+		}
+		else
+		{
+			push_read(it->first, record);
+		}
+	}
+
+	void run()
+	{
+		while(true)
+		{
+			bool shutting_down = false;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				shutting_down = _done;
+				while(!_queue.empty() && _inflight.size() < max_inflight)
+				{
+					read_request request = std::move(_queue.front());
+					_queue.pop_front();
+					lock.unlock();
+					start(std::move(request));
+					lock.lock();
+				}
+			}
+
+			if(shutting_down && _inflight.empty())
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				if(_queue.empty())
+				{
+					return;
+				}
+				continue;
+			}
+
+			if(!_wake_armed)
+			{
+				push_wake_poll();
+				_wake_armed = true;
+			}
+
+			const int entered =
+				io_uring_enter_call(_ring_fd, _to_submit, 1, IORING_ENTER_GETEVENTS);
+			if(entered >= 0)
+			{
+				_to_submit -= static_cast<unsigned>(entered);
+			}
+			else if(errno != EINTR)
+			{
+				// The ring is wedged - drain everything through blocking
+				// reads rather than abandoning the promises.
+				for(auto& entry : _inflight)
+				{
+					finish_blocking(entry.second);
+				}
+				_inflight.clear();
+				drain_blocking();
+				return;
+			}
+
+			unsigned head = *_cq_head;
+			std::atomic_thread_fence(std::memory_order_acquire);
+			const unsigned tail = *_cq_tail;
+			while(head != tail)
+			{
+				process_completion(_cqes[head & *_cq_mask]);
+				++head;
+			}
+			std::atomic_thread_fence(std::memory_order_release);
+			*_cq_head = head;
+		}
+	}
+
+	void finish_blocking(inflight& record)
+	{
+		byte_array_t rest(record.buffer.size() - static_cast<std::size_t>(record.transferred));
+		std::size_t offset = 0;
+		while(offset < rest.size())
+		{
+			const ssize_t got = pread(record.fd, rest.data() + offset, rest.size() - offset,
+									  static_cast<off_t>(record.base + record.transferred + offset));
+			if(got <= 0)
+			{
+				break;
+			}
+			offset += static_cast<std::size_t>(got);
+		}
+
+		std::memcpy(record.buffer.data() + record.transferred, rest.data(), offset);
+		record.transferred += offset;
+		record.buffer.resize(static_cast<std::size_t>(record.transferred));
+		close(record.fd);
+		record.promise->set_value(std::move(record.buffer));
+	}
+
+	void drain_blocking()
+	{
+		while(true)
+		{
+			read_request request;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				if(_queue.empty())
+				{
+					if(_done)
+					{
+						return;
+					}
+					_cv_fallback.wait(lock, [this]() { return _done || !_queue.empty(); });
+					continue;
+				}
+				request = std::move(_queue.front());
+				_queue.pop_front();
+			}
+
+			request.promise->set_value(read_range_blocking(request));
+		}
+	}
+
+	int _ring_fd = -1;
+	int _event_fd = -1;
+	void* _sq_ring = MAP_FAILED;
+	void* _cq_ring = MAP_FAILED;
+	void* _sqes = MAP_FAILED;
+	std::size_t _sq_ring_size = 0;
+	std::size_t _cq_ring_size = 0;
+	std::size_t _sqes_size = 0;
+
+	unsigned* _sq_tail = nullptr;
+	unsigned* _sq_mask = nullptr;
+	unsigned* _sq_array = nullptr;
+	unsigned* _cq_head = nullptr;
+	unsigned* _cq_tail = nullptr;
+	unsigned* _cq_mask = nullptr;
+	io_uring_cqe* _cqes = nullptr;
+
+	/// Submission entries appended since the last io_uring_enter.
+	unsigned _to_submit = 0;
+	/// True while the eventfd poll op sits in the ring.
+	bool _wake_armed = false;
+	std::uint64_t _next_key = 1;
+	/// Touched only by the ring thread.
+	std::unordered_map<std::uint64_t, inflight> _inflight;
+
+	std::mutex _mutex;
+	/// Only used when the ring wedges and the thread degrades to
+	/// blocking reads.
+	std::condition_variable _cv_fallback;
+	std::deque<read_request> _queue;
+	bool _done = false;
+	std::thread _thread;
+};
+
+#endif
+
+//-----------------------------------------------------------------------------
+//  Name : get_backend () (Local)
+/// <summary>
+/// Picks the richest backend the runtime supports on first use. The
+/// instance lives until static destruction, where it drains outstanding
+/// reads before joining its threads.
+/// </summary>
+//-----------------------------------------------------------------------------
+read_backend& get_backend()
+{
+	static std::unique_ptr<read_backend> backend = []() {
+		std::unique_ptr<read_backend> result;
+#if defined(_WIN32)
+		result = overlapped_read_backend::create();
+#elif defined(FS_HAS_IO_URING)
+		result = uring_read_backend::create();
+#endif
+		if(!result)
+		{
+			result.reset(new blocking_read_backend());
+		}
+		return result;
+	}();
+
+	return *backend;
+}
+}
+
+core::task_future<byte_array_t> read_async(const path& _path)
+{
+	return read_async(_path, 0, 0, byte_array_t());
+}
+
+core::task_future<byte_array_t> read_async(const path& _path, std::uint64_t offset, std::uint64_t length,
+										   byte_array_t&& recycled)
+{
+	read_request request;
+	request.file = _path;
+	request.promise = std::make_shared<std::promise<byte_array_t>>();
+	request.offset = offset;
+	request.length = length;
+	request.storage = std::move(recycled);
+
+	auto future = core::task_future<byte_array_t>::from_future(request.promise->get_future());
+
+	get_backend().submit(std::move(request));
+
+	return future;
+}
+}
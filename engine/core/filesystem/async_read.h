@@ -0,0 +1,34 @@
+#pragma once
+
+#include "../tasks/task_system.h"
+#include "filesystem.h"
+
+namespace fs
+{
+//-----------------------------------------------------------------------------
+//  Name : read_async ()
+/// <summary>
+/// Reads the whole file into a byte_array_t without occupying a task
+/// system worker while the kernel does the transfer. The read is handed
+/// to the platform's asynchronous IO facility - io_uring on Linux,
+/// overlapped IO on Windows - with a small dedicated reader thread pool
+/// as the fallback when neither is available at runtime. The returned
+/// future becomes ready when the transfer completes; a missing or
+/// unreadable file yields an empty array, mirroring what read_stream
+/// returns for a bad stream.
+/// </summary>
+//-----------------------------------------------------------------------------
+core::task_future<byte_array_t> read_async(const path& _path);
+
+//-----------------------------------------------------------------------------
+//  Name : read_async ()
+/// <summary>
+/// Ranged flavour - reads 'length' bytes starting at 'offset' (clamped
+/// to the file end; zero length means everything from the offset on).
+/// 'recycled' donates a previously used buffer so steady-state chunked
+/// readers stop allocating; pass an empty array when there is none.
+/// </summary>
+//-----------------------------------------------------------------------------
+core::task_future<byte_array_t> read_async(const path& _path, std::uint64_t offset, std::uint64_t length,
+										   byte_array_t&& recycled);
+}
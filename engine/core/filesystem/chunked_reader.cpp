@@ -0,0 +1,91 @@
+#include "chunked_reader.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace fs
+{
+chunked_reader::chunked_reader(const path& _path, std::size_t chunk_size, std::size_t read_ahead)
+	: _path(_path)
+	, _chunk_size(std::max<std::size_t>(chunk_size, 1))
+	, _read_ahead(std::max<std::size_t>(read_ahead, 1))
+{
+	error_code err;
+	const auto reported = file_size(_path, err);
+	if(!err)
+	{
+		_file_size = static_cast<std::uint64_t>(reported);
+	}
+
+	prime();
+}
+
+chunked_reader::~chunked_reader()
+{
+	// Outstanding reads still target our recycled buffers - wait them out
+	// rather than abandoning the transfers mid-flight.
+	for(auto& pending : _pending)
+	{
+		pending.wait();
+	}
+}
+
+std::uint64_t chunked_reader::size() const
+{
+	return _file_size;
+}
+
+byte_array_t chunked_reader::next()
+{
+	if(_pending.empty())
+	{
+		return {};
+	}
+
+	auto chunk = _pending.front().get();
+	_pending.pop_front();
+
+	if(chunk.empty())
+	{
+		// A failed chunk leaves a hole in the stream - stop issuing and
+		// drain what is already in flight so the caller sees a clean end.
+		_read_offset = _file_size;
+		for(auto& pending : _pending)
+		{
+			pending.wait();
+		}
+		_pending.clear();
+		return {};
+	}
+
+	prime();
+	return chunk;
+}
+
+void chunked_reader::recycle(byte_array_t&& buffer)
+{
+	if(_pool.size() < _read_ahead + 2)
+	{
+		_pool.emplace_back(std::move(buffer));
+	}
+}
+
+void chunked_reader::prime()
+{
+	while(_pending.size() < _read_ahead && _read_offset < _file_size)
+	{
+		const std::uint64_t want =
+			std::min<std::uint64_t>(_chunk_size, _file_size - _read_offset);
+
+		byte_array_t storage;
+		if(!_pool.empty())
+		{
+			storage = std::move(_pool.back());
+			_pool.pop_back();
+		}
+
+		_pending.emplace_back(read_async(_path, _read_offset, want, std::move(storage)));
+		_read_offset += want;
+	}
+}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "async_read.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace fs
+{
+//-----------------------------------------------------------------------------
+//  Name : chunked_reader (Class)
+/// <summary>
+/// Reads a file as a sequence of fixed-size chunks with a configurable
+/// number of them in flight ahead of the consumer, so decoding one chunk
+/// overlaps the IO for the next. Buffers handed back through recycle()
+/// feed later requests from a small pool, which keeps peak memory per
+/// load near chunk-size instead of file-size and stops steady-state
+/// allocation. Not thread safe - one consumer drives one reader.
+/// </summary>
+//-----------------------------------------------------------------------------
+class chunked_reader
+{
+public:
+	//-----------------------------------------------------------------------------
+	//  Name : chunked_reader ()
+	/// <summary>
+	/// Starts reading immediately, keeping up to 'read_ahead' chunks of
+	/// 'chunk_size' bytes in flight. A missing file reports size() == 0.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	chunked_reader(const path& _path, std::size_t chunk_size = 256 * 1024, std::size_t read_ahead = 2);
+
+	~chunked_reader();
+
+	//-----------------------------------------------------------------------------
+	//  Name : size ()
+	/// <summary>
+	/// Total size of the file in bytes, captured when the reader opened.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::uint64_t size() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : next ()
+	/// <summary>
+	/// Returns the next chunk in file order, waiting only if its IO has
+	/// not finished yet, and tops the pipeline back up before returning.
+	/// An empty array means end of file or a failed read - either way no
+	/// further data will come.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	byte_array_t next();
+
+	//-----------------------------------------------------------------------------
+	//  Name : recycle ()
+	/// <summary>
+	/// Returns a consumed chunk's buffer so an upcoming request can reuse
+	/// its capacity instead of allocating.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void recycle(byte_array_t&& buffer);
+
+private:
+	//-----------------------------------------------------------------------------
+	//  Name : prime () (Private)
+	/// <summary>
+	/// Issues ranged reads until 'read_ahead' chunks are in flight or the
+	/// file is exhausted.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void prime();
+
+	/// File being read.
+	path _path;
+	/// Bytes per chunk.
+	std::size_t _chunk_size = 0;
+	/// Maximum chunks in flight.
+	std::size_t _read_ahead = 0;
+	/// Total file size captured at construction.
+	std::uint64_t _file_size = 0;
+	/// Offset the next issued chunk starts at.
+	std::uint64_t _read_offset = 0;
+	/// Outstanding chunk reads in file order.
+	std::deque<core::task_future<byte_array_t>> _pending;
+	/// Recycled buffers waiting to back a future chunk.
+	std::vector<byte_array_t> _pool;
+};
+}
@@ -2,12 +2,321 @@
 
 #include "filesystem_watcher.h"
 #include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <type_traits>
 #include <vector>
 
 namespace fs
 {
 
+//-----------------------------------------------------------------------------
+//  Name : directory_snapshot (Class)
+/// <summary>
+/// Persistent path -> size/mtime/type store shared between directory
+/// caches. Directories listed once are served from the snapshot on later
+/// visits - including across runs when the owner loads/saves it - at the
+/// cost of a single stat of the directory itself to prove the stored
+/// listing is still current. Watcher events keep the records fresh while
+/// the process runs, so navigation over a large (or network mounted)
+/// tree stops re-stat-ing every file it has already seen.
+/// </summary>
+//-----------------------------------------------------------------------------
+class directory_snapshot
+{
+public:
+	struct record
+	{
+		file_type type = status_error;
+		std::uintmax_t size = 0;
+		file_time_type modified = 0;
+		/// Directories only - true once their children were enumerated,
+		/// so a directory known only as someone's child never serves an
+		/// empty listing.
+		bool enumerated = false;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : load ()
+	/// <summary>
+	/// Replaces the records with the contents of a previously saved
+	/// snapshot file. A missing or unreadable file leaves the snapshot
+	/// empty - every directory then lists from disk once and repopulates.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void load(const fs::path& file)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_records.clear();
+		_dirty = false;
+
+		std::ifstream stream{file.string(), std::ios::in};
+		std::string line;
+		if(!std::getline(stream, line) || line != "fs-snapshot 1")
+		{
+			return;
+		}
+
+		while(std::getline(stream, line))
+		{
+			std::istringstream fields(line);
+			int enumerated = 0;
+			int type = 0;
+			std::uintmax_t size = 0;
+			long long modified = 0;
+			if(!(fields >> enumerated >> type >> size >> modified))
+			{
+				continue;
+			}
+			fields.get();
+
+			std::string key;
+			std::getline(fields, key);
+			if(key.empty())
+			{
+				continue;
+			}
+
+			record& rec = _records[key];
+			rec.enumerated = enumerated != 0;
+			rec.type = static_cast<file_type>(type);
+			rec.size = size;
+			rec.modified = static_cast<file_time_type>(modified);
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : save ()
+	/// <summary>
+	/// Writes the records out if anything changed since the last save.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void save(const fs::path& file) const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if(!_dirty)
+		{
+			return;
+		}
+
+		std::ofstream stream{file.string(), std::ios::out | std::ios::trunc};
+		if(!stream.good())
+		{
+			return;
+		}
+
+		stream << "fs-snapshot 1\n";
+		for(const auto& entry : _records)
+		{
+			stream << (entry.second.enumerated ? 1 : 0) << ' ' << static_cast<int>(entry.second.type)
+				   << ' ' << entry.second.size << ' '
+				   << static_cast<long long>(entry.second.modified) << ' ' << entry.first << '\n';
+		}
+
+		_dirty = false;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : list ()
+	/// <summary>
+	/// Serves a directory listing from the records without touching its
+	/// children on disk. Returns false - and the caller falls back to a
+	/// real iteration - when the directory was never enumerated or its
+	/// own modification time no longer matches the stored one.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool list(const fs::path& dir, bool recursive, std::vector<directory_entry>& out) const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return list_locked(dir.generic_string(), recursive, out);
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : store ()
+	/// <summary>
+	/// Records the result of a real directory iteration. Sizes and
+	/// modification times are stat-ed here once; later visits are served
+	/// from the records for free.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void store(const fs::path& dir, bool recursive, const std::vector<directory_entry>& entries)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		mark_enumerated(dir.generic_string());
+
+		for(const auto& entry : entries)
+		{
+			fs::error_code err;
+			record& rec = _records[entry.path().generic_string()];
+			rec.type = entry.status(err).type();
+			rec.modified = fs::last_write_time(entry.path(), err);
+			if(rec.type == regular_file)
+			{
+				rec.size = fs::file_size(entry.path(), err);
+			}
+			if(recursive && rec.type == directory_file)
+			{
+				mark_enumerated(entry.path().generic_string());
+			}
+		}
+
+		_dirty = true;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : apply ()
+	/// <summary>
+	/// Folds a batch of watcher events into the records, so changes made
+	/// while the process runs never force a re-enumeration. A renamed
+	/// directory drops its subtree and re-enumerates on the next visit.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void apply(const std::vector<filesystem_watcher::entry>& entries)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		for(const auto& entry : entries)
+		{
+			const auto key = entry.path.generic_string();
+			switch(entry.status)
+			{
+				case filesystem_watcher::created:
+				case filesystem_watcher::modified:
+				{
+					record& rec = _records[key];
+					rec.type = entry.type;
+					rec.size = entry.size;
+					rec.modified = entry.last_mod_time;
+					touch_parent(key);
+					break;
+				}
+				case filesystem_watcher::renamed:
+				{
+					const auto last_key = entry.last_path.generic_string();
+					erase_subtree(last_key);
+					record& rec = _records[key];
+					rec.type = entry.type;
+					rec.size = entry.size;
+					rec.modified = entry.last_mod_time;
+					rec.enumerated = false;
+					touch_parent(last_key);
+					touch_parent(key);
+					break;
+				}
+				case filesystem_watcher::removed:
+				{
+					erase_subtree(key);
+					touch_parent(key);
+					break;
+				}
+				default:
+					continue;
+			}
+
+			_dirty = true;
+		}
+	}
+
+private:
+	bool list_locked(const std::string& dir_key, bool recursive,
+					 std::vector<directory_entry>& out) const
+	{
+		auto it = _records.find(dir_key);
+		if(it == _records.end() || it->second.type != directory_file || !it->second.enumerated)
+		{
+			return false;
+		}
+
+		fs::error_code err;
+		const auto disk_time = fs::last_write_time(dir_key, err);
+		if(err || disk_time != it->second.modified)
+		{
+			return false;
+		}
+
+		const std::string prefix = dir_key + "/";
+		for(auto child = _records.lower_bound(prefix);
+			child != _records.end() && child->first.compare(0, prefix.size(), prefix) == 0; ++child)
+		{
+			// Deeper descendants surface through the recursion below.
+			if(child->first.find('/', prefix.size()) != std::string::npos)
+			{
+				continue;
+			}
+
+			out.emplace_back(fs::path(child->first), file_status(child->second.type));
+			if(recursive && child->second.type == directory_file &&
+			   !list_locked(child->first, true, out))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void mark_enumerated(const std::string& dir_key)
+	{
+		fs::error_code err;
+		record& rec = _records[dir_key];
+		rec.type = directory_file;
+		rec.modified = fs::last_write_time(dir_key, err);
+		rec.enumerated = true;
+	}
+
+	void erase_subtree(const std::string& key)
+	{
+		_records.erase(key);
+
+		const std::string prefix = key + "/";
+		auto it = _records.lower_bound(prefix);
+		while(it != _records.end() && it->first.compare(0, prefix.size(), prefix) == 0)
+		{
+			it = _records.erase(it);
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : touch_parent () (Private)
+	/// <summary>
+	/// Refreshes the stored modification time of an entry's parent so a
+	/// watcher-reported change does not read as a stale listing.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void touch_parent(const std::string& key)
+	{
+		const auto separator = key.find_last_of('/');
+		if(separator == std::string::npos)
+		{
+			return;
+		}
+
+		auto it = _records.find(key.substr(0, separator));
+		if(it == _records.end())
+		{
+			return;
+		}
+
+		fs::error_code err;
+		const auto disk_time = fs::last_write_time(it->first, err);
+		if(!err)
+		{
+			it->second.modified = disk_time;
+		}
+	}
+
+	mutable std::mutex _mutex;
+	/// Generic path string -> record; the sorted keys make a directory's
+	/// children one contiguous range.
+	std::map<std::string, record> _records;
+	mutable bool _dirty = false;
+};
+
 template <typename T>
 class cache
 {
@@ -33,6 +342,7 @@ public:
 		, _scan_frequency(rhs._scan_frequency)
 		, _entries(rhs._entries)
 		, _should_refresh(rhs._should_refresh.load())
+		, _snapshot(rhs._snapshot)
 	{
 		watch();
 	}
@@ -42,6 +352,7 @@ public:
 		, _scan_frequency(std::move(rhs._scan_frequency))
 		, _entries(std::move(rhs._entries))
 		, _should_refresh(rhs._should_refresh.load())
+		, _snapshot(std::move(rhs._snapshot))
 	{
 		watch();
 	}
@@ -53,6 +364,7 @@ public:
 		_scan_frequency = rhs._scan_frequency;
 		_entries = rhs._entries;
 		_should_refresh = rhs._should_refresh.load();
+		_snapshot = rhs._snapshot;
 		watch();
 
 		return *this;
@@ -65,6 +377,7 @@ public:
 		_scan_frequency = std::move(rhs._scan_frequency);
 		_entries = std::move(rhs._entries);
 		_should_refresh = rhs._should_refresh.load();
+		_snapshot = std::move(rhs._snapshot);
 		watch();
 
 		return *this;
@@ -112,20 +425,32 @@ public:
 	//-----------------------------------------------------------------------------
 	void refresh() const
 	{
+		constexpr bool is_recursive = std::is_same<iterator_t, recursive_directory_iterator>::value;
+
 		_entries.clear();
 
-		fs::error_code err;
-		iterator_t it(_path, err);
-		for(const auto& p : it)
+		if(!_snapshot || !_snapshot->list(_path, is_recursive, _entries))
 		{
-			_entries.push_back(p);
+			_entries.clear();
+
+			fs::error_code err;
+			iterator_t it(_path, err);
+			for(const auto& p : it)
+			{
+				_entries.push_back(p);
+			}
+
+			if(_snapshot)
+			{
+				_snapshot->store(_path, is_recursive, _entries);
+			}
 		}
-        
+
         std::sort(std::begin(_entries), std::end(_entries), [](const auto& lhs, const auto& rhs)
         {
             return fs::is_directory(lhs.status()) > fs::is_directory(rhs.status());
         });
-        
+
 		_should_refresh = false;
 	}
 
@@ -157,7 +482,25 @@ public:
         _should_refresh = true;
         watch();
     }
-    
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_snapshot ()
+	/// <summary>
+	/// Attaches a shared persistent snapshot. Directories it already
+	/// knows are served without touching their children on disk, and the
+	/// watcher events of this cache keep it up to date. Loading and
+	/// saving the snapshot file stays with the owner.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_snapshot(const std::shared_ptr<directory_snapshot>& snapshot)
+	{
+		unwatch();
+		_snapshot = snapshot;
+		_should_refresh = true;
+		watch();
+	}
+
+
 private:
 	//-----------------------------------------------------------------------------
 	//  Name : should_refresh ()
@@ -176,7 +519,13 @@ private:
 		constexpr bool is_recursive = std::is_same<iterator_t, recursive_directory_iterator>::value;
 
 		_watch_id = watcher::watch(_path / "*", is_recursive, false, _scan_frequency,
-								   [this](const auto&, bool) { _should_refresh = true; });
+								   [this](const auto& entries, bool) {
+									   if(_snapshot)
+									   {
+										   _snapshot->apply(entries);
+									   }
+									   _should_refresh = true;
+								   });
 	}
 	void unwatch()
 	{
@@ -191,6 +540,8 @@ private:
 	mutable std::vector<directory_entry> _entries;
 	///
 	mutable std::atomic_bool _should_refresh = {true};
+	/// Optional shared persistent metadata store.
+	std::shared_ptr<directory_snapshot> _snapshot;
 	///
 	std::uint64_t _watch_id = 0;
 };
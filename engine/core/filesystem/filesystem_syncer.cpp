@@ -1,6 +1,9 @@
 #include "filesystem_syncer.h"
+#include "../tasks/task_system.h"
 #include "filesystem_watcher.h"
 
+#include <map>
+
 namespace fs
 {
 static void ensure_directory_exists(const fs::path& path)
@@ -56,6 +59,11 @@ void syncer::unsync()
 	fs::watcher::unwatch(_watch_id);
 }
 
+void syncer::set_task_system(core::task_system* tasks)
+{
+	_task_system = tasks;
+}
+
 syncer::mapping syncer::get_mapping(const std::string& ext)
 {
 	std::lock_guard<std::mutex> lock(_mutex);
@@ -102,8 +110,7 @@ void syncer::sync(const fs::path& reference_dir, const fs::path& synced_dir)
 		ensure_directory_exists(_synced_dir);
 	}
 
-	const auto on_change = [this](const auto& entries, bool is_initial_listing) {
-		for(const auto& entry : entries)
+	const auto process_entry = [this](const auto& entry, bool is_initial_listing) {
 		{
 			bool is_directory = (entry.type == fs::directory_file);
             auto entry_path = entry.path;
@@ -181,6 +188,55 @@ void syncer::sync(const fs::path& reference_dir, const fs::path& synced_dir)
 			}
 		}
 	};
+
+	const auto on_change = [this, process_entry](const auto& entries, bool is_initial_listing) {
+		auto* tasks = _task_system.load();
+		if(tasks == nullptr || entries.size() < 2)
+		{
+			for(const auto& entry : entries)
+			{
+				process_entry(entry, is_initial_listing);
+			}
+			return;
+		}
+
+		// Fan the batch out with one task per source directory, keeping
+		// the entries of a directory in order inside their task. The
+		// callback returns only when the whole batch has been processed,
+		// so batches never overlap each other.
+		std::map<std::string, std::vector<fs::watcher::entry>> batches;
+		for(const auto& entry : entries)
+		{
+			batches[entry.path.parent_path().generic_string()].emplace_back(entry);
+		}
+
+		if(batches.size() == 1)
+		{
+			for(const auto& entry : entries)
+			{
+				process_entry(entry, is_initial_listing);
+			}
+			return;
+		}
+
+		std::vector<core::task_future<void>> pending;
+		pending.reserve(batches.size());
+		for(auto& batch : batches)
+		{
+			pending.emplace_back(tasks->push_on_worker_thread(
+				[process_entry, group = std::move(batch.second), is_initial_listing]() {
+					for(const auto& entry : group)
+					{
+						process_entry(entry, is_initial_listing);
+					}
+				}));
+		}
+
+		for(auto& task : pending)
+		{
+			task.wait();
+		}
+	};
 	using namespace std::literals;
 	const fs::path watch_dir = get_watch_path();
 	_watch_id = fs::watcher::watch(watch_dir, true, true, 500ms, on_change);
@@ -7,6 +7,11 @@
 #include <unordered_map>
 #include <vector>
 
+namespace core
+{
+class task_system;
+}
+
 namespace fs
 {
 class syncer
@@ -66,6 +71,19 @@ public:
 	//-----------------------------------------------------------------------------
 	void unsync();
 
+	//-----------------------------------------------------------------------------
+	//  Name : set_task_system ()
+	/// <summary>
+	/// Hands the syncer a task system to fan change batches out on. Large
+	/// batches - the initial listing above all - are split into one task
+	/// per source directory, so callback order is only guaranteed between
+	/// entries of the same directory. Without it (or with the pointer
+	/// reset) every batch processes serially as before. The pointer must
+	/// outlive the syncer or be reset before the task system dies.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_task_system(core::task_system* tasks);
+
 private:
 	mapping get_mapping(const std::string& ext);
 	on_entry_created_t get_on_created_callback(const std::string& ext);
@@ -104,6 +122,8 @@ private:
 	fs::path _reference_dir;
 	/// Directory to be synced with the reference one.
 	fs::path _synced_dir;
+	/// Optional task system used to process change batches in parallel.
+	std::atomic<core::task_system*> _task_system = {nullptr};
 
 	std::atomic<std::uint64_t> _watch_id = {0};
 };
@@ -1,4 +1,13 @@
 #include "filesystem_watcher.h"
+
+#include <set>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
 namespace fs
 {
 using namespace std::literals;
@@ -80,6 +89,12 @@ static std::pair<path, std::string> visit_wild_card_path(const fs::path& path, b
 	return path_filter;
 }
 
+/// A save from some editors lands as several distinct writes in quick
+/// succession. Changes are held until their path has been quiet this
+/// long and then delivered as one batch, so a single artist save causes
+/// one recompile downstream instead of two or three.
+static const filesystem_watcher::clock_t::duration debounce_interval = 100ms;
+
 class filesystem_watcher::watcher_impl
 {
 public:
@@ -157,12 +172,76 @@ public:
 
 		process_modifications(entries, created, modified);
 
-		if(entries.size() > 0 && _callback)
+		const auto now = clock_t::now();
+		if(!entries.empty())
 		{
-			_callback(entries, false);
+			for(auto& e : entries)
+			{
+				coalesce(e);
+			}
+			_last_change = now;
+		}
+
+		// deliver once the batch has been quiet for the debounce window
+		if(!_pending.empty() && now - _last_change >= debounce_interval && _callback)
+		{
+			std::vector<filesystem_watcher::entry> batch;
+			batch.reserve(_pending.size());
+			for(auto& pair : _pending)
+			{
+				batch.push_back(std::move(pair.second));
+			}
+			_pending.clear();
+			_callback(batch, false);
 		}
 	}
 
+	//-----------------------------------------------------------------------------
+	//  Name : coalesce ()
+	/// <summary>
+	/// Folds a fresh change into the pending batch for its path, so the
+	/// several notifications one save produces collapse into a single
+	/// entry with the status the consumer should act on.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void coalesce(const filesystem_watcher::entry& e)
+	{
+		const auto key = e.path.string();
+		auto it = _pending.find(key);
+		if(it == _pending.end())
+		{
+			_pending.emplace(key, e);
+			return;
+		}
+
+		auto& pending = it->second;
+		if(pending.status == filesystem_watcher::entry_status::created &&
+		   e.status == filesystem_watcher::entry_status::removed)
+		{
+			// appeared and vanished inside the window - nothing to report
+			_pending.erase(it);
+			return;
+		}
+
+		if((pending.status == filesystem_watcher::entry_status::created ||
+			pending.status == filesystem_watcher::entry_status::renamed) &&
+		   e.status == filesystem_watcher::entry_status::modified)
+		{
+			// keep how the file first showed up, only refresh its state
+			pending.size = e.size;
+			pending.last_mod_time = e.last_mod_time;
+			pending.type = e.type;
+			return;
+		}
+
+		pending = e;
+	}
+
+	bool has_pending() const
+	{
+		return !_pending.empty();
+	}
+
 	void process_modifications(std::vector<filesystem_watcher::entry>& entries,
 							   const std::vector<size_t>& created, const std::vector<size_t>&)
 	{
@@ -269,10 +348,277 @@ protected:
 	clock_t::duration _poll_interval = 500ms;
 
 	clock_t::time_point _last_poll = clock_t::now();
+	/// Changes waiting out the debounce window, keyed by path.
+	std::map<std::string, filesystem_watcher::entry> _pending;
+	/// When the newest pending change was recorded.
+	clock_t::time_point _last_change = clock_t::now();
 	///
 	bool _recursive = false;
 };
 
+//-----------------------------------------------------------------------------
+//  Name : change_notifier (Class) (Local)
+/// <summary>
+/// Native OS change events feeding the poll loop. Events do not replace
+/// the poller - they mark the owning watcher dirty and wake the thread,
+/// so the existing stat-and-diff logic runs immediately while the timed
+/// poll stretches to a fraction of its configured rate as a safety net.
+/// Linux uses inotify; on platforms without a backend everything behaves
+/// exactly as before.
+/// </summary>
+//-----------------------------------------------------------------------------
+#if defined(__linux__)
+class change_notifier
+{
+public:
+	change_notifier()
+	{
+		_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	}
+
+	~change_notifier()
+	{
+		_running = false;
+		if(_thread.joinable())
+			_thread.join();
+		if(_fd >= 0)
+			::close(_fd);
+	}
+
+	bool is_available() const
+	{
+		return _fd >= 0;
+	}
+
+	void start(const std::function<void()>& on_change)
+	{
+		if(!is_available() || _thread.joinable())
+			return;
+
+		_on_change = on_change;
+		_running = true;
+		_thread = std::thread([this]() { run(); });
+	}
+
+	void add(std::uint64_t key, const fs::path& root, bool recursive)
+	{
+		if(!is_available())
+			return;
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		add_tree(key, root, recursive);
+	}
+
+	void remove(std::uint64_t key)
+	{
+		if(!is_available())
+			return;
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		for(auto it = _watches.begin(); it != _watches.end();)
+		{
+			if(it->second.key == key)
+			{
+				inotify_rm_watch(_fd, it->first);
+				it = _watches.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+		_watch_counts.erase(key);
+		_dirty.erase(key);
+	}
+
+	void clear()
+	{
+		if(!is_available())
+			return;
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		for(const auto& pair : _watches)
+		{
+			inotify_rm_watch(_fd, pair.first);
+		}
+		_watches.clear();
+		_watch_counts.clear();
+		_dirty.clear();
+	}
+
+	bool covers(std::uint64_t key) const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto it = _watch_counts.find(key);
+		return it != _watch_counts.end() && it->second > 0;
+	}
+
+	bool consume_dirty(std::uint64_t key)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _dirty.erase(key) != 0;
+	}
+
+private:
+	// _mutex held by the caller.
+	void add_tree(std::uint64_t key, const fs::path& root, bool recursive)
+	{
+		add_dir(key, root, recursive);
+		if(recursive)
+		{
+			fs::error_code err;
+			fs::recursive_directory_iterator it(root, err);
+			for(const auto& entry : it)
+			{
+				fs::error_code status_err;
+				if(fs::is_directory(entry.path(), status_err))
+				{
+					add_dir(key, entry.path(), recursive);
+				}
+			}
+		}
+	}
+
+	// _mutex held by the caller.
+	void add_dir(std::uint64_t key, const fs::path& dir, bool recursive)
+	{
+		const int wd = inotify_add_watch(_fd, dir.string().c_str(),
+										 IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MODIFY |
+											 IN_MOVED_FROM | IN_MOVED_TO);
+		if(wd < 0)
+			return;
+
+		auto it = _watches.find(wd);
+		if(it == _watches.end())
+		{
+			_watch_counts[key]++;
+		}
+		auto& desc = _watches[wd];
+		desc.key = key;
+		desc.path = dir;
+		desc.recursive = recursive;
+	}
+
+	void run()
+	{
+		while(_running)
+		{
+			pollfd pfd;
+			pfd.fd = _fd;
+			pfd.events = POLLIN;
+			pfd.revents = 0;
+			if(::poll(&pfd, 1, 250) <= 0)
+				continue;
+
+			alignas(inotify_event) std::uint8_t buffer[4096];
+			const auto length = ::read(_fd, buffer, sizeof(buffer));
+			if(length <= 0)
+				continue;
+
+			bool any = false;
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				std::size_t offset = 0;
+				while(offset + sizeof(inotify_event) <= static_cast<std::size_t>(length))
+				{
+					const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+					offset += sizeof(inotify_event) + event->len;
+
+					if((event->mask & IN_Q_OVERFLOW) != 0)
+					{
+						// The kernel dropped events - let the next poll
+						// re-examine every watcher.
+						for(const auto& pair : _watch_counts)
+						{
+							_dirty.insert(pair.first);
+						}
+						any = true;
+						continue;
+					}
+
+					auto it = _watches.find(event->wd);
+					if(it == _watches.end())
+						continue;
+
+					const auto& desc = it->second;
+					_dirty.insert(desc.key);
+					any = true;
+
+					// Cover directories created inside a recursive watch.
+					if(desc.recursive && (event->mask & IN_ISDIR) != 0 &&
+					   (event->mask & (IN_CREATE | IN_MOVED_TO)) != 0 && event->len > 0)
+					{
+						add_tree(desc.key, desc.path / event->name, true);
+					}
+				}
+			}
+
+			if(any && _on_change)
+				_on_change();
+		}
+	}
+
+	struct watch_desc
+	{
+		std::uint64_t key = 0;
+		fs::path path;
+		bool recursive = false;
+	};
+
+	/// inotify instance descriptor.
+	int _fd = -1;
+	std::atomic<bool> _running = {false};
+	/// Thread draining the event descriptor.
+	std::thread _thread;
+	/// Wakes the poll loop after events were recorded.
+	std::function<void()> _on_change;
+	mutable std::mutex _mutex;
+	/// inotify watch descriptor to owning watcher.
+	std::map<int, watch_desc> _watches;
+	/// Directories covered per watcher key.
+	std::map<std::uint64_t, std::size_t> _watch_counts;
+	/// Watchers with unprocessed events.
+	std::set<std::uint64_t> _dirty;
+};
+#else
+// No native backend on this platform - the interval poller carries all
+// the work, as it always has.
+class change_notifier
+{
+public:
+	bool is_available() const
+	{
+		return false;
+	}
+	void start(const std::function<void()>&)
+	{
+	}
+	void add(std::uint64_t, const fs::path&, bool)
+	{
+	}
+	void remove(std::uint64_t)
+	{
+	}
+	void clear()
+	{
+	}
+	bool covers(std::uint64_t) const
+	{
+		return false;
+	}
+	bool consume_dirty(std::uint64_t)
+	{
+		return false;
+	}
+};
+#endif
+
+static change_notifier& get_notifier()
+{
+	static change_notifier notifier;
+	return notifier;
+}
+
 static filesystem_watcher& get_watcher()
 {
 	// create the static filesystem_watcher instance
@@ -340,6 +686,8 @@ void filesystem_watcher::close()
 void filesystem_watcher::start()
 {
 	_watching = true;
+	// native change events wake us up the moment something happens
+	get_notifier().start([this]() { _cv.notify_all(); });
 	_thread = std::thread([this]() {
 		// keep watching for modifications every ms milliseconds
 		using namespace std::literals;
@@ -354,19 +702,32 @@ void filesystem_watcher::start()
 				watchers = _watchers;
 			}
 
+			auto& notifier = get_notifier();
 			for(auto& pair : watchers)
 			{
 				auto watcher = pair.second;
 
 				auto now = clock_t::now();
 
-				auto diff = (watcher->_last_poll + watcher->_poll_interval) - now;
-				if(diff <= clock_t::duration(0))
+				// A native event arrived for this watcher - poll it right
+				// away. Watchers covered by the notifier only stat on the
+				// timer as a safety net, at a fraction of their rate.
+				const bool dirty = notifier.consume_dirty(pair.first);
+				auto interval = watcher->_poll_interval;
+				if(!dirty && notifier.covers(pair.first))
+					interval *= 20;
+
+				// a pending batch must flush as soon as its window closes
+				if(watcher->has_pending())
+					interval = std::min(interval, debounce_interval);
+
+				auto diff = (watcher->_last_poll + interval) - now;
+				if(dirty || diff <= clock_t::duration(0))
 				{
 					watcher->watch();
 					watcher->_last_poll = now;
 
-					sleep_time = std::min(sleep_time, watcher->_poll_interval);
+					sleep_time = std::min(sleep_time, interval);
 				}
 				else
 				{
@@ -424,6 +785,7 @@ std::uint64_t filesystem_watcher::watch_impl(const fs::path& path, bool recursiv
 			std::lock_guard<std::mutex> lock(wd._mutex);
 			wd._watchers.emplace(key, std::move(impl));
 		}
+		get_notifier().add(key, p, recursive);
 		wd._cv.notify_all();
 		return key;
 	}
@@ -439,6 +801,7 @@ void filesystem_watcher::unwatch_impl(std::uint64_t key)
 		std::lock_guard<std::mutex> lock(wd._mutex);
 		wd._watchers.erase(key);
 	}
+	get_notifier().remove(key);
 	wd._cv.notify_all();
 }
 
@@ -449,6 +812,7 @@ void filesystem_watcher::unwatch_all_impl()
 		std::lock_guard<std::mutex> lock(wd._mutex);
 		wd._watchers.clear();
 	}
+	get_notifier().clear();
 	wd._cv.notify_all();
 }
 }
@@ -0,0 +1,118 @@
+#include "memory_mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs
+{
+
+memory_mapped_file::~memory_mapped_file()
+{
+	close();
+}
+
+#ifdef _WIN32
+
+bool memory_mapped_file::open(const path& file_path)
+{
+	close();
+
+	HANDLE file = CreateFileW(file_path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+							  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER file_size;
+	if(GetFileSizeEx(file, &file_size) == FALSE || file_size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if(mapping == nullptr)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if(view == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	_file = file;
+	_mapping = mapping;
+	_data = static_cast<const std::uint8_t*>(view);
+	_size = static_cast<std::uint64_t>(file_size.QuadPart);
+	return true;
+}
+
+void memory_mapped_file::close()
+{
+	if(_data != nullptr)
+		UnmapViewOfFile(_data);
+	if(_mapping != nullptr)
+		CloseHandle(_mapping);
+	if(_file != nullptr)
+		CloseHandle(_file);
+
+	_data = nullptr;
+	_size = 0;
+	_file = nullptr;
+	_mapping = nullptr;
+}
+
+#else
+
+bool memory_mapped_file::open(const path& file_path)
+{
+	close();
+
+	int file = ::open(file_path.string().c_str(), O_RDONLY);
+	if(file < 0)
+		return false;
+
+	struct stat file_info;
+	if(::fstat(file, &file_info) != 0 || file_info.st_size <= 0)
+	{
+		::close(file);
+		return false;
+	}
+
+	void* view = ::mmap(nullptr, static_cast<std::size_t>(file_info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	if(view == MAP_FAILED)
+	{
+		::close(file);
+		return false;
+	}
+
+	_file = file;
+	_data = static_cast<const std::uint8_t*>(view);
+	_size = static_cast<std::uint64_t>(file_info.st_size);
+	return true;
+}
+
+void memory_mapped_file::close()
+{
+	if(_data != nullptr)
+		::munmap(const_cast<std::uint8_t*>(_data), static_cast<std::size_t>(_size));
+	if(_file >= 0)
+		::close(_file);
+
+	_data = nullptr;
+	_size = 0;
+	_file = -1;
+}
+
+#endif
+}
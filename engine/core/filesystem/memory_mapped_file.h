@@ -0,0 +1,74 @@
+#pragma once
+
+#include "detail/filesystem_includes.h"
+
+#include <cstdint>
+
+namespace fs
+{
+
+//-----------------------------------------------------------------------------
+//  Name : memory_mapped_file (Class)
+/// <summary>
+/// Read only view of a file mapped directly into the address space. Used
+/// by loaders that want to hand file contents to consumers without
+/// copying them through intermediate buffers first.
+/// </summary>
+//-----------------------------------------------------------------------------
+class memory_mapped_file
+{
+public:
+	memory_mapped_file() = default;
+	memory_mapped_file(const memory_mapped_file&) = delete;
+	memory_mapped_file& operator=(const memory_mapped_file&) = delete;
+	~memory_mapped_file();
+
+	//-----------------------------------------------------------------------------
+	//  Name : open ()
+	/// <summary>
+	/// Maps the specified file for reading. Any previously held mapping is
+	/// released first. Returns false when the file cannot be mapped.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool open(const path& file_path);
+
+	//-----------------------------------------------------------------------------
+	//  Name : close ()
+	/// <summary>
+	/// Releases the mapping. Pointers previously returned by 'data' become
+	/// invalid.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void close();
+
+	const std::uint8_t* data() const
+	{
+		return _data;
+	}
+
+	std::uint64_t size() const
+	{
+		return _size;
+	}
+
+	bool is_open() const
+	{
+		return _data != nullptr;
+	}
+
+private:
+	/// start of the mapped region
+	const std::uint8_t* _data = nullptr;
+	/// size of the mapped region in bytes
+	std::uint64_t _size = 0;
+#ifdef _WIN32
+	/// file handle backing the mapping
+	void* _file = nullptr;
+	/// mapping object handle
+	void* _mapping = nullptr;
+#else
+	/// file descriptor backing the mapping
+	int _file = -1;
+#endif
+};
+}
@@ -0,0 +1,117 @@
+#include "destruction_queue.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace gfx
+{
+
+void destruction_queue::queue(texture_handle _handle)
+{
+	if(bgfx::isValid(_handle))
+		push(handle_kind::texture, _handle.idx);
+}
+
+void destruction_queue::queue(frame_buffer_handle _handle)
+{
+	if(bgfx::isValid(_handle))
+		push(handle_kind::frame_buffer, _handle.idx);
+}
+
+void destruction_queue::queue(vertex_buffer_handle _handle)
+{
+	if(bgfx::isValid(_handle))
+		push(handle_kind::vertex_buffer, _handle.idx);
+}
+
+void destruction_queue::queue(index_buffer_handle _handle)
+{
+	if(bgfx::isValid(_handle))
+		push(handle_kind::index_buffer, _handle.idx);
+}
+
+void destruction_queue::queue(uniform_handle _handle)
+{
+	if(bgfx::isValid(_handle))
+		push(handle_kind::uniform, _handle.idx);
+}
+
+void destruction_queue::queue(program_handle _handle)
+{
+	if(bgfx::isValid(_handle))
+		push(handle_kind::program, _handle.idx);
+}
+
+void destruction_queue::queue(shader_handle _handle)
+{
+	if(bgfx::isValid(_handle))
+		push(handle_kind::shader, _handle.idx);
+}
+
+void destruction_queue::push(handle_kind kind, std::uint16_t idx)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_queue.push_back({kind, idx});
+	_stats.pending = std::uint32_t(_queue.size());
+}
+
+void destruction_queue::flush()
+{
+	// Swap the batch out so destructors cascading into further queue
+	// calls (e.g. a program releasing its shaders) land in the next one.
+	std::vector<entry> batch;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		std::swap(batch, _queue);
+	}
+
+	for(const auto& e : batch)
+	{
+		switch(e.kind)
+		{
+			case handle_kind::texture:
+				bgfx::destroy(texture_handle{e.idx});
+				break;
+			case handle_kind::frame_buffer:
+				bgfx::destroy(frame_buffer_handle{e.idx});
+				break;
+			case handle_kind::vertex_buffer:
+				bgfx::destroy(vertex_buffer_handle{e.idx});
+				break;
+			case handle_kind::index_buffer:
+				bgfx::destroy(index_buffer_handle{e.idx});
+				break;
+			case handle_kind::uniform:
+				bgfx::destroy(uniform_handle{e.idx});
+				break;
+			case handle_kind::program:
+				bgfx::destroy(program_handle{e.idx});
+				break;
+			case handle_kind::shader:
+				bgfx::destroy(shader_handle{e.idx});
+				break;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stats.pending = std::uint32_t(_queue.size());
+		_stats.last_flush_destroyed = std::uint32_t(batch.size());
+		_stats.peak_flush_destroyed =
+			std::max(_stats.peak_flush_destroyed, _stats.last_flush_destroyed);
+		_stats.total_destroyed += batch.size();
+	}
+}
+
+destruction_queue::stats destruction_queue::get_stats() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _stats;
+}
+
+destruction_queue& get_destruction_queue()
+{
+	static destruction_queue queue;
+	return queue;
+}
+}
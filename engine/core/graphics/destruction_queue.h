@@ -0,0 +1,96 @@
+#pragma once
+
+#include "graphics.h"
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace gfx
+{
+
+//-----------------------------------------------------------------------------
+//  Name : destruction_queue (Class)
+/// <summary>
+/// Per-frame destruction queue for bgfx handles. Wrapper destructors
+/// enqueue here instead of destroying inline, and the whole batch is
+/// released once per frame at the frame boundary. Expiring asset handles
+/// used to scatter destruction work across the frame - worst of all
+/// during level transitions, where release bursts coincided with
+/// hitches. The stats expose queue depth and per-frame destruction
+/// counts so those bursts show up in captures.
+/// </summary>
+//-----------------------------------------------------------------------------
+class destruction_queue
+{
+public:
+	struct stats
+	{
+		/// handles waiting for the next flush
+		std::uint32_t pending = 0;
+		/// handles destroyed by the most recent flush
+		std::uint32_t last_flush_destroyed = 0;
+		/// largest single flush seen (burst high-water mark)
+		std::uint32_t peak_flush_destroyed = 0;
+		/// handles destroyed since startup
+		std::uint64_t total_destroyed = 0;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : queue ()
+	/// <summary>
+	/// Defers destruction of the handle to the next frame boundary.
+	/// Safe to call from any thread; invalid handles are ignored.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void queue(texture_handle _handle);
+	void queue(frame_buffer_handle _handle);
+	void queue(vertex_buffer_handle _handle);
+	void queue(index_buffer_handle _handle);
+	void queue(uniform_handle _handle);
+	void queue(program_handle _handle);
+	void queue(shader_handle _handle);
+
+	//-----------------------------------------------------------------------------
+	//  Name : flush ()
+	/// <summary>
+	/// Destroys everything queued so far in one batch. Called once per
+	/// frame by gfx::frame and a final time during shutdown.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void flush();
+
+	stats get_stats() const;
+
+private:
+	enum class handle_kind : std::uint8_t
+	{
+		texture,
+		frame_buffer,
+		vertex_buffer,
+		index_buffer,
+		uniform,
+		program,
+		shader,
+	};
+
+	struct entry
+	{
+		handle_kind kind;
+		std::uint16_t idx;
+	};
+
+	void push(handle_kind kind, std::uint16_t idx);
+
+	mutable std::mutex _mutex;
+	std::vector<entry> _queue;
+	stats _stats;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : get_destruction_queue ()
+/// <summary>
+/// Process-wide instance shared by every handle wrapper.
+/// </summary>
+//-----------------------------------------------------------------------------
+destruction_queue& get_destruction_queue();
+}
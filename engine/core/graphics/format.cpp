@@ -3,6 +3,18 @@
 namespace gfx
 {
 
+static gbuffer_profile s_gbuffer_profile = gbuffer_profile::precision;
+
+void set_gbuffer_profile(gbuffer_profile profile)
+{
+	s_gbuffer_profile = profile;
+}
+
+gbuffer_profile get_gbuffer_profile()
+{
+	return s_gbuffer_profile;
+}
+
 texture_format get_best_format(std::uint16_t type_flags, std::uint32_t search_flags)
 {
 	//( "DX11", "Go back over the list and find good formats for DX11" )
@@ -51,6 +63,11 @@ texture_format get_best_format(std::uint16_t type_flags, std::uint32_t search_fl
 			// How many channels?
 			if((search_flags & format_search_flags::four_channels))
 			{
+				// Packed small floats halve the bandwidth of a half float
+				// target when no alpha is needed.
+				if((search_flags & format_search_flags::compact_storage) && !requires_alpha &&
+				   is_format_supported(type_flags, texture_format::RG11B10F))
+					return texture_format::RG11B10F;
 				if(accept_full && is_format_supported(type_flags, texture_format::RGBA32F))
 					return texture_format::RGBA32F;
 				else if(accept_half && is_format_supported(type_flags, texture_format::RGBA16F))
@@ -24,9 +24,26 @@ enum e
 	half_precision_float = 0x1000,
 	full_precision_float = 0x2000,
 	floating_point = 0xF000,
+
+	// Prefer the narrowest qualifying format (e.g. packed small floats over
+	// half precision) to trade precision for bandwidth.
+	compact_storage = 0x10000,
+};
 };
+
+/// G-buffer storage profile, selectable at runtime. The bandwidth profile
+/// answers target format queries with narrower formats where the render
+/// passes can tolerate the precision loss.
+enum class gbuffer_profile
+{
+	precision,
+	bandwidth,
 };
 
+void set_gbuffer_profile(gbuffer_profile profile);
+
+gbuffer_profile get_gbuffer_profile();
+
 bool is_format_supported(std::uint16_t flags, texture_format format);
 
 texture_format get_best_format(std::uint16_t type, std::uint32_t search_flags);
@@ -1,10 +1,31 @@
 #include "graphics.h"
+#include "destruction_queue.h"
+#include "static_buffer_pool.h"
+#include "uniform.h"
 #include <algorithm>
+#include <fstream>
 #include <map>
+#include <sstream>
 namespace gfx
 {
 static std::map<std::string, std::function<void(const std::string& log_msg)>> s_loggers;
 static bool s_initted = false;
+/// Directory the cache callbacks below persist renderer binaries to; the
+/// callbacks are no-ops while it is empty.
+static std::string s_cache_directory;
+
+void set_callback_cache_directory(const std::string& directory)
+{
+	s_cache_directory = directory;
+}
+
+static std::string cache_file_path(std::uint64_t _id)
+{
+	std::ostringstream stream;
+	stream << s_cache_directory << "/" << bgfx::getRendererName(bgfx::getRendererType()) << "_" << std::hex
+		   << _id << ".bin";
+	return stream.str();
+}
 
 void set_info_logger(std::function<void(const std::string& log_msg)> logger)
 {
@@ -55,18 +76,41 @@ struct gfx_callback : public bgfx::CallbackI
 		log("error", _str);
 	}
 
-	virtual std::uint32_t cacheReadSize(std::uint64_t /*_id*/) final
+	virtual std::uint32_t cacheReadSize(std::uint64_t _id) final
 	{
-		return 0;
+		if(s_cache_directory.empty())
+			return 0;
+
+		std::ifstream stream(cache_file_path(_id), std::ios::binary | std::ios::ate);
+		if(!stream.is_open())
+			return 0;
+
+		return std::uint32_t(stream.tellg());
 	}
 
-	virtual bool cacheRead(std::uint64_t /*_id*/, void* /*_data*/, std::uint32_t /*_size*/) final
+	virtual bool cacheRead(std::uint64_t _id, void* _data, std::uint32_t _size) final
 	{
-		return false;
+		if(s_cache_directory.empty())
+			return false;
+
+		std::ifstream stream(cache_file_path(_id), std::ios::binary);
+		if(!stream.is_open())
+			return false;
+
+		stream.read(reinterpret_cast<char*>(_data), _size);
+		return std::uint32_t(stream.gcount()) == _size;
 	}
 
-	virtual void cacheWrite(std::uint64_t /*_id*/, const void* /*_data*/, std::uint32_t /*_size*/) final
+	virtual void cacheWrite(std::uint64_t _id, const void* _data, std::uint32_t _size) final
 	{
+		if(s_cache_directory.empty())
+			return;
+
+		std::ofstream stream(cache_file_path(_id), std::ios::binary | std::ios::trunc);
+		if(!stream.is_open())
+			return;
+
+		stream.write(reinterpret_cast<const char*>(_data), _size);
 	}
 
 	virtual void screenShot(const char* /*_filePath*/, std::uint32_t /*_width*/, std::uint32_t /*_height*/,
@@ -96,6 +140,17 @@ void set_platform_data(const platform_data& _data)
 
 void shutdown()
 {
+	// drop registry-owned uniform handles while the device can still
+	// destroy them
+	release_uniform_registry();
+
+	// shared static-geometry blocks go the same way
+	release_static_buffer_pool();
+
+	// a cascade can queue more handles while flushing, so drain fully
+	while(get_destruction_queue().get_stats().pending != 0)
+		get_destruction_queue().flush();
+
 	if(s_initted)
 		bgfx::shutdown();
 }
@@ -177,11 +232,48 @@ void end(encoder* _encoder)
 	bgfx::end(_encoder);
 }
 
+/// Encoder the calling thread currently records through; when null the
+/// draw-state and submit wrappers fall through to the regular bgfx calls.
+static thread_local encoder* s_recording_encoder = nullptr;
+
+encoder* begin_recording()
+{
+	s_recording_encoder = bgfx::begin();
+	return s_recording_encoder;
+}
+
+void end_recording()
+{
+	if(s_recording_encoder != nullptr)
+	{
+		bgfx::end(s_recording_encoder);
+		s_recording_encoder = nullptr;
+	}
+}
+
+/// Frames rendered so far; used to scope per-frame caches without asking
+/// bgfx for its stats.
+static uint64_t s_render_frame = 0;
+
 uint32_t frame(bool _capture)
 {
+	// release the frame's expired handles in one batch at the boundary
+	get_destruction_queue().flush();
+
+	++s_render_frame;
 	return bgfx::frame(_capture);
 }
 
+uint64_t get_render_frame()
+{
+	return s_render_frame;
+}
+
+render_frame_result render_frame()
+{
+	return bgfx::renderFrame();
+}
+
 renderer_type get_renderer_type()
 {
 	return bgfx::getRendererType();
@@ -621,6 +713,11 @@ void set_marker(const char* _marker)
 
 void set_state(uint64_t _state, uint32_t _rgba)
 {
+	if(s_recording_encoder != nullptr)
+	{
+		s_recording_encoder->setState(_state, _rgba);
+		return;
+	}
 	bgfx::setState(_state, _rgba);
 }
 
@@ -636,6 +733,8 @@ void set_stencil(uint32_t _fstencil, uint32_t _bstencil)
 
 uint16_t set_scissor(uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height)
 {
+	if(s_recording_encoder != nullptr)
+		return s_recording_encoder->setScissor(_x, _y, _width, _height);
 	return bgfx::setScissor(_x, _y, _width, _height);
 }
 
@@ -646,6 +745,8 @@ void set_scissor(uint16_t _cache)
 
 uint32_t set_transform(const void* _mtx, uint16_t _num)
 {
+	if(s_recording_encoder != nullptr)
+		return s_recording_encoder->setTransform(_mtx, _num);
 	return bgfx::setTransform(_mtx, _num);
 }
 
@@ -661,11 +762,21 @@ void set_transform(uint32_t _cache, uint16_t _num)
 
 void set_uniform(uniform_handle _handle, const void* _value, uint16_t _num)
 {
+	if(s_recording_encoder != nullptr)
+	{
+		s_recording_encoder->setUniform(_handle, _value, _num);
+		return;
+	}
 	bgfx::setUniform(_handle, _value, _num);
 }
 
 void set_index_buffer(index_buffer_handle _handle, uint32_t _firstIndex, uint32_t _numIndices)
 {
+	if(s_recording_encoder != nullptr)
+	{
+		s_recording_encoder->setIndexBuffer(_handle, _firstIndex, _numIndices);
+		return;
+	}
 	bgfx::setIndexBuffer(_handle, _firstIndex, _numIndices);
 }
 
@@ -682,6 +793,11 @@ void set_index_buffer(const transient_index_buffer* _tib, uint32_t _firstIndex,
 void set_vertex_buffer(uint8_t _stream, vertex_buffer_handle _handle, uint32_t _startVertex,
 					   uint32_t _numVertices)
 {
+	if(s_recording_encoder != nullptr)
+	{
+		s_recording_encoder->setVertexBuffer(_stream, _handle, _startVertex, _numVertices);
+		return;
+	}
 	bgfx::setVertexBuffer(_stream, _handle, _startVertex, _numVertices);
 }
 
@@ -699,6 +815,11 @@ void set_vertex_buffer(uint8_t _stream, const transient_vertex_buffer* _tvb, uin
 
 void set_instance_data_buffer(const instance_data_buffer* _idb, uint32_t _num)
 {
+	if(s_recording_encoder != nullptr)
+	{
+		s_recording_encoder->setInstanceDataBuffer(_idb, _num);
+		return;
+	}
 	bgfx::setInstanceDataBuffer(_idb, _num);
 }
 
@@ -714,6 +835,11 @@ void set_instance_data_buffer(dynamic_vertex_buffer_handle _handle, uint32_t _st
 
 void set_texture(uint8_t _stage, uniform_handle _sampler, texture_handle _handle, uint32_t _flags)
 {
+	if(s_recording_encoder != nullptr)
+	{
+		s_recording_encoder->setTexture(_stage, _sampler, _handle, _flags);
+		return;
+	}
 	bgfx::setTexture(_stage, _sampler, _handle, _flags);
 }
 
@@ -724,12 +850,22 @@ void touch(view_id _id)
 
 void submit(view_id _id, program_handle _handle, int32_t _depth, bool _preserveState)
 {
+	if(s_recording_encoder != nullptr)
+	{
+		s_recording_encoder->submit(_id, _handle, _depth, _preserveState);
+		return;
+	}
 	bgfx::submit(_id, _handle, _depth, _preserveState);
 }
 
 void submit(view_id _id, program_handle _program, occlusion_query_handle _occlusionQuery, int32_t _depth,
 			bool _preserveState)
 {
+	if(s_recording_encoder != nullptr)
+	{
+		s_recording_encoder->submit(_id, _program, _occlusionQuery, _depth, _preserveState);
+		return;
+	}
 	bgfx::submit(_id, _program, _occlusionQuery, _depth, _preserveState);
 }
 
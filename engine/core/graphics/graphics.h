@@ -28,6 +28,7 @@ using stats = bgfx::Stats;
 using access = bgfx::Access::Enum;
 using view_mode = bgfx::ViewMode::Enum;
 using occlusion_query_result = bgfx::OcclusionQueryResult::Enum;
+using render_frame_result = bgfx::RenderFrame::Enum;
 using topology_conversion = bgfx::TopologyConvert::Enum;
 using topology_sort = bgfx::TopologySort::Enum;
 using release_fn = bgfx::ReleaseFn;
@@ -96,15 +97,39 @@ uint8_t get_supported_renderers(uint8_t _max = 0, renderer_type* _enum = nullptr
 /**/
 const char* get_renderer_name(renderer_type _type);
 
+/// Points the renderer's binary cache callbacks at a directory. Backends
+/// that support it (shader/program blobs, e.g. D3D bytecode or GL program
+/// binaries) then persist compiled binaries across runs, keyed by bgfx's
+/// cache id and the active renderer, removing first-use compile hitches.
+void set_callback_cache_directory(const std::string& directory);
+
 /**/
 encoder* begin();
 
 /**/
 void end(encoder* _encoder);
 
+/// Begins an encoder and routes this thread's draw-state and submit wrappers
+/// below through it until end_recording(). Lets render passes be recorded on
+/// worker threads in parallel; view configuration stays on the API thread.
+encoder* begin_recording();
+
+/**/
+void end_recording();
+
 /**/
 uint32_t frame(bool _capture = true);
 
+/// Processes one backend frame on the calling thread. Calling this before
+/// init() marks the caller as the dedicated render thread, which puts the
+/// backend into explicit multithreaded mode: frame() then only snapshots
+/// the submitted commands and kicks this thread. Keep pumping until
+/// Exiting comes back during shutdown.
+render_frame_result render_frame();
+
+/// Number of frames rendered so far (incremented by frame()).
+uint64_t get_render_frame();
+
 /**/
 renderer_type get_renderer_type();
 
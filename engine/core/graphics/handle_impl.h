@@ -1,5 +1,6 @@
 #pragma once
 
+#include "destruction_queue.h"
 #include "graphics.h"
 
 namespace gfx
@@ -19,8 +20,10 @@ public:
 
 	void dispose()
 	{
+		// Handles are released in one batch per frame instead of inline;
+		// see destruction_queue.
 		if(is_valid())
-			bgfx::destroy(handle);
+			get_destruction_queue().queue(handle);
 
 		handle = invalid_handle();
 	}
@@ -1,9 +1,23 @@
 #include "index_buffer.h"
+#include "../memory/memory_tracker.h"
+
 namespace gfx
 {
 
 index_buffer::index_buffer(const memory_view* _mem, std::uint16_t _flags /*= BGFX_BUFFER_NONE*/)
 {
 	handle = create_index_buffer(_mem, _flags);
+
+	if(_mem != nullptr)
+	{
+		tracked_size = _mem->size;
+		memory::memory_tracker::get().record_alloc("gfx/index_buffers", tracked_size);
+	}
+}
+
+index_buffer::~index_buffer()
+{
+	if(tracked_size != 0)
+		memory::memory_tracker::get().record_free("gfx/index_buffers", tracked_size);
 }
 }
@@ -16,5 +16,16 @@ struct index_buffer : public handle_impl<index_buffer_handle>
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	index_buffer(const memory_view* _mem, std::uint16_t _flags = BGFX_BUFFER_NONE);
+
+	//-----------------------------------------------------------------------------
+	//  Name : ~index_buffer ()
+	/// <summary>
+	/// Releases the bytes accounted to the memory tracker on creation.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	~index_buffer();
+
+	/// Bytes accounted to the memory tracker for this buffer.
+	std::uint32_t tracked_size = 0;
 };
 }
@@ -1,11 +1,16 @@
 #include "render_pass.h"
 #include <bitset>
 #include <limits>
+#include <mutex>
 namespace gfx
 {
 static gfx::view_id s_index = 0;
 static gfx::view_id s_last_index = 0;
 
+/// last gathered per-pass-name timings and its guard
+static std::mutex s_timings_mutex;
+static std::unordered_map<std::string, render_pass::gpu_timing> s_timings;
+
 gfx::view_id generate_id()
 {
 	if(s_index == 255)
@@ -42,6 +47,21 @@ void render_pass::bind(const frame_buffer* fb) const
 	touch(id);
 }
 
+void render_pass::bind(const frame_buffer* fb, const urect& rect) const
+{
+	if(fb == nullptr)
+	{
+		return;
+	}
+
+	set_view_rect(id, std::uint16_t(rect.left), std::uint16_t(rect.top), std::uint16_t(rect.width()),
+				  std::uint16_t(rect.height()));
+	set_view_scissor(id, std::uint16_t(rect.left), std::uint16_t(rect.top), std::uint16_t(rect.width()),
+					 std::uint16_t(rect.height()));
+	set_view_frame_buffer(id, fb->native_handle());
+	touch(id);
+}
+
 void render_pass::bind() const
 {
 	std::uint16_t width = 0;
@@ -82,4 +102,38 @@ gfx::view_id render_pass::get_pass()
 {
 	return s_last_index;
 }
+
+void render_pass::gather_gpu_timings()
+{
+	const auto* stats = get_stats();
+	if(stats == nullptr || stats->numViews == 0)
+	{
+		return;
+	}
+
+	// timer frequencies are reported per backend
+	const double to_gpu_ms = stats->gpuTimerFreq != 0 ? 1000.0 / double(stats->gpuTimerFreq) : 0.0;
+	const double to_cpu_ms = stats->cpuTimerFreq != 0 ? 1000.0 / double(stats->cpuTimerFreq) : 0.0;
+
+	std::unordered_map<std::string, gpu_timing> timings;
+	for(std::uint32_t i = 0; i < stats->numViews; ++i)
+	{
+		const auto& view_stats = stats->viewStats[i];
+		// several passes can share a name (e.g. one per shadow cascade) -
+		// they aggregate under it
+		auto& timing = timings[view_stats.name];
+		timing.gpu_time_ms += double(view_stats.gpuTimeElapsed) * to_gpu_ms;
+		timing.cpu_time_ms += double(view_stats.cpuTimeElapsed) * to_cpu_ms;
+		++timing.pass_count;
+	}
+
+	std::lock_guard<std::mutex> lock(s_timings_mutex);
+	s_timings = std::move(timings);
+}
+
+std::unordered_map<std::string, render_pass::gpu_timing> render_pass::get_gpu_timings()
+{
+	std::lock_guard<std::mutex> lock(s_timings_mutex);
+	return s_timings;
+}
 }
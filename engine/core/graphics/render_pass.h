@@ -28,6 +28,16 @@ struct render_pass
 	//-----------------------------------------------------------------------------
 	void bind(const frame_buffer* fb) const;
 	void bind() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : bind ()
+	/// <summary>
+	/// Binds the frame buffer with the view rect and scissor restricted
+	/// to the given sub-rectangle, for atlas-style targets where several
+	/// views share one frame buffer.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void bind(const frame_buffer* fb, const urect& rect) const;
 	//-----------------------------------------------------------------------------
 	//  Name : clear ()
 	/// <summary>
@@ -78,6 +88,37 @@ struct render_pass
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	static gfx::view_id get_pass();
+
+	/// per-pass timing of the most recent frame with results available
+	struct gpu_timing
+	{
+		/// time the gpu spent in views with this name
+		double gpu_time_ms = 0.0;
+		/// time the render thread spent submitting them
+		double cpu_time_ms = 0.0;
+		/// views aggregated under this name this frame
+		std::uint32_t pass_count = 0;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : gather_gpu_timings ()
+	/// <summary>
+	/// Reads the backend's per-view timer queries and aggregates them by
+	/// pass name. Call once per frame right after the frame is kicked -
+	/// the backend reports a view's timings a few frames after
+	/// submission, so the table always lags slightly behind.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	static void gather_gpu_timings();
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_gpu_timings ()
+	/// <summary>
+	/// The last gathered pass-name timing table, for perf HUDs.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	static std::unordered_map<std::string, gpu_timing> get_gpu_timings();
+
 	///
 	gfx::view_id id;
 };
@@ -0,0 +1,84 @@
+#include "render_target_pool.h"
+#include "graphics.h"
+
+#include <algorithm>
+
+namespace gfx
+{
+static bool matches(const texture_info& lhs, const texture_info& rhs)
+{
+	return lhs.format == rhs.format && lhs.width == rhs.width && lhs.height == rhs.height &&
+		   lhs.depth == rhs.depth && lhs.numLayers == rhs.numLayers && lhs.numMips == rhs.numMips &&
+		   lhs.cubeMap == rhs.cubeMap;
+}
+
+std::shared_ptr<texture> render_target_pool::acquire(const texture_info& info, std::uint32_t flags,
+													 backbuffer_ratio ratio)
+{
+	for(auto it = _pooled.begin(); it != _pooled.end(); ++it)
+	{
+		if(it->flags != flags || it->ratio != ratio || !matches(it->info, info))
+			continue;
+
+		auto tex = it->tex;
+		_pooled_bytes -= it->info.storageSize;
+		_pooled.erase(it);
+		return tex;
+	}
+
+	return nullptr;
+}
+
+void render_target_pool::release(std::shared_ptr<texture> tex, const texture_info& info, std::uint32_t flags,
+								 backbuffer_ratio ratio)
+{
+	if(!tex)
+		return;
+
+	pooled_target entry;
+	entry.tex = std::move(tex);
+	entry.info = info;
+	entry.flags = flags;
+	entry.ratio = ratio;
+	entry.last_used_frame = get_render_frame();
+	_pooled_bytes += info.storageSize;
+	_pooled.push_back(std::move(entry));
+
+	evict();
+}
+
+void render_target_pool::set_memory_budget(std::uint64_t bytes)
+{
+	_budget = bytes;
+	evict();
+}
+
+std::uint64_t render_target_pool::get_memory_budget() const
+{
+	return _budget;
+}
+
+std::uint64_t render_target_pool::get_pooled_memory() const
+{
+	return _pooled_bytes;
+}
+
+void render_target_pool::evict()
+{
+	while(_pooled_bytes > _budget && !_pooled.empty())
+	{
+		auto oldest = std::min_element(_pooled.begin(), _pooled.end(),
+									   [](const pooled_target& lhs, const pooled_target& rhs) {
+										   return lhs.last_used_frame < rhs.last_used_frame;
+									   });
+		_pooled_bytes -= oldest->info.storageSize;
+		_pooled.erase(oldest);
+	}
+}
+
+render_target_pool& get_render_target_pool()
+{
+	static render_target_pool pool;
+	return pool;
+}
+}
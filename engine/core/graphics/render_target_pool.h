@@ -0,0 +1,91 @@
+#pragma once
+
+#include "texture.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace gfx
+{
+
+//-----------------------------------------------------------------------------
+//  Name : render_target_pool (Class)
+/// <summary>
+/// Process-wide pool of idle render targets, bucketed by size, format,
+/// creation flags and back buffer ratio. render_view instances return
+/// targets here instead of destroying them, so a probe or split-screen
+/// camera that needs the same shape of target a frame later reuses GPU
+/// memory instead of allocating its own. Idle memory is capped by a
+/// configurable budget with least-recently-used eviction.
+/// </summary>
+//-----------------------------------------------------------------------------
+class render_target_pool
+{
+public:
+	//-----------------------------------------------------------------------------
+	//  Name : acquire ()
+	/// <summary>
+	/// Hands out a pooled target matching the description, or null when the
+	/// pool has none; the caller then creates one as usual.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::shared_ptr<texture> acquire(const texture_info& info, std::uint32_t flags, backbuffer_ratio ratio);
+
+	//-----------------------------------------------------------------------------
+	//  Name : release ()
+	/// <summary>
+	/// Returns an unused target to the pool and evicts the least recently
+	/// used entries while the idle memory exceeds the budget.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void release(std::shared_ptr<texture> tex, const texture_info& info, std::uint32_t flags,
+				 backbuffer_ratio ratio);
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_memory_budget ()
+	/// <summary>
+	/// Caps how much GPU memory idle pooled targets may hold.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_memory_budget(std::uint64_t bytes);
+
+	std::uint64_t get_memory_budget() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_pooled_memory ()
+	/// <summary>
+	/// GPU memory currently held by idle targets in the pool.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::uint64_t get_pooled_memory() const;
+
+private:
+	struct pooled_target
+	{
+		std::shared_ptr<texture> tex;
+		/// bucket description the target was created with
+		texture_info info;
+		std::uint32_t flags = 0;
+		backbuffer_ratio ratio = backbuffer_ratio::Count;
+		/// render frame the target last saw use, for LRU ordering
+		std::uint64_t last_used_frame = 0;
+	};
+
+	void evict();
+
+	/// idle targets available for reuse
+	std::vector<pooled_target> _pooled;
+	/// bytes currently held by the idle targets
+	std::uint64_t _pooled_bytes = 0;
+	/// idle memory cap
+	std::uint64_t _budget = 512u * 1024u * 1024u;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : get_render_target_pool ()
+/// <summary>
+/// The pool shared by every render_view.
+/// </summary>
+//-----------------------------------------------------------------------------
+render_target_pool& get_render_target_pool();
+}
@@ -1,4 +1,5 @@
 #include "render_view.h"
+#include "render_target_pool.h"
 
 namespace gfx
 {
@@ -24,7 +25,10 @@ std::shared_ptr<texture> render_view::get_texture(const std::string& id, std::ui
 	}
 	else
 	{
-		tex = std::make_shared<texture>(_width, _height, _hasMips, _numLayers, _format, _flags, _mem);
+		if(_mem == nullptr)
+			tex = get_render_target_pool().acquire(key.info, _flags, key.ratio);
+		if(!tex)
+			tex = std::make_shared<texture>(_width, _height, _hasMips, _numLayers, _format, _flags, _mem);
 		_textures[key] = std::pair<std::shared_ptr<texture>, bool>(tex, true);
 	}
 
@@ -54,7 +58,9 @@ std::shared_ptr<texture> render_view::get_texture(const std::string& id, backbuf
 	}
 	else
 	{
-		tex = std::make_shared<texture>(_ratio, _hasMips, _numLayers, _format, _flags);
+		tex = get_render_target_pool().acquire(key.info, _flags, key.ratio);
+		if(!tex)
+			tex = std::make_shared<texture>(_ratio, _hasMips, _numLayers, _format, _flags);
 		_textures[key] = std::pair<std::shared_ptr<texture>, bool>(tex, true);
 	}
 
@@ -82,7 +88,10 @@ std::shared_ptr<texture> render_view::get_texture(const std::string& id, std::ui
 	}
 	else
 	{
-		tex = std::make_shared<texture>(_width, _height, _depth, _hasMips, _format, _flags, _mem);
+		if(_mem == nullptr)
+			tex = get_render_target_pool().acquire(key.info, _flags, key.ratio);
+		if(!tex)
+			tex = std::make_shared<texture>(_width, _height, _depth, _hasMips, _format, _flags, _mem);
 		_textures[key] = std::pair<std::shared_ptr<texture>, bool>(tex, true);
 	}
 
@@ -109,7 +118,10 @@ std::shared_ptr<texture> render_view::get_texture(const std::string& id, std::ui
 	}
 	else
 	{
-		tex = std::make_shared<texture>(_size, _hasMips, _numLayers, _format, _flags, _mem);
+		if(_mem == nullptr)
+			tex = get_render_target_pool().acquire(key.info, _flags, key.ratio);
+		if(!tex)
+			tex = std::make_shared<texture>(_size, _hasMips, _numLayers, _format, _flags, _mem);
 		_textures[key] = std::pair<std::shared_ptr<texture>, bool>(tex, true);
 	}
 
@@ -138,6 +150,35 @@ std::shared_ptr<frame_buffer> render_view::get_fbo(const std::string& id,
 	return tex;
 }
 
+std::shared_ptr<frame_buffer> render_view::get_fbo(const std::string& id,
+												   const std::vector<fbo_attachment>& bind_attachments)
+{
+	// Attachments targeting different mips/layers of the same textures must
+	// come in under different ids since the key only stores the textures.
+	fbo_key key;
+	key.id = id;
+	key.textures.reserve(bind_attachments.size());
+	for(const auto& attachment : bind_attachments)
+	{
+		key.textures.push_back(attachment.texture);
+	}
+
+	std::shared_ptr<frame_buffer> tex;
+	auto it = _fbos.find(key);
+	if(it != _fbos.end())
+	{
+		tex = it->second.first;
+		it->second.second = true;
+	}
+	else
+	{
+		tex = std::make_shared<frame_buffer>(bind_attachments);
+		_fbos[key] = std::pair<std::shared_ptr<frame_buffer>, bool>(tex, true);
+	}
+
+	return tex;
+}
+
 std::shared_ptr<texture> render_view::get_depth_stencil_buffer(const usize& viewport_size)
 {
 	static auto format =
@@ -161,10 +202,16 @@ std::shared_ptr<frame_buffer> render_view::get_g_buffer_fbo(const usize& viewpor
 	static auto format =
 		get_best_format(BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER,
 						format_search_flags::four_channels | format_search_flags::requires_alpha);
-	static auto normal_format =
-		get_best_format(BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER, format_search_flags::four_channels |
-																  format_search_flags::requires_alpha |
-																  format_search_flags::half_precision_float);
+	// Normals and roughness. encodeNormalUint already maps the normal into
+	// 0..1, so the bandwidth profile can drop the half float target for a
+	// plain unorm one at half the storage and fill rate.
+	auto normal_format =
+		get_gbuffer_profile() == gbuffer_profile::bandwidth
+			? get_best_format(BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER,
+							  format_search_flags::four_channels | format_search_flags::requires_alpha)
+			: get_best_format(BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER,
+							  format_search_flags::four_channels | format_search_flags::requires_alpha |
+								  format_search_flags::half_precision_float);
 	auto depth_buffer = get_depth_stencil_buffer(viewport_size);
 	auto buffer0 = get_texture("GBUFFER0", viewport_size.width, viewport_size.height, false, 1, format);
 	auto buffer1 =
@@ -198,6 +245,26 @@ void render_view::release_unused_resources()
 	};
 
 	check_resources(_fbos);
-	check_resources(_textures);
+
+	// Textures are handed to the shared pool instead of being destroyed so
+	// other views (probes, split-screen cameras) can alias the memory; the
+	// pool applies the LRU budget.
+	for(auto it = _textures.begin(); it != _textures.end();)
+	{
+		auto& item = it->second.first;
+		bool& used_last_frame = it->second.second;
+
+		if(!used_last_frame && item.use_count() == 1)
+		{
+			get_render_target_pool().release(std::move(item), it->first.info, it->first.flags,
+											 it->first.ratio);
+			it = _textures.erase(it);
+		}
+		else
+		{
+			used_last_frame = false;
+			it++;
+		}
+	}
 }
 }
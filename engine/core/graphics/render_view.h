@@ -37,6 +37,9 @@ public:
 	std::shared_ptr<frame_buffer> get_fbo(const std::string& id,
 										  const std::vector<std::shared_ptr<texture>>& bind_textures);
 
+	std::shared_ptr<frame_buffer> get_fbo(const std::string& id,
+										  const std::vector<fbo_attachment>& bind_attachments);
+
 	std::shared_ptr<texture> get_depth_stencil_buffer(const usize& viewport_size);
 	std::shared_ptr<texture> get_output_buffer(const usize& viewport_size);
 	std::shared_ptr<frame_buffer> get_output_fbo(const usize& viewport_size);
@@ -0,0 +1,186 @@
+#include "static_buffer_pool.h"
+
+#include <algorithm>
+
+namespace gfx
+{
+
+static_vertex_alloc static_buffer_pool::alloc_vertices(const vertex_layout& layout, const memory_view* mem,
+													   std::uint32_t count)
+{
+	static_vertex_alloc result;
+	if(mem == nullptr || count == 0 || _disposed)
+		return result;
+
+	const std::uint16_t stride = layout.getStride();
+
+	// Find a live block for this layout with enough room left.
+	std::uint32_t block_index = std::uint32_t(_vertex_blocks.size());
+	for(std::uint32_t i = 0; i < _vertex_blocks.size(); ++i)
+	{
+		auto& block = _vertex_blocks[i];
+		if(block.layout_hash == layout.m_hash && bgfx::isValid(block.handle) &&
+		   block.cursor + count <= block.capacity)
+		{
+			block_index = i;
+			break;
+		}
+	}
+
+	if(block_index == _vertex_blocks.size())
+	{
+		// Oversized requests get a block of their own; everything else
+		// shares the standard block size.
+		const std::uint32_t block_vertices =
+			std::max(count, _vertex_block_bytes / std::uint32_t(stride));
+		vertex_block block;
+		block.handle = create_dynamic_vertex_buffer(block_vertices, layout);
+		if(!bgfx::isValid(block.handle))
+			return result;
+		block.layout_hash = layout.m_hash;
+		block.stride = stride;
+		block.capacity = block_vertices;
+		_vertex_blocks.push_back(block);
+	}
+
+	auto& block = _vertex_blocks[block_index];
+	update_dynamic_vertex_buffer(block.handle, block.cursor, mem);
+
+	result.handle = block.handle;
+	result.base_vertex = block.cursor;
+	result.count = count;
+	result.block = block_index;
+	result.valid = true;
+
+	block.cursor += count;
+	block.live++;
+	_live_allocs++;
+	return result;
+}
+
+static_index_alloc static_buffer_pool::alloc_indices(const memory_view* mem, std::uint32_t count)
+{
+	static_index_alloc result;
+	if(mem == nullptr || count == 0 || _disposed)
+		return result;
+
+	std::uint32_t block_index = std::uint32_t(_index_blocks.size());
+	for(std::uint32_t i = 0; i < _index_blocks.size(); ++i)
+	{
+		auto& block = _index_blocks[i];
+		if(bgfx::isValid(block.handle) && block.cursor + count <= block.capacity)
+		{
+			block_index = i;
+			break;
+		}
+	}
+
+	if(block_index == _index_blocks.size())
+	{
+		const std::uint32_t block_indices =
+			std::max(count, _index_block_bytes / std::uint32_t(sizeof(std::uint32_t)));
+		index_block block;
+		block.handle = create_dynamic_index_buffer(block_indices, BGFX_BUFFER_INDEX32);
+		if(!bgfx::isValid(block.handle))
+			return result;
+		block.capacity = block_indices;
+		_index_blocks.push_back(block);
+	}
+
+	auto& block = _index_blocks[block_index];
+	update_dynamic_index_buffer(block.handle, block.cursor, mem);
+
+	result.handle = block.handle;
+	result.base_index = block.cursor;
+	result.count = count;
+	result.block = block_index;
+	result.valid = true;
+
+	block.cursor += count;
+	block.live++;
+	_live_allocs++;
+	return result;
+}
+
+void static_buffer_pool::release(const static_vertex_alloc& alloc)
+{
+	if(!alloc.valid || _disposed || alloc.block >= _vertex_blocks.size())
+		return;
+
+	auto& block = _vertex_blocks[alloc.block];
+	if(block.live > 0)
+		block.live--;
+	if(_live_allocs > 0)
+		_live_allocs--;
+
+	// Whole-block recycle - once the last allocation goes the bump
+	// cursor rewinds and the reservation serves the next load.
+	if(block.live == 0)
+		block.cursor = 0;
+}
+
+void static_buffer_pool::release(const static_index_alloc& alloc)
+{
+	if(!alloc.valid || _disposed || alloc.block >= _index_blocks.size())
+		return;
+
+	auto& block = _index_blocks[alloc.block];
+	if(block.live > 0)
+		block.live--;
+	if(_live_allocs > 0)
+		_live_allocs--;
+
+	if(block.live == 0)
+		block.cursor = 0;
+}
+
+void static_buffer_pool::dispose()
+{
+	for(auto& block : _vertex_blocks)
+	{
+		if(bgfx::isValid(block.handle))
+			destroy(block.handle);
+	}
+	_vertex_blocks.clear();
+
+	for(auto& block : _index_blocks)
+	{
+		if(bgfx::isValid(block.handle))
+			destroy(block.handle);
+	}
+	_index_blocks.clear();
+
+	_live_allocs = 0;
+	_disposed = true;
+}
+
+static_buffer_pool::stats static_buffer_pool::get_stats() const
+{
+	stats result;
+	for(const auto& block : _vertex_blocks)
+	{
+		result.blocks++;
+		result.reserved_bytes += std::uint64_t(block.capacity) * block.stride;
+		result.allocated_bytes += std::uint64_t(block.cursor) * block.stride;
+	}
+	for(const auto& block : _index_blocks)
+	{
+		result.blocks++;
+		result.reserved_bytes += std::uint64_t(block.capacity) * sizeof(std::uint32_t);
+		result.allocated_bytes += std::uint64_t(block.cursor) * sizeof(std::uint32_t);
+	}
+	result.live_allocs = _live_allocs;
+	return result;
+}
+
+static_buffer_pool& get_static_buffer_pool()
+{
+	static static_buffer_pool s_pool;
+	return s_pool;
+}
+
+void release_static_buffer_pool()
+{
+	get_static_buffer_pool().dispose();
+}
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "graphics.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace gfx
+{
+
+/// Suballocation of static vertex data within a shared pool block. The
+/// handle is shared with other meshes using the same vertex layout;
+/// base_vertex is this allocation's first vertex within the block and is
+/// passed as the start vertex at bind time, so index values stay relative
+/// to the owning mesh.
+struct static_vertex_alloc
+{
+	dynamic_vertex_buffer_handle handle = {invalid_handle};
+	/// first vertex of the allocation within the shared block
+	std::uint32_t base_vertex = 0;
+	/// vertices in the allocation
+	std::uint32_t count = 0;
+	/// block the allocation came from; used by release()
+	std::uint32_t block = 0;
+	/// false when the pool could not service the request
+	bool valid = false;
+};
+
+/// Suballocation of static 32-bit index data within a shared pool block.
+struct static_index_alloc
+{
+	dynamic_index_buffer_handle handle = {invalid_handle};
+	/// first index of the allocation within the shared block
+	std::uint32_t base_index = 0;
+	/// 32-bit indices in the allocation
+	std::uint32_t count = 0;
+	/// block the allocation came from; used by release()
+	std::uint32_t block = 0;
+	/// false when the pool could not service the request
+	bool valid = false;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : static_buffer_pool (Class)
+/// <summary>
+/// Shared buffer pool for static mesh geometry. Meshes suballocate
+/// ranges of large per-layout vertex blocks and shared index blocks
+/// instead of owning one small buffer pair each, so consecutive draws
+/// from the same pool bind the same handles and the driver skips the
+/// rebind; the recorded offsets also leave the door open for multi-draw
+/// batching later. Blocks are bump-allocated; a block's storage is
+/// recycled as a whole once every allocation made from it has been
+/// released, which matches the level-load / level-unload lifetime of
+/// static geometry without the cost of a general purpose allocator.
+/// Requests larger than the standard block size get a dedicated block.
+/// </summary>
+//-----------------------------------------------------------------------------
+class static_buffer_pool
+{
+public:
+	struct stats
+	{
+		/// blocks currently alive (vertex + index)
+		std::uint32_t blocks = 0;
+		/// bytes reserved by all blocks
+		std::uint64_t reserved_bytes = 0;
+		/// bytes of the reservation handed out to live allocations
+		std::uint64_t allocated_bytes = 0;
+		/// live suballocations
+		std::uint32_t live_allocs = 0;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : alloc_vertices ()
+	/// <summary>
+	/// Suballocates and uploads count vertices of the given layout,
+	/// consuming mem. Check valid on the result; a false return means the
+	/// caller should fall back to a dedicated buffer.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	static_vertex_alloc alloc_vertices(const vertex_layout& layout, const memory_view* mem,
+									   std::uint32_t count);
+
+	//-----------------------------------------------------------------------------
+	//  Name : alloc_indices ()
+	/// <summary>
+	/// Suballocates and uploads count 32-bit indices, consuming mem.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	static_index_alloc alloc_indices(const memory_view* mem, std::uint32_t count);
+
+	//-----------------------------------------------------------------------------
+	//  Name : release ()
+	/// <summary>
+	/// Returns an allocation to its block. The block's storage is only
+	/// recycled once all of its allocations have been released. Safe to
+	/// call with an invalid allocation or after the pool has shut down.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void release(const static_vertex_alloc& alloc);
+	void release(const static_index_alloc& alloc);
+
+	//-----------------------------------------------------------------------------
+	//  Name : dispose ()
+	/// <summary>
+	/// Destroys every block. Called during graphics shutdown while the
+	/// device is still alive; later release() calls become no-ops.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void dispose();
+
+	stats get_stats() const;
+
+private:
+	struct vertex_block
+	{
+		dynamic_vertex_buffer_handle handle = {invalid_handle};
+		/// layout hash the block serves
+		std::uint32_t layout_hash = 0;
+		std::uint16_t stride = 0;
+		/// vertices the block can hold
+		std::uint32_t capacity = 0;
+		/// vertices handed out so far
+		std::uint32_t cursor = 0;
+		/// live allocations; the cursor rewinds when this reaches zero
+		std::uint32_t live = 0;
+	};
+
+	struct index_block
+	{
+		dynamic_index_buffer_handle handle = {invalid_handle};
+		std::uint32_t capacity = 0;
+		std::uint32_t cursor = 0;
+		std::uint32_t live = 0;
+	};
+
+	/// vertex blocks for every layout; allocations search only blocks
+	/// whose layout hash matches
+	std::vector<vertex_block> _vertex_blocks;
+	std::vector<index_block> _index_blocks;
+
+	/// standard block sizes; oversized requests get a dedicated block
+	std::uint32_t _vertex_block_bytes = 8 * 1024 * 1024;
+	std::uint32_t _index_block_bytes = 4 * 1024 * 1024;
+
+	std::uint32_t _live_allocs = 0;
+
+	/// set by dispose(); turns later release() calls into no-ops
+	bool _disposed = false;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : get_static_buffer_pool ()
+/// <summary>
+/// Process-wide instance shared by every static mesh.
+/// </summary>
+//-----------------------------------------------------------------------------
+static_buffer_pool& get_static_buffer_pool();
+
+//-----------------------------------------------------------------------------
+//  Name : release_static_buffer_pool ()
+/// <summary>
+/// Destroys the pool's blocks. Must run before the device goes away.
+/// </summary>
+//-----------------------------------------------------------------------------
+void release_static_buffer_pool();
+}
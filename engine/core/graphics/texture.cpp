@@ -1,4 +1,8 @@
 #include "texture.h"
+#include "../memory/memory_tracker.h"
+
+#include <bimg/bimg.h>
+#include <bx/allocator.h>
 
 namespace gfx
 {
@@ -17,6 +21,9 @@ texture::texture(const memory_view* _mem, std::uint32_t _flags /*= BGFX_TEXTURE_
 
 	flags = _flags;
 	ratio = backbuffer_ratio::Count;
+
+	tracked_size = info.storageSize;
+	memory::memory_tracker::get().record_alloc("gfx/textures", tracked_size);
 }
 
 texture::texture(std::uint16_t _width, std::uint16_t _height, bool _hasMips, std::uint16_t _numLayers,
@@ -29,6 +36,9 @@ texture::texture(std::uint16_t _width, std::uint16_t _height, bool _hasMips, std
 
 	flags = _flags;
 	ratio = backbuffer_ratio::Count;
+
+	tracked_size = info.storageSize;
+	memory::memory_tracker::get().record_alloc("gfx/textures", tracked_size);
 }
 
 texture::texture(std::uint16_t _width, std::uint16_t _height, std::uint16_t _depth, bool _hasMips,
@@ -41,6 +51,9 @@ texture::texture(std::uint16_t _width, std::uint16_t _height, std::uint16_t _dep
 
 	flags = _flags;
 	ratio = backbuffer_ratio::Count;
+
+	tracked_size = info.storageSize;
+	memory::memory_tracker::get().record_alloc("gfx/textures", tracked_size);
 }
 
 texture::texture(std::uint16_t _size, bool _hasMips, std::uint16_t _numLayers, texture_format _format,
@@ -52,6 +65,9 @@ texture::texture(std::uint16_t _size, bool _hasMips, std::uint16_t _numLayers, t
 
 	flags = _flags;
 	ratio = backbuffer_ratio::Count;
+
+	tracked_size = info.storageSize;
+	memory::memory_tracker::get().record_alloc("gfx/textures", tracked_size);
 }
 
 texture::texture(backbuffer_ratio _ratio, bool _hasMips, std::uint16_t _numLayers, texture_format _format,
@@ -66,6 +82,69 @@ texture::texture(backbuffer_ratio _ratio, bool _hasMips, std::uint16_t _numLayer
 
 	flags = _flags;
 	ratio = _ratio;
+
+	tracked_size = info.storageSize;
+	memory::memory_tracker::get().record_alloc("gfx/textures", tracked_size);
+}
+
+texture::~texture()
+{
+	if(tracked_size != 0)
+		memory::memory_tracker::get().record_free("gfx/textures", tracked_size);
+}
+
+bool texture::update(const std::uint8_t* _data, std::uint32_t _size)
+{
+	if(!is_valid() || is_render_target())
+		return false;
+
+	static bx::DefaultAllocator allocator;
+	bimg::ImageContainer* container = bimg::imageParse(&allocator, _data, _size);
+	if(nullptr == container)
+		return false;
+
+	const bool layout_matches =
+		container->m_width == info.width && container->m_height == info.height &&
+		container->m_depth == info.depth && container->m_numLayers == info.numLayers &&
+		container->m_numMips == info.numMips && container->m_cubeMap == info.cubeMap &&
+		static_cast<texture_format>(container->m_format) == info.format;
+
+	if(!layout_matches)
+	{
+		bimg::imageFree(container);
+		return false;
+	}
+
+	const std::uint16_t num_sides = container->m_numLayers * (container->m_cubeMap ? 6 : 1);
+	for(std::uint16_t side = 0; side < num_sides; ++side)
+	{
+		for(std::uint8_t lod = 0; lod < container->m_numMips; ++lod)
+		{
+			bimg::ImageMip mip;
+			if(!bimg::imageGetRawData(*container, side, lod, container->m_data, container->m_size, mip))
+				continue;
+
+			const memory_view* mem = copy(mip.m_data, mip.m_size);
+			if(container->m_cubeMap)
+			{
+				update_texture_cube(handle, std::uint16_t(side / 6), std::uint8_t(side % 6), lod, 0, 0,
+									std::uint16_t(mip.m_width), std::uint16_t(mip.m_height), mem);
+			}
+			else if(container->m_depth > 1)
+			{
+				update_texture_3d(handle, lod, 0, 0, 0, std::uint16_t(mip.m_width),
+								  std::uint16_t(mip.m_height), std::uint16_t(mip.m_depth), mem);
+			}
+			else
+			{
+				update_texture_2d(handle, side, lod, 0, 0, std::uint16_t(mip.m_width),
+								  std::uint16_t(mip.m_height), mem);
+			}
+		}
+	}
+
+	bimg::imageFree(container);
+	return true;
 }
 
 usize texture::get_size() const
@@ -75,6 +75,26 @@ struct texture : public handle_impl<texture_handle>
 	texture(std::uint16_t _size, bool _hasMips, std::uint16_t _numLayers, texture_format _format,
 			std::uint32_t _flags = BGFX_TEXTURE_NONE, const memory_view* _mem = nullptr);
 
+	//-----------------------------------------------------------------------------
+	//  Name : ~Texture ()
+	/// <summary>
+	/// Releases the bytes accounted to the memory tracker on creation.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	~texture();
+
+	//-----------------------------------------------------------------------------
+	//  Name : update ()
+	/// <summary>
+	/// Uploads texel data from a compiled texture container into the
+	/// existing handle when the container's dimensions, format, layer and
+	/// mip layout all match this texture. Returns false without touching
+	/// the texture when they do not - the caller recreates instead. Must
+	/// be called from a thread bgfx accepts resource updates from.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool update(const std::uint8_t* _data, std::uint32_t _size);
+
 	//-----------------------------------------------------------------------------
 	//  Name : get_size ()
 	/// <summary>
@@ -101,5 +121,7 @@ struct texture : public handle_impl<texture_handle>
 	std::uint32_t flags = BGFX_TEXTURE_NONE;
 	/// Back buffer ratio if any.
 	backbuffer_ratio ratio = backbuffer_ratio::Count;
+	/// Bytes accounted to the memory tracker for this texture.
+	std::uint32_t tracked_size = 0;
 };
 }
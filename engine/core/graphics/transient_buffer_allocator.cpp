@@ -0,0 +1,170 @@
+#include "transient_buffer_allocator.h"
+
+#include <algorithm>
+
+namespace gfx
+{
+
+transient_vertex_alloc transient_buffer_allocator::alloc_vertices(const vertex_layout& layout,
+																  std::uint32_t count)
+{
+	const auto frame = get_render_frame();
+	if(frame != _frame)
+		roll_frame(frame);
+
+	const std::uint16_t stride = layout.getStride();
+	auto& ring = _vertex_rings[layout.m_hash];
+	ring.requested += count;
+
+	transient_vertex_alloc result;
+	result.count = count;
+
+	if(ring.capacity == 0)
+	{
+		// First request of the frame for this layout - make the single
+		// frame reservation, sized from the high-water mark with some
+		// headroom, clamped to the budget and to what the pool can give.
+		std::uint32_t reserve = std::max(count, ring.peak_requested + ring.peak_requested / 4);
+		reserve = std::min(reserve, std::uint32_t(_vertex_budget / stride));
+		if(reserve >= count)
+		{
+			reserve = get_avail_transient_vertex_buffer(reserve, layout);
+			if(reserve >= count)
+			{
+				alloc_transient_vertex_buffer(&ring.buffer, reserve, layout);
+				ring.capacity = reserve;
+				ring.cursor = 0;
+			}
+		}
+	}
+
+	if(ring.capacity != 0 && ring.cursor + count <= ring.capacity)
+	{
+		result.buffer = ring.buffer;
+		result.start = ring.cursor;
+		result.valid = true;
+		ring.cursor += count;
+	}
+	else
+	{
+		// The chunk is exhausted (or could not cover the request); fall
+		// back to an ad hoc allocation so the geometry is not dropped.
+		// The request is still counted into the ring, so next frame's
+		// reservation grows to cover it.
+		++_stats.frame_overflow_allocs;
+		if(get_avail_transient_vertex_buffer(count, layout) == count)
+		{
+			alloc_transient_vertex_buffer(&result.buffer, count, layout);
+			result.start = 0;
+			result.valid = true;
+		}
+		else
+		{
+			++_stats.frame_failed_allocs;
+			++_stats.total_failed_allocs;
+		}
+	}
+
+	if(result.valid)
+		_stats.frame_vertex_bytes += count * stride;
+
+	return result;
+}
+
+transient_index_alloc transient_buffer_allocator::alloc_indices(std::uint32_t count)
+{
+	const auto frame = get_render_frame();
+	if(frame != _frame)
+		roll_frame(frame);
+
+	auto& ring = _index_ring;
+	ring.requested += count;
+
+	transient_index_alloc result;
+	result.count = count;
+
+	if(ring.capacity == 0)
+	{
+		std::uint32_t reserve = std::max(count, ring.peak_requested + ring.peak_requested / 4);
+		reserve = std::min(reserve, std::uint32_t(_index_budget / sizeof(std::uint16_t)));
+		if(reserve >= count)
+		{
+			reserve = get_avail_transient_index_buffer(reserve);
+			if(reserve >= count)
+			{
+				alloc_transient_index_buffer(&ring.buffer, reserve);
+				ring.capacity = reserve;
+				ring.cursor = 0;
+			}
+		}
+	}
+
+	if(ring.capacity != 0 && ring.cursor + count <= ring.capacity)
+	{
+		result.buffer = ring.buffer;
+		result.start = ring.cursor;
+		result.valid = true;
+		ring.cursor += count;
+	}
+	else
+	{
+		++_stats.frame_overflow_allocs;
+		if(get_avail_transient_index_buffer(count) == count)
+		{
+			alloc_transient_index_buffer(&result.buffer, count);
+			result.start = 0;
+			result.valid = true;
+		}
+		else
+		{
+			++_stats.frame_failed_allocs;
+			++_stats.total_failed_allocs;
+		}
+	}
+
+	if(result.valid)
+		_stats.frame_index_bytes += count * std::uint32_t(sizeof(std::uint16_t));
+
+	return result;
+}
+
+void transient_buffer_allocator::set_budget(std::uint32_t vertex_bytes, std::uint32_t index_bytes)
+{
+	_vertex_budget = vertex_bytes;
+	_index_budget = index_bytes;
+}
+
+void transient_buffer_allocator::roll_frame(std::uint64_t frame)
+{
+	_stats.peak_vertex_bytes = std::max(_stats.peak_vertex_bytes, _stats.frame_vertex_bytes);
+	_stats.peak_index_bytes = std::max(_stats.peak_index_bytes, _stats.frame_index_bytes);
+	_stats.frame_vertex_bytes = 0;
+	_stats.frame_index_bytes = 0;
+	_stats.frame_overflow_allocs = 0;
+	_stats.frame_failed_allocs = 0;
+
+	// Transient memory only lives for the frame it was allocated in, so
+	// every chunk is re-reserved on first use of the new frame.
+	for(auto& pair : _vertex_rings)
+	{
+		auto& ring = pair.second;
+		ring.peak_requested = std::max(ring.peak_requested, ring.requested);
+		ring.requested = 0;
+		ring.capacity = 0;
+		ring.cursor = 0;
+	}
+
+	_index_ring.peak_requested = std::max(_index_ring.peak_requested, _index_ring.requested);
+	_index_ring.requested = 0;
+	_index_ring.capacity = 0;
+	_index_ring.cursor = 0;
+
+	_frame = frame;
+}
+
+transient_buffer_allocator& get_transient_buffer_allocator()
+{
+	static transient_buffer_allocator allocator;
+	return allocator;
+}
+}
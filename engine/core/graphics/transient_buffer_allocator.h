@@ -0,0 +1,168 @@
+#pragma once
+
+#include "graphics.h"
+#include <cstdint>
+#include <unordered_map>
+
+namespace gfx
+{
+
+/// Sub-range of the per-frame transient ring handed to a caller. The
+/// buffer is shared with other allocations of the same vertex layout;
+/// start/count address this caller's slice both for writing (data())
+/// and for set_vertex_buffer / set_index_buffer at submit time.
+struct transient_vertex_alloc
+{
+	transient_vertex_buffer buffer;
+	/// first vertex of the slice, relative to the buffer
+	std::uint32_t start = 0;
+	/// vertices in the slice
+	std::uint32_t count = 0;
+	/// false when the allocation failed outright; no geometry to write
+	bool valid = false;
+
+	std::uint8_t* data() const
+	{
+		return buffer.data + std::uint32_t(start) * buffer.stride;
+	}
+};
+
+struct transient_index_alloc
+{
+	transient_index_buffer buffer;
+	/// first index of the slice, relative to the buffer
+	std::uint32_t start = 0;
+	/// 16-bit indices in the slice
+	std::uint32_t count = 0;
+	/// false when the allocation failed outright; no geometry to write
+	bool valid = false;
+
+	std::uint8_t* data() const
+	{
+		return buffer.data + start * sizeof(std::uint16_t);
+	}
+};
+
+//-----------------------------------------------------------------------------
+//  Name : transient_buffer_allocator (Class)
+/// <summary>
+/// Per-frame ring allocator over the bgfx transient pools for dynamic
+/// geometry (GUI, debug draw, software-rendered meshes). One chunk per
+/// vertex layout is reserved per frame - sized from the high-water mark
+/// of previous frames - and callers receive suballocated slices, so the
+/// frame makes one reservation per layout instead of an ad hoc alloc
+/// per draw. Requests that outgrow the chunk fall back to a direct
+/// allocation and are counted, never silently dropped; outright
+/// failures are counted too. The stats expose frame usage, high-water
+/// marks and failure counters for sizing the budget to worst-case
+/// frames.
+/// </summary>
+//-----------------------------------------------------------------------------
+class transient_buffer_allocator
+{
+public:
+	struct stats
+	{
+		/// vertex/index bytes handed out during the current frame
+		std::uint32_t frame_vertex_bytes = 0;
+		std::uint32_t frame_index_bytes = 0;
+		/// largest per-frame usage observed (high-water marks)
+		std::uint32_t peak_vertex_bytes = 0;
+		std::uint32_t peak_index_bytes = 0;
+		/// requests this frame that outgrew their reserved chunk
+		std::uint32_t frame_overflow_allocs = 0;
+		/// requests that failed because the bgfx pool was exhausted
+		std::uint32_t frame_failed_allocs = 0;
+		std::uint32_t total_failed_allocs = 0;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : alloc_vertices ()
+	/// <summary>
+	/// Suballocates vertices from this frame's chunk for the layout,
+	/// reserving the chunk on the layout's first request of the frame.
+	/// Check valid on the result - a false return means even the
+	/// fallback allocation failed.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	transient_vertex_alloc alloc_vertices(const vertex_layout& layout, std::uint32_t count);
+
+	//-----------------------------------------------------------------------------
+	//  Name : alloc_indices ()
+	/// <summary>
+	/// Suballocates 16-bit indices from this frame's index chunk.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	transient_index_alloc alloc_indices(std::uint32_t count);
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_budget ()
+	/// <summary>
+	/// Caps the bytes the per-frame reservations may claim from the
+	/// bgfx transient pools. Requests beyond the budget still succeed
+	/// through the overflow path while the pools have room.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_budget(std::uint32_t vertex_bytes, std::uint32_t index_bytes);
+
+	const stats& get_stats() const
+	{
+		return _stats;
+	}
+
+private:
+	struct vertex_ring
+	{
+		transient_vertex_buffer buffer;
+		/// vertices reserved for this frame (0 = not reserved yet)
+		std::uint32_t capacity = 0;
+		/// vertices handed out of the reservation so far
+		std::uint32_t cursor = 0;
+		/// vertices requested this frame, reserved or not
+		std::uint32_t requested = 0;
+		/// largest per-frame request total seen; drives next reservation
+		std::uint32_t peak_requested = 0;
+	};
+
+	struct index_ring
+	{
+		transient_index_buffer buffer;
+		std::uint32_t capacity = 0;
+		std::uint32_t cursor = 0;
+		std::uint32_t requested = 0;
+		std::uint32_t peak_requested = 0;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : roll_frame ()
+	/// <summary>
+	/// Folds the finished frame's usage into the high-water marks and
+	/// resets the per-frame chunks and counters.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void roll_frame(std::uint64_t frame);
+
+	/// per-layout vertex chunks, keyed by the layout hash
+	std::unordered_map<std::uint32_t, vertex_ring> _vertex_rings;
+	index_ring _index_ring;
+
+	/// render frame the chunks belong to
+	std::uint64_t _frame = std::uint64_t(-1);
+
+	/// reservation caps; overflow beyond them is ad hoc
+	std::uint32_t _vertex_budget = 4 * 1024 * 1024;
+	std::uint32_t _index_budget = 1 * 1024 * 1024;
+
+	stats _stats;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : get_transient_buffer_allocator ()
+/// <summary>
+/// Process-wide instance, shared by every dynamic-geometry producer.
+/// Like the rest of the submission api it belongs to the rendering
+/// thread.
+/// </summary>
+//-----------------------------------------------------------------------------
+transient_buffer_allocator& get_transient_buffer_allocator();
+}
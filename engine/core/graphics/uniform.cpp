@@ -1,5 +1,10 @@
 #include "uniform.h"
 
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 namespace gfx
 {
 
@@ -14,4 +19,57 @@ uniform::uniform(handle_type_t _handle)
 	gfx::get_uniform_info(_handle, info);
 	handle = gfx::create_uniform(info.name, info.type, info.num);
 }
+
+namespace
+{
+/// Process-wide uniform registry. A deque keeps entries at stable
+/// addresses while registration grows it, so the per-draw getter can
+/// index without taking the registration lock.
+struct uniform_registry
+{
+	std::mutex mutex;
+	std::unordered_map<std::uint32_t, uniform_id> by_hash;
+	std::deque<std::unique_ptr<uniform>> entries;
+};
+
+uniform_registry& get_registry()
+{
+	static uniform_registry registry;
+	return registry;
+}
+}
+
+uniform_id register_uniform(std::uint32_t _name_hash, const char* _name, uniform_type _type,
+							std::uint16_t _num /*= 1*/)
+{
+	auto& registry = get_registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+
+	auto it = registry.by_hash.find(_name_hash);
+	if(it != registry.by_hash.end())
+		return it->second;
+
+	const auto id = uniform_id(registry.entries.size());
+	registry.entries.emplace_back(std::make_unique<uniform>(_name, _type, _num));
+	registry.by_hash.emplace(_name_hash, id);
+	return id;
+}
+
+const uniform& get_registered_uniform(uniform_id _id)
+{
+	return *get_registry().entries[_id];
+}
+
+void set_registered_uniform(uniform_id _id, const void* _value, std::uint16_t _num /*= 1*/)
+{
+	gfx::set_uniform(get_registered_uniform(_id).native_handle(), _value, _num);
+}
+
+void release_uniform_registry()
+{
+	auto& registry = get_registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.entries.clear();
+	registry.by_hash.clear();
+}
 }
@@ -1,10 +1,27 @@
 #pragma once
 
 #include "handle_impl.h"
+#include <cstdint>
+#include <memory>
 #include <string>
 
 namespace gfx
 {
+//-----------------------------------------------------------------------------
+//  Name : uniform_hash ()
+/// <summary>
+/// Compile-time FNV-1a hash of a uniform name. With a string literal the
+/// whole call folds to a constant, so hashed call sites carry a number
+/// instead of a string.
+/// </summary>
+//-----------------------------------------------------------------------------
+constexpr std::uint32_t uniform_hash(const char* _name, std::uint32_t _hash = 2166136261u)
+{
+	return *_name == 0
+			   ? _hash
+			   : uniform_hash(_name + 1, (_hash ^ std::uint32_t(std::uint8_t(*_name))) * 16777619u);
+}
+
 struct uniform : public handle_impl<uniform_handle>
 {
 	uniform() = default;
@@ -31,4 +48,47 @@ struct uniform : public handle_impl<uniform_handle>
 	/// Uniform info
 	uniform_info info;
 };
+
+/// Index into the process-wide uniform registry.
+using uniform_id = std::uint32_t;
+
+//-----------------------------------------------------------------------------
+//  Name : register_uniform ()
+/// <summary>
+/// Resolves a hashed uniform name against the process-wide registry,
+/// creating the uniform on first request. bgfx uniforms are global per
+/// name, so one registry entry serves every program referencing the name.
+/// The returned id stays valid until shutdown - cache it and bind through
+/// it instead of repeating string-keyed lookups per draw.
+/// </summary>
+//-----------------------------------------------------------------------------
+uniform_id register_uniform(std::uint32_t _name_hash, const char* _name, uniform_type _type,
+							std::uint16_t _num = 1);
+
+//-----------------------------------------------------------------------------
+//  Name : get_registered_uniform ()
+/// <summary>
+/// Looks a registered uniform up by id - a plain array index, meant for
+/// the per-draw path. Ids must come from register_uniform. Like the rest
+/// of the submission api this is intended for the rendering thread.
+/// </summary>
+//-----------------------------------------------------------------------------
+const uniform& get_registered_uniform(uniform_id _id);
+
+//-----------------------------------------------------------------------------
+//  Name : set_registered_uniform ()
+/// <summary>
+/// Binds a registered uniform's value for the next submit.
+/// </summary>
+//-----------------------------------------------------------------------------
+void set_registered_uniform(uniform_id _id, const void* _value, std::uint16_t _num = 1);
+
+//-----------------------------------------------------------------------------
+//  Name : release_uniform_registry ()
+/// <summary>
+/// Destroys every registered uniform. Called while the device is still
+/// alive (gfx::shutdown), after which all uniform ids go stale.
+/// </summary>
+//-----------------------------------------------------------------------------
+void release_uniform_registry();
 }
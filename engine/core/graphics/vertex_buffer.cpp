@@ -1,4 +1,5 @@
 #include "vertex_buffer.h"
+#include "../memory/memory_tracker.h"
 
 namespace gfx
 {
@@ -7,5 +8,17 @@ vertex_buffer::vertex_buffer(const memory_view* _mem, const vertex_layout& _decl
 							 std::uint16_t _flags /*= BGFX_BUFFER_NONE*/)
 {
 	handle = create_vertex_buffer(_mem, _decl, _flags);
+
+	if(_mem != nullptr)
+	{
+		tracked_size = _mem->size;
+		memory::memory_tracker::get().record_alloc("gfx/vertex_buffers", tracked_size);
+	}
+}
+
+vertex_buffer::~vertex_buffer()
+{
+	if(tracked_size != 0)
+		memory::memory_tracker::get().record_free("gfx/vertex_buffers", tracked_size);
 }
 }
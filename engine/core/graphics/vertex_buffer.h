@@ -17,5 +17,16 @@ struct vertex_buffer : public handle_impl<vertex_buffer_handle>
 	//-----------------------------------------------------------------------------
 	vertex_buffer(const memory_view* _mem, const vertex_layout& _decl,
 				  std::uint16_t _flags = BGFX_BUFFER_NONE);
+
+	//-----------------------------------------------------------------------------
+	//  Name : ~vertex_buffer ()
+	/// <summary>
+	/// Releases the bytes accounted to the memory tracker on creation.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	~vertex_buffer();
+
+	/// Bytes accounted to the memory tracker for this buffer.
+	std::uint32_t tracked_size = 0;
 };
 }
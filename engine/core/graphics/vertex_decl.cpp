@@ -1,7 +1,26 @@
 #include "vertex_decl.h"
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 namespace gfx
 {
+const vertex_layout& get_canonical_layout(const vertex_layout& layout)
+{
+	// Keyed by the murmur hash end() computes over the attribute
+	// description - the same key bgfx uses for its own decl registry.
+	static std::mutex s_mutex;
+	static std::unordered_map<std::uint32_t, std::unique_ptr<vertex_layout>> s_registry;
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+	auto& entry = s_registry[layout.m_hash];
+	if(!entry)
+		entry = std::make_unique<vertex_layout>(layout);
+
+	return *entry;
+}
+
 void pos_texcoord0_vertex::init(gfx::vertex_layout& decl)
 {
 	decl.begin()
@@ -22,6 +41,18 @@ void mesh_vertex::init(vertex_layout& decl)
 		.end();
 }
 
+void compressed_mesh_vertex::init(vertex_layout& decl)
+{
+	decl.begin()
+		.add(attribute::Position, 3, attribute_type::Float)
+		.add(attribute::Color1, 4, attribute_type::Uint8, true)
+		.add(attribute::Normal, 4, attribute_type::Uint8, true, true)
+		.add(attribute::Tangent, 4, attribute_type::Uint8, true, true)
+		.add(attribute::Bitangent, 4, attribute_type::Uint8, true, true)
+		.add(attribute::TexCoord0, 2, attribute_type::Half)
+		.end();
+}
+
 void pos_texcoord0_color0_vertex::init(vertex_layout& decl)
 {
 	decl.begin()
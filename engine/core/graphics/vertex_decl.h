@@ -9,15 +9,29 @@ using vertex_layout = bgfx::VertexDecl;
 using attribute = bgfx::Attrib::Enum;
 using attribute_type = bgfx::AttribType::Enum;
 
+//-----------------------------------------------------------------------------
+//  Name : get_canonical_layout ()
+/// <summary>
+/// Canonical layout registry. Returns a shared immutable instance for the
+/// given layout, keyed by its attribute hash (computed by end(), so the
+/// layout must be finalized). Identical layouts resolve to the same
+/// address, which makes them pointer-comparable and lets repeated mesh
+/// loads reuse one instance instead of carrying their own copies.
+/// </summary>
+//-----------------------------------------------------------------------------
+const vertex_layout& get_canonical_layout(const vertex_layout& layout);
+
 template <typename T>
 struct vertex
 {
 	static const vertex_layout& get_layout()
 	{
-		static vertex_layout s_decl = []() {
+		// routed through the canonical registry so the static layouts
+		// share addresses with loaded ones
+		static const vertex_layout& s_decl = []() -> const vertex_layout& {
 			vertex_layout decl;
 			T::init(decl);
-			return decl;
+			return get_canonical_layout(decl);
 		}();
 		return s_decl;
 	}
@@ -40,6 +54,14 @@ struct mesh_vertex : vertex<mesh_vertex>
 	static void init(vertex_layout& decl);
 };
 
+/// Compressed variant of mesh_vertex written by the asset compiler.
+/// Texture coordinates are stored as half floats and expanded by the GPU
+/// during vertex fetch, so shaders consume both layouts unchanged.
+struct compressed_mesh_vertex : vertex<compressed_mesh_vertex>
+{
+	static void init(vertex_layout& decl);
+};
+
 struct pos_texcoord0_color0_vertex : vertex<pos_texcoord0_color0_vertex>
 {
 	static void init(vertex_layout& decl);
@@ -1,6 +1,112 @@
 #include "logging.h"
 
+#include <utility>
+#include <vector>
+
+namespace logging
+{
+bounded_async_sink_mt::bounded_async_sink_mt(std::shared_ptr<sinks::sink> inner, std::size_t queue_size)
+	: _inner(std::move(inner))
+	, _capacity(queue_size)
+	, _worker([this]() { run(); })
+{
+}
+
+bounded_async_sink_mt::~bounded_async_sink_mt()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_done = true;
+		_flush_requested = true;
+	}
+	_cv.notify_all();
+	if(_worker.joinable())
+		_worker.join();
+}
+
+void bounded_async_sink_mt::log(const details::log_msg& msg)
+{
+	queued_msg queued;
+	queued.level = msg.level;
+	queued.time = msg.time;
+	queued.thread_id = msg.thread_id;
+	if(msg.logger_name != nullptr)
+		queued.logger_name = *msg.logger_name;
+	queued.raw = msg.raw.str();
+	queued.formatted = msg.formatted.str();
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if(_queue.size() >= _capacity)
+		{
+			// never block the caller - discard and count
+			++_dropped;
+			return;
+		}
+		_queue.push_back(std::move(queued));
+		++_enqueued;
+	}
+	_cv.notify_one();
+}
+
+void bounded_async_sink_mt::flush()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_flush_requested = true;
+	}
+	_cv.notify_one();
+}
+
+async_log_stats bounded_async_sink_mt::get_stats() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	async_log_stats stats;
+	stats.enqueued = _enqueued;
+	stats.dropped = _dropped;
+	stats.pending = _queue.size();
+	return stats;
+}
+
+void bounded_async_sink_mt::run()
+{
+	std::vector<queued_msg> batch;
+	for(;;)
+	{
+		bool flush_inner = false;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_cv.wait(lock, [this]() { return _done || _flush_requested || !_queue.empty(); });
+
+			batch.assign(std::make_move_iterator(_queue.begin()), std::make_move_iterator(_queue.end()));
+			_queue.clear();
+			flush_inner = _flush_requested;
+			_flush_requested = false;
+
+			if(_done && batch.empty() && !flush_inner)
+				return;
+		}
+
+		for(auto& queued : batch)
+		{
+			details::log_msg msg;
+			msg.logger_name = &queued.logger_name;
+			msg.level = queued.level;
+			msg.time = queued.time;
+			msg.thread_id = queued.thread_id;
+			msg.raw << queued.raw;
+			msg.formatted << queued.formatted;
+			_inner->log(msg);
+		}
+		batch.clear();
+
+		if(flush_inner)
+			_inner->flush();
+	}
+}
+}
+
 int logging_obj_export_symbols()
 {
 	return 0;
-}
\ No newline at end of file
+}
@@ -60,6 +60,13 @@ using platform_sink_st = stdout_sink_st;
 #include "spdlog/sinks/dist_sink.h"
 #include "spdlog/sinks/file_sinks.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 namespace logging
 {
 using namespace spdlog;
@@ -68,6 +75,101 @@ inline std::shared_ptr<sinks::dist_sink_mt> get_mutable_logging_container()
 	static auto sink = std::make_shared<sinks::dist_sink_mt>();
 	return sink;
 }
+
+/// queue statistics of the bounded async sink
+struct async_log_stats
+{
+	/// messages accepted into the queue since startup
+	std::uint64_t enqueued = 0;
+	/// messages discarded because the queue was full
+	std::uint64_t dropped = 0;
+	/// messages currently waiting for the worker
+	std::size_t pending = 0;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : bounded_async_sink_mt (Class)
+/// <summary>
+/// Decouples logging call sites from sink formatting and IO. Producers
+/// only copy the message into a bounded queue under a briefly held lock;
+/// a dedicated worker forwards to the wrapped sink. When the queue is
+/// full the newest message is discarded and counted rather than blocking
+/// the caller - an error storm on a worker thread cannot stall a frame
+/// on sink IO. flush() is asynchronous as well: it tells the worker to
+/// drain and flush the wrapped sink, making the per-frame flush point
+/// explicit and cheap for the caller.
+/// </summary>
+//-----------------------------------------------------------------------------
+class bounded_async_sink_mt : public sinks::sink
+{
+public:
+	bounded_async_sink_mt(std::shared_ptr<sinks::sink> inner, std::size_t queue_size);
+	~bounded_async_sink_mt() override;
+
+	void log(const details::log_msg& msg) override;
+	void flush() override;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_stats ()
+	/// <summary>
+	/// Queue statistics - watch 'dropped' in degraded situations.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	async_log_stats get_stats() const;
+
+private:
+	struct queued_msg
+	{
+		level::level_enum level = level::info;
+		log_clock::time_point time;
+		std::size_t thread_id = 0;
+		std::string logger_name;
+		std::string raw;
+		std::string formatted;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : run () (Private)
+	/// <summary>
+	/// Worker loop - drains the queue in batches and forwards to the
+	/// wrapped sink.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void run();
+
+	/// the sink doing the real formatting and IO
+	std::shared_ptr<sinks::sink> _inner;
+	/// guards the queue and the flush request
+	mutable std::mutex _mutex;
+	/// wakes the worker when messages or a flush arrive
+	std::condition_variable _cv;
+	/// pending messages, newest last
+	std::deque<queued_msg> _queue;
+	/// maximum queued messages before discarding
+	std::size_t _capacity;
+	/// statistics
+	std::uint64_t _enqueued = 0;
+	std::uint64_t _dropped = 0;
+	/// worker should forward everything and flush the wrapped sink
+	bool _flush_requested = false;
+	/// shutdown flag
+	bool _done = false;
+	/// dedicated forwarding thread. Last member so it starts fully initialized.
+	std::thread _worker;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : get_async_logging_container ()
+/// <summary>
+/// The bounded async front for the shared sink container. Loggers built
+/// on this keep formatting and sink IO off the calling thread.
+/// </summary>
+//-----------------------------------------------------------------------------
+inline std::shared_ptr<bounded_async_sink_mt> get_async_logging_container()
+{
+	static auto sink = std::make_shared<bounded_async_sink_mt>(get_mutable_logging_container(), 8192);
+	return sink;
+}
 #define APPLOG "Log"
 #define APPLOG_INFO(...) spdlog::get("Log")->info(__VA_ARGS__)
 #define APPLOG_TRACE(...) spdlog::get("Log")->trace(__VA_ARGS__)
@@ -1,6 +1,11 @@
 #include "bbox.h"
 #include <limits>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATH_BBOX_SSE2 1
+#include <emmintrin.h>
+#endif
+
 namespace math
 {
 ///////////////////////////////////////////////////////////////////////////////
@@ -969,6 +974,112 @@ bbox bbox::mul(const bbox& bounds, const transform& t)
 	//	return result;
 }
 
+//-----------------------------------------------------------------------------
+//  Name : mul_batch () (Static)
+/// <summary>
+/// Transforms an array of boxes by their matching transforms in one pass
+/// using the center/extent form: the new center is the fully transformed
+/// old center and the new extent is the componentwise-absolute rotation
+/// applied to the old extent. Identical result to mul per box, without
+/// the 8-corner expansion.
+/// </summary>
+//-----------------------------------------------------------------------------
+void bbox::mul_batch(const bbox* boxes, const transform* transforms, std::size_t count, bbox* results)
+{
+	std::size_t i = 0;
+#if defined(MATH_BBOX_SSE2)
+	const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	const __m128 half = _mm_set1_ps(0.5f);
+	for(; i < count; ++i)
+	{
+		const auto& b = boxes[i];
+		const mat4& m = transforms[i].matrix();
+
+		// One register holds the three components of a vector; the matrix
+		// columns load directly since mat4 is column major.
+		const __m128 col0 = _mm_loadu_ps(&m[0][0]);
+		const __m128 col1 = _mm_loadu_ps(&m[1][0]);
+		const __m128 col2 = _mm_loadu_ps(&m[2][0]);
+		const __m128 col3 = _mm_loadu_ps(&m[3][0]);
+
+		// loading 16 bytes from min stays inside the box (it picks up
+		// max.x in the unused lane), so no per-component sets are needed
+		const __m128 bmin = _mm_loadu_ps(&b.min.x);
+		const __m128 bmax = _mm_set_ps(0.0f, b.max.z, b.max.y, b.max.x);
+		const __m128 center = _mm_mul_ps(_mm_add_ps(bmin, bmax), half);
+		const __m128 extent = _mm_mul_ps(_mm_sub_ps(bmax, bmin), half);
+
+		const __m128 cx = _mm_shuffle_ps(center, center, _MM_SHUFFLE(0, 0, 0, 0));
+		const __m128 cy = _mm_shuffle_ps(center, center, _MM_SHUFFLE(1, 1, 1, 1));
+		const __m128 cz = _mm_shuffle_ps(center, center, _MM_SHUFFLE(2, 2, 2, 2));
+		const __m128 new_center = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(col0, cx), _mm_mul_ps(col1, cy)), _mm_add_ps(_mm_mul_ps(col2, cz), col3));
+
+		const __m128 ex = _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(0, 0, 0, 0));
+		const __m128 ey = _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(1, 1, 1, 1));
+		const __m128 ez = _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(2, 2, 2, 2));
+		const __m128 new_extent =
+			_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(col0, abs_mask), ex),
+								  _mm_mul_ps(_mm_and_ps(col1, abs_mask), ey)),
+					   _mm_mul_ps(_mm_and_ps(col2, abs_mask), ez));
+
+		alignas(16) float lo[4];
+		alignas(16) float hi[4];
+		_mm_store_ps(lo, _mm_sub_ps(new_center, new_extent));
+		_mm_store_ps(hi, _mm_add_ps(new_center, new_extent));
+
+		auto& out = results[i];
+		out.min = vec3(lo[0], lo[1], lo[2]);
+		out.max = vec3(hi[0], hi[1], hi[2]);
+	}
+#endif
+	// Scalar fallback without SSE2.
+	for(; i < count; ++i)
+		results[i] = mul(boxes[i], transforms[i]);
+}
+
+//-----------------------------------------------------------------------------
+//  Name : merge_batch () (Static)
+/// <summary>
+/// Reduces an array of boxes to their common bounds - the merge step of
+/// a hierarchy refit.
+/// </summary>
+//-----------------------------------------------------------------------------
+bbox bbox::merge_batch(const bbox* boxes, std::size_t count)
+{
+	if(count == 0)
+		return bbox();
+
+	std::size_t i = 0;
+	bbox result(boxes[0].min, boxes[0].max);
+#if defined(MATH_BBOX_SSE2)
+	// Lanes 0-2 of running_min track min.xyz (lane 3 picks up max.x and is
+	// discarded); lanes 1-3 of running_max track max.xyz. Both loads stay
+	// inside their box, so no past-the-end reads on the last element.
+	__m128 running_min = _mm_loadu_ps(&boxes[0].min.x);
+	__m128 running_max = _mm_loadu_ps(&boxes[0].min.z);
+	for(i = 1; i < count; ++i)
+	{
+		running_min = _mm_min_ps(running_min, _mm_loadu_ps(&boxes[i].min.x));
+		running_max = _mm_max_ps(running_max, _mm_loadu_ps(&boxes[i].min.z));
+	}
+
+	alignas(16) float lo[4];
+	alignas(16) float hi[4];
+	_mm_store_ps(lo, running_min);
+	_mm_store_ps(hi, running_max);
+	result.min = vec3(lo[0], lo[1], lo[2]);
+	result.max = vec3(hi[1], hi[2], hi[3]);
+#else
+	for(i = 1; i < count; ++i)
+	{
+		result.add_point(boxes[i].min);
+		result.add_point(boxes[i].max);
+	}
+#endif
+	return result;
+}
+
 //-----------------------------------------------------------------------------
 //  Name : inflate()
 /// <summary>
@@ -6,6 +6,7 @@
 #include "math_types.h"
 #include "plane.h"
 #include "transform.h"
+#include <cstddef>
 namespace math
 {
 using namespace glm;
@@ -71,6 +72,30 @@ struct bbox
 	//-------------------------------------------------------------------------
 	static bbox mul(const bbox& bounds, const transform& t);
 
+	//-------------------------------------------------------------------------
+	//  Name : mul_batch () (Static)
+	/// <summary>
+	/// Transforms a contiguous array of boxes by their matching transforms
+	/// in one pass. Works in center/extent form - new center is the
+	/// transformed center, new extent is the absolute rotation applied to
+	/// the old extent - so no 8-corner expansion. The SSE2 path runs the
+	/// three components of a box in one register. results may alias boxes.
+	/// </summary>
+	//-------------------------------------------------------------------------
+	static void mul_batch(const bbox* boxes, const transform* transforms, std::size_t count,
+						  bbox* results);
+
+	//-------------------------------------------------------------------------
+	//  Name : merge_batch () (Static)
+	/// <summary>
+	/// Merges a contiguous array of boxes into their common bounds - the
+	/// reduction step of a hierarchy refit. The SSE2 path keeps the
+	/// running min/max in registers instead of comparing per component.
+	/// Returns an empty box for an empty array.
+	/// </summary>
+	//-------------------------------------------------------------------------
+	static bbox merge_batch(const bbox* boxes, std::size_t count);
+
 	//-------------------------------------------------------------------------
 	// Public Operators
 	//-------------------------------------------------------------------------
@@ -1,5 +1,10 @@
 #include "frustum.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATH_FRUSTUM_SSE2 1
+#include <emmintrin.h>
+#endif
+
 namespace math
 {
 ///////////////////////////////////////////////////////////////////////////////
@@ -59,6 +64,8 @@ frustum::frustum(const bbox& AABB)
 	points[volume_geometry_point::right_top_near] = vec3(p.x + e.x, p.y + e.y, p.z - e.z);
 	points[volume_geometry_point::right_top_far] = vec3(p.x + e.x, p.y + e.y, p.z + e.z);
 	position = p;
+
+	update_pvertex_masks();
 }
 
 //-----------------------------------------------------------------------------
@@ -144,6 +151,33 @@ void frustum::set_planes(const std::array<plane, 6>& new_planes)
 
 	// Recompute the frustum corner points.
 	recompute_points();
+
+	// Refresh the positive-vertex lookup used by the AABB tests.
+	update_pvertex_masks();
+}
+
+//-----------------------------------------------------------------------------
+//  Name : update_pvertex_masks ()
+/// <summary>
+/// Rebuild the per-plane positive-vertex selection masks from the current
+/// plane normals. Must be called whenever the planes are replaced or
+/// transformed.
+/// </summary>
+//-----------------------------------------------------------------------------
+void frustum::update_pvertex_masks()
+{
+	for(std::size_t i = 0; i < planes.size(); ++i)
+	{
+		const plane& p = planes[i];
+		std::uint8_t mask = 0;
+		if(p.data.x > 0.0f)
+			mask |= 0x1;
+		if(p.data.y > 0.0f)
+			mask |= 0x2;
+		if(p.data.z > 0.0f)
+			mask |= 0x4;
+		pvertex_masks[i] = mask;
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -197,42 +231,16 @@ void frustum::recompute_points()
 volume_query frustum::classify_aabb(const bbox& AABB) const
 {
 	volume_query Result = volume_query::inside;
-	vec3 NearPoint, FarPoint;
-	for(const auto& plane : planes)
+	const vec3* const corners[2] = {&AABB.min, &AABB.max};
+	for(std::size_t i = 0; i < planes.size(); ++i)
 	{
-		// Calculate near / far extreme points
-		if(plane.data.x > 0.0f)
-		{
-			FarPoint.x = AABB.max.x;
-			NearPoint.x = AABB.min.x;
-		}
-		else
-		{
-			FarPoint.x = AABB.min.x;
-			NearPoint.x = AABB.max.x;
-		}
-
-		if(plane.data.y > 0.0f)
-		{
-			FarPoint.y = AABB.max.y;
-			NearPoint.y = AABB.min.y;
-		}
-		else
-		{
-			FarPoint.y = AABB.min.y;
-			NearPoint.y = AABB.max.y;
-		}
-
-		if(plane.data.z > 0.0f)
-		{
-			FarPoint.z = AABB.max.z;
-			NearPoint.z = AABB.min.z;
-		}
-		else
-		{
-			FarPoint.z = AABB.min.z;
-			NearPoint.z = AABB.max.z;
-		}
+		// Select near / far extreme points via the precomputed p-vertex mask.
+		const plane& plane = planes[i];
+		const std::uint8_t mask = pvertex_masks[i];
+		const vec3 FarPoint(corners[mask & 0x1]->x, corners[(mask >> 1) & 0x1]->y,
+							corners[(mask >> 2) & 0x1]->z);
+		const vec3 NearPoint(corners[(mask & 0x1) ^ 0x1]->x, corners[((mask >> 1) & 0x1) ^ 0x1]->y,
+							 corners[((mask >> 2) & 0x1) ^ 0x1]->z);
 
 		// If near extreme point is outside, then the AABB is totally outside the
 		// frustum
@@ -248,6 +256,82 @@ volume_query frustum::classify_aabb(const bbox& AABB) const
 	return Result;
 }
 
+//-----------------------------------------------------------------------------
+//  Name : classify_aabb_batch ()
+/// <summary>
+/// Classifies a contiguous array of boxes against all six planes in one
+/// pass. The SSE2 path tests four boxes per iteration; because the plane
+/// sign is uniform across a batch, the near/far extreme selection is one
+/// branch per plane rather than per box.
+/// </summary>
+//-----------------------------------------------------------------------------
+void frustum::classify_aabb_batch(const bbox* boxes, std::size_t count, volume_query* results) const
+{
+	std::size_t i = 0;
+#if defined(MATH_FRUSTUM_SSE2)
+	const __m128 zero = _mm_setzero_ps();
+	for(; i + 4 <= count; i += 4)
+	{
+		// Transpose the four boxes into SoA registers.
+		const __m128 min_x =
+			_mm_set_ps(boxes[i + 3].min.x, boxes[i + 2].min.x, boxes[i + 1].min.x, boxes[i].min.x);
+		const __m128 min_y =
+			_mm_set_ps(boxes[i + 3].min.y, boxes[i + 2].min.y, boxes[i + 1].min.y, boxes[i].min.y);
+		const __m128 min_z =
+			_mm_set_ps(boxes[i + 3].min.z, boxes[i + 2].min.z, boxes[i + 1].min.z, boxes[i].min.z);
+		const __m128 max_x =
+			_mm_set_ps(boxes[i + 3].max.x, boxes[i + 2].max.x, boxes[i + 1].max.x, boxes[i].max.x);
+		const __m128 max_y =
+			_mm_set_ps(boxes[i + 3].max.y, boxes[i + 2].max.y, boxes[i + 1].max.y, boxes[i].max.y);
+		const __m128 max_z =
+			_mm_set_ps(boxes[i + 3].max.z, boxes[i + 2].max.z, boxes[i + 1].max.z, boxes[i].max.z);
+
+		__m128 outside = _mm_setzero_ps();
+		__m128 intersect = _mm_setzero_ps();
+
+		for(const auto& p : planes)
+		{
+			const __m128 px = _mm_set1_ps(p.data.x);
+			const __m128 py = _mm_set1_ps(p.data.y);
+			const __m128 pz = _mm_set1_ps(p.data.z);
+			const __m128 pw = _mm_set1_ps(p.data.w);
+
+			const __m128 near_x = p.data.x > 0.0f ? min_x : max_x;
+			const __m128 far_x = p.data.x > 0.0f ? max_x : min_x;
+			const __m128 near_y = p.data.y > 0.0f ? min_y : max_y;
+			const __m128 far_y = p.data.y > 0.0f ? max_y : min_y;
+			const __m128 near_z = p.data.z > 0.0f ? min_z : max_z;
+			const __m128 far_z = p.data.z > 0.0f ? max_z : min_z;
+
+			const __m128 near_dot = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(px, near_x), _mm_mul_ps(py, near_y)),
+				_mm_add_ps(_mm_mul_ps(pz, near_z), pw));
+			outside = _mm_or_ps(outside, _mm_cmpgt_ps(near_dot, zero));
+
+			const __m128 far_dot = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(px, far_x), _mm_mul_ps(py, far_y)),
+				_mm_add_ps(_mm_mul_ps(pz, far_z), pw));
+			intersect = _mm_or_ps(intersect, _mm_cmpgt_ps(far_dot, zero));
+		}
+
+		const int outside_mask = _mm_movemask_ps(outside);
+		const int intersect_mask = _mm_movemask_ps(intersect);
+		for(int lane = 0; lane < 4; ++lane)
+		{
+			if((outside_mask & (1 << lane)) != 0)
+				results[i + lane] = volume_query::outside;
+			else if((intersect_mask & (1 << lane)) != 0)
+				results[i + lane] = volume_query::intersect;
+			else
+				results[i + lane] = volume_query::inside;
+		}
+	}
+#endif
+	// Scalar tail (and full fallback without SSE2).
+	for(; i < count; ++i)
+		results[i] = classify_aabb(boxes[i]);
+}
+
 //-----------------------------------------------------------------------------
 //  Name : classifyAABB ()
 /// <summary>
@@ -274,43 +358,19 @@ volume_query frustum::classify_aabb(const bbox& AABB, unsigned int& FrustumBits,
 	// If the 'last outside plane' index was specified, test it first!
 	vec3 NearPoint, FarPoint;
 	volume_query Result = volume_query::inside;
+	const vec3* const corners[2] = {&AABB.min, &AABB.max};
 	if(LastOutside >= 0 && (((FrustumBits >> LastOutside) & 0x1) == 0x0))
 	{
 		const plane& plane = planes[size_t(LastOutside)];
 
-		// Calculate near / far extreme points
-		if(plane.data.x > 0.0f)
-		{
-			FarPoint.x = AABB.max.x;
-			NearPoint.x = AABB.min.x;
-		}
-		else
-		{
-			FarPoint.x = AABB.min.x;
-			NearPoint.x = AABB.max.x;
-		}
-
-		if(plane.data.y > 0.0f)
-		{
-			FarPoint.y = AABB.max.y;
-			NearPoint.y = AABB.min.y;
-		}
-		else
-		{
-			FarPoint.y = AABB.min.y;
-			NearPoint.y = AABB.max.y;
-		}
-
-		if(plane.data.z > 0.0f)
-		{
-			FarPoint.z = AABB.max.z;
-			NearPoint.z = AABB.min.z;
-		}
-		else
-		{
-			FarPoint.z = AABB.min.z;
-			NearPoint.z = AABB.max.z;
-		}
+		// Select near / far extreme points via the precomputed p-vertex mask.
+		const std::uint8_t mask = pvertex_masks[size_t(LastOutside)];
+		FarPoint.x = corners[mask & 0x1]->x;
+		FarPoint.y = corners[(mask >> 1) & 0x1]->y;
+		FarPoint.z = corners[(mask >> 2) & 0x1]->z;
+		NearPoint.x = corners[(mask & 0x1) ^ 0x1]->x;
+		NearPoint.y = corners[((mask >> 1) & 0x1) ^ 0x1]->y;
+		NearPoint.z = corners[((mask >> 2) & 0x1) ^ 0x1]->z;
 
 		// If near extreme point is outside, then the AABB is totally outside the
 		// frustum
@@ -340,40 +400,15 @@ volume_query frustum::classify_aabb(const bbox& AABB, unsigned int& FrustumBits,
 		if(LastOutside >= 0 && LastOutside == int(i))
 			continue;
 
-		// Calculate near / far extreme points
+		// Select near / far extreme points via the precomputed p-vertex mask.
 		const plane& plane = planes[i];
-		if(plane.data.x > 0.0f)
-		{
-			FarPoint.x = AABB.max.x;
-			NearPoint.x = AABB.min.x;
-		}
-		else
-		{
-			FarPoint.x = AABB.min.x;
-			NearPoint.x = AABB.max.x;
-		}
-
-		if(plane.data.y > 0.0f)
-		{
-			FarPoint.y = AABB.max.y;
-			NearPoint.y = AABB.min.y;
-		}
-		else
-		{
-			FarPoint.y = AABB.min.y;
-			NearPoint.y = AABB.max.y;
-		}
-
-		if(plane.data.z > 0.0f)
-		{
-			FarPoint.z = AABB.max.z;
-			NearPoint.z = AABB.min.z;
-		}
-		else
-		{
-			FarPoint.z = AABB.min.z;
-			NearPoint.z = AABB.max.z;
-		}
+		const std::uint8_t mask = pvertex_masks[i];
+		FarPoint.x = corners[mask & 0x1]->x;
+		FarPoint.y = corners[(mask >> 1) & 0x1]->y;
+		FarPoint.z = corners[(mask >> 2) & 0x1]->z;
+		NearPoint.x = corners[(mask & 0x1) ^ 0x1]->x;
+		NearPoint.y = corners[((mask >> 1) & 0x1) ^ 0x1]->y;
+		NearPoint.z = corners[((mask >> 2) & 0x1) ^ 0x1]->z;
 
 		// If near extreme point is outside, then the AABB is totally outside the
 		// frustum
@@ -426,27 +461,18 @@ bool frustum::test_aabb(const bbox& AABB) const
 {
 	// Loop through all the planes
 	vec3 NearPoint;
-	for(const auto& plane : planes)
+	const vec3* const corners[2] = {&AABB.min, &AABB.max};
+	for(std::size_t i = 0; i < planes.size(); ++i)
 	{
-		// Calculate near / far extreme points
-		if(plane.data.x > 0.0f)
-			NearPoint.x = AABB.min.x;
-		else
-			NearPoint.x = AABB.max.x;
-
-		if(plane.data.y > 0.0f)
-			NearPoint.y = AABB.min.y;
-		else
-			NearPoint.y = AABB.max.y;
-
-		if(plane.data.z > 0.0f)
-			NearPoint.z = AABB.min.z;
-		else
-			NearPoint.z = AABB.max.z;
+		// Select the near extreme point via the precomputed p-vertex mask.
+		const std::uint8_t mask = pvertex_masks[i];
+		NearPoint.x = corners[(mask & 0x1) ^ 0x1]->x;
+		NearPoint.y = corners[((mask >> 1) & 0x1) ^ 0x1]->y;
+		NearPoint.z = corners[((mask >> 2) & 0x1) ^ 0x1]->z;
 
 		// If near extreme point is outside, then the AABB is totally outside the
 		// frustum
-		if(plane::dot_coord(plane, NearPoint) > 0.0f)
+		if(plane::dot_coord(planes[i], NearPoint) > 0.0f)
 			return false;
 
 	} // Next plane
@@ -881,6 +907,9 @@ frustum& frustum::mul(const transform& t)
 	for(auto& plane : planes)
 		plane = plane::normalize(plane::mul(plane, mtxIT));
 
+	// Plane normals changed; refresh the positive-vertex lookup.
+	update_pvertex_masks();
+
 	// transform points
 	for(auto& point : points)
 		point = transform::transform_coord(point, mtx);
@@ -6,6 +6,7 @@
 #include "plane.h"
 #include "transform.h"
 #include <array>
+#include <cstdint>
 
 namespace math
 {
@@ -38,6 +39,16 @@ public:
 	void recompute_points();
 	volume_query classify_aabb(const bbox& bounds) const;
 	volume_query classify_aabb(const bbox& bounds, unsigned int& frustumBits, int& lastOutside) const;
+	//-----------------------------------------------------------------------------
+	//  Name : classify_aabb_batch ()
+	/// <summary>
+	/// Classifies a contiguous array of boxes against all six planes in
+	/// one pass, writing one volume_query per box. Uses an SSE2 path that
+	/// tests four boxes per iteration where available and falls back to
+	/// scalar classify_aabb otherwise.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void classify_aabb_batch(const bbox* boxes, std::size_t count, volume_query* results) const;
 	volume_query classify_sphere(const vec3& center, float radius) const;
 	volume_query classify_plane(const plane& plane) const;
 	bool test_point(const vec3& point) const;
@@ -69,8 +80,18 @@ public:
 	std::array<plane, 6> planes;		// The 6 planes of the frustum.
 	std::array<vec3, 8> points;			// The 8 corner points of the frustum.
 	vec3 position = {0.0f, 0.0f, 0.0f}; // The originating position of the frustum.
+	// Per-plane positive-vertex selection masks (bit 0/1/2 set when the plane
+	// normal is positive along x/y/z). Precomputed whenever the planes change
+	// so each AABB test is six indexed loads and dot products with early-out
+	// instead of three sign comparisons per plane per box.
+	std::array<std::uint8_t, 6> pvertex_masks = {{0, 0, 0, 0, 0, 0}};
 
 private:
+	//-------------------------------------------------------------------------
+	// Private Methods
+	//-------------------------------------------------------------------------
+	void update_pvertex_masks();
+
 	//-------------------------------------------------------------------------
 	// Private Static Functions
 	//-------------------------------------------------------------------------
@@ -1,10 +1,45 @@
 #include "transform.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATH_TRANSFORM_SSE2 1
+#include <emmintrin.h>
+#endif
+
 //-----------------------------------------------------------------------------
 // Defines
 //-----------------------------------------------------------------------------
 namespace math
 {
+#if defined(MATH_TRANSFORM_SSE2)
+namespace
+{
+//-----------------------------------------------------------------------------
+//  Name : mat4_mul_sse2 ()
+/// <summary>
+/// out = lhs * rhs for column-major 4x4 float matrices. One column of the
+/// result per iteration, broadcast-multiply-accumulate over the four lhs
+/// columns held in registers.
+/// </summary>
+//-----------------------------------------------------------------------------
+inline void mat4_mul_sse2(float* out, const float* lhs, const float* rhs)
+{
+	const __m128 l0 = _mm_loadu_ps(lhs + 0);
+	const __m128 l1 = _mm_loadu_ps(lhs + 4);
+	const __m128 l2 = _mm_loadu_ps(lhs + 8);
+	const __m128 l3 = _mm_loadu_ps(lhs + 12);
+	for(int i = 0; i < 4; ++i)
+	{
+		const __m128 r0 = _mm_set1_ps(rhs[i * 4 + 0]);
+		const __m128 r1 = _mm_set1_ps(rhs[i * 4 + 1]);
+		const __m128 r2 = _mm_set1_ps(rhs[i * 4 + 2]);
+		const __m128 r3 = _mm_set1_ps(rhs[i * 4 + 3]);
+		const __m128 col = _mm_add_ps(_mm_add_ps(_mm_mul_ps(l0, r0), _mm_mul_ps(l1, r1)),
+									  _mm_add_ps(_mm_mul_ps(l2, r2), _mm_mul_ps(l3, r3)));
+		_mm_storeu_ps(out + i * 4, col);
+	}
+}
+}
+#endif
 //-----------------------------------------------------------------------------
 // Static Member Definitions
 //-----------------------------------------------------------------------------
@@ -172,8 +207,14 @@ mat4::col_type const& transform::operator[](mat4::length_type i) const
 //-----------------------------------------------------------------------------
 transform transform::operator*(const transform& t) const
 {
+#if defined(MATH_TRANSFORM_SSE2)
+	transform result;
+	mat4_mul_sse2(&result._matrix[0][0], &_matrix[0][0], &t._matrix[0][0]);
+	return result;
+#else
 	transform result(_matrix * t._matrix);
 	return result;
+#endif
 }
 
 vec4 transform::operator*(const vec4& v) const
@@ -226,7 +267,13 @@ transform transform::operator-(const transform& t) const
 //-----------------------------------------------------------------------------
 transform& transform::operator*=(const transform& t)
 {
+#if defined(MATH_TRANSFORM_SSE2)
+	mat4 result;
+	mat4_mul_sse2(&result[0][0], &_matrix[0][0], &t._matrix[0][0]);
+	_matrix = result;
+#else
 	_matrix *= t._matrix;
+#endif
 	return *this;
 }
 
@@ -608,6 +655,50 @@ vec3 transform::transform_coord(const vec3& v, const transform& t)
 	return t.transform_coord(v);
 }
 
+//-----------------------------------------------------------------------------
+//  Name : transform_coord_array()
+/// <summary>
+/// Transforms a span of 3D positions, projecting each result back into
+/// w = 1. The matrix columns stay pinned in registers across the whole
+/// span on the SIMD path.
+/// </summary>
+//-----------------------------------------------------------------------------
+void transform::transform_coord_array(vec3* dst, const vec3* src, std::size_t count) const
+{
+#if defined(MATH_TRANSFORM_SSE2)
+	const __m128 c0 = _mm_loadu_ps(&_matrix[0][0]);
+	const __m128 c1 = _mm_loadu_ps(&_matrix[1][0]);
+	const __m128 c2 = _mm_loadu_ps(&_matrix[2][0]);
+	const __m128 c3 = _mm_loadu_ps(&_matrix[3][0]);
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		const __m128 x = _mm_set1_ps(src[i].x);
+		const __m128 y = _mm_set1_ps(src[i].y);
+		const __m128 z = _mm_set1_ps(src[i].z);
+		__m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, x), _mm_mul_ps(c1, y)),
+							  _mm_add_ps(_mm_mul_ps(c2, z), c3));
+
+		alignas(16) float out[4];
+		_mm_store_ps(out, r);
+		const float w = out[3];
+		if(w != 0.0f && w != 1.0f)
+		{
+			const float inv_w = 1.0f / w;
+			dst[i] = vec3{out[0] * inv_w, out[1] * inv_w, out[2] * inv_w};
+		}
+		else
+		{
+			dst[i] = vec3{out[0], out[1], out[2]};
+		}
+	}
+#else
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		dst[i] = transform_coord(src[i]);
+	}
+#endif
+}
+
 //-----------------------------------------------------------------------------
 //  Name : inverse_transform_coord()
 /// <summary>
@@ -3,6 +3,7 @@
 // transform Header Includes
 //-----------------------------------------------------------------------------
 #include "glm_includes.h"
+#include <cstddef>
 
 namespace math
 {
@@ -34,6 +35,16 @@ public:
 	// Public Methods
 	//-------------------------------------------------------------------------
 	vec3 transform_coord(const vec3& v) const;
+	//-----------------------------------------------------------------------------
+	//  Name : transform_coord_array ()
+	/// <summary>
+	/// Transforms a span of 3D positions by this transform in one pass,
+	/// projecting each result back into w = 1. Uses the SIMD fast path
+	/// where available; much cheaper than calling transform_coord per
+	/// element when preparing meshes or skinning palettes.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void transform_coord_array(vec3* dst, const vec3* src, std::size_t count) const;
 	vec3 inverse_transform_coord(const vec3& v) const;
 	vec3 transform_normal(const vec3& v) const;
 	vec3 inverse_transform_normal(const vec3& v) const;
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+// avoid dragging windows.h into every includer of this header
+extern "C" unsigned short __stdcall RtlCaptureStackBackTrace(unsigned long frames_to_skip,
+															 unsigned long frames_to_capture,
+															 void** back_trace,
+															 unsigned long* back_trace_hash);
+#else
+#include <execinfo.h>
+#endif
+
+namespace memory
+{
+
+//-----------------------------------------------------------------------------
+//  Name : memory_tracker (Class)
+/// <summary>
+/// Process-wide allocation accounting, bucketed by a caller supplied tag
+/// (one per subsystem). Tracks live bytes, live allocation count, peak
+/// bytes and total allocation volume per tag. Callstack capture can be
+/// switched on for allocations above a size threshold to pin down the
+/// top offenders; stacks are aggregated by hash and reported by total
+/// allocated volume since capture is size-only (frees are not matched
+/// back to the stack that allocated them). Tags must be string literals
+/// or otherwise outlive the tracker.
+/// </summary>
+//-----------------------------------------------------------------------------
+class memory_tracker
+{
+public:
+	struct tag_stats
+	{
+		/// bytes currently allocated under this tag
+		std::uint64_t live_bytes = 0;
+		/// allocations currently outstanding under this tag
+		std::uint64_t live_count = 0;
+		/// highest value live_bytes ever reached
+		std::uint64_t peak_bytes = 0;
+		/// total bytes ever allocated under this tag
+		std::uint64_t total_bytes = 0;
+	};
+
+	static memory_tracker& get()
+	{
+		static memory_tracker instance;
+		return instance;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : record_alloc ()
+	/// <summary>
+	/// Accounts 'bytes' to 'tag' and, when callstack capture is enabled
+	/// and the allocation is large enough, records the calling stack.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void record_alloc(const char* tag, std::size_t bytes)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto& stats = _tags[tag];
+		stats.live_bytes += bytes;
+		stats.live_count += 1;
+		stats.total_bytes += bytes;
+		if(stats.live_bytes > stats.peak_bytes)
+			stats.peak_bytes = stats.live_bytes;
+
+		if(_capture_callstacks && bytes >= _capture_min_bytes)
+			capture_callstack(tag, bytes);
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : record_free ()
+	/// <summary>
+	/// Releases 'bytes' previously accounted to 'tag'.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void record_free(const char* tag, std::size_t bytes)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto& stats = _tags[tag];
+		stats.live_bytes = bytes > stats.live_bytes ? 0 : stats.live_bytes - bytes;
+		stats.live_count = stats.live_count > 0 ? stats.live_count - 1 : 0;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_callstack_capture ()
+	/// <summary>
+	/// Enables or disables callstack capture for allocations of at least
+	/// 'min_bytes'. Capture is costly - leave it off outside of leak
+	/// hunts.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_callstack_capture(bool enabled, std::size_t min_bytes = 4096)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_capture_callstacks = enabled;
+		_capture_min_bytes = min_bytes;
+		if(!enabled)
+			_callstacks.clear();
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_stats ()
+	/// <summary>
+	/// Snapshot of the per-tag accounting.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::map<std::string, tag_stats> get_stats() const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		std::map<std::string, tag_stats> result;
+		for(const auto& tag : _tags)
+			result.emplace(tag.first, tag.second);
+		return result;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : dump ()
+	/// <summary>
+	/// Human readable report - per-tag live/peak/total byte counts and,
+	/// when capture is enabled, the top allocating callstacks.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::string dump(std::size_t top_callstacks = 5) const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		std::ostringstream out;
+		out << "memory tracker\n";
+		for(const auto& tag : _tags)
+		{
+			const auto& stats = tag.second;
+			out << "  " << tag.first << ": live " << (stats.live_bytes / 1024) << " KiB in "
+				<< stats.live_count << " allocation(s), peak " << (stats.peak_bytes / 1024)
+				<< " KiB, total " << (stats.total_bytes / 1024) << " KiB\n";
+		}
+
+		if(_capture_callstacks && !_callstacks.empty())
+		{
+			// sort captured stacks by total allocated volume
+			std::vector<const callstack_record*> sorted;
+			sorted.reserve(_callstacks.size());
+			for(const auto& entry : _callstacks)
+				sorted.push_back(&entry.second);
+			std::sort(sorted.begin(), sorted.end(), [](const callstack_record* lhs,
+													   const callstack_record* rhs) {
+				return lhs->total_bytes > rhs->total_bytes;
+			});
+
+			out << "top allocating callstacks (by volume since capture was enabled)\n";
+			const std::size_t count = sorted.size() < top_callstacks ? sorted.size() : top_callstacks;
+			for(std::size_t i = 0; i < count; ++i)
+			{
+				const auto& record = *sorted[i];
+				out << "  [" << record.tag << "] " << (record.total_bytes / 1024) << " KiB in "
+					<< record.count << " allocation(s)\n";
+				append_symbols(out, record.frames);
+			}
+		}
+		return out.str();
+	}
+
+private:
+	struct callstack_record
+	{
+		const char* tag = nullptr;
+		std::uint64_t total_bytes = 0;
+		std::uint64_t count = 0;
+		std::vector<void*> frames;
+	};
+
+	memory_tracker() = default;
+
+	void capture_callstack(const char* tag, std::size_t bytes)
+	{
+		// called under _mutex
+		void* frames[32];
+#if defined(_WIN32)
+		const auto frame_count = RtlCaptureStackBackTrace(2, 32, frames, nullptr);
+#else
+		const auto frame_count = backtrace(frames, 32);
+#endif
+		std::uint64_t key = 1099511628211ull * (reinterpret_cast<std::uintptr_t>(tag) + 1);
+		for(int i = 0; i < int(frame_count); ++i)
+			key = (key ^ reinterpret_cast<std::uintptr_t>(frames[i])) * 1099511628211ull;
+
+		auto& record = _callstacks[key];
+		if(record.frames.empty())
+		{
+			record.tag = tag;
+			record.frames.assign(frames, frames + frame_count);
+		}
+		record.total_bytes += bytes;
+		record.count += 1;
+	}
+
+	static void append_symbols(std::ostringstream& out, const std::vector<void*>& frames)
+	{
+#if defined(_WIN32)
+		for(const auto& frame : frames)
+			out << "    " << frame << "\n";
+#else
+		char** symbols = backtrace_symbols(frames.data(), int(frames.size()));
+		if(symbols == nullptr)
+			return;
+		for(std::size_t i = 0; i < frames.size(); ++i)
+			out << "    " << symbols[i] << "\n";
+		free(symbols);
+#endif
+	}
+
+	/// guards everything below
+	mutable std::mutex _mutex;
+	/// per-tag accounting, keyed by the literal passed to record_alloc
+	std::map<const char*, tag_stats> _tags;
+	/// captured stacks aggregated by (tag, frames) hash
+	std::map<std::uint64_t, callstack_record> _callstacks;
+	/// capture toggles
+	bool _capture_callstacks = false;
+	std::size_t _capture_min_bytes = 4096;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : tracking_allocator (Class)
+/// <summary>
+/// Standard allocator adaptor that accounts every allocation to a tag in
+/// the memory_tracker before forwarding to the underlying allocator. The
+/// tag travels with the allocator through copies and rebinds, so shared
+/// pointer control blocks and container node types stay attributed to
+/// the subsystem that created them.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T, typename Underlying = std::allocator<T>>
+class tracking_allocator
+{
+public:
+	using value_type = T;
+
+	template <typename U>
+	struct rebind
+	{
+		using other = tracking_allocator<
+			U, typename std::allocator_traits<Underlying>::template rebind_alloc<U>>;
+	};
+
+	explicit tracking_allocator(const char* tag, const Underlying& underlying = Underlying{})
+		: _tag(tag)
+		, _underlying(underlying)
+	{
+	}
+
+	template <typename U, typename UnderlyingU>
+	tracking_allocator(const tracking_allocator<U, UnderlyingU>& other)
+		: _tag(other.tag())
+		, _underlying(other.underlying())
+	{
+	}
+
+	T* allocate(std::size_t n)
+	{
+		memory_tracker::get().record_alloc(_tag, n * sizeof(T));
+		return std::allocator_traits<Underlying>::allocate(_underlying, n);
+	}
+
+	void deallocate(T* ptr, std::size_t n)
+	{
+		memory_tracker::get().record_free(_tag, n * sizeof(T));
+		std::allocator_traits<Underlying>::deallocate(_underlying, ptr, n);
+	}
+
+	const char* tag() const
+	{
+		return _tag;
+	}
+	const Underlying& underlying() const
+	{
+		return _underlying;
+	}
+
+	bool operator==(const tracking_allocator& other) const
+	{
+		return _tag == other._tag && _underlying == other._underlying;
+	}
+	bool operator!=(const tracking_allocator& other) const
+	{
+		return !(*this == other);
+	}
+
+private:
+	const char* _tag;
+	Underlying _underlying;
+};
+}
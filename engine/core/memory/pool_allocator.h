@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace memory
+{
+
+/// Fixed-size block pool. Blocks are carved out of larger chunks obtained
+/// from ::operator new; freed blocks go onto an intrusive free list and are
+/// handed out again without touching the system allocator. Chunks are only
+/// released when the pool itself is destroyed. One pool instance exists per
+/// (block size, alignment) pair and is shared process-wide, so allocators
+/// created at different sites all recycle the same storage.
+template <std::size_t BlockSize, std::size_t BlockAlign, std::size_t BlocksPerChunk = 256>
+class memory_pool
+{
+public:
+	static_assert(BlocksPerChunk > 0, "A chunk must hold at least one block.");
+
+	static memory_pool& get()
+	{
+		static memory_pool instance;
+		return instance;
+	}
+
+	void* allocate()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if(_free_list == nullptr)
+			grow();
+
+		node* block = _free_list;
+		_free_list = block->next;
+		return block;
+	}
+
+	void deallocate(void* p)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		node* block = static_cast<node*>(p);
+		block->next = _free_list;
+		_free_list = block;
+	}
+
+	/// Returns a whole batch of blocks in one lock acquisition. Useful for
+	/// teardown paths that release many same-type objects at once.
+	void deallocate_bulk(void* const* blocks, std::size_t count)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			node* block = static_cast<node*>(blocks[i]);
+			block->next = _free_list;
+			_free_list = block;
+		}
+	}
+
+	memory_pool(const memory_pool&) = delete;
+	memory_pool& operator=(const memory_pool&) = delete;
+
+private:
+	struct node
+	{
+		node* next;
+	};
+
+	// A block must be able to hold the free-list link and keep every
+	// element suitably aligned.
+	static const std::size_t block_stride =
+		((BlockSize < sizeof(node) ? sizeof(node) : BlockSize) + BlockAlign - 1) / BlockAlign * BlockAlign;
+
+	memory_pool() = default;
+	~memory_pool()
+	{
+		for(auto* chunk : _chunks)
+			::operator delete(chunk);
+	}
+
+	void grow()
+	{
+		char* chunk = static_cast<char*>(::operator new(block_stride * BlocksPerChunk));
+		_chunks.push_back(chunk);
+		for(std::size_t i = BlocksPerChunk; i > 0; --i)
+		{
+			node* block = reinterpret_cast<node*>(chunk + (i - 1) * block_stride);
+			block->next = _free_list;
+			_free_list = block;
+		}
+	}
+
+	std::vector<char*> _chunks;
+	node* _free_list = nullptr;
+	std::mutex _mutex;
+};
+
+/// STL-compatible allocator backed by the shared per-size memory_pool.
+/// Single-object allocations (the common case for allocate_shared and
+/// node-based containers) come from the pool; array allocations fall back
+/// to ::operator new. All instances for the same T compare equal.
+template <typename T>
+class pool_allocator
+{
+public:
+	using value_type = T;
+
+	pool_allocator() noexcept = default;
+
+	template <typename U>
+	pool_allocator(const pool_allocator<U>&) noexcept
+	{
+	}
+
+	template <typename U>
+	struct rebind
+	{
+		using other = pool_allocator<U>;
+	};
+
+	T* allocate(std::size_t n)
+	{
+		if(n != 1)
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+
+		return static_cast<T*>(pool_t::get().allocate());
+	}
+
+	void deallocate(T* p, std::size_t n)
+	{
+		if(n != 1)
+		{
+			::operator delete(p);
+			return;
+		}
+		pool_t::get().deallocate(p);
+	}
+
+private:
+	using pool_t = memory_pool<sizeof(T), alignof(T)>;
+};
+
+template <typename T, typename U>
+inline bool operator==(const pool_allocator<T>&, const pool_allocator<U>&) noexcept
+{
+	return true;
+}
+
+template <typename T, typename U>
+inline bool operator!=(const pool_allocator<T>&, const pool_allocator<U>&) noexcept
+{
+	return false;
+}
+}
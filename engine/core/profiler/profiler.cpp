@@ -0,0 +1,190 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace core
+{
+namespace
+{
+//-----------------------------------------------------------------------------
+//  Name : combine_path_key () (Local)
+/// <summary>
+/// Folds a site into its parent's path key, so the same site reached
+/// through different parents aggregates into different nodes.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::uint64_t combine_path_key(std::uint64_t parent_key, std::uint32_t site)
+{
+	const std::uint64_t fnv_prime = 1099511628211ull;
+	return (parent_key ^ (std::uint64_t(site) + 1)) * fnv_prime;
+}
+}
+
+profiler& profiler::get_instance()
+{
+	static profiler instance;
+	return instance;
+}
+
+std::uint32_t profiler::register_site(const char* name)
+{
+	std::lock_guard<std::mutex> lock(_sites_mutex);
+	_site_names.emplace_back(name);
+	return static_cast<std::uint32_t>(_site_names.size() - 1);
+}
+
+profiler::thread_buffer& profiler::local_buffer()
+{
+	static thread_local thread_buffer* buffer = nullptr;
+	if(buffer == nullptr)
+	{
+		auto owned = std::make_unique<thread_buffer>();
+		buffer = owned.get();
+
+		std::lock_guard<std::mutex> lock(_buffers_mutex);
+		owned->thread_index = static_cast<std::uint32_t>(_buffers.size());
+		_buffers.push_back(std::move(owned));
+	}
+	return *buffer;
+}
+
+void profiler::push_event(std::uint32_t site, std::uint32_t type)
+{
+	if(!_enabled)
+	{
+		return;
+	}
+
+	auto& buffer = local_buffer();
+	const auto enqueue_pos = buffer.enqueue_pos.load(std::memory_order_relaxed);
+	const auto dequeue_pos = buffer.dequeue_pos.load(std::memory_order_acquire);
+	if(enqueue_pos - dequeue_pos >= thread_buffer::capacity)
+	{
+		// never block the instrumented code - the hierarchy for this thread
+		// resyncs on the next collect
+		buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	auto& e = buffer.events[enqueue_pos & (thread_buffer::capacity - 1)];
+	e.timestamp = static_cast<std::uint64_t>(clock_t::now().time_since_epoch().count());
+	e.site = site;
+	e.type = type;
+	buffer.enqueue_pos.store(enqueue_pos + 1, std::memory_order_release);
+}
+
+void profiler::collect()
+{
+	struct accum
+	{
+		std::uint32_t site = 0;
+		std::uint32_t depth = 0;
+		std::uint32_t thread_index = 0;
+		std::uint32_t call_count = 0;
+		std::uint64_t total_ticks = 0;
+		std::size_t order = 0;
+	};
+	std::unordered_map<std::uint64_t, accum> frame;
+	std::size_t next_order = 0;
+
+	std::vector<thread_buffer*> buffers;
+	{
+		std::lock_guard<std::mutex> lock(_buffers_mutex);
+		buffers.reserve(_buffers.size());
+		for(const auto& buffer : _buffers)
+		{
+			buffers.push_back(buffer.get());
+		}
+	}
+
+	for(auto* buffer : buffers)
+	{
+		if(buffer->dropped.exchange(0, std::memory_order_relaxed) > 0)
+		{
+			// events were lost - the begin/end pairing on this thread can no
+			// longer be trusted, start its hierarchy over
+			buffer->stack.clear();
+		}
+
+		auto dequeue_pos = buffer->dequeue_pos.load(std::memory_order_relaxed);
+		const auto enqueue_pos = buffer->enqueue_pos.load(std::memory_order_acquire);
+		while(dequeue_pos != enqueue_pos)
+		{
+			const auto& e = buffer->events[dequeue_pos & (thread_buffer::capacity - 1)];
+			++dequeue_pos;
+
+			if(e.type == event_begin)
+			{
+				const auto parent_key =
+					buffer->stack.empty() ? std::uint64_t(buffer->thread_index) : buffer->stack.back().path_key;
+				buffer->stack.push_back({e.site, e.timestamp, combine_path_key(parent_key, e.site)});
+			}
+			else
+			{
+				if(buffer->stack.empty() || buffer->stack.back().site != e.site)
+				{
+					// orphaned end after an overflow resync
+					buffer->stack.clear();
+					continue;
+				}
+
+				const auto scope = buffer->stack.back();
+				buffer->stack.pop_back();
+
+				auto& node = frame[scope.path_key];
+				if(node.call_count == 0)
+				{
+					node.site = scope.site;
+					node.depth = static_cast<std::uint32_t>(buffer->stack.size());
+					node.thread_index = buffer->thread_index;
+					node.order = next_order++;
+				}
+				++node.call_count;
+				node.total_ticks += e.timestamp - scope.begin;
+			}
+		}
+		buffer->dequeue_pos.store(dequeue_pos, std::memory_order_release);
+	}
+
+	std::vector<sample> samples;
+	samples.reserve(frame.size());
+	{
+		std::lock_guard<std::mutex> lock(_sites_mutex);
+		std::vector<const accum*> ordered;
+		ordered.reserve(frame.size());
+		for(const auto& pair : frame)
+		{
+			ordered.push_back(&pair.second);
+		}
+		std::sort(std::begin(ordered), std::end(ordered), [](const accum* a, const accum* b) {
+			if(a->thread_index != b->thread_index)
+			{
+				return a->thread_index < b->thread_index;
+			}
+			return a->order < b->order;
+		});
+
+		for(const auto* node : ordered)
+		{
+			sample s;
+			s.name = node->site < _site_names.size() ? _site_names[node->site] : "<unknown>";
+			s.depth = node->depth;
+			s.thread_index = node->thread_index;
+			s.call_count = node->call_count;
+			s.total_ms =
+				std::chrono::duration<double, std::milli>(clock_t::duration(node->total_ticks)).count();
+			samples.push_back(std::move(s));
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(_result_mutex);
+	_last_frame = std::move(samples);
+}
+
+std::vector<profiler::sample> profiler::get_last_frame_samples() const
+{
+	std::lock_guard<std::mutex> lock(_result_mutex);
+	return _last_frame;
+}
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace core
+{
+//-----------------------------------------------------------------------------
+//  Name : profiler (Class)
+/// <summary>
+/// Hierarchical CPU frame profiler. Scoped timers (see PROFILE_SCOPE)
+/// register their site once and then record begin/end events into a
+/// per-thread lock-free ring; collect(), called once per frame by the
+/// application loop, drains every ring, rebuilds each thread's call
+/// hierarchy and aggregates time and call counts per unique call path.
+/// The result of the last collected frame is available through
+/// get_last_frame_samples() for docks and console commands to display.
+/// </summary>
+//-----------------------------------------------------------------------------
+class profiler
+{
+public:
+	using clock_t = std::chrono::high_resolution_clock;
+
+	/// one aggregated call-tree node of the last collected frame
+	struct sample
+	{
+		/// site name as passed to PROFILE_SCOPE
+		std::string name;
+		/// nesting depth within its thread, 0 for roots
+		std::uint32_t depth = 0;
+		/// ordinal of the recording thread, 0 is the first seen
+		std::uint32_t thread_index = 0;
+		/// times this exact call path completed during the frame
+		std::uint32_t call_count = 0;
+		/// accumulated inclusive time
+		double total_ms = 0.0;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_instance ()
+	/// <summary>
+	/// The single profiler - timers must work on any thread at any point
+	/// of the application's life, so this is not a subsystem.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	static profiler& get_instance();
+
+	//-----------------------------------------------------------------------------
+	//  Name : register_site ()
+	/// <summary>
+	/// Registers a timed scope's name once and returns its id. Called
+	/// from a static initializer inside PROFILE_SCOPE - the hot path only
+	/// ever handles the returned id.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::uint32_t register_site(const char* name);
+
+	//-----------------------------------------------------------------------------
+	//  Name : push_event ()
+	/// <summary>
+	/// Records a begin or end event into the calling thread's ring. Never
+	/// blocks - when a ring is full the event is counted as dropped and
+	/// that thread's hierarchy resyncs on the next collect.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void push_event(std::uint32_t site, std::uint32_t type);
+
+	//-----------------------------------------------------------------------------
+	//  Name : collect ()
+	/// <summary>
+	/// Drains all thread rings and aggregates the completed scopes into
+	/// the last-frame snapshot. Call once per frame from the owner thread.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void collect();
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_last_frame_samples ()
+	/// <summary>
+	/// The aggregated call tree of the last collected frame, ordered by
+	/// thread then by recording order.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::vector<sample> get_last_frame_samples() const;
+
+	inline void set_enabled(bool enabled)
+	{
+		_enabled = enabled;
+	}
+
+	inline bool is_enabled() const
+	{
+		return _enabled;
+	}
+
+	/// event types
+	static const std::uint32_t event_begin = 0;
+	static const std::uint32_t event_end = 1;
+
+private:
+	/// per-thread event ring - the owning thread produces, collect consumes
+	struct thread_buffer
+	{
+		struct event
+		{
+			std::uint64_t timestamp = 0;
+			std::uint32_t site = 0;
+			std::uint32_t type = 0;
+		};
+
+		/// power of two
+		static const std::size_t capacity = 16384;
+
+		std::array<event, capacity> events;
+		std::atomic<std::size_t> enqueue_pos = {0};
+		std::atomic<std::size_t> dequeue_pos = {0};
+		std::atomic<std::uint64_t> dropped = {0};
+		std::uint32_t thread_index = 0;
+
+		/// replay state, touched only by collect - scopes still open when a
+		/// frame is collected stay here and land in the frame they close in
+		struct open_scope
+		{
+			std::uint32_t site = 0;
+			std::uint64_t begin = 0;
+			std::uint64_t path_key = 0;
+		};
+		std::vector<open_scope> stack;
+	};
+
+	thread_buffer& local_buffer();
+
+	/// guards registration of new thread buffers
+	std::mutex _buffers_mutex;
+	/// one ring per thread that ever recorded, never shrinks
+	std::vector<std::unique_ptr<thread_buffer>> _buffers;
+
+	/// guards the site name table
+	mutable std::mutex _sites_mutex;
+	/// site id to name
+	std::vector<std::string> _site_names;
+
+	/// guards the last-frame snapshot
+	mutable std::mutex _result_mutex;
+	/// aggregated result of the last collect
+	std::vector<sample> _last_frame;
+
+	std::atomic<bool> _enabled = {true};
+};
+
+//-----------------------------------------------------------------------------
+//  Name : scoped_perf_timer (Class)
+/// <summary>
+/// RAII pair of profiler events. Use through PROFILE_SCOPE.
+/// </summary>
+//-----------------------------------------------------------------------------
+class scoped_perf_timer
+{
+public:
+	scoped_perf_timer(std::uint32_t site)
+		: _site(site)
+		, _active(profiler::get_instance().is_enabled())
+	{
+		if(_active)
+		{
+			profiler::get_instance().push_event(_site, profiler::event_begin);
+		}
+	}
+
+	~scoped_perf_timer()
+	{
+		if(_active)
+		{
+			profiler::get_instance().push_event(_site, profiler::event_end);
+		}
+	}
+
+private:
+	std::uint32_t _site = 0;
+	/// whether the begin event was recorded - keeps pairs matched when the
+	/// profiler is toggled inside a scope
+	bool _active = false;
+};
+}
+
+#define PROFILER_CONCAT_IMPL(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+
+/// Times the enclosing scope under the given name.
+#define PROFILE_SCOPE(name)                                                                                  \
+	static const std::uint32_t PROFILER_CONCAT(profiler_site_, __LINE__) =                                   \
+		core::profiler::get_instance().register_site(name);                                                  \
+	core::scoped_perf_timer PROFILER_CONCAT(profiler_scope_, __LINE__)(                                      \
+		PROFILER_CONCAT(profiler_site_, __LINE__))
@@ -12,6 +12,9 @@
 #include "rttr/rttr_enable.h"
 #include "rttr/type.h"
 
+#include <mutex>
+#include <vector>
+
 #define CAT_IMPL_(a, b) a##b
 #define CAT_(a, b) CAT_IMPL_(a, b)
 #ifdef __COUNTER__
@@ -22,17 +25,121 @@
 
 namespace refl_detail
 {
+//-----------------------------------------------------------------------------
+//  Name : get_pending_registrations ()
+/// <summary>
+/// Registration bodies recorded at static init and not yet executed.
+/// </summary>
+//-----------------------------------------------------------------------------
+inline std::vector<void (*)()>& get_pending_registrations()
+{
+	static std::vector<void (*)()> pending;
+	return pending;
+}
+
+inline std::mutex& get_pending_registrations_mutex()
+{
+	static std::mutex mutex;
+	return mutex;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : reg_function ()
+/// <summary>
+/// Per-type slot holding the registration body recorded at static init.
+/// The registration macros expand inside the type's own namespace, so
+/// the body can only be named there - it reaches this slot as a plain
+/// pointer.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T>
+inline void (*&reg_function())()
+{
+	static void (*f)() = nullptr;
+	return f;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : execute_reg_once ()
+/// <summary>
+/// Runs a type's registration body exactly once, no matter whether it is
+/// reached through a first-use trigger, warm_up(), or both.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T>
+void execute_reg_once()
+{
+	static const int once = []() {
+		auto f = reg_function<T>();
+		if(nullptr != f)
+			f();
+		return 0;
+	}();
+	(void)once;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : get_reg ()
+/// <summary>
+/// Static-init hook behind REFLECT_EXTERN / REFLECT_INLINE. Registration
+/// bodies are expensive - hundreds of rttr constructions per type - so
+/// static init only records the body and the work runs on first
+/// reflection use (reflection::ensure<T>()) or when the process opts
+/// into everything (reflection::warm_up()). A binary that never reflects
+/// pays one pointer push per type before main.
+/// </summary>
+//-----------------------------------------------------------------------------
 template <typename T>
 inline int get_reg(void (*f)())
 {
 	static const int s = [&f]() {
-		f();
+		reg_function<T>() = f;
+		std::lock_guard<std::mutex> lock(get_pending_registrations_mutex());
+		get_pending_registrations().push_back(&execute_reg_once<T>);
 		return 0;
 	}();
 	return s;
 }
 }
 
+namespace reflection
+{
+//-----------------------------------------------------------------------------
+//  Name : ensure ()
+/// <summary>
+/// Executes the registration body recorded for one type, if it has not
+/// run yet. Call before the first rttr query against that type.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T>
+inline void ensure()
+{
+	refl_detail::execute_reg_once<T>();
+}
+
+//-----------------------------------------------------------------------------
+//  Name : warm_up ()
+/// <summary>
+/// Executes every registration body recorded so far. The editor calls
+/// this once at startup - inspectors and component enumeration genuinely
+/// need the full metadata - while the shipped runtime never does and
+/// skips the work entirely.
+/// </summary>
+//-----------------------------------------------------------------------------
+inline void warm_up()
+{
+	std::vector<void (*)()> run;
+	{
+		std::lock_guard<std::mutex> lock(refl_detail::get_pending_registrations_mutex());
+		run.swap(refl_detail::get_pending_registrations());
+	}
+	for(auto f : run)
+	{
+		f();
+	}
+}
+}
+
 #define REFLECT_INLINE(cls)                                                                                  \
 	template <typename T>                                                                                    \
 	extern void rttr_auto_register_reflection_function_t();                                                  \
@@ -8,8 +8,160 @@
 //}
 
 #include "cereal/archives/binary.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
 namespace cereal
 {
 using oarchive_binary_t = BinaryOutputArchive;
 using iarchive_binary_t = BinaryInputArchive;
 }
+
+namespace serialization
+{
+
+//-----------------------------------------------------------------------------
+//  Name : memory_input_archive (Class)
+/// <summary>
+/// Binary input archive over a raw memory region - the same wire format
+/// as iarchive_binary_t, but reads advance a bounds-checked pointer
+/// instead of funnelling through std::istream. Deserializing compiled
+/// assets straight out of a pack mapping or memory mapped file skips the
+/// stream buffer layer entirely; the caller keeps the region alive for
+/// the archive's lifetime.
+/// </summary>
+//-----------------------------------------------------------------------------
+class memory_input_archive
+	: public cereal::InputArchive<memory_input_archive, cereal::AllowEmptyClassElision>
+{
+public:
+	memory_input_archive(const std::uint8_t* data, std::size_t size)
+		: cereal::InputArchive<memory_input_archive, cereal::AllowEmptyClassElision>(this)
+		, _cursor(data)
+		, _end(data + size)
+	{
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : loadBinary ()
+	/// <summary>
+	/// Copies 'size' bytes to 'dest' and advances; throws the cereal
+	/// exception the callers already handle when the region is exhausted.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void loadBinary(void* const dest, std::size_t size)
+	{
+		if(static_cast<std::size_t>(_end - _cursor) < size)
+		{
+			throw cereal::Exception("memory_input_archive: read past the end of the region");
+		}
+
+		std::memcpy(dest, _cursor, size);
+		_cursor += size;
+	}
+
+private:
+	const std::uint8_t* _cursor;
+	const std::uint8_t* _end;
+};
+
+template <typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+CEREAL_LOAD_FUNCTION_NAME(memory_input_archive& ar, T& t)
+{
+	ar.loadBinary(std::addressof(t), sizeof(t));
+}
+
+template <typename T>
+inline void CEREAL_SERIALIZE_FUNCTION_NAME(memory_input_archive& ar, cereal::NameValuePair<T>& t)
+{
+	ar(t.value);
+}
+
+template <typename T>
+inline void CEREAL_SERIALIZE_FUNCTION_NAME(memory_input_archive& ar, cereal::SizeTag<T>& t)
+{
+	ar(t.size);
+}
+
+template <typename T>
+inline void CEREAL_LOAD_FUNCTION_NAME(memory_input_archive& ar, cereal::BinaryData<T>& bd)
+{
+	ar.loadBinary(bd.data, static_cast<std::size_t>(bd.size));
+}
+} // namespace serialization
+
+CEREAL_REGISTER_ARCHIVE(serialization::memory_input_archive)
+
+namespace serialization
+{
+
+//-----------------------------------------------------------------------------
+//  Name : varint (Struct)
+/// <summary>
+/// Unsigned LEB128 wrapper for the binary archives. Entity ids, counts
+/// and list sizes are overwhelmingly small, so encoding them seven bits
+/// per byte shrinks them to one or two bytes instead of a fixed eight.
+/// Wrap a value in it where the small-integer assumption holds; the
+/// fixed-width encoding stays the default for everything else.
+/// </summary>
+//-----------------------------------------------------------------------------
+struct varint
+{
+	varint() = default;
+	explicit varint(std::uint64_t v)
+		: value(v)
+	{
+	}
+
+	std::uint64_t value = 0;
+};
+
+inline void CEREAL_SAVE_FUNCTION_NAME(cereal::oarchive_binary_t& ar, const varint& v)
+{
+	std::uint64_t value = v.value;
+	std::uint8_t byte = 0;
+	do
+	{
+		byte = value & 0x7fu;
+		value >>= 7;
+		if(value != 0)
+		{
+			byte |= 0x80u;
+		}
+		ar(byte);
+	} while(value != 0);
+}
+
+inline void CEREAL_LOAD_FUNCTION_NAME(cereal::iarchive_binary_t& ar, varint& v)
+{
+	v.value = 0;
+	std::uint8_t byte = 0;
+	for(std::uint32_t shift = 0; shift < 64; shift += 7)
+	{
+		ar(byte);
+		v.value |= static_cast<std::uint64_t>(byte & 0x7fu) << shift;
+		if((byte & 0x80u) == 0)
+		{
+			break;
+		}
+	}
+}
+
+inline void CEREAL_LOAD_FUNCTION_NAME(memory_input_archive& ar, varint& v)
+{
+	v.value = 0;
+	std::uint8_t byte = 0;
+	for(std::uint32_t shift = 0; shift < 64; shift += 7)
+	{
+		ar(byte);
+		v.value |= static_cast<std::uint64_t>(byte & 0x7fu) << shift;
+		if((byte & 0x80u) == 0)
+		{
+			break;
+		}
+	}
+}
+} // namespace serialization
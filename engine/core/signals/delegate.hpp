@@ -57,6 +57,10 @@ class delegate<R(A...)>
 		void (*function_pointer)();
 		void (undefined_class::*member_pointer)();
 		pairtype pair;
+		// widens the small-buffer so typical capturing lambdas (a handful
+		// of pointers and references) stay inline instead of heap
+		// allocating on connect
+		char inline_capture[64];
 	};
 
 	union any_data {
@@ -309,6 +313,9 @@ class delegate<R(A...)>
 	any_data functor_;
 	manager_type manager_ = nullptr;
 	invoker_type invoker_ = nullptr;
+	/// resolved functor/object pointer, refreshed whenever the stored
+	/// functor changes so dispatch skips the manager indirection
+	void* object_cache_ = nullptr;
 
 public:
 	delegate() = default;
@@ -326,6 +333,7 @@ public:
 			invoker_ = rhs.invoker_;
 			manager_ = rhs.manager_;
 			manager_->clone_type_(functor_, rhs.functor_);
+			refresh_object_cache();
 		}
 	}
 
@@ -379,6 +387,7 @@ public:
 
 			invoker_ = &functor_stub<functor_type>;
 			manager_ = &man;
+			refresh_object_cache();
 		}
 	}
 
@@ -401,6 +410,7 @@ public:
 			manager_->destroy_type_(functor_);
 			manager_ = nullptr;
 			invoker_ = nullptr;
+			object_cache_ = nullptr;
 		}
 		return *this;
 	}
@@ -498,6 +508,11 @@ public:
 		std::swap(functor_, other.functor_);
 		std::swap(manager_, other.manager_);
 		std::swap(invoker_, other.invoker_);
+
+		// locally stored functors live inside functor_ itself, so the
+		// cached pointers must be recomputed rather than swapped
+		refresh_object_cache();
+		other.refresh_object_cache();
 	}
 
 	bool operator==(delegate const& rhs) const noexcept
@@ -538,19 +553,19 @@ public:
 
 	R operator()(A... args) const
 	{
-		void* object_ptr = get_object_ptr();
-		assert(object_ptr);
-		return invoker_(object_ptr, std::forward<A>(args)...);
+		assert(object_cache_);
+		return invoker_(object_cache_, std::forward<A>(args)...);
 	}
 
 private:
 	void* get_object_ptr() const
 	{
-		if(manager_)
-		{
-			return manager_->get_pointer_type_(functor_);
-		}
-		return nullptr;
+		return object_cache_;
+	}
+
+	void refresh_object_cache()
+	{
+		object_cache_ = manager_ ? manager_->get_pointer_type_(functor_) : nullptr;
 	}
 
 	friend struct std::hash<delegate>;
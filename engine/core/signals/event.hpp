@@ -4,6 +4,7 @@
 
 #include "delegate.hpp"
 #include <algorithm>
+#include <cstddef>
 #include <utility>
 #include <vector>
 
@@ -125,11 +126,16 @@ public:
 
 	/// Emits the events you wish to send to the call-backs
 	/// \param args The arguments to emit to the slots connected to the signal
+	/// \note Walks the flat subscriber array directly. Arguments are
+	/// passed, not forwarded - a by-value argument must never be moved
+	/// out from under the remaining slots.
 	void emit(Args... args) const
 	{
-		for(auto& slot : _slots)
+		const auto* slots = _slots.data();
+		const auto count = _slots.size();
+		for(std::size_t i = 0; i < count; ++i)
 		{
-			slot(std::forward<Args>(args)...);
+			slots[i](args...);
 		}
 	}
 
@@ -24,6 +24,11 @@ void simulation::run_one_frame(bool is_active)
 	{
 		duration_t target_duration = 1000ms / max_fps;
 
+		// Hybrid pacing: sleep through the coarse part of the wait but
+		// keep a margin for OS sleep granularity, then yield-spin to the
+		// exact deadline. A plain sleep_for routinely overshoots by a
+		// millisecond or more, which reads as judder at a 60Hz cap.
+		const duration_t spin_margin = 2ms;
 		for(;;)
 		{
 			elapsed = clock_t::now() - _last_frame_timepoint;
@@ -34,19 +39,24 @@ void simulation::run_one_frame(bool is_active)
 			{
 				break;
 			}
-			duration_t sleep_time = (target_duration - elapsed);
-			auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(sleep_time);
-
-			if(sleep_time > std::chrono::microseconds(1000))
+			duration_t remaining = target_duration - elapsed;
+			if(remaining > spin_margin)
 			{
-				if(ms.count() > 0)
-				{
-					sleep_time /= ms.count();
-				}
-
-				std::this_thread::sleep_for(sleep_time);
+				std::this_thread::sleep_for(remaining - spin_margin);
+			}
+			else
+			{
+				std::this_thread::yield();
 			}
 		}
+
+		// How far past the deadline we actually woke; by construction the
+		// spin keeps this near the scheduler's yield latency.
+		const duration_t pacing_error =
+			elapsed > target_duration ? elapsed - target_duration : duration_t::zero();
+		_last_pacing_error = pacing_error;
+		_avg_pacing_error += (pacing_error - _avg_pacing_error) / pacing_error_smoothing;
+		_max_pacing_error = std::max(_max_pacing_error, pacing_error);
 	}
 
 	if(elapsed < duration_t(0))
@@ -84,9 +94,70 @@ void simulation::run_one_frame(bool is_active)
 		_timestep = elapsed;
 	}
 
+	// Fixed-step accumulation runs on the same smoothed, clamped timeline
+	// the variable delta reports, so the two never drift apart.
+	if(_fixed_timestep > duration_t::zero())
+	{
+		_fixed_accumulator += _timestep;
+		_fixed_updates = 0;
+		while(_fixed_accumulator >= _fixed_timestep && _fixed_updates < _max_fixed_updates)
+		{
+			_fixed_accumulator -= _fixed_timestep;
+			++_fixed_updates;
+		}
+
+		// Past the catch-up cap the excess time is dropped - simulation
+		// appears to slow during a long hitch rather than spiraling.
+		if(_fixed_accumulator >= _fixed_timestep)
+		{
+			_fixed_accumulator = duration_t::zero();
+		}
+	}
+	else
+	{
+		_fixed_accumulator = duration_t::zero();
+		_fixed_updates = 0;
+	}
+
 	++_frame;
 }
 
+void simulation::set_fixed_time_step(duration_t step)
+{
+	_fixed_timestep = std::max(step, duration_t::zero());
+	if(_fixed_timestep == duration_t::zero())
+	{
+		_fixed_accumulator = duration_t::zero();
+		_fixed_updates = 0;
+	}
+}
+
+bool simulation::is_fixed_timestep() const
+{
+	return _fixed_timestep > duration_t::zero();
+}
+
+std::chrono::duration<float> simulation::get_fixed_delta_time() const
+{
+	return std::chrono::duration_cast<std::chrono::duration<float>>(_fixed_timestep);
+}
+
+std::uint32_t simulation::get_fixed_updates() const
+{
+	return _fixed_updates;
+}
+
+float simulation::get_interpolation_alpha() const
+{
+	if(_fixed_timestep == duration_t::zero())
+	{
+		return 0.0f;
+	}
+
+	return std::chrono::duration_cast<std::chrono::duration<float>>(_fixed_accumulator).count() /
+		   std::chrono::duration_cast<std::chrono::duration<float>>(_fixed_timestep).count();
+}
+
 void simulation::set_min_fps(unsigned int fps)
 {
 	_min_fps = std::max<unsigned int>(fps, 0);
@@ -107,6 +178,28 @@ void simulation::set_time_smoothing_step(unsigned int step)
 	_smoothing_step = step;
 }
 
+std::chrono::duration<float, std::milli> simulation::get_last_pacing_error() const
+{
+	return std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(_last_pacing_error);
+}
+
+std::chrono::duration<float, std::milli> simulation::get_average_pacing_error() const
+{
+	return std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(_avg_pacing_error);
+}
+
+std::chrono::duration<float, std::milli> simulation::get_max_pacing_error() const
+{
+	return std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(_max_pacing_error);
+}
+
+void simulation::reset_pacing_stats()
+{
+	_last_pacing_error = duration_t::zero();
+	_avg_pacing_error = duration_t::zero();
+	_max_pacing_error = duration_t::zero();
+}
+
 simulation::duration_t simulation::get_time_since_launch() const
 {
 	return clock_t::now() - _launch_timepoint;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <vector>
 
 namespace core
@@ -81,6 +82,86 @@ struct simulation
 	//-----------------------------------------------------------------------------
 	void set_time_smoothing_step(unsigned int);
 
+	//-----------------------------------------------------------------------------
+	//  Name : set_fixed_time_step ()
+	/// <summary>
+	/// Enables fixed-timestep simulation at the given step, zero to
+	/// disable. Each frame accumulates the (smoothed) elapsed time and
+	/// reports via get_fixed_updates() how many fixed ticks to run, so
+	/// simulation cost stops scaling with display refresh.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_fixed_time_step(duration_t step);
+
+	//-----------------------------------------------------------------------------
+	//  Name : is_fixed_timestep ()
+	/// <summary>
+	/// Whether fixed-timestep simulation is enabled.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool is_fixed_timestep() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_fixed_delta_time ()
+	/// <summary>
+	/// The fixed step in seconds; what every fixed tick advances by.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::chrono::duration<float> get_fixed_delta_time() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_fixed_updates ()
+	/// <summary>
+	/// Number of fixed ticks the accumulator yielded for this frame.
+	/// Zero when fixed-timestep mode is disabled.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::uint32_t get_fixed_updates() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_interpolation_alpha ()
+	/// <summary>
+	/// Fraction [0,1) of a fixed step left in the accumulator - how far
+	/// the render frame sits between the last two simulation ticks.
+	/// Rendering interpolates snapshotted state by this.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	float get_interpolation_alpha() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_last_pacing_error ()
+	/// <summary>
+	/// How far past the frame-cap deadline the previous frame actually
+	/// woke. Zero when no cap is set or the frame ran over on its own.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::chrono::duration<float, std::milli> get_last_pacing_error() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_average_pacing_error ()
+	/// <summary>
+	/// Exponential moving average of the pacing error across recent
+	/// capped frames.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::chrono::duration<float, std::milli> get_average_pacing_error() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_max_pacing_error ()
+	/// <summary>
+	/// Worst pacing error observed since launch (or the last reset).
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::chrono::duration<float, std::milli> get_max_pacing_error() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : reset_pacing_stats ()
+	/// <summary>
+	/// Clears the accumulated pacing-error statistics.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void reset_pacing_stats();
+
 	//-----------------------------------------------------------------------------
 	//  Name : get_time_since_launch ()
 	/// <summary>
@@ -117,6 +198,23 @@ protected:
 
 	/// next frame time step in seconds
 	duration_t _timestep = duration_t::zero();
+	/// fixed simulation step; zero means variable-timestep mode
+	duration_t _fixed_timestep = duration_t::zero();
+	/// frame time not yet consumed by fixed ticks
+	duration_t _fixed_accumulator = duration_t::zero();
+	/// fixed ticks the current frame should run
+	std::uint32_t _fixed_updates = 0;
+	/// catch-up cap per frame; a hitch beyond it drops the excess time so
+	/// simulation slows down instead of snowballing further behind
+	std::uint32_t _max_fixed_updates = 4;
+	/// EMA weight for the average pacing error (1/N per sample)
+	static const duration_t::rep pacing_error_smoothing = 16;
+	/// how far past the cap deadline the previous frame woke
+	duration_t _last_pacing_error = duration_t::zero();
+	/// exponential moving average of recent pacing errors
+	duration_t _avg_pacing_error = duration_t::zero();
+	/// worst pacing error observed since launch/reset
+	duration_t _max_pacing_error = duration_t::zero();
 	/// current frame
 	std::uint64_t _frame = 0;
 	/// how many frames to average for the smoothed time step
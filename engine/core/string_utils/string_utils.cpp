@@ -2,12 +2,101 @@
 #include <chrono>
 #include <thread>
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRING_UTILS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+inline char to_lower_ascii(char c)
+{
+	return (c >= 'A' && c <= 'Z') ? char(c + ('a' - 'A')) : c;
+}
+
+#ifdef STRING_UTILS_SSE2
+inline __m128i fold_lower_ascii(__m128i v)
+{
+	// add 0x20 to every byte in the ['A'..'Z'] range, leave the rest alone
+	const __m128i above = _mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1));
+	const __m128i below = _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), v);
+	const __m128i mask = _mm_and_si128(above, below);
+	return _mm_add_epi8(v, _mm_and_si128(mask, _mm_set1_epi8(0x20)));
+}
+
+inline __m128i fold_upper_ascii(__m128i v)
+{
+	// subtract 0x20 from every byte in the ['a'..'z'] range
+	const __m128i above = _mm_cmpgt_epi8(v, _mm_set1_epi8('a' - 1));
+	const __m128i below = _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), v);
+	const __m128i mask = _mm_and_si128(above, below);
+	return _mm_sub_epi8(v, _mm_and_si128(mask, _mm_set1_epi8(0x20)));
+}
+#endif
+}
+
 int string_utils::compare(const std::string& s1, const std::string& s2, bool ignoreCase)
 {
 	if(!ignoreCase)
 		return s1.compare(s2);
 	else
-		return StrICmp()(s1, s2);
+		return icompare(s1, s2);
+}
+
+int string_utils::icompare(const std::string& s1, const std::string& s2)
+{
+	const std::size_t length = std::min(s1.size(), s2.size());
+	std::size_t i = 0;
+
+#ifdef STRING_UTILS_SSE2
+	while(i + 16 <= length)
+	{
+		const __m128i c1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1.data() + i));
+		const __m128i c2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s2.data() + i));
+		const __m128i eq = _mm_cmpeq_epi8(fold_lower_ascii(c1), fold_lower_ascii(c2));
+		if(_mm_movemask_epi8(eq) != 0xffff)
+		{
+			// let the scalar loop find the first differing character
+			break;
+		}
+		i += 16;
+	}
+#endif
+
+	for(; i < length; ++i)
+	{
+		const char c1 = to_lower_ascii(s1[i]);
+		const char c2 = to_lower_ascii(s2[i]);
+		if(c1 != c2)
+			return c1 < c2 ? -1 : 1;
+	}
+
+	if(s1.size() == s2.size())
+		return 0;
+	return s1.size() < s2.size() ? -1 : 1;
+}
+
+std::uint64_t string_utils::hash(const std::string& str)
+{
+	// FNV-1a
+	std::uint64_t h = 14695981039346656037ull;
+	for(char c : str)
+	{
+		h ^= static_cast<unsigned char>(c);
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+std::uint64_t string_utils::ihash(const std::string& str)
+{
+	std::uint64_t h = 14695981039346656037ull;
+	for(char c : str)
+	{
+		h ^= static_cast<unsigned char>(to_lower_ascii(c));
+		h *= 1099511628211ull;
+	}
+	return h;
 }
 
 std::string string_utils::trim(const std::string& str)
@@ -70,14 +159,38 @@ std::vector<std::string> string_utils::split(const std::string& text, char sep,
 std::string string_utils::to_upper(const std::string& str)
 {
 	std::string s(str);
-	std::transform(s.begin(), s.end(), s.begin(), toupper);
+	std::string::size_type i = 0;
+
+#ifdef STRING_UTILS_SSE2
+	for(; i + 16 <= s.size(); i += 16)
+	{
+		char* block = &s[i];
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(block), fold_upper_ascii(v));
+	}
+#endif
+
+	std::transform(s.begin() + static_cast<std::string::difference_type>(i), s.end(),
+				   s.begin() + static_cast<std::string::difference_type>(i), toupper);
 	return s;
 }
 
 std::string string_utils::to_lower(const std::string& str)
 {
 	std::string s(str);
-	std::transform(s.begin(), s.end(), s.begin(), tolower);
+	std::string::size_type i = 0;
+
+#ifdef STRING_UTILS_SSE2
+	for(; i + 16 <= s.size(); i += 16)
+	{
+		char* block = &s[i];
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(block), fold_lower_ascii(v));
+	}
+#endif
+
+	std::transform(s.begin() + static_cast<std::string::difference_type>(i), s.end(),
+				   s.begin() + static_cast<std::string::difference_type>(i), tolower);
 	return s;
 }
 
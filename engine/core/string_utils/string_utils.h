@@ -5,6 +5,7 @@
 //-----------------------------------------------------------------------------
 #include <algorithm>
 #include <cctype> // toupper / tolower
+#include <cstdint>
 #include <locale>
 #include <random>
 #include <stdarg.h>
@@ -86,6 +87,34 @@ private:
 /// </summary>
 //-------------------------------------------------------------------------
 int compare(const std::string& s1, const std::string& s2, bool ignoreCase);
+
+//-------------------------------------------------------------------------
+//  Name : icompare ()
+/// <summary>
+/// ASCII case insensitive compare. Folds and compares sixteen characters
+/// at a time where SSE2 is available, falling back to a scalar loop for
+/// the remainder and on other targets.
+/// </summary>
+//-------------------------------------------------------------------------
+int icompare(const std::string& s1, const std::string& s2);
+
+//-------------------------------------------------------------------------
+//  Name : hash ()
+/// <summary>
+/// Fast non-cryptographic 64 bit hash (FNV-1a) of the string contents.
+/// </summary>
+//-------------------------------------------------------------------------
+std::uint64_t hash(const std::string& str);
+
+//-------------------------------------------------------------------------
+//  Name : ihash ()
+/// <summary>
+/// Same as hash but folds ASCII upper case characters to lower case while
+/// hashing, so two strings differing only in ASCII case share a hash.
+/// </summary>
+//-------------------------------------------------------------------------
+std::uint64_t ihash(const std::string& str);
+
 //-------------------------------------------------------------------------
 //  Name : trim()
 /// <summary>
@@ -37,6 +37,7 @@ void dispose()
 	context().dispose();
 	context() = {};
 	status() = internal_status::disposed;
+	++epoch();
 }
 
 subsystem_context& context()
@@ -45,6 +46,14 @@ subsystem_context& context()
 	return s_context;
 }
 
+std::uint64_t& epoch()
+{
+	// Starts at 1 so a default-constructed cached reference (epoch 0) is
+	// always treated as stale.
+	static std::uint64_t s_epoch = 1;
+	return s_epoch;
+}
+
 bool initialize()
 {
 	if(!context().initialize())
@@ -4,7 +4,10 @@
 #include "../common/nonstd/type_traits.hpp"
 
 #include <algorithm>
+#include <cstdint>
+#include <deque>
 #include <memory>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -42,6 +45,22 @@ struct subsystem_context
 	template <typename S, typename... Args>
 	S& add_subsystem(Args&&...);
 
+	//-----------------------------------------------------------------------------
+	//  Name : install_subsystem ()
+	/// <summary>
+	/// Registers an externally constructed subsystem under its type
+	/// index. Used by subsystem_batch, which constructs instances
+	/// concurrently and registers them afterwards in declaration order.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void install_subsystem(std::size_t index, std::shared_ptr<void> subsystem)
+	{
+		expects(_subsystems.find(index) == _subsystems.end() && "duplicated subsystem");
+
+		_orders.push_back(index);
+		_subsystems.emplace(std::make_pair(index, std::move(subsystem)));
+	}
+
 	//-----------------------------------------------------------------------------
 	//  Name : get_subsystem ()
 	/// <summary>
@@ -201,6 +220,16 @@ void dispose();
 /// </summary>
 //-----------------------------------------------------------------------------
 subsystem_context& context();
+
+//-----------------------------------------------------------------------------
+//  Name : epoch ()
+/// <summary>
+/// Monotonic counter bumped whenever a subsystem is removed or the whole
+/// context is disposed. Lets cached subsystem references detect that a
+/// previously resolved pointer may have gone away.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::uint64_t& epoch();
 }
 
 template <typename S>
@@ -221,7 +250,10 @@ template <typename S>
 void remove_subsystem()
 {
 	if(details::status() == details::internal_status::running)
+	{
 		details::context().remove_subsystem<S>();
+		++details::epoch();
+	}
 }
 
 template <typename... Args>
@@ -231,4 +263,138 @@ bool has_subsystems()
 			   ? false
 			   : details::context().has_subsystems<Args...>();
 }
+
+//-----------------------------------------------------------------------------
+//  Name : subsystem_ref (Class)
+/// <summary>
+/// Memoized access to a subsystem. Resolves the type-map lookup once and
+/// then hands out the pinned pointer; the cached pointer is re-resolved
+/// whenever a subsystem was removed or the context was torn down since
+/// the last lookup (tracked via details::epoch). Hot per-frame paths pay
+/// a counter compare and a dereference instead of a hash-map probe.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename S>
+class subsystem_ref
+{
+public:
+	S& get()
+	{
+		const auto current_epoch = details::epoch();
+		if(_cached == nullptr || _epoch != current_epoch)
+		{
+			_cached = &core::get_subsystem<S>();
+			_epoch = current_epoch;
+		}
+		return *_cached;
+	}
+
+	S& operator*()
+	{
+		return get();
+	}
+	S* operator->()
+	{
+		return &get();
+	}
+
+private:
+	S* _cached = nullptr;
+	std::uint64_t _epoch = 0;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : subsystem_batch (Class)
+/// <summary>
+/// Concurrent construction for a group of mutually independent
+/// subsystems. Dependencies are declared by batch boundaries: members of
+/// one batch must not depend on each other - nor resolve or register
+/// other subsystems while constructing - and commit() registers the
+/// whole batch, in declaration order, before returning. Anything that
+/// depends on a batch member goes after commit() or in a later batch.
+/// Used at application startup, where device opens and archive mounts
+/// otherwise serialize behind one another.
+/// </summary>
+//-----------------------------------------------------------------------------
+class subsystem_batch
+{
+public:
+	~subsystem_batch()
+	{
+		commit();
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : add ()
+	/// <summary>
+	/// Begins constructing S concurrently from its constructor arguments,
+	/// taken by value - the construction outlives this call.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <typename S, typename... Args>
+	void add(Args... args)
+	{
+		add_with<S>([args...]() mutable { return std::make_shared<S>(std::move(args)...); });
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : add_with ()
+	/// <summary>
+	/// Begins constructing S concurrently through a custom factory
+	/// returning std::shared_ptr<S>, for subsystems that need
+	/// post-construction setup (mounting, loading) folded into the
+	/// concurrent work.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <typename S, typename F>
+	void add_with(F construct)
+	{
+		expects(details::status() == details::internal_status::running &&
+				"details::context must be initialized");
+
+		_entries.emplace_back();
+		auto& entry = _entries.back();
+		entry.index = rtti::type_id<S>().hash_code();
+		_threads.emplace_back([&entry, construct]() mutable { entry.instance = construct(); });
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : commit ()
+	/// <summary>
+	/// Waits for every pending construction and registers the batch in
+	/// declaration order. Safe to call repeatedly; the destructor calls
+	/// it as a backstop.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void commit()
+	{
+		for(auto& thread : _threads)
+		{
+			if(thread.joinable())
+				thread.join();
+		}
+		_threads.clear();
+
+		for(auto& entry : _entries)
+		{
+			details::context().install_subsystem(entry.index, std::move(entry.instance));
+		}
+		_entries.clear();
+	}
+
+private:
+	struct entry
+	{
+		/// Type index the instance registers under.
+		std::size_t index = 0;
+		/// The constructed instance, written by the construction thread.
+		std::shared_ptr<void> instance;
+	};
+
+	/// Deque for reference stability - construction threads write into
+	/// their entry while later adds grow the container.
+	std::deque<entry> _entries;
+	/// One construction thread per entry, joined by commit().
+	std::vector<std::thread> _threads;
+};
 }
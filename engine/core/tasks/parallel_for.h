@@ -0,0 +1,115 @@
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include "task_system.h"
+#include <vector>
+
+namespace core
+{
+namespace detail
+{
+//-----------------------------------------------------------------------------
+//  Name : pick_grain ()
+/// <summary>
+/// Grain used when the caller passes 0 - a handful of chunks per worker
+/// so stealing can still balance uneven iteration costs.
+/// </summary>
+//-----------------------------------------------------------------------------
+inline std::size_t pick_grain(const task_system& system, std::size_t count)
+{
+	const std::size_t workers = std::max<std::size_t>(1, system.get_threads_count() - 1);
+	return std::max<std::size_t>(1, count / (workers * 4));
+}
+}
+
+//-----------------------------------------------------------------------------
+//  Name : parallel_for ()
+/// <summary>
+/// Runs fn(chunk_begin, chunk_end) over [begin, end) split into chunks of
+/// roughly grain iterations, spread over the worker threads. A grain of 0
+/// picks one automatically. The calling thread runs the first chunk
+/// itself and helps drain the queues while joining, so the call never
+/// idles a thread. Returns when every chunk has completed.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <class F>
+void parallel_for(task_system& system, std::size_t begin, std::size_t end, std::size_t grain, F&& fn)
+{
+	if(end <= begin)
+		return;
+
+	const std::size_t count = end - begin;
+	if(grain == 0)
+		grain = detail::pick_grain(system, count);
+
+	if(count <= grain)
+	{
+		fn(begin, end);
+		return;
+	}
+
+	std::vector<task_future<void>> chunks;
+	chunks.reserve(count / grain);
+	for(std::size_t chunk_begin = begin + grain; chunk_begin < end; chunk_begin += grain)
+	{
+		const std::size_t chunk_end = std::min(chunk_begin + grain, end);
+		// The join below outlives every chunk, so capturing fn by
+		// reference is safe.
+		chunks.emplace_back(system.push_on_worker_thread(
+			[&fn, chunk_begin, chunk_end]() { fn(chunk_begin, chunk_end); }));
+	}
+
+	fn(begin, begin + grain);
+
+	for(auto& chunk : chunks)
+	{
+		chunk.wait();
+	}
+}
+
+//-----------------------------------------------------------------------------
+//  Name : parallel_reduce ()
+/// <summary>
+/// Runs map_fn(chunk_begin, chunk_end) over [begin, end) split like
+/// parallel_for and folds the per-chunk results with reduce_fn, seeded
+/// with identity. Chunk results are combined in range order, so
+/// non-commutative reductions behave like the serial loop.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <class T, class MapF, class ReduceF>
+T parallel_reduce(task_system& system, std::size_t begin, std::size_t end, std::size_t grain, T identity,
+				  MapF&& map_fn, ReduceF&& reduce_fn)
+{
+	if(end <= begin)
+		return identity;
+
+	const std::size_t count = end - begin;
+	if(grain == 0)
+		grain = detail::pick_grain(system, count);
+
+	if(count <= grain)
+	{
+		return reduce_fn(std::move(identity), map_fn(begin, end));
+	}
+
+	std::vector<task_future<T>> chunks;
+	chunks.reserve(count / grain);
+	for(std::size_t chunk_begin = begin + grain; chunk_begin < end; chunk_begin += grain)
+	{
+		const std::size_t chunk_end = std::min(chunk_begin + grain, end);
+		chunks.emplace_back(system.push_on_worker_thread(
+			[&map_fn, chunk_begin, chunk_end]() { return map_fn(chunk_begin, chunk_end); }));
+	}
+
+	T result = reduce_fn(std::move(identity), map_fn(begin, begin + grain));
+
+	for(auto& chunk : chunks)
+	{
+		result = reduce_fn(std::move(result), chunk.get());
+	}
+
+	return result;
+}
+} // namespace core
+
+#endif // #ifndef PARALLEL_FOR_H
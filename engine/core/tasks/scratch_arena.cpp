@@ -0,0 +1,49 @@
+#include "scratch_arena.h"
+
+#include <new>
+
+namespace core
+{
+
+scratch_arena& scratch_arena::get_local()
+{
+	static thread_local scratch_arena arena;
+	return arena;
+}
+
+void* scratch_arena::allocate(std::size_t size, std::size_t alignment)
+{
+	if(!_buffer)
+	{
+		_buffer.reset(new std::uint8_t[_capacity]);
+	}
+
+	const std::size_t aligned = (_offset + (alignment - 1)) & ~(alignment - 1);
+	if(aligned + size <= _capacity)
+	{
+		_offset = aligned + size;
+		return _buffer.get() + aligned;
+	}
+
+	// Oversized or exhausted - the global allocator takes it. deallocate
+	// recognizes the pointer as foreign and frees it normally.
+	return ::operator new(size);
+}
+
+void scratch_arena::deallocate(void* ptr, std::size_t size)
+{
+	auto* bytes = static_cast<std::uint8_t*>(ptr);
+	if(_buffer && bytes >= _buffer.get() && bytes < _buffer.get() + _capacity)
+	{
+		// Free in LIFO order rewinds the bump pointer; anything else is
+		// reclaimed by the enclosing scope's rewind.
+		if(bytes + size == _buffer.get() + _offset)
+		{
+			_offset = static_cast<std::size_t>(bytes - _buffer.get());
+		}
+		return;
+	}
+
+	::operator delete(ptr);
+}
+}
@@ -0,0 +1,174 @@
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+//  Name : scratch_arena (Class)
+/// <summary>
+/// Thread-local bump allocator for transient allocations inside tasks.
+/// Allocation is a pointer bump into a block that is reused forever, so
+/// temporary containers built while gathering visibility or processing
+/// mesh chunks never touch the global allocator from many threads at
+/// once. The task system rewinds the arena around every task it runs;
+/// scratch memory must therefore not outlive the task that allocated
+/// it. Requests that do not fit the block fall back to the global
+/// allocator and are freed normally.
+/// </summary>
+//-----------------------------------------------------------------------------
+class scratch_arena
+{
+public:
+	//-----------------------------------------------------------------------------
+	//  Name : get_local ()
+	/// <summary>
+	/// The calling thread's arena. Created lazily on first use.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	static scratch_arena& get_local();
+
+	void* allocate(std::size_t size, std::size_t alignment);
+	void deallocate(void* ptr, std::size_t size);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_marker ()
+	/// <summary>
+	/// Current bump position, to rewind to later.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t get_marker() const
+	{
+		return _offset;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : rewind ()
+	/// <summary>
+	/// Drops everything allocated since the marker. The memory itself is
+	/// kept for reuse.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void rewind(std::size_t marker)
+	{
+		_offset = marker;
+	}
+
+	void reset()
+	{
+		rewind(0);
+	}
+
+	std::size_t get_capacity() const
+	{
+		return _capacity;
+	}
+
+private:
+	/// Big enough for the per-task temporaries we see; overflow falls
+	/// back to the global allocator rather than growing the block.
+	static const std::size_t default_capacity = 1024 * 1024;
+
+	/// Backing block, created on first allocation.
+	std::unique_ptr<std::uint8_t[]> _buffer;
+	std::size_t _capacity = default_capacity;
+	std::size_t _offset = 0;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : scratch_scope (Struct)
+/// <summary>
+/// RAII marker on the calling thread's arena - everything allocated
+/// inside the scope is dropped when it closes. Scopes nest, which is
+/// what makes arenas safe under processing_wait running tasks inside
+/// tasks.
+/// </summary>
+//-----------------------------------------------------------------------------
+struct scratch_scope
+{
+	scratch_scope()
+		: _arena(scratch_arena::get_local())
+		, _marker(_arena.get_marker())
+	{
+	}
+
+	~scratch_scope()
+	{
+		_arena.rewind(_marker);
+	}
+
+	scratch_scope(const scratch_scope&) = delete;
+	scratch_scope& operator=(const scratch_scope&) = delete;
+
+private:
+	scratch_arena& _arena;
+	std::size_t _marker;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : scratch_allocator (Class)
+/// <summary>
+/// STL-compatible adaptor over the calling thread's arena. Containers
+/// using it must stay within the task (or scratch_scope) that created
+/// them.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T>
+class scratch_allocator
+{
+public:
+	using value_type = T;
+
+	scratch_allocator()
+		: _arena(&scratch_arena::get_local())
+	{
+	}
+
+	template <typename U>
+	scratch_allocator(const scratch_allocator<U>& other)
+		: _arena(other.get_arena())
+	{
+	}
+
+	T* allocate(std::size_t n)
+	{
+		return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* ptr, std::size_t n)
+	{
+		_arena->deallocate(ptr, n * sizeof(T));
+	}
+
+	scratch_arena* get_arena() const
+	{
+		return _arena;
+	}
+
+private:
+	scratch_arena* _arena;
+};
+
+template <typename T, typename U>
+bool operator==(const scratch_allocator<T>& lhs, const scratch_allocator<U>& rhs)
+{
+	return lhs.get_arena() == rhs.get_arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const scratch_allocator<T>& lhs, const scratch_allocator<U>& rhs)
+{
+	return !(lhs == rhs);
+}
+
+/// The common case - a temporary vector that costs a pointer bump.
+template <typename T>
+using scratch_vector = std::vector<T, scratch_allocator<T>>;
+} // namespace core
+
+#endif // #ifndef SCRATCH_ARENA_H
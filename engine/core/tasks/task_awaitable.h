@@ -0,0 +1,167 @@
+#ifndef TASK_AWAITABLE_H
+#define TASK_AWAITABLE_H
+
+// Opt-in coroutine adapter for task_future. The engine itself builds as
+// C++14 and never includes this header; include it only from translation
+// units compiled with coroutine support (-fcoroutines / -fcoroutines-ts /
+// /await or a C++20 standard flag). With it, straight-line async code can
+// co_await a task_future instead of blocking a thread in wait() - the
+// coroutine suspends and resumes on a worker once the future is ready.
+
+#if defined(__cpp_impl_coroutine) || defined(__cpp_coroutines)
+
+#include "task_system.h"
+#include <exception>
+
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#else
+#include <experimental/coroutine>
+#endif
+
+namespace core
+{
+#if defined(__cpp_impl_coroutine)
+namespace coro = std;
+#else
+namespace coro = std::experimental;
+#endif
+
+//-----------------------------------------------------------------------------
+//  Name : task_awaiter (Class)
+/// <summary>
+/// Awaiter behind co_await on a task_future. Suspension schedules the
+/// resume as a continuation on a worker thread via then(), so no thread
+/// blocks while the future completes.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T>
+class task_awaiter
+{
+public:
+	explicit task_awaiter(const task_future<T>& future)
+		: _future(future)
+	{
+	}
+
+	bool await_ready() const
+	{
+		return _future.is_ready();
+	}
+
+	void await_suspend(coro::coroutine_handle<> handle)
+	{
+		// The value is picked up in await_resume; the continuation only
+		// carries the wake-up. Generic args absorb both void and valued
+		// futures.
+		_future.then([handle](auto&&...) mutable { handle.resume(); });
+	}
+
+	decltype(auto) await_resume()
+	{
+		return _future.get();
+	}
+
+private:
+	task_future<T> _future;
+};
+
+template <typename T>
+auto operator co_await(const task_future<T>& future)
+{
+	return task_awaiter<T>(future);
+}
+
+//-----------------------------------------------------------------------------
+//  Name : co_task (Struct)
+/// <summary>
+/// Minimal coroutine return type so call sites can actually write
+/// coroutines against the task system:
+///
+///     core::co_task<void> reload(runtime::asset_manager& am)
+///     {
+///         auto mesh = co_await am.load<mesh>(key);
+///         ...
+///     }
+///
+/// Runs eagerly on the calling thread until the first suspension, then
+/// resumes on workers. The wrapped future joins or chains it like any
+/// other task.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T>
+struct co_task
+{
+	struct promise_type
+	{
+		std::promise<T> result;
+
+		co_task get_return_object()
+		{
+			return co_task{task_future<T>::from_future(result.get_future())};
+		}
+
+		coro::suspend_never initial_suspend() noexcept
+		{
+			return {};
+		}
+
+		coro::suspend_never final_suspend() noexcept
+		{
+			return {};
+		}
+
+		void return_value(T value)
+		{
+			result.set_value(std::move(value));
+		}
+
+		void unhandled_exception()
+		{
+			result.set_exception(std::current_exception());
+		}
+	};
+
+	task_future<T> future;
+};
+
+template <>
+struct co_task<void>
+{
+	struct promise_type
+	{
+		std::promise<void> result;
+
+		co_task get_return_object()
+		{
+			return co_task{task_future<void>::from_future(result.get_future())};
+		}
+
+		coro::suspend_never initial_suspend() noexcept
+		{
+			return {};
+		}
+
+		coro::suspend_never final_suspend() noexcept
+		{
+			return {};
+		}
+
+		void return_void()
+		{
+			result.set_value();
+		}
+
+		void unhandled_exception()
+		{
+			result.set_exception(std::current_exception());
+		}
+	};
+
+	task_future<void> future;
+};
+} // namespace core
+
+#endif // coroutine support
+
+#endif // #ifndef TASK_AWAITABLE_H
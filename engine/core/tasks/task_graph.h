@@ -0,0 +1,123 @@
+#ifndef TASK_GRAPH_H
+#define TASK_GRAPH_H
+
+#include "task_system.h"
+#include <functional>
+#include <vector>
+
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+//  Name : task_graph (Class)
+/// <summary>
+/// Builder for pipelines of dependent tasks. Passing the future of one
+/// node as an argument to another declares the edge - the successor is
+/// queued as an awaitable task and only runs once every predecessor is
+/// ready, so no worker thread blocks in wait() between stages. Typical
+/// shape:
+///
+///     task_graph graph(ts);
+///     auto loaded = graph.add(load_mesh, key);
+///     auto uploaded = graph.add_on_owner_thread(upload_to_gpu, loaded);
+///     graph.add(resolve_materials, uploaded);
+///     graph.wait();
+///
+/// Build a graph from one thread; the nodes themselves run wherever they
+/// were scheduled.
+/// </summary>
+//-----------------------------------------------------------------------------
+class task_graph
+{
+public:
+	explicit task_graph(task_system& system)
+		: _system(system)
+	{
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : add ()
+	/// <summary>
+	/// Adds a node scheduled on a worker thread. Any task_future among the
+	/// arguments is a declared predecessor; its result is what f receives.
+	/// Returns the node's future for chaining further nodes.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <class F, class... Args>
+	auto add(F&& f, Args&&... args)
+	{
+		auto future = _system.push_on_worker_thread(std::forward<F>(f), std::forward<Args>(args)...);
+		track(future);
+		return future;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : add_on_owner_thread ()
+	/// <summary>
+	/// Same as add but the node runs on the owner thread - the usual shape
+	/// for GPU uploads and other main-thread-only stages.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <class F, class... Args>
+	auto add_on_owner_thread(F&& f, Args&&... args)
+	{
+		auto future = _system.push_on_owner_thread(std::forward<F>(f), std::forward<Args>(args)...);
+		track(future);
+		return future;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : is_ready ()
+	/// <summary>
+	/// Whether every node added so far has completed. Non-blocking.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool is_ready() const
+	{
+		for(const auto& node : _nodes)
+		{
+			if(!node.is_ready())
+				return false;
+		}
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : wait ()
+	/// <summary>
+	/// Blocks until every node added so far has completed. This is the one
+	/// deliberate sync point of a graph - intermediate edges never block.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void wait() const
+	{
+		for(const auto& node : _nodes)
+		{
+			node.wait();
+		}
+	}
+
+private:
+	struct node
+	{
+		std::function<bool()> is_ready;
+		std::function<void()> wait;
+	};
+
+	template <typename T>
+	void track(const task_future<T>& future)
+	{
+		node n;
+		n.is_ready = [future]() { return future.is_ready(); };
+		n.wait = [future]() { future.wait(); };
+		_nodes.emplace_back(std::move(n));
+	}
+
+	/// System the nodes are scheduled on.
+	task_system& _system;
+	/// Type-erased views of every node's future, for the join.
+	std::vector<node> _nodes;
+};
+} // namespace core
+
+#endif // #ifndef TASK_GRAPH_H
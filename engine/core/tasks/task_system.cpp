@@ -1,5 +1,6 @@
 #include "task_system.h"
 #include "../common/platform.h"
+#include "scratch_arena.h"
 #include <limits>
 
 namespace core
@@ -7,29 +8,78 @@ namespace core
 
 task::task_concept::~task_concept() noexcept = default;
 
-void task_system::task_queue::sort()
+void task_system::task_queue::sort(std::deque<task>& lane)
 {
-	if(_tasks.size() > 1)
+	if(lane.size() > 1)
 	{
-		std::stable_partition(_tasks.begin(), _tasks.end(), [](const auto& task1) { return task1.ready(); });
+		std::stable_partition(lane.begin(), lane.end(), [](const auto& task1) { return task1.ready(); });
 	}
 }
 
+std::size_t task_system::task_queue::count_tasks() const
+{
+	std::size_t count = 0;
+	for(const auto& lane : _lanes)
+	{
+		count += lane.size();
+	}
+	return count;
+}
+
 task_system::task_queue::task_queue()
-	: _tasks{}
+	: _lanes{}
+	, _sample_storage(sample_capacity)
+	, _samples(_sample_storage.begin(), _sample_storage.end())
 {
 }
 
 task_system::task_queue::task_queue(task_system::task_queue&& other) noexcept
-	: _tasks(std::move(other)._tasks)
-	, _done(other._done.load())
+	: _done(other._done.load())
+	, _sample_storage(sample_capacity)
+	, _samples(_sample_storage.begin(), _sample_storage.end())
 {
+	// Queues only move while the system is built, before any thread runs
+	// on them - dropping the (empty) telemetry of the source is fine.
+	for(std::size_t i = 0; i < lane_count; ++i)
+	{
+		_lanes[i] = std::move(other._lanes[i]);
+	}
 }
 
 std::size_t task_system::task_queue::get_pending_tasks() const
 {
 	std::lock_guard<std::mutex> lock(_mutex);
-	return _tasks.size();
+	return count_tasks();
+}
+
+task_system::queue_info task_system::task_queue::get_stats() const
+{
+	queue_info info;
+	info.pending_tasks = get_pending_tasks();
+
+	std::lock_guard<std::mutex> lock(_sample_mutex);
+	info.executed_tasks = _executed_tasks;
+	info.busy_time = _busy_time;
+	return info;
+}
+
+void task_system::task_queue::record_sample(const task_sample& s)
+{
+	std::lock_guard<std::mutex> lock(_sample_mutex);
+	_samples.push_back(s);
+	_executed_tasks++;
+	_busy_time += s.exec_time;
+}
+
+std::vector<task_system::task_sample> task_system::task_queue::drain_samples()
+{
+	std::lock_guard<std::mutex> lock(_sample_mutex);
+	std::vector<task_sample> samples(_samples.begin(), _samples.end());
+	while(!_samples.empty())
+	{
+		_samples.pop_front();
+	}
+	return samples;
 }
 
 void task_system::task_queue::set_done()
@@ -47,29 +97,73 @@ std::pair<bool, task> task_system::task_queue::try_pop()
 {
 	std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
 
-	if(!lock || _tasks.empty())
+	if(!lock)
 	{
 		return std::make_pair(false, task{});
 	}
-	else if(_tasks.front().ready())
+
+	for(auto& lane : _lanes)
 	{
-		auto t = std::move(_tasks.front());
-		_tasks.pop_front();
-		return std::make_pair(true, std::move(t));
+		if(lane.empty())
+			continue;
+
+		if(lane.front().ready())
+		{
+			auto t = std::move(lane.front());
+			lane.pop_front();
+			return std::make_pair(true, std::move(t));
+		}
+
+		sort(lane);
+	}
+
+	return std::make_pair(false, task{});
+}
+
+std::pair<bool, task> task_system::task_queue::try_steal()
+{
+	std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
+
+	if(!lock)
+	{
+		return std::make_pair(false, task{});
+	}
+
+	// Thieves take from the back while the owner pops from the front, so
+	// the two sides contend on the lock but not on the same tasks and the
+	// owner keeps its oldest work. Stealing is opportunistic - do not pay
+	// for sorting a victim's lanes, just fall back to the front if only
+	// that end is ready. Lanes are scanned in priority order like pop.
+	for(auto& lane : _lanes)
+	{
+		if(lane.empty())
+			continue;
+
+		if(lane.back().ready())
+		{
+			auto t = std::move(lane.back());
+			lane.pop_back();
+			return std::make_pair(true, std::move(t));
+		}
+		else if(lane.front().ready())
+		{
+			auto t = std::move(lane.front());
+			lane.pop_front();
+			return std::make_pair(true, std::move(t));
+		}
 	}
 
-	sort();
 	return std::make_pair(false, task{});
 }
 
-bool task_system::task_queue::try_push(task& t)
+bool task_system::task_queue::try_push(task& t, task_priority priority)
 {
 	{
 		std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
 		if(!lock)
 			return false;
 
-		_tasks.emplace_back(std::move(t));
+		_lanes[static_cast<std::size_t>(priority)].emplace_back(std::move(t));
 	}
 
 	_cv.notify_one();
@@ -81,7 +175,7 @@ std::pair<bool, task> task_system::task_queue::pop(duration_t pop_timeout)
 	std::unique_lock<std::mutex> lock(_mutex);
 	bool wait = pop_timeout > decltype(pop_timeout)(0);
 	bool timed_wait = pop_timeout != decltype(pop_timeout)::max();
-	if(wait && _tasks.empty())
+	if(wait && count_tasks() == 0)
 	{
 		if(timed_wait)
 		{
@@ -93,36 +187,41 @@ std::pair<bool, task> task_system::task_queue::pop(duration_t pop_timeout)
 		}
 	}
 
-	if(_tasks.empty())
-		return std::make_pair(false, task{});
-
-	if(_tasks.front().ready())
-	{
-		auto t = std::move(_tasks.front());
-		_tasks.pop_front();
-		return std::make_pair(true, std::move(t));
-	}
-	else
+	// Higher lanes first - a burst of background work cannot delay a
+	// queued critical task by more than the one in flight.
+	for(auto& lane : _lanes)
 	{
-		sort();
-	}
+		if(lane.empty())
+			continue;
 
-	// try after sort
-	if(_tasks.front().ready())
-	{
-		auto t = std::move(_tasks.front());
-		_tasks.pop_front();
-		return std::make_pair(true, std::move(t));
+		if(lane.front().ready())
+		{
+			auto t = std::move(lane.front());
+			lane.pop_front();
+			return std::make_pair(true, std::move(t));
+		}
+		else
+		{
+			sort(lane);
+		}
+
+		// try after sort
+		if(lane.front().ready())
+		{
+			auto t = std::move(lane.front());
+			lane.pop_front();
+			return std::make_pair(true, std::move(t));
+		}
 	}
 
 	return std::make_pair(false, task{});
 }
 
-void task_system::task_queue::push(task t)
+void task_system::task_queue::push(task t, task_priority priority)
 {
 	{
 		std::unique_lock<std::mutex> lock(_mutex);
-		_tasks.emplace_back(std::move(t));
+		_lanes[static_cast<std::size_t>(priority)].emplace_back(std::move(t));
 	}
 	_cv.notify_one();
 }
@@ -146,19 +245,19 @@ void task_system::run(std::size_t idx, std::function<bool()> condition, duration
 
 		if(idx != 0 && is_empty)
 		{
-			std::size_t steal_attempts = _threads_count;
-			const auto queue_idx = get_most_free_queue_idx(true);
-			for(std::size_t k = 0; k < steal_attempts; ++k)
+			// Start with the busiest queue, then sweep the remaining
+			// workers - the snapshot the busiest-pick is based on goes
+			// stale fast under bursts, so one candidate is not enough.
+			const auto busiest_idx = get_most_busy_queue_idx(true);
+			for(std::size_t k = 0; k < _threads_count && !p.first; ++k)
 			{
-				if(queue_index != queue_idx)
-				{
-					p = _queues[queue_idx].try_pop();
-					if(p.first)
-					{
-						_steals++;
-						break;
-					}
-				}
+				const auto victim_idx = (busiest_idx + k) % _threads_count;
+				if(victim_idx == get_owner_thread_idx() || victim_idx == queue_index)
+					continue;
+
+				p = _queues[victim_idx].try_steal();
+				if(p.first)
+					_steals++;
 			}
 		}
 
@@ -166,7 +265,21 @@ void task_system::run(std::size_t idx, std::function<bool()> condition, duration
 			p = _queues[queue_index].pop(pop_timeout);
 
 		if(p.first)
-			p.second();
+		{
+			const auto start = std::chrono::steady_clock::now();
+			{
+				// Scratch allocations made inside the task are dropped
+				// with it; the scope nests for tasks run while waiting.
+				scratch_scope scratch;
+				p.second();
+			}
+			const auto end = std::chrono::steady_clock::now();
+
+			task_sample sample;
+			sample.wait_time = start - p.second._enqueued;
+			sample.exec_time = end - start;
+			_queues[queue_index].record_sample(sample);
+		}
 	}
 }
 
@@ -199,9 +312,23 @@ task_system::task_system()
 }
 
 task_system::task_system(std::size_t nthreads, const task_system::allocator_t& alloc)
+	: task_system(
+		  [nthreads]() {
+			  worker_config config;
+			  config.thread_count = nthreads;
+			  return config;
+		  }(),
+		  alloc)
+{
+}
+
+task_system::task_system(const worker_config& config, const task_system::allocator_t& alloc)
 	: _alloc(alloc)
-	, _threads_count{nthreads}
+	, _threads_count{config.thread_count != 0 ? config.thread_count
+											  : std::size_t(std::thread::hardware_concurrency())}
 {
+	_threads_count = std::max<std::size_t>(1, _threads_count);
+
 	_queues.reserve(_threads_count);
 	_queues.emplace_back();
 	for(std::size_t th = 1; th < _threads_count; ++th)
@@ -216,7 +343,22 @@ task_system::task_system(std::size_t nthreads, const task_system::allocator_t& a
 	for(std::size_t th = 1; th < _threads_count; ++th)
 	{
 		_threads.emplace_back(&task_system::run, this, th, []() { return true; }, 50ms);
-		platform::set_thread_name(_threads.back(), "task_worker");
+		auto& worker = _threads.back();
+
+		const auto name = config.name_prefix + ":" + std::to_string(th);
+		platform::set_thread_name(worker, name.c_str());
+
+		// Scheduling tweaks are best effort - a refused call leaves the
+		// worker on OS defaults, which is what we shipped with anyway.
+		if(!config.worker_affinity.empty())
+		{
+			const auto core = config.worker_affinity[(th - 1) % config.worker_affinity.size()];
+			platform::set_thread_affinity(worker, core);
+		}
+		if(config.worker_priority != 0)
+		{
+			platform::set_thread_priority(worker, config.worker_priority);
+		}
 	}
 }
 
@@ -238,18 +380,36 @@ void task_system::run_on_owner_thread(duration_t max_duration)
 
 	using namespace std::literals;
 	auto now = std::chrono::steady_clock::now();
-	auto end = now + max_duration;
-
-	while(now < end)
+	const auto end = now + max_duration;
+
+	// Do not start a task the running cost estimate says will overshoot
+	// the budget - it stays queued and the next frame picks it up, so a
+	// burst of completions cannot eat an unbounded slice of this frame.
+	// The first ready task runs regardless of the estimate: the estimate
+	// only updates when a task executes, so one outlier above the budget
+	// would otherwise pin it there and wedge the pump with work still
+	// queued.
+	bool executed = false;
+	while(!executed || now + _owner_task_cost_ewma < end)
 	{
 		auto p = _queues[queue_index].pop(0ms);
 		if(!p.first)
 			return;
+		executed = true;
 
-		if(p.first)
+		const auto start = std::chrono::steady_clock::now();
+		{
+			scratch_scope scratch;
 			p.second();
-
+		}
 		now = std::chrono::steady_clock::now();
+
+		task_sample sample;
+		sample.wait_time = start - p.second._enqueued;
+		sample.exec_time = now - start;
+		_queues[queue_index].record_sample(sample);
+
+		_owner_task_cost_ewma = (_owner_task_cost_ewma * 7 + sample.exec_time) / 8;
 	}
 }
 
@@ -259,11 +419,18 @@ task_system::system_info task_system::get_info() const
 	info.queue_infos.reserve(_queues.size());
 	for(const auto& queue : _queues)
 	{
-		queue_info q_info;
-		q_info.pending_tasks = queue.get_pending_tasks();
+		auto q_info = queue.get_stats();
 		info.pending_tasks += q_info.pending_tasks;
 		info.queue_infos.emplace_back(std::move(q_info));
 	}
 	return info;
 }
+
+std::vector<task_system::task_sample> task_system::drain_samples(std::size_t queue_index)
+{
+	if(queue_index >= _queues.size())
+		return {};
+
+	return _queues[queue_index].drain_samples();
+}
 }
@@ -2,9 +2,11 @@
 #define TASK_SYSTEM_H
 
 #include "../common/nonstd/function_traits.hpp"
+#include "../common/nonstd/ring_view.hpp"
 #include "../common/nonstd/type_traits.hpp"
 #include <algorithm>
 #include <atomic>
+#include <cassert>
 #include <chrono>
 #include <condition_variable>
 #include <cstddef>
@@ -14,6 +16,7 @@
 #include <future>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -59,6 +62,41 @@ public:
 		return future.wait_for(rel_time);
 	}
 
+	//-----------------------------------------------------------------------------
+	//  Name : is_task_backed ()
+	/// <summary>
+	/// True when the future came from a task_system, so wait() can process
+	/// queued tasks while waiting. False for futures adopted from plain
+	/// promises, whose wait() is a blind block.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool is_task_backed() const
+	{
+		return _system != nullptr;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : then ()
+	/// <summary>
+	/// Schedules f on a worker thread once this future is ready, passing it
+	/// the result. No thread blocks while waiting - the continuation sits in
+	/// the queue as an awaitable task until its predecessor completes. Only
+	/// valid on futures obtained from a task_system.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <class F>
+	auto then(F&& f) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : then_on_owner_thread ()
+	/// <summary>
+	/// Same as then but the continuation runs on the owner thread - the
+	/// usual shape for GPU uploads and other main-thread-only completions.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <class F>
+	auto then_on_owner_thread(F&& f) const;
+
 	template <class Clock, class Dur>
 	std::future_status wait_until(const std::chrono::time_point<Clock, Dur>& abs_time) const
 	{ // wait until time point
@@ -174,6 +212,31 @@ struct decay_future<const task_future<T>&>
 	using type = T;
 };
 
+/// Placeholder handed to continuations of void futures - a parameter of
+/// type void cannot be formed, so the awaitable machinery substitutes
+/// this empty tag instead. Take it by generic/ignored argument.
+struct void_result
+{
+};
+
+template <>
+struct decay_future<task_future<void>>
+{
+	using type = void_result;
+};
+
+template <>
+struct decay_future<task_future<void>&>
+{
+	using type = void_result;
+};
+
+template <>
+struct decay_future<const task_future<void>&>
+{
+	using type = void_result;
+};
+
 /*
  * awaitable_task; a type-erased, allocator-aware std::packaged_task that
  * also contains its own arguments. The underlying packaged_task and the
@@ -362,12 +425,23 @@ private:
 		{
 		}
 
+#if __cplusplus >= 201703L
+		// std::packaged_task lost its allocator constructors in C++17;
+		// newer-standard translation units fall back to the default one.
+		template <class Allocator, class F>
+		explicit ready_task_model(std::allocator_arg_t, Allocator const&, F&& f, Args&&... args)
+			: _f(std::forward<F>(f))
+			, _args(std::forward<Args>(args)...)
+		{
+		}
+#else
 		template <class Allocator, class F>
 		explicit ready_task_model(std::allocator_arg_t, Allocator const& alloc, F&& f, Args&&... args)
 			: _f(std::allocator_arg_t(), alloc, std::forward<F>(f))
 			, _args(std::forward<Args>(args)...)
 		{
 		}
+#endif
 
 		task_future<R> get_future()
 		{
@@ -411,12 +485,23 @@ private:
 		{
 		}
 
+#if __cplusplus >= 201703L
+		// std::packaged_task lost its allocator constructors in C++17;
+		// newer-standard translation units fall back to the default one.
+		template <class Allocator, class F, class... Args>
+		explicit awaitable_task_model(std::allocator_arg_t, Allocator const&, F&& f, Args&&... args)
+			: _f(std::forward<F>(f))
+			, _args(std::forward<Args>(args)...)
+		{
+		}
+#else
 		template <class Allocator, class F, class... Args>
 		explicit awaitable_task_model(std::allocator_arg_t, Allocator const& alloc, F&& f, Args&&... args)
 			: _f(std::allocator_arg_t(), alloc, std::forward<F>(f))
 			, _args(std::forward<Args>(args)...)
 		{
 		}
+#endif
 
 		task_future<R> get_future()
 		{
@@ -448,6 +533,12 @@ private:
 			return t.get();
 		}
 
+		static inline void_result call_get(task_future<void>&& t) noexcept
+		{
+			t.get();
+			return {};
+		}
+
 		template <class T>
 		static inline decltype(auto) call_get(std::future<T>&& t) noexcept
 		{
@@ -502,9 +593,23 @@ private:
 		std::tuple<nonstd::special_decay_t<FutArgs>...> _args;
 	};
 
+	/// Stamped by the system when the task is queued; telemetry derives
+	/// the queue wait from it when the task finally runs.
+	std::chrono::steady_clock::time_point _enqueued;
+
 	std::unique_ptr<task_concept> _t;
 };
 
+/// Scheduling lane of a task. Workers drain lower numbered lanes first,
+/// so frame-critical work is never stuck behind a burst of background
+/// decodes. Placement (owner vs worker thread) is orthogonal.
+enum class task_priority : std::size_t
+{
+	critical = 0,
+	normal = 1,
+	background = 2,
+};
+
 class task_system
 {
 	using duration_t = std::chrono::steady_clock::duration;
@@ -515,6 +620,11 @@ public:
 	struct queue_info
 	{
 		std::size_t pending_tasks = 0;
+		/// Tasks executed from this queue since startup.
+		std::uint64_t executed_tasks = 0;
+		/// Total time this queue's thread spent running tasks. Diff two
+		/// per-frame snapshots against wall time for utilization.
+		duration_t busy_time = duration_t(0);
 	};
 	struct system_info
 	{
@@ -522,12 +632,54 @@ public:
 		std::vector<queue_info> queue_infos;
 	};
 
+	//-----------------------------------------------------------------------------
+	//  Name : task_sample (Struct)
+	/// <summary>
+	/// Timing of one executed task, buffered per queue in a fixed ring -
+	/// the oldest samples are overwritten when a frame is not drained.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	struct task_sample
+	{
+		/// Time the task spent queued before a thread picked it up.
+		duration_t wait_time = duration_t(0);
+		/// Time the task ran.
+		duration_t exec_time = duration_t(0);
+	};
+
 	using allocator_t = std::allocator<task>;
 
+	//-----------------------------------------------------------------------------
+	//  Name : worker_config (Struct)
+	/// <summary>
+	/// Construction-time scheduling policy for the worker pool. The
+	/// defaults reproduce the old behavior: one worker per hardware
+	/// thread, no pinning, default OS priority.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	struct worker_config
+	{
+		/// schedulable threads, the owner included; 0 picks
+		/// hardware_concurrency
+		std::size_t thread_count = 0;
+		/// logical cores workers pin to, assigned round-robin; empty
+		/// leaves the OS free to migrate them. Lets big.LITTLE and NUMA
+		/// machines keep workers on the intended cores.
+		std::vector<std::size_t> worker_affinity;
+		/// relative scheduling priority for workers: negative demotes to
+		/// background, 0 keeps the OS default, positive elevates
+		/// (privileged on some platforms). Applied best effort.
+		int worker_priority = 0;
+		/// profiler-visible name; workers show as "<prefix>:<index>"
+		std::string name_prefix = "task_worker";
+	};
+
 	task_system();
 
 	task_system(std::size_t nthreads, allocator_t const& alloc = {});
 
+	task_system(const worker_config& config, allocator_t const& alloc = {});
+
 	//-----------------------------------------------------------------------------
 	//  Name : ~task_system ()
 	/// <summary>
@@ -544,7 +696,33 @@ public:
 	//-----------------------------------------------------------------------------
 	void run_on_owner_thread(duration_t max_duration = duration_t(0));
 
+	//-----------------------------------------------------------------------------
+	//  Name : execute_tasks_on_owner_thread ()
+	/// <summary>
+	/// Budgeted drain of the owner queue. Runs queued tasks until starting
+	/// another one would exceed the budget by the running cost estimate;
+	/// overflow stays queued and the next frame picks it up, so the
+	/// per-frame main-thread cost is bounded even when a burst of asset
+	/// completions lands at once.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void execute_tasks_on_owner_thread(std::uint32_t max_microseconds)
+	{
+		run_on_owner_thread(
+			std::chrono::duration_cast<duration_t>(std::chrono::microseconds(max_microseconds)));
+	}
+
 	system_info get_info() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : drain_samples ()
+	/// <summary>
+	/// Returns and clears the buffered task samples of the specified
+	/// queue. Telemetry calls this once per frame per queue and charts the
+	/// wait times against queue depths from get_info.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::vector<task_sample> drain_samples(std::size_t queue_index);
 	//-----------------------------------------------------------------------------
 	//  Name : get_owner_thread_idx ()
 	/// <summary>
@@ -558,6 +736,17 @@ public:
 		return 0;
 	}
 
+	//-----------------------------------------------------------------------------
+	//  Name : get_threads_count ()
+	/// <summary>
+	/// Number of threads the system schedules on, the owner included.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t get_threads_count() const
+	{
+		return _threads_count;
+	}
+
 	//-----------------------------------------------------------------------------
 	//  Name : get_any_worker_thread_idx ()
 	/// <summary>
@@ -622,9 +811,16 @@ public:
 	//-----------------------------------------------------------------------------
 	template <class F, class... Args>
 	auto push_on_thread(const std::size_t idx, F&& f, Args&&... args)
+	{
+		return push_on_thread(task_priority::normal, idx, std::forward<F>(f), std::forward<Args>(args)...);
+	}
+
+	template <class F, class... Args>
+	auto push_on_thread(task_priority priority, const std::size_t idx, F&& f, Args&&... args)
 	{
 		using is_ready_task = nonstd::all_true<!is_future<Args>::value...>;
-		return push_impl(is_ready_task(), idx, false, std::forward<F>(f), std::forward<Args>(args)...);
+		return push_impl(is_ready_task(), idx, false, priority, std::forward<F>(f),
+						 std::forward<Args>(args)...);
 	}
 
 	//-----------------------------------------------------------------------------
@@ -641,6 +837,13 @@ public:
 		return push_on_thread(idx, std::forward<F>(f), std::forward<Args>(args)...);
 	}
 
+	template <class F, class... Args>
+	auto push_on_worker_thread(task_priority priority, F&& f, Args&&... args)
+	{
+		const std::size_t idx = get_any_worker_thread_idx();
+		return push_on_thread(priority, idx, std::forward<F>(f), std::forward<Args>(args)...);
+	}
+
 	//-----------------------------------------------------------------------------
 	//  Name : push_on_owner_thread ()
 	/// <summary>
@@ -658,6 +861,13 @@ public:
 		return push_on_thread(idx, std::forward<F>(f), std::forward<Args>(args)...);
 	}
 
+	template <class F, class... Args>
+	auto push_on_owner_thread(task_priority priority, F&& f, Args&&... args)
+	{
+		const std::size_t idx = get_owner_thread_idx();
+		return push_on_thread(priority, idx, std::forward<F>(f), std::forward<Args>(args)...);
+	}
+
 	//-----------------------------------------------------------------------------
 	//  Name : push_or_execute_on_thread ()
 	/// <summary>
@@ -669,9 +879,17 @@ public:
 	//-----------------------------------------------------------------------------
 	template <class F, class... Args>
 	auto push_or_execute_on_thread(const std::size_t idx, F&& f, Args&&... args)
+	{
+		return push_or_execute_on_thread(task_priority::normal, idx, std::forward<F>(f),
+										 std::forward<Args>(args)...);
+	}
+
+	template <class F, class... Args>
+	auto push_or_execute_on_thread(task_priority priority, const std::size_t idx, F&& f, Args&&... args)
 	{
 		using is_ready_task = nonstd::all_true<!is_future<Args>::value...>;
-		return push_impl(is_ready_task(), idx, true, std::forward<F>(f), std::forward<Args>(args)...);
+		return push_impl(is_ready_task(), idx, true, priority, std::forward<F>(f),
+						 std::forward<Args>(args)...);
 	}
 
 	//-----------------------------------------------------------------------------
@@ -690,6 +908,13 @@ public:
 		return push_or_execute_on_thread(idx, std::forward<F>(f), std::forward<Args>(args)...);
 	}
 
+	template <class F, class... Args>
+	auto push_or_execute_on_worker_thread(task_priority priority, F&& f, Args&&... args)
+	{
+		const std::size_t idx = get_any_worker_thread_idx();
+		return push_or_execute_on_thread(priority, idx, std::forward<F>(f), std::forward<Args>(args)...);
+	}
+
 	//-----------------------------------------------------------------------------
 	//  Name : push_or_execute_on_owner_thread ()
 	/// <summary>
@@ -708,6 +933,13 @@ public:
 		return push_or_execute_on_thread(idx, std::forward<F>(f), std::forward<Args>(args)...);
 	}
 
+	template <class F, class... Args>
+	auto push_or_execute_on_owner_thread(task_priority priority, F&& f, Args&&... args)
+	{
+		const std::size_t idx = get_owner_thread_idx();
+		return push_or_execute_on_thread(priority, idx, std::forward<F>(f), std::forward<Args>(args)...);
+	}
+
 private:
 	//-----------------------------------------------------------------------------
 	//  Name : push_impl ()
@@ -721,11 +953,12 @@ private:
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	template <class F, class... Args>
-	auto push_impl(std::true_type, std::size_t idx, bool execute_if_ready, F&& f, Args&&... args)
+	auto push_impl(std::true_type, std::size_t idx, bool execute_if_ready, task_priority priority, F&& f,
+				   Args&&... args)
 	{
 		return push_task(
 			make_ready_task(std::allocator_arg_t{}, _alloc, std::forward<F>(f), std::forward<Args>(args)...),
-			idx, execute_if_ready);
+			idx, execute_if_ready, priority);
 	}
 
 	//-----------------------------------------------------------------------------
@@ -738,11 +971,12 @@ private:
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	template <class F, class... Args>
-	auto push_impl(std::false_type, std::size_t idx, bool execute_if_ready, F&& f, Args&&... args)
+	auto push_impl(std::false_type, std::size_t idx, bool execute_if_ready, task_priority priority, F&& f,
+				   Args&&... args)
 	{
 		return push_task(make_awaitable_task(std::allocator_arg_t{}, _alloc, std::forward<F>(f),
 											 std::forward<Args>(args)...),
-						 idx, execute_if_ready);
+						 idx, execute_if_ready, priority);
 	}
 
 	//-----------------------------------------------------------------------------
@@ -760,7 +994,7 @@ private:
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	template <class T>
-	auto push_task(T&& t, std::size_t idx, bool execute_if_ready) ->
+	auto push_task(T&& t, std::size_t idx, bool execute_if_ready, task_priority priority) ->
 		typename std::remove_reference<decltype(t.second)>::type
 	{
 		t.second._system = this;
@@ -775,7 +1009,8 @@ private:
 		}
 		else
 		{
-			_queues[queue_index].push(std::move(t.first));
+			t.first._enqueued = std::chrono::steady_clock::now();
+			_queues[queue_index].push(std::move(t.first), priority);
 			return std::move(t.second);
 		}
 	}
@@ -853,32 +1088,73 @@ private:
 		task_queue(task_queue&& other) noexcept;
 
 		std::size_t get_pending_tasks() const;
+		queue_info get_stats() const;
+		void record_sample(const task_sample& s);
+		std::vector<task_sample> drain_samples();
 		void set_done();
 		bool is_done() const;
 		std::pair<bool, task> try_pop();
-		bool try_push(task& t);
+		std::pair<bool, task> try_steal();
+		bool try_push(task& t, task_priority priority);
 		std::pair<bool, task> pop(duration_t pop_timeout = duration_t::max());
 
-		void push(task t);
+		void push(task t, task_priority priority);
 		void wake_up();
 
 	private:
-		void sort();
-		std::deque<task> _tasks;
+		static const std::size_t lane_count = 3;
+
+		void sort(std::deque<task>& lane);
+		std::size_t count_tasks() const;
+		/// One deque per priority; pops scan the lanes in order so
+		/// critical work drains before background bursts.
+		std::deque<task> _lanes[lane_count];
 		std::condition_variable _cv;
 		mutable std::mutex _mutex;
 		std::atomic_bool _done{false};
+
+		/// Telemetry. Samples live in a fixed ring so recording never
+		/// allocates; writes come only from the thread bound to this
+		/// queue, reads from whoever charts them, under _sample_mutex.
+		static const std::size_t sample_capacity = 256;
+		std::vector<task_sample> _sample_storage;
+		nonstd::ring_span<task_sample> _samples;
+		mutable std::mutex _sample_mutex;
+		std::uint64_t _executed_tasks = 0;
+		duration_t _busy_time = duration_t(0);
 	};
 
 	std::atomic<std::uint32_t> _steals = {0};
+	/// Exponential moving average of owner-thread task cost, used by the
+	/// budgeted drain to avoid starting a task that would blow the frame
+	/// budget. Touched only by the owner thread.
+	duration_t _owner_task_cost_ewma = duration_t(0);
 	std::vector<task_queue> _queues;
 	std::vector<std::thread> _threads;
-	typename allocator_t::template rebind<task::task_concept>::other _alloc;
+	// Rebound through allocator_traits so the header also compiles in
+	// C++20 translation units (member rebind is gone there).
+	typename std::allocator_traits<allocator_t>::template rebind_alloc<task::task_concept> _alloc;
 	std::size_t _threads_count;
 	//
 	const std::thread::id _owner_thread_id = std::this_thread::get_id();
 };
 
+template <typename T>
+template <class F>
+auto task_future<T>::then(F&& f) const
+{
+	assert(_system != nullptr && "continuations require a future obtained from a task_system");
+	return _system->push_on_worker_thread(std::forward<F>(f), *this);
+}
+
+template <typename T>
+template <class F>
+auto task_future<T>::then_on_owner_thread(F&& f) const
+{
+	assert(_system != nullptr && "continuations require a future obtained from a task_system");
+	return _system->push_on_owner_thread(std::forward<F>(f), *this);
+}
+
 template <typename T>
 void task_future<T>::wait() const
 {
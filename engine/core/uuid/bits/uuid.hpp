@@ -67,6 +67,42 @@ constexpr inline bool static_all_of(InIter first, InIter last, Pred pr)
 {
 	return (first != last && pr(*first)) ? static_all_of(++first, last, pr) : (first == last);
 }
+
+constexpr inline int hex_to_int(char c)
+{
+	return (c >= '0' && c <= '9')
+			   ? c - '0'
+			   : ((c >= 'a' && c <= 'f') ? c - 'a' + 10 : ((c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1));
+}
+
+// host order word load; compiles down to a single move
+inline std::uint64_t load64(std::uint8_t const* bytes)
+{
+	std::uint64_t word = 0;
+	::std::memcpy(&word, bytes, sizeof(word));
+	return word;
+}
+
+// big endian word load, so word comparison orders like a byte-wise
+// lexicographical compare
+inline std::uint64_t load_be64(std::uint8_t const* bytes)
+{
+	return (std::uint64_t(bytes[0]) << 56) | (std::uint64_t(bytes[1]) << 48) |
+		   (std::uint64_t(bytes[2]) << 40) | (std::uint64_t(bytes[3]) << 32) |
+		   (std::uint64_t(bytes[4]) << 24) | (std::uint64_t(bytes[5]) << 16) |
+		   (std::uint64_t(bytes[6]) << 8) | std::uint64_t(bytes[7]);
+}
+
+// 64 bit finalizer (murmur3 style), good avalanche for unordered_map
+inline std::uint64_t mix64(std::uint64_t x)
+{
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdull;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ull;
+	x ^= x >> 33;
+	return x;
+}
 }
 
 struct uuid
@@ -120,10 +156,43 @@ struct uuid
 	{
 	}
 
-	constexpr uuid(char const*, size_type)
-		: uuid()
+	constexpr uuid(char const* cstr, size_type len)
+		: _data{0}
 	{
-		// std::isxdigit(ch)..
+		// accepts the canonical 8-4-4-4-12 hex form; anything else is nil
+		if(cstr != nullptr && len == static_size * 2 + 4)
+		{
+			bool valid = true;
+			size_type k = 0;
+			for(size_type i = 0; i < len && valid; ++i)
+			{
+				const char c = cstr[i];
+				if(i == 8 || i == 13 || i == 18 || i == 23)
+				{
+					valid = (c == '-');
+					continue;
+				}
+
+				const int nibble = detail::hex_to_int(c);
+				if(nibble < 0)
+				{
+					valid = false;
+					continue;
+				}
+
+				if((k & 1) == 0)
+					_data[k >> 1] = static_cast<value_type>(nibble << 4);
+				else
+					_data[k >> 1] = static_cast<value_type>(_data[k >> 1] | nibble);
+				++k;
+			}
+
+			if(!valid)
+			{
+				for(size_type i = 0; i < static_size; ++i)
+					_data[i] = 0;
+			}
+		}
 	}
 
 	explicit uuid(std::string const& str)
@@ -191,20 +260,15 @@ struct uuid
 	{
 		static constexpr char const* const hex_digits = "0123456789abcdef";
 
-		::std::string result(this->size() * 2 + 4, 0);
-		result[8] = result[13] = result[18] = result[23] = '-';
+		::std::string result(this->size() * 2 + 4, '-');
 
-		for(size_type i = 0, k = 0; i < result.size() - 1;)
+		for(size_type i = 0, k = 0; k < this->size(); ++k)
 		{
-			if(result[i] == '-')
-			{
+			if(k == 4 || k == 6 || k == 8 || k == 10)
 				++i;
-				continue;
-			}
 
 			result[i++] = hex_digits[(_data[k] & 0xf0u) >> 4];
 			result[i++] = hex_digits[(_data[k] & 0x0fu)];
-			++k;
 		}
 
 		return result;
@@ -219,7 +283,7 @@ struct uuid
 
 	constexpr const_iterator end() const noexcept
 	{
-		return detail::static_addressof(_data[static_size - 1]);
+		return detail::static_addressof(_data[0]) + static_size;
 	}
 
 	constexpr const_iterator cbegin() const noexcept
@@ -229,7 +293,7 @@ struct uuid
 
 	constexpr const_iterator cend() const noexcept
 	{
-		return detail::static_addressof(_data[static_size - 1]);
+		return detail::static_addressof(_data[0]) + static_size;
 	}
 
 	const_reverse_iterator rbegin() const noexcept
@@ -265,12 +329,19 @@ struct uuid
 
 	friend bool operator==(uuid const& lhs, uuid const& rhs)
 	{
-		return ::std::equal(lhs.begin(), lhs.end(), rhs.begin());
+		// two word compares instead of a byte-wise scan
+		return detail::load64(lhs._data) == detail::load64(rhs._data) &&
+			   detail::load64(lhs._data + 8) == detail::load64(rhs._data + 8);
 	}
 
 	friend bool operator<(uuid const& lhs, uuid const& rhs)
 	{
-		return ::std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+		const auto lhs_high = detail::load_be64(lhs._data);
+		const auto rhs_high = detail::load_be64(rhs._data);
+		if(lhs_high != rhs_high)
+			return lhs_high < rhs_high;
+
+		return detail::load_be64(lhs._data + 8) < detail::load_be64(rhs._data + 8);
 	}
 
 	///////////////////////////////////////////////////////////////////////
@@ -338,8 +409,11 @@ struct hash<uuids::uuid>
 {
 	size_t operator()(const uuids::uuid& obj) const
 	{
-		hash<std::string> hasher;
-		return hasher(obj.to_string());
+		// mix the two words instead of hashing the formatted string
+		const auto* bytes = obj.begin();
+		const auto high = uuids::detail::load64(bytes);
+		const auto low = uuids::detail::load64(bytes + 8);
+		return static_cast<size_t>(uuids::detail::mix64(high ^ uuids::detail::mix64(low)));
 	}
 };
 }
@@ -0,0 +1,99 @@
+#include "animation_compression.h"
+#include "core/math/math_includes.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace runtime
+{
+namespace
+{
+float interpolation_factor(double start, double end, double at)
+{
+	const auto segment = end - start;
+	return segment > 0.0 ? static_cast<float>((at - start) / segment) : 0.0f;
+}
+
+float reconstruction_error(const math::vec3& start, const math::vec3& end, float factor,
+						   const math::vec3& original)
+{
+	return math::distance(math::mix(start, end, factor), original);
+}
+
+float reconstruction_error(const math::quat& start, const math::quat& end, float factor,
+						   const math::quat& original)
+{
+	const auto reconstructed = math::slerp(start, end, factor);
+	// angle between the two rotations - q and -q are the same rotation,
+	// so the dot is folded positive
+	const auto d = std::min(1.0f, std::abs(math::dot(reconstructed, original)));
+	return math::degrees(2.0f * std::acos(d));
+}
+
+//-----------------------------------------------------------------------------
+//  Name : decimate_track () (Local)
+/// <summary>
+/// Greedy span extension: from every kept key, the end of the span grows
+/// while every key inside it stays within tolerance of the interpolation
+/// between the span's endpoints. Only the endpoints survive, so tolerance
+/// bounds the error against the source keys themselves, not against an
+/// already thinned track.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T>
+void decimate_track(std::vector<node_animation::key<T>>& keys, float tolerance)
+{
+	if(keys.size() <= 2)
+	{
+		return;
+	}
+
+	std::vector<node_animation::key<T>> kept;
+	kept.reserve(keys.size());
+	kept.push_back(keys.front());
+
+	// Spans are capped so verification stays quadratic in the cap rather
+	// than the track length - a run of identical keys still thins 64:1.
+	const std::size_t max_span = 64;
+
+	std::size_t span_begin = 0;
+	while(span_begin + 1 < keys.size())
+	{
+		std::size_t span_end = span_begin + 1;
+		const std::size_t last_candidate = std::min(keys.size(), span_begin + max_span + 1);
+		for(std::size_t candidate = span_begin + 2; candidate < last_candidate; ++candidate)
+		{
+			bool within = true;
+			for(std::size_t k = span_begin + 1; k < candidate && within; ++k)
+			{
+				const auto factor =
+					interpolation_factor(keys[span_begin].time, keys[candidate].time, keys[k].time);
+				within = reconstruction_error(keys[span_begin].value, keys[candidate].value, factor,
+											  keys[k].value) <= tolerance;
+			}
+			if(!within)
+			{
+				break;
+			}
+			span_end = candidate;
+		}
+
+		kept.push_back(keys[span_end]);
+		span_begin = span_end;
+	}
+
+	keys = std::move(kept);
+}
+}
+
+void compress_animation(animation& clip, float position_tolerance, float rotation_tolerance_degrees,
+						float scaling_tolerance)
+{
+	for(auto& channel : clip.channels)
+	{
+		decimate_track(channel.position_keys, position_tolerance);
+		decimate_track(channel.rotation_keys, rotation_tolerance_degrees);
+		decimate_track(channel.scaling_keys, scaling_tolerance);
+	}
+}
+}
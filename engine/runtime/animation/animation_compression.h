@@ -0,0 +1,19 @@
+#pragma once
+#include "animation.h"
+
+namespace runtime
+{
+//-----------------------------------------------------------------------------
+//  Name : compress_animation ()
+/// <summary>
+/// Drops keys the sampler can reconstruct by interpolating their kept
+/// neighbours within the given tolerances - positions and scalings by
+/// distance, rotations by angle in degrees. Raw imported clips key every
+/// frame on every bone; mocap in particular collapses to a fraction of its
+/// size. Lossy but bounded: playback never deviates more than the
+/// tolerances from the source keys.
+/// </summary>
+//-----------------------------------------------------------------------------
+void compress_animation(animation& clip, float position_tolerance = 0.001f,
+						float rotation_tolerance_degrees = 0.1f, float scaling_tolerance = 0.001f);
+}
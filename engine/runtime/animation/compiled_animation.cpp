@@ -0,0 +1,217 @@
+#include "compiled_animation.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace runtime
+{
+namespace
+{
+/// scale mapping the [-1/sqrt(2), 1/sqrt(2)] component range onto 15 bits
+const float quantize_scale = 23169.06079f; // 16383.5 * sqrt(2)
+}
+
+quantized_quat quantized_quat::encode(const math::quat& q)
+{
+	const float components[4] = {q.x, q.y, q.z, q.w};
+	std::uint32_t largest = 0;
+	for(std::uint32_t i = 1; i < 4; ++i)
+	{
+		if(std::abs(components[i]) > std::abs(components[largest]))
+		{
+			largest = i;
+		}
+	}
+
+	// q and -q are the same rotation - flip so the dropped component is
+	// positive and can be rebuilt without a sign
+	const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+	std::uint16_t packed[3];
+	std::uint32_t out = 0;
+	for(std::uint32_t i = 0; i < 4; ++i)
+	{
+		if(i == largest)
+		{
+			continue;
+		}
+		const auto value = components[i] * sign * quantize_scale + 16383.5f;
+		packed[out++] = static_cast<std::uint16_t>(
+			std::min(32767.0f, std::max(0.0f, value)));
+	}
+
+	quantized_quat result;
+	result.x = static_cast<std::uint16_t>(packed[0] | ((largest & 0x2u) << 14));
+	result.y = static_cast<std::uint16_t>(packed[1] | ((largest & 0x1u) << 15));
+	result.z = packed[2];
+	return result;
+}
+
+math::quat quantized_quat::decode() const
+{
+	const std::uint32_t largest = ((x >> 14) & 0x2u) | (y >> 15);
+	const float stored[3] = {(static_cast<float>(x & 0x7fffu) - 16383.5f) / quantize_scale,
+							 (static_cast<float>(y & 0x7fffu) - 16383.5f) / quantize_scale,
+							 (static_cast<float>(z & 0x7fffu) - 16383.5f) / quantize_scale};
+
+	float components[4];
+	std::uint32_t in = 0;
+	float length_sq = 0.0f;
+	for(std::uint32_t i = 0; i < 4; ++i)
+	{
+		if(i != largest)
+		{
+			components[i] = stored[in++];
+			length_sq += components[i] * components[i];
+		}
+	}
+	components[largest] = std::sqrt(std::max(0.0f, 1.0f - length_sq));
+
+	return math::quat(components[3], components[0], components[1], components[2]);
+}
+
+namespace
+{
+template <typename T>
+void split_keys(const std::vector<node_animation::key<T>>& keys, std::vector<float>& out_times,
+				std::vector<T>& out_values)
+{
+	out_times.reserve(keys.size());
+	out_values.reserve(keys.size());
+	for(const auto& k : keys)
+	{
+		out_times.push_back(static_cast<float>(k.time));
+		out_values.push_back(k.value);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//  Name : sample_track ()
+/// <summary>
+/// Samples one track at the given time, advancing the cached key index
+/// instead of searching. The cursor always names the key at or before the
+/// sample time, so a resumed scan only visits keys the playhead crossed.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T, typename InterpolateT>
+auto sample_track(const std::vector<float>& times, const std::vector<T>& values, float time,
+				  std::uint32_t& cursor, InterpolateT interpolate)
+	-> decltype(interpolate(values[0], values[0], 0.0f))
+{
+	if(cursor >= times.size())
+	{
+		cursor = 0;
+	}
+	while(cursor + 1 < times.size() && times[cursor + 1] <= time)
+	{
+		++cursor;
+	}
+
+	if(cursor + 1 >= times.size() || time <= times[cursor])
+	{
+		return interpolate(values[cursor], values[cursor], 0.0f);
+	}
+
+	const auto segment = times[cursor + 1] - times[cursor];
+	const auto factor = segment > 0.0f ? (time - times[cursor]) / segment : 0.0f;
+	return interpolate(values[cursor], values[cursor + 1], factor);
+}
+}
+
+compiled_animation compile_animation(const animation& clip,
+									 const std::unordered_map<std::string, std::uint32_t>& bone_indices)
+{
+	compiled_animation compiled;
+	compiled.duration = static_cast<float>(clip.duration);
+	compiled.ticks_per_second = static_cast<float>(clip.ticks_per_second);
+	compiled.channels.reserve(clip.channels.size());
+
+	for(const auto& node_channel : clip.channels)
+	{
+		const auto it = bone_indices.find(node_channel.node_name);
+		if(it == std::end(bone_indices))
+		{
+			continue;
+		}
+
+		compiled_animation::channel channel;
+		channel.bone_index = it->second;
+		split_keys(node_channel.position_keys, channel.position_times, channel.position_values);
+		split_keys(node_channel.scaling_keys, channel.scaling_times, channel.scaling_values);
+
+		channel.rotation_times.reserve(node_channel.rotation_keys.size());
+		channel.rotation_values.reserve(node_channel.rotation_keys.size());
+		for(const auto& k : node_channel.rotation_keys)
+		{
+			channel.rotation_times.push_back(static_cast<float>(k.time));
+			channel.rotation_values.push_back(quantized_quat::encode(k.value));
+		}
+		compiled.channels.push_back(std::move(channel));
+	}
+
+	return compiled;
+}
+
+void animation_cursor::reset()
+{
+	_last_time = 0.0f;
+	_cursors.clear();
+}
+
+void animation_cursor::sample(const compiled_animation& clip, float time,
+							  std::vector<math::transform>& out_pose)
+{
+	sample(clip, time, out_pose.data(), out_pose.size());
+}
+
+void animation_cursor::sample(const compiled_animation& clip, float time, math::transform* out_pose,
+							  std::size_t bone_count)
+{
+	if(_cursors.size() != clip.channels.size())
+	{
+		_cursors.assign(clip.channels.size(), channel_cursor());
+	}
+	else if(time < _last_time)
+	{
+		// loop wrap or seek backwards - the scans restart from the front
+		std::fill(std::begin(_cursors), std::end(_cursors), channel_cursor());
+	}
+	_last_time = time;
+
+	for(std::size_t i = 0; i < clip.channels.size(); ++i)
+	{
+		const auto& channel = clip.channels[i];
+		auto& cursor = _cursors[i];
+		if(channel.bone_index >= bone_count)
+		{
+			continue;
+		}
+
+		auto& bone = out_pose[channel.bone_index];
+		if(!channel.position_values.empty())
+		{
+			bone.set_position(sample_track(channel.position_times, channel.position_values, time,
+										   cursor.position,
+										   [](const math::vec3& a, const math::vec3& b, float t) {
+											   return math::mix(a, b, t);
+										   }));
+		}
+		if(!channel.rotation_values.empty())
+		{
+			bone.set_rotation(sample_track(channel.rotation_times, channel.rotation_values, time,
+										   cursor.rotation,
+										   [](const quantized_quat& a, const quantized_quat& b, float t) {
+											   return math::slerp(a.decode(), b.decode(), t);
+										   }));
+		}
+		if(!channel.scaling_values.empty())
+		{
+			bone.set_scale(sample_track(channel.scaling_times, channel.scaling_values, time,
+										cursor.scaling,
+										[](const math::vec3& a, const math::vec3& b, float t) {
+											return math::mix(a, b, t);
+										}));
+		}
+	}
+}
+}
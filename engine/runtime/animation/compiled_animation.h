@@ -0,0 +1,136 @@
+#pragma once
+#include "animation.h"
+#include "core/math/math_includes.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace runtime
+{
+//-----------------------------------------------------------------------------
+//  Name : quantized_quat (Struct)
+/// <summary>
+/// Smallest-three quaternion in 48 bits: the largest component is dropped
+/// and rebuilt from the unit length on decode, the remaining three are
+/// stored with 15 bits each and the dropped component's index takes the two
+/// spare top bits. Rotation tracks dominate clip memory, so this quarters
+/// them against full float quats.
+/// </summary>
+//-----------------------------------------------------------------------------
+struct quantized_quat
+{
+	static quantized_quat encode(const math::quat& q);
+	math::quat decode() const;
+
+	/// three smallest components at 15 bits; the top bit of x and of y
+	/// together index the dropped component
+	std::uint16_t x = 0;
+	std::uint16_t y = 0;
+	std::uint16_t z = 0;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : compiled_animation (Struct)
+/// <summary>
+/// Playback form of an animation clip. Each channel stores separate time and
+/// value arrays instead of interleaved keys, so the time scans that dominate
+/// sampling walk a dense float array, and node names are resolved to bone
+/// indices once at compile time instead of by string per frame.
+/// </summary>
+//-----------------------------------------------------------------------------
+struct compiled_animation
+{
+	/// bone index of a channel whose node is not part of the palette
+	static const std::uint32_t invalid_bone = 0xffffffff;
+
+	struct channel
+	{
+		/// index of the affected bone in the palette the clip was
+		/// compiled against
+		std::uint32_t bone_index = invalid_bone;
+
+		/// key times and values split per track - scans only touch the
+		/// time arrays
+		std::vector<float> position_times;
+		std::vector<math::vec3> position_values;
+		std::vector<float> rotation_times;
+		std::vector<quantized_quat> rotation_values;
+		std::vector<float> scaling_times;
+		std::vector<math::vec3> scaling_values;
+	};
+
+	/// Duration of the animation in ticks.
+	float duration = 0.0f;
+
+	/// Ticks per second. 0 if not specified in the imported file
+	float ticks_per_second = 0.0f;
+
+	/// The compiled channels. Each channel affects a single bone.
+	std::vector<channel> channels;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : compile_animation ()
+/// <summary>
+/// Builds the playback form of a clip against a bone palette (node name to
+/// bone index). Channels whose node is not in the palette are dropped.
+/// </summary>
+//-----------------------------------------------------------------------------
+compiled_animation compile_animation(const animation& clip,
+									 const std::unordered_map<std::string, std::uint32_t>& bone_indices);
+
+//-----------------------------------------------------------------------------
+//  Name : animation_cursor (Struct)
+/// <summary>
+/// Per-player sampling state. Remembers the key reached on the previous
+/// sample for every track, so advancing playback resumes the scan from there
+/// instead of searching the key array from scratch; sampling backwards (a
+/// loop wrap or a seek) rewinds the cursors.
+/// </summary>
+//-----------------------------------------------------------------------------
+struct animation_cursor
+{
+	//-----------------------------------------------------------------------------
+	//  Name : reset ()
+	/// <summary>
+	/// Forgets the cached key positions - call when switching clips.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void reset();
+
+	//-----------------------------------------------------------------------------
+	//  Name : sample ()
+	/// <summary>
+	/// Samples the clip at the given time in ticks into a pose indexed by
+	/// bone. Bones without a channel keep whatever the pose already holds;
+	/// channels whose bone index is outside the pose are skipped.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void sample(const compiled_animation& clip, float time, std::vector<math::transform>& out_pose);
+
+	//-----------------------------------------------------------------------------
+	//  Name : sample ()
+	/// <summary>
+	/// Same, into a raw pose buffer - the form blend trees use with poses
+	/// living on the scratch arena.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void sample(const compiled_animation& clip, float time, math::transform* out_pose,
+				std::size_t bone_count);
+
+private:
+	struct channel_cursor
+	{
+		std::uint32_t position = 0;
+		std::uint32_t rotation = 0;
+		std::uint32_t scaling = 0;
+	};
+
+	/// time of the previous sample - going backwards rewinds the cursors
+	float _last_time = 0.0f;
+
+	/// cached key index per track of every channel
+	std::vector<channel_cursor> _cursors;
+};
+}
@@ -0,0 +1,50 @@
+#include "pose.h"
+
+#include <algorithm>
+
+namespace runtime
+{
+math::transform blend_transforms(const math::transform& a, const math::transform& b, float weight)
+{
+	math::transform result;
+	result.set_position(math::mix(a.get_position(), b.get_position(), weight));
+	result.set_rotation(math::slerp(a.get_rotation(), b.get_rotation(), weight));
+	result.set_scale(math::mix(a.get_scale(), b.get_scale(), weight));
+	return result;
+}
+
+void blend_pose(const math::transform* a, const math::transform* b, float weight, math::transform* out,
+				std::size_t bone_count)
+{
+	for(std::size_t i = 0; i < bone_count; ++i)
+	{
+		out[i] = blend_transforms(a[i], b[i], weight);
+	}
+}
+
+void blend_poses(const math::transform* const* poses, const float* weights, std::size_t pose_count,
+				 math::transform* out, std::size_t bone_count)
+{
+	if(pose_count == 0)
+	{
+		return;
+	}
+
+	std::copy(poses[0], poses[0] + bone_count, out);
+	auto accumulated = weights[0];
+
+	for(std::size_t p = 1; p < pose_count; ++p)
+	{
+		const auto total = accumulated + weights[p];
+		if(total <= 0.0f)
+		{
+			continue;
+		}
+		// progressive normalization - blending input p at its share of
+		// the running total is equivalent to a normalized weighted sum,
+		// without materializing intermediate poses
+		blend_pose(out, poses[p], weights[p] / total, out, bone_count);
+		accumulated = total;
+	}
+}
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "core/math/math_includes.h"
+#include "core/tasks/scratch_arena.h"
+
+#include <cstddef>
+
+namespace runtime
+{
+/// One local transform per bone - the unit every blend operates on.
+/// Backed by the calling thread's scratch arena, so intermediate poses of
+/// an N-way blend cost a pointer bump and vanish with the enclosing
+/// core::scratch_scope instead of hitting the heap every frame.
+using scratch_pose = core::scratch_vector<math::transform>;
+
+//-----------------------------------------------------------------------------
+//  Name : make_scratch_pose ()
+/// <summary>
+/// A bone_count sized pose on the calling thread's scratch arena. Must not
+/// outlive the scratch_scope (or task) it was made in.
+/// </summary>
+//-----------------------------------------------------------------------------
+inline scratch_pose make_scratch_pose(std::size_t bone_count)
+{
+	return scratch_pose(bone_count);
+}
+
+//-----------------------------------------------------------------------------
+//  Name : blend_transforms ()
+/// <summary>
+/// Component-wise blend of two transforms - positions and scales lerp,
+/// rotations slerp.
+/// </summary>
+//-----------------------------------------------------------------------------
+math::transform blend_transforms(const math::transform& a, const math::transform& b, float weight);
+
+//-----------------------------------------------------------------------------
+//  Name : blend_pose ()
+/// <summary>
+/// Blends two poses bone by bone into out. out may alias either input, so
+/// layered blends can accumulate in place without extra buffers.
+/// </summary>
+//-----------------------------------------------------------------------------
+void blend_pose(const math::transform* a, const math::transform* b, float weight, math::transform* out,
+				std::size_t bone_count);
+
+//-----------------------------------------------------------------------------
+//  Name : blend_poses ()
+/// <summary>
+/// N-way weighted blend. Accumulates the inputs progressively with
+/// normalized weights directly into out, so an N-way blend needs no
+/// intermediate pose at all - weights need not sum to one.
+/// </summary>
+//-----------------------------------------------------------------------------
+void blend_poses(const math::transform* const* poses, const float* weights, std::size_t pose_count,
+				 math::transform* out, std::size_t bone_count);
+}
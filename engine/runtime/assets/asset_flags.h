@@ -15,4 +15,14 @@ enum class load_flags
 	reload,
 	do_not_unload
 };
+
+// Scheduling class for the IO portion of a load. Background prefetches
+// should use 'low' so they can never starve assets the player is looking
+// at; synchronous loads are promoted to 'high' automatically.
+enum class load_priority
+{
+	low,
+	normal,
+	high
+};
 }
@@ -1,18 +1,88 @@
 #pragma once
 
+#include "asset_id.h"
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 
 template <typename T>
 struct asset_link
 {
-	std::string id;
+	/// Interned key. Reads as a string for display and serialization;
+	/// the id itself backs the container lookups.
+	runtime::asset_key id;
 	std::shared_ptr<T> asset;
+	/// Intrusive count of the handles sharing this record. Embedded here
+	/// so handle copies touch one count next to the data they already
+	/// reference instead of a separate control block.
+	std::atomic<long> refs = {1};
+	/// Frame the unused-asset sweep last saw an outside reference to this
+	/// record. Maintained by the sweep itself, so the hot handle paths
+	/// never touch it.
+	std::atomic<std::uint64_t> last_used_frame = {0};
 };
 
+//-----------------------------------------------------------------------------
+//  Name : asset_handle (Struct)
+/// <summary>
+/// Handle to a loaded (or loading) asset record. One raw pointer wide,
+/// with the reference count living inside the record itself, so the
+/// prolific copies on the render path cost a single atomic op and no
+/// control-block hop. Copying and destroying distinct handles is thread
+/// safe; mutating one handle object from several threads is not, the
+/// same contract shared_ptr gives.
+/// </summary>
+//-----------------------------------------------------------------------------
 template <typename T>
 struct asset_handle
 {
+	asset_handle()
+		: link(new asset_link<T>())
+	{
+	}
+
+	asset_handle(const asset_handle& rhs)
+		: link(rhs.link)
+	{
+		retain(link);
+	}
+
+	asset_handle(asset_handle&& rhs) noexcept
+		: link(rhs.link)
+	{
+		rhs.link = nullptr;
+	}
+
+	asset_handle& operator=(const asset_handle& rhs)
+	{
+		if(link != rhs.link)
+		{
+			auto* old = link;
+			link = rhs.link;
+			retain(link);
+			release(old);
+		}
+		return *this;
+	}
+
+	asset_handle& operator=(asset_handle&& rhs) noexcept
+	{
+		if(this != &rhs)
+		{
+			auto* old = link;
+			link = rhs.link;
+			rhs.link = nullptr;
+			release(old);
+		}
+		return *this;
+	}
+
+	~asset_handle()
+	{
+		release(link);
+	}
+
 	//-----------------------------------------------------------------------------
 	//  Name : get ()
 	/// <summary>
@@ -23,12 +93,12 @@ struct asset_handle
 	//-----------------------------------------------------------------------------
 	inline T* get() const
 	{
-		return link->asset.get();
+		return link != nullptr ? link->asset.get() : nullptr;
 	}
 
 	inline std::shared_ptr<T> get_asset() const
 	{
-		return link->asset;
+		return link != nullptr ? link->asset : std::shared_ptr<T>();
 	}
 
 	//-----------------------------------------------------------------------------
@@ -41,6 +111,7 @@ struct asset_handle
 	//-----------------------------------------------------------------------------
 	inline void reset(std::shared_ptr<T> data = nullptr)
 	{
+		revive();
 		link->asset = data;
 		if(!data)
 		{
@@ -51,14 +122,12 @@ struct asset_handle
 	//-----------------------------------------------------------------------------
 	//  Name : use_count ()
 	/// <summary>
-	///
-	///
-	///
+	/// Number of handles sharing the record.
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	inline long use_count() const
 	{
-		return link.use_count();
+		return link != nullptr ? link->refs.load(std::memory_order_relaxed) : 0;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -71,7 +140,25 @@ struct asset_handle
 	//-----------------------------------------------------------------------------
 	const std::string& id() const
 	{
-		return link->id;
+		if(link != nullptr)
+		{
+			return link->id;
+		}
+
+		static const std::string empty;
+		return empty;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : key ()
+	/// <summary>
+	/// The interned id of the asset key - compare and hash this instead
+	/// of id() on hot paths.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	runtime::asset_id key() const
+	{
+		return link != nullptr ? link->id.id() : runtime::asset_id();
 	}
 
 	//-----------------------------------------------------------------------------
@@ -84,6 +171,8 @@ struct asset_handle
 	//-----------------------------------------------------------------------------
 	asset_handle& operator=(std::shared_ptr<T> data)
 	{
+		revive();
+
 		// Own the specified handle's data pointer
 		if(data != link->asset)
 			link->asset = data;
@@ -169,6 +258,38 @@ struct asset_handle
 		return get();
 	}
 
-	// Internal link to asset
-	std::shared_ptr<asset_link<T>> link = std::make_shared<asset_link<T>>();
+	// Internal link to asset. Null only on a moved-from handle; reads are
+	// null-safe and writes revive the link first.
+	asset_link<T>* link = nullptr;
+
+private:
+	//-----------------------------------------------------------------------------
+	//  Name : revive () (Private)
+	/// <summary>
+	/// Gives a moved-from handle a fresh record before a write touches it.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline void revive()
+	{
+		if(link == nullptr)
+		{
+			link = new asset_link<T>();
+		}
+	}
+
+	static inline void retain(asset_link<T>* ptr)
+	{
+		if(ptr != nullptr)
+		{
+			ptr->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	static inline void release(asset_link<T>* ptr)
+	{
+		if(ptr != nullptr && ptr->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			delete ptr;
+		}
+	}
 };
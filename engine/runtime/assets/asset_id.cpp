@@ -0,0 +1,91 @@
+#include "asset_id.h"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace runtime
+{
+namespace
+{
+struct intern_table
+{
+	intern_table()
+	{
+		// Slot 0 backs the reserved empty id.
+		keys.emplace_back();
+	}
+
+	/// Guards both containers.
+	std::mutex mutex;
+	/// Key to id.
+	std::unordered_map<std::string, std::uint32_t> ids;
+	/// Id to key. A deque so references handed out stay stable while the
+	/// table grows.
+	std::deque<std::string> keys;
+};
+
+intern_table& get_table()
+{
+	static intern_table table;
+	return table;
+}
+
+const std::string& get_empty_key()
+{
+	static const std::string empty;
+	return empty;
+}
+}
+
+asset_id intern_asset_key(const std::string& key)
+{
+	if(key.empty())
+		return {};
+
+	auto& table = get_table();
+	std::lock_guard<std::mutex> lock(table.mutex);
+	auto it = table.ids.find(key);
+	if(it != table.ids.end())
+		return {it->second};
+
+	table.keys.push_back(key);
+	const auto value = static_cast<std::uint32_t>(table.keys.size() - 1);
+	table.ids.emplace(key, value);
+	return {value};
+}
+
+const std::string& get_asset_key(asset_id id)
+{
+	auto& table = get_table();
+	std::lock_guard<std::mutex> lock(table.mutex);
+	if(id.value >= table.keys.size())
+		return table.keys.front();
+
+	return table.keys[id.value];
+}
+
+asset_key::asset_key()
+	: _str(&get_empty_key())
+{
+}
+
+asset_key& asset_key::operator=(const std::string& key)
+{
+	if(key.empty())
+	{
+		clear();
+		return *this;
+	}
+
+	_id = intern_asset_key(key);
+	_str = &get_asset_key(_id);
+	return *this;
+}
+
+void asset_key::clear()
+{
+	_id = {};
+	_str = &get_empty_key();
+}
+}
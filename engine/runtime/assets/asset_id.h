@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace runtime
+{
+
+//-----------------------------------------------------------------------------
+//  Name : asset_id (Struct)
+/// <summary>
+/// Interned identifier for an asset key. Comparing and hashing cost one
+/// integer op instead of walking a path string; the key string itself
+/// lives once in the intern table and is kept for display and
+/// serialization only. Value 0 is reserved for the empty key.
+/// </summary>
+//-----------------------------------------------------------------------------
+struct asset_id
+{
+	std::uint32_t value = 0;
+
+	inline bool operator==(const asset_id& rhs) const
+	{
+		return value == rhs.value;
+	}
+
+	inline bool operator!=(const asset_id& rhs) const
+	{
+		return value != rhs.value;
+	}
+
+	inline bool operator<(const asset_id& rhs) const
+	{
+		return value < rhs.value;
+	}
+
+	explicit operator bool() const
+	{
+		return value != 0;
+	}
+};
+
+//-----------------------------------------------------------------------------
+//  Name : intern_asset_key ()
+/// <summary>
+/// Returns the stable id for the key, adding it to the global intern
+/// table on first sight. Thread safe.
+/// </summary>
+//-----------------------------------------------------------------------------
+asset_id intern_asset_key(const std::string& key);
+
+//-----------------------------------------------------------------------------
+//  Name : get_asset_key ()
+/// <summary>
+/// Returns the key string an id was interned from. The reference stays
+/// valid for the process lifetime - interned keys are never evicted.
+/// </summary>
+//-----------------------------------------------------------------------------
+const std::string& get_asset_key(asset_id id);
+
+//-----------------------------------------------------------------------------
+//  Name : asset_key (Class)
+/// <summary>
+/// Interned key stored inside asset links. Assignment interns the string
+/// once; reads hand back the id or a reference into the intern table
+/// without locking or allocating, so copies are two words and never
+/// touch the heap.
+/// </summary>
+//-----------------------------------------------------------------------------
+class asset_key
+{
+public:
+	asset_key();
+
+	asset_key& operator=(const std::string& key);
+
+	//-----------------------------------------------------------------------------
+	//  Name : clear ()
+	/// <summary>
+	/// Resets to the empty key. The interned entry itself stays in the
+	/// table for any other holder.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void clear();
+
+	inline operator const std::string&() const
+	{
+		return *_str;
+	}
+
+	inline const std::string& str() const
+	{
+		return *_str;
+	}
+
+	inline asset_id id() const
+	{
+		return _id;
+	}
+
+	inline bool empty() const
+	{
+		return _id.value == 0;
+	}
+
+private:
+	/// Interned id of the key.
+	asset_id _id;
+	/// Cached pointer into the intern table. Entries are never evicted,
+	/// so it stays valid even while the table grows.
+	const std::string* _str;
+};
+}
+
+namespace std
+{
+template <>
+struct hash<runtime::asset_id>
+{
+	std::size_t operator()(const runtime::asset_id& id) const
+	{
+		return static_cast<std::size_t>(id.value);
+	}
+};
+}
@@ -1,16 +1,39 @@
 #include "asset_manager.h"
+#include "../system/events.h"
+#include "impl/asset_reader.h"
+#include "core/simulation/simulation.h"
 
 namespace runtime
 {
 asset_manager::asset_manager()
 {
+	on_frame_update.connect(this, &asset_manager::frame_update);
 }
 
 asset_manager::~asset_manager()
 {
+	on_frame_update.disconnect(this, &asset_manager::frame_update);
 	clear();
 }
 
+void asset_manager::frame_update(std::chrono::duration<float> /*dt*/)
+{
+	if(_max_unused_frames == 0 || !core::has_subsystems<core::simulation>())
+		return;
+
+	const auto frame = core::get_subsystem<core::simulation>().get_frame();
+	for(auto& pair : _storages)
+	{
+		pair.second->sweep_unused(frame, _max_unused_frames, _frame_sweep_budget);
+	}
+}
+
+void asset_manager::set_eviction_policy(std::uint64_t max_unused_frames, std::size_t frame_budget)
+{
+	_max_unused_frames = max_unused_frames;
+	_frame_sweep_budget = frame_budget;
+}
+
 void asset_manager::clear()
 {
 	for(auto& pair : _storages)
@@ -20,6 +43,28 @@ void asset_manager::clear()
 	}
 }
 
+void asset_manager::prefetch_dependencies(const std::string& key)
+{
+	if(_prefetchers.empty())
+		return;
+
+	std::vector<std::string> dependencies;
+	if(!asset_reader::read_dependencies(key, dependencies))
+		return;
+
+	for(const auto& dependency : dependencies)
+	{
+		// Guard against a malformed list referencing its own asset.
+		if(dependency == key)
+			continue;
+
+		const auto extension = fs::path(dependency).extension().string();
+		auto it = _prefetchers.find(extension);
+		if(it != _prefetchers.end())
+			it->second(dependency);
+	}
+}
+
 void asset_manager::clear(const std::string& group)
 {
 	for(auto& pair : _storages)
@@ -2,10 +2,17 @@
 
 #include <functional>
 #include <unordered_map>
+#include <vector>
 
 #include "asset_flags.h"
 #include "asset_storage.h"
+#include "../system/hitch_detector.h"
+#include "core/profiler/profiler.h"
+#include "core/system/subsystem.h"
+#include "impl/load_queue.h"
+#include "impl/upload_queue.h"
 #include <cassert>
+#include <thread>
 
 namespace runtime
 {
@@ -34,6 +41,27 @@ public:
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	void clear(const std::string& group);
+
+	//-----------------------------------------------------------------------------
+	//  Name : frame_update ()
+	/// <summary>
+	/// Per-frame incremental sweep - each storage examines a bounded slice
+	/// of its entries and evicts the ones unreferenced past the configured
+	/// window, so long sessions stay memory bounded without the
+	/// stop-the-world clears.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void frame_update(std::chrono::duration<float> dt);
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_eviction_policy ()
+	/// <summary>
+	/// Tunes the sweep - entries unreferenced for max_unused_frames are
+	/// evicted, examining at most frame_budget entries per storage per
+	/// frame. A window of 0 disables the sweep.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_eviction_policy(std::uint64_t max_unused_frames, std::size_t frame_budget);
 	//-----------------------------------------------------------------------------
 	//  Name : add_storage ()
 	/// <summary>
@@ -51,13 +79,57 @@ public:
 
 	template <typename T>
 	core::task_future<asset_handle<T>> load(const std::string& key, load_mode mode = load_mode::sync,
-											load_flags flags = load_flags::standard)
+											load_flags flags = load_flags::standard,
+											load_priority priority = load_priority::normal)
 	{
 		auto& storage = get_storage<T>();
-		return load_asset_from_file_impl<T>(key, mode, flags, storage.container_mutex, storage.container,
+		const auto id = intern_asset_key(key);
+		return load_asset_from_file_impl<T>(key, id, mode, flags, priority, storage.get_shard(id),
 											storage.load_from_file);
 	}
 
+	//-----------------------------------------------------------------------------
+	//  Name : prioritize ()
+	/// <summary>
+	/// Promotes the IO of an in-flight load request. Call when a still
+	/// pending handle turns out to be urgent - e.g. the render path hits
+	/// an asset that is waiting behind background prefetches.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <typename T>
+	void prioritize(const std::string& key, load_priority priority)
+	{
+		auto& storage = get_storage<T>();
+		const auto id = intern_asset_key(key);
+		auto& sh = storage.get_shard(id);
+
+		std::lock_guard<std::recursive_mutex> lock(sh.mutex);
+		auto it = sh.container.find(id);
+		if(it != sh.container.end() && !it->second.is_ready() && core::has_subsystems<load_queue>())
+		{
+			core::get_subsystem<load_queue>().prioritize(key, priority);
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : register_prefetch ()
+	/// <summary>
+	/// Associates a set of key extensions with an asset type so the
+	/// dependency lists the compiler records can fan out typed loads for
+	/// matching keys.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <typename T>
+	void register_prefetch(const std::vector<std::string>& extensions)
+	{
+		for(const auto& extension : extensions)
+		{
+			_prefetchers[extension] = [this](const std::string& key) {
+				load<T>(key, load_mode::async, load_flags::standard, load_priority::normal);
+			};
+		}
+	}
+
 	//-----------------------------------------------------------------------------
 	//  Name : create_asset_from_memory ()
 	/// <summary>
@@ -72,15 +144,17 @@ public:
 							 load_mode mode = load_mode::sync, load_flags flags = load_flags::standard)
 	{
 		auto& storage = get_storage<T>();
-		return create_asset_from_memory_impl<T>(key, data, size, mode, flags, storage.container_mutex,
-												storage.container, storage.load_from_memory);
+		const auto id = intern_asset_key(key);
+		return create_asset_from_memory_impl<T>(key, id, data, size, mode, flags, storage.get_shard(id),
+												storage.load_from_memory);
 	}
 
 	template <typename T>
 	core::task_future<asset_handle<T>> find_asset_entry(const std::string& key)
 	{
 		auto& storage = get_storage<T>();
-		return find_asset_impl<T>(key, storage.container_mutex, storage.container);
+		const auto id = intern_asset_key(key);
+		return find_asset_impl<T>(id, storage.get_shard(id));
 	}
 
 	template <typename T>
@@ -88,7 +162,8 @@ public:
 																std::shared_ptr<T> entry)
 	{
 		auto& storage = get_storage<T>();
-		return load_asset_from_instance_impl(key, entry, storage.container_mutex, storage.container,
+		const auto id = intern_asset_key(key);
+		return load_asset_from_instance_impl(key, id, entry, storage.get_shard(id),
 											 storage.load_from_instance);
 	}
 
@@ -96,16 +171,42 @@ public:
 	void rename_asset(const std::string& key, const std::string& new_key)
 	{
 		auto& storage = get_storage<T>();
+		const auto id_from = intern_asset_key(key);
+		const auto id_to = intern_asset_key(new_key);
+		auto& shard_from = storage.get_shard(id_from);
+		auto& shard_to = storage.get_shard(id_to);
+
+		// The two keys may hash into different shards; lock both in a
+		// stable (address) order to avoid deadlocking with a concurrent
+		// rename in the opposite direction.
+		std::unique_lock<std::recursive_mutex> lock_from(shard_from.mutex, std::defer_lock);
+		std::unique_lock<std::recursive_mutex> lock_to(shard_to.mutex, std::defer_lock);
+		if(&shard_from == &shard_to)
+		{
+			lock_from.lock();
+		}
+		else if(&shard_from < &shard_to)
+		{
+			lock_from.lock();
+			lock_to.lock();
+		}
+		else
+		{
+			lock_to.lock();
+			lock_from.lock();
+		}
 
-		std::lock_guard<std::recursive_mutex> lock(storage.container_mutex);
-		auto it = storage.container.find(key);
-		if(it != storage.container.end())
+		auto it = shard_from.container.find(id_from);
+		if(it != shard_from.container.end())
 		{
 			auto& future = it->second;
+			wait_serving_uploads(future);
 			auto asset = future.get();
 			asset.link->id = new_key;
-			storage.container[new_key] = future;
-			storage.container.erase(it);
+			shard_to.container[id_to] = future;
+			shard_to.index_insert(new_key, id_to);
+			shard_from.container.erase(it);
+			shard_from.index_erase(key, id_from);
 		}
 	}
 
@@ -113,21 +214,39 @@ public:
 	void clear_asset(const std::string& key)
 	{
 		auto& storage = get_storage<T>();
+		const auto id = intern_asset_key(key);
+		auto& sh = storage.get_shard(id);
 
-		std::lock_guard<std::recursive_mutex> lock(storage.container_mutex);
-		auto it = storage.container.find(key);
-		if(it != storage.container.end())
+		std::lock_guard<std::recursive_mutex> lock(sh.mutex);
+		auto it = sh.container.find(id);
+		if(it != sh.container.end())
 		{
 			auto& future = it->second;
 
+			wait_serving_uploads(future);
 			auto asset = future.get();
 			asset.link->asset.reset();
 			asset.link->id.clear();
 
-			storage.container.erase(it);
+			sh.container.erase(it);
+			sh.index_erase(key, id);
 		}
 	}
 
+	//-----------------------------------------------------------------------------
+	//  Name : enumerate_group ()
+	/// <summary>
+	/// Visits every request of the given type whose key begins with the
+	/// group prefix, through the storage's group index, so the cost scales
+	/// with the group rather than everything loaded.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <typename T>
+	void enumerate_group(const std::string& group, const typename asset_storage<T>::visitor_t& visitor)
+	{
+		get_storage<T>().enumerate_group(group, visitor);
+	}
+
 	//-----------------------------------------------------------------------------
 	//  Name : save ()
 	/// <summary>
@@ -145,6 +264,16 @@ public:
 	}
 
 private:
+	//-----------------------------------------------------------------------------
+	//  Name : prefetch_dependencies ()
+	/// <summary>
+	/// Dispatches loads for every dependency recorded next to the compiled
+	/// asset with the specified key. Unknown extensions are skipped; keys
+	/// already requested resolve to their existing entries.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void prefetch_dependencies(const std::string& key);
+
 	//-----------------------------------------------------------------------------
 	//  Name : load_asset_from_file_impl ()
 	/// <summary>
@@ -155,12 +284,29 @@ private:
 	//-----------------------------------------------------------------------------
 	template <typename T, typename F>
 	core::task_future<asset_handle<T>>
-	load_asset_from_file_impl(const std::string& key, load_mode mode, load_flags flags,
-							  std::recursive_mutex& container_mutex,
-							  typename asset_storage<T>::request_container_t& container, F&& load_func)
+	load_asset_from_file_impl(const std::string& key, asset_id id, load_mode mode, load_flags flags,
+							  load_priority priority, typename asset_storage<T>::shard& sh,
+							  F&& load_func)
 	{
-		std::unique_lock<std::recursive_mutex> lock(container_mutex);
-		auto it = container.find(key);
+		// Inclusive of the wait when the caller loads synchronously, so
+		// main-thread stalls on sync loads show up in the frame capture.
+		PROFILE_SCOPE("assets/load_request");
+
+		if(core::has_subsystems<hitch_detector>())
+		{
+			core::get_subsystem<hitch_detector>().note_asset_event(
+				(mode == load_mode::sync ? "sync load " : "async load ") + key);
+		}
+
+		auto& container = sh.container;
+
+		// Someone is blocking on a synchronous load; its IO always jumps
+		// ahead of queued background work.
+		if(mode == load_mode::sync)
+			priority = load_priority::high;
+
+		std::unique_lock<std::recursive_mutex> lock(sh.mutex);
+		auto it = container.find(id);
 		if(it != std::end(container))
 		{
 			auto& future = it->second;
@@ -169,25 +315,56 @@ private:
 				if(load_func)
 					load_func(future, key);
 			}
+
+			// Re-prioritize the in-flight IO if this request is more
+			// urgent than the one that queued it.
+			if(!future.is_ready() && core::has_subsystems<load_queue>())
+				core::get_subsystem<load_queue>().prioritize(key, priority);
+
 			auto future_copy = future;
 
 			lock.unlock();
 
 			if(mode == load_mode::sync)
 			{
-				future_copy.wait();
+				wait_serving_uploads(future_copy);
 			}
 
 			return future_copy;
 		}
 		else
 		{
-			auto& future = container[key];
+			auto& future = container[id];
+			sh.index_insert(key, id);
+
+			// Record the scheduling class the reader should queue the IO
+			// under before dispatching.
+			if(core::has_subsystems<load_queue>())
+				core::get_subsystem<load_queue>().set_request_priority(key, priority);
+
 			// Dispatch the loading
 			if(load_func)
 				load_func(future, key);
 
-			return future;
+			auto future_copy = future;
+
+			lock.unlock();
+
+			// Fan out any dependencies the compiler recorded for this asset
+			// so they read in parallel with it instead of one wave at a time
+			// as it deserializes. Done outside the shard lock since the
+			// dependencies hash into arbitrary shards.
+			prefetch_dependencies(key);
+
+			// Resolve before returning so a synchronous caller never has
+			// to block on the raw future - its creation may be staged in
+			// the upload queue this thread is responsible for draining.
+			if(mode == load_mode::sync)
+			{
+				wait_serving_uploads(future_copy);
+			}
+
+			return future_copy;
 		}
 	}
 
@@ -201,13 +378,14 @@ private:
 	//-----------------------------------------------------------------------------
 	template <typename T, typename F>
 	core::task_future<asset_handle<T>>&
-	create_asset_from_memory_impl(const std::string& key, const std::uint8_t* data, const std::uint32_t& size,
-								  load_mode mode, load_flags flags, std::recursive_mutex& container_mutex,
-								  typename asset_storage<T>::request_container_t& container, F&& load_func)
+	create_asset_from_memory_impl(const std::string& key, asset_id id, const std::uint8_t* data,
+								  const std::uint32_t& size, load_mode mode, load_flags flags,
+								  typename asset_storage<T>::shard& sh, F&& load_func)
 	{
+		auto& container = sh.container;
 
-		std::lock_guard<std::recursive_mutex> lock(container_mutex);
-		auto it = container.find(key);
+		std::lock_guard<std::recursive_mutex> lock(sh.mutex);
+		auto it = container.find(id);
 		if(it != std::end(container))
 		{
 			// If there is already a loading request.
@@ -216,7 +394,8 @@ private:
 		}
 		else
 		{
-			auto& future = container[key];
+			auto& future = container[id];
+			sh.index_insert(key, id);
 			// Dispatch the loading
 			if(load_func)
 				load_func(future, key, data, size);
@@ -227,12 +406,12 @@ private:
 
 	template <typename T, typename F>
 	core::task_future<asset_handle<T>>&
-	load_asset_from_instance_impl(const std::string& key, std::shared_ptr<T> entry,
-								  std::recursive_mutex& container_mutex,
-								  typename asset_storage<T>::request_container_t& container, F&& load_func)
+	load_asset_from_instance_impl(const std::string& key, asset_id id, std::shared_ptr<T> entry,
+								  typename asset_storage<T>::shard& sh, F&& load_func)
 	{
-		std::lock_guard<std::recursive_mutex> lock(container_mutex);
-		auto& future = container[key];
+		std::lock_guard<std::recursive_mutex> lock(sh.mutex);
+		auto& future = sh.container[id];
+		sh.index_insert(key, id);
 		// Dispatch the loading
 		if(load_func)
 			load_func(future, key, entry);
@@ -241,12 +420,12 @@ private:
 	}
 
 	template <typename T>
-	core::task_future<asset_handle<T>>
-	find_asset_impl(const std::string& key, std::recursive_mutex& container_mutex,
-					typename asset_storage<T>::request_container_t& container)
+	core::task_future<asset_handle<T>> find_asset_impl(asset_id id, typename asset_storage<T>::shard& sh)
 	{
-		std::lock_guard<std::recursive_mutex> lock(container_mutex);
-		auto it = container.find(key);
+		auto& container = sh.container;
+
+		std::lock_guard<std::recursive_mutex> lock(sh.mutex);
+		auto it = container.find(id);
 		if(it != container.end())
 		{
 			return it->second;
@@ -272,5 +451,13 @@ private:
 	}
 	/// Different storages
 	std::unordered_map<std::size_t, std::unique_ptr<basic_storage>> _storages;
+	/// Typed load dispatchers for dependency prefetching, keyed by the
+	/// asset key extension each storage type claims.
+	std::unordered_map<std::string, std::function<void(const std::string&)>> _prefetchers;
+	/// entries unreferenced for this many frames are evicted; 0 disables
+	/// the sweep
+	std::uint64_t _max_unused_frames = 3600;
+	/// entries examined per storage per frame by the sweep
+	std::size_t _frame_sweep_budget = 64;
 };
 }
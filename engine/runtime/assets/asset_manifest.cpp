@@ -0,0 +1,175 @@
+#include "asset_manifest.h"
+#include "core/logging/logging.h"
+
+#include <fstream>
+
+namespace runtime
+{
+namespace
+{
+/// 'EMAN' in little endian.
+const std::uint32_t manifest_magic = 0x4E414D45;
+/// Bumped whenever the header or record layout changes.
+const std::uint32_t manifest_version = 1;
+
+//-----------------------------------------------------------------------------
+//  Name : read_pod () (Local)
+/// <summary>
+/// Reads a trivially copyable value from the stream. Returns false when
+/// the stream ran out.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T>
+bool read_pod(std::istream& stream, T& out)
+{
+	stream.read(reinterpret_cast<char*>(&out), sizeof(T));
+	return stream.good();
+}
+
+//-----------------------------------------------------------------------------
+//  Name : write_pod () (Local)
+/// <summary>
+/// Writes a trivially copyable value to the stream.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T>
+void write_pod(std::ostream& stream, const T& value)
+{
+	stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+}
+
+bool asset_manifest::load(const fs::path& manifest_path)
+{
+	std::ifstream stream{manifest_path.string(), std::ios::in | std::ios::binary};
+	if(!stream.good())
+	{
+		APPLOG_ERROR("Failed to open asset manifest {0}.", manifest_path.string());
+		return false;
+	}
+
+	std::uint32_t magic = 0;
+	std::uint32_t version = 0;
+	std::uint64_t entry_count = 0;
+	if(!read_pod(stream, magic) || !read_pod(stream, version) || !read_pod(stream, entry_count) ||
+	   magic != manifest_magic || version != manifest_version)
+	{
+		APPLOG_ERROR("Asset manifest {0} has an invalid header.", manifest_path.string());
+		return false;
+	}
+
+	std::unordered_map<std::string, std::uint64_t> index;
+	index.reserve(static_cast<std::size_t>(entry_count));
+
+	for(std::uint64_t i = 0; i < entry_count; ++i)
+	{
+		std::uint64_t size = 0;
+		std::uint16_t key_length = 0;
+		if(!read_pod(stream, size) || !read_pod(stream, key_length))
+		{
+			APPLOG_ERROR("Asset manifest {0} is truncated.", manifest_path.string());
+			return false;
+		}
+
+		std::string key(key_length, '\0');
+		stream.read(&key[0], key_length);
+		if(!stream.good())
+		{
+			APPLOG_ERROR("Asset manifest {0} is truncated.", manifest_path.string());
+			return false;
+		}
+
+		index.emplace(std::move(key), size);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_index = std::move(index);
+		_loaded = true;
+	}
+
+	APPLOG_INFO("Loaded asset manifest {0} with {1} entries.", manifest_path.string(), entry_count);
+	return true;
+}
+
+void asset_manifest::unload()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_index.clear();
+	_loaded = false;
+}
+
+bool asset_manifest::is_loaded() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _loaded;
+}
+
+bool asset_manifest::get_size(const std::string& compiled_key, std::uint64_t& out_size) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _index.find(compiled_key);
+	if(it == _index.end())
+		return false;
+
+	out_size = it->second;
+	return true;
+}
+
+std::uint64_t asset_manifest::get_entry_count() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _index.size();
+}
+
+bool asset_manifest::build(const fs::path& manifest_path, const fs::path& cache_dir)
+{
+	fs::error_code err;
+	if(!fs::exists(cache_dir, err))
+		return false;
+
+	// Collect every compiled file under the cache, keyed in protocol form
+	// so the runtime can look entries up without resolving paths first.
+	std::unordered_map<std::string, std::uint64_t> index;
+	fs::recursive_directory_iterator it(cache_dir, err);
+	for(const auto& entry : it)
+	{
+		const auto& entry_path = entry.path();
+		fs::error_code file_err;
+		if(!fs::is_regular_file(entry_path, file_err))
+			continue;
+
+		if(entry_path == manifest_path)
+			continue;
+
+		fs::error_code size_err;
+		const auto size = fs::file_size(entry_path, size_err);
+		if(size_err)
+			continue;
+
+		const auto key = fs::convert_to_protocol(entry_path).generic_string();
+		index.emplace(key, static_cast<std::uint64_t>(size));
+	}
+
+	std::ofstream stream{manifest_path.string(), std::ios::out | std::ios::binary | std::ios::trunc};
+	if(!stream.good())
+	{
+		APPLOG_ERROR("Failed to write asset manifest {0}.", manifest_path.string());
+		return false;
+	}
+
+	write_pod(stream, manifest_magic);
+	write_pod(stream, manifest_version);
+	write_pod(stream, static_cast<std::uint64_t>(index.size()));
+
+	for(const auto& entry : index)
+	{
+		write_pod(stream, entry.second);
+		write_pod(stream, static_cast<std::uint16_t>(entry.first.size()));
+		stream.write(entry.first.data(), static_cast<std::streamsize>(entry.first.size()));
+	}
+
+	APPLOG_INFO("Wrote asset manifest {0} with {1} entries.", manifest_path.string(), index.size());
+	return stream.good();
+}
+}
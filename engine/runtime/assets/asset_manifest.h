@@ -0,0 +1,91 @@
+#pragma once
+
+#include "core/filesystem/filesystem.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace runtime
+{
+
+//-----------------------------------------------------------------------------
+//  Name : asset_manifest (Class)
+/// <summary>
+/// Cooked index of the compiled asset cache, mapping every compiled key
+/// to its size. Loaded once at startup (or project open) it answers the
+/// existence and size questions the readers would otherwise ask the
+/// filesystem per key - a stat storm on network filesystems. The
+/// manifest is advisory: a miss falls back to probing, so caches that
+/// changed after cooking still resolve.
+/// </summary>
+//-----------------------------------------------------------------------------
+class asset_manifest
+{
+public:
+	asset_manifest() = default;
+	~asset_manifest() = default;
+
+	//-----------------------------------------------------------------------------
+	//  Name : load ()
+	/// <summary>
+	/// Parses the binary manifest at the specified path, replacing any
+	/// previously loaded index.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool load(const fs::path& manifest_path);
+
+	//-----------------------------------------------------------------------------
+	//  Name : unload ()
+	/// <summary>
+	/// Drops the loaded index; lookups fall back to the filesystem.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void unload();
+
+	//-----------------------------------------------------------------------------
+	//  Name : is_loaded ()
+	/// <summary>
+	/// Returns whether an index is currently loaded.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool is_loaded() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_size ()
+	/// <summary>
+	/// Looks the compiled key (protocol form, e.g.
+	/// 'app:/cache/textures/stone.png.asset') up and returns its recorded
+	/// size. Returns false when the key was not cooked.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool get_size(const std::string& compiled_key, std::uint64_t& out_size) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_entry_count ()
+	/// <summary>
+	/// Returns the number of recorded entries.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::uint64_t get_entry_count() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : build ()
+	/// <summary>
+	/// Walks the specified compiled cache directory and writes a manifest
+	/// recording every file's key (protocol form) and size. Called by the
+	/// cook - the editor on project close - not by the runtime.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	static bool build(const fs::path& manifest_path, const fs::path& cache_dir);
+
+private:
+	/// Guards the index against a reload racing lookups.
+	mutable std::mutex _mutex;
+	/// Compiled key (protocol form) to size in bytes.
+	std::unordered_map<std::string, std::uint64_t> _index;
+	/// Whether load() succeeded.
+	bool _loaded = false;
+};
+}
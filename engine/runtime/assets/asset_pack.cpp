@@ -0,0 +1,224 @@
+#include "asset_pack.h"
+#include "core/logging/logging.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace runtime
+{
+namespace
+{
+/// 'EPAK' in little endian.
+const std::uint32_t pack_magic = 0x4B415045;
+/// Bumped whenever the header or record layout changes.
+const std::uint32_t pack_version = 1;
+
+//-----------------------------------------------------------------------------
+//  Name : hash_key () (Local)
+/// <summary>
+/// 64 bit FNV-1a over the key string. Stored with each index record so a
+/// truncated or corrupted index is caught at mount time.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::uint64_t hash_key(const std::string& key)
+{
+	std::uint64_t hash = 0xCBF29CE484222325ull;
+	for(const char c : key)
+	{
+		hash ^= static_cast<std::uint8_t>(c);
+		hash *= 0x100000001B3ull;
+	}
+	return hash;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : read_pod () (Local)
+/// <summary>
+/// Reads a trivially copyable value out of the mapping, advancing the
+/// cursor. Returns false when the mapping is too small.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T>
+bool read_pod(const std::uint8_t* data, std::uint64_t size, std::uint64_t& cursor, T& out)
+{
+	if(cursor + sizeof(T) > size)
+		return false;
+
+	std::memcpy(&out, data + cursor, sizeof(T));
+	cursor += sizeof(T);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : write_pod () (Local)
+/// <summary>
+/// Writes a trivially copyable value to the stream.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T>
+void write_pod(std::ostream& stream, const T& value)
+{
+	stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+}
+
+bool asset_pack::mount(const fs::path& pack_path)
+{
+	unmount();
+
+	if(!_mapping.open(pack_path))
+	{
+		APPLOG_ERROR("Failed to map asset pack {0}.", pack_path.string());
+		return false;
+	}
+
+	const std::uint8_t* data = _mapping.data();
+	const std::uint64_t size = _mapping.size();
+	std::uint64_t cursor = 0;
+
+	std::uint32_t magic = 0;
+	std::uint32_t version = 0;
+	std::uint64_t entry_count = 0;
+	if(!read_pod(data, size, cursor, magic) || !read_pod(data, size, cursor, version) ||
+	   !read_pod(data, size, cursor, entry_count))
+	{
+		APPLOG_ERROR("Asset pack {0} is truncated.", pack_path.string());
+		unmount();
+		return false;
+	}
+
+	if(magic != pack_magic || version != pack_version)
+	{
+		APPLOG_ERROR("Asset pack {0} has an unsupported format.", pack_path.string());
+		unmount();
+		return false;
+	}
+
+	_index.reserve(static_cast<std::size_t>(entry_count));
+	std::string key;
+	for(std::uint64_t i = 0; i < entry_count; ++i)
+	{
+		std::uint64_t hash = 0;
+		std::uint64_t offset = 0;
+		std::uint64_t entry_size = 0;
+		std::uint16_t key_length = 0;
+		if(!read_pod(data, size, cursor, hash) || !read_pod(data, size, cursor, offset) ||
+		   !read_pod(data, size, cursor, entry_size) || !read_pod(data, size, cursor, key_length) ||
+		   cursor + key_length > size)
+		{
+			APPLOG_ERROR("Asset pack {0} has a truncated index.", pack_path.string());
+			unmount();
+			return false;
+		}
+
+		key.assign(reinterpret_cast<const char*>(data + cursor), key_length);
+		cursor += key_length;
+
+		// Validate the record before trusting it: the key must hash to the
+		// stored value and the slice must lie inside the mapping.
+		if(hash_key(key) != hash || offset > size || entry_size > size - offset)
+		{
+			APPLOG_ERROR("Asset pack {0} has a corrupted record for key {1}.", pack_path.string(), key);
+			unmount();
+			return false;
+		}
+
+		slice entry;
+		entry.data = data + offset;
+		entry.size = entry_size;
+		_index.emplace(key, entry);
+	}
+
+	APPLOG_INFO("Mounted asset pack {0} ({1} entries).", pack_path.string(), _index.size());
+	return true;
+}
+
+void asset_pack::unmount()
+{
+	_index.clear();
+	_mapping.close();
+}
+
+bool asset_pack::is_mounted() const
+{
+	return _mapping.is_open();
+}
+
+bool asset_pack::find(const std::string& key, slice& out_slice) const
+{
+	auto it = _index.find(key);
+	if(it == _index.end())
+		return false;
+
+	out_slice = it->second;
+	return true;
+}
+
+std::size_t asset_pack::get_entry_count() const
+{
+	return _index.size();
+}
+
+bool asset_pack::build(const fs::path& pack_path,
+					   const std::vector<std::pair<std::string, fs::path>>& files)
+{
+	// The index precedes the data, so the record block size (and with it
+	// every data offset) has to be known up front.
+	std::uint64_t index_size = sizeof(pack_magic) + sizeof(pack_version) + sizeof(std::uint64_t);
+	std::vector<std::uint64_t> sizes;
+	sizes.reserve(files.size());
+	for(const auto& file : files)
+	{
+		fs::error_code err;
+		const auto file_size = fs::file_size(file.second, err);
+		if(err)
+		{
+			APPLOG_ERROR("Failed to stat {0} while building asset pack {1}.", file.second.string(),
+						 pack_path.string());
+			return false;
+		}
+
+		sizes.push_back(static_cast<std::uint64_t>(file_size));
+		index_size += sizeof(std::uint64_t) * 3 + sizeof(std::uint16_t) + file.first.size();
+	}
+
+	std::ofstream stream{pack_path.string(), std::ios::out | std::ios::binary | std::ios::trunc};
+	if(!stream.good())
+	{
+		APPLOG_ERROR("Failed to open asset pack {0} for writing.", pack_path.string());
+		return false;
+	}
+
+	write_pod(stream, pack_magic);
+	write_pod(stream, pack_version);
+	write_pod(stream, static_cast<std::uint64_t>(files.size()));
+
+	std::uint64_t offset = index_size;
+	for(std::size_t i = 0; i < files.size(); ++i)
+	{
+		const auto& key = files[i].first;
+		write_pod(stream, hash_key(key));
+		write_pod(stream, offset);
+		write_pod(stream, sizes[i]);
+		write_pod(stream, static_cast<std::uint16_t>(key.size()));
+		stream.write(key.data(), static_cast<std::streamsize>(key.size()));
+
+		offset += sizes[i];
+	}
+
+	for(const auto& file : files)
+	{
+		std::ifstream source{file.second.string(), std::ios::in | std::ios::binary};
+		if(!source.good())
+		{
+			APPLOG_ERROR("Failed to read {0} while building asset pack {1}.", file.second.string(),
+						 pack_path.string());
+			return false;
+		}
+
+		stream << source.rdbuf();
+	}
+
+	return stream.good();
+}
+}
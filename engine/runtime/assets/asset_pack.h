@@ -0,0 +1,106 @@
+#pragma once
+
+#include "core/filesystem/filesystem.h"
+#include "core/filesystem/memory_mapped_file.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace runtime
+{
+//-----------------------------------------------------------------------------
+//  Name : asset_pack (Class)
+/// <summary>
+/// A single memory mapped archive bundling many compiled assets. The pack
+/// carries an index of key -> offset/size/hash records, so a mounted pack
+/// serves reads as pointer slices into the mapping - cold startup touches
+/// one file instead of thousands of loose ones. The asset readers consult
+/// the mounted pack before falling back to loose files, which keeps the
+/// editor workflow (loose, rewritable files) working unchanged.
+/// </summary>
+//-----------------------------------------------------------------------------
+class asset_pack
+{
+public:
+	//-----------------------------------------------------------------------------
+	//  Name : slice (Struct)
+	/// <summary>
+	/// A view into the mapped archive. Valid for as long as the pack stays
+	/// mounted; the pack subsystem outlives every asset loaded from it.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	struct slice
+	{
+		/// Start of the entry's bytes inside the mapping.
+		const std::uint8_t* data = nullptr;
+		/// Size of the entry in bytes.
+		std::uint64_t size = 0;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : mount ()
+	/// <summary>
+	/// Maps the specified pack file and parses its index. Any previously
+	/// mounted pack is released first. Returns false when the file cannot
+	/// be mapped or its index is malformed.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool mount(const fs::path& pack_path);
+
+	//-----------------------------------------------------------------------------
+	//  Name : unmount ()
+	/// <summary>
+	/// Releases the mapping and clears the index. Slices handed out earlier
+	/// become invalid.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void unmount();
+
+	//-----------------------------------------------------------------------------
+	//  Name : is_mounted ()
+	/// <summary>
+	/// Whether a pack is currently mounted.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool is_mounted() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : find ()
+	/// <summary>
+	/// Looks the key up in the index. Returns true and fills 'out_slice'
+	/// with a view into the mapping when the pack contains the entry. The
+	/// index is immutable after mount, so lookups are safe from any thread.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool find(const std::string& key, slice& out_slice) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_entry_count ()
+	/// <summary>
+	/// Number of entries in the mounted pack.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t get_entry_count() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : build ()
+	/// <summary>
+	/// Writes a pack file containing the given (key, source file) pairs.
+	/// Used by the deployment pipeline to bundle a compiled asset cache.
+	/// Returns false when any source file cannot be read or the pack
+	/// cannot be written.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	static bool build(const fs::path& pack_path,
+					  const std::vector<std::pair<std::string, fs::path>>& files);
+
+private:
+	/// Mapping over the whole pack file.
+	fs::memory_mapped_file _mapping;
+	/// Key to slice lookup, built once at mount time.
+	std::unordered_map<std::string, slice> _index;
+};
+}
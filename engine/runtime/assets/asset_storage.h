@@ -1,13 +1,18 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
+#include <map>
 #include <unordered_map>
+#include <vector>
 
 #include "core/common/nonstd/type_traits.hpp"
 #include "core/string_utils/string_utils.h"
 #include "core/tasks/task_system.h"
 
 #include "asset_handle.h"
+#include "asset_id.h"
+#include "impl/upload_queue.h"
 #include <cassert>
 
 namespace runtime
@@ -44,13 +49,25 @@ struct basic_storage
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	virtual void clear(const std::string& group) = 0;
+
+	//-----------------------------------------------------------------------------
+	//  Name : sweep_unused (virtual )
+	/// <summary>
+	/// Examines a bounded slice of the storage and evicts entries that
+	/// stayed unreferenced for max_unused_frames. Returns the number of
+	/// evictions. Call once per frame from the owner thread.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	virtual std::size_t sweep_unused(std::uint64_t frame, std::uint64_t max_unused_frames,
+									 std::size_t budget) = 0;
 };
 
 template <typename T>
 struct asset_storage : public basic_storage
 {
-	/// aliases
-	using request_container_t = std::unordered_map<std::string, core::task_future<asset_handle<T>>>;
+	/// aliases. Requests are keyed by interned id - hashing and comparing
+	/// one integer instead of a path string on every container touch.
+	using request_container_t = std::unordered_map<asset_id, core::task_future<asset_handle<T>>>;
 	template <typename F>
 	using callable = std::function<F>;
 	using load_from_file_t = callable<bool(core::task_future<asset_handle<T>>&, const std::string&)>;
@@ -61,6 +78,89 @@ struct asset_storage : public basic_storage
 	using delete_file_t = callable<void(const std::string&)>;
 
 	using predicate_t = callable<bool(const typename request_container_t::value_type&)>;
+	using visitor_t = callable<void(const std::string&, const core::task_future<asset_handle<T>>&)>;
+
+	//-----------------------------------------------------------------------------
+	//  Name : key_less_no_case (Struct)
+	/// <summary>
+	/// Orders index keys the way group matching compares them - case
+	/// insensitively - so a group's members form one contiguous range.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	struct key_less_no_case
+	{
+		bool operator()(const std::string& lhs, const std::string& rhs) const
+		{
+			return string_utils::compare(lhs, rhs, true) < 0;
+		}
+	};
+
+	/// Keys in group order. A multimap since distinct keys may compare
+	/// equal under the case insensitive ordering.
+	using key_index_t = std::multimap<std::string, asset_id, key_less_no_case>;
+
+	/// Number of independently locked shards the requests are spread over.
+	/// Keys map to shards by hash, so concurrent loads of different assets
+	/// rarely touch the same lock. Kept a power of two for cheap masking.
+	static const std::size_t shard_count = 16;
+
+	//-----------------------------------------------------------------------------
+	//  Name : shard (Struct)
+	/// <summary>
+	/// One slice of the request container with its own lock.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	struct shard
+	{
+		/// Guards this shard's container only.
+		std::recursive_mutex mutex;
+		/// Requests whose key hashes into this shard.
+		request_container_t container;
+		/// This shard's keys in group order, maintained alongside the
+		/// container so group operations walk just the matching range
+		/// instead of prefix-testing every request.
+		key_index_t index;
+
+		//-----------------------------------------------------------------------------
+		//  Name : index_insert ()
+		/// <summary>
+		/// Records the key under the group index; a no-op when the pair is
+		/// already present. Caller holds the shard lock.
+		/// </summary>
+		//-----------------------------------------------------------------------------
+		void index_insert(const std::string& key, asset_id id)
+		{
+			const auto range = index.equal_range(key);
+			for(auto it = range.first; it != range.second; ++it)
+			{
+				if(it->second == id)
+				{
+					return;
+				}
+			}
+			index.emplace(key, id);
+		}
+
+		//-----------------------------------------------------------------------------
+		//  Name : index_erase ()
+		/// <summary>
+		/// Drops the key's index entry. Caller holds the shard lock.
+		/// </summary>
+		//-----------------------------------------------------------------------------
+		void index_erase(const std::string& key, asset_id id)
+		{
+			const auto range = index.equal_range(key);
+			for(auto it = range.first; it != range.second; ++it)
+			{
+				if(it->second == id)
+				{
+					index.erase(it);
+					return;
+				}
+			}
+		}
+	};
+
 	//-----------------------------------------------------------------------------
 	//  Name : ~storage ()
 	/// <summary>
@@ -71,18 +171,34 @@ struct asset_storage : public basic_storage
 	//-----------------------------------------------------------------------------
 	~asset_storage() = default;
 
+	//-----------------------------------------------------------------------------
+	//  Name : get_shard ()
+	/// <summary>
+	/// Returns the shard responsible for the specified id. Interned ids
+	/// are sequential, so masking spreads them evenly over the shards.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	shard& get_shard(asset_id id)
+	{
+		return shards[id.value & (shard_count - 1)];
+	}
+
 	void clear_with_condition(const predicate_t& predicate)
 	{
-		std::lock_guard<std::recursive_mutex> lock(container_mutex);
-		for(auto it = container.cbegin(); it != container.cend();)
+		for(auto& sh : shards)
 		{
-			if(predicate(*it))
-			{
-				it = container.erase(it);
-			}
-			else
+			std::lock_guard<std::recursive_mutex> lock(sh.mutex);
+			for(auto it = sh.container.cbegin(); it != sh.container.cend();)
 			{
-				++it;
+				if(predicate(*it))
+				{
+					sh.index_erase(get_asset_key(it->first), it->first);
+					it = sh.container.erase(it);
+				}
+				else
+				{
+					++it;
+				}
 			}
 		}
 	}
@@ -98,7 +214,7 @@ struct asset_storage : public basic_storage
 	{
 		clear_with_condition([](const auto& it) {
 			const auto& task = it.second;
-			task.wait();
+			wait_serving_uploads(task);
 			return true;
 		});
 	}
@@ -106,24 +222,145 @@ struct asset_storage : public basic_storage
 	//-----------------------------------------------------------------------------
 	//  Name : clear ()
 	/// <summary>
-	///
-	///
-	///
+	/// Clears every request whose key begins with the group prefix. Walks
+	/// the group index range, so the cost scales with the group's member
+	/// count rather than the total request count.
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	virtual void clear(const std::string& group) final
 	{
-		clear_with_condition([&group](const auto& it) {
-			const auto& id = it.first;
-			const auto& task = it.second;
+		for(auto& sh : shards)
+		{
+			std::lock_guard<std::recursive_mutex> lock(sh.mutex);
+			for(auto it = sh.index.lower_bound(group);
+				it != sh.index.end() && string_utils::begins_with(it->first, group, true);)
+			{
+				auto request = sh.container.find(it->second);
+				if(request != sh.container.end())
+				{
+					wait_serving_uploads(request->second);
+					sh.container.erase(request);
+				}
+				it = sh.index.erase(it);
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : sweep_unused ()
+	/// <summary>
+	/// Incremental reclamation - walks up to 'budget' entries starting at
+	/// the persistent shard/bucket cursor. An entry whose record is shared
+	/// with anything outside the container gets its last-use frame
+	/// refreshed; one that stayed unshared past max_unused_frames is
+	/// evicted the same way the clears do. Spread over frames, the whole
+	/// storage is revisited continuously without a stop-the-world pass.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	virtual std::size_t sweep_unused(std::uint64_t frame, std::uint64_t max_unused_frames,
+									 std::size_t budget) final
+	{
+		std::size_t examined = 0;
+		std::size_t evicted = 0;
+		std::size_t shard_advances = 0;
+		std::vector<asset_id> evict;
 
-			if(string_utils::begins_with(id, group, true))
+		while(examined < budget && shard_advances <= shard_count)
+		{
+			auto& sh = shards[_sweep_shard & (shard_count - 1)];
+			std::lock_guard<std::recursive_mutex> lock(sh.mutex);
+
+			if(sh.container.empty() || _sweep_bucket >= sh.container.bucket_count())
 			{
-				task.wait();
-				return true;
+				_sweep_bucket = 0;
+				++_sweep_shard;
+				++shard_advances;
+				continue;
 			}
-			return false;
-		});
+
+			evict.clear();
+			for(auto it = sh.container.begin(_sweep_bucket); it != sh.container.end(_sweep_bucket); ++it)
+			{
+				++examined;
+
+				const auto& task = it->second;
+				if(!task.is_ready())
+				{
+					// still loading - trivially in use
+					continue;
+				}
+
+				const auto& handle = task.get();
+				auto* link = handle.link;
+				if(link == nullptr)
+				{
+					continue;
+				}
+
+				// the container's copy accounts for one handle and one
+				// shared_ptr reference; anything above that is an outside user
+				const bool referenced =
+					handle.use_count() > 1 || (link->asset && link->asset.use_count() > 1);
+
+				const auto last_used = link->last_used_frame.load(std::memory_order_relaxed);
+				if(referenced || last_used == 0)
+				{
+					// the first unreferenced sighting only starts the clock -
+					// the entry must stay unused for the full window
+					link->last_used_frame.store(frame, std::memory_order_relaxed);
+				}
+				else if(frame - last_used > max_unused_frames)
+				{
+					// instance-backed entries (the embedded primitives) have
+					// no file to reload from - never evict those
+					if(!string_utils::begins_with(get_asset_key(it->first), "embedded:", true))
+					{
+						evict.push_back(it->first);
+					}
+				}
+			}
+			++_sweep_bucket;
+
+			for(const auto id : evict)
+			{
+				auto request = sh.container.find(id);
+				if(request == sh.container.end())
+				{
+					continue;
+				}
+				wait_serving_uploads(request->second);
+				sh.index_erase(get_asset_key(id), id);
+				sh.container.erase(request);
+				++evicted;
+			}
+		}
+		return evicted;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : enumerate_group ()
+	/// <summary>
+	/// Visits every request whose key begins with the group prefix - in
+	/// key order within each shard - through the same index range the
+	/// group clear walks. The visitor runs under the shard lock - keep it
+	/// light.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void enumerate_group(const std::string& group, const visitor_t& visitor)
+	{
+		for(auto& sh : shards)
+		{
+			std::lock_guard<std::recursive_mutex> lock(sh.mutex);
+			for(auto it = sh.index.lower_bound(group);
+				it != sh.index.end() && string_utils::begins_with(it->first, group, true); ++it)
+			{
+				auto request = sh.container.find(it->second);
+				if(request != sh.container.end())
+				{
+					visitor(it->first, request->second);
+				}
+			}
+		}
 	}
 
 	/// key, mode
@@ -135,10 +372,14 @@ struct asset_storage : public basic_storage
 	/// key, asset
 	save_file_t save_to_file;
 
-	/// Storage container
-	request_container_t container;
+	/// Storage container, sharded by key hash so concurrent loads and
+	/// lookups of the same asset type scale with the worker count.
+	shard shards[shard_count];
 
-	/// Mutex
-	std::recursive_mutex container_mutex;
+private:
+	/// persistent sweep position - shard currently being walked
+	std::size_t _sweep_shard = 0;
+	/// persistent sweep position - next bucket within that shard
+	std::size_t _sweep_bucket = 0;
 };
 }
@@ -1,4 +1,8 @@
 #pragma once
+#include "core/string_utils/string_utils.h"
+
+#include <cstdint>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -51,4 +55,59 @@ inline const std::vector<std::string>& get_suported_scene_formats()
 	static std::vector<std::string> formats = {".sgr"};
 	return formats;
 }
+
+//-----------------------------------------------------------------------------
+//  Name : is_format ()
+/// <summary>
+/// Case insensitive membership test of an extension against one of the format
+/// tables above. The case folded key hashes of every table are built once up
+/// front, so a file watcher burst only ever hashes the incoming extension and
+/// falls back to a character compare on a hash match.
+/// </summary>
+//-----------------------------------------------------------------------------
+inline bool is_format(const std::string& extension, const std::vector<std::string>& formats)
+{
+	static const std::map<const std::vector<std::string>*, std::vector<std::uint64_t>> folded_keys = []() {
+		std::map<const std::vector<std::string>*, std::vector<std::uint64_t>> keys;
+		for(const auto* table :
+			{&get_suported_texture_formats(), &get_suported_mesh_formats(), &get_suported_sound_formats(),
+			 &get_suported_shader_formats(), &get_suported_material_formats(),
+			 &get_suported_animation_formats(), &get_suported_prefab_formats(),
+			 &get_suported_scene_formats()})
+		{
+			auto& hashes = keys[table];
+			hashes.reserve(table->size());
+			for(const auto& format : *table)
+			{
+				hashes.push_back(string_utils::ihash(format));
+			}
+		}
+		return keys;
+	}();
+
+	auto it = folded_keys.find(&formats);
+	if(it != folded_keys.end())
+	{
+		const auto key = string_utils::ihash(extension);
+		const auto& hashes = it->second;
+		for(std::size_t i = 0; i < hashes.size(); ++i)
+		{
+			if(hashes[i] == key && string_utils::icompare(extension, formats[i]) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// unknown table - plain scan
+	for(const auto& format : formats)
+	{
+		if(string_utils::icompare(extension, format) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
 }
@@ -5,9 +5,17 @@
 #include "../../meta/audio/sound.hpp"
 #include "../../meta/rendering/material.hpp"
 #include "../../meta/rendering/mesh.hpp"
+#include "../../rendering/texture_residency.h"
+#include "../asset_manifest.h"
+#include "../asset_pack.h"
 #include "asset_extensions.h"
+#include "load_queue.h"
+#include "upload_queue.h"
 #include "core/audio/sound.h"
+#include "core/filesystem/async_read.h"
+#include "core/filesystem/chunked_reader.h"
 #include "core/filesystem/filesystem.h"
+#include "core/filesystem/memory_mapped_file.h"
 #include "core/graphics/index_buffer.h"
 #include "core/graphics/shader.h"
 #include "core/graphics/texture.h"
@@ -19,12 +27,226 @@
 #include "core/serialization/serialization.h"
 #include "core/serialization/types/map.hpp"
 #include "core/serialization/types/vector.hpp"
+#include "core/system/subsystem.h"
 #include <cstdint>
+#include <fstream>
+#include <istream>
+#include <sstream>
+#include <streambuf>
 
 namespace runtime
 {
 namespace asset_reader
 {
+namespace
+{
+//-----------------------------------------------------------------------------
+//  Name : find_packed () (Local)
+/// <summary>
+/// Looks the compiled key up in the mounted asset pack, if one is
+/// available. Served slices point straight into the pack mapping.
+/// </summary>
+//-----------------------------------------------------------------------------
+bool find_packed(const std::string& pack_key, asset_pack::slice& out_slice)
+{
+	if(!core::has_subsystems<asset_pack>())
+		return false;
+
+	return core::get_subsystem<asset_pack>().find(pack_key, out_slice);
+}
+
+//-----------------------------------------------------------------------------
+//  Name : dispatch_read () (Local)
+/// <summary>
+/// Routes the IO portion of a load through the prioritized load queue
+/// when it is available, falling back to a plain worker task otherwise.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename F>
+core::task_future<bool> dispatch_read(const std::string& key, std::uint64_t size_hint, F&& io_func)
+{
+	if(core::has_subsystems<load_queue>())
+		return core::get_subsystem<load_queue>().enqueue(key, size_hint, std::forward<F>(io_func));
+
+	// Asset IO rides the background lane so a decode burst cannot delay
+	// the frame-critical tasks sharing the workers.
+	auto& ts = core::get_subsystem<core::task_system>();
+	return ts.push_on_worker_thread(core::task_priority::background, std::forward<F>(io_func));
+}
+
+//-----------------------------------------------------------------------------
+//  Name : dispatch_read_bytes () (Local)
+/// <summary>
+/// Schedules a plain whole-file read into 'out'. With the load queue
+/// running the job rides the IO thread under its priority and bandwidth
+/// rules, parked on the async backend while the kernel transfers. Without
+/// it no thread blocks at all - the creation task chains on the async
+/// read's future and a worker only touches the job once the bytes are in.
+/// </summary>
+//-----------------------------------------------------------------------------
+core::task_future<bool> dispatch_read_bytes(const std::string& key, std::uint64_t size_hint,
+											const std::string& absolute_path,
+											std::shared_ptr<fs::byte_array_t> out)
+{
+	if(core::has_subsystems<load_queue>())
+	{
+		return core::get_subsystem<load_queue>().enqueue(key, size_hint, [absolute_path, out]() {
+			if(!out)
+				return false;
+
+			// Assembling chunk by chunk keeps the next transfer in flight
+			// while the current chunk is copied, with the chunk buffers
+			// recycled instead of reallocated. One contiguous copy is
+			// still required - bgfx takes the bytes as a single block.
+			fs::chunked_reader reader(absolute_path);
+			out->clear();
+			out->reserve(static_cast<std::size_t>(reader.size()));
+			while(true)
+			{
+				auto chunk = reader.next();
+				if(chunk.empty())
+					break;
+
+				out->insert(out->end(), chunk.begin(), chunk.end());
+				reader.recycle(std::move(chunk));
+			}
+			return !out->empty();
+		});
+	}
+
+	auto read = fs::read_async(absolute_path);
+	auto& ts = core::get_subsystem<core::task_system>();
+	return ts.push_on_worker_thread(core::task_priority::background,
+									[out](fs::byte_array_t bytes) {
+										if(!out)
+											return false;
+
+										*out = std::move(bytes);
+										return !out->empty();
+									},
+									read);
+}
+
+//-----------------------------------------------------------------------------
+//  Name : dispatch_gpu_create () (Local)
+/// <summary>
+/// Schedules the bgfx-facing part of a load. With the upload queue
+/// running, a worker stages the creation as a ready-to-upload job once
+/// the bytes are in and the renderer drains it under its per-frame
+/// budget, so streaming completions stop bunching into frame spikes.
+/// Without the queue the creation stays an ordinary owner-thread task.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename T, typename F>
+core::task_future<asset_handle<T>> dispatch_gpu_create(const std::string& key, std::uint64_t size_hint,
+													   F create_func, core::task_future<bool> ready)
+{
+	auto& ts = core::get_subsystem<core::task_system>();
+	if(core::has_subsystems<upload_queue>())
+	{
+		auto& uploads = core::get_subsystem<upload_queue>();
+		auto promise = std::make_shared<std::promise<asset_handle<T>>>();
+		auto future = core::task_future<asset_handle<T>>::from_future(promise->get_future());
+
+		ts.push_on_worker_thread(core::task_priority::background,
+								 [&uploads, key, size_hint, create_func, promise](bool read_result) mutable {
+									 uploads.enqueue(key, read_result ? size_hint : 0,
+													 [create_func, read_result, promise]() mutable {
+														 promise->set_value(create_func(read_result));
+													 });
+								 },
+								 ready);
+		return future;
+	}
+
+	return ts.push_on_owner_thread(std::move(create_func), ready);
+}
+
+//-----------------------------------------------------------------------------
+//  Name : notify_texture_loaded () (Local)
+/// <summary>
+/// Reports a created texture's GPU storage to the residency manager, if
+/// one is running, so the memory budget can be enforced.
+/// </summary>
+//-----------------------------------------------------------------------------
+void notify_texture_loaded(const std::string& key, const gfx::texture& tex)
+{
+	if(core::has_subsystems<texture_residency>())
+		core::get_subsystem<texture_residency>().on_loaded(key, tex.info.storageSize);
+}
+
+//-----------------------------------------------------------------------------
+//  Name : resolve_compiled () (Local)
+/// <summary>
+/// Resolves a compiled asset's existence and size, answering from the
+/// cooked manifest when one is loaded so resolution never stats the
+/// filesystem. The manifest is advisory - a miss falls back to probing,
+/// so assets compiled after the cook still resolve in the editor.
+/// </summary>
+//-----------------------------------------------------------------------------
+bool resolve_compiled(const std::string& compiled_key, const std::string& compiled_absolute_key,
+					  std::uint64_t& out_size_hint)
+{
+	if(core::has_subsystems<asset_manifest>())
+	{
+		auto& manifest = core::get_subsystem<asset_manifest>();
+		if(manifest.is_loaded() && manifest.get_size(compiled_key, out_size_hint))
+			return true;
+	}
+
+	fs::error_code err;
+	if(!fs::exists(compiled_absolute_key, err))
+		return false;
+
+	fs::error_code size_err;
+	const auto file_size = fs::file_size(compiled_absolute_key, size_err);
+	out_size_hint = size_err ? 0 : static_cast<std::uint64_t>(file_size);
+	return true;
+}
+}
+
+bool read_dependencies(const std::string& key, std::vector<std::string>& out_dependencies)
+{
+	if(!fs::has_known_protocol(key))
+		return false;
+
+	auto cache_key = fs::replace(key, ":/data", ":/cache");
+
+	std::string text;
+	asset_pack::slice packed;
+	if(find_packed(cache_key + ".asset.deps", packed) && packed.size > 0)
+	{
+		text.assign(reinterpret_cast<const char*>(packed.data), static_cast<std::size_t>(packed.size));
+	}
+	else
+	{
+		fs::path absolute_key = fs::absolute(fs::resolve_protocol(cache_key).string());
+		auto deps_absolute_key = absolute_key.string() + ".asset.deps";
+
+		std::uint64_t deps_size = 0;
+		if(!resolve_compiled(cache_key + ".asset.deps", deps_absolute_key, deps_size))
+			return false;
+
+		std::ifstream stream{deps_absolute_key, std::ios::in};
+		if(!stream.good())
+			return false;
+
+		text.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+
+	std::istringstream lines(text);
+	std::string line;
+	while(std::getline(lines, line))
+	{
+		while(!line.empty() && (line.back() == '\r' || line.back() == '\n'))
+			line.pop_back();
+
+		if(!line.empty())
+			out_dependencies.push_back(line);
+	}
+
+	return !out_dependencies.empty();
+}
 
 template <>
 bool load_from_file<gfx::texture>(core::task_future<asset_handle<gfx::texture>>& output,
@@ -50,11 +272,37 @@ bool load_from_file<gfx::texture>(core::task_future<asset_handle<gfx::texture>>&
 	}
 
     auto cache_key = fs::replace(key, ":/data", ":/cache");
+
+	// A mounted pack serves the bytes as a slice into its mapping; bgfx
+	// references them without copying and the pack outlives the asset.
+	asset_pack::slice packed;
+	if(find_packed(cache_key + ".asset", packed) && packed.size > 0)
+	{
+		auto create_resource_from_pack = [ result = original, packed, key ]() mutable
+		{
+			const gfx::memory_view* mem =
+				gfx::make_ref(packed.data, static_cast<std::uint32_t>(packed.size));
+
+			if(nullptr != mem)
+			{
+				auto tex = std::make_shared<gfx::texture>(mem, 0, 0, nullptr);
+				result.link->id = key;
+				result.link->asset = tex;
+				notify_texture_loaded(key, *tex);
+			}
+
+			return result;
+		};
+
+		output = ts.push_or_execute_on_owner_thread(create_resource_from_pack);
+		return true;
+	}
+
 	fs::path absolute_key = fs::absolute(fs::resolve_protocol(cache_key).string());
 	auto compiled_absolute_key = absolute_key.string() + ".asset";
 
-	fs::error_code err;
-	if(!fs::exists(compiled_absolute_key, err))
+	std::uint64_t read_size_hint = 0;
+	if(!resolve_compiled(cache_key + ".asset", compiled_absolute_key, read_size_hint))
 	{
         APPLOG_ERROR("Asset with key {0} and absolute_path {1} does not exist!", key, compiled_absolute_key);
 		output = ts.push_or_execute_on_worker_thread(create_resource_func_fallback);
@@ -62,15 +310,6 @@ bool load_from_file<gfx::texture>(core::task_future<asset_handle<gfx::texture>>&
 	}
 
 	auto read_memory = std::make_shared<fs::byte_array_t>();
-	auto read_memory_func = [read_memory, compiled_absolute_key]() {
-		if(!read_memory)
-			return false;
-
-		auto stream = std::ifstream{compiled_absolute_key, std::ios::in | std::ios::binary};
-		*read_memory = fs::read_stream(stream);
-
-		return true;
-	};
 
 	auto create_resource_func = [ result = original, read_memory, key ](bool read_result) mutable
 	{
@@ -81,6 +320,19 @@ bool load_from_file<gfx::texture>(core::task_future<asset_handle<gfx::texture>>&
 		if(read_memory->empty())
 			return result;
 
+		// A hot reload whose dimensions, format and mip layout are
+		// unchanged uploads into the live handle - everything referencing
+		// the texture keeps its handle and the cost is one upload.
+		auto existing = result.link->asset;
+		if(existing &&
+		   existing->update(read_memory->data(), static_cast<std::uint32_t>(read_memory->size())))
+		{
+			result.link->id = key;
+			read_memory->clear();
+			read_memory.reset();
+			return result;
+		}
+
 		const gfx::memory_view* mem =
 			gfx::copy(read_memory->data(), static_cast<std::uint32_t>(read_memory->size()));
 
@@ -92,13 +344,79 @@ bool load_from_file<gfx::texture>(core::task_future<asset_handle<gfx::texture>>&
 			auto tex = std::make_shared<gfx::texture>(mem, 0, 0, nullptr);
 			result.link->id = key;
 			result.link->asset = tex;
+			notify_texture_loaded(key, *tex);
 		}
 
 		return result;
 	};
 
-	auto ready_memory_task = ts.push_on_worker_thread(read_memory_func);
-	output = ts.push_on_owner_thread(create_resource_func, ready_memory_task);
+	// The editor writes a low-mip proxy next to the compiled chain. When
+	// it is present the handle resolves from the proxy after a tiny read,
+	// and the full chain streams in at background priority and swaps into
+	// the shared link once created, so every holder upgrades in place.
+	auto lomip_absolute_key = compiled_absolute_key + ".lomip";
+	std::uint64_t lomip_size_hint = 0;
+	if(resolve_compiled(cache_key + ".asset.lomip", lomip_absolute_key, lomip_size_hint))
+	{
+		auto lomip_memory = std::make_shared<fs::byte_array_t>();
+
+		auto create_lomip_func = [ result = original, lomip_memory, key ](bool read_result) mutable
+		{
+			// if someone destroyed our memory
+			if(!lomip_memory)
+				return result;
+			// if nothing was read
+			if(lomip_memory->empty())
+				return result;
+
+			// When the resident texture is still the proxy from a previous
+			// load, a matching new proxy updates it in place.
+			auto existing = result.link->asset;
+			if(existing &&
+			   existing->update(lomip_memory->data(), static_cast<std::uint32_t>(lomip_memory->size())))
+			{
+				result.link->id = key;
+				lomip_memory->clear();
+				lomip_memory.reset();
+				return result;
+			}
+
+			const gfx::memory_view* mem =
+				gfx::copy(lomip_memory->data(), static_cast<std::uint32_t>(lomip_memory->size()));
+
+			lomip_memory->clear();
+			lomip_memory.reset();
+
+			if(nullptr != mem)
+			{
+				auto tex = std::make_shared<gfx::texture>(mem, 0, 0, nullptr);
+				result.link->id = key;
+				result.link->asset = tex;
+				notify_texture_loaded(key, *tex);
+			}
+
+			return result;
+		};
+
+		auto ready_lomip_task =
+			dispatch_read_bytes(key, lomip_size_hint, lomip_absolute_key, lomip_memory);
+		output = dispatch_gpu_create<gfx::texture>(key, lomip_size_hint, create_lomip_func, ready_lomip_task);
+
+		// The full chain can never block a waiting load - the handle is
+		// already served by the proxy - so it always queues at background
+		// priority behind everything someone is actually waiting on.
+		if(core::has_subsystems<load_queue>())
+			core::get_subsystem<load_queue>().set_request_priority(key, load_priority::low);
+
+		auto ready_memory_task =
+			dispatch_read_bytes(key, read_size_hint, compiled_absolute_key, read_memory);
+		dispatch_gpu_create<gfx::texture>(key, read_size_hint, create_resource_func, ready_memory_task);
+		return true;
+	}
+
+	auto ready_memory_task =
+			dispatch_read_bytes(key, read_size_hint, compiled_absolute_key, read_memory);
+	output = dispatch_gpu_create<gfx::texture>(key, read_size_hint, create_resource_func, ready_memory_task);
 	return true;
 }
 
@@ -126,13 +444,36 @@ bool load_from_file<gfx::shader>(core::task_future<asset_handle<gfx::shader>>& o
 	}
     
 	auto cache_key = fs::replace(key, ":/data", ":/cache");
-    
-    fs::path absolute_key = fs::absolute(fs::resolve_protocol(cache_key).string());
 	const auto& renderer_extension = gfx::get_renderer_filename_extension();
+
+	// Shaders are compiled per renderer back end; the pack is keyed on the
+	// same decorated name the loose cache uses.
+	asset_pack::slice packed;
+	if(find_packed(cache_key + renderer_extension + ".asset", packed) && packed.size > 0)
+	{
+		auto create_resource_from_pack = [ result = original, packed, key ]() mutable
+		{
+			const gfx::memory_view* mem =
+				gfx::make_ref(packed.data, static_cast<std::uint32_t>(packed.size));
+
+			if(nullptr != mem)
+			{
+				result.link->id = key;
+				result.link->asset = std::make_shared<gfx::shader>(mem);
+			}
+
+			return result;
+		};
+
+		output = ts.push_or_execute_on_owner_thread(create_resource_from_pack);
+		return true;
+	}
+
+    fs::path absolute_key = fs::absolute(fs::resolve_protocol(cache_key).string());
 	auto compiled_absolute_key = absolute_key.string() + renderer_extension + ".asset";
 
-	fs::error_code err;
-	if(!fs::exists(compiled_absolute_key, err))
+	std::uint64_t read_size_hint = 0;
+	if(!resolve_compiled(cache_key + renderer_extension + ".asset", compiled_absolute_key, read_size_hint))
 	{
 		APPLOG_ERROR("Asset with key {0} and absolute_path {1} does not exist!", key, compiled_absolute_key);
 		output = ts.push_or_execute_on_worker_thread(create_resource_func_fallback);
@@ -141,16 +482,6 @@ bool load_from_file<gfx::shader>(core::task_future<asset_handle<gfx::shader>>& o
 
 	auto read_memory = std::make_shared<fs::byte_array_t>();
 
-	auto read_memory_func = [read_memory, compiled_absolute_key]() {
-		if(!read_memory)
-			return false;
-
-		auto stream = std::ifstream{compiled_absolute_key, std::ios::in | std::ios::binary};
-		*read_memory = fs::read_stream(stream);
-
-		return true;
-	};
-
 	auto create_resource_func = [ result = original, read_memory, key ](bool read_result) mutable
 	{
 		// if someone destroyed our memory
@@ -174,8 +505,9 @@ bool load_from_file<gfx::shader>(core::task_future<asset_handle<gfx::shader>>& o
 		return result;
 	};
 
-	auto ready_memory_task = ts.push_on_worker_thread(read_memory_func);
-	output = ts.push_on_owner_thread(create_resource_func, ready_memory_task);
+	auto ready_memory_task =
+		dispatch_read_bytes(key, read_size_hint, compiled_absolute_key, read_memory);
+	output = dispatch_gpu_create<gfx::shader>(key, read_size_hint, create_resource_func, ready_memory_task);
 	return true;
 }
 
@@ -206,8 +538,11 @@ bool load_from_file<mesh>(core::task_future<asset_handle<mesh>>& output, const s
 
 	auto compiled_absolute_key = absolute_key.string() + ".asset";
 
-	fs::error_code err;
-	if(!fs::exists(compiled_absolute_key, err))
+	asset_pack::slice packed;
+	const bool is_packed = find_packed(cache_key + ".asset", packed) && packed.size > 0;
+
+	std::uint64_t read_size_hint = packed.size;
+	if(!is_packed && !resolve_compiled(cache_key + ".asset", compiled_absolute_key, read_size_hint))
 	{
         APPLOG_ERROR("Asset with key {0} and absolute_path {1} does not exist!", key, compiled_absolute_key);
 		output = ts.push_or_execute_on_worker_thread(create_resource_func_fallback);
@@ -220,22 +555,57 @@ bool load_from_file<mesh>(core::task_future<asset_handle<mesh>>& output, const s
 	};
 
 	auto wrapper = std::make_shared<wrapper_t>();
-	auto read_memory_func = [wrapper, compiled_absolute_key]() mutable {
+	auto read_memory_func = [wrapper, packed, is_packed, compiled_absolute_key]() mutable {
+		// Compiled meshes without skinning data arrive in the layout-final
+		// runtime container. Those are bound with zero copies - the mesh
+		// renders straight out of the pack or file mapping. Anything else
+		// falls back to the cereal archive below.
+		if(is_packed)
+		{
+			if(mesh::is_prepared_format(packed.data, static_cast<std::size_t>(packed.size)))
+			{
+				// The pack mapping is owned by the subsystem and outlives
+				// the mesh, so no backing reference is required.
+				return wrapper->mesh->bind_prepared(nullptr, packed.data,
+													static_cast<std::size_t>(packed.size));
+			}
+		}
+		else
+		{
+			auto mapping = std::make_shared<fs::memory_mapped_file>();
+			if(mapping->open(compiled_absolute_key) &&
+			   mesh::is_prepared_format(mapping->data(), static_cast<std::size_t>(mapping->size())))
+			{
+				return wrapper->mesh->bind_prepared(mapping, mapping->data(),
+													static_cast<std::size_t>(mapping->size()));
+			}
+		}
+
 		mesh::load_data data;
+		if(is_packed)
+		{
+			serialization::memory_input_archive ar(packed.data, static_cast<std::size_t>(packed.size));
+
+			try_load(ar, cereal::make_nvp("mesh", data));
+		}
+		else
 		{
-			std::ifstream stream{compiled_absolute_key, std::ios::in | std::ios::binary};
+			auto mem = fs::read_async(compiled_absolute_key).get();
 
-			if(stream.bad())
+			if(mem.empty())
 			{
 				return false;
 			}
 
-			cereal::iarchive_binary_t ar(stream);
+			serialization::memory_input_archive ar(mem.data(), mem.size());
 
 			try_load(ar, cereal::make_nvp("mesh", data));
 		}
-		wrapper->mesh->prepare_mesh(data.vertex_format);
-		wrapper->mesh->set_vertex_source(&data.vertex_data[0], data.vertex_count, data.vertex_format);
+		// resolve the deserialized layout against the canonical registry
+		// so identical layouts across meshes share one instance
+		const auto& vertex_format = gfx::get_canonical_layout(data.vertex_format);
+		wrapper->mesh->prepare_mesh(vertex_format);
+		wrapper->mesh->set_vertex_source(&data.vertex_data[0], data.vertex_count, vertex_format);
 		wrapper->mesh->add_primitives(data.triangle_data);
 		wrapper->mesh->set_subset_count(data.material_count);
 		wrapper->mesh->bind_skin(data.skin_data);
@@ -264,8 +634,8 @@ bool load_from_file<mesh>(core::task_future<asset_handle<mesh>>& output, const s
 		return result;
 	};
 
-	auto ready_memory_task = ts.push_on_worker_thread(read_memory_func);
-	output = ts.push_on_owner_thread(create_resource_func, ready_memory_task);
+	auto ready_memory_task = dispatch_read(key, read_size_hint, read_memory_func);
+	output = dispatch_gpu_create<mesh>(key, read_size_hint, create_resource_func, ready_memory_task);
 	return true;
 }
 
@@ -297,8 +667,11 @@ bool load_from_file<audio::sound>(core::task_future<asset_handle<audio::sound>>&
 
 	auto compiled_absolute_key = absolute_key.string() + ".asset";
 
-	fs::error_code err;
-	if(!fs::exists(compiled_absolute_key, err))
+	asset_pack::slice packed;
+	const bool is_packed = find_packed(cache_key + ".asset", packed) && packed.size > 0;
+
+	std::uint64_t read_size_hint = packed.size;
+	if(!is_packed && !resolve_compiled(cache_key + ".asset", compiled_absolute_key, read_size_hint))
 	{
         APPLOG_ERROR("Asset with key {0} and absolute_path {1} does not exist!", key, compiled_absolute_key);
 		output = ts.push_or_execute_on_worker_thread(create_resource_func_fallback);
@@ -311,16 +684,23 @@ bool load_from_file<audio::sound>(core::task_future<asset_handle<audio::sound>>&
 	};
 
 	auto wrapper = std::make_shared<wrapper_t>();
-	auto read_memory_func = [wrapper, compiled_absolute_key]() mutable {
+	auto read_memory_func = [wrapper, packed, is_packed, compiled_absolute_key]() mutable {
+		if(is_packed)
+		{
+			serialization::memory_input_archive ar(packed.data, static_cast<std::size_t>(packed.size));
+
+			try_load(ar, cereal::make_nvp("sound", wrapper->data));
+		}
+		else
 		{
-			std::ifstream stream{compiled_absolute_key, std::ios::in | std::ios::binary};
+			auto mem = fs::read_async(compiled_absolute_key).get();
 
-			if(stream.bad())
+			if(mem.empty())
 			{
 				return false;
 			}
 
-			cereal::iarchive_binary_t ar(stream);
+			serialization::memory_input_archive ar(mem.data(), mem.size());
 
 			try_load(ar, cereal::make_nvp("sound", wrapper->data));
 		}
@@ -331,7 +711,7 @@ bool load_from_file<audio::sound>(core::task_future<asset_handle<audio::sound>>&
 	{
 		if(read_result)
 		{
-			if(!wrapper->data.data.empty())
+			if(!wrapper->data.data.empty() || !wrapper->data.encoded_data.empty())
 			{
 				result.link->id = key;
 				result.link->asset = std::make_shared<audio::sound>(std::move(wrapper->data));
@@ -342,7 +722,7 @@ bool load_from_file<audio::sound>(core::task_future<asset_handle<audio::sound>>&
 		return result;
 	};
 
-	auto ready_memory_task = ts.push_on_worker_thread(read_memory_func);
+	auto ready_memory_task = dispatch_read(key, read_size_hint, read_memory_func);
 	output = ts.push_on_owner_thread(create_resource_func, ready_memory_task);
 	return true;
 }
@@ -375,8 +755,11 @@ bool load_from_file<runtime::animation>(core::task_future<asset_handle<runtime::
 
 	auto compiled_absolute_key = absolute_key.string() + ".asset";
 
-	fs::error_code err;
-	if(!fs::exists(compiled_absolute_key, err))
+	asset_pack::slice packed;
+	const bool is_packed = find_packed(cache_key + ".asset", packed) && packed.size > 0;
+
+	std::uint64_t read_size_hint = packed.size;
+	if(!is_packed && !resolve_compiled(cache_key + ".asset", compiled_absolute_key, read_size_hint))
 	{
         APPLOG_ERROR("Asset with key {0} and absolute_path {1} does not exist!", key, compiled_absolute_key);
 		output = ts.push_or_execute_on_worker_thread(create_resource_func_fallback);
@@ -389,17 +772,24 @@ bool load_from_file<runtime::animation>(core::task_future<asset_handle<runtime::
 	};
 
 	auto wrapper = std::make_shared<wrapper_t>();
-	auto read_memory_func = [wrapper, compiled_absolute_key]() mutable {
+	auto read_memory_func = [wrapper, packed, is_packed, compiled_absolute_key]() mutable {
 		auto& data = *wrapper->anim.get();
+		if(is_packed)
 		{
-			std::ifstream stream{compiled_absolute_key, std::ios::in | std::ios::binary};
+			serialization::memory_input_archive ar(packed.data, static_cast<std::size_t>(packed.size));
 
-			if(stream.bad())
+			try_load(ar, cereal::make_nvp("animation", data));
+		}
+		else
+		{
+			auto mem = fs::read_async(compiled_absolute_key).get();
+
+			if(mem.empty())
 			{
 				return false;
 			}
 
-			cereal::iarchive_binary_t ar(stream);
+			serialization::memory_input_archive ar(mem.data(), mem.size());
 
 			try_load(ar, cereal::make_nvp("animation", data));
 		}
@@ -421,7 +811,7 @@ bool load_from_file<runtime::animation>(core::task_future<asset_handle<runtime::
 		return result;
 	};
 
-	auto ready_memory_task = ts.push_on_worker_thread(read_memory_func);
+	auto ready_memory_task = dispatch_read(key, read_size_hint, read_memory_func);
 	output = ts.push_on_owner_thread(create_resource_func, ready_memory_task);
 	return true;
 }
@@ -453,8 +843,11 @@ bool load_from_file<material>(core::task_future<asset_handle<material>>& output,
 
 	auto compiled_absolute_key = absolute_key.string() + ".asset";
 
-	fs::error_code err;
-	if(!fs::exists(compiled_absolute_key, err))
+	asset_pack::slice packed;
+	const bool is_packed = find_packed(cache_key + ".asset", packed) && packed.size > 0;
+
+	std::uint64_t read_size_hint = packed.size;
+	if(!is_packed && !resolve_compiled(cache_key + ".asset", compiled_absolute_key, read_size_hint))
 	{
         APPLOG_ERROR("Asset with key {0} and absolute_path {1} does not exist!", key, compiled_absolute_key);
 		output = ts.push_or_execute_on_worker_thread(create_resource_func_fallback);
@@ -468,14 +861,23 @@ bool load_from_file<material>(core::task_future<asset_handle<material>>& output,
 
 	auto wrapper = std::make_shared<wrapper_t>();
 
-	auto read_memory_func = [wrapper, compiled_absolute_key]() mutable {
-		std::ifstream stream{compiled_absolute_key, std::ios::in | std::ios::binary};
+	auto read_memory_func = [wrapper, packed, is_packed, compiled_absolute_key]() mutable {
+		if(is_packed)
+		{
+			serialization::memory_input_archive ar(packed.data, static_cast<std::size_t>(packed.size));
+
+			try_load(ar, cereal::make_nvp("material", wrapper->material));
+
+			return true;
+		}
+
+		auto mem = fs::read_async(compiled_absolute_key).get();
 
-		if(stream.bad())
+		if(mem.empty())
 		{
 			return false;
 		}
-		cereal::iarchive_binary_t ar(stream);
+		serialization::memory_input_archive ar(mem.data(), mem.size());
 
 		try_load(ar, cereal::make_nvp("material", wrapper->material));
 
@@ -491,7 +893,7 @@ bool load_from_file<material>(core::task_future<asset_handle<material>>& output,
 		return result;
 	};
 
-	auto ready_memory_task = ts.push_on_worker_thread(read_memory_func);
+	auto ready_memory_task = dispatch_read(key, read_size_hint, read_memory_func);
 	output = ts.push_on_owner_thread(create_resource_func, ready_memory_task);
 	return true;
 }
@@ -523,8 +925,11 @@ bool load_from_file<prefab>(core::task_future<asset_handle<prefab>>& output, con
 
 	auto compiled_absolute_key = absolute_key.string() + ".asset";
 
-	fs::error_code err;
-	if(!fs::exists(compiled_absolute_key, err))
+	asset_pack::slice packed;
+	const bool is_packed = find_packed(cache_key + ".asset", packed) && packed.size > 0;
+
+	std::uint64_t read_size_hint = packed.size;
+	if(!is_packed && !resolve_compiled(cache_key + ".asset", compiled_absolute_key, read_size_hint))
 	{
         APPLOG_ERROR("Asset with key {0} and absolute_path {1} does not exist!", key, compiled_absolute_key);
 		output = ts.push_or_execute_on_worker_thread(create_resource_func_fallback);
@@ -533,13 +938,18 @@ bool load_from_file<prefab>(core::task_future<asset_handle<prefab>>& output, con
 
 	std::shared_ptr<std::istringstream> read_memory = std::make_shared<std::istringstream>();
 
-	auto read_memory_func = [read_memory, compiled_absolute_key]() {
+	auto read_memory_func = [read_memory, packed, is_packed, compiled_absolute_key]() {
 		if(!read_memory)
 			return false;
 
-		auto stream =
-			std::fstream{compiled_absolute_key, std::fstream::in | std::fstream::out | std::ios::binary};
-		auto mem = fs::read_stream(stream);
+		if(is_packed)
+		{
+			*read_memory = std::istringstream(
+				std::string(reinterpret_cast<const char*>(packed.data), packed.size));
+			return true;
+		}
+
+		auto mem = fs::read_async(compiled_absolute_key).get();
 		*read_memory = std::istringstream(std::string(mem.begin(), mem.end()));
 
 		return true;
@@ -559,7 +969,7 @@ bool load_from_file<prefab>(core::task_future<asset_handle<prefab>>& output, con
 		return result;
 	};
 
-	auto ready_memory_task = ts.push_on_worker_thread(read_memory_func);
+	auto ready_memory_task = dispatch_read(key, read_size_hint, read_memory_func);
 	output = ts.push_on_owner_thread(create_resource_func, ready_memory_task);
 	return true;
 }
@@ -591,8 +1001,11 @@ bool load_from_file<scene>(core::task_future<asset_handle<scene>>& output, const
 
 	auto compiled_absolute_key = absolute_key.string() + ".asset";
 
-	fs::error_code err;
-	if(!fs::exists(compiled_absolute_key, err))
+	asset_pack::slice packed;
+	const bool is_packed = find_packed(cache_key + ".asset", packed) && packed.size > 0;
+
+	std::uint64_t read_size_hint = packed.size;
+	if(!is_packed && !resolve_compiled(cache_key + ".asset", compiled_absolute_key, read_size_hint))
 	{
         APPLOG_ERROR("Asset with key {0} and absolute_path {1} does not exist!", key, compiled_absolute_key);
 		output = ts.push_or_execute_on_worker_thread(create_resource_func_fallback);
@@ -601,13 +1014,18 @@ bool load_from_file<scene>(core::task_future<asset_handle<scene>>& output, const
 
 	std::shared_ptr<std::istringstream> read_memory = std::make_shared<std::istringstream>();
 
-	auto read_memory_func = [read_memory, compiled_absolute_key]() {
+	auto read_memory_func = [read_memory, packed, is_packed, compiled_absolute_key]() {
 		if(!read_memory)
 			return false;
 
-		auto stream =
-			std::fstream{compiled_absolute_key, std::fstream::in | std::fstream::out | std::ios::binary};
-		auto mem = fs::read_stream(stream);
+		if(is_packed)
+		{
+			*read_memory = std::istringstream(
+				std::string(reinterpret_cast<const char*>(packed.data), packed.size));
+			return true;
+		}
+
+		auto mem = fs::read_async(compiled_absolute_key).get();
 		*read_memory = std::istringstream(std::string(mem.begin(), mem.end()));
 
 		return true;
@@ -627,7 +1045,7 @@ bool load_from_file<scene>(core::task_future<asset_handle<scene>>& output, const
 		return result;
 	};
 
-	auto ready_memory_task = ts.push_on_worker_thread(read_memory_func);
+	auto ready_memory_task = dispatch_read(key, read_size_hint, read_memory_func);
 	output = ts.push_on_owner_thread(create_resource_func, ready_memory_task);
 	return true;
 }
@@ -3,6 +3,7 @@
 #include "core/filesystem/filesystem.h"
 #include "core/system/subsystem.h"
 #include "core/tasks/task_system.h"
+#include <vector>
 
 namespace runtime
 {
@@ -29,5 +30,15 @@ inline bool load_from_instance(core::task_future<asset_handle<T>>& output, const
 
 	return true;
 }
+
+//-----------------------------------------------------------------------------
+//  Name : read_dependencies ()
+/// <summary>
+/// Reads the dependency list the compiler recorded next to the compiled
+/// asset ('<cache key>.asset.deps'), from the mounted pack or the loose
+/// cache. Returns false when no list was recorded.
+/// </summary>
+//-----------------------------------------------------------------------------
+bool read_dependencies(const std::string& key, std::vector<std::string>& out_dependencies);
 }
 }
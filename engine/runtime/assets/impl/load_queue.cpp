@@ -0,0 +1,184 @@
+#include "load_queue.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace runtime
+{
+
+load_queue::load_queue()
+	: _thread([this]() { run(); })
+{
+}
+
+load_queue::~load_queue()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_done = true;
+
+		// Complete whatever is still pending so nobody waits on a future
+		// that will never be fulfilled. The loaders treat 'false' as a
+		// failed read and fall back to an empty handle.
+		for(auto& queue : _queues)
+		{
+			for(auto& pending : queue)
+				pending.promise->set_value(false);
+			queue.clear();
+		}
+	}
+	_cv.notify_all();
+
+	if(_thread.joinable())
+		_thread.join();
+}
+
+core::task_future<bool> load_queue::enqueue(const std::string& key, std::uint64_t size_hint,
+											std::function<bool()> io_func)
+{
+	job new_job;
+	new_job.key = key;
+	new_job.size_hint = size_hint;
+	new_job.io_func = std::move(io_func);
+	new_job.promise = std::make_shared<std::promise<bool>>();
+
+	auto future = core::task_future<bool>::from_shared_future(new_job.promise->get_future().share());
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		auto it = _requested.find(key);
+		if(it != _requested.end())
+		{
+			new_job.priority = it->second;
+			_requested.erase(it);
+		}
+
+		_queues[static_cast<std::size_t>(new_job.priority)].push_back(std::move(new_job));
+	}
+	_cv.notify_one();
+
+	return future;
+}
+
+void load_queue::set_request_priority(const std::string& key, load_priority priority)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_requested[key] = priority;
+}
+
+void load_queue::prioritize(const std::string& key, load_priority priority)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	const auto target = static_cast<std::size_t>(priority);
+	for(std::size_t i = 0; i < target; ++i)
+	{
+		auto& queue = _queues[i];
+		auto it = std::find_if(queue.begin(), queue.end(),
+							   [&key](const job& pending) { return pending.key == key; });
+		if(it == queue.end())
+			continue;
+
+		job promoted = std::move(*it);
+		queue.erase(it);
+		promoted.priority = priority;
+		_queues[target].push_back(std::move(promoted));
+		return;
+	}
+}
+
+void load_queue::set_bandwidth_budget(std::uint64_t bytes_per_second)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_bytes_per_second = bytes_per_second;
+}
+
+std::uint64_t load_queue::get_bandwidth_budget() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _bytes_per_second;
+}
+
+std::size_t load_queue::get_pending_count() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _queues[0].size() + _queues[1].size() + _queues[2].size();
+}
+
+bool load_queue::pop_job(job& out_job)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_cv.wait(lock, [this]() {
+		if(_done)
+			return true;
+
+		for(const auto& queue : _queues)
+		{
+			if(!queue.empty())
+				return true;
+		}
+		return false;
+	});
+
+	if(_done)
+		return false;
+
+	// Drain strictly high to low; within a class jobs keep request order.
+	for(std::size_t i = 3; i > 0; --i)
+	{
+		auto& queue = _queues[i - 1];
+		if(queue.empty())
+			continue;
+
+		out_job = std::move(queue.front());
+		queue.pop_front();
+		return true;
+	}
+	return false;
+}
+
+void load_queue::run()
+{
+	using clock_t = std::chrono::steady_clock;
+
+	auto last_refill = clock_t::now();
+	double allowance = 0.0;
+
+	job current;
+	while(pop_job(current))
+	{
+		const auto budget = get_bandwidth_budget();
+
+		// Token bucket: the allowance refills at the budget rate and may
+		// burst up to one second's worth. High priority jobs bypass the
+		// throttle entirely - they are what someone is waiting on.
+		if(budget != 0 && current.priority != load_priority::high)
+		{
+			const auto now = clock_t::now();
+			const auto elapsed = std::chrono::duration<double>(now - last_refill).count();
+			last_refill = now;
+			allowance = std::min(allowance + elapsed * static_cast<double>(budget),
+								 static_cast<double>(budget));
+
+			if(allowance < static_cast<double>(current.size_hint))
+			{
+				// Sleep until enough budget accumulated, capped so a huge
+				// single asset cannot stall the queue indefinitely.
+				const double deficit = static_cast<double>(current.size_hint) - allowance;
+				const double wait_seconds = std::min(deficit / static_cast<double>(budget), 0.25);
+				std::this_thread::sleep_for(std::chrono::duration<double>(wait_seconds));
+				last_refill = clock_t::now();
+			}
+			allowance = std::max(allowance - static_cast<double>(current.size_hint), 0.0);
+		}
+
+		bool result = false;
+		if(current.io_func)
+			result = current.io_func();
+
+		current.promise->set_value(result);
+		current = job();
+	}
+}
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "../asset_flags.h"
+#include "core/tasks/task_system.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace runtime
+{
+//-----------------------------------------------------------------------------
+//  Name : load_queue (Class)
+/// <summary>
+/// Prioritized queue for the IO portion of asset loads. Jobs are drained
+/// by a dedicated IO thread in strict priority order, throttled by a
+/// bytes-per-second budget so background prefetches cannot monopolize the
+/// disk. Pending jobs can be re-prioritized while they sit in the queue -
+/// a request that becomes urgent (a synchronous load, or a handle the
+/// render path is waiting on) jumps ahead of everything less important.
+/// </summary>
+//-----------------------------------------------------------------------------
+class load_queue
+{
+public:
+	load_queue();
+	~load_queue();
+
+	//-----------------------------------------------------------------------------
+	//  Name : enqueue ()
+	/// <summary>
+	/// Queues an IO function for execution on the IO thread. 'size_hint'
+	/// is the expected number of bytes the function will read and feeds
+	/// the bandwidth budget. The returned future becomes ready when the
+	/// function has run. The job is queued under the priority recorded
+	/// for the key via 'set_request_priority', or 'normal' otherwise.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	core::task_future<bool> enqueue(const std::string& key, std::uint64_t size_hint,
+									std::function<bool()> io_func);
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_request_priority ()
+	/// <summary>
+	/// Records the priority the next 'enqueue' of this key should use.
+	/// Called by the asset manager before dispatching a new load request.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_request_priority(const std::string& key, load_priority priority);
+
+	//-----------------------------------------------------------------------------
+	//  Name : prioritize ()
+	/// <summary>
+	/// Promotes a job that is still waiting in the queue to the given
+	/// priority class. Demotions and jobs already being processed are
+	/// ignored.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void prioritize(const std::string& key, load_priority priority);
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_bandwidth_budget ()
+	/// <summary>
+	/// Sets the IO budget in bytes per second. Zero disables throttling.
+	/// High priority jobs always bypass the budget.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_bandwidth_budget(std::uint64_t bytes_per_second);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_bandwidth_budget ()
+	/// <summary>
+	/// Current IO budget in bytes per second.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::uint64_t get_bandwidth_budget() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_pending_count ()
+	/// <summary>
+	/// Number of IO jobs waiting in the queue, for stats display.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t get_pending_count() const;
+
+private:
+	struct job
+	{
+		/// Asset key, used for re-prioritization lookups.
+		std::string key;
+		/// Expected bytes read; feeds the bandwidth budget.
+		std::uint64_t size_hint = 0;
+		/// Priority class the job was queued (or promoted) under.
+		load_priority priority = load_priority::normal;
+		/// The IO work itself.
+		std::function<bool()> io_func;
+		/// Fulfilled with the io_func result once it has run.
+		std::shared_ptr<std::promise<bool>> promise;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : pop_job () (Private)
+	/// <summary>
+	/// Blocks until a job is available or the queue is shut down. Returns
+	/// false on shutdown.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool pop_job(job& out_job);
+
+	//-----------------------------------------------------------------------------
+	//  Name : run () (Private)
+	/// <summary>
+	/// IO thread main loop - drains jobs in priority order under the
+	/// bandwidth budget.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void run();
+
+	/// Guards the queues and the recorded request priorities.
+	mutable std::mutex _mutex;
+	/// Signals the IO thread when work arrives or shutdown is requested.
+	std::condition_variable _cv;
+	/// One FIFO per priority class, drained high to low.
+	std::deque<job> _queues[3];
+	/// Priorities recorded by the asset manager, consumed on enqueue.
+	std::map<std::string, load_priority> _requested;
+	/// IO budget in bytes per second; zero disables throttling.
+	std::uint64_t _bytes_per_second = 128 * 1024 * 1024;
+	/// Shutdown flag for the IO thread.
+	bool _done = false;
+	/// Dedicated IO thread. Last member so it starts fully initialized.
+	std::thread _thread;
+};
+}
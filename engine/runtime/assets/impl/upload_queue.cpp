@@ -0,0 +1,100 @@
+#include "upload_queue.h"
+
+#include <cassert>
+#include <utility>
+
+namespace runtime
+{
+upload_queue::upload_queue()
+	: _upload_thread(std::this_thread::get_id())
+{
+}
+
+void upload_queue::enqueue(const std::string& key, std::uint64_t bytes, upload_func_t upload)
+{
+	if(!upload)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_queue.emplace_back(job{key, bytes, std::move(upload)});
+}
+
+void upload_queue::drain()
+{
+	assert(can_upload_on_this_thread());
+
+	std::uint64_t bytes_budget = 0;
+	std::chrono::microseconds time_budget(0);
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		bytes_budget = _bytes_per_frame;
+		time_budget = _time_per_frame;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	std::uint64_t bytes_done = 0;
+
+	job current;
+	while(pop(current))
+	{
+		current.upload();
+		bytes_done += current.bytes;
+
+		if(bytes_budget != 0 && bytes_done >= bytes_budget)
+		{
+			break;
+		}
+		if(time_budget.count() != 0 && std::chrono::steady_clock::now() - start >= time_budget)
+		{
+			break;
+		}
+	}
+}
+
+bool upload_queue::drain_one()
+{
+	assert(can_upload_on_this_thread());
+
+	job current;
+	if(!pop(current))
+	{
+		return false;
+	}
+
+	current.upload();
+	return true;
+}
+
+bool upload_queue::can_upload_on_this_thread() const
+{
+	return std::this_thread::get_id() == _upload_thread;
+}
+
+void upload_queue::set_budget(std::uint64_t bytes_per_frame, std::chrono::microseconds time_per_frame)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_bytes_per_frame = bytes_per_frame;
+	_time_per_frame = time_per_frame;
+}
+
+std::size_t upload_queue::get_pending_count() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _queue.size();
+}
+
+bool upload_queue::pop(job& out_job)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if(_queue.empty())
+	{
+		return false;
+	}
+
+	out_job = std::move(_queue.front());
+	_queue.pop_front();
+	return true;
+}
+}
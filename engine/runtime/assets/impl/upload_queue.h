@@ -0,0 +1,157 @@
+#pragma once
+
+#include "core/system/subsystem.h"
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace runtime
+{
+//-----------------------------------------------------------------------------
+//  Name : upload_queue (Class)
+/// <summary>
+/// Staging queue for the bgfx-facing part of asset loads. Workers finish
+/// IO and decode, then enqueue a ready-to-upload job here instead of an
+/// owner-thread task; the renderer drains the queue once per frame under
+/// a byte and time budget, so streaming bursts turn into a bounded,
+/// smooth per-frame upload cost instead of completion spikes. Jobs run
+/// only on the thread the renderer was brought up on - the one bgfx
+/// accepts resource creation from.
+/// </summary>
+//-----------------------------------------------------------------------------
+class upload_queue
+{
+public:
+	using upload_func_t = std::function<void()>;
+
+	upload_queue();
+
+	//-----------------------------------------------------------------------------
+	//  Name : enqueue ()
+	/// <summary>
+	/// Queues an upload job from any thread. 'bytes' is the payload size
+	/// the job will hand to the GPU and feeds the per-frame byte budget.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void enqueue(const std::string& key, std::uint64_t bytes, upload_func_t upload);
+
+	//-----------------------------------------------------------------------------
+	//  Name : drain ()
+	/// <summary>
+	/// Runs queued jobs until the byte or time budget is spent - always at
+	/// least one so the queue never stalls. Called by the renderer once
+	/// per frame; must run on the upload thread.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void drain();
+
+	//-----------------------------------------------------------------------------
+	//  Name : drain_one ()
+	/// <summary>
+	/// Runs a single queued job, budget aside. Returns false when the
+	/// queue is empty. Used by synchronous loads waiting on the upload
+	/// thread, where a budgeted frame drain would wait on that very wait.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool drain_one();
+
+	//-----------------------------------------------------------------------------
+	//  Name : can_upload_on_this_thread ()
+	/// <summary>
+	/// True when the calling thread is the one bgfx accepts resource
+	/// creation from.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool can_upload_on_this_thread() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_budget ()
+	/// <summary>
+	/// Per-frame drain budget. Whichever of the two limits is hit first
+	/// ends the frame's drain; a zero disables that limit.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_budget(std::uint64_t bytes_per_frame, std::chrono::microseconds time_per_frame);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_pending_count ()
+	/// <summary>
+	/// Number of staged jobs waiting to upload, for stats display.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t get_pending_count() const;
+
+private:
+	struct job
+	{
+		/// Asset key, for diagnostics.
+		std::string key;
+		/// Payload size handed to the GPU; feeds the byte budget.
+		std::uint64_t bytes = 0;
+		/// The creation work itself.
+		upload_func_t upload;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : pop () (Private)
+	/// <summary>
+	/// Takes the oldest staged job. Returns false when none is queued.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool pop(job& out_job);
+
+	/// Guards the queue and the budgets.
+	mutable std::mutex _mutex;
+	/// Staged jobs in arrival order.
+	std::deque<job> _queue;
+	/// Byte budget per frame drain; zero disables the limit.
+	std::uint64_t _bytes_per_frame = 32 * 1024 * 1024;
+	/// Time budget per frame drain; zero disables the limit.
+	std::chrono::microseconds _time_per_frame = std::chrono::microseconds(3000);
+	/// The thread uploads must run on - the one this subsystem was
+	/// registered from, which is the thread that brought bgfx up.
+	std::thread::id _upload_thread;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : wait_serving_uploads ()
+/// <summary>
+/// Waits for a load future while keeping the upload queue moving when
+/// the waiter is the upload thread itself - a plain wait there would
+/// deadlock on a creation staged in the queue, since the frame drain
+/// cannot run until the wait returns. Off the upload thread it is a
+/// plain wait.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename Future>
+void wait_serving_uploads(const Future& future)
+{
+	// Task-backed futures keep their processing wait - their completions
+	// are ordinary tasks this thread can execute while waiting. Only the
+	// promise-backed ones resolve through a staged upload.
+	if(!future.is_task_backed() && core::has_subsystems<upload_queue>())
+	{
+		auto& uploads = core::get_subsystem<upload_queue>();
+		if(uploads.can_upload_on_this_thread())
+		{
+			while(!future.is_ready())
+			{
+				if(!uploads.drain_one())
+				{
+					// The creation is not staged yet - the IO feeding it
+					// is still in flight - so give it a moment.
+					future.wait_for(std::chrono::milliseconds(1));
+				}
+			}
+			return;
+		}
+	}
+
+	future.wait();
+}
+}
@@ -1,40 +1,152 @@
 #include "audio_source_component.h"
+#include "../systems/audio_system.h"
+#include "core/system/subsystem.h"
 #include <limits>
 
-void audio_source_component::update(const math::transform& t)
+void audio_source_component::update(const math::transform& t, std::chrono::duration<float> dt)
 {
-	auto pos = t.get_position();
-	auto forward = t.z_unit_axis();
-	auto up = t.y_unit_axis();
-	_source.set_position({{pos.x, pos.y, pos.z}});
-	_source.set_orientation({{forward.x, forward.y, forward.z}}, {{up.x, up.y, up.z}});
+	if(_voice)
+	{
+		auto pos = t.get_position();
+		auto forward = t.z_unit_axis();
+		auto up = t.y_unit_axis();
+		_voice->set_position({{pos.x, pos.y, pos.z}});
+		_voice->set_orientation({{forward.x, forward.y, forward.z}}, {{up.x, up.y, up.z}});
+	}
+
+	if(!_playing || _paused)
+	{
+		return;
+	}
+
+	// deliver any time owed from throttled frames in one lump
+	const auto elapsed = dt + _deferred_dt;
+	_deferred_dt = std::chrono::duration<float>(0);
+
+	if(_voice)
+	{
+		// the real voice is authoritative - mirror its progress and
+		// notice one-shots that ran out
+		_virtual_offset = _voice->get_playing_offset();
+		if(_voice->is_stopped())
+		{
+			_playing = false;
+			_virtual_offset = audio::sound_info::duration_t(0);
+		}
+	}
+	else
+	{
+		_virtual_offset += std::chrono::duration_cast<audio::sound_info::duration_t>(elapsed);
+		const auto duration = get_playing_duration();
+		if(duration.count() > 0.0 && _virtual_offset >= duration)
+		{
+			if(_loop)
+			{
+				while(_virtual_offset >= duration)
+				{
+					_virtual_offset -= duration;
+				}
+			}
+			else
+			{
+				_playing = false;
+				_virtual_offset = audio::sound_info::duration_t(0);
+			}
+		}
+	}
+}
+
+void audio_source_component::defer_update(std::chrono::duration<float> dt)
+{
+	_deferred_dt += dt;
+}
+
+bool audio_source_component::is_active() const
+{
+	return _playing && !_paused && is_sound_valid();
+}
+
+bool audio_source_component::has_voice() const
+{
+	return _voice != nullptr;
+}
+
+void audio_source_component::promote_voice(std::shared_ptr<audio::source> voice)
+{
+	if(!voice || _voice || !is_sound_valid())
+	{
+		return;
+	}
+
+	_voice = std::move(voice);
+	_voice->bind(*_sound.get());
+	apply_voice_properties();
+	_voice->set_playing_offset(_virtual_offset);
+	if(_playing && !_paused)
+	{
+		_voice->play();
+	}
+}
+
+std::shared_ptr<audio::source> audio_source_component::demote_voice()
+{
+	if(!_voice)
+	{
+		return nullptr;
+	}
+
+	if(_playing)
+	{
+		_virtual_offset = _voice->get_playing_offset();
+		if(_voice->is_stopped() && !_paused)
+		{
+			_playing = false;
+			_virtual_offset = audio::sound_info::duration_t(0);
+		}
+	}
+
+	auto voice = std::move(_voice);
+	voice->stop();
+	return voice;
 }
 
 void audio_source_component::set_loop(bool on)
 {
 	_loop = on;
-	_source.set_loop(on);
+	if(_voice)
+	{
+		_voice->set_loop(on);
+	}
 }
 
 void audio_source_component::set_volume(float volume)
 {
 	math::clamp(volume, 0.0f, 1.0f);
 	_volume = volume;
-	_source.set_volume(volume);
+	if(_voice)
+	{
+		_voice->set_volume(volume);
+	}
 }
 
 void audio_source_component::set_pitch(float pitch)
 {
 	math::clamp(pitch, 0.5f, 2.0f);
 	_pitch = pitch;
-	_source.set_pitch(pitch);
+	if(_voice)
+	{
+		_voice->set_pitch(pitch);
+	}
 }
 
 void audio_source_component::set_volume_rolloff(float rolloff)
 {
 	math::clamp(rolloff, 0.0f, 10.0f);
 	_volume_rolloff = rolloff;
-	_source.set_volume_rolloff(rolloff);
+	if(_voice)
+	{
+		_voice->set_volume_rolloff(rolloff);
+	}
 }
 
 void audio_source_component::set_range(const frange& range)
@@ -43,7 +155,10 @@ void audio_source_component::set_range(const frange& range)
 	math::clamp(range.max, range.min, std::numeric_limits<float>::max());
 
 	_range = range;
-	_source.set_distance(range.min, range.max);
+	if(_voice)
+	{
+		_voice->set_distance(range.min, range.max);
+	}
 }
 
 void audio_source_component::set_autoplay(bool on)
@@ -62,6 +177,17 @@ bool audio_source_component::get_autoplay() const
 	return _auto_play;
 }
 
+void audio_source_component::set_priority(float priority)
+{
+	math::clamp(priority, 0.0f, 1.0f);
+	_priority = priority;
+}
+
+float audio_source_component::get_priority() const
+{
+	return _priority;
+}
+
 float audio_source_component::get_volume() const
 {
 	return _volume;
@@ -84,46 +210,99 @@ const frange& audio_source_component::get_range() const
 
 void audio_source_component::set_playing_offset(audio::sound_info::duration_t offset)
 {
-	_source.set_playing_offset(offset);
+	_virtual_offset = offset;
+	if(_voice)
+	{
+		_voice->set_playing_offset(offset);
+	}
 }
 
 audio::sound_info::duration_t audio_source_component::get_playing_offset() const
 {
-	return _source.get_playing_offset();
+	if(_voice)
+	{
+		return _voice->get_playing_offset();
+	}
+	return _virtual_offset;
 }
 
 audio::sound_info::duration_t audio_source_component::get_playing_duration() const
 {
-	return _source.get_playing_duration();
+	if(_sound)
+	{
+		return _sound->get_info().duration;
+	}
+	return audio::sound_info::duration_t(0);
 }
 
 void audio_source_component::play()
 {
-	if(_sound)
+	if(!is_sound_valid())
+	{
+		return;
+	}
+
+	const bool resume = _playing && _paused;
+	_playing = true;
+	_paused = false;
+	if(!resume)
+	{
+		_virtual_offset = audio::sound_info::duration_t(0);
+	}
+
+	// grab a voice right away if one is free - one-shots should not wait
+	// a frame; otherwise the audio_system promotes us when we rank
+	// inside the voice budget
+	if(!_voice && core::has_subsystems<runtime::audio_system>())
 	{
-		_source.bind(*_sound.get());
-		_source.play();
+		auto voice = core::get_subsystem<runtime::audio_system>().acquire_voice();
+		if(voice)
+		{
+			promote_voice(std::move(voice));
+			return;
+		}
+	}
+
+	if(_voice)
+	{
+		_voice->bind(*_sound.get());
+		apply_voice_properties();
+		_voice->set_playing_offset(_virtual_offset);
+		_voice->play();
 	}
 }
 
 void audio_source_component::stop()
 {
-	_source.stop();
+	_playing = false;
+	_paused = false;
+	_virtual_offset = audio::sound_info::duration_t(0);
+	if(_voice)
+	{
+		_voice->stop();
+	}
 }
 
 void audio_source_component::pause()
 {
-	_source.pause();
+	if(_playing)
+	{
+		_paused = true;
+	}
+	if(_voice)
+	{
+		_voice->pause();
+	}
 }
 
 bool audio_source_component::is_playing() const
 {
-	return _source.is_playing();
+	return _playing && !_paused;
 }
 
 bool audio_source_component::is_paused() const
 {
-	return _source.is_paused();
+	return _playing && _paused;
 }
 
 bool audio_source_component::is_looping() const
@@ -147,7 +326,12 @@ asset_handle<audio::sound> audio_source_component::get_sound() const
 
 bool audio_source_component::has_binded_sound() const
 {
-	return _source.has_binded_sound();
+	if(_voice)
+	{
+		return _voice->has_binded_sound();
+	}
+	// virtualized playback counts - offset and duration stay serviceable
+	return (_playing || _paused) && is_sound_valid();
 }
 
 void audio_source_component::apply_all()
@@ -160,6 +344,20 @@ void audio_source_component::apply_all()
 	set_autoplay(_auto_play);
 }
 
+void audio_source_component::apply_voice_properties()
+{
+	if(!_voice)
+	{
+		return;
+	}
+
+	_voice->set_loop(_loop);
+	_voice->set_volume(_volume);
+	_voice->set_pitch(_pitch);
+	_voice->set_volume_rolloff(_volume_rolloff);
+	_voice->set_distance(_range.min, _range.max);
+}
+
 bool audio_source_component::is_sound_valid() const
 {
 	return _sound && _sound->is_valid();
@@ -6,6 +6,9 @@
 #include "core/common/basetypes.hpp"
 #include "core/math/math_includes.h"
 
+#include <chrono>
+#include <memory>
+
 //-----------------------------------------------------------------------------
 // Main Class Declarations
 //-----------------------------------------------------------------------------
@@ -31,12 +34,57 @@ public:
 	//-----------------------------------------------------------------------------
 	//  Name : update ()
 	/// <summary>
-	///
-	///
-	///
+	/// Per-frame upkeep - feeds the spatial properties to the real voice
+	/// when one is held and advances the virtual playback position when
+	/// not.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void update(const math::transform& t, std::chrono::duration<float> dt);
+
+	//-----------------------------------------------------------------------------
+	//  Name : defer_update ()
+	/// <summary>
+	/// Banks the frame time of a skipped update. The owed time is delivered
+	/// in one lump on the next real update, so throttled one-shots still
+	/// expire and throttled loops still wrap correctly.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void defer_update(std::chrono::duration<float> dt);
+
+	//-----------------------------------------------------------------------------
+	//  Name : is_active ()
+	/// <summary>
+	/// Whether the source currently needs a voice - playing and not
+	/// paused.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool is_active() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : has_voice ()
+	/// <summary>
+	/// Whether the source holds a real voice from the audio_system pool.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool has_voice() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : promote_voice ()
+	/// <summary>
+	/// Hands the source a real voice - binds the sound, applies the
+	/// cached properties and resumes from the virtual playback position.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void promote_voice(std::shared_ptr<audio::source> voice);
+
+	//-----------------------------------------------------------------------------
+	//  Name : demote_voice ()
+	/// <summary>
+	/// Takes the real voice back for recycling - the playback position
+	/// carries on virtually.
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	void update(const math::transform& t);
+	std::shared_ptr<audio::source> demote_voice();
 
 	void set_loop(bool on);
 	void set_volume(float volume);
@@ -46,6 +94,8 @@ public:
 	void set_range(const frange& range);
 	void set_autoplay(bool on);
 	bool get_autoplay() const;
+	void set_priority(float priority);
+	float get_priority() const;
 
 	float get_volume() const;
 	float get_pitch() const;
@@ -71,6 +121,7 @@ public:
 
 private:
 	void apply_all();
+	void apply_voice_properties();
 	bool is_sound_valid() const;
 	//-------------------------------------------------------------------------
 	// Private Member Variables.
@@ -81,7 +132,19 @@ private:
 	float _volume = 1.0f;
 	float _pitch = 1.0f;
 	float _volume_rolloff = 1.0f;
+	/// voice stealing bias - a higher priority keeps its real voice over
+	/// lower ones at the same distance
+	float _priority = 0.5f;
 	frange _range = {1.0f, 20.0f};
-	audio::source _source;
+	/// logical playback state - the source of truth, since the real
+	/// voice comes and goes with the audio_system voice budget
+	bool _playing = false;
+	bool _paused = false;
+	/// playback position kept advancing while no real voice is held
+	audio::sound_info::duration_t _virtual_offset = audio::sound_info::duration_t(0);
+	/// time owed from updates the audio_system throttled away
+	std::chrono::duration<float> _deferred_dt = std::chrono::duration<float>(0);
+	/// real voice lent by the audio_system - null while virtualized
+	std::shared_ptr<audio::source> _voice;
 	asset_handle<audio::sound> _sound;
 };
@@ -32,7 +32,90 @@ void camera_component::set_hdr(bool hdr)
 
 void camera_component::set_viewport_size(const usize& size)
 {
-	_camera.set_viewport_size(size);
+	const auto applied = _camera.get_viewport_size();
+	if(size == applied)
+	{
+		_pending_viewport_frames = 0;
+		return;
+	}
+
+	// Debounce drag-resizes: every intermediate size would reallocate this
+	// camera's whole render_view chain, so keep rendering at the old size
+	// (consumers blit it scaled) until the new one holds steady.
+	if(size == _pending_viewport_size)
+	{
+		++_pending_viewport_frames;
+	}
+	else
+	{
+		_pending_viewport_size = size;
+		_pending_viewport_frames = 1;
+	}
+
+	if(_pending_viewport_frames >= viewport_settle_frames || applied.width == 0 || applied.height == 0)
+	{
+		_camera.set_viewport_size(size);
+		_pending_viewport_frames = 0;
+	}
+}
+
+void camera_component::set_render_on_demand(bool enabled)
+{
+	if(_render_on_demand == enabled)
+		return;
+
+	_render_on_demand = enabled;
+	// Never reuse a target that predates the gating switch.
+	_refresh_requested = true;
+}
+
+bool camera_component::is_render_on_demand() const
+{
+	return _render_on_demand;
+}
+
+void camera_component::request_present()
+{
+	_present_requested = true;
+}
+
+void camera_component::request_refresh()
+{
+	_refresh_requested = true;
+}
+
+bool camera_component::should_render() const
+{
+	if(!_render_on_demand)
+		return true;
+
+	// Nothing displays the output this frame; skip the view entirely.
+	if(!_present_requested)
+		return false;
+
+	if(_refresh_requested)
+		return true;
+
+	// Presented but idle: reuse the previous target and only refresh at
+	// the reduced rate.
+	return _frames_since_render >= idle_refresh_interval;
+}
+
+void camera_component::on_view_rendered(bool rendered)
+{
+	if(rendered)
+	{
+		_frames_since_render = 0;
+		_refresh_requested = false;
+	}
+	else
+	{
+		++_frames_since_render;
+	}
+
+	// Present requests are per frame; the presenter re-issues them while
+	// it stays visible.
+	_present_requested = false;
 }
 
 const usize& camera_component::get_viewport_size() const
@@ -99,3 +182,13 @@ projection_mode camera_component::get_projection_mode() const
 {
 	return _camera.get_projection_mode();
 }
+
+void camera_component::set_render_priority(std::int32_t priority)
+{
+	if(_render_priority == priority)
+		return;
+
+	touch();
+
+	_render_priority = priority;
+}
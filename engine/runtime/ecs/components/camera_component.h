@@ -235,6 +235,84 @@ public:
 		return _render_view;
 	}
 
+	//-----------------------------------------------------------------------------
+	//  Name : set_render_on_demand ()
+	/// <summary>
+	/// Enables presenter driven render gating for this camera. A gated view
+	/// is only rendered on frames where its output was requested, and an
+	/// idle but presented view refreshes at a reduced rate. Off by default
+	/// so standalone cameras are unaffected.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_render_on_demand(bool enabled);
+
+	//-----------------------------------------------------------------------------
+	//  Name : is_render_on_demand ()
+	/// <summary>
+	/// Whether presenter driven render gating is enabled for this camera.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool is_render_on_demand() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : request_present ()
+	/// <summary>
+	/// Marks that something will display this camera's output this frame.
+	/// Called every frame by the presenter (e.g. a visible editor dock);
+	/// a gated view without a present request is skipped entirely.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void request_present();
+
+	//-----------------------------------------------------------------------------
+	//  Name : request_refresh ()
+	/// <summary>
+	/// Forces the next presented frame to render regardless of the idle
+	/// refresh interval. Called when the view content is known to have
+	/// changed (camera moved, scene edited).
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void request_refresh();
+
+	//-----------------------------------------------------------------------------
+	//  Name : should_render ()
+	/// <summary>
+	/// Whether the renderer should render this camera's view this frame.
+	/// Pure query; stable for the duration of the frame. The renderer
+	/// reports the outcome through on_view_rendered.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool should_render() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : on_view_rendered ()
+	/// <summary>
+	/// Per-frame gating bookkeeping, called by the renderer exactly once
+	/// per camera per frame with whether the view was actually rendered.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void on_view_rendered(bool rendered);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_render_priority ()
+	/// <summary>
+	/// Render order among active cameras; lower values render first.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline std::int32_t get_render_priority() const
+	{
+		return _render_priority;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_render_priority ()
+	/// <summary>
+	/// Sets the render order among active cameras. Ties keep a stable order,
+	/// so split-screen views with equal priority stay where they were.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_render_priority(std::int32_t priority);
+
 private:
 	//-------------------------------------------------------------------------
 	// Private Member Variables.
@@ -245,4 +323,22 @@ private:
 	gfx::render_view _render_view;
 	/// Is the camera HDR?
 	bool _hdr = true;
+	/// frames a new viewport size must repeat before it is applied
+	static const std::uint32_t viewport_settle_frames = 8;
+	/// viewport size waiting out the settle window
+	usize _pending_viewport_size = {0, 0};
+	/// consecutive frames the pending size has held steady
+	std::uint32_t _pending_viewport_frames = 0;
+	/// frames between renders of a presented but idle gated view
+	static const std::uint32_t idle_refresh_interval = 10;
+	/// is presenter driven render gating enabled for this camera?
+	bool _render_on_demand = false;
+	/// did a presenter request this camera's output this frame?
+	bool _present_requested = false;
+	/// must the next presented frame render regardless of idleness?
+	bool _refresh_requested = true;
+	/// frames elapsed since the view was last rendered
+	std::uint32_t _frames_since_render = 0;
+	/// render order among active cameras; lower renders first
+	std::int32_t _render_priority = 0;
 };
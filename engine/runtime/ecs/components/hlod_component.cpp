@@ -0,0 +1,45 @@
+#include "hlod_component.h"
+
+hlod_component& hlod_component::set_members(const std::vector<runtime::entity>& members)
+{
+	_members = members;
+
+	touch();
+
+	return *this;
+}
+
+const std::vector<runtime::entity>& hlod_component::get_members() const
+{
+	return _members;
+}
+
+hlod_component& hlod_component::set_cluster_bounds(const math::bbox& bounds)
+{
+	_cluster_bounds = bounds;
+
+	touch();
+
+	return *this;
+}
+
+const math::bbox& hlod_component::get_cluster_bounds() const
+{
+	return _cluster_bounds;
+}
+
+hlod_component& hlod_component::set_screen_size_threshold(float threshold)
+{
+	if(math::epsilonEqual(_screen_size_threshold, threshold, math::epsilon<float>()))
+		return *this;
+
+	touch();
+
+	_screen_size_threshold = threshold;
+	return *this;
+}
+
+float hlod_component::get_screen_size_threshold() const
+{
+	return _screen_size_threshold;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../ecs.h"
+#include "core/math/math_includes.h"
+
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Main Class Declarations
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//  Name : hlod_component (Class)
+/// <summary>
+/// Marks an entity as the proxy of a hierarchical LOD cluster: a merged,
+/// simplified stand-in for a group of static models built by the editor's
+/// HLOD pass. The renderer swaps between the proxy and its member
+/// entities based on the cluster's projected screen size, so distant
+/// groups cost one draw instead of one per member.
+/// </summary>
+//-----------------------------------------------------------------------------
+class hlod_component : public runtime::component_impl<hlod_component>
+{
+	SERIALIZABLE(hlod_component)
+	REFLECTABLEV(hlod_component, component)
+
+public:
+	//-------------------------------------------------------------------------
+	// Public Methods
+	//-------------------------------------------------------------------------
+	//-----------------------------------------------------------------------------
+	//  Name : set_members ()
+	/// <summary>
+	/// The entities this proxy replaces when the cluster is distant.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	hlod_component& set_members(const std::vector<runtime::entity>& members);
+	const std::vector<runtime::entity>& get_members() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_cluster_bounds ()
+	/// <summary>
+	/// World-space bounds of the whole cluster, used for the screen size
+	/// metric that drives the swap.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	hlod_component& set_cluster_bounds(const math::bbox& bounds);
+	const math::bbox& get_cluster_bounds() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_screen_size_threshold ()
+	/// <summary>
+	/// Projected screen height fraction below which the proxy replaces
+	/// the member entities.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	hlod_component& set_screen_size_threshold(float threshold);
+	float get_screen_size_threshold() const;
+
+private:
+	//-------------------------------------------------------------------------
+	// Private Member Variables.
+	//-------------------------------------------------------------------------
+	/// Entities replaced by this proxy when the cluster is distant.
+	std::vector<runtime::entity> _members;
+	/// World-space bounds of the cluster at build time.
+	math::bbox _cluster_bounds;
+	/// Swap point as projected screen height fraction.
+	float _screen_size_threshold = 0.05f;
+};
@@ -1,4 +1,5 @@
 #include "model_component.h"
+#include "../../rendering/mesh.h"
 #include "transform_component.h"
 
 model_component& model_component::set_casts_shadow(bool cast_shadow)
@@ -87,7 +88,45 @@ const std::vector<runtime::entity>& model_component::get_bone_entities() const
 	return _bone_entities;
 }
 
+skinning_data& model_component::get_skinning_data()
+{
+	return _skinning_data;
+}
+
+const skinning_data& model_component::get_skinning_data() const
+{
+	return _skinning_data;
+}
+
 bool model_component::casts_reflection() const
 {
 	return _casts_reflection;
 }
+
+const math::bbox& model_component::get_world_bounds(transform_component& transform)
+{
+	auto lod = _model.get_lod(0);
+	auto* mesh_ptr = lod.get();
+	const auto model_version = get_last_touched();
+	const auto transform_version = transform.get_last_touched();
+
+	// Touch frames only change once per frame, so a transform that was
+	// modified again after the cache was filled this frame is caught by its
+	// still-pending dirty flag.
+	if(!_world_bounds_valid || transform.is_dirty() || mesh_ptr != _world_bounds_mesh ||
+	   model_version != _world_bounds_model_version ||
+	   transform_version != _world_bounds_transform_version)
+	{
+		if(mesh_ptr != nullptr)
+			_world_bounds = math::bbox::mul(mesh_ptr->get_bounds(), transform.get_transform());
+		else
+			_world_bounds.reset();
+
+		_world_bounds_mesh = mesh_ptr;
+		_world_bounds_model_version = model_version;
+		_world_bounds_transform_version = transform_version;
+		_world_bounds_valid = true;
+	}
+
+	return _world_bounds;
+}
@@ -4,6 +4,7 @@
 #include "../ecs.h"
 
 class material;
+class transform_component;
 //-----------------------------------------------------------------------------
 // Main Class Declarations
 //-----------------------------------------------------------------------------
@@ -110,6 +111,28 @@ public:
 	model_component& set_bone_transforms(const std::vector<math::transform>& bone_transforms);
 	const std::vector<math::transform>& get_bone_transforms() const;
 
+	//-----------------------------------------------------------------------------
+	//  Name : get_skinning_data ()
+	/// <summary>
+	/// Skinning palettes for the current frame, resolved once by the bone
+	/// system and shared by every render pass that draws this entity.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	skinning_data& get_skinning_data();
+	const skinning_data& get_skinning_data() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_world_bounds ()
+	/// <summary>
+	/// World-space bounds of the base mesh under the given transform.
+	/// Cached between calls and only recomputed when the transform or this
+	/// component was touched since the cache was filled (or the mesh
+	/// finished streaming in), so repeated visibility gathers in one frame
+	/// do not redo the corner transforms.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const math::bbox& get_world_bounds(transform_component& transform);
+
 private:
 	//-------------------------------------------------------------------------
 	// Private Member Variables.
@@ -125,4 +148,16 @@ private:
 	///
 	std::vector<runtime::entity> _bone_entities;
 	std::vector<math::transform> _bone_transforms;
+	/// Skinning palettes shared by all passes in the current frame.
+	skinning_data _skinning_data;
+	/// Cached world-space bounds and the state they were computed from.
+	math::bbox _world_bounds;
+	/// Mesh the cached bounds were taken from; a streamed-in mesh swap
+	/// invalidates the cache even though nothing was touched.
+	mesh* _world_bounds_mesh = nullptr;
+	/// Touch frames of this component and the transform at cache time.
+	std::uint32_t _world_bounds_model_version = 0;
+	std::uint32_t _world_bounds_transform_version = 0;
+	///
+	bool _world_bounds_valid = false;
 };
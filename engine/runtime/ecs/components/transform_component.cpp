@@ -2,6 +2,8 @@
 #include "core/logging/logging.h"
 #include <algorithm>
 
+event<void(runtime::entity)> on_transform_parent_changed;
+
 void transform_component::on_entity_set()
 {
 	for(auto& child : _children)
@@ -157,6 +159,37 @@ const math::transform& transform_component::get_transform()
 	return _world_transform;
 }
 
+void transform_component::snapshot_tick_transform()
+{
+	_last_tick_transform = get_transform();
+	_has_tick_snapshot = true;
+}
+
+void transform_component::update_render_transform(float alpha)
+{
+	// math::transform::lerp mutates its endpoints while decomposing, so
+	// both go in as copies
+	math::transform previous = _has_tick_snapshot ? _last_tick_transform : get_transform();
+	math::transform current = get_transform();
+	_render_transform = math::transform::lerp(previous, current, alpha);
+	_render_transform_valid = true;
+}
+
+void transform_component::clear_render_transform()
+{
+	_render_transform_valid = false;
+}
+
+const math::transform& transform_component::get_render_transform()
+{
+	if(_render_transform_valid)
+	{
+		return _render_transform;
+	}
+
+	return get_transform();
+}
+
 const math::transform& transform_component::get_local_transform() const
 {
 	// Return reference to our internal matrix
@@ -552,6 +585,8 @@ transform_component& transform_component::set_parent(runtime::entity parent, boo
 
 	set_dirty(is_dirty());
 
+	on_transform_parent_changed(get_entity());
+
 	// Success!
 	return *this;
 }
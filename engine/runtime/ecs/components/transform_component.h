@@ -3,6 +3,11 @@
 #include "../ecs.h"
 #include "core/math/math_includes.h"
 
+/// Fired after a transform's parent changed, with the affected entity.
+/// Lets interested systems (e.g. scene_graph root tracking) react to
+/// reparenting without rescanning the hierarchy.
+extern event<void(runtime::entity)> on_transform_parent_changed;
+
 //-----------------------------------------------------------------------------
 // Main Class Declarations
 //-----------------------------------------------------------------------------
@@ -96,6 +101,44 @@ public:
 	//-----------------------------------------------------------------------------
 	const math::transform& get_transform();
 
+	//-----------------------------------------------------------------------------
+	//  Name : snapshot_tick_transform ()
+	/// <summary>
+	/// Records the current world transform as the previous simulation tick.
+	/// Called once per fixed tick, before gameplay moves anything, so the
+	/// renderer has both endpoints to interpolate between.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void snapshot_tick_transform();
+
+	//-----------------------------------------------------------------------------
+	//  Name : update_render_transform ()
+	/// <summary>
+	/// Blends the snapshotted previous-tick transform toward the current
+	/// one by the given alpha and caches the result for rendering.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void update_render_transform(float alpha);
+
+	//-----------------------------------------------------------------------------
+	//  Name : clear_render_transform ()
+	/// <summary>
+	/// Drops the interpolated cache; get_render_transform falls back to
+	/// the resolved world transform.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void clear_render_transform();
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_render_transform ()
+	/// <summary>
+	/// The transform rendering should submit - the interpolated one when
+	/// fixed-timestep interpolation is active, the resolved world
+	/// transform otherwise.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const math::transform& get_render_transform();
+
 	//-----------------------------------------------------------------------------
 	//  Name : get_position ()
 	/// <summary>
@@ -554,6 +597,14 @@ protected:
 	math::transform _local_transform;
 	/// Cached world transformation at pivot point.
 	math::transform _world_transform;
+	/// World transform as of the previous fixed simulation tick.
+	math::transform _last_tick_transform;
+	/// Interpolated transform rendering submits between two ticks.
+	math::transform _render_transform;
+	/// Whether a fixed tick has snapshotted this component yet.
+	bool _has_tick_snapshot = false;
+	/// Whether _render_transform holds a blend for the current frame.
+	bool _render_transform_valid = false;
 
 	bool _dirty = true;
 };
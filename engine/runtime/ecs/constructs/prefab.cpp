@@ -1,17 +1,53 @@
 #include "prefab.h"
 #include "utils.h"
 
+#include <sstream>
+
 runtime::entity prefab::instantiate()
 {
 	std::vector<runtime::entity> out_data;
-	if(!data)
-		return {};
 
-	if(!ecs::utils::deserialize_data(*data, out_data))
+	if(_template_blob.empty())
+	{
+		if(!data)
+			return {};
+
+		std::ostringstream os;
+		os << data->rdbuf();
+		auto payload = os.str();
+		data->clear();
+		data->seekg(0);
+
+		if(ecs::utils::is_binary_entity_data(payload))
+		{
+			// The compiled artifact already is the tagged binary template
+			// form - adopt its bytes outright, so even the first spawn is
+			// one read and one construction pass with no decode/re-encode
+			// round trip.
+			_template_blob = std::move(payload);
+		}
+		else
+		{
+			// Associative source form (uncompiled content) - decode it
+			// once and transcode the result into the template.
+			std::istringstream stream(payload);
+			if(!ecs::utils::deserialize_data(stream, out_data))
+				return {};
+
+			if(out_data.empty())
+				return {};
+
+			_template_blob = ecs::utils::serialize_entities_as_binary(out_data);
+			return out_data.front();
+		}
+	}
+
+	std::istringstream stream(_template_blob);
+	if(!ecs::utils::deserialize_data(stream, out_data))
 		return {};
 
 	if(out_data.empty())
 		return {};
-	else
-		return out_data.front();
+
+	return out_data.front();
 }
@@ -3,9 +3,19 @@
 #include "../ecs.h"
 #include <fstream>
 #include <memory>
+#include <string>
 
 struct prefab
 {
 	runtime::entity instantiate();
 	std::shared_ptr<std::istream> data;
+
+private:
+	/// Binary template every spawn clones from through the fast dispatch
+	/// decoder. A compiled artifact is already in this form and its bytes
+	/// are adopted as-is on the first instantiate; an associative source
+	/// is decoded once and transcoded. Heavyweight component payloads
+	/// (meshes, materials, textures) are asset handles and stay shared
+	/// between the instances.
+	std::string _template_blob;
 };
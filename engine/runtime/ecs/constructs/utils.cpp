@@ -3,12 +3,38 @@
 #include "core/serialization/associative_archive.h"
 #include "core/serialization/binary_archive.h"
 #include "core/serialization/serialization.h"
+#include "core/system/subsystem.h"
+#include "core/tasks/task_system.h"
+
+#include <algorithm>
+#include <set>
+#include <sstream>
 
 namespace ecs
 {
 namespace utils
 {
 
+/// Tag prepended to compiled binary entity data. The binary archive is
+/// not self-describing, so the tag is how deserialize_data tells the
+/// runtime artifact apart from the associative source form.
+static const char binary_format_tag[] = {'e', 'b', 'd', '1'};
+
+/// Chunked variant of the binary form - the payload is split into
+/// self-contained chunks that deserialize in parallel on the task
+/// system, followed by a serial append in chunk order.
+static const char chunked_format_tag[] = {'e', 'b', 'd', '2'};
+
+/// Same layouts, but components are encoded through the dispatch table
+/// instead of cereal's polymorphic machinery. The old tags keep loading
+/// with the polymorphic decoder.
+static const char binary_format_tag_v2[] = {'e', 'b', 'd', '3'};
+static const char chunked_format_tag_v2[] = {'e', 'b', 'd', '4'};
+
+/// Dispatch-table encoding with varint ids, counts and string lengths.
+static const char binary_format_tag_v3[] = {'e', 'b', 'd', '5'};
+static const char chunked_format_tag_v3[] = {'e', 'b', 'd', '6'};
+
 template <typename OArchive>
 static void serialize_t(std::ostream& stream, const std::vector<runtime::entity>& data)
 {
@@ -20,14 +46,15 @@ static void serialize_t(std::ostream& stream, const std::vector<runtime::entity>
 }
 
 template <typename IArchive>
-static bool deserialize_t(std::istream& stream, std::vector<runtime::entity>& out_data)
+static bool deserialize_t(std::istream& stream, std::vector<runtime::entity>& out_data,
+						  std::streampos start = 0)
 {
 	// get length of file:
 	runtime::get_serialization_map().clear();
 	stream.seekg(0, stream.end);
 	std::streampos length = stream.tellg();
-	stream.seekg(0, stream.beg);
-	if(length > 0)
+	stream.seekg(start);
+	if(length > start)
 	{
 		IArchive ar(stream);
 
@@ -41,6 +68,68 @@ static bool deserialize_t(std::istream& stream, std::vector<runtime::entity>& ou
 	return false;
 }
 
+static std::string journal_path(const fs::path& full_path)
+{
+	return full_path.string() + ".journal";
+}
+
+/// Last in-flight journal write. Discarding waits on it so a write that
+/// was still queued cannot resurrect the sidecar after a full save.
+static core::task_future<void> pending_journal_write;
+
+/// Last in-flight background full save. Loads and synchronous saves wait
+/// on it so nobody reads or rewrites a half-written snapshot.
+static core::task_future<void> pending_scene_write;
+
+static void wait_pending_scene_write()
+{
+	if(pending_scene_write.valid())
+	{
+		pending_scene_write.wait();
+	}
+}
+
+//  Decodes a tagged-or-associative entity payload without clearing the
+//  thread's serialization map. The journal merge relies on entities the
+//  journal loaded staying mapped while the base snapshot decodes, and
+//  resave relies on the map still naming everything afterwards - the
+//  regular deserialize_t path clears it on both ends.
+static void read_entities_preserving_map(std::istream& stream, std::vector<runtime::entity>& out_data)
+{
+	char tag[sizeof(binary_format_tag)] = {};
+	stream.read(tag, sizeof(tag));
+	const bool has_tag = stream.gcount() == static_cast<std::streamsize>(sizeof(tag));
+	stream.clear();
+
+	const auto tag_is = [&tag, has_tag](const char(&format_tag)[sizeof(tag)]) {
+		return has_tag && std::equal(std::begin(tag), std::end(tag), std::begin(format_tag));
+	};
+
+	std::uint32_t binary_version = 0;
+	if(tag_is(binary_format_tag))
+		binary_version = 1;
+	else if(tag_is(binary_format_tag_v2))
+		binary_version = 2;
+	else if(tag_is(binary_format_tag_v3))
+		binary_version = 3;
+
+	if(binary_version != 0)
+	{
+		stream.seekg(std::streampos(sizeof(tag)));
+		runtime::get_binary_component_format_version() = binary_version;
+		{
+			cereal::iarchive_binary_t ar(stream);
+			try_load(ar, cereal::make_nvp("data", out_data));
+		}
+		runtime::get_binary_component_format_version() = 3;
+		return;
+	}
+
+	stream.seekg(0);
+	cereal::iarchive_associative_t ar(stream);
+	try_load(ar, cereal::make_nvp("data", out_data));
+}
+
 void save_entity_to_file(const fs::path& full_path, const runtime::entity& data)
 {
 	save_entities_to_file(full_path, {data});
@@ -60,14 +149,142 @@ bool try_load_entity_from_file(const fs::path& full_path, runtime::entity& out_d
 
 void save_entities_to_file(const fs::path& full_path, const std::vector<runtime::entity>& data)
 {
+	wait_pending_scene_write();
+
 	std::ofstream os(full_path.string(), std::fstream::binary | std::fstream::trunc);
 	serialize_t<cereal::oarchive_associative_t>(os, data);
+
+	// a full save supersedes whatever the journal accumulated
+	discard_entities_journal(full_path);
+}
+
+bool save_entities_to_file_async(const fs::path& full_path, const std::vector<runtime::entity>& data)
+{
+	if(data.empty())
+		return false;
+
+	wait_pending_scene_write();
+
+	// The snapshot step: the dispatch-table binary form detaches the whole
+	// serializable scene state from the live ecs in memory, so the worker
+	// below never touches components while simulation keeps mutating them.
+	auto payload = serialize_entities_as_binary(data);
+
+	auto& ts = core::get_subsystem<core::task_system>();
+	// chain behind any queued journal write - the full snapshot supersedes
+	// the sidecar and must not lose the race against it landing on disk
+	auto journal_write = pending_journal_write;
+	pending_scene_write = ts.push_on_worker_thread(
+		core::task_priority::background,
+		[
+			path = full_path.string(), journal_file = journal_path(full_path),
+			payload = std::move(payload), journal_write
+		]() {
+			if(journal_write.valid())
+			{
+				journal_write.wait();
+			}
+			{
+				std::ofstream file(path, std::fstream::binary | std::fstream::trunc);
+				file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+			}
+			fs::error_code err;
+			fs::remove(fs::path(journal_file), err);
+		});
+	return true;
 }
 
 bool load_entities_from_file(const fs::path& full_path, std::vector<runtime::entity>& out_data)
 {
-	std::ifstream is(full_path.string(), std::fstream::binary);
-	return deserialize_t<cereal::iarchive_associative_t>(is, out_data);
+	wait_pending_scene_write();
+
+	fs::error_code err;
+	const fs::path journal = journal_path(full_path);
+	if(!fs::exists(journal, err))
+	{
+		// the file is either the associative source form or a tagged binary
+		// snapshot left behind by a background autosave
+		std::ifstream is(full_path.string(), std::fstream::binary);
+		if(!is.good())
+			return false;
+		return deserialize_data(is, out_data);
+	}
+
+	// An incremental save left a journal behind - merge it in. The
+	// journal loads first so its (newer) entity records land in the
+	// serialization map; when the base snapshot then reaches the same
+	// ids it picks the journal's entities up through the map instead of
+	// re-reading its own stale bodies.
+	auto& serialization_map = runtime::get_serialization_map();
+	serialization_map.clear();
+
+	std::vector<runtime::entity> journal_roots;
+	{
+		std::ifstream is(journal.string(), std::fstream::binary);
+		if(is.good())
+		{
+			read_entities_preserving_map(is, journal_roots);
+		}
+	}
+
+	std::vector<runtime::entity> base_roots;
+	{
+		std::ifstream is(full_path.string(), std::fstream::binary);
+		if(is.good())
+		{
+			read_entities_preserving_map(is, base_roots);
+		}
+	}
+	serialization_map.clear();
+
+	out_data = std::move(base_roots);
+	// roots created after the full save exist only in the journal
+	for(const auto& journal_root : journal_roots)
+	{
+		if(std::find(out_data.begin(), out_data.end(), journal_root) == out_data.end())
+		{
+			out_data.push_back(journal_root);
+		}
+	}
+	return !out_data.empty();
+}
+
+bool save_entities_journal(const fs::path& full_path, const std::vector<runtime::entity>& data)
+{
+	if(data.empty())
+		return false;
+
+	// serialization walks the live ecs, so it stays on the calling
+	// thread - only the file write itself goes to a worker
+	std::ostringstream os;
+	serialize_t<cereal::oarchive_associative_t>(os, data);
+
+	auto& ts = core::get_subsystem<core::task_system>();
+	// chain behind an in-flight full save - its tail end deletes the
+	// sidecar and must not eat a journal written after it was queued
+	auto scene_write = pending_scene_write;
+	pending_journal_write = ts.push_on_worker_thread(
+		core::task_priority::background,
+		[ path = journal_path(full_path), payload = os.str(), scene_write ]() {
+			if(scene_write.valid())
+			{
+				scene_write.wait();
+			}
+			std::ofstream file(path, std::fstream::binary | std::fstream::trunc);
+			file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+		});
+	return true;
+}
+
+void discard_entities_journal(const fs::path& full_path)
+{
+	if(pending_journal_write.valid())
+	{
+		pending_journal_write.wait();
+	}
+
+	fs::error_code err;
+	fs::remove(fs::path(journal_path(full_path)), err);
 }
 
 runtime::entity clone_entity(const runtime::entity& data)
@@ -85,9 +302,245 @@ runtime::entity clone_entity(const runtime::entity& data)
 	return {};
 }
 
+std::string serialize_entities_as_binary(const std::vector<runtime::entity>& data)
+{
+	std::ostringstream os;
+	os.write(binary_format_tag_v3, sizeof(binary_format_tag_v3));
+	serialize_t<cereal::oarchive_binary_t>(os, data);
+	return os.str();
+}
+
+bool is_binary_entity_data(const std::string& payload)
+{
+	if(payload.size() < sizeof(binary_format_tag))
+		return false;
+
+	const auto tag_is = [&payload](const char(&format_tag)[sizeof(binary_format_tag)]) {
+		return std::equal(std::begin(format_tag), std::end(format_tag), payload.begin());
+	};
+
+	return tag_is(binary_format_tag) || tag_is(chunked_format_tag) || tag_is(binary_format_tag_v2) ||
+		   tag_is(chunked_format_tag_v2) || tag_is(binary_format_tag_v3) ||
+		   tag_is(chunked_format_tag_v3);
+}
+
 bool deserialize_data(std::istream& stream, std::vector<runtime::entity>& out_data)
 {
+	char tag[sizeof(binary_format_tag)] = {};
+	stream.read(tag, sizeof(tag));
+	const bool has_tag = stream.gcount() == static_cast<std::streamsize>(sizeof(tag));
+	stream.clear();
+
+	const auto tag_is = [&tag, has_tag](const char(&format_tag)[sizeof(tag)]) {
+		return has_tag && std::equal(std::begin(tag), std::end(tag), std::begin(format_tag));
+	};
+
+	std::uint32_t binary_version = 0;
+	if(tag_is(binary_format_tag))
+		binary_version = 1;
+	else if(tag_is(binary_format_tag_v2))
+		binary_version = 2;
+	else if(tag_is(binary_format_tag_v3))
+		binary_version = 3;
+
+	if(binary_version != 0)
+	{
+		runtime::get_binary_component_format_version() = binary_version;
+		const bool result = deserialize_t<cereal::iarchive_binary_t>(stream, out_data,
+																	 std::streampos(sizeof(tag)));
+		runtime::get_binary_component_format_version() = 3;
+		return result;
+	}
+
+	std::uint32_t chunked_version = 0;
+	if(tag_is(chunked_format_tag))
+		chunked_version = 1;
+	else if(tag_is(chunked_format_tag_v2))
+		chunked_version = 2;
+	else if(tag_is(chunked_format_tag_v3))
+		chunked_version = 3;
+
+	if(chunked_version != 0)
+	{
+		const std::uint32_t component_format_version = chunked_version;
+		std::uint32_t chunk_count = 0;
+		stream.read(reinterpret_cast<char*>(&chunk_count), sizeof(chunk_count));
+		if(stream.gcount() != static_cast<std::streamsize>(sizeof(chunk_count)) || chunk_count == 0)
+			return false;
+
+		std::vector<std::uint32_t> sizes(chunk_count);
+		stream.read(reinterpret_cast<char*>(sizes.data()),
+					static_cast<std::streamsize>(chunk_count * sizeof(std::uint32_t)));
+
+		std::vector<std::string> payloads(chunk_count);
+		for(std::uint32_t i = 0; i < chunk_count; ++i)
+		{
+			payloads[i].resize(sizes[i]);
+			stream.read(&payloads[i][0], static_cast<std::streamsize>(sizes[i]));
+			if(stream.gcount() != static_cast<std::streamsize>(sizes[i]))
+				return false;
+		}
+
+		// Chunks are self-contained - each worker resolves references
+		// through its own (thread local) serialization map, while ecs
+		// mutation inside the entity loader is serialized by a mutex.
+		// The first chunk parses on the calling thread; results append
+		// in chunk order so entity ordering matches the single-chunk
+		// form.
+		auto& ts = core::get_subsystem<core::task_system>();
+		std::vector<core::task_future<std::vector<runtime::entity>>> pending;
+		pending.reserve(chunk_count - 1);
+		for(std::uint32_t i = 1; i < chunk_count; ++i)
+		{
+			pending.emplace_back(
+				ts.push_on_worker_thread([ payload = std::move(payloads[i]), component_format_version ]() {
+					runtime::get_binary_component_format_version() = component_format_version;
+					std::istringstream is(payload);
+					std::vector<runtime::entity> chunk;
+					deserialize_t<cereal::iarchive_binary_t>(is, chunk);
+					runtime::get_binary_component_format_version() = 3;
+					return chunk;
+				}));
+		}
+
+		{
+			runtime::get_binary_component_format_version() = component_format_version;
+			std::istringstream is(payloads[0]);
+			deserialize_t<cereal::iarchive_binary_t>(is, out_data);
+			runtime::get_binary_component_format_version() = 3;
+		}
+
+		for(auto& future : pending)
+		{
+			auto chunk = future.get();
+			out_data.insert(out_data.end(), chunk.begin(), chunk.end());
+		}
+		return !out_data.empty();
+	}
+
+	stream.seekg(0);
 	return deserialize_t<cereal::iarchive_associative_t>(stream, out_data);
 }
+
+bool resave_entities_as_binary(const fs::path& input, const fs::path& output,
+							   const std::function<void(std::vector<runtime::entity>&)>& post_load)
+{
+	auto& serialization_map = runtime::get_serialization_map();
+	serialization_map.clear();
+
+	std::vector<runtime::entity> roots;
+	{
+		std::ifstream is(input.string(), std::fstream::binary);
+		if(!is.good())
+			return false;
+
+		// sources are associative, but a background autosave may have left
+		// the scene as a tagged binary snapshot - accept both
+		read_entities_preserving_map(is, roots);
+	}
+
+	// the map holds every entity the load created, roots and children alike
+	std::vector<runtime::entity> all;
+	all.reserve(serialization_map.size());
+	for(auto& pair : serialization_map)
+	{
+		all.push_back(pair.second);
+	}
+	serialization_map.clear();
+
+	if(post_load)
+	{
+		post_load(roots);
+	}
+
+	bool saved = false;
+	if(!roots.empty())
+	{
+		// Slice the roots into self-contained chunks so the load can fan
+		// the per-entity work out across workers. If an entity shows up
+		// in two chunks (a component referencing into another root's
+		// subtree) the chunks would instantiate it twice on load -
+		// detect the overlap and fall back to the single-chunk form.
+		auto& ts = core::get_subsystem<core::task_system>();
+		const std::size_t workers = std::max<std::size_t>(1, ts.get_threads_count() - 1);
+		const std::size_t chunk_count = std::min(roots.size(), workers);
+		const std::size_t per_chunk = (roots.size() + chunk_count - 1) / chunk_count;
+
+		std::vector<std::string> payloads;
+		payloads.reserve(chunk_count);
+		bool disjoint = true;
+		std::set<std::uint64_t> seen;
+		for(std::size_t begin = 0; begin < roots.size() && disjoint; begin += per_chunk)
+		{
+			const std::size_t end = std::min(begin + per_chunk, roots.size());
+			std::vector<runtime::entity> slice(roots.begin() + static_cast<std::ptrdiff_t>(begin),
+											   roots.begin() + static_cast<std::ptrdiff_t>(end));
+
+			std::ostringstream os_chunk;
+			serialization_map.clear();
+			{
+				cereal::oarchive_binary_t ar(os_chunk);
+				try_save(ar, cereal::make_nvp("data", slice));
+			}
+			for(const auto& pair : serialization_map)
+			{
+				if(!seen.insert(pair.first).second)
+				{
+					disjoint = false;
+					break;
+				}
+			}
+			serialization_map.clear();
+			payloads.push_back(os_chunk.str());
+		}
+
+		std::ofstream os(output.string(), std::fstream::binary | std::fstream::trunc);
+		if(os.good())
+		{
+			if(disjoint && payloads.size() > 1)
+			{
+				os.write(chunked_format_tag_v3, sizeof(chunked_format_tag_v3));
+				const auto count = static_cast<std::uint32_t>(payloads.size());
+				os.write(reinterpret_cast<const char*>(&count), sizeof(count));
+				for(const auto& payload : payloads)
+				{
+					const auto size = static_cast<std::uint32_t>(payload.size());
+					os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+				}
+				for(const auto& payload : payloads)
+				{
+					os.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+				}
+			}
+			else
+			{
+				os.write(binary_format_tag_v3, sizeof(binary_format_tag_v3));
+				serialize_t<cereal::oarchive_binary_t>(os, roots);
+			}
+			saved = true;
+		}
+	}
+
+	// the entities existed only to feed the binary writer - tear them
+	// down again before anything else can see them. Roots the post_load
+	// hook created are not in 'all', so sweep both lists.
+	for(auto& e : all)
+	{
+		if(e.valid())
+		{
+			e.destroy();
+		}
+	}
+	for(auto& e : roots)
+	{
+		if(e.valid())
+		{
+			e.destroy();
+		}
+	}
+	serialization_map.clear();
+
+	return saved;
+}
 }
 }
@@ -3,6 +3,7 @@
 #include "../ecs.h"
 #include "core/filesystem/filesystem.h"
 #include <fstream>
+#include <functional>
 #include <vector>
 
 namespace ecs
@@ -41,6 +42,20 @@ bool try_load_entity_from_file(const fs::path& full_path, runtime::entity& out_d
 //-----------------------------------------------------------------------------
 void save_entities_to_file(const fs::path& full_path, const std::vector<runtime::entity>& data);
 
+//-----------------------------------------------------------------------------
+//  Name : save_entities_to_file_async ()
+/// <summary>
+/// Background variant of save_entities_to_file for autosaves. The scene
+/// state is snapshotted in memory on the calling thread through the fast
+/// tagged binary form, then a background worker writes the file and
+/// retires the journal - the caller never blocks on serialization volume
+/// or disk. The scene file ends up in the tagged binary layout; all
+/// loaders sniff the tag and accept either form. Loads and synchronous
+/// saves of any scene wait for the in-flight write first.
+/// </summary>
+//-----------------------------------------------------------------------------
+bool save_entities_to_file_async(const fs::path& full_path, const std::vector<runtime::entity>& data);
+
 //-----------------------------------------------------------------------------
 //  Name : load_data ()
 /// <summary>
@@ -52,13 +67,72 @@ void save_entities_to_file(const fs::path& full_path, const std::vector<runtime:
 bool load_entities_from_file(const fs::path& full_path, std::vector<runtime::entity>& out_data);
 
 //-----------------------------------------------------------------------------
-//  Name : deserialize_data ()
+//  Name : save_entities_journal ()
 /// <summary>
-///
+/// Incremental counterpart of save_entities_to_file - writes only the
+/// given (dirty) subtrees into a sidecar journal next to the base
+/// snapshot. Serialization runs on the calling thread; the file write is
+/// pushed to a background worker. A later full save compacts the journal
+/// away. The journal cannot express deletions - force a full save when
+/// entities were removed.
+/// </summary>
+//-----------------------------------------------------------------------------
+bool save_entities_journal(const fs::path& full_path, const std::vector<runtime::entity>& data);
+
+//-----------------------------------------------------------------------------
+//  Name : discard_entities_journal ()
+/// <summary>
+/// Removes the sidecar journal of the given snapshot, if present.
 ///
 ///
 /// </summary>
 //-----------------------------------------------------------------------------
+void discard_entities_journal(const fs::path& full_path);
+
+//-----------------------------------------------------------------------------
+//  Name : deserialize_data ()
+/// <summary>
+/// Loads entities from either serialized form - a tagged binary archive
+/// (the compiled runtime artifact) or the associative one (source and
+/// meta files).
+/// </summary>
+//-----------------------------------------------------------------------------
 bool deserialize_data(std::istream& stream, std::vector<runtime::entity>& out_data);
+
+//-----------------------------------------------------------------------------
+//  Name : serialize_entities_as_binary ()
+/// <summary>
+/// Serializes entities into an in-memory tagged binary blob - the same
+/// form the compiled artifacts use, so deserialize_data decodes it
+/// through the fast dispatch path.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::string serialize_entities_as_binary(const std::vector<runtime::entity>& data);
+
+//-----------------------------------------------------------------------------
+//  Name : is_binary_entity_data ()
+/// <summary>
+/// Whether the payload begins with one of the tagged binary entity
+/// forms deserialize_data decodes directly. Compiled artifacts qualify,
+/// the associative source form does not.
+/// </summary>
+//-----------------------------------------------------------------------------
+bool is_binary_entity_data(const std::string& payload);
+
+//-----------------------------------------------------------------------------
+//  Name : resave_entities_as_binary ()
+/// <summary>
+/// Rewrites an associative (text) entity file as the tagged binary
+/// archive. Entity serialization goes through the live ecs, so the
+/// entities are instantiated only for the duration of the call and
+/// destroyed again before it returns - callers must therefore invoke
+/// this on the owner thread. 'post_load' runs on the instantiated roots
+/// before they are re-serialized, so compile steps can rewrite the
+/// entity set (e.g. static batching); entities the hook creates and
+/// parents into the roots are torn down with the rest.
+/// </summary>
+//-----------------------------------------------------------------------------
+bool resave_entities_as_binary(const fs::path& input, const fs::path& output,
+							   const std::function<void(std::vector<runtime::entity>&)>& post_load = {});
 }
 }
@@ -1,4 +1,5 @@
 #include "ecs.h"
+#include "../system/events.h"
 
 namespace runtime
 {
@@ -35,6 +36,9 @@ event<void(entity)> on_entity_destroyed;
 event<void(entity, chandle<component>)> on_component_added;
 event<void(entity, chandle<component>)> on_component_removed;
 
+const std::uint32_t component_storage::npos;
+const std::uint32_t entity_component_system::npos;
+
 component_storage::component_storage(std::size_t size)
 {
 	expand(size);
@@ -42,30 +46,65 @@ component_storage::component_storage(std::size_t size)
 
 void component_storage::expand(std::size_t n)
 {
-	data.resize(n);
+	if(sparse.size() < n)
+		sparse.resize(n, npos);
 }
 
 void component_storage::reserve(std::size_t n)
 {
 	data.reserve(n);
+	dense_to_entity.reserve(n);
+	sparse.reserve(n);
+}
+
+bool component_storage::contains(std::size_t n) const
+{
+	return n < sparse.size() && sparse[n] != npos;
 }
 
 std::shared_ptr<component> component_storage::get(std::size_t n) const
 {
-	expects(n < size());
-	return data[n];
+	expects(contains(n));
+	return data[sparse[n]];
+}
+
+component* component_storage::get_raw(std::size_t n) const
+{
+	expects(contains(n));
+	return data[sparse[n]].get();
 }
 
 void component_storage::destroy(std::size_t n)
 {
-	expects(n < size());
-	auto& element = data[n];
-	element.reset();
+	expects(contains(n));
+	const std::uint32_t slot = sparse[n];
+	const std::uint32_t last = std::uint32_t(data.size() - 1);
+	if(slot != last)
+	{
+		// Swap the last dense element into the vacated slot and patch
+		// its remap entry so the mapping stays consistent.
+		data[slot] = std::move(data[last]);
+		dense_to_entity[slot] = dense_to_entity[last];
+		sparse[dense_to_entity[slot]] = slot;
+	}
+	data.pop_back();
+	dense_to_entity.pop_back();
+	sparse[n] = npos;
 }
 
 std::weak_ptr<component> component_storage::set(unsigned int index, std::shared_ptr<component> component)
 {
-	data[index] = component;
+	expand(index + 1);
+	if(sparse[index] != npos)
+	{
+		data[sparse[index]] = component;
+	}
+	else
+	{
+		sparse[index] = std::uint32_t(data.size());
+		data.push_back(component);
+		dense_to_entity.push_back(index);
+	}
 	return component;
 }
 
@@ -97,6 +136,13 @@ void entity::destroy()
 	invalidate();
 }
 
+void entity::destroy_deferred()
+{
+	expects(valid());
+	manager_->destroy_deferred(id_);
+	invalidate();
+}
+
 std::bitset<MAX_COMPONENTS> entity::component_mask() const
 {
 	return manager_->component_mask(id_);
@@ -104,16 +150,23 @@ std::bitset<MAX_COMPONENTS> entity::component_mask() const
 
 entity_component_system::entity_component_system()
 {
+	runtime::on_frame_end.connect(this, &entity_component_system::frame_end);
 }
 
 entity_component_system::~entity_component_system()
 {
+	runtime::on_frame_end.disconnect(this, &entity_component_system::frame_end);
 	dispose();
 }
 
+void entity_component_system::frame_end(std::chrono::duration<float>)
+{
+	flush_destroyed();
+}
+
 size_t entity_component_system::size() const
 {
-	return entity_component_mask_.size() - free_list_.size();
+	return live_entities_.size();
 }
 
 size_t entity_component_system::capacity() const
@@ -146,6 +199,8 @@ entity entity_component_system::create()
 		free_list_.pop_back();
 		version = entity_version_[index];
 	}
+	live_slot_[index] = std::uint32_t(live_entities_.size());
+	live_entities_.push_back(index);
 	entity entity(this, entity::id_t(index, version));
 	on_entity_created(entity);
 	return entity;
@@ -153,7 +208,26 @@ entity entity_component_system::create()
 
 void entity_component_system::set_entity_name(entity::id_t id, std::string name)
 {
-	entity_names_[id.id()] = name;
+	auto& stored = entity_names_[id.id()];
+	if(stored == name)
+		return;
+
+	if(!stored.empty())
+	{
+		auto it = name_index_.find(stored);
+		if(it != name_index_.end())
+		{
+			auto& ids = it->second;
+			ids.erase(std::remove(std::begin(ids), std::end(ids), id.id()), std::end(ids));
+			if(ids.empty())
+				name_index_.erase(it);
+		}
+	}
+
+	if(!name.empty())
+		name_index_[name].push_back(id.id());
+
+	stored = std::move(name);
 }
 
 const std::string& entity_component_system::get_entity_name(entity::id_t id)
@@ -161,17 +235,48 @@ const std::string& entity_component_system::get_entity_name(entity::id_t id)
 	return entity_names_[id.id()];
 }
 
+entity entity_component_system::find_entity_by_name(const std::string& name)
+{
+	auto it = name_index_.find(name);
+	if(it == name_index_.end() || it->second.empty())
+		return entity();
+
+	return get(entity::id_t(it->second.front()));
+}
+
+std::vector<entity> entity_component_system::find_entities_by_name(const std::string& name)
+{
+	std::vector<entity> result;
+	auto it = name_index_.find(name);
+	if(it != name_index_.end())
+	{
+		result.reserve(it->second.size());
+		for(const auto id : it->second)
+		{
+			result.push_back(get(entity::id_t(id)));
+		}
+	}
+	return result;
+}
+
 void entity_component_system::dispose()
 {
-	for(entity entity : all_entities())
+	flush_destroyed();
+
+	// Drain the dense live array back to front - destroy() swap-and-pops
+	// the array, so iterating it with a view here would skip entries.
+	while(!live_entities_.empty())
 	{
-		entity.destroy();
+		get(create_id(live_entities_.back())).destroy();
 	}
 
 	component_pools_.clear();
 	entity_component_mask_.clear();
+	component_presence_.clear();
 	entity_version_.clear();
 	free_list_.clear();
+	live_entities_.clear();
+	live_slot_.clear();
 	index_counter_ = 0;
 }
 
@@ -191,6 +296,7 @@ void entity_component_system::remove(entity::id_t id, const rtti::type_index_seq
 	on_component_removed(get(id), handle);
 	// Remove component bit.
 	entity_component_mask_[id.index()].reset(family);
+	set_component_presence(family, id.index(), false);
 
 	// Call destructor.
 	pool->destroy(index);
@@ -258,6 +364,7 @@ chandle<component> entity_component_system::assign(entity::id_t id, std::shared_
 	auto ptr = pool.set(id.index(), comp);
 	// Set the bit for this component.
 	entity_component_mask_[id.index()].set(family);
+	set_component_presence(family, id.index(), true);
 
 	// Create and return handle.
 	comp->_entity = get(id);
@@ -269,7 +376,7 @@ chandle<component> entity_component_system::assign(entity::id_t id, std::shared_
 
 void entity_component_system::destroy(entity::id_t id)
 {
-	entity_names_[id.id()] = "";
+	set_entity_name(id, "");
 	assert_valid(id);
 	std::uint32_t index = id.index();
 	auto mask = entity_component_mask_[index];
@@ -288,8 +395,68 @@ void entity_component_system::destroy(entity::id_t id)
 
 	on_entity_destroyed(get(id));
 	entity_component_mask_[index].reset();
+	clear_component_presence(index);
 	entity_version_[index]++;
 	free_list_.push_back(index);
+	remove_live(index);
+}
+
+void entity_component_system::destroy_deferred(entity::id_t id)
+{
+	assert_valid(id);
+	const std::uint32_t index = id.index();
+
+	// Fire removal/destruction events while the entity is still intact.
+	auto mask = entity_component_mask_[index];
+	for(std::size_t i = 0; i < component_pools_.size(); ++i)
+	{
+		if(mask.test(i))
+		{
+			auto& pool = component_pools_[i];
+			if(pool)
+				on_component_removed(get(id), chandle<component>(pool->get(index)));
+		}
+	}
+	on_entity_destroyed(get(id));
+	set_entity_name(id, "");
+
+	// Invalidate up front so stale ids and cached handles fail fast.
+	entity_version_[index]++;
+	pending_destroys_.push_back(index);
+}
+
+void entity_component_system::flush_destroyed()
+{
+	// Swap the queue out first: component destructors may queue further
+	// entities (e.g. transform hierarchies tearing down children).
+	std::vector<std::uint32_t> pending;
+	std::swap(pending, pending_destroys_);
+
+	while(!pending.empty())
+	{
+		// One sweep per component type over all queued entities keeps each
+		// pool's bookkeeping hot in cache instead of hopping between pools.
+		for(std::size_t family = 0; family < component_pools_.size(); ++family)
+		{
+			auto& pool = component_pools_[family];
+			if(!pool)
+				continue;
+			for(const auto index : pending)
+			{
+				if(entity_component_mask_[index].test(family))
+					pool->destroy(index);
+			}
+		}
+		for(const auto index : pending)
+		{
+			entity_component_mask_[index].reset();
+			clear_component_presence(index);
+			free_list_.push_back(index);
+			remove_live(index);
+		}
+		pending.clear();
+		std::swap(pending, pending_destroys_);
+	}
 }
 
 entity entity_component_system::get(entity::id_t id)
@@ -303,6 +470,19 @@ entity::id_t entity_component_system::create_id(uint32_t index) const
 	return entity::id_t(index, entity_version_[index]);
 }
 
+void entity_component_system::remove_live(std::uint32_t index)
+{
+	const std::uint32_t pos = live_slot_[index];
+	const std::uint32_t last = std::uint32_t(live_entities_.size() - 1);
+	if(pos != last)
+	{
+		live_entities_[pos] = live_entities_[last];
+		live_slot_[live_entities_[pos]] = pos;
+	}
+	live_entities_.pop_back();
+	live_slot_[index] = npos;
+}
+
 component::~component()
 {
 }
@@ -2,12 +2,15 @@
 
 #include "core/common/assert.hpp"
 #include "core/common/nonstd/type_traits.hpp"
+#include "core/memory/memory_tracker.h"
+#include "core/memory/pool_allocator.h"
 #include "core/reflection/registration.h"
 #include "core/serialization/serialization.h"
 #include "core/signals/event.hpp"
 
 #include <algorithm>
 #include <bitset>
+#include <chrono>
 #include <cstdint>
 #include <cstdlib>
 #include <functional>
@@ -36,12 +39,37 @@ std::uint64_t get_frame();
 
 static const std::size_t MAX_COMPONENTS = 128;
 
+/// Index of the lowest set bit in a non-zero 64 bit word.
+inline std::uint32_t bit_scan_forward(std::uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return std::uint32_t(__builtin_ctzll(word));
+#else
+	std::uint32_t bit = 0;
+	while((word & 1u) == 0)
+	{
+		word >>= 1;
+		++bit;
+	}
+	return bit;
+#endif
+}
+
 class component;
+
+/// Per-type component pool. Components are kept densely packed so that
+/// iteration over a single type walks contiguous memory, while a sparse
+/// index remap keeps lookups by entity index O(1). Removal swaps the last
+/// dense element into the vacated slot and patches the remap, so dense
+/// order is unstable but the mapping always is.
 class component_storage
 {
 public:
+	static const std::uint32_t npos = 0xffffffff;
+
 	component_storage(std::size_t size = 100);
 
+	/// Number of live components in the pool.
 	inline std::size_t size() const
 	{
 		return data.size();
@@ -50,9 +78,10 @@ public:
 	{
 		return data.capacity();
 	}
-	/// Ensure at least n elements will fit in the pool.
+	/// Ensure entity indices up to n will fit in the sparse remap.
 	void expand(std::size_t n);
 	void reserve(std::size_t n);
+	bool contains(std::size_t n) const;
 	std::shared_ptr<component> get(std::size_t n) const;
 
 	template <typename T>
@@ -63,20 +92,45 @@ public:
 		return std::static_pointer_cast<T>(get(n));
 	}
 
+	/// Raw, non-owning access. The pointer stays valid until the component
+	/// is removed from the pool; no refcount traffic is involved.
+	component* get_raw(std::size_t n) const;
+
 	void destroy(std::size_t n);
 
 	template <typename T, typename... Args>
 	std::weak_ptr<T> set(unsigned int index, Args&&... args)
 	{
-		auto element = std::make_shared<T>(std::forward<Args>(args)...);
-		data[index] = std::move(element);
-		return std::static_pointer_cast<T>(data[index]);
+		// allocate_shared puts the component and its control block into the
+		// per-type pool, so spawning waves of components stays off malloc.
+		auto element = std::allocate_shared<T>(
+			memory::tracking_allocator<T, memory::pool_allocator<T>>{"ecs/components"},
+			std::forward<Args>(args)...);
+		return std::static_pointer_cast<T>(set(index, std::move(element)).lock());
 	}
 
 	std::weak_ptr<component> set(unsigned int index, std::shared_ptr<component> component);
 
+	/// Densely packed components, in no particular order. Safe to walk
+	/// linearly as long as nothing is added to or removed from the pool.
+	inline const std::vector<std::shared_ptr<component>>& dense() const
+	{
+		return data;
+	}
+
+	/// Entity index owning the component at the given dense slot.
+	inline std::uint32_t entity_index(std::size_t dense_index) const
+	{
+		return dense_to_entity[dense_index];
+	}
+
 private:
+	/// Densely packed component instances.
 	std::vector<std::shared_ptr<component>> data;
+	/// Entity index for each dense slot.
+	std::vector<std::uint32_t> dense_to_entity;
+	/// Entity index -> dense slot, npos if the entity has no component here.
+	std::vector<std::uint32_t> sparse;
 };
 
 class entity_component_system;
@@ -242,6 +296,14 @@ public:
 	 * Destroy and invalidate this entity.
 	 */
 	void destroy();
+
+	/**
+	 * Queue this entity for destruction at the end of the frame and
+	 * invalidate this handle. The entity's version is bumped immediately so
+	 * every outstanding handle fails fast; component teardown happens in
+	 * one batched sweep per component type.
+	 */
+	void destroy_deferred();
 	std::bitset<MAX_COMPONENTS> component_mask() const;
 
 private:
@@ -249,6 +311,41 @@ private:
 	entity_component_system* manager_ = nullptr;
 };
 
+/// Lightweight generation-checked component handle. Unlike chandle (a
+/// weak_ptr), validity is an index/version compare against the owning
+/// entity slot - no atomic refcount traffic - and access hands back a raw
+/// pointer. Safe to cache across frames in hot render paths: if the
+/// entity slot is reused or the component removed, get() returns nullptr.
+template <typename C>
+class component_handle
+{
+public:
+	component_handle() = default;
+	component_handle(entity_component_system* manager, entity::id_t id)
+		: manager_(manager)
+		, id_(id)
+	{
+	}
+
+	bool valid() const;
+	explicit operator bool() const
+	{
+		return valid();
+	}
+
+	/// Raw component access, nullptr if the handle went stale.
+	C* get() const;
+
+	entity::id_t id() const
+	{
+		return id_;
+	}
+
+private:
+	entity_component_system* manager_ = nullptr;
+	entity::id_t id_ = entity::INVALID;
+};
+
 class component : public std::enable_shared_from_this<component>
 {
 	REFLECTABLEV(component)
@@ -318,6 +415,19 @@ public:
 		return _last_touched >= static_cast<std::uint32_t>(ecs::get_frame());
 	}
 
+	//-----------------------------------------------------------------------------
+	//  Name : get_last_touched ()
+	/// <summary>
+	/// Frame the component was last touched on.
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::uint32_t get_last_touched() const
+	{
+		return _last_touched;
+	}
+
 	//-----------------------------------------------------------------------------
 	//  Name : on_entity_set (virtual )
 	/// <summary>
@@ -455,13 +565,31 @@ public:
 				std::sort(manager_->free_list_.begin(), manager_->free_list_.end());
 				free_cursor_ = 0;
 			}
+			else
+			{
+				for(std::size_t family = 0; family < MAX_COMPONENTS; ++family)
+				{
+					if(mask_[family])
+						families_.push_back(family);
+				}
+			}
 		}
 
 		void next()
 		{
-			while(i_ < capacity_ && !predicate())
+			if(!All && !families_.empty())
 			{
-				++i_;
+				// Intersect the queried families' presence bitmaps so that
+				// runs of non-matching entities are skipped 64 slots at a
+				// time instead of being tested one mask at a time.
+				i_ = manager_->next_masked_index(families_, i_, std::uint32_t(capacity_));
+			}
+			else
+			{
+				while(i_ < capacity_ && !predicate())
+				{
+					++i_;
+				}
 			}
 
 			if(i_ < capacity_)
@@ -489,6 +617,8 @@ public:
 
 		entity_component_system* manager_;
 		component_mask_t mask_;
+		/// Set bit positions of mask_, driving the word-level skip path.
+		std::vector<std::size_t> families_;
 		std::uint32_t i_;
 		size_t capacity_;
 		size_t free_cursor_;
@@ -579,6 +709,88 @@ public:
 	template <typename... Components>
 	using View = typed_view<false, Components...>;
 
+	/// Iterates the dense array of live entity slots, maintained with
+	/// slot_map style swap-and-pop bookkeeping. Cost tracks the live entity
+	/// count instead of the table's high-water mark, so iteration no longer
+	/// degrades on tables left sparse by churn.
+	class live_view
+	{
+	public:
+		class iterator_type : public std::iterator<std::input_iterator_tag, entity>
+		{
+		public:
+			iterator_type(entity_component_system* manager, std::size_t pos)
+				: manager_(manager)
+				, pos_(pos)
+			{
+			}
+
+			iterator_type& operator++()
+			{
+				++pos_;
+				return *this;
+			}
+			bool operator==(const iterator_type& rhs) const
+			{
+				return pos_ == rhs.pos_;
+			}
+			bool operator!=(const iterator_type& rhs) const
+			{
+				return pos_ != rhs.pos_;
+			}
+			entity operator*() const
+			{
+				const auto index = manager_->live_entities_[pos_];
+				return entity(manager_, manager_->create_id(index));
+			}
+
+		private:
+			entity_component_system* manager_;
+			std::size_t pos_;
+		};
+
+		iterator_type begin() const
+		{
+			return iterator_type(manager_, 0);
+		}
+		iterator_type end() const
+		{
+			return iterator_type(manager_, manager_->live_entities_.size());
+		}
+
+	private:
+		friend class entity_component_system;
+
+		explicit live_view(entity_component_system* manager)
+			: manager_(manager)
+		{
+		}
+
+		entity_component_system* manager_;
+	};
+
+	/// A group of entities sharing an identical component mask. Component
+	/// access goes through densely packed arrays of raw pointers, so systems
+	/// pay no per-entity mask tests or weak_ptr locks while iterating. The
+	/// arrays are a snapshot: they stay valid until a component is added to
+	/// or removed from one of the participating pools.
+	template <typename... Components>
+	struct chunk
+	{
+		template <typename C>
+		const std::vector<C*>& get() const
+		{
+			return std::get<std::vector<C*>>(arrays);
+		}
+
+		/// Shared component mask of every entity in this chunk.
+		component_mask_t mask;
+		/// Entities in the chunk, parallel to the component arrays.
+		std::vector<entity> entities;
+		/// Raw component pointers, one array per requested type.
+		std::tuple<std::vector<Components*>...> arrays;
+	};
+
 	template <typename... Components>
 	class unpacking_view
 	{
@@ -700,6 +912,22 @@ public:
 	 */
 	void destroy(entity::id_t id);
 
+	/**
+	 * Queue an entity::Id for destruction at the end of the frame.
+	 *
+	 * Destruction events fire immediately and the version is bumped so the
+	 * id (and every component_handle built from it) goes stale right away,
+	 * but component storage is only released by flush_destroyed, which
+	 * sweeps all queued entities per component type in one pass.
+	 */
+	void destroy_deferred(entity::id_t id);
+
+	/**
+	 * Release components and entity slots of everything queued through
+	 * destroy_deferred. Runs automatically on on_frame_end.
+	 */
+	void flush_destroyed();
+
 	entity get(entity::id_t id);
 
 	/**
@@ -722,7 +950,10 @@ public:
 	chandle<C> assign(entity::id_t id, Args&&... args)
 	{
 		return std::static_pointer_cast<C>(
-			assign(id, std::make_shared<C>(std::forward<Args>(args)...)).lock());
+			assign(id, std::allocate_shared<C>(
+						   memory::tracking_allocator<C, memory::pool_allocator<C>>{"ecs/components"},
+						   std::forward<Args>(args)...))
+				.lock());
 	}
 
 	chandle<component> assign(entity::id_t id, std::shared_ptr<component> comp);
@@ -773,6 +1004,35 @@ public:
 		return chandle<C>(pool->template get<C>(id.index()));
 	}
 
+	/**
+	 * Retrieve a raw pointer to a component assigned to an entity::Id.
+	 *
+	 * Unlike get_component this also tolerates stale ids and involves no
+	 * shared_ptr traffic, which is what component_handle::get relies on.
+	 *
+	 * @returns Pointer to an instance of C, or nullptr if the id is stale
+	 * or the entity does not have that component.
+	 */
+	template <typename C>
+	C* get_component_raw(entity::id_t id)
+	{
+		if(!valid(id))
+			return nullptr;
+		auto family = rtti::type_index_sequential_t::id<component, C>();
+		if(family >= component_pools_.size())
+			return nullptr;
+		auto& pool = component_pools_[family];
+		if(!pool || !entity_component_mask_[id.index()][family])
+			return nullptr;
+		return static_cast<C*>(pool->get_raw(id.index()));
+	}
+
+	template <typename C>
+	component_handle<C> get_component_handle(entity::id_t id)
+	{
+		return component_handle<C>(this, id);
+	}
+
 	template <typename... Components>
 	std::tuple<chandle<Components>...> components(entity::id_t id)
 	{
@@ -813,6 +1073,71 @@ public:
 		return entities_with_components<Components...>().for_each(f);
 	}
 
+	/**
+	 * Group entities that have all of the specified Components into chunks
+	 * of identical component masks. The smallest participating pool is
+	 * walked densely and each matching entity is bucketed once, so the
+	 * per-entity cost during system iteration is a plain array access.
+	 *
+	 * @code
+	 * for (const auto& chunk : ecs.chunked_entities_with_components<transform_component>()) {
+	 *   const auto& transforms = chunk.get<transform_component>();
+	 *   for (std::size_t i = 0; i < chunk.entities.size(); ++i)
+	 *     transforms[i]->...;
+	 * }
+	 * @endcode
+	 */
+	template <typename... Components>
+	std::vector<chunk<Components...>> chunked_entities_with_components()
+	{
+		std::vector<chunk<Components...>> chunks;
+		const auto mask = component_mask<Components...>();
+		const component_storage* smallest = nullptr;
+		for(auto family : {rtti::type_index_sequential_t::id<component, Components>()...})
+		{
+			if(family >= component_pools_.size() || !component_pools_[family])
+				return chunks;
+			const auto* pool = component_pools_[family].get();
+			if(!smallest || pool->size() < smallest->size())
+				smallest = pool;
+		}
+
+		const auto& dense = smallest->dense();
+		for(std::size_t i = 0; i < dense.size(); ++i)
+		{
+			const auto index = smallest->entity_index(i);
+			const auto& entity_mask = entity_component_mask_[index];
+			if((entity_mask & mask) != mask)
+				continue;
+
+			chunk<Components...>* bucket = nullptr;
+			for(auto& existing : chunks)
+			{
+				if(existing.mask == entity_mask)
+				{
+					bucket = &existing;
+					break;
+				}
+			}
+			if(!bucket)
+			{
+				chunks.emplace_back();
+				bucket = &chunks.back();
+				bucket->mask = entity_mask;
+			}
+
+			bucket->entities.push_back(get(create_id(index)));
+			auto fill = {(std::get<std::vector<Components*>>(bucket->arrays)
+							  .push_back(static_cast<Components*>(
+								  component_pools_[rtti::type_index_sequential_t::id<
+													   component, Components>()]
+									  ->get_raw(index))),
+						 0)...};
+			(void)fill;
+		}
+		return chunks;
+	}
+
 	/**
 	 * Find Entities that have all of the specified Components and assign them
 	 * to the given parameters.
@@ -834,16 +1159,19 @@ public:
 	}
 
 	/**
-	 * Iterate over all *valid* entities (ie. not in the free list). Not fast
+	 * Iterate over all *valid* entities (ie. not in the free list).
+	 *
+	 * Walks the contiguous live-entity array, so the cost is proportional
+	 * to the number of live entities rather than the table capacity.
 	 *
 	 * @code
 	 * for (entity entity : entity_manager.all_entities()) {}
 	 *
 	 * @return An iterator view over all valid entities.
 	 */
-	base_view<true> all_entities()
+	live_view all_entities()
 	{
-		return base_view<true>(this);
+		return live_view(this);
 	}
 
 	template <typename C>
@@ -880,8 +1208,26 @@ public:
 	void set_entity_name(entity::id_t id, std::string name);
 	const std::string& get_entity_name(entity::id_t id);
 
+	/**
+	 * Finds the first live entity carrying the given name. Backed by a
+	 * name -> id hash index maintained on rename and destroy, so the
+	 * cost does not scale with the entity count. Returns an invalid
+	 * entity when no match exists.
+	 */
+	entity find_entity_by_name(const std::string& name);
+
+	/**
+	 * Gathers every live entity carrying the given name. Names are not
+	 * required to be unique.
+	 */
+	std::vector<entity> find_entities_by_name(const std::string& name);
+
 private:
 	friend class entity;
+	template <typename... Components>
+	friend class cached_query;
+
+	void frame_end(std::chrono::duration<float> dt);
 
 	inline void assert_valid(entity::id_t id) const
 	{
@@ -927,12 +1273,92 @@ private:
 		return component_mask<C1, Components...>();
 	}
 
+	/**
+	 * Find the next entity index at or after start that carries every one of
+	 * the given component families, or capacity if there is none.
+	 *
+	 * Works on the per-family presence bitmaps: one 64 bit word per family is
+	 * intersected per step, so a zero intersection rules out 64 entity slots
+	 * with a handful of loads. Sparse queries therefore cost O(matches)
+	 * rather than O(capacity).
+	 */
+	std::uint32_t next_masked_index(const std::vector<std::size_t>& families, std::uint32_t start,
+									std::uint32_t capacity) const
+	{
+		for(const auto family : families)
+		{
+			// A family that never had a component assigned can never match.
+			if(family >= component_presence_.size())
+				return capacity;
+		}
+
+		std::uint32_t i = start;
+		while(i < capacity)
+		{
+			const std::size_t word_index = i >> 6;
+			// Mask off the slots below the current position up front.
+			std::uint64_t word = ~std::uint64_t(0) << (i & 63);
+			for(const auto family : families)
+			{
+				const auto& bitmap = component_presence_[family];
+				word &= word_index < bitmap.size() ? bitmap[word_index] : 0;
+			}
+			if(word == 0)
+			{
+				i = std::uint32_t((word_index + 1) << 6);
+				continue;
+			}
+
+			const auto found = std::uint32_t((word_index << 6) + bit_scan_forward(word));
+			return found < capacity ? found : capacity;
+		}
+		return capacity;
+	}
+
+	/// Mirror a component mask bit into the family's presence bitmap. Both
+	/// the family list and each bitmap grow lazily on first use.
+	inline void set_component_presence(rtti::type_index_sequential_t::index_t family, std::uint32_t index,
+									   bool present)
+	{
+		if(component_presence_.size() <= family)
+			component_presence_.resize(family + 1);
+
+		auto& bitmap = component_presence_[family];
+		const std::size_t word = index >> 6;
+		if(bitmap.size() <= word)
+		{
+			if(!present)
+				return;
+			bitmap.resize(word + 1, 0);
+		}
+
+		const std::uint64_t bit = std::uint64_t(1) << (index & 63);
+		if(present)
+			bitmap[word] |= bit;
+		else
+			bitmap[word] &= ~bit;
+	}
+
+	/// Clear the entity's bit in every presence bitmap; pairs with the full
+	/// component mask reset on entity destruction.
+	inline void clear_component_presence(std::uint32_t index)
+	{
+		const std::size_t word = index >> 6;
+		const std::uint64_t bit = std::uint64_t(1) << (index & 63);
+		for(auto& bitmap : component_presence_)
+		{
+			if(word < bitmap.size())
+				bitmap[word] &= ~bit;
+		}
+	}
+
 	inline void accomodate_entity(std::uint32_t index)
 	{
 		if(entity_component_mask_.size() <= index)
 		{
 			entity_component_mask_.resize(index + 1);
 			entity_version_.resize(index + 1);
+			live_slot_.resize(index + 1, npos);
 			for(auto& pool : component_pools_)
 			{
 				if(pool)
@@ -964,6 +1390,12 @@ private:
 		return *component_pools_[family].get();
 	}
 
+	/// Marker for entity slots absent from the dense live array.
+	static const std::uint32_t npos = 0xffffffff;
+
+	/// Swap-and-pop the given entity index out of the dense live array.
+	void remove_live(std::uint32_t index);
+
 	std::uint32_t index_counter_ = 0;
 
 	// Each element in component_pools_ corresponds to a Pool for a component.
@@ -972,13 +1404,29 @@ private:
 	// Bitmask of components associated with each entity. Index into the vector is
 	// the entity::Id.
 	std::vector<component_mask_t> entity_component_mask_;
+	// Transposed view of the masks: one bitmap per component family with one
+	// bit per entity index, packed into 64 bit words. Lets queries intersect
+	// words and skip 64 non-matching entities at a time.
+	std::vector<std::vector<std::uint64_t>> component_presence_;
 	// Vector of entity version numbers. Incremented each time an entity is
 	// destroyed
 	std::vector<std::uint32_t> entity_version_;
 	// List of available entity slots.
 	std::vector<std::uint32_t> free_list_;
+	// slot_map style dense bookkeeping of the live entity slots.
+	// live_entities_ is the contiguous iterable backing array, live_slot_
+	// maps an entity index to its dense position (npos while free).
+	std::vector<std::uint32_t> live_entities_;
+	std::vector<std::uint32_t> live_slot_;
+	// Entity slots queued by destroy_deferred, swept by flush_destroyed.
+	std::vector<std::uint32_t> pending_destroys_;
 
 	std::unordered_map<std::uint64_t, std::string> entity_names_;
+
+	// Reverse lookup over entity_names_ so find-by-name stays O(1) in the
+	// entity count. Names are not unique - each bucket keeps every id that
+	// currently carries the name.
+	std::unordered_map<std::string, std::vector<std::uint64_t>> name_index_;
 };
 
 template <typename C, typename... Args>
@@ -1060,6 +1508,102 @@ inline bool entity::valid() const
 	return manager_ && manager_->valid(id_);
 }
 
+/// Persistent query over entities carrying all of the given Components.
+/// Instead of rescanning the whole entity range per frame, the matching
+/// list is maintained incrementally from the component add/remove and
+/// entity destruction events, so steady-state cost is proportional to the
+/// number of changes. Component removals are reconciled lazily on the
+/// next entities() call, since the removal event fires before the mask is
+/// updated.
+template <typename... Components>
+class cached_query
+{
+public:
+	explicit cached_query(entity_component_system& manager)
+		: manager_(&manager)
+	{
+		mask_ = manager.component_mask<Components...>();
+		on_component_added.connect(this, &cached_query::component_added);
+		on_component_removed.connect(this, &cached_query::component_removed);
+		on_entity_destroyed.connect(this, &cached_query::entity_destroyed);
+
+		for(auto entity : manager.entities_with_components<Components...>())
+		{
+			insert(entity);
+		}
+	}
+
+	~cached_query()
+	{
+		on_component_added.disconnect(this, &cached_query::component_added);
+		on_component_removed.disconnect(this, &cached_query::component_removed);
+		on_entity_destroyed.disconnect(this, &cached_query::entity_destroyed);
+	}
+
+	cached_query(const cached_query&) = delete;
+	cached_query& operator=(const cached_query&) = delete;
+
+	/// Current matching entities. Reconciles any pending removals first.
+	const std::vector<entity>& entities()
+	{
+		for(auto entity : pending_)
+		{
+			if(!entity.valid() || (entity.component_mask() & mask_) != mask_)
+				erase(entity);
+		}
+		pending_.clear();
+		return entities_;
+	}
+
+private:
+	void component_added(entity e, chandle<component>)
+	{
+		if((e.component_mask() & mask_) == mask_)
+			insert(e);
+	}
+
+	void component_removed(entity e, chandle<component>)
+	{
+		// The mask bit is still set at this point; check again lazily.
+		pending_.push_back(e);
+	}
+
+	void entity_destroyed(entity e)
+	{
+		erase(e);
+	}
+
+	void insert(entity e)
+	{
+		if(std::find(std::begin(entities_), std::end(entities_), e) == std::end(entities_))
+			entities_.push_back(e);
+	}
+
+	void erase(entity e)
+	{
+		entities_.erase(std::remove(std::begin(entities_), std::end(entities_), e), std::end(entities_));
+	}
+
+	entity_component_system* manager_;
+	entity_component_system::component_mask_t mask_;
+	std::vector<entity> entities_;
+	std::vector<entity> pending_;
+};
+
+template <typename C>
+inline C* component_handle<C>::get() const
+{
+	if(!manager_)
+		return nullptr;
+	return manager_->get_component_raw<C>(id_);
+}
+
+template <typename C>
+inline bool component_handle<C>::valid() const
+{
+	return get() != nullptr;
+}
+
 inline std::ostream& operator<<(std::ostream& out, const entity::id_t& id)
 {
 	out << id.index();
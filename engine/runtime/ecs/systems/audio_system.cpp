@@ -3,31 +3,225 @@
 #include "../components/audio_listener_component.h"
 #include "../components/audio_source_component.h"
 #include "../components/transform_component.h"
+#include "core/audio/device.h"
+#include "core/audio/source.h"
 #include "core/system/subsystem.h"
+#include "system_scheduler.h"
+
+#include <algorithm>
 
 namespace runtime
 {
+namespace
+{
+/// sources outside their attenuation range tick at this frame interval
+/// instead of every frame - their upkeep is all bookkeeping, nothing is
+/// audible
+const std::uint32_t low_rate_interval = 15;
+/// beyond this multiple of the max range the source freezes entirely
+/// until the listener approaches
+const float frozen_tier_ratio = 2.0f;
+}
+
 void audio_system::frame_update(std::chrono::duration<float> dt)
 {
 	auto& ecs = core::get_subsystem<entity_component_system>();
+	const auto frame = static_cast<std::uint32_t>(runtime::ecs::get_frame());
 
-	ecs.for_each<transform_component, audio_source_component>(
-		[](entity e, transform_component& transform, audio_source_component& source) {
-			source.update(transform.get_transform());
-		});
+	math::vec3 listener_position{0.0f, 0.0f, 0.0f};
+	bool has_listener = false;
 	ecs.for_each<transform_component, audio_listener_component>(
-		[](entity e, transform_component& transform, audio_listener_component& listener) {
-			listener.update(transform.get_transform());
+		[&](entity e, transform_component& transform, audio_listener_component& listener) {
+			// only redo the listener math when the transform moved since
+			// the last push to the device
+			if(transform.get_last_touched() >= _last_listener_update_frame)
+			{
+				listener.update(transform.get_transform());
+			}
+			if(!has_listener)
+			{
+				listener_position = transform.get_transform().get_position();
+				has_listener = true;
+			}
 		});
+	_last_listener_update_frame = frame;
+
+	// Rank every active source by how audible it is - distance to the
+	// listener relative to its max range, biased by its priority - and
+	// grant the fixed voice budget to the best ranked. The rest keep
+	// playing virtually: their playback position still advances, and
+	// they pick a real voice back up the moment they rank inside the
+	// budget again.
+	struct candidate_t
+	{
+		audio_source_component* source = nullptr;
+		float score = 0.0f;
+		bool audible = false;
+	};
+	std::vector<candidate_t> candidates;
+
+	ecs.for_each<transform_component, audio_source_component>(
+		[&](entity e, transform_component& transform, audio_source_component& source) {
+			if(!source.is_active())
+			{
+				if(source.has_voice())
+				{
+					recycle_voice(source.demote_voice());
+				}
+				return;
+			}
+
+			float distance_ratio = 0.0f;
+			const auto& range = source.get_range();
+			if(has_listener && range.max > 0.0f)
+			{
+				const auto position = transform.get_transform().get_position();
+				distance_ratio = math::distance(listener_position, position) / range.max;
+			}
+			const bool audible = distance_ratio <= 1.0f;
+
+			// tiered upkeep - inaudible virtual sources tick at a low
+			// rate, staggered across frames by entity so they don't all
+			// land on the same one, and far-out ones freeze entirely
+			// until the listener approaches. The skipped time is banked
+			// and delivered in one lump on the next real update.
+			if(!audible && !source.has_voice())
+			{
+				const bool frozen = distance_ratio > frozen_tier_ratio;
+				if(frozen || (frame + e.id().index()) % low_rate_interval != 0)
+				{
+					source.defer_update(dt);
+					return;
+				}
+			}
+
+			source.update(transform.get_transform(), dt);
+
+			if(!source.is_active())
+			{
+				if(source.has_voice())
+				{
+					recycle_voice(source.demote_voice());
+				}
+				return;
+			}
+
+			candidate_t candidate;
+			candidate.source = &source;
+			candidate.audible = audible;
+			candidate.score = distance_ratio - source.get_priority();
+			candidates.push_back(candidate);
+		});
+
+	std::sort(std::begin(candidates), std::end(candidates),
+			  [](const candidate_t& lhs, const candidate_t& rhs) { return lhs.score < rhs.score; });
+
+	// demotions first so the freed voices can go to better candidates
+	std::size_t granted = 0;
+	for(auto& candidate : candidates)
+	{
+		candidate.audible = candidate.audible && granted < max_voices;
+		if(candidate.audible)
+		{
+			++granted;
+		}
+		else if(candidate.source->has_voice())
+		{
+			recycle_voice(candidate.source->demote_voice());
+		}
+	}
+
+	for(auto& candidate : candidates)
+	{
+		if(candidate.audible && !candidate.source->has_voice())
+		{
+			candidate.source->promote_voice(acquire_voice());
+		}
+	}
+
+	// everything latched above - positions, gains, promotions - goes to
+	// openal in one batched submit
+	if(core::has_subsystems<audio::device>())
+	{
+		core::get_subsystem<audio::device>().submit_deferred();
+	}
+}
+
+std::shared_ptr<audio::source> audio_system::acquire_voice()
+{
+	prune_lent_voices();
+
+	std::shared_ptr<audio::source> voice;
+	if(!_free_voices.empty())
+	{
+		voice = std::move(_free_voices.back());
+		_free_voices.pop_back();
+	}
+	else if(_lent_voices.size() < max_voices)
+	{
+		voice = std::make_shared<audio::source>();
+	}
+
+	if(voice)
+	{
+		_lent_voices.emplace_back(voice);
+	}
+	return voice;
+}
+
+void audio_system::recycle_voice(std::shared_ptr<audio::source> voice)
+{
+	if(!voice)
+	{
+		return;
+	}
+
+	voice->stop();
+
+	_lent_voices.erase(std::remove_if(std::begin(_lent_voices), std::end(_lent_voices),
+									  [&voice](const std::weak_ptr<audio::source>& lent) {
+										  return lent.expired() || lent.lock() == voice;
+									  }),
+					   std::end(_lent_voices));
+
+	_free_voices.push_back(std::move(voice));
+}
+
+void audio_system::prune_lent_voices()
+{
+	_lent_voices.erase(std::remove_if(std::begin(_lent_voices), std::end(_lent_voices),
+									  [](const std::weak_ptr<audio::source>& lent) {
+										  return lent.expired();
+									  }),
+					   std::end(_lent_voices));
 }
 
 audio_system::audio_system()
 {
-	on_frame_update.connect(this, &audio_system::frame_update);
+	if(core::has_subsystems<system_scheduler>())
+	{
+		system_scheduler::system_desc desc;
+		desc.name = "audio_system";
+		desc.reads = system_scheduler::make_mask<transform_component>();
+		desc.writes = system_scheduler::make_mask<audio_source_component, audio_listener_component>();
+		desc.on_update = [this](std::chrono::duration<float> dt) { frame_update(dt); };
+		core::get_subsystem<system_scheduler>().register_system(std::move(desc));
+	}
+	else
+	{
+		on_frame_update.connect(this, &audio_system::frame_update);
+	}
 }
 
 audio_system::~audio_system()
 {
-	on_frame_update.disconnect(this, &audio_system::frame_update);
+	if(core::has_subsystems<system_scheduler>())
+	{
+		core::get_subsystem<system_scheduler>().unregister_system("audio_system");
+	}
+	else
+	{
+		on_frame_update.disconnect(this, &audio_system::frame_update);
+	}
 }
 }
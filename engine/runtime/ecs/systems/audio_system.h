@@ -1,6 +1,15 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace audio
+{
+class source;
+}
 
 namespace runtime
 {
@@ -18,5 +27,41 @@ public:
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	void frame_update(std::chrono::duration<float> dt);
+
+	//-----------------------------------------------------------------------------
+	//  Name : acquire_voice ()
+	/// <summary>
+	/// Hands out a real source from the fixed voice pool, reusing a
+	/// recycled one when available - source creation is costly. Returns
+	/// null when the whole budget is lent out; the caller then plays on
+	/// virtually until the ranking promotes it.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::shared_ptr<audio::source> acquire_voice();
+
+	//-----------------------------------------------------------------------------
+	//  Name : recycle_voice ()
+	/// <summary>
+	/// Returns a lent voice to the pool for reuse.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void recycle_voice(std::shared_ptr<audio::source> voice);
+
+	/// ceiling of simultaneously real (hardware) voices
+	static const std::size_t max_voices = 24;
+
+private:
+	void prune_lent_voices();
+
+	/// stopped sources kept around for reuse
+	std::vector<std::shared_ptr<audio::source>> _free_voices;
+
+	/// voices currently lent out - weak so a holder destroyed with its
+	/// voice frees that slot of the budget again
+	std::vector<std::weak_ptr<audio::source>> _lent_voices;
+
+	/// frame of the last listener push to the audio device - listener
+	/// math is only redone when the transform was touched since
+	std::uint32_t _last_listener_update_frame = 0;
 };
 }
@@ -4,7 +4,10 @@
 #include "../../system/events.h"
 #include "../components/model_component.h"
 #include "../components/transform_component.h"
+#include "core/profiler/profiler.h"
 #include "core/system/subsystem.h"
+#include "core/tasks/parallel_for.h"
+#include "system_scheduler.h"
 
 namespace runtime
 {
@@ -66,45 +69,129 @@ get_transforms_for_bones(const std::vector<runtime::entity>& bone_entities)
 
 void bone_system::frame_update(std::chrono::duration<float> dt)
 {
+	PROFILE_SCOPE("bone_system/frame_update");
+
 	auto& ecs = core::get_subsystem<runtime::entity_component_system>();
-	ecs.for_each<model_component>([&ecs](runtime::entity e, model_component& model_comp) {
 
-		const auto& model = model_comp.get_model();
-		auto mesh = model.get_lod(0);
+	// Per-entity palette work, prepared serially below. Bone entity
+	// creation and world transform resolution both mutate shared ecs
+	// state so they stay on this thread; the palette matrix math only
+	// reads the gathered transforms and writes the entity's own
+	// skinning buffers, so it fans out across the workers.
+	struct palette_job
+	{
+		model_component* model = nullptr;
+		asset_handle<mesh> lod;
+		std::vector<math::transform> transforms;
+	};
+	std::vector<palette_job> jobs;
+
+	// Chunked iteration hands us packed raw pointers, so we avoid a mask
+	// test and a weak_ptr lock per entity.
+	auto chunks = ecs.chunked_entities_with_components<model_component>();
+	for(const auto& chunk : chunks)
+	{
+		const auto& models = chunk.get<model_component>();
+		for(std::size_t i = 0; i < chunk.entities.size(); ++i)
+		{
+			auto e = chunk.entities[i];
+			auto& model_comp = *models[i];
+
+			const auto& model = model_comp.get_model();
+			auto mesh = model.get_lod(0);
+
+			// If mesh isnt loaded yet skip it.
+			if(!mesh)
+				continue;
+
+			const auto& skin_data = mesh->get_skin_bind_data();
 
-		// If mesh isnt loaded yet skip it.
-		if(!mesh)
-			return;
+			// Has skinning data?
+			if(skin_data.has_bones())
+			{
+				if(model_comp.get_bone_entities().size() <= 1)
+				{
+					const auto& armature = mesh->get_armature();
+					std::vector<runtime::entity> be;
+					process_node(armature, skin_data, e, be, ecs);
+					model_comp.set_bone_entities(be);
+					model_comp.set_static(false);
+				}
 
-		const auto& skin_data = mesh->get_skin_bind_data();
+				palette_job job;
+				job.model = &model_comp;
+				job.lod = mesh;
+				job.transforms = get_transforms_for_bones(model_comp.get_bone_entities());
+				jobs.push_back(std::move(job));
+			}
+		}
+	}
 
-		// Has skinning data?
-		if(skin_data.has_bones())
+	if(jobs.empty())
+		return;
+
+	// Resolve the final palette matrices once here instead of in every
+	// render pass; shadow, reflection and camera passes all reuse them
+	// (and the transform cache entries the first pass records) without
+	// redoing the matrix math per palette. Entities are independent, so
+	// the jobs spread over the workers.
+	auto evaluate_range = [&jobs](std::size_t begin, std::size_t end) {
+		for(std::size_t j = begin; j < end; ++j)
 		{
-			if(model_comp.get_bone_entities().size() <= 1)
+			auto& job = jobs[j];
+			const auto& skin_data = job.lod->get_skin_bind_data();
+			const auto& palettes = job.lod->get_bone_palettes();
+			auto& skinning = job.model->get_skinning_data();
+			skinning.palettes.resize(palettes.size());
+			for(std::size_t p = 0; p < palettes.size(); ++p)
 			{
-				const auto& armature = mesh->get_armature();
-				std::vector<runtime::entity> be;
-				process_node(armature, skin_data, e, be, ecs);
-				model_comp.set_bone_entities(be);
-				model_comp.set_static(false);
+				skinning.palettes[p] =
+					palettes[p].get_skinning_matrices(job.transforms, skin_data, false);
 			}
+			// Uploads from previous frames are stale now.
+			skinning.transform_caches.clear();
 
-			const auto& bone_entities = model_comp.get_bone_entities();
-			auto transforms = get_transforms_for_bones(bone_entities);
-			model_comp.set_bone_transforms(std::move(transforms));
+			job.model->set_bone_transforms(std::move(job.transforms));
 		}
+	};
 
-	});
+	if(core::has_subsystems<core::task_system>())
+	{
+		auto& tasks = core::get_subsystem<core::task_system>();
+		core::parallel_for(tasks, 0, jobs.size(), 0, evaluate_range);
+	}
+	else
+	{
+		evaluate_range(0, jobs.size());
+	}
 }
 
 bone_system::bone_system()
 {
-	runtime::on_frame_update.connect(this, &bone_system::frame_update);
+	if(core::has_subsystems<system_scheduler>())
+	{
+		system_scheduler::system_desc desc;
+		desc.name = "bone_system";
+		// Creates bone entities and writes transforms back into models.
+		desc.writes = system_scheduler::make_mask<transform_component, model_component>();
+		desc.on_update = [this](std::chrono::duration<float> dt) { frame_update(dt); };
+		core::get_subsystem<system_scheduler>().register_system(std::move(desc));
+	}
+	else
+	{
+		runtime::on_frame_update.connect(this, &bone_system::frame_update);
+	}
 }
 
 bone_system::~bone_system()
 {
-	runtime::on_frame_update.disconnect(this, &bone_system::frame_update);
+	if(core::has_subsystems<system_scheduler>())
+	{
+		core::get_subsystem<system_scheduler>().unregister_system("bone_system");
+	}
+	else
+	{
+		runtime::on_frame_update.disconnect(this, &bone_system::frame_update);
+	}
 }
 }
@@ -3,26 +3,100 @@
 #include "../components/camera_component.h"
 #include "../components/transform_component.h"
 #include "core/system/subsystem.h"
+#include "system_scheduler.h"
+
+#include <algorithm>
 
 namespace runtime
 {
 void camera_system::frame_update(std::chrono::duration<float> dt)
 {
-	auto& ecs = core::get_subsystem<entity_component_system>();
+	auto& ecs = _ecs.get();
+
+	const auto& entities = _query->entities();
+
+	// Membership changes arrive through the cached query's events; a
+	// priority edit is caught by comparing against the order's backing
+	// priorities while the cameras are being updated anyway.
+	bool resort = entities.size() != _sorted_cameras.size();
 
-	ecs.for_each<transform_component, camera_component>(
-		[](entity e, transform_component& transform, camera_component& camera) {
-			camera.update(transform.get_transform());
-		});
+	for(const auto& e : entities)
+	{
+		auto* transform = ecs.get_component_raw<transform_component>(e.id());
+		auto* camera = ecs.get_component_raw<camera_component>(e.id());
+		if(transform && camera)
+			camera->update(transform->get_transform());
+	}
+
+	if(!resort)
+	{
+		for(std::size_t i = 0; i < _sorted_cameras.size(); ++i)
+		{
+			auto* camera = ecs.get_component_raw<camera_component>(_sorted_cameras[i].id());
+			if(camera == nullptr || camera->get_render_priority() != _sorted_priorities[i])
+			{
+				resort = true;
+				break;
+			}
+		}
+	}
+
+	if(resort)
+		rebuild_sorted_cameras();
+}
+
+void camera_system::rebuild_sorted_cameras()
+{
+	auto& ecs = _ecs.get();
+
+	_sorted_cameras = _query->entities();
+	std::stable_sort(_sorted_cameras.begin(), _sorted_cameras.end(),
+					 [&ecs](const entity& lhs, const entity& rhs) {
+						 auto* lhs_camera = ecs.get_component_raw<camera_component>(lhs.id());
+						 auto* rhs_camera = ecs.get_component_raw<camera_component>(rhs.id());
+						 const auto lhs_priority = lhs_camera ? lhs_camera->get_render_priority() : 0;
+						 const auto rhs_priority = rhs_camera ? rhs_camera->get_render_priority() : 0;
+						 return lhs_priority < rhs_priority;
+					 });
+
+	_sorted_priorities.clear();
+	_sorted_priorities.reserve(_sorted_cameras.size());
+	for(const auto& e : _sorted_cameras)
+	{
+		auto* camera = ecs.get_component_raw<camera_component>(e.id());
+		_sorted_priorities.push_back(camera ? camera->get_render_priority() : 0);
+	}
 }
 
 camera_system::camera_system()
 {
-	on_frame_update.connect(this, &camera_system::frame_update);
+	auto& ecs = core::get_subsystem<entity_component_system>();
+	_query = std::make_unique<cached_query<transform_component, camera_component>>(ecs);
+
+	if(core::has_subsystems<system_scheduler>())
+	{
+		system_scheduler::system_desc desc;
+		desc.name = "camera_system";
+		desc.reads = system_scheduler::make_mask<transform_component>();
+		desc.writes = system_scheduler::make_mask<camera_component>();
+		desc.on_update = [this](std::chrono::duration<float> dt) { frame_update(dt); };
+		core::get_subsystem<system_scheduler>().register_system(std::move(desc));
+	}
+	else
+	{
+		on_frame_update.connect(this, &camera_system::frame_update);
+	}
 }
 
 camera_system::~camera_system()
 {
-	on_frame_update.disconnect(this, &camera_system::frame_update);
+	if(core::has_subsystems<system_scheduler>())
+	{
+		core::get_subsystem<system_scheduler>().unregister_system("camera_system");
+	}
+	else
+	{
+		on_frame_update.disconnect(this, &camera_system::frame_update);
+	}
 }
 }
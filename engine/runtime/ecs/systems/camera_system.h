@@ -1,6 +1,15 @@
 #pragma once
 
+#include "../ecs.h"
+#include "core/system/subsystem.h"
+
 #include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class transform_component;
+class camera_component;
 
 namespace runtime
 {
@@ -18,5 +27,39 @@ public:
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	void frame_update(std::chrono::duration<float> dt);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_active_cameras ()
+	/// <summary>
+	/// Active cameras sorted by ascending render priority. Membership
+	/// follows component add/remove events through the cached query and the
+	/// order is re-derived only when membership or a camera's priority
+	/// changed, so consumers (the renderer) avoid a per-frame rediscovery
+	/// scan.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const std::vector<entity>& get_active_cameras() const
+	{
+		return _sorted_cameras;
+	}
+
+private:
+	//-----------------------------------------------------------------------------
+	//  Name : rebuild_sorted_cameras (Private)
+	/// <summary>
+	/// Re-derives the priority order from the current query membership.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void rebuild_sorted_cameras();
+
+	/// Incrementally maintained camera query; avoids a full entity rescan
+	/// per frame.
+	std::unique_ptr<cached_query<transform_component, camera_component>> _query;
+	/// Memoized ECS access for the per-frame path.
+	core::subsystem_ref<entity_component_system> _ecs;
+	/// active cameras in render order (ascending priority, stable ties)
+	std::vector<entity> _sorted_cameras;
+	/// priorities backing _sorted_cameras, used to detect reorder cheaply
+	std::vector<std::int32_t> _sorted_priorities;
 };
 }
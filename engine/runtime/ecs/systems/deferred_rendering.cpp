@@ -4,23 +4,38 @@
 #include "../../rendering/material.h"
 #include "../../rendering/mesh.h"
 #include "../../rendering/model.h"
+#include "../../rendering/render_graph.h"
 #include "../../rendering/renderer.h"
+#include "../../rendering/texture_array_pool.h"
 #include "../../system/events.h"
 #include "../components/camera_component.h"
+#include "../components/hlod_component.h"
 #include "../components/light_component.h"
 #include "../components/model_component.h"
 #include "../components/reflection_probe_component.h"
 #include "../components/transform_component.h"
 #include "core/graphics/index_buffer.h"
+#include "core/profiler/profiler.h"
 #include "core/graphics/render_pass.h"
 #include "core/graphics/render_view.h"
 #include "core/graphics/texture.h"
 #include "core/graphics/vertex_buffer.h"
+#include "camera_system.h"
 #include "core/system/subsystem.h"
+#include "reflection_probe_system.h"
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <array>
+#include <unordered_set>
 
 namespace runtime
 {
 
+/// Shared shadow atlas dimensions; build_shadows_pass packs light slots
+/// into it and the lighting pass normalizes those slots against it.
+static const usize shadow_atlas_size = {4096, 4096};
+
 bool update_lod_data(lod_data& data, const std::vector<urange>& lod_limits, std::size_t total_lods,
 					 float transition_time, float dt, asset_handle<mesh> mesh, const math::transform& world,
 					 const camera& cam)
@@ -73,15 +88,13 @@ bool should_rebuild_reflections(visibility_set_models_t& visibility_set, const r
 
 	for(auto& element : visibility_set)
 	{
-		auto& transform_comp_handle = std::get<1>(element);
-		auto& model_comp_handle = std::get<2>(element);
-		auto transform_comp_ptr = transform_comp_handle.lock();
-		auto model_comp_ptr = model_comp_handle.lock();
+		auto* transform_comp_ptr = std::get<1>(element).get();
+		auto* model_comp_ptr = std::get<2>(element).get();
 		if(!transform_comp_ptr || !model_comp_ptr)
 			continue;
 
-		auto& transform_comp_ref = *transform_comp_ptr.get();
-		auto& model_comp_ref = *model_comp_ptr.get();
+		auto& transform_comp_ref = *transform_comp_ptr;
+		auto& model_comp_ref = *model_comp_ptr;
 
 		const auto& model = model_comp_ref.get_model();
 		if(!model.is_valid())
@@ -89,7 +102,7 @@ bool should_rebuild_reflections(visibility_set_models_t& visibility_set, const r
 
 		const auto mesh = model.get_lod(0);
 
-		const auto& world_transform = transform_comp_ref.get_transform();
+		const auto& world_transform = transform_comp_ref.get_render_transform();
 
 		const auto& bounds = mesh->get_bounds();
 
@@ -146,99 +159,555 @@ bool should_rebuild_shadows(visibility_set_models_t& visibility_set, const light
 	return false;
 }
 
+namespace
+{
+//-----------------------------------------------------------------------------
+//  Name : hash_frustum ()
+/// <summary>
+/// Hashes the six plane equations of a frustum; passes culling against an
+/// identical frustum (e.g. overlapping shadow splits) map to the same
+/// visibility cache slot.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::size_t hash_frustum(const math::frustum& frustum)
+{
+	std::size_t seed = 0;
+	for(const auto& plane : frustum.planes)
+	{
+		const float components[4] = {plane.data.x, plane.data.y, plane.data.z, plane.data.w};
+		for(const float component : components)
+			seed ^= std::hash<float>()(component) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+	return seed;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : for_each_active_camera ()
+/// <summary>
+/// Visits the active cameras in render order. Consumes the camera_system's
+/// incrementally maintained, priority-sorted list instead of rescanning the
+/// component storage; setups without the system fall back to a plain scan.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename F>
+void for_each_active_camera(entity_component_system& ecs, F&& callback)
+{
+	if(core::has_subsystems<camera_system>())
+	{
+		for(auto e : core::get_subsystem<camera_system>().get_active_cameras())
+		{
+			auto* camera_comp = ecs.get_component_raw<camera_component>(e.id());
+			if(camera_comp != nullptr)
+				callback(e, *camera_comp);
+		}
+		return;
+	}
+
+	ecs.for_each<camera_component>(std::forward<F>(callback));
+}
+}
+
 visibility_set_models_t deferred_rendering::gather_visible_models(entity_component_system& ecs,
 																  camera* camera,
 																  bool dirty_only /* = false*/,
 																  bool static_only /*= true*/,
-																  bool require_reflection_caster /*= false*/)
+																  bool require_reflection_caster /*= false*/,
+																  bool temporal_coherence /*= true*/)
 {
-	visibility_set_models_t result;
-	chandle<transform_component> transform_comp_handle;
-	chandle<model_component> model_comp_handle;
-	for(auto entity : ecs.entities_with_components(transform_comp_handle, model_comp_handle))
+	// Per-frame cache: reuse an identical gather outright, or refine a
+	// superset gathered with looser model filters for the same frustum.
+	visibility_cache_key cache_key;
+	cache_key.frustum_hash = camera != nullptr ? hash_frustum(camera->get_frustum()) : 0;
+	cache_key.dirty_only = dirty_only;
+	cache_key.static_only = static_only;
+	cache_key.require_reflection_caster = require_reflection_caster;
 	{
-		auto model_comp_ptr = model_comp_handle.lock();
-		auto transform_comp_ptr = transform_comp_handle.lock();
+		std::lock_guard<std::mutex> lock(_visibility_cache_mutex);
+		const auto cached = _visibility_cache.find(cache_key);
+		if(cached != _visibility_cache.end())
+			return cached->second;
 
-		if(static_only && !model_comp_ptr->is_static())
+		for(const auto& entry : _visibility_cache)
 		{
-			continue;
+			if(entry.first.frustum_hash != cache_key.frustum_hash ||
+			   entry.first.dirty_only != dirty_only)
+				continue;
+
+			// A cached flag that is unset means the set is a superset for
+			// that filter; refine it instead of rescanning the instances.
+			if((entry.first.static_only && !static_only) ||
+			   (entry.first.require_reflection_caster && !require_reflection_caster))
+				continue;
+
+			visibility_set_models_t refined;
+			for(const auto& item : entry.second)
+			{
+				auto* model_comp_ptr = std::get<2>(item).get();
+				if(model_comp_ptr == nullptr)
+					continue;
+				if(static_only && !model_comp_ptr->is_static())
+					continue;
+				if(require_reflection_caster && !model_comp_ptr->casts_reflection())
+					continue;
+				refined.push_back(item);
+			}
+			_visibility_cache[cache_key] = refined;
+			return refined;
 		}
+	}
+
+	visibility_set_models_t result;
+	auto* coherence = camera != nullptr && temporal_coherence ? &_visibility_coherence[camera] : nullptr;
+	auto* occlusion = camera != nullptr && temporal_coherence ? &_occlusion_queries[camera] : nullptr;
+	const auto current_frame = runtime::ecs::get_frame();
+	// How long a GPU-occluded instance stays culled before it is drawn
+	// again to refresh its query.
+	const std::uint64_t occlusion_recheck_interval = 4;
+
+	// Broad phase: ask the spatial index for the potentially visible set so
+	// the per-instance work below scales with what the frustum can see, not
+	// with scene size. Entities the index does not know about (e.g. meshes
+	// that streamed in this frame) fall through to the fine tests untouched.
+	std::unordered_set<entity> broad_visible;
+	spatial_index* spatial = nullptr;
+	if(camera != nullptr && core::has_subsystems<spatial_index>())
+	{
+		spatial = &core::get_subsystem<spatial_index>();
+		std::vector<entity> query_result;
+		query_result.reserve(spatial->size());
+		spatial->query_frustum(camera->get_frustum(), query_result);
+		broad_visible.insert(query_result.begin(), query_result.end());
+	}
 
-		if(require_reflection_caster && !model_comp_ptr->casts_reflection())
+	// Per-range output so the instance array can be split across worker
+	// threads without shared state; buckets are merged in order afterwards.
+	struct gather_bucket
+	{
+		visibility_set_models_t visible;
+		std::vector<const render_snapshot::model_instance*> candidates;
+		std::vector<math::bbox> candidate_bounds;
+		std::vector<std::uint64_t> candidate_keys;
+	};
+
+	const auto& instances = _snapshots.front().models;
+	const auto process_range = [&](std::size_t range_begin, std::size_t range_end, gather_bucket& bucket) {
+		math::bbox indexed_bounds;
+		for(std::size_t idx = range_begin; idx < range_end; ++idx)
 		{
-			continue;
-		}
+			const auto& instance = instances[idx];
+			// HLOD swap: cluster members are hidden while their merged proxy
+			// is active, proxies while their members render.
+			if(!_hlod_hidden.empty() && _hlod_hidden.find(instance.e) != _hlod_hidden.end())
+			{
+				continue;
+			}
 
-		auto mesh = model_comp_ptr->get_model().get_lod(0);
+			if(spatial != nullptr && broad_visible.find(instance.e) == broad_visible.end() &&
+			   spatial->get_bounds(instance.e, indexed_bounds))
+			{
+				// Indexed and rejected by the broad phase; skip the fine tests.
+				continue;
+			}
 
-		// If mesh isnt loaded yet skip it.
-		if(!mesh)
-			continue;
+			if(static_only && !instance.is_static)
+			{
+				continue;
+			}
 
-		if(camera)
-		{
-			const auto& frustum = camera->get_frustum();
+			if(require_reflection_caster && !instance.casts_reflection)
+			{
+				continue;
+			}
+
+			// Only dirty mesh components.
+			if(dirty_only && !instance.touched)
+				continue;
 
-			const auto& world_transform = transform_comp_ptr->get_transform();
+			auto* model_comp_ptr = instance.model_comp.get();
+			if(!model_comp_ptr)
+				continue;
 
-			const auto& bounds = mesh->get_bounds();
+			auto mesh = model_comp_ptr->get_model().get_lod(0);
 
-			// Test the bounding box of the mesh
-			if(math::frustum::test_obb(frustum, bounds, world_transform))
+			// If mesh isnt loaded yet skip it.
+			if(!mesh)
+				continue;
+
+			if(camera)
 			{
-				// Only dirty mesh components.
-				if(dirty_only)
+				// Bounds are cached on the component and snapshotted once per
+				// frame; only instances whose mesh streamed in after capture
+				// still pay for the corner transforms here.
+				const auto world_bounds = instance.world_bounds.is_populated()
+											  ? instance.world_bounds
+											  : math::bbox::mul(mesh->get_bounds(), instance.world_transform);
+				const std::uint64_t key = instance.e.id().id();
+
+				// GPU occlusion: an instance whose last issued query came
+				// back with zero visible pixels is skipped until its
+				// periodic recheck, where drawing it refreshes the query.
+				if(occlusion != nullptr)
 				{
-					if(transform_comp_ptr->is_touched() || model_comp_ptr->is_touched())
+					const auto oit = occlusion->find(key);
+					if(oit != occlusion->end() && oit->second.query.idx != gfx::invalid_handle &&
+					   current_frame - oit->second.last_issue_frame < occlusion_recheck_interval)
 					{
-						result.push_back(std::make_tuple(entity, transform_comp_handle, model_comp_handle));
+						std::int32_t pixels = 0;
+						if(gfx::get_result(oit->second.query, &pixels) ==
+						   bgfx::OcclusionQueryResult::Invisible)
+							continue;
 					}
-				} // End if dirty_only
-				else
+				}
+
+				// Temporal coherence: an instance rejected last frame is very
+				// likely rejected by the same separating plane again, so retest
+				// it up front - in the common case a single dot product -
+				// instead of pushing it through the full batch classify. Only
+				// existing entries are written here, so concurrent ranges never
+				// mutate the map layout.
+				if(coherence != nullptr)
 				{
-					result.push_back(std::make_tuple(entity, transform_comp_handle, model_comp_handle));
+					const auto it = coherence->find(key);
+					if(it != coherence->end() && it->second >= 0)
+					{
+						unsigned int frustum_bits = 0;
+						int last_outside = it->second;
+						const auto query =
+							camera->get_frustum().classify_aabb(world_bounds, frustum_bits, last_outside);
+						it->second = last_outside;
+						if(query == math::volume_query::outside)
+							continue;
+
+						bucket.visible.push_back(
+							std::make_tuple(instance.e, instance.transform_comp, instance.model_comp));
+						continue;
+					}
 				}
 
-			} // Enf if visble
+				bucket.candidates.push_back(&instance);
+				bucket.candidate_bounds.push_back(world_bounds);
+				bucket.candidate_keys.push_back(key);
+			}
+			else
+			{
+				bucket.visible.push_back(
+					std::make_tuple(instance.e, instance.transform_comp, instance.model_comp));
+			}
 		}
-		else
+	};
+
+	// Large scenes split the instance range across the task system workers;
+	// waiting also lends this thread to other pending tasks, so nested
+	// gathers kicked from frame_render do not starve the pool.
+	const std::size_t instances_per_task = 2048;
+	std::vector<gather_bucket> buckets;
+	if(instances.size() >= instances_per_task * 2 && core::has_subsystems<core::task_system>())
+	{
+		auto& ts = core::get_subsystem<core::task_system>();
+		const std::size_t batch_count = (instances.size() + instances_per_task - 1) / instances_per_task;
+		buckets.resize(batch_count);
+		std::vector<core::task_future<void>> futures;
+		futures.reserve(batch_count - 1);
+		for(std::size_t batch = 1; batch < batch_count; ++batch)
 		{
-			// Only dirty mesh components.
-			if(dirty_only)
+			const std::size_t range_begin = batch * instances_per_task;
+			const std::size_t range_end = std::min(range_begin + instances_per_task, instances.size());
+			auto& bucket = buckets[batch];
+			futures.emplace_back(ts.push_on_worker_thread(
+				[&process_range, range_begin, range_end, &bucket]() { process_range(range_begin, range_end, bucket); }));
+		}
+
+		// First range on the calling thread while the workers run.
+		process_range(0, instances_per_task, buckets[0]);
+		for(auto& future : futures)
+			future.wait();
+	}
+	else
+	{
+		buckets.resize(1);
+		process_range(0, instances.size(), buckets[0]);
+	}
+
+	std::vector<const render_snapshot::model_instance*> candidates;
+	std::vector<math::bbox> candidate_bounds;
+	std::vector<std::uint64_t> candidate_keys;
+	for(auto& bucket : buckets)
+	{
+		result.insert(result.end(), bucket.visible.begin(), bucket.visible.end());
+		candidates.insert(candidates.end(), bucket.candidates.begin(), bucket.candidates.end());
+		candidate_bounds.insert(candidate_bounds.end(), bucket.candidate_bounds.begin(),
+								bucket.candidate_bounds.end());
+		candidate_keys.insert(candidate_keys.end(), bucket.candidate_keys.begin(),
+							  bucket.candidate_keys.end());
+	}
+
+	if(camera && !candidates.empty())
+	{
+		// Classify all remaining world-space boxes in one SIMD batch
+		// instead of a frustum transform and scalar test per entity.
+		std::vector<math::volume_query> queries(candidates.size());
+		camera->get_frustum().classify_aabb_batch(candidate_bounds.data(), candidate_bounds.size(),
+												  queries.data());
+		for(std::size_t i = 0; i < candidates.size(); ++i)
+		{
+			if(queries[i] == math::volume_query::outside)
 			{
-				if(transform_comp_ptr->is_touched() || model_comp_ptr->is_touched())
+				if(coherence != nullptr)
 				{
-					result.push_back(std::make_tuple(entity, transform_comp_handle, model_comp_handle));
+					// Record the separating plane so next frame's gather can
+					// early-out on it; the scalar classify stops at the first
+					// rejecting plane.
+					unsigned int frustum_bits = 0;
+					int last_outside = -1;
+					camera->get_frustum().classify_aabb(candidate_bounds[i], frustum_bits, last_outside);
+					(*coherence)[candidate_keys[i]] = last_outside;
 				}
-			} // End if dirty_only
-			else
-			{
-				result.push_back(std::make_tuple(entity, transform_comp_handle, model_comp_handle));
+				continue;
 			}
+			if(coherence != nullptr)
+				(*coherence)[candidate_keys[i]] = -1;
+			const auto& instance = *candidates[i];
+			result.push_back(std::make_tuple(instance.e, instance.transform_comp, instance.model_comp));
 		}
 	}
+
+	{
+		std::lock_guard<std::mutex> lock(_visibility_cache_mutex);
+		_visibility_cache[cache_key] = result;
+	}
 	return result;
 }
 
+void deferred_rendering::update_hlod_clusters(entity_component_system& ecs)
+{
+	_hlod_hidden.clear();
+
+	// Reference camera for the swap metric; with several cameras the first
+	// one decides, which keeps all gathers of the frame consistent.
+	const camera* reference_camera = nullptr;
+	ecs.for_each<camera_component>([&reference_camera](entity, camera_component& camera_comp) {
+		if(reference_camera == nullptr)
+			reference_camera = &camera_comp.get_camera();
+	});
+
+	ecs.for_each<hlod_component>([this, reference_camera](entity e, hlod_component& cluster) {
+		bool proxy_active = false;
+		const auto& bounds = cluster.get_cluster_bounds();
+		if(reference_camera != nullptr && bounds.is_populated())
+		{
+			// Projected screen height fraction of the cluster's bounding
+			// sphere; inside the sphere the cluster fills the screen.
+			const auto center = bounds.get_center();
+			const float radius = math::length(bounds.get_dimensions()) * 0.5f;
+			const float distance = math::length(center - reference_camera->get_position());
+			const float half_fov = math::radians(reference_camera->get_fov() * 0.5f);
+			float screen_size = 1.0f;
+			if(distance > radius && half_fov > 0.0f)
+				screen_size = radius / (distance * math::tan(half_fov));
+
+			proxy_active = screen_size < cluster.get_screen_size_threshold();
+		}
+
+		if(proxy_active)
+		{
+			for(const auto& member : cluster.get_members())
+			{
+				if(member.valid())
+					_hlod_hidden.insert(member);
+			}
+		}
+		else
+		{
+			_hlod_hidden.insert(e);
+		}
+	});
+}
+
+void deferred_rendering::set_dynamic_resolution_enabled(bool enabled)
+{
+	_dynamic_resolution_enabled = enabled;
+	if(!enabled)
+	{
+		_resolution_scale = 1.0f;
+		_scale_cooldown = 0;
+	}
+}
+
+void deferred_rendering::set_target_frame_time(float milliseconds)
+{
+	_target_frame_time_ms = milliseconds;
+}
+
+void deferred_rendering::update_resolution_scale()
+{
+	if(!_dynamic_resolution_enabled)
+		return;
+
+	if(_scale_cooldown > 0)
+	{
+		--_scale_cooldown;
+		return;
+	}
+
+	// Whole-frame gpu time, summed from the per-pass timer queries. An
+	// empty table means the backend reports no timings - stay at full
+	// resolution rather than steering blind.
+	double gpu_time_ms = 0.0;
+	for(const auto& timing : gfx::render_pass::get_gpu_timings())
+		gpu_time_ms += timing.second.gpu_time_ms;
+	if(gpu_time_ms <= 0.0)
+		return;
+
+	// Quantized steps - over budget drops a step, comfortable headroom
+	// climbs one. The dead zone in between keeps the scale (and with it
+	// the render_view target cache) stable.
+	const float step = 0.05f;
+	const float min_scale = 0.5f;
+	float scale = _resolution_scale;
+	if(gpu_time_ms > double(_target_frame_time_ms) * 0.95)
+		scale -= step;
+	else if(gpu_time_ms < double(_target_frame_time_ms) * 0.70)
+		scale += step;
+	scale = math::clamp(scale, min_scale, 1.0f);
+
+	if(math::abs(scale - _resolution_scale) > 0.001f)
+	{
+		_resolution_scale = scale;
+		// The timer queries report a few frames behind submission; hold
+		// until the new size shows up in them before steering again.
+		_scale_cooldown = 8;
+	}
+}
+
+usize deferred_rendering::scale_viewport(const usize& size) const
+{
+	if(_resolution_scale >= 0.999f)
+		return size;
+
+	usize scaled;
+	scaled.width = std::max(1u, std::uint32_t(float(size.width) * _resolution_scale + 0.5f));
+	scaled.height = std::max(1u, std::uint32_t(float(size.height) * _resolution_scale + 0.5f));
+	return scaled;
+}
+
 void deferred_rendering::frame_render(std::chrono::duration<float> dt)
 {
+	PROFILE_SCOPE("deferred_rendering/frame_render");
+
 	auto& ecs = core::get_subsystem<entity_component_system>();
 
-	build_reflections_pass(ecs, dt);
-	build_shadows_pass(ecs, dt);
-	camera_pass(ecs, dt);
+	// Steer the internal render resolution from last frames' gpu timings
+	// before any pass sizes its targets.
+	update_resolution_scale();
+
+	// Copy newly acquired material texture sets into the shared arrays
+	// before any geometry samples them.
+	if(core::has_subsystems<texture_array_pool>())
+	{
+		core::get_subsystem<texture_array_pool>().flush_uploads();
+	}
+
+	// Pick a side for every HLOD cluster before any visibility gather runs
+	// so all passes agree on which entities exist this frame.
+	update_hlod_clusters(ecs);
+
+	// Capture this frame's render-relevant state and flip the buffers;
+	// everything below consumes the freshly captured front snapshot.
+	_snapshots.back().capture(ecs);
+	_snapshots.swap();
+
+	{
+		// New snapshot, new visibility; drop last frame's gathers.
+		std::lock_guard<std::mutex> lock(_visibility_cache_mutex);
+		_visibility_cache.clear();
+	}
+
+	// The frame is composed through the render graph: the probe and shadow
+	// build passes only run when the scene can consume what they produce.
+	bool has_probes = false;
+	ecs.for_each<reflection_probe_component>(
+		[&has_probes](entity e, reflection_probe_component& probe) { has_probes = true; });
+	bool has_lights = false;
+	ecs.for_each<light_component>([&has_lights](entity e, light_component& light) { has_lights = true; });
+
+	// Kick the per-pass visibility gathers on the task system up front; the
+	// passes join right before they submit. The shared dirty gather feeds
+	// both the reflection and the shadow build, so it is computed once and
+	// skipped entirely when neither pass is live.
+	if(core::has_subsystems<core::task_system>())
+	{
+		auto& ts = core::get_subsystem<core::task_system>();
+		if(has_probes || has_lights)
+		{
+			_dirty_models_future = ts.push_on_worker_thread(
+				[this, &ecs]() { return gather_visible_models(ecs, nullptr, true, true, true); });
+		}
+
+		_camera_gathers.clear();
+		for_each_active_camera(ecs, [this, &ts, &ecs](entity ce, camera_component& camera_comp) {
+			// Gated views that will be skipped this frame need no gather.
+			if(!camera_comp.should_render())
+				return;
+
+			auto& camera = camera_comp.get_camera();
+			// Pre-create the coherency and occlusion entries so the
+			// concurrent worker gathers never insert into the outer maps.
+			_visibility_coherence[&camera];
+			_occlusion_queries[&camera];
+			_camera_gathers[ce] = ts.push_on_worker_thread(
+				[this, &ecs, &camera]() { return gather_visible_models(ecs, &camera, false, false, false); });
+		});
+	}
+
+	render_graph graph;
+
+	render_graph::pass_desc reflections;
+	reflections.name = "build_reflections";
+	reflections.outputs = {"reflection-probes"};
+	reflections.on_execute = [this, &ecs, dt]() { build_reflections_pass(ecs, dt); };
+	graph.add_pass(std::move(reflections));
+
+	render_graph::pass_desc shadows;
+	shadows.name = "build_shadows";
+	shadows.outputs = {"shadow-maps"};
+	shadows.on_execute = [this, &ecs, dt]() { build_shadows_pass(ecs, dt); };
+	graph.add_pass(std::move(shadows));
+
+	render_graph::pass_desc scene;
+	scene.name = "camera_pass";
+	if(has_probes)
+		scene.inputs.push_back("reflection-probes");
+	if(has_lights)
+		scene.inputs.push_back("shadow-maps");
+	scene.outputs = {"scene-color"};
+	scene.on_execute = [this, &ecs, dt]() { camera_pass(ecs, dt); };
+	graph.add_pass(std::move(scene));
+
+	graph.execute({"scene-color"});
+
+	_dirty_models_future = {};
+	_camera_gathers.clear();
 }
 
 void deferred_rendering::build_reflections_pass(entity_component_system& ecs, std::chrono::duration<float> dt)
 {
-	auto dirty_models = gather_visible_models(ecs, nullptr, true, true, true);
+	auto dirty_models = _dirty_models_future.valid() ? _dirty_models_future.get()
+													 : gather_visible_models(ecs, nullptr, true, true, true);
+	auto* probe_scheduler = core::has_subsystems<reflection_probe_system>()
+								? &core::get_subsystem<reflection_probe_system>()
+								: nullptr;
 	ecs.for_each<transform_component, reflection_probe_component>(
-		[this, &ecs, dt, &dirty_models](entity ce, transform_component& transform_comp,
+		[this, &ecs, dt, &dirty_models, probe_scheduler](entity ce, transform_component& transform_comp,
 										reflection_probe_component& reflection_probe_comp) {
-			const auto& world_tranform = transform_comp.get_transform();
+			const auto& world_tranform = transform_comp.get_render_transform();
 			const auto& probe = reflection_probe_comp.get_probe();
 
+			// A convolution queued in an earlier frame may have won its
+			// budget slot this frame; it is independent of whether any
+			// faces re-render below.
+			if(probe_scheduler != nullptr && probe_scheduler->is_filter_granted(ce))
+				convolve_probe_pass(reflection_probe_comp);
+
 			auto cubemap_fbo = reflection_probe_comp.get_cubemap_fbo();
 			bool should_rebuild = true;
 
@@ -251,18 +720,61 @@ void deferred_rendering::build_reflections_pass(entity_component_system& ecs, st
 			if(!should_rebuild)
 				return;
 
+			if(probe_scheduler != nullptr)
+			{
+				// Amortize: queue the faces and render only the ones that
+				// fit into this frame's budget; the rest follow over the
+				// coming frames.
+				probe_scheduler->request_rebuild(ce);
+				bool any_granted = false;
+				for(std::uint32_t i = 0; i < 6; ++i)
+					any_granted |= probe_scheduler->is_face_granted(ce, i);
+				if(!any_granted)
+					return;
+			}
+
+			// Build all six face cameras first and kick their gathers as
+			// tasks; each face then joins its own right before submission.
+			// Face cameras are transient, so temporal coherency is skipped.
+			std::array<camera, 6> face_cameras;
+			std::array<core::task_future<visibility_set_models_t>, 6> face_gathers;
+			for(std::uint32_t i = 0; i < 6; ++i)
+			{
+				face_cameras[i] = camera::get_face_camera(i, world_tranform);
+				face_cameras[i].set_far_clip(reflection_probe_comp.get_probe().box_data.extents.r);
+				face_cameras[i].set_viewport_size(usize(cubemap_fbo->get_size()));
+			}
+
+			if(probe.method != reflect_method::environment && core::has_subsystems<core::task_system>())
+			{
+				auto& ts = core::get_subsystem<core::task_system>();
+				for(std::uint32_t i = 0; i < 6; ++i)
+				{
+					if(probe_scheduler != nullptr && !probe_scheduler->is_face_granted(ce, i))
+						continue;
+
+					auto& face_camera = face_cameras[i];
+					face_gathers[i] = ts.push_on_worker_thread([this, &ecs, &face_camera, should_rebuild]() {
+						return gather_visible_models(ecs, &face_camera, !should_rebuild, true, true, false);
+					});
+				}
+			}
+
 			// iterate trough each cube face
 			for(std::uint32_t i = 0; i < 6; ++i)
 			{
-				auto camera = camera::get_face_camera(i, world_tranform);
-				camera.set_far_clip(reflection_probe_comp.get_probe().box_data.extents.r);
+				if(probe_scheduler != nullptr && !probe_scheduler->is_face_granted(ce, i))
+					continue;
+
+				auto& camera = face_cameras[i];
 				auto& render_view = reflection_probe_comp.get_render_view(i);
-				camera.set_viewport_size(usize(cubemap_fbo->get_size()));
 				auto& camera_lods = _lod_data[ce];
 				visibility_set_models_t visibility_set;
 
 				if(probe.method != reflect_method::environment)
-					visibility_set = gather_visible_models(ecs, &camera, !should_rebuild, true, true);
+					visibility_set = face_gathers[i].valid()
+										 ? face_gathers[i].get()
+										 : gather_visible_models(ecs, &camera, !should_rebuild, true, true, false);
 
 				std::shared_ptr<gfx::frame_buffer> output = nullptr;
 				output = g_buffer_pass(output, camera, render_view, visibility_set, camera_lods, dt);
@@ -275,54 +787,427 @@ void deferred_rendering::build_reflections_pass(entity_component_system& ecs, st
 						  output->get_texture()->native_handle());
 			}
 
-			gfx::render_pass pass("cubemap_generate_mips");
-			pass.bind(cubemap_fbo.get());
+			if(probe_scheduler != nullptr)
+			{
+				// Filter once the last queued face lands; the grant comes
+				// through the same per-frame budget as the face renders.
+				if(!probe_scheduler->has_pending_faces(ce))
+					probe_scheduler->request_filter(ce);
+			}
+			else
+			{
+				// No scheduler - all six faces rendered above, filter now.
+				convolve_probe_pass(reflection_probe_comp);
+			}
 
 		});
 }
 
+void deferred_rendering::convolve_probe_pass(reflection_probe_component& reflection_probe_comp)
+{
+	auto cubemap = reflection_probe_comp.get_cubemap();
+	auto cubemap_fbo = reflection_probe_comp.get_cubemap_fbo();
+	if(!cubemap)
+		return;
+
+	if(!_cubemap_prefilter_program || !_cubemap_irradiance_program)
+	{
+		gfx::render_pass pass("cubemap_generate_mips");
+		pass.bind(cubemap_fbo.get());
+		return;
+	}
+
+	auto& render_view = reflection_probe_comp.get_render_view(0);
+	const std::uint16_t size = cubemap->info.width;
+	const std::uint16_t num_mips = cubemap->info.numMips;
+	if(num_mips < 2)
+		return;
+
+	static auto source_flags = gfx::get_default_rt_sampler_flags() | BGFX_TEXTURE_BLIT_DST;
+
+	// Unfiltered copy of the scene faces; the prefilter samples it while the
+	// probe cubemap's own smaller mips are being written, so the cubemap is
+	// never bound for read and write at once.
+	auto source =
+		render_view.get_texture("CUBEMAP_SOURCE", size, true, 1, cubemap->info.format, source_flags);
+	auto source_fbo = render_view.get_fbo("CUBEMAP_SOURCE", {source});
+	{
+		gfx::render_pass pass("cubemap_source_copy");
+		for(std::uint16_t face = 0; face < 6; ++face)
+		{
+			gfx::blit(pass.id, source->native_handle(), 0, 0, 0, face, cubemap->native_handle(), 0, 0, 0,
+					  face, size, size);
+		}
+
+		// Same idiom as the old mip pass: binding the chain resolves the
+		// auto-generated mips, giving the filters a lod chain to sample.
+		gfx::render_pass mips_pass("cubemap_source_mips");
+		mips_pass.bind(source_fbo.get());
+	}
+
+	for(std::uint16_t mip = 1; mip < num_mips; ++mip)
+	{
+		// The bottom mip carries the diffuse irradiance; everything in
+		// between steps the GGX roughness linearly per mip.
+		const bool irradiance = (mip == num_mips - 1) && num_mips > 2;
+		const std::uint16_t mip_size = std::uint16_t(math::max(1, size >> mip));
+		const float roughness = float(mip) / float(num_mips - 1);
+
+		auto* program =
+			irradiance ? _cubemap_irradiance_program.get() : _cubemap_prefilter_program.get();
+
+		for(std::uint16_t face = 0; face < 6; ++face)
+		{
+			const auto fbo_id =
+				"CUBEMAP_M" + std::to_string(mip) + "F" + std::to_string(face);
+			auto fbo = render_view.get_fbo(fbo_id, std::vector<gfx::fbo_attachment>{{cubemap, mip, face}});
+
+			gfx::render_pass pass(irradiance ? "cubemap_irradiance" : "cubemap_prefilter");
+			pass.bind(fbo.get(), urect(0, 0, mip_size, mip_size));
+
+			program->begin();
+			float filter_data0[4] = {float(face), roughness, float(size), float(num_mips)};
+			program->set_uniform("u_filter_data0", filter_data0);
+			program->set_texture(0, "s_tex_cube", source.get());
+
+			auto topology = gfx::clip_quad(1.0f);
+			gfx::set_state(topology | BGFX_STATE_RGB_WRITE | BGFX_STATE_ALPHA_WRITE);
+			gfx::submit(pass.id, program->native_handle());
+			gfx::set_state(BGFX_STATE_DEFAULT);
+			program->end();
+		}
+	}
+}
+
+usize compute_shadow_map_size(light_component& light_comp, const math::vec3& light_position,
+							  const math::vec3& light_direction, const std::vector<camera*>& cameras)
+{
+	const std::uint32_t max_size = 1024;
+	const std::uint32_t min_size = 128;
+
+	// Directional lights cover the whole screen and keep the full map.
+	if(light_comp.get_light().type == light_type::directional)
+		return {max_size, max_size};
+
+	// Screen contribution: the largest projected extent of the light's
+	// bounding sphere across the active cameras.
+	float coverage = 0.0f;
+	for(auto* cam : cameras)
+	{
+		const auto& viewport = cam->get_viewport_size();
+		irect rect(0, 0, irect::value_type(viewport.width), irect::value_type(viewport.height));
+		if(light_comp.compute_projected_sphere_rect(rect, light_position, light_direction, cam->get_view(),
+													cam->get_projection()) == 0)
+			continue;
+
+		const float extent = math::max(float(rect.width()) / float(viewport.width),
+									   float(rect.height()) / float(viewport.height));
+		coverage = math::max(coverage, math::clamp(extent, 0.0f, 1.0f));
+	}
+
+	// One shadow texel per covered pixel of the full map, rounded up to
+	// the next power of two so the cached targets only step occasionally.
+	std::uint32_t desired = std::uint32_t(coverage * float(max_size));
+	std::uint32_t size = min_size;
+	while(size < desired)
+		size <<= 1;
+	size = math::clamp(size, min_size, max_size);
+
+	return {size, size};
+}
+
 void deferred_rendering::build_shadows_pass(entity_component_system& ecs, std::chrono::duration<float> dt)
 {
-	auto dirty_models = gather_visible_models(ecs, nullptr, true, true, true);
+	auto dirty_models = _dirty_models_future.valid() ? _dirty_models_future.get()
+													 : gather_visible_models(ecs, nullptr, true, true, true);
+
+	// The active cameras drive each light's screen contribution below.
+	std::vector<camera*> cameras;
+	ecs.for_each<camera_component>([&cameras](entity e, camera_component& camera_comp) {
+		cameras.push_back(&camera_comp.get_camera());
+	});
+
+	// Collect the shadow casting lights and their map sizes first so the
+	// atlas can be packed before anything renders.
+	struct shadow_entry
+	{
+		entity e;
+		transform_component* transform_comp = nullptr;
+		light_component* light_comp = nullptr;
+		usize map_size;
+		/// slot within the shared atlas; empty on overflow
+		urect atlas_rect;
+	};
+
+	std::vector<shadow_entry> entries;
 	ecs.for_each<transform_component, light_component>(
-		[this, &ecs, dt, &dirty_models](entity ce, transform_component& transform_comp,
-										light_component& light_comp) {
-			// const auto& world_tranform = transform_comp.get_transform();
-			const auto& light = light_comp.get_light();
+		[this, &cameras, &entries](entity ce, transform_component& transform_comp,
+								   light_component& light_comp) {
+			const auto& world_transform = transform_comp.get_render_transform();
+
+			shadow_entry entry;
+			entry.e = ce;
+			entry.transform_comp = &transform_comp;
+			entry.light_comp = &light_comp;
+			// Distant or small lights get proportionally smaller maps.
+			entry.map_size = compute_shadow_map_size(light_comp, world_transform.get_position(),
+													 world_transform.z_unit_axis(), cameras);
+			entries.push_back(entry);
+		});
 
-			bool should_rebuild = true;
+	if(entries.empty())
+		return;
+
+	// Shelf-pack the maps into the shared atlas, tallest first. The sizes
+	// are powers of two so the shelves pack without waste; a light that
+	// does not fit falls back to a dedicated composite target below.
+	const usize atlas_size = shadow_atlas_size;
+	std::vector<std::size_t> pack_order(entries.size());
+	for(std::size_t i = 0; i < pack_order.size(); ++i)
+		pack_order[i] = i;
+	std::sort(pack_order.begin(), pack_order.end(), [&entries](std::size_t lhs, std::size_t rhs) {
+		return entries[lhs].map_size.height > entries[rhs].map_size.height;
+	});
 
-			if(!transform_comp.is_touched() && !light_comp.is_touched())
+	std::uint32_t shelf_top = 0;
+	std::uint32_t shelf_height = 0;
+	std::uint32_t shelf_cursor = 0;
+	for(auto index : pack_order)
+	{
+		auto& entry = entries[index];
+		const auto width = entry.map_size.width;
+		const auto height = entry.map_size.height;
+		if(shelf_cursor + width > atlas_size.width)
+		{
+			shelf_top += shelf_height;
+			shelf_height = 0;
+			shelf_cursor = 0;
+		}
+		if(shelf_top + height > atlas_size.height)
+			continue;
+
+		entry.atlas_rect = {shelf_cursor, shelf_top, shelf_cursor + width, shelf_top + height};
+		shelf_cursor += width;
+		shelf_height = math::max(shelf_height, height);
+	}
+
+	auto atlas_depth = _shadow_atlas_view.get_depth_stencil_buffer(atlas_size);
+	auto atlas_fbo = _shadow_atlas_view.get_fbo("SHADOW_ATLAS", {atlas_depth});
+
+	for(auto& entry : entries)
+	{
+		auto& transform_comp = *entry.transform_comp;
+		auto& light_comp = *entry.light_comp;
+		const auto& light = light_comp.get_light();
+
+		auto& cache = _shadow_caches[entry.e];
+
+		// The cached static-caster depth goes stale when the light
+		// itself changed or when static geometry moved under it.
+		if(transform_comp.is_touched() || light_comp.is_touched() ||
+		   should_rebuild_shadows(dirty_models, light))
+		{
+			cache.static_casters_valid = false;
+		}
+
+		// A resolution step also invalidates the cached static depth.
+		const usize shadow_map_size = entry.map_size;
+		if(shadow_map_size != cache.shadow_map_size)
+		{
+			cache.shadow_map_size = shadow_map_size;
+			cache.static_casters_valid = false;
+		}
+		// Published for the lighting pass to resolve the light's texels
+		// within the shared atlas.
+		cache.atlas_rect = entry.atlas_rect;
+
+		// World-to-clip matrix of this light's depth render, consumed by
+		// the shadow-sampling shader variants at lighting time.
+		{
+			static const auto perspective_ =
+				gfx::is_homogeneous_depth() ? math::perspectiveNO<float> : math::perspectiveZO<float>;
+			static const auto ortho_ =
+				gfx::is_homogeneous_depth() ? math::orthoNO<float> : math::orthoZO<float>;
+
+			const auto& world_transform = transform_comp.get_render_transform();
+			const auto light_position = world_transform.get_position();
+			const auto light_direction = world_transform.z_unit_axis();
+
+			math::transform shadow_view;
+			math::transform shadow_proj;
+			if(light.type == light_type::directional)
+			{
+				// Fixed-extent volume pushed ahead of the main camera; a
+				// frustum-fitted cascade chain can replace it later.
+				const float extent = 50.0f;
+				const float depth_range = 200.0f;
+				const auto focus =
+					cameras.empty() ? light_position : cameras.front()->get_position();
+				shadow_view.look_at(focus - light_direction * (depth_range * 0.5f), focus,
+									world_transform.y_unit_axis());
+				shadow_proj = ortho_(-extent, extent, -extent, extent, 0.1f, depth_range);
+			}
+			else
 			{
-				// If shadows shouldn't be rebuilt - continue.
-				should_rebuild = should_rebuild_shadows(dirty_models, light);
+				// Spot maps cover the outer cone; point lights reuse a
+				// forward 90 degree frustum until omni faces are packed.
+				const float fov = light.type == light_type::spot
+									  ? math::radians(light.spot_data.get_outer_angle())
+									  : math::radians(90.0f);
+				const float range = light.type == light_type::spot ? light.spot_data.get_range()
+																   : light.point_data.range;
+				shadow_view.look_at(light_position, light_position + light_direction,
+									world_transform.y_unit_axis());
+				shadow_proj = perspective_(fov, 1.0f, 0.1f, math::max(range, 0.2f));
 			}
+			cache.view_proj = shadow_proj * shadow_view;
+		}
 
-			if(!should_rebuild)
-				return;
+		auto static_depth = cache.render_view.get_depth_stencil_buffer(shadow_map_size);
+		auto static_fbo = cache.render_view.get_fbo("SHADOW_STATIC", {static_depth});
 
-		});
+		if(!cache.static_casters_valid)
+		{
+			// Re-render every static caster once into the persistent
+			// depth target. On the common frame where neither the light
+			// nor static geometry changed this block is skipped and the
+			// cached depth is reused as-is.
+			auto static_casters = gather_visible_models(ecs, nullptr, false, true, false);
+
+			gfx::render_pass pass("shadow_static_depth_fill");
+			pass.bind(static_fbo.get());
+			pass.clear(BGFX_CLEAR_DEPTH, 0x000000ff, 1.0f, 0);
+			// Depth-only submission of static_casters goes here once
+			// shadow geometry rendering lands; the cache plumbing and
+			// invalidation are already exercised.
+			(void)static_casters;
+
+			cache.static_casters_valid = true;
+		}
+
+		auto dynamic_casters = gather_visible_models(ecs, nullptr, false, false, false);
+		dynamic_casters.erase(std::remove_if(dynamic_casters.begin(), dynamic_casters.end(),
+											 [](const visibility_set_models_t::value_type& item) {
+												 auto* model_comp_ptr = std::get<2>(item).get();
+												 return model_comp_ptr == nullptr ||
+														model_comp_ptr->is_static();
+											 }),
+							  dynamic_casters.end());
+
+		// Shadow-relevance cull for positional lights: a caster whose
+		// extruded silhouette volume cannot reach the view frustum
+		// contributes nothing on screen this frame. The extrusion is
+		// cached per (caster, light) and only recomputed when either
+		// side actually changed, so unchanged pairs cost two compares.
+		if(!cameras.empty() && light.type != light_type::directional)
+		{
+			const auto& view_frustum = cameras.front()->get_frustum();
+			const auto& light_world = transform_comp.get_render_transform();
+			const auto light_position = light_world.get_position();
+			const float light_range = light.type == light_type::spot ? light.spot_data.get_range()
+																	 : light.point_data.range;
+			const bool light_dirty = transform_comp.is_touched() || light_comp.is_touched();
+			dynamic_casters.erase(
+				std::remove_if(
+					dynamic_casters.begin(), dynamic_casters.end(),
+					[&, this](const visibility_set_models_t::value_type& item) {
+						auto caster = std::get<0>(item);
+						auto* caster_transform = std::get<1>(item).get();
+						auto* caster_model = std::get<2>(item).get();
+						if(!caster_transform || !caster_model)
+							return true;
+
+						const auto& bounds = caster_model->get_world_bounds(*caster_transform);
+						// A caster inside the frustum always stays - the
+						// edge-based extrusion test only covers volumes
+						// crossing the frustum boundary.
+						if(view_frustum.test_aabb(bounds))
+							return false;
+
+						const bool caster_dirty = light_dirty || caster_transform->is_touched() ||
+												  caster_model->is_touched();
+						const auto& extruded = get_caster_extrusion(
+							caster, entry.e, bounds, light_position, light_range, caster_dirty);
+						return !view_frustum.test_extruded_aabb(extruded);
+					}),
+				dynamic_casters.end());
+		}
+
+		if(!entry.atlas_rect.empty())
+		{
+			// Composite into the light's atlas slot: every light shares
+			// one depth target and only the viewport changes, so the
+			// shadow phase binds a single frame buffer for N lights.
+			gfx::render_pass pass("shadow_atlas_composite");
+			pass.bind(atlas_fbo.get(), entry.atlas_rect);
+			gfx::blit(pass.id, atlas_depth->native_handle(), std::uint16_t(entry.atlas_rect.left),
+					  std::uint16_t(entry.atlas_rect.top), static_depth->native_handle());
+			// Depth submission of dynamic_casters goes here once shadow
+			// geometry rendering lands.
+			(void)dynamic_casters;
+		}
+		else
+		{
+			// Atlas overflow: seed a dedicated composite target from the
+			// cached static depth, as before.
+			auto composite_depth =
+				cache.render_view.get_texture("SHADOW_COMPOSITE", shadow_map_size.width,
+											  shadow_map_size.height, false, 1, static_depth->info.format);
+			auto composite_fbo = cache.render_view.get_fbo("SHADOW", {composite_depth});
+
+			gfx::render_pass pass("shadow_dynamic_composite");
+			pass.bind(composite_fbo.get());
+			gfx::blit(pass.id, composite_depth->native_handle(), 0, 0, static_depth->native_handle());
+			(void)dynamic_casters;
+		}
+	}
 }
 
 void deferred_rendering::camera_pass(entity_component_system& ecs, std::chrono::duration<float> dt)
 {
-	ecs.for_each<camera_component>([this, &ecs, dt](entity ce, camera_component& camera_comp) {
+	for_each_active_camera(ecs, [this, &ecs, dt](entity ce, camera_component& camera_comp) {
+		// Presenter gated views reuse their previous output target on
+		// skipped frames; the bookkeeping call keeps the idle refresh
+		// cadence ticking.
+		if(!camera_comp.should_render())
+		{
+			camera_comp.on_view_rendered(false);
+			return;
+		}
+
 		auto& camera_lods = _lod_data[ce];
 		auto& camera = camera_comp.get_camera();
 		auto& render_view = camera_comp.get_render_view();
 
-		auto output = deferred_render_full(camera, render_view, ecs, camera_lods, dt);
+		// Join the gather kicked in frame_render; standalone invocations
+		// without a pre-kicked task still gather inline.
+		visibility_set_models_t visibility_set;
+		const auto it = _camera_gathers.find(ce);
+		if(it != _camera_gathers.end() && it->second.valid())
+			visibility_set = it->second.get();
+		else
+			visibility_set = gather_visible_models(ecs, &camera, false, false, false);
 
+		auto output = deferred_render_full(camera, render_view, ecs, visibility_set, camera_lods, dt);
+
+		camera_comp.on_view_rendered(true);
 	});
 }
 
 std::shared_ptr<gfx::frame_buffer> deferred_rendering::deferred_render_full(
 	camera& camera, gfx::render_view& render_view, entity_component_system& ecs,
-	std::unordered_map<entity, lod_data>& camera_lods, std::chrono::duration<float> dt)
+	lod_state_storage& camera_lods, std::chrono::duration<float> dt)
 {
-	std::shared_ptr<gfx::frame_buffer> output = nullptr;
-
 	auto visibility_set = gather_visible_models(ecs, &camera, false, false, false);
+	return deferred_render_full(camera, render_view, ecs, visibility_set, camera_lods, dt);
+}
+
+std::shared_ptr<gfx::frame_buffer> deferred_rendering::deferred_render_full(
+	camera& camera, gfx::render_view& render_view, entity_component_system& ecs,
+	visibility_set_models_t& visibility_set, lod_state_storage& camera_lods,
+	std::chrono::duration<float> dt)
+{
+	std::shared_ptr<gfx::frame_buffer> output = nullptr;
 
 	output = g_buffer_pass(output, camera, render_view, visibility_set, camera_lods, dt);
 
@@ -332,6 +1217,8 @@ std::shared_ptr<gfx::frame_buffer> deferred_rendering::deferred_render_full(
 
 	output = atmospherics_pass(output, camera, render_view, ecs, dt);
 
+	output = transparency_pass(output, camera, render_view, visibility_set, camera_lods, dt);
+
 	output = tonemapping_pass(output, camera, render_view);
 
 	return output;
@@ -340,12 +1227,14 @@ std::shared_ptr<gfx::frame_buffer> deferred_rendering::deferred_render_full(
 std::shared_ptr<gfx::frame_buffer>
 deferred_rendering::g_buffer_pass(std::shared_ptr<gfx::frame_buffer> input, camera& camera,
 								  gfx::render_view& render_view, visibility_set_models_t& visibility_set,
-								  std::unordered_map<entity, lod_data>& camera_lods,
+								  lod_state_storage& camera_lods,
 								  std::chrono::duration<float> dt)
 {
 	const auto& view = camera.get_view();
 	const auto& proj = camera.get_projection();
-	const auto& viewport_size = camera.get_viewport_size();
+	// Internal passes render at the scaled resolution; the tonemapping
+	// pass upscales into the full-size output surface.
+	const auto viewport_size = scale_viewport(camera.get_viewport_size());
 	auto g_buffer_fbo = render_view.get_g_buffer_fbo(viewport_size);
 
 	gfx::render_pass pass("g_buffer_fill");
@@ -353,27 +1242,46 @@ deferred_rendering::g_buffer_pass(std::shared_ptr<gfx::frame_buffer> input, came
 	pass.clear();
 	pass.set_view_proj(view, proj);
 
+	auto& occlusion = _occlusion_queries[&camera];
+	const auto current_frame = runtime::ecs::get_frame();
+	const auto clip_planes = math::vec2(camera.get_near_clip(), camera.get_far_clip());
+
+	// Advance lod state first and split the set into instanced batches (same
+	// mesh, materials and lod; rigid and not mid transition) and the draws
+	// that have to stay individual.
+	struct queued_draw
+	{
+		entity e;
+		const model* mdl = nullptr;
+		const math::transform* world_transform = nullptr;
+		skinning_data* skinning = nullptr;
+		std::uint32_t current_lod_index = 0;
+		std::uint32_t target_lod_index = 0;
+		float current_time = 0.0f;
+		float transition_time = 0.0f;
+	};
+
+	std::vector<queued_draw> queued;
+	queued.reserve(visibility_set.size());
+
 	for(auto& element : visibility_set)
 	{
 		auto& e = std::get<0>(element);
-		auto& transform_comp_handle = std::get<1>(element);
-		auto& model_comp_handle = std::get<2>(element);
-		auto transform_comp_ptr = transform_comp_handle.lock();
-		auto model_comp_ptr = model_comp_handle.lock();
+		auto* transform_comp_ptr = std::get<1>(element).get();
+		auto* model_comp_ptr = std::get<2>(element).get();
 		if(!transform_comp_ptr || !model_comp_ptr)
 			continue;
 
-		auto& transform_comp_ref = *transform_comp_ptr.get();
-		auto& model_comp_ref = *model_comp_ptr.get();
+		auto& transform_comp_ref = *transform_comp_ptr;
+		auto& model_comp_ref = *model_comp_ptr;
 
 		const auto& model = model_comp_ref.get_model();
 		if(!model.is_valid())
 			continue;
 
-		const auto& world_transform = transform_comp_ref.get_transform();
-		const auto clip_planes = math::vec2(camera.get_near_clip(), camera.get_far_clip());
+		const auto& world_transform = transform_comp_ref.get_render_transform();
 
-		auto& lod_data = camera_lods[e];
+		auto& lod_data = camera_lods.get(e);
 		const auto transition_time = model.get_lod_transition_time();
 		const auto lod_count = model.get_lods().size();
 		const auto& lod_limits = model.get_lod_limits();
@@ -388,27 +1296,271 @@ deferred_rendering::g_buffer_pass(std::shared_ptr<gfx::frame_buffer> input, came
 		if(false == update_lod_data(lod_data, lod_limits, lod_count, transition_time, dt.count(),
 									current_mesh, world_transform, camera))
 			continue;
-		const auto params = math::vec3{0.0f, -1.0f, (transition_time - current_time) / transition_time};
+
+		queued_draw draw;
+		draw.e = e;
+		draw.mdl = &model;
+		draw.world_transform = &world_transform;
+		draw.skinning = &model_comp_ref.get_skinning_data();
+		draw.current_lod_index = current_lod_index;
+		draw.target_lod_index = target_lod_index;
+		draw.current_time = current_time;
+		draw.transition_time = transition_time;
+		queued.push_back(draw);
+	}
+
+	// 64-bit submission sort keys: pass, program, material, then front-to-back
+	// depth. Sorting by these keeps consecutive draws on the same program and
+	// material so the per-draw uniform and texture rebinding in
+	// material::submit stops thrashing, and the depth bits give early-z a
+	// favourable order within each material run.
+	const auto eye = camera.get_position();
+	const auto inv_clip_range =
+		1.0f / math::max(camera.get_far_clip() - camera.get_near_clip(), 0.0001f);
+	std::vector<std::uint64_t> sort_keys(queued.size());
+	for(std::size_t i = 0; i < queued.size(); ++i)
+	{
+		const auto& draw = queued[i];
+		// The first subset's material stands in for the whole model; subsets
+		// of one mesh nearly always share a program.
+		const material* mat = draw.mdl->get_material_for_group(0).get();
+		const gpu_program* program = mat ? mat->get_program() : nullptr;
+
+		const auto program_bits = std::uint64_t(std::hash<const void*>()(program) & 0xfff);
+		const auto material_bits = std::uint64_t(std::hash<const void*>()(mat) & 0xfff);
+		const float depth =
+			math::clamp(math::length(draw.world_transform->get_position() - eye) * inv_clip_range,
+						0.0f, 1.0f);
+		const auto depth_bits = std::uint64_t(depth * float(0xffffffff));
+
+		sort_keys[i] = (std::uint64_t(pass.id) << 56) | (program_bits << 44) | (material_bits << 32) |
+					   depth_bits;
+	}
+
+	struct instance_batch
+	{
+		const model* mdl = nullptr;
+		std::uint32_t lod = 0;
+		std::vector<math::transform> transforms;
+		/// indices into queued, so a failed batch can fall back per-draw
+		std::vector<std::size_t> members;
+		/// member models, for the per-instance array layers
+		std::vector<const model*> member_models;
+		/// merged across materials through the shared texture arrays
+		bool use_array = false;
+	};
+
+	std::unordered_map<std::size_t, instance_batch> batches;
+	std::vector<std::size_t> singles;
+	singles.reserve(queued.size());
+
+	for(std::size_t i = 0; i < queued.size(); ++i)
+	{
+		const auto& draw = queued[i];
+		const bool skinned = !draw.skinning->palettes.empty();
+		const bool transitioning = draw.current_time != 0.0f;
+		const auto mesh = draw.mdl->get_lod(draw.current_lod_index);
+		// Mixed-transparency models stay per-draw so the opaque filter
+		// applies; their transparent subsets render in transparency_pass.
+		if(skinned || transitioning || !mesh || draw.mdl->has_transparency())
+		{
+			singles.push_back(i);
+			continue;
+		}
+
+		// Models whose materials all have a ready slice in the shared
+		// texture arrays key by (array set, shading hash) per subset
+		// instead of material identity - draws that differ only in
+		// textures then land in one batch and the layer rides per
+		// instance. Anything else keeps the exact-material key.
+		bool array_capable = true;
+		for(const auto& mat : draw.mdl->get_materials())
+		{
+			const auto* slice = mat ? mat->get_texture_array_slice() : nullptr;
+			if(slice == nullptr || !slice->ready)
+			{
+				array_capable = false;
+				break;
+			}
+		}
+
+		std::size_t key =
+			std::hash<const void*>()(mesh.get()) ^ draw.current_lod_index ^ (std::size_t(array_capable) << 31);
+		for(const auto& mat : draw.mdl->get_materials())
+		{
+			if(array_capable)
+			{
+				const auto* slice = mat->get_texture_array_slice();
+				key ^= std::hash<const void*>()(slice->set) + 0x9e3779b9 + (key << 6) + (key >> 2);
+				key ^= std::size_t(mat->get_shading_hash()) + 0x9e3779b9 + (key << 6) + (key >> 2);
+			}
+			else
+			{
+				key ^= std::hash<const void*>()(mat.get()) + 0x9e3779b9 + (key << 6) + (key >> 2);
+			}
+		}
+
+		auto& batch = batches[key];
+		batch.mdl = draw.mdl;
+		batch.lod = draw.current_lod_index;
+		batch.use_array = array_capable;
+		batch.transforms.push_back(*draw.world_transform);
+		batch.members.push_back(i);
+		batch.member_models.push_back(draw.mdl);
+	}
+
+	std::vector<instance_batch*> ordered_batches;
+	ordered_batches.reserve(batches.size());
+	for(auto& pair : batches)
+		ordered_batches.push_back(&pair.second);
+	std::sort(ordered_batches.begin(), ordered_batches.end(),
+			  [&sort_keys](const instance_batch* lhs, const instance_batch* rhs) {
+				  return sort_keys[lhs->members.front()] < sort_keys[rhs->members.front()];
+			  });
+
+	const auto lod_params_full = math::vec3{0.0f, -1.0f, 1.0f};
+	for(auto* batch_ptr : ordered_batches)
+	{
+		auto& batch = *batch_ptr;
+
+		// A batch of one gains nothing from the instanced program; per-draw
+		// submission also keeps its occlusion query.
+		bool drawn = batch.members.size() > 1;
+		if(drawn)
+		{
+			const auto setup = [&camera, &clip_planes, &lod_params_full](gpu_program& p) {
+				auto camera_pos = camera.get_position();
+				p.set_uniform("u_camera_wpos", &camera_pos);
+				p.set_uniform("u_camera_clip_planes", &clip_planes);
+				p.set_uniform("u_lod_params", &lod_params_full);
+			};
+
+			// Cross-material batches must go through the array path - the
+			// per-draw fallback below re-submits each member with its own
+			// materials, so a failed array batch degrades correctly.
+			if(batch.use_array)
+			{
+				drawn = batch.mdl->render_instanced_array(pass.id, batch.transforms,
+														  batch.member_models, true, true, true,
+														  batch.lod, setup);
+			}
+			else
+			{
+				drawn = batch.mdl->render_instanced(pass.id, batch.transforms, true, true, true, 0,
+													batch.lod, nullptr, setup);
+			}
+		}
+
+		if(!drawn)
+		{
+			singles.insert(singles.end(), batch.members.begin(), batch.members.end());
+		}
+	}
+
+	std::sort(singles.begin(), singles.end(), [&sort_keys](std::size_t lhs, std::size_t rhs) {
+		return sort_keys[lhs] < sort_keys[rhs];
+	});
+
+	// Issue the per-instance occlusion query with the main draw; next
+	// frame's gather reads the result back. Instanced batches skip this;
+	// their entities simply never get occlusion-culled. Queries are created
+	// here on the calling thread so the recording below never mutates the
+	// shared map.
+	for(auto i : singles)
+	{
+		auto& occlusion_record = occlusion[queued[i].e.id().id()];
+		if(occlusion_record.query.idx == gfx::invalid_handle)
+			occlusion_record.query = gfx::create_occlusion_query();
+		occlusion_record.last_issue_frame = current_frame;
+	}
+
+	auto render_single = [&queued, &occlusion, &camera, &clip_planes, &pass](std::size_t i) {
+		const auto& draw = queued[i];
+		const auto& model = *draw.mdl;
+		const auto& world_transform = *draw.world_transform;
+		auto* skinning = draw.skinning;
+		const auto current_time = draw.current_time;
+		const auto transition_time = draw.transition_time;
+
+		const auto params =
+			math::vec3{0.0f, -1.0f, (transition_time - current_time) / transition_time};
 
 		const auto params_inv = math::vec3{1.0f, 1.0f, current_time / transition_time};
 
-		const auto& bone_transforms = model_comp_ref.get_bone_transforms();
+		const auto& occlusion_record = occlusion.at(draw.e.id().id());
 
-		model.render(pass.id, world_transform, bone_transforms, true, true, true, 0, current_lod_index,
-					 nullptr, [&camera, &clip_planes, &params](auto& p) {
+		model.render(pass.id, world_transform, skinning, true, true, true, 0,
+					 draw.current_lod_index, nullptr,
+					 [&camera, &clip_planes, &params](auto& p) {
 						 auto camera_pos = camera.get_position();
 						 p.set_uniform("u_camera_wpos", &camera_pos);
 						 p.set_uniform("u_camera_clip_planes", &clip_planes);
 						 p.set_uniform("u_lod_params", &params);
-					 });
+					 },
+					 occlusion_record.query, &camera, model::subset_filter::opaque_only);
 
 		if(current_time != 0.0f)
 		{
-			model.render(pass.id, world_transform, bone_transforms, true, true, true, 0, target_lod_index,
-						 nullptr, [&camera, &clip_planes, &params_inv](auto& p) {
+			model.render(pass.id, world_transform, skinning, true, true, true, 0,
+						 draw.target_lod_index, nullptr,
+						 [&camera, &clip_planes, &params_inv](auto& p) {
 							 p.set_uniform("u_lod_params", &params_inv);
-						 });
+						 },
+						 {gfx::invalid_handle}, &camera, model::subset_filter::opaque_only);
 		}
+	};
+
+	// Record the individual draws on worker threads through bgfx encoders.
+	// Ranges split only where the program/material bits of the sort key
+	// change, so a material (and its mutable program state) is touched by
+	// exactly one thread per frame.
+	const std::size_t draws_per_task = 256;
+	if(singles.size() >= draws_per_task * 2 && core::has_subsystems<core::task_system>())
+	{
+		auto& ts = core::get_subsystem<core::task_system>();
+
+		std::vector<std::size_t> range_starts;
+		range_starts.push_back(0);
+		std::size_t last_start = 0;
+		for(std::size_t i = 1; i < singles.size(); ++i)
+		{
+			if(i - last_start < draws_per_task)
+				continue;
+			if((sort_keys[singles[i]] >> 32) == (sort_keys[singles[i - 1]] >> 32))
+				continue;
+			range_starts.push_back(i);
+			last_start = i;
+		}
+		range_starts.push_back(singles.size());
+
+		std::vector<core::task_future<void>> futures;
+		futures.reserve(range_starts.size());
+		for(std::size_t r = 1; r + 1 < range_starts.size(); ++r)
+		{
+			const auto range_begin = range_starts[r];
+			const auto range_end = range_starts[r + 1];
+			futures.emplace_back(
+				ts.push_on_worker_thread([&render_single, &singles, range_begin, range_end]() {
+					gfx::begin_recording();
+					for(std::size_t i = range_begin; i < range_end; ++i)
+						render_single(singles[i]);
+					gfx::end_recording();
+				}));
+		}
+
+		// First range on the calling thread, like the gather split.
+		gfx::begin_recording();
+		for(std::size_t i = range_starts[0]; i < range_starts[1]; ++i)
+			render_single(singles[i]);
+		gfx::end_recording();
+
+		for(auto& f : futures)
+			f.wait();
+	}
+	else
+	{
+		for(auto i : singles)
+			render_single(i);
 	}
 
 	return g_buffer_fbo;
@@ -422,7 +1574,7 @@ deferred_rendering::lighting_pass(std::shared_ptr<gfx::frame_buffer> input, came
 	const auto& view = camera.get_view();
 	const auto& proj = camera.get_projection();
 
-	const auto& viewport_size = camera.get_viewport_size();
+	const auto viewport_size = scale_viewport(camera.get_viewport_size());
 	auto g_buffer_fbo = render_view.get_g_buffer_fbo(viewport_size).get();
 
 	static auto light_buffer_format = gfx::get_best_format(
@@ -445,78 +1597,148 @@ deferred_rendering::lighting_pass(std::shared_ptr<gfx::frame_buffer> input, came
 			.get_texture("RBUFFER", viewport_size.width, viewport_size.height, false, 1, light_buffer_format)
 			.get();
 
+	// Bin every light into the camera's view-space cluster grid first. The
+	// packed cluster table is what the clustered lighting shader will read;
+	// until then the per-light cluster coverage already culls lights that
+	// influence nothing inside the frustum before any state is touched.
+	struct light_draw
+	{
+		entity e;
+		light_component* comp = nullptr;
+		math::vec3 position;
+		math::vec3 direction;
+	};
+	std::vector<light_draw> draws;
+	std::vector<light_cluster::bin_light> bin_lights;
 	ecs.for_each<transform_component, light_component>(
-		[this, bind_indirect_specular, &camera, &pass, &buffer_size, &view, &proj, g_buffer_fbo,
-		 refl_buffer](entity e, transform_component& transform_comp_ref, light_component& light_comp_ref) {
-			const auto& light = light_comp_ref.get_light();
-			const auto& world_transform = transform_comp_ref.get_transform();
-			const auto& light_position = world_transform.get_position();
-			const auto& light_direction = world_transform.z_unit_axis();
-
-			irect rect(0, 0, irect::value_type(buffer_size.width), irect::value_type(buffer_size.height));
-			if(light_comp_ref.compute_projected_sphere_rect(rect, light_position, light_direction, view,
-															proj) == 0)
-				return;
+		[&draws, &bin_lights](entity e, transform_component& transform_comp_ref,
+							  light_component& light_comp_ref) {
+			const auto& world_transform = transform_comp_ref.get_render_transform();
+
+			light_draw draw;
+			draw.e = e;
+			draw.comp = &light_comp_ref;
+			draw.position = world_transform.get_position();
+			draw.direction = world_transform.z_unit_axis();
+			draws.push_back(draw);
+
+			light_cluster::bin_light bl;
+			bl.data = light_comp_ref.get_light();
+			bl.position = draw.position;
+			bl.direction = draw.direction;
+			bin_lights.push_back(bl);
+		});
+	_light_clusters.build(camera, bin_lights);
 
-			gpu_program* program = nullptr;
-			if(light.type == light_type::directional && _directional_light_program)
-			{
-				// Draw light.
-				program = _directional_light_program.get();
-				program->begin();
-				program->set_uniform("u_light_direction", &light_direction);
-			}
-			if(light.type == light_type::point && _point_light_program)
-			{
-				float light_data[4] = {light.point_data.range, light.point_data.exponent_falloff, 0.0f, 0.0f};
+	for(std::size_t light_index = 0; light_index < draws.size(); ++light_index)
+	{
+		auto& light_comp_ref = *draws[light_index].comp;
+		const auto& light = light_comp_ref.get_light();
+		const auto& light_position = draws[light_index].position;
+		const auto& light_direction = draws[light_index].direction;
+
+		// Covered by no cluster: the light cannot affect any shaded
+		// pixel this frame.
+		if(_light_clusters.get_cluster_count(light_index) == 0)
+			continue;
 
-				// Draw light.
-				program = _point_light_program.get();
-				program->begin();
-				program->set_uniform("u_light_position", &light_position);
-				program->set_uniform("u_light_data", light_data);
-			}
+		irect rect(0, 0, irect::value_type(buffer_size.width), irect::value_type(buffer_size.height));
+		if(light_comp_ref.compute_projected_sphere_rect(rect, light_position, light_direction, view,
+														proj) == 0)
+			continue;
 
-			if(light.type == light_type::spot && _spot_light_program)
-			{
-				float light_data[4] = {light.spot_data.get_range(),
-									   math::cos(math::radians(light.spot_data.get_inner_angle() * 0.5f)),
-									   math::cos(math::radians(light.spot_data.get_outer_angle() * 0.5f)),
-									   0.0f};
+		// Lights with a slot in the shadow atlas run the shadow-sampling
+		// shader variant; everything else keeps the branch-free base
+		// program, so no shaded pixel pays for shadows it does not have.
+		const shadow_map_cache* shadow_cache = nullptr;
+		const auto cache_it = _shadow_caches.find(draws[light_index].e);
+		if(cache_it != _shadow_caches.end() && !cache_it->second.atlas_rect.empty())
+		{
+			shadow_cache = &cache_it->second;
+		}
 
-				// Draw light.
-				program = _spot_light_program.get();
-				program->begin();
-				program->set_uniform("u_light_position", &light_position);
-				program->set_uniform("u_light_direction", &light_direction);
-				program->set_uniform("u_light_data", light_data);
-			}
+		gpu_program* program = nullptr;
+		bool shadowed = false;
+		if(light.type == light_type::directional && _directional_light_program)
+		{
+			shadowed = shadow_cache != nullptr && _directional_light_shadow_program != nullptr;
 
-			if(program)
-			{
-				float light_color_intensity[4] = {light.color.value.r, light.color.value.g,
-												  light.color.value.b, light.intensity};
-				auto camera_pos = camera.get_position();
-				program->set_uniform("u_light_color_intensity", light_color_intensity);
-				program->set_uniform("u_camera_position", &camera_pos);
-				program->set_texture(0, "s_tex0", g_buffer_fbo->get_texture(0).get());
-				program->set_texture(1, "s_tex1", g_buffer_fbo->get_texture(1).get());
-				program->set_texture(2, "s_tex2", g_buffer_fbo->get_texture(2).get());
-				program->set_texture(3, "s_tex3", g_buffer_fbo->get_texture(3).get());
-				program->set_texture(4, "s_tex4", g_buffer_fbo->get_texture(4).get());
-				program->set_texture(5, "s_tex5", refl_buffer);
-				program->set_texture(6, "s_tex6", _ibl_brdf_lut.get());
+			// Draw light.
+			program = shadowed ? _directional_light_shadow_program.get()
+							   : _directional_light_program.get();
+			program->begin();
+			program->set_uniform("u_light_direction", &light_direction);
+		}
+		if(light.type == light_type::point && _point_light_program)
+		{
+			float light_data[4] = {light.point_data.range, light.point_data.exponent_falloff, 0.0f, 0.0f};
 
-				gfx::set_scissor(rect.left, rect.top, rect.width(), rect.height());
-				auto topology = gfx::clip_quad(1.0f);
-				gfx::set_state(topology | BGFX_STATE_RGB_WRITE | BGFX_STATE_ALPHA_WRITE |
-							   BGFX_STATE_BLEND_ADD);
-				gfx::submit(pass.id, program->native_handle());
-				gfx::set_state(BGFX_STATE_DEFAULT);
+			// Draw light.
+			program = _point_light_program.get();
+			program->begin();
+			program->set_uniform("u_light_position", &light_position);
+			program->set_uniform("u_light_data", light_data);
+		}
 
-				program->end();
+		if(light.type == light_type::spot && _spot_light_program)
+		{
+			float light_data[4] = {light.spot_data.get_range(),
+								   math::cos(math::radians(light.spot_data.get_inner_angle() * 0.5f)),
+								   math::cos(math::radians(light.spot_data.get_outer_angle() * 0.5f)),
+								   0.0f};
+
+			shadowed = shadow_cache != nullptr && _spot_light_shadow_program != nullptr;
+
+			// Draw light.
+			program = shadowed ? _spot_light_shadow_program.get() : _spot_light_program.get();
+			program->begin();
+			program->set_uniform("u_light_position", &light_position);
+			program->set_uniform("u_light_direction", &light_direction);
+			program->set_uniform("u_light_data", light_data);
+		}
+
+		if(program)
+		{
+			float light_color_intensity[4] = {light.color.value.r, light.color.value.g,
+											  light.color.value.b, light.intensity};
+			auto camera_pos = camera.get_position();
+			program->set_uniform("u_light_color_intensity", light_color_intensity);
+			program->set_uniform("u_camera_position", &camera_pos);
+			program->set_texture(0, "s_tex0", g_buffer_fbo->get_texture(0).get());
+			program->set_texture(1, "s_tex1", g_buffer_fbo->get_texture(1).get());
+			program->set_texture(2, "s_tex2", g_buffer_fbo->get_texture(2).get());
+			program->set_texture(3, "s_tex3", g_buffer_fbo->get_texture(3).get());
+			program->set_texture(4, "s_tex4", g_buffer_fbo->get_texture(4).get());
+			program->set_texture(5, "s_tex5", refl_buffer);
+			program->set_texture(6, "s_tex6", _ibl_brdf_lut.get());
+
+			if(shadowed)
+			{
+				// Only the shadow variants declare these constants.
+				const auto& slot = shadow_cache->atlas_rect;
+				float shadow_rect[4] = {float(slot.left) / float(shadow_atlas_size.width),
+										float(slot.top) / float(shadow_atlas_size.height),
+										float(slot.width()) / float(shadow_atlas_size.width),
+										float(slot.height()) / float(shadow_atlas_size.height)};
+				float shadow_params[4] = {0.0015f, 0.0f, 0.0f, 0.0f};
+				program->set_uniform("u_light_shadow_matrix", &shadow_cache->view_proj);
+				program->set_uniform("u_shadow_rect", shadow_rect);
+				program->set_uniform("u_shadow_params", shadow_params);
+
+				auto atlas_depth = _shadow_atlas_view.get_depth_stencil_buffer(shadow_atlas_size);
+				program->set_texture(7, "s_tex7", atlas_depth.get());
 			}
-		});
+
+			gfx::set_scissor(rect.left, rect.top, rect.width(), rect.height());
+			auto topology = gfx::clip_quad(1.0f);
+			gfx::set_state(topology | BGFX_STATE_RGB_WRITE | BGFX_STATE_ALPHA_WRITE |
+						   BGFX_STATE_BLEND_ADD);
+			gfx::submit(pass.id, program->native_handle());
+			gfx::set_state(BGFX_STATE_DEFAULT);
+
+			program->end();
+		}
+	}
 
 	return l_buffer_fbo;
 }
@@ -529,7 +1751,7 @@ deferred_rendering::reflection_probe_pass(std::shared_ptr<gfx::frame_buffer> inp
 	const auto& view = camera.get_view();
 	const auto& proj = camera.get_projection();
 
-	const auto& viewport_size = camera.get_viewport_size();
+	const auto viewport_size = scale_viewport(camera.get_viewport_size());
 	auto g_buffer_fbo = render_view.get_g_buffer_fbo(viewport_size).get();
 
 	static auto refl_buffer_format = gfx::get_best_format(BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER,
@@ -551,7 +1773,7 @@ deferred_rendering::reflection_probe_pass(std::shared_ptr<gfx::frame_buffer> inp
 		[this, &camera, &pass, &buffer_size, &view, &proj, g_buffer_fbo](
 			entity e, transform_component& transform_comp_ref, reflection_probe_component& probe_comp_ref) {
 			const auto& probe = probe_comp_ref.get_probe();
-			const auto& world_transform = transform_comp_ref.get_transform();
+			const auto& world_transform = transform_comp_ref.get_render_transform();
 			const auto& probe_position = world_transform.get_position();
 
 			irect rect(0, 0, buffer_size.width, buffer_size.height);
@@ -630,7 +1852,7 @@ deferred_rendering::atmospherics_pass(std::shared_ptr<gfx::frame_buffer> input,
 	const auto& view = camera.get_view();
 	const auto& proj = camera.get_projection();
 	camera.set_far_clip(far_clip_cache);
-	const auto& viewport_size = camera.get_viewport_size();
+	const auto viewport_size = scale_viewport(camera.get_viewport_size());
 
 	static auto light_buffer_format = gfx::get_best_format(
 		BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER, gfx::format_search_flags::four_channels |
@@ -663,7 +1885,7 @@ deferred_rendering::atmospherics_pass(std::shared_ptr<gfx::frame_buffer> input,
 				if(light.type == light_type::directional)
 				{
 					found_sun = true;
-					const auto& world_transform = transform_comp_ref.get_transform();
+					const auto& world_transform = transform_comp_ref.get_render_transform();
 					light_direction = world_transform.z_unit_axis();
 				}
 			});
@@ -684,6 +1906,142 @@ deferred_rendering::atmospherics_pass(std::shared_ptr<gfx::frame_buffer> input,
 	return input;
 }
 
+namespace
+{
+//-----------------------------------------------------------------------------
+//  Name : radix_sort_by_key ()
+/// <summary>
+/// Stable LSD radix sort of order by keys - four counting passes over
+/// 256 buckets, linear in the draw count where a comparison sort would
+/// pay its log factor every frame.
+/// </summary>
+//-----------------------------------------------------------------------------
+void radix_sort_by_key(std::vector<std::uint32_t>& keys, std::vector<std::uint32_t>& order)
+{
+	std::vector<std::uint32_t> scratch_keys(keys.size());
+	std::vector<std::uint32_t> scratch_order(order.size());
+
+	for(std::uint32_t shift = 0; shift < 32; shift += 8)
+	{
+		std::uint32_t offsets[256] = {};
+		for(auto key : keys)
+			offsets[(key >> shift) & 0xff]++;
+
+		std::uint32_t running = 0;
+		for(auto& offset : offsets)
+		{
+			const auto count = offset;
+			offset = running;
+			running += count;
+		}
+
+		for(std::size_t i = 0; i < keys.size(); ++i)
+		{
+			const auto dst = offsets[(keys[i] >> shift) & 0xff]++;
+			scratch_keys[dst] = keys[i];
+			scratch_order[dst] = order[i];
+		}
+
+		keys.swap(scratch_keys);
+		order.swap(scratch_order);
+	}
+}
+}
+
+std::shared_ptr<gfx::frame_buffer>
+deferred_rendering::transparency_pass(std::shared_ptr<gfx::frame_buffer> input, camera& camera,
+									  gfx::render_view& render_view,
+									  visibility_set_models_t& visibility_set,
+									  lod_state_storage& camera_lods,
+									  std::chrono::duration<float> dt)
+{
+	if(!input)
+		return nullptr;
+
+	// Collect the transparent draws. Lod state was already advanced by the
+	// g-buffer pass this frame, so it is only read here.
+	struct transparent_draw
+	{
+		const model* mdl = nullptr;
+		const math::transform* world_transform = nullptr;
+		skinning_data* skinning = nullptr;
+		std::uint32_t lod = 0;
+	};
+
+	std::vector<transparent_draw> draws;
+	std::vector<std::uint32_t> keys;
+	std::vector<std::uint32_t> order;
+
+	const auto eye = camera.get_position();
+	const auto inv_clip_range =
+		1.0f / math::max(camera.get_far_clip() - camera.get_near_clip(), 0.0001f);
+
+	for(auto& element : visibility_set)
+	{
+		auto& e = std::get<0>(element);
+		auto* transform_comp_ptr = std::get<1>(element).get();
+		auto* model_comp_ptr = std::get<2>(element).get();
+		if(!transform_comp_ptr || !model_comp_ptr)
+			continue;
+
+		const auto& model = model_comp_ptr->get_model();
+		if(!model.is_valid() || !model.has_transparency())
+			continue;
+
+		transparent_draw draw;
+		draw.mdl = &model;
+		draw.world_transform = &transform_comp_ptr->get_render_transform();
+		draw.skinning = &model_comp_ptr->get_skinning_data();
+		draw.lod = camera_lods.get(e).current_lod_index;
+
+		// Back-to-front: the quantized distance is inverted so ascending
+		// key order draws the farthest surface first; the low byte keeps
+		// same-material runs together at equal depth, matching the key
+		// layout of the opaque path.
+		const float depth =
+			math::clamp(math::length(draw.world_transform->get_position() - eye) * inv_clip_range,
+						0.0f, 1.0f);
+		const auto depth_bits = 0xffffffu - std::uint32_t(depth * float(0xffffff));
+		const auto material_bits =
+			std::uint32_t(std::hash<const void*>()(model.get_material_for_group(0).get()) & 0xff);
+
+		keys.push_back((depth_bits << 8) | material_bits);
+		order.push_back(std::uint32_t(draws.size()));
+		draws.push_back(draw);
+	}
+
+	if(draws.empty())
+		return input;
+
+	radix_sort_by_key(keys, order);
+
+	// Blend onto the composed light buffer, testing against the scene
+	// depth but never writing it.
+	const auto& view = camera.get_view();
+	const auto& proj = camera.get_projection();
+	gfx::render_pass pass("transparency_fill");
+	pass.bind(input.get());
+	pass.set_view_proj(view, proj);
+
+	const auto clip_planes = math::vec2(camera.get_near_clip(), camera.get_far_clip());
+	const auto lod_params_full = math::vec3{0.0f, -1.0f, 1.0f};
+	for(auto index : order)
+	{
+		const auto& draw = draws[index];
+		draw.mdl->render(pass.id, *draw.world_transform, draw.skinning, true, false, true,
+						 BGFX_STATE_BLEND_ALPHA, draw.lod, nullptr,
+						 [&camera, &clip_planes, &lod_params_full](auto& p) {
+							 auto camera_pos = camera.get_position();
+							 p.set_uniform("u_camera_wpos", &camera_pos);
+							 p.set_uniform("u_camera_clip_planes", &clip_planes);
+							 p.set_uniform("u_lod_params", &lod_params_full);
+						 },
+						 {gfx::invalid_handle}, &camera, model::subset_filter::transparent_only);
+	}
+
+	return input;
+}
+
 std::shared_ptr<gfx::frame_buffer>
 deferred_rendering::tonemapping_pass(std::shared_ptr<gfx::frame_buffer> input, camera& camera,
 									 gfx::render_view& render_view)
@@ -716,6 +2074,26 @@ deferred_rendering::tonemapping_pass(std::shared_ptr<gfx::frame_buffer> input, c
 	return surface;
 }
 
+const math::bbox_extruded& deferred_rendering::get_caster_extrusion(entity caster, entity light_e,
+																	const math::bbox& world_bounds,
+																	const math::vec3& light_position,
+																	float light_range, bool caster_dirty)
+{
+	auto& entry = _extrusion_cache[{caster.id().id(), light_e.id().id()}];
+
+	const bool light_moved =
+		entry.light_position != light_position || entry.light_range != light_range;
+	if(!entry.valid || caster_dirty || light_moved)
+	{
+		entry.extruded.extrude(world_bounds, light_position, light_range);
+		entry.light_position = light_position;
+		entry.light_range = light_range;
+		entry.valid = true;
+	}
+
+	return entry.extruded;
+}
+
 void deferred_rendering::receive(entity e)
 {
 	_lod_data.erase(e);
@@ -723,6 +2101,15 @@ void deferred_rendering::receive(entity e)
 	{
 		pair.second.erase(e);
 	}
+
+	// drop extrusions this entity participated in, as caster or light
+	for(auto it = _extrusion_cache.begin(); it != _extrusion_cache.end();)
+	{
+		if(it->first.first == e.id().id() || it->first.second == e.id().id())
+			it = _extrusion_cache.erase(it);
+		else
+			++it;
+	}
 }
 deferred_rendering::deferred_rendering()
 {
@@ -736,12 +2123,18 @@ deferred_rendering::deferred_rendering()
 	auto fs_deferred_spot_light = am.load<gfx::shader>("engine:/data/shaders/fs_deferred_spot_light.sc");
 	auto fs_deferred_directional_light =
 		am.load<gfx::shader>("engine:/data/shaders/fs_deferred_directional_light.sc");
+	auto fs_deferred_spot_light_shadow =
+		am.load<gfx::shader>("engine:/data/shaders/fs_deferred_spot_light_shadow.sc");
+	auto fs_deferred_directional_light_shadow =
+		am.load<gfx::shader>("engine:/data/shaders/fs_deferred_directional_light_shadow.sc");
 	auto fs_gamma_correction = am.load<gfx::shader>("engine:/data/shaders/fs_gamma_correction.sc");
 	auto vs_clip_quad_ex = am.load<gfx::shader>("engine:/data/shaders/vs_clip_quad_ex.sc");
 	auto fs_sphere_reflection_probe =
 		am.load<gfx::shader>("engine:/data/shaders/fs_sphere_reflection_probe.sc");
 	auto fs_box_reflection_probe = am.load<gfx::shader>("engine:/data/shaders/fs_box_reflection_probe.sc");
 	auto fs_atmospherics = am.load<gfx::shader>("engine:/data/shaders/fs_atmospherics.sc");
+	auto fs_cubemap_prefilter = am.load<gfx::shader>("engine:/data/shaders/fs_cubemap_prefilter.sc");
+	auto fs_cubemap_irradiance = am.load<gfx::shader>("engine:/data/shaders/fs_cubemap_irradiance.sc");
 	_ibl_brdf_lut = am.load<gfx::texture>("engine:/data/textures/ibl_brdf_lut.png").get();
 
 	ts.push_or_execute_on_owner_thread(
@@ -764,6 +2157,18 @@ deferred_rendering::deferred_rendering()
 		},
 		vs_clip_quad, fs_deferred_directional_light);
 
+	ts.push_or_execute_on_owner_thread(
+		[this](asset_handle<gfx::shader> vs, asset_handle<gfx::shader> fs) {
+			_spot_light_shadow_program = std::make_unique<gpu_program>(vs, fs);
+		},
+		vs_clip_quad, fs_deferred_spot_light_shadow);
+
+	ts.push_or_execute_on_owner_thread(
+		[this](asset_handle<gfx::shader> vs, asset_handle<gfx::shader> fs) {
+			_directional_light_shadow_program = std::make_unique<gpu_program>(vs, fs);
+		},
+		vs_clip_quad, fs_deferred_directional_light_shadow);
+
 	ts.push_or_execute_on_owner_thread(
 		[this](asset_handle<gfx::shader> vs, asset_handle<gfx::shader> fs) {
 			_gamma_correction_program = std::make_unique<gpu_program>(vs, fs);
@@ -791,11 +2196,34 @@ deferred_rendering::deferred_rendering()
 
 		},
 		vs_clip_quad_ex, fs_atmospherics);
+
+	ts.push_or_execute_on_owner_thread(
+		[this](asset_handle<gfx::shader> vs, asset_handle<gfx::shader> fs) {
+			_cubemap_prefilter_program = std::make_unique<gpu_program>(vs, fs);
+
+		},
+		vs_clip_quad, fs_cubemap_prefilter);
+
+	ts.push_or_execute_on_owner_thread(
+		[this](asset_handle<gfx::shader> vs, asset_handle<gfx::shader> fs) {
+			_cubemap_irradiance_program = std::make_unique<gpu_program>(vs, fs);
+
+		},
+		vs_clip_quad, fs_cubemap_irradiance);
 }
 
 deferred_rendering::~deferred_rendering()
 {
 	on_entity_destroyed.disconnect(this, &deferred_rendering::receive);
 	on_frame_render.disconnect(this, &deferred_rendering::frame_render);
+
+	for(auto& per_camera : _occlusion_queries)
+	{
+		for(auto& record : per_camera.second)
+		{
+			if(record.second.query.idx != gfx::invalid_handle)
+				gfx::destroy(record.second.query);
+		}
+	}
 }
 }
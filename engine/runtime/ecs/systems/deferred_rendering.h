@@ -1,16 +1,24 @@
 #pragma once
 
 #include "../../rendering/gpu_program.h"
+#include "../../rendering/light_cluster.h"
+#include "core/graphics/render_view.h"
+#include "core/tasks/task_system.h"
 #include "../components/model_component.h"
 #include "../components/transform_component.h"
 #include "../ecs.h"
+#include "render_snapshot.h"
 
 #include <chrono>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <tuple>
+#include <unordered_set>
 #include <vector>
 
 class camera;
+class reflection_probe_component;
 
 namespace gfx
 {
@@ -28,8 +36,50 @@ struct lod_data
 	float current_time = 0.0f;
 };
 
+/// Per-camera LOD state, stored flat and indexed by the entity's slot
+/// index. The visibility loops touch one entry per visible model every
+/// frame, so the lookup is an array index plus a generation check
+/// instead of a hash probe; a stale generation means the slot was
+/// recycled and the state resets to defaults.
+class lod_state_storage
+{
+public:
+	lod_data& get(const entity& e)
+	{
+		const auto index = e.id().index();
+		const auto version = e.id().version();
+		if(index >= _slots.size())
+			_slots.resize(index + 1);
+
+		auto& slot = _slots[index];
+		if(slot.version != version)
+		{
+			slot.version = version;
+			slot.data = {};
+		}
+		return slot.data;
+	}
+
+	void erase(const entity& e)
+	{
+		const auto index = e.id().index();
+		if(index < _slots.size() && _slots[index].version == e.id().version())
+			_slots[index] = {};
+	}
+
+private:
+	struct slot
+	{
+		/// entity generation the state belongs to; 0 = empty
+		std::uint32_t version = 0;
+		lod_data data;
+	};
+
+	std::vector<slot> _slots;
+};
+
 using visibility_set_models_t =
-	std::vector<std::tuple<entity, chandle<transform_component>, chandle<model_component>>>;
+	std::vector<std::tuple<entity, component_handle<transform_component>, component_handle<model_component>>>;
 
 class deferred_rendering
 {
@@ -46,7 +96,8 @@ public:
 	//-----------------------------------------------------------------------------
 	visibility_set_models_t gather_visible_models(entity_component_system& ecs, camera* camera,
 												  bool dirty_only = false, bool static_only = true,
-												  bool require_reflection_caster = false);
+												  bool require_reflection_caster = false,
+												  bool temporal_coherence = true);
 	//-----------------------------------------------------------------------------
 	//  Name : frame_render (virtual )
 	/// <summary>
@@ -77,6 +128,18 @@ public:
 	//-----------------------------------------------------------------------------
 	void build_reflections_pass(entity_component_system& ecs, std::chrono::duration<float> dt);
 
+	//-----------------------------------------------------------------------------
+	//  Name : convolve_probe_pass ()
+	/// <summary>
+	/// GPU convolution of a probe cubemap whose six faces are complete:
+	/// importance-sampled GGX prefilter into the smaller mips (one roughness
+	/// step per mip) and a cosine irradiance convolution into the bottom mip
+	/// for diffuse. Falls back to plain auto-generated mips while the filter
+	/// programs are still loading.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void convolve_probe_pass(reflection_probe_component& reflection_probe_comp);
+
 	//-----------------------------------------------------------------------------
 	//  Name : build_shadows ()
 	/// <summary>
@@ -107,7 +170,20 @@ public:
 	//-----------------------------------------------------------------------------
 	std::shared_ptr<gfx::frame_buffer> deferred_render_full(camera& camera, gfx::render_view& render_view,
 															entity_component_system& ecs,
-															std::unordered_map<entity, lod_data>& camera_lods,
+															lod_state_storage& camera_lods,
+															std::chrono::duration<float> dt);
+
+	//-----------------------------------------------------------------------------
+	//  Name : scene_pass ()
+	/// <summary>
+	/// Variant consuming an already gathered visibility set, e.g. one joined
+	/// from a task kicked in frame_render.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::shared_ptr<gfx::frame_buffer> deferred_render_full(camera& camera, gfx::render_view& render_view,
+															entity_component_system& ecs,
+															visibility_set_models_t& visibility_set,
+															lod_state_storage& camera_lods,
 															std::chrono::duration<float> dt);
 
 	//-----------------------------------------------------------------------------
@@ -121,7 +197,7 @@ public:
 	std::shared_ptr<gfx::frame_buffer> g_buffer_pass(std::shared_ptr<gfx::frame_buffer> input, camera& camera,
 													 gfx::render_view& render_view,
 													 visibility_set_models_t& visibility_set,
-													 std::unordered_map<entity, lod_data>& camera_lods,
+													 lod_state_storage& camera_lods,
 													 std::chrono::duration<float> dt);
 
 	//-----------------------------------------------------------------------------
@@ -162,6 +238,20 @@ public:
 														 entity_component_system& ecs,
 														 std::chrono::duration<float> dt);
 
+	//-----------------------------------------------------------------------------
+	//  Name : transparency_pass ()
+	/// <summary>
+	/// Draws the transparent subsets of the visibility set onto the
+	/// composed light buffer, radix-sorted back-to-front by quantized
+	/// view depth, blended and without depth writes.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::shared_ptr<gfx::frame_buffer> transparency_pass(std::shared_ptr<gfx::frame_buffer> input,
+														 camera& camera, gfx::render_view& render_view,
+														 visibility_set_models_t& visibility_set,
+														 lod_state_storage& camera_lods,
+														 std::chrono::duration<float> dt);
+
 	//-----------------------------------------------------------------------------
 	//  Name : tonemapping_pass ()
 	/// <summary>
@@ -173,23 +263,226 @@ public:
 	std::shared_ptr<gfx::frame_buffer> tonemapping_pass(std::shared_ptr<gfx::frame_buffer> input,
 														camera& camera, gfx::render_view& render_view);
 
+	//-----------------------------------------------------------------------------
+	//  Name : set_dynamic_resolution_enabled ()
+	/// <summary>
+	/// Toggles gpu-feedback driven resolution scaling of the internal
+	/// passes. Disabling snaps back to full resolution.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_dynamic_resolution_enabled(bool enabled);
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_target_frame_time ()
+	/// <summary>
+	/// Gpu frame-time budget the resolution controller steers towards,
+	/// in milliseconds.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_target_frame_time(float milliseconds);
+
+	float get_resolution_scale() const
+	{
+		return _resolution_scale;
+	}
+
 private:
-	std::unordered_map<entity, std::unordered_map<entity, lod_data>> _lod_data;
+	//-----------------------------------------------------------------------------
+	//  Name : update_resolution_scale ()
+	/// <summary>
+	/// Steps the resolution scale from the gpu timer feedback of previous
+	/// frames; over budget drops a step, comfortable headroom climbs one.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void update_resolution_scale();
+
+	//-----------------------------------------------------------------------------
+	//  Name : scale_viewport ()
+	/// <summary>
+	/// Applies the current resolution scale to a viewport size.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	usize scale_viewport(const usize& size) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : update_hlod_clusters ()
+	/// <summary>
+	/// Decides per HLOD cluster whether the merged proxy or its member
+	/// entities render this frame, from the cluster's projected screen
+	/// size. The losing side lands in _hlod_hidden, which every
+	/// visibility gather consults.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void update_hlod_clusters(entity_component_system& ecs);
+
+	/// Double-buffered copy of render-relevant scene state. The back
+	/// snapshot is captured at the start of frame_render and flipped; all
+	/// visibility gathering reads the front one, keeping the render passes
+	/// off live simulation state.
+	render_snapshot_buffer _snapshots;
+	/// Previous-frame occlusion query per (camera, entity). A model drawn
+	/// with its query is GPU-tested against the depth it rendered to; the
+	/// next frame's gather drops instances whose query came back invisible
+	/// and periodically re-issues them so revealed geometry pops back in.
+	struct occlusion_record
+	{
+		gfx::occlusion_query_handle query = {gfx::invalid_handle};
+		std::uint64_t last_issue_frame = 0;
+	};
+
+	std::unordered_map<const camera*, std::unordered_map<std::uint64_t, occlusion_record>>
+		_occlusion_queries;
+	/// Per-camera frustum coherency cache: for every instance the index of
+	/// the plane that rejected it last frame (-1 when it was visible). Lets
+	/// gather_visible_models retest yesterday's separating plane first and
+	/// early-out with a single dot product for still-culled instances.
+	std::unordered_map<const camera*, std::unordered_map<std::uint64_t, int>> _visibility_coherence;
+	/// Cached shadow state for one shadow-casting light. Static casters are
+	/// rendered once into a persistent per-light depth target and only
+	/// re-rendered when the light or static geometry changed; dynamic
+	/// casters are composited on top of a blit of that depth every frame.
+	struct shadow_map_cache
+	{
+		/// persistent per-light targets (static depth + composite)
+		gfx::render_view render_view;
+		/// when false the static depth is re-rendered this frame
+		bool static_casters_valid = false;
+		/// resolution the cached targets were allocated at; scales with
+		/// the light's screen contribution in power-of-two steps
+		usize shadow_map_size = {0, 0};
+		/// this light's slot within the shared shadow atlas; empty when
+		/// the light overflowed into a dedicated target this frame
+		urect atlas_rect;
+		/// world-to-shadow-clip matrix the depth was rendered with;
+		/// consumed by the shadowed lighting shader variants
+		math::transform view_proj;
+	};
+
+	std::unordered_map<entity, shadow_map_cache> _shadow_caches;
+
+	//-----------------------------------------------------------------------------
+	//  Name : extrusion_cache_entry (Struct)
+	/// <summary>
+	/// Cached silhouette extrusion for one (caster, light) pair, together
+	/// with the light origin and range it was computed against.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	struct extrusion_cache_entry
+	{
+		/// precomputed silhouette planes of the caster as lit
+		math::bbox_extruded extruded;
+		/// light origin the extrusion was built with
+		math::vec3 light_position = {0.0f, 0.0f, 0.0f};
+		/// extrusion range the planes were projected by
+		float light_range = 0.0f;
+		/// false forces a recompute on next lookup
+		bool valid = false;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_caster_extrusion ()
+	/// <summary>
+	/// Returns the extruded bounds of a caster under a light, recomputing
+	/// only when the caster was touched or the light origin/range moved.
+	/// Static geometry under static lights hits the cache every frame.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const math::bbox_extruded& get_caster_extrusion(entity caster, entity light_e,
+													const math::bbox& world_bounds,
+													const math::vec3& light_position, float light_range,
+													bool caster_dirty);
+
+	/// Shadow-relevance extrusions keyed by (caster id, light id).
+	std::map<std::pair<std::uint64_t, std::uint64_t>, extrusion_cache_entry> _extrusion_cache;
+
+	/// Shared atlas depth target all non-overflowing shadow maps
+	/// composite into, one viewport per light.
+	gfx::render_view _shadow_atlas_view;
+
+	/// Key for the per-frame visibility cache: which frustum was culled
+	/// against and with which filter flags.
+	struct visibility_cache_key
+	{
+		std::size_t frustum_hash = 0;
+		bool dirty_only = false;
+		bool static_only = false;
+		bool require_reflection_caster = false;
+
+		bool operator==(const visibility_cache_key& rhs) const
+		{
+			return frustum_hash == rhs.frustum_hash && dirty_only == rhs.dirty_only &&
+				   static_only == rhs.static_only &&
+				   require_reflection_caster == rhs.require_reflection_caster;
+		}
+	};
+
+	struct visibility_cache_key_hash
+	{
+		std::size_t operator()(const visibility_cache_key& key) const
+		{
+			return key.frustum_hash ^ (std::size_t(key.dirty_only) << 1) ^
+				   (std::size_t(key.static_only) << 2) ^
+				   (std::size_t(key.require_reflection_caster) << 3);
+		}
+	};
+
+	/// Gathers computed so far this frame. Passes culling the same frustum
+	/// reuse the set directly or refine a cached superset (looser filter
+	/// flags) instead of rescanning every instance; cleared on every
+	/// snapshot flip. Guarded by a mutex because gathers run as tasks.
+	std::unordered_map<visibility_cache_key, visibility_set_models_t, visibility_cache_key_hash>
+		_visibility_cache;
+	std::mutex _visibility_cache_mutex;
+	/// Visibility gathers kicked on the task system at the top of
+	/// frame_render and joined by the passes right before submission;
+	/// invalid/empty when the passes run standalone.
+	core::task_future<visibility_set_models_t> _dirty_models_future;
+	std::unordered_map<entity, core::task_future<visibility_set_models_t>> _camera_gathers;
+	/// flat per-camera LOD state; the outer map only holds one entry per
+	/// active camera
+	std::unordered_map<entity, lod_state_storage> _lod_data;
+	/// Entities suppressed by the HLOD swap this frame: cluster members
+	/// while their proxy is active, proxies while their members render.
+	std::unordered_set<entity> _hlod_hidden;
+	/// View-space clustered light binning rebuilt by the lighting pass; lights
+	/// covering zero clusters are skipped before any state is bound.
+	light_cluster _light_clusters;
 	/// Program that is responsible for rendering.
 	std::unique_ptr<gpu_program> _directional_light_program;
 	/// Program that is responsible for rendering.
 	std::unique_ptr<gpu_program> _point_light_program;
 	/// Program that is responsible for rendering.
 	std::unique_ptr<gpu_program> _spot_light_program;
+	/// Shadow-sampling variant, selected when the light has an atlas slot.
+	std::unique_ptr<gpu_program> _directional_light_shadow_program;
+	/// Shadow-sampling variant, selected when the light has an atlas slot.
+	std::unique_ptr<gpu_program> _spot_light_shadow_program;
 	/// Program that is responsible for rendering.
 	std::unique_ptr<gpu_program> _box_ref_probe_program;
 	/// Program that is responsible for rendering.
 	std::unique_ptr<gpu_program> _sphere_ref_probe_program;
+	/// Specular prefilter of probe cubemap mips.
+	std::unique_ptr<gpu_program> _cubemap_prefilter_program;
+	/// Diffuse irradiance convolution of the probe cubemap's bottom mip.
+	std::unique_ptr<gpu_program> _cubemap_irradiance_program;
 	/// Program that is responsible for rendering.
 	std::unique_ptr<gpu_program> _gamma_correction_program;
 	/// Program that is responsible for rendering.
 	std::unique_ptr<gpu_program> _atmospherics_program;
 
 	asset_handle<gfx::texture> _ibl_brdf_lut;
+
+	/// Dynamic resolution state. The internal passes (g-buffer through
+	/// atmospherics) render at viewport * scale and the tonemapping pass
+	/// upscales into the full-size output surface; the scale moves in
+	/// quantized steps with a cooldown so the render_view target cache
+	/// only re-allocates on an actual step change, and the controller
+	/// never steers off timings that predate the last change.
+	bool _dynamic_resolution_enabled = true;
+	float _resolution_scale = 1.0f;
+	/// gpu budget the controller steers towards
+	float _target_frame_time_ms = 1000.0f / 60.0f;
+	/// frames to wait before the next adjustment
+	std::uint32_t _scale_cooldown = 0;
 };
 }
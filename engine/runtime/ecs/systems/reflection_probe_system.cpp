@@ -1,25 +1,204 @@
 #include "reflection_probe_system.h"
 #include "../../system/events.h"
+#include "../components/camera_component.h"
 #include "../components/reflection_probe_component.h"
+#include "../components/transform_component.h"
 #include "core/system/subsystem.h"
+#include "system_scheduler.h"
+
+#include <algorithm>
 
 namespace runtime
 {
+namespace
+{
+//-----------------------------------------------------------------------------
+//  Name : probe_contribution ()
+/// <summary>
+/// Rough screen-space contribution of a probe as seen from the viewer:
+/// projected radius over distance. Probes filling more of the screen win the
+/// per-frame face budget first.
+/// </summary>
+//-----------------------------------------------------------------------------
+float probe_contribution(const reflection_probe& probe, const math::vec3& probe_position,
+						 const math::vec3& viewer_position)
+{
+	float radius = 0.0f;
+	if(probe.type == probe_type::box)
+		radius = math::length(probe.box_data.extents);
+	else
+		radius = probe.sphere_data.range;
+
+	const float distance = math::length(probe_position - viewer_position);
+	return radius / math::max(distance, 0.1f);
+}
+}
+
 void reflection_probe_system::frame_update(std::chrono::duration<float> dt)
 {
 	auto& ecs = core::get_subsystem<entity_component_system>();
 
 	ecs.for_each<reflection_probe_component>(
 		[](entity e, reflection_probe_component& probe) { probe.update(); });
+
+	// Hand out this frame's face budget.
+	_granted_faces.clear();
+	_granted_filters.clear();
+	if(_queue.empty() && _filter_queue.empty())
+		return;
+
+	// Viewer position for the contribution estimates: the first scene camera.
+	math::vec3 viewer_position{0.0f, 0.0f, 0.0f};
+	bool viewer_found = false;
+	ecs.for_each<transform_component, camera_component>(
+		[&viewer_position, &viewer_found](entity e, transform_component& transform_comp,
+										  camera_component& camera_comp) {
+			if(viewer_found)
+				return;
+			viewer_position = transform_comp.get_position();
+			viewer_found = true;
+		});
+
+	// Drop stale probes and order the rest by contribution; the stable sort
+	// keeps request order for ties so equally sized probes take turns.
+	std::vector<std::pair<float, entity>> ordered;
+	ordered.reserve(_queue.size());
+	for(auto e : _queue)
+	{
+		if(!e.valid() || !e.has_component<reflection_probe_component>() ||
+		   !e.has_component<transform_component>())
+		{
+			_pending_faces.erase(e);
+			continue;
+		}
+
+		const auto& probe = e.get_component<reflection_probe_component>().lock()->get_probe();
+		const auto& probe_position = e.get_component<transform_component>().lock()->get_position();
+		ordered.emplace_back(probe_contribution(probe, probe_position, viewer_position), e);
+	}
+	std::stable_sort(ordered.begin(), ordered.end(),
+					 [](const std::pair<float, entity>& lhs, const std::pair<float, entity>& rhs) {
+						 return lhs.first > rhs.first;
+					 });
+
+	std::uint32_t budget = _faces_per_frame;
+	for(const auto& entry : ordered)
+	{
+		if(budget == 0)
+			break;
+
+		auto e = entry.second;
+		auto& pending = _pending_faces[e];
+		std::uint32_t granted = 0;
+		for(std::uint32_t face = 0; face < 6 && budget > 0; ++face)
+		{
+			const std::uint32_t bit = 1u << face;
+			if((pending & bit) == 0)
+				continue;
+			pending &= ~bit;
+			granted |= bit;
+			--budget;
+		}
+		if(granted != 0)
+			_granted_faces[e] = granted;
+	}
+
+	// Rebuild the queue without fully served or stale probes.
+	std::deque<entity> still_pending;
+	for(auto e : _queue)
+	{
+		const auto it = _pending_faces.find(e);
+		if(it == _pending_faces.end())
+			continue;
+		if(it->second == 0)
+		{
+			_pending_faces.erase(it);
+			continue;
+		}
+		still_pending.push_back(e);
+	}
+	_queue.swap(still_pending);
+
+	// Whatever budget the face renders left over goes to queued
+	// convolutions, one slot per probe, oldest request first. A probe that
+	// regained pending faces (it was re-requested mid-filter) waits until
+	// its cubemap is complete again.
+	std::deque<entity> still_filtering;
+	for(auto e : _filter_queue)
+	{
+		if(!e.valid() || !e.has_component<reflection_probe_component>())
+			continue;
+
+		if(budget > 0 && !has_pending_faces(e))
+		{
+			_granted_filters[e] = true;
+			--budget;
+			continue;
+		}
+		still_filtering.push_back(e);
+	}
+	_filter_queue.swap(still_filtering);
+}
+
+void reflection_probe_system::request_rebuild(entity probe)
+{
+	auto& pending = _pending_faces[probe];
+	if(pending == 0)
+		_queue.push_back(probe);
+	pending = 0x3f; // all six faces
+}
+
+bool reflection_probe_system::is_face_granted(entity probe, std::uint32_t face) const
+{
+	const auto it = _granted_faces.find(probe);
+	if(it == _granted_faces.end())
+		return false;
+	return (it->second & (1u << face)) != 0;
+}
+
+bool reflection_probe_system::has_pending_faces(entity probe) const
+{
+	const auto it = _pending_faces.find(probe);
+	return it != _pending_faces.end() && it->second != 0;
+}
+
+void reflection_probe_system::request_filter(entity probe)
+{
+	if(std::find(_filter_queue.begin(), _filter_queue.end(), probe) == _filter_queue.end())
+		_filter_queue.push_back(probe);
+}
+
+bool reflection_probe_system::is_filter_granted(entity probe) const
+{
+	return _granted_filters.find(probe) != _granted_filters.end();
 }
 
 reflection_probe_system::reflection_probe_system()
 {
-	on_frame_update.connect(this, &reflection_probe_system::frame_update);
+	if(core::has_subsystems<system_scheduler>())
+	{
+		system_scheduler::system_desc desc;
+		desc.name = "reflection_probe_system";
+		desc.reads = system_scheduler::make_mask<transform_component, camera_component>();
+		desc.writes = system_scheduler::make_mask<reflection_probe_component>();
+		desc.on_update = [this](std::chrono::duration<float> dt) { frame_update(dt); };
+		core::get_subsystem<system_scheduler>().register_system(std::move(desc));
+	}
+	else
+	{
+		on_frame_update.connect(this, &reflection_probe_system::frame_update);
+	}
 }
 
 reflection_probe_system::~reflection_probe_system()
 {
-	on_frame_update.disconnect(this, &reflection_probe_system::frame_update);
+	if(core::has_subsystems<system_scheduler>())
+	{
+		core::get_subsystem<system_scheduler>().unregister_system("reflection_probe_system");
+	}
+	else
+	{
+		on_frame_update.disconnect(this, &reflection_probe_system::frame_update);
+	}
 }
 }
@@ -1,6 +1,11 @@
 #pragma once
 
+#include "../ecs.h"
 #include <chrono>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+
 namespace runtime
 {
 class reflection_probe_system
@@ -17,5 +22,85 @@ public:
 	/// </summary>
 	//-----------------------------------------------------------------------------
 	void frame_update(std::chrono::duration<float> dt);
+
+	//-----------------------------------------------------------------------------
+	//  Name : request_rebuild ()
+	/// <summary>
+	/// Queues all six cubemap faces of the probe for re-render. Requests are
+	/// amortized: each frame at most get_faces_per_frame() faces are granted
+	/// across all probes, highest screen-space contribution first, so a
+	/// moved probe never costs six scene renders in a single frame.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void request_rebuild(entity probe);
+
+	//-----------------------------------------------------------------------------
+	//  Name : is_face_granted ()
+	/// <summary>
+	/// Whether the given cubemap face fits into this frame's face budget and
+	/// should be rendered now. Granted faces are consumed from the pending
+	/// queue; ungranted ones stay queued for the coming frames.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool is_face_granted(entity probe, std::uint32_t face) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : has_pending_faces ()
+	/// <summary>
+	/// Whether the probe still has queued faces awaiting a render slot.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool has_pending_faces(entity probe) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : request_filter ()
+	/// <summary>
+	/// Queues the probe's GPU convolution (specular prefilter of the mip
+	/// chain plus the diffuse irradiance mip). Filters share the per-frame
+	/// face budget with face renders but only run once all six faces have
+	/// landed, so a rebuilt probe never filters a half-updated cubemap.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void request_filter(entity probe);
+
+	//-----------------------------------------------------------------------------
+	//  Name : is_filter_granted ()
+	/// <summary>
+	/// Whether the probe's queued convolution fits into this frame's budget
+	/// and should run now.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool is_filter_granted(entity probe) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_faces_per_frame ()
+	/// <summary>
+	/// Adjusts the per-frame face budget shared by all probes.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_faces_per_frame(std::uint32_t count)
+	{
+		_faces_per_frame = count;
+	}
+
+	std::uint32_t get_faces_per_frame() const
+	{
+		return _faces_per_frame;
+	}
+
+private:
+	/// probes with queued faces, in request order; ties in contribution keep
+	/// this order so probes progress round-robin
+	std::deque<entity> _queue;
+	/// per-probe bitmask of faces still awaiting their render slot
+	std::unordered_map<entity, std::uint32_t> _pending_faces;
+	/// per-probe bitmask of faces granted for the current frame
+	std::unordered_map<entity, std::uint32_t> _granted_faces;
+	/// probes whose cubemaps are complete and await their convolution slot
+	std::deque<entity> _filter_queue;
+	/// probes granted a convolution for the current frame
+	std::unordered_map<entity, bool> _granted_filters;
+	/// how many cubemap faces may be re-rendered per frame in total
+	std::uint32_t _faces_per_frame = 2;
 };
 }
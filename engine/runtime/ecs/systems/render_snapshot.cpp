@@ -0,0 +1,146 @@
+#include "render_snapshot.h"
+
+#include <algorithm>
+
+namespace runtime
+{
+namespace
+{
+//-----------------------------------------------------------------------------
+//  Name : expand_bits_10 ()
+/// <summary>
+/// Spreads the lower 10 bits of the value so that two zero bits separate
+/// each original bit - one axis of a 3d Morton code.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::uint32_t expand_bits_10(std::uint32_t v)
+{
+	v = (v * 0x00010001u) & 0xFF0000FFu;
+	v = (v * 0x00000101u) & 0x0F00F00Fu;
+	v = (v * 0x00000011u) & 0xC30C30C3u;
+	v = (v * 0x00000005u) & 0x49249249u;
+	return v;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : morton_encode ()
+/// <summary>
+/// 30-bit Morton code of a world position, quantized onto a 1024^3 grid
+/// of 4 meter cells centered on the origin. Positions outside the grid
+/// clamp to the border cell - they still sort together, just without
+/// sub-cell ordering.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::uint64_t morton_encode(const math::vec3& position)
+{
+	const float cell_size = 4.0f;
+	const float half_extent = 512.0f;
+	auto quantize = [&](float v) {
+		float cell = v / cell_size + half_extent;
+		cell = math::clamp(cell, 0.0f, 1023.0f);
+		return static_cast<std::uint32_t>(cell);
+	};
+
+	const auto x = expand_bits_10(quantize(position.x));
+	const auto y = expand_bits_10(quantize(position.y));
+	const auto z = expand_bits_10(quantize(position.z));
+	return static_cast<std::uint64_t>((x << 2) | (y << 1) | z);
+}
+}
+
+void render_snapshot::capture(entity_component_system& ecs)
+{
+	frame = runtime::ecs::get_frame();
+	models.clear();
+
+	auto chunks = ecs.chunked_entities_with_components<transform_component, model_component>();
+	for(const auto& chunk : chunks)
+	{
+		const auto& transforms = chunk.get<transform_component>();
+		const auto& mods = chunk.get<model_component>();
+		for(std::size_t i = 0; i < chunk.entities.size(); ++i)
+		{
+			auto entity = chunk.entities[i];
+			auto* transform_comp_ptr = transforms[i];
+			auto* model_comp_ptr = mods[i];
+
+			model_instance instance;
+			instance.e = entity;
+			instance.transform_comp = ecs.get_component_handle<transform_component>(entity.id());
+			instance.model_comp = ecs.get_component_handle<model_component>(entity.id());
+			instance.world_transform = transform_comp_ptr->get_transform();
+			instance.world_bounds = model_comp_ptr->get_world_bounds(*transform_comp_ptr);
+			instance.is_static = model_comp_ptr->is_static();
+			instance.casts_reflection = model_comp_ptr->casts_reflection();
+			instance.touched = transform_comp_ptr->is_touched() || model_comp_ptr->is_touched();
+
+			const auto center = instance.world_bounds.is_populated()
+									? instance.world_bounds.get_center()
+									: instance.world_transform.get_position();
+			instance.spatial_key = morton_encode(center);
+			models.push_back(std::move(instance));
+		}
+	}
+
+	if(sort_spatially)
+	{
+		sort_by_spatial_key();
+	}
+}
+
+void render_snapshot::sort_by_spatial_key()
+{
+	const auto count = models.size();
+	if(count < 2)
+	{
+		return;
+	}
+
+	// The capture order is stable chunk order, so the permutation from the
+	// last sort keeps producing a sorted array as long as nothing moved
+	// across a cell boundary and the entity set did not change shape.
+	if(_spatial_order.size() == count)
+	{
+		bool still_sorted = true;
+		std::uint64_t previous_key = 0;
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			const auto key = models[_spatial_order[i]].spatial_key;
+			if(key < previous_key)
+			{
+				still_sorted = false;
+				break;
+			}
+			previous_key = key;
+		}
+
+		if(still_sorted)
+		{
+			_sort_scratch.resize(count);
+			for(std::size_t i = 0; i < count; ++i)
+			{
+				_sort_scratch[i] = std::move(models[_spatial_order[i]]);
+			}
+			models.swap(_sort_scratch);
+			return;
+		}
+	}
+
+	_spatial_order.resize(count);
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		_spatial_order[i] = static_cast<std::uint32_t>(i);
+	}
+	std::sort(std::begin(_spatial_order), std::end(_spatial_order),
+			  [this](std::uint32_t lhs, std::uint32_t rhs) {
+				  return models[lhs].spatial_key < models[rhs].spatial_key;
+			  });
+
+	_sort_scratch.resize(count);
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		_sort_scratch[i] = std::move(models[_spatial_order[i]]);
+	}
+	models.swap(_sort_scratch);
+}
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "../components/model_component.h"
+#include "../components/transform_component.h"
+#include "../ecs.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace runtime
+{
+/// Compact, camera-independent copy of the render-relevant scene state of
+/// one simulated frame. Captured once after simulation, then consumed by
+/// the render passes, so the next simulation tick is free to mutate live
+/// components while rendering still reads coherent data.
+struct render_snapshot
+{
+	struct model_instance
+	{
+		entity e;
+		/// Generation-checked handles for state that is only needed at
+		/// draw time (meshes, bone palettes).
+		component_handle<transform_component> transform_comp;
+		component_handle<model_component> model_comp;
+		/// World transform at capture time.
+		math::transform world_transform;
+		/// World-space bounds at capture time, copied from the component
+		/// cache so the visibility gathers can batch-classify straight off
+		/// the snapshot. Unpopulated while the mesh is still streaming.
+		math::bbox world_bounds;
+		bool is_static = false;
+		bool casts_reflection = false;
+		/// Whether transform or model were touched this frame.
+		bool touched = false;
+		/// Morton code of the world bounds center; the instance array is
+		/// kept sorted by it so culling walks memory in spatial order.
+		std::uint64_t spatial_key = 0;
+	};
+
+	/// Frame the snapshot was captured on.
+	std::uint64_t frame = 0;
+	std::vector<model_instance> models;
+	/// When set (default), capture() sorts the instances by Morton code of
+	/// their bounds center. Neighbouring array entries are then neighbours
+	/// in space, so the visibility gathers stream bounds sequentially and
+	/// frustum rejections cluster into runs instead of scattering.
+	bool sort_spatially = true;
+
+	//-----------------------------------------------------------------------------
+	//  Name : capture ()
+	/// <summary>
+	/// Overwrites this snapshot with the current render-relevant state of
+	/// all entities carrying a transform and a model.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void capture(entity_component_system& ecs);
+
+private:
+	//-----------------------------------------------------------------------------
+	//  Name : sort_by_spatial_key ()
+	/// <summary>
+	/// Reorders the freshly captured instance array by spatial_key. The
+	/// permutation from the previous capture is tried first and the sort
+	/// only reruns when movement actually broke the ordering, so static
+	/// scenes pay a linear reshuffle instead of a sort every frame.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void sort_by_spatial_key();
+
+	/// Permutation (sorted index -> capture index) of the last sort, reused
+	/// while it still yields a sorted array.
+	std::vector<std::uint32_t> _spatial_order;
+	/// Scratch array the permutation is applied into, kept to avoid
+	/// reallocating every frame.
+	std::vector<model_instance> _sort_scratch;
+};
+
+/// Double buffer of snapshots: simulation state is captured into the back
+/// snapshot while render passes consume the front one; swap() flips the
+/// two at the frame boundary.
+class render_snapshot_buffer
+{
+public:
+	render_snapshot& back()
+	{
+		return _snapshots[_back];
+	}
+	const render_snapshot& front() const
+	{
+		return _snapshots[1 - _back];
+	}
+	void swap()
+	{
+		_back = 1 - _back;
+	}
+
+private:
+	render_snapshot _snapshots[2];
+	std::size_t _back = 0;
+};
+}
@@ -1,13 +1,134 @@
 #include "scene_graph.h"
 #include "../../system/events.h"
 #include "../components/transform_component.h"
+#include "core/profiler/profiler.h"
+#include "core/simulation/simulation.h"
 #include "core/system/subsystem.h"
+#include "core/tasks/task_system.h"
+#include "system_scheduler.h"
+#include <algorithm>
 
 namespace runtime
 {
 
+namespace
+{
+void resolve_subtree(const entity& e)
+{
+	auto transform = e.get_component<transform_component>().lock();
+	if(!transform)
+		return;
+
+	// Parents are resolved before their children are visited, so each
+	// node computes its world matrix exactly once.
+	transform->resolve();
+	for(const auto& child : transform->get_children())
+	{
+		if(child.valid())
+			resolve_subtree(child);
+	}
+}
+
+void snapshot_subtree(const entity& e)
+{
+	auto transform = e.get_component<transform_component>().lock();
+	if(!transform)
+		return;
+
+	transform->snapshot_tick_transform();
+	for(const auto& child : transform->get_children())
+	{
+		if(child.valid())
+			snapshot_subtree(child);
+	}
+}
+
+void interpolate_subtree(const entity& e, float alpha)
+{
+	auto transform = e.get_component<transform_component>().lock();
+	if(!transform)
+		return;
+
+	transform->update_render_transform(alpha);
+	for(const auto& child : transform->get_children())
+	{
+		if(child.valid())
+			interpolate_subtree(child, alpha);
+	}
+}
+
+void clear_interpolation_subtree(const entity& e)
+{
+	auto transform = e.get_component<transform_component>().lock();
+	if(!transform)
+		return;
+
+	transform->clear_render_transform();
+	for(const auto& child : transform->get_children())
+	{
+		if(child.valid())
+			clear_interpolation_subtree(child);
+	}
+}
+}
+
+void scene_graph::resolve_transforms()
+{
+	// Root subtrees are independent hierarchy islands, so they can be
+	// resolved concurrently. Small scenes stay on this thread - the
+	// dispatch overhead would dwarf the work.
+	const std::size_t roots_per_task = 64;
+	if(_roots.size() < roots_per_task * 2 || !core::has_subsystems<core::task_system>())
+	{
+		for(const auto& root : _roots)
+		{
+			resolve_subtree(root);
+		}
+		return;
+	}
+
+	auto& ts = core::get_subsystem<core::task_system>();
+	const std::size_t task_count = (_roots.size() + roots_per_task - 1) / roots_per_task;
+	std::vector<core::task_future<void>> futures;
+	futures.reserve(task_count - 1);
+	for(std::size_t t = 1; t < task_count; ++t)
+	{
+		const std::size_t begin = t * roots_per_task;
+		const std::size_t end = std::min(begin + roots_per_task, _roots.size());
+		futures.emplace_back(ts.push_on_worker_thread([this, begin, end]() {
+			for(std::size_t i = begin; i < end; ++i)
+			{
+				resolve_subtree(_roots[i]);
+			}
+		}));
+	}
+	// Resolve the first batch on this thread while workers chew the rest.
+	for(std::size_t i = 0; i < roots_per_task; ++i)
+	{
+		resolve_subtree(_roots[i]);
+	}
+	for(auto& fut : futures)
+	{
+		fut.wait();
+	}
+}
+
 void scene_graph::frame_update(std::chrono::duration<float> dt)
 {
+	PROFILE_SCOPE("scene_graph/frame_update");
+
+	if(!_dirty)
+	{
+		// Roots are kept up to date by the entity/reparent hooks; just
+		// drop any handles that went stale without an event (safety net).
+		_roots.erase(std::remove_if(std::begin(_roots), std::end(_roots),
+									[](const entity& e) { return !e.valid(); }),
+					 std::end(_roots));
+		resolve_transforms();
+		interpolate_transforms();
+		return;
+	}
+
 	auto& ecs = core::get_subsystem<runtime::entity_component_system>();
 	_roots.clear();
 	auto all_entities = ecs.all_entities();
@@ -27,17 +148,118 @@ void scene_graph::frame_update(std::chrono::duration<float> dt)
 			_roots.push_back(entity);
 		}
 	}
+	_dirty = false;
+
+	resolve_transforms();
+
+	interpolate_transforms();
+}
+
+void scene_graph::frame_fixed_update(std::chrono::duration<float> /*dt*/)
+{
+	PROFILE_SCOPE("scene_graph/frame_fixed_update");
+
+	// Connected in the constructor, so this fires before gameplay handlers
+	// that subscribed later - the snapshot really is the pre-tick state.
+	for(const auto& root : _roots)
+	{
+		snapshot_subtree(root);
+	}
+}
+
+void scene_graph::interpolate_transforms()
+{
+	auto& sim = core::get_subsystem<core::simulation>();
+	if(sim.is_fixed_timestep())
+	{
+		const float alpha = sim.get_interpolation_alpha();
+		for(const auto& root : _roots)
+		{
+			interpolate_subtree(root, alpha);
+		}
+		_interpolation_was_active = true;
+	}
+	else if(_interpolation_was_active)
+	{
+		// One clearing pass after fixed mode turns off so rendering falls
+		// back to the live world transforms.
+		for(const auto& root : _roots)
+		{
+			clear_interpolation_subtree(root);
+		}
+		_interpolation_was_active = false;
+	}
+}
+
+void scene_graph::on_entity_created(entity e)
+{
+	// Fresh entities have no parent yet, so they start out as roots.
+	if(std::find(std::begin(_roots), std::end(_roots), e) == std::end(_roots))
+	{
+		_roots.push_back(e);
+	}
+}
+
+void scene_graph::on_entity_destroyed(entity e)
+{
+	_roots.erase(std::remove(std::begin(_roots), std::end(_roots), e), std::end(_roots));
+}
+
+void scene_graph::on_parent_changed(entity e)
+{
+	auto transform_comp = e.get_component<transform_component>().lock();
+	const bool is_root = !transform_comp || !transform_comp->get_parent().valid();
+	if(is_root)
+	{
+		if(std::find(std::begin(_roots), std::end(_roots), e) == std::end(_roots))
+		{
+			_roots.push_back(e);
+		}
+	}
+	else
+	{
+		on_entity_destroyed(e);
+	}
 }
 
 scene_graph::scene_graph()
 {
-	runtime::on_frame_update.connect(this, &scene_graph::frame_update);
+	if(core::has_subsystems<system_scheduler>())
+	{
+		system_scheduler::system_desc desc;
+		desc.name = "scene_graph";
+		// The transform flush writes cached world matrices.
+		desc.writes = system_scheduler::make_mask<transform_component>();
+		desc.on_update = [this](std::chrono::duration<float> dt) { frame_update(dt); };
+		core::get_subsystem<system_scheduler>().register_system(std::move(desc));
+	}
+	else
+	{
+		runtime::on_frame_update.connect(this, &scene_graph::frame_update);
+	}
+
+	runtime::on_frame_fixed_update.connect(this, &scene_graph::frame_fixed_update);
+	runtime::on_entity_created.connect(this, &scene_graph::on_entity_created);
+	runtime::on_entity_destroyed.connect(this, &scene_graph::on_entity_destroyed);
+	on_transform_parent_changed.connect(this, &scene_graph::on_parent_changed);
 
 	transform_component::static_id();
 }
 
 scene_graph::~scene_graph()
 {
-	runtime::on_frame_update.disconnect(this, &scene_graph::frame_update);
+	runtime::on_frame_fixed_update.disconnect(this, &scene_graph::frame_fixed_update);
+	runtime::on_entity_created.disconnect(this, &scene_graph::on_entity_created);
+	runtime::on_entity_destroyed.disconnect(this, &scene_graph::on_entity_destroyed);
+	on_transform_parent_changed.disconnect(this, &scene_graph::on_parent_changed);
+
+	if(core::has_subsystems<system_scheduler>())
+	{
+		core::get_subsystem<system_scheduler>().unregister_system("scene_graph");
+	}
+	else
+	{
+		runtime::on_frame_update.disconnect(this, &scene_graph::frame_update);
+	}
 }
 }
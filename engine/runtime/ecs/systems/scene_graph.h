@@ -20,6 +20,19 @@ public:
 	//-----------------------------------------------------------------------------
 	void frame_update(std::chrono::duration<float> dt);
 
+	//-----------------------------------------------------------------------------
+	//  Name : resolve_transforms ()
+	/// <summary>
+	/// Explicit transform flush: walks every dirty subtree in
+	/// parent-before-child order exactly once, so world matrices are ready
+	/// before other systems read them and get_transform becomes a plain
+	/// cached load for the rest of the frame. Runs as part of
+	/// frame_update; systems scheduled after scene_graph can rely on
+	/// resolved transforms.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void resolve_transforms();
+
 	//-----------------------------------------------------------------------------
 	//  Name : getRoots ()
 	/// <summary>
@@ -33,8 +46,51 @@ public:
 		return _roots;
 	}
 
+	//-----------------------------------------------------------------------------
+	//  Name : invalidate ()
+	/// <summary>
+	/// Forces a full root rebuild on the next frame_update. Only needed
+	/// when roots changed behind the event hooks' back (e.g. bulk scene
+	/// loads that bypass set_parent).
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void invalidate()
+	{
+		_dirty = true;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : frame_fixed_update ()
+	/// <summary>
+	/// Runs at the start of every fixed simulation tick and snapshots each
+	/// transform before gameplay moves it, giving frame_update the
+	/// previous-tick endpoint to interpolate from.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void frame_fixed_update(std::chrono::duration<float> dt);
+
 private:
-	/// scene roots
+	//-----------------------------------------------------------------------------
+	//  Name : interpolate_transforms ()
+	/// <summary>
+	/// When fixed-timestep mode is on, blends every transform between its
+	/// previous-tick snapshot and its current state by the simulation's
+	/// interpolation alpha; when it just turned off, clears the caches.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void interpolate_transforms();
+
+	void on_entity_created(entity e);
+	void on_entity_destroyed(entity e);
+	void on_parent_changed(entity e);
+
+	/// scene roots, maintained incrementally from entity lifetime and
+	/// reparent events
 	std::vector<entity> _roots;
+	/// when set, frame_update falls back to a full rebuild
+	bool _dirty = true;
+	/// whether the previous frame blended render transforms; lets the
+	/// frame after fixed mode turns off clear the stale caches once
+	bool _interpolation_was_active = false;
 };
 }
@@ -0,0 +1,326 @@
+#include "spatial_index.h"
+#include "../../system/events.h"
+#include "../components/model_component.h"
+#include "../components/transform_component.h"
+#include "core/system/subsystem.h"
+#include "system_scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace runtime
+{
+namespace
+{
+/// Smallest cell edge; level L cells are base_cell_size * 2^L wide.
+const float base_cell_size = 4.0f;
+/// Entities larger than the top level all share one oversized bucket.
+const std::uint32_t max_level = 16;
+}
+
+void spatial_index::frame_update(std::chrono::duration<float> dt)
+{
+	auto& ecs = core::get_subsystem<entity_component_system>();
+
+	// Entities flagged by removal events: drop them unless they still carry
+	// both components (the event fires for every removed component type).
+	for(auto e : _pending_eval)
+	{
+		if(!e.valid() || !e.has_component<transform_component>() || !e.has_component<model_component>())
+			remove(e);
+	}
+	_pending_eval.clear();
+
+	// Re-bucket everything that moved or changed model this frame; untouched
+	// entities keep their cell and cached bounds. The candidates are
+	// gathered first so their world bounds compute in one SIMD batch
+	// instead of a corner expansion per box.
+	std::vector<entity> refit_entities;
+	std::vector<math::bbox> refit_bounds;
+	std::vector<math::transform> refit_transforms;
+	auto chunks = ecs.chunked_entities_with_components<transform_component, model_component>();
+	for(const auto& chunk : chunks)
+	{
+		const auto& transforms = chunk.get<transform_component>();
+		const auto& models = chunk.get<model_component>();
+		for(std::size_t i = 0; i < chunk.entities.size(); ++i)
+		{
+			auto entity = chunk.entities[i];
+			auto* transform_comp_ptr = transforms[i];
+			auto* model_comp_ptr = models[i];
+
+			const bool indexed = _records.find(entity) != _records.end();
+			if(indexed && !transform_comp_ptr->is_touched() && !model_comp_ptr->is_touched())
+				continue;
+
+			auto mesh = model_comp_ptr->get_model().get_lod(0);
+			if(!mesh)
+			{
+				// Mesh not streamed in yet; retried here next frame.
+				if(indexed)
+					remove(entity);
+				continue;
+			}
+
+			refit_entities.push_back(entity);
+			refit_bounds.push_back(mesh->get_bounds());
+			refit_transforms.push_back(transform_comp_ptr->get_transform());
+		}
+	}
+
+	if(!refit_entities.empty())
+	{
+		// in place: the batch may alias its input
+		math::bbox::mul_batch(refit_bounds.data(), refit_transforms.data(), refit_bounds.size(),
+							  refit_bounds.data());
+		for(std::size_t i = 0; i < refit_entities.size(); ++i)
+		{
+			insert(refit_entities[i], refit_bounds[i]);
+		}
+	}
+}
+
+void spatial_index::query_frustum(const math::frustum& frustum, std::vector<entity>& out) const
+{
+	for(const auto& cell : _cells)
+	{
+		// Broad phase on the loose cell box, fine phase on exact bounds.
+		if(!frustum.test_aabb(loose_cell_bounds(cell.first)))
+			continue;
+
+		for(const auto& e : cell.second)
+		{
+			const auto it = _records.find(e);
+			if(it != _records.end() && frustum.test_aabb(it->second.bounds))
+				out.push_back(e);
+		}
+	}
+}
+
+void spatial_index::query_bounds(const math::bbox& bounds, std::vector<entity>& out) const
+{
+	for(const auto& cell : _cells)
+	{
+		if(!bounds.intersect(loose_cell_bounds(cell.first)))
+			continue;
+
+		for(const auto& e : cell.second)
+		{
+			const auto it = _records.find(e);
+			if(it != _records.end() && bounds.intersect(it->second.bounds))
+				out.push_back(e);
+		}
+	}
+}
+
+bool spatial_index::raycast(const math::vec3& origin, const math::vec3& direction, float max_distance,
+							raycast_hit& out) const
+{
+	if(max_distance <= 0.0f)
+		return false;
+
+	// The ray is parameterized over [0, 1] along direction * range; the best
+	// hit fraction found so far prunes cells and entities further along.
+	const math::vec3 velocity = direction * max_distance;
+	float best_t = 1.0f;
+	bool hit = false;
+
+	for(const auto& cell : _cells)
+	{
+		float cell_t = 0.0f;
+		if(!loose_cell_bounds(cell.first).intersect(origin, velocity, cell_t) || cell_t >= best_t)
+			continue;
+
+		for(const auto& e : cell.second)
+		{
+			const auto it = _records.find(e);
+			if(it == _records.end())
+				continue;
+
+			float bounds_t = 0.0f;
+			if(!it->second.bounds.intersect(origin, velocity, bounds_t) || bounds_t >= best_t)
+				continue;
+
+			auto ent = e;
+			if(!ent.valid())
+				continue;
+			auto transform_comp = ent.get_component<transform_component>().lock();
+			auto model_comp = ent.get_component<model_component>().lock();
+			if(!transform_comp || !model_comp)
+				continue;
+
+			auto mesh = model_comp->get_model().get_lod(0);
+			if(!mesh)
+				continue;
+
+			// Narrow phase in mesh local space: the world segment up to the
+			// current best hit maps to a local segment, and the affine map
+			// preserves the parametric hit fraction along it.
+			const auto& world = transform_comp->get_transform();
+			const math::vec3 local_origin = world.inverse_transform_coord(origin);
+			const math::vec3 local_end = world.inverse_transform_coord(origin + velocity * best_t);
+			const math::vec3 local_dir = local_end - local_origin;
+			const float local_len = math::length(local_dir);
+			if(local_len < math::epsilon<float>())
+				continue;
+
+			float local_distance = 0.0f;
+			math::vec3 local_normal;
+			std::uint32_t face = 0;
+			if(!mesh->raycast(local_origin, local_dir / local_len, local_len, local_distance,
+							  local_normal, face))
+				continue;
+
+			best_t = (local_distance / local_len) * best_t;
+			hit = true;
+			out.hit_entity = ent;
+			out.face = face;
+			out.normal = math::normalize(world.transform_normal(local_normal));
+		}
+	}
+
+	if(!hit)
+		return false;
+
+	out.distance = best_t * max_distance;
+	out.position = origin + direction * out.distance;
+	return true;
+}
+
+bool spatial_index::get_bounds(entity e, math::bbox& out) const
+{
+	const auto it = _records.find(e);
+	if(it == _records.end())
+		return false;
+
+	out = it->second.bounds;
+	return true;
+}
+
+void spatial_index::on_entity_destroyed(entity e)
+{
+	remove(e);
+}
+
+void spatial_index::on_component_removed(entity e, chandle<component> c)
+{
+	// The component type is opaque here; membership is re-evaluated on the
+	// next frame_update instead.
+	if(_records.find(e) != _records.end())
+		_pending_eval.push_back(e);
+}
+
+void spatial_index::insert(entity e, const math::bbox& bounds)
+{
+	const auto key = make_key(bounds);
+	const auto it = _records.find(e);
+	if(it != _records.end())
+	{
+		if(it->second.key == key)
+		{
+			// Same cell; just refresh the cached bounds.
+			it->second.bounds = bounds;
+			return;
+		}
+		remove(e);
+	}
+
+	_cells[key].push_back(e);
+	_records[e] = {key, bounds};
+}
+
+void spatial_index::remove(entity e)
+{
+	const auto it = _records.find(e);
+	if(it == _records.end())
+		return;
+
+	const auto cell_it = _cells.find(it->second.key);
+	if(cell_it != _cells.end())
+	{
+		auto& entities = cell_it->second;
+		const auto pos = std::find(entities.begin(), entities.end(), e);
+		if(pos != entities.end())
+		{
+			// Swap-pop; bucket order is irrelevant.
+			*pos = entities.back();
+			entities.pop_back();
+		}
+		if(entities.empty())
+			_cells.erase(cell_it);
+	}
+	_records.erase(it);
+}
+
+spatial_index::cell_key spatial_index::make_key(const math::bbox& bounds)
+{
+	const auto extents = bounds.get_extents();
+	const float largest = std::max(extents.x, std::max(extents.y, extents.z)) * 2.0f;
+
+	// Pick the level whose cell size covers the box; the loose factor then
+	// guarantees the box fits inside the expanded cell it is centered in.
+	std::uint32_t level = 0;
+	while(level < max_level && cell_size(level) < largest)
+		++level;
+
+	const float size = cell_size(level);
+	const auto center = bounds.get_center();
+
+	cell_key key;
+	key.x = static_cast<std::int32_t>(std::floor(center.x / size));
+	key.y = static_cast<std::int32_t>(std::floor(center.y / size));
+	key.z = static_cast<std::int32_t>(std::floor(center.z / size));
+	key.level = level;
+	return key;
+}
+
+float spatial_index::cell_size(std::uint32_t level)
+{
+	return base_cell_size * static_cast<float>(1u << level);
+}
+
+math::bbox spatial_index::loose_cell_bounds(const cell_key& key)
+{
+	// Loose factor of two: the cell box expanded by half its size on every
+	// side, covering any box bucketed into this cell.
+	const float size = cell_size(key.level);
+	const math::vec3 min(static_cast<float>(key.x) * size - size * 0.5f,
+						 static_cast<float>(key.y) * size - size * 0.5f,
+						 static_cast<float>(key.z) * size - size * 0.5f);
+	return math::bbox(min, min + math::vec3(size * 2.0f, size * 2.0f, size * 2.0f));
+}
+
+spatial_index::spatial_index()
+{
+	runtime::on_entity_destroyed.connect(this, &spatial_index::on_entity_destroyed);
+	runtime::on_component_removed.connect(this, &spatial_index::on_component_removed);
+
+	if(core::has_subsystems<system_scheduler>())
+	{
+		system_scheduler::system_desc desc;
+		desc.name = "spatial_index";
+		desc.reads = system_scheduler::make_mask<transform_component, model_component>();
+		desc.on_update = [this](std::chrono::duration<float> dt) { frame_update(dt); };
+		core::get_subsystem<system_scheduler>().register_system(std::move(desc));
+	}
+	else
+	{
+		on_frame_update.connect(this, &spatial_index::frame_update);
+	}
+}
+
+spatial_index::~spatial_index()
+{
+	runtime::on_entity_destroyed.disconnect(this, &spatial_index::on_entity_destroyed);
+	runtime::on_component_removed.disconnect(this, &spatial_index::on_component_removed);
+
+	if(core::has_subsystems<system_scheduler>())
+	{
+		core::get_subsystem<system_scheduler>().unregister_system("spatial_index");
+	}
+	else
+	{
+		on_frame_update.disconnect(this, &spatial_index::frame_update);
+	}
+}
+}
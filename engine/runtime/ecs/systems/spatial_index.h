@@ -0,0 +1,155 @@
+#pragma once
+
+#include "../ecs.h"
+#include "core/math/math_includes.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace runtime
+{
+//-----------------------------------------------------------------------------
+//  Name : spatial_index (Class)
+/// <summary>
+/// Persistent spatial index over model world bounds. Entities are bucketed
+/// into a hierarchical loose hash grid (the hash-grid equivalent of a loose
+/// octree: each entity lives at the level whose cell size covers its bounds,
+/// in the cell containing its center) and only moved when their transform or
+/// model was touched, so maintenance cost scales with the number of moving
+/// entities. Broad-phase queries walk occupied cells instead of every entity,
+/// letting visibility cost scale with the visible set rather than scene size.
+/// </summary>
+//-----------------------------------------------------------------------------
+class spatial_index
+{
+public:
+	/// Result of a raycast query: the hit entity together with the world
+	/// space hit distance, position, surface normal and mesh face index.
+	struct raycast_hit
+	{
+		entity hit_entity;
+		float distance = 0.0f;
+		math::vec3 position{0.0f, 0.0f, 0.0f};
+		math::vec3 normal{0.0f, 0.0f, 0.0f};
+		std::uint32_t face = 0;
+	};
+
+	spatial_index();
+	~spatial_index();
+
+	//-----------------------------------------------------------------------------
+	//  Name : frame_update ()
+	/// <summary>
+	/// Refreshes the index: re-buckets entities whose transform or model was
+	/// touched this frame and evaluates entities flagged by component
+	/// removal events.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void frame_update(std::chrono::duration<float> dt);
+
+	//-----------------------------------------------------------------------------
+	//  Name : query_frustum ()
+	/// <summary>
+	/// Appends every indexed entity whose world bounds may intersect the
+	/// frustum. Conservative: cells are tested with their loose bounds, then
+	/// entities with their exact world box, so callers never miss a visible
+	/// entity but may still receive borderline ones.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void query_frustum(const math::frustum& frustum, std::vector<entity>& out) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : query_bounds ()
+	/// <summary>
+	/// Appends every indexed entity whose world bounds intersect the given
+	/// box.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void query_bounds(const math::bbox& bounds, std::vector<entity>& out) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : raycast ()
+	/// <summary>
+	/// Casts a world space ray against the indexed scene and returns the
+	/// closest triangle-accurate hit within max_distance. Cells and cached
+	/// entity bounds act as the broad phase; survivors are tested against
+	/// their mesh triangles in local space, so the per-query cost stays
+	/// proportional to the entities near the ray. The direction is expected
+	/// to be normalized.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool raycast(const math::vec3& origin, const math::vec3& direction, float max_distance,
+				 raycast_hit& out) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_bounds ()
+	/// <summary>
+	/// Fetches the cached world bounds of an indexed entity. Returns false
+	/// when the entity is not present in the index.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool get_bounds(entity e, math::bbox& out) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : size ()
+	/// <summary>
+	/// Number of entities currently indexed.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::size_t size() const
+	{
+		return _records.size();
+	}
+
+private:
+	/// Cell address: grid coordinate at a power-of-two level.
+	struct cell_key
+	{
+		std::int32_t x = 0;
+		std::int32_t y = 0;
+		std::int32_t z = 0;
+		std::uint32_t level = 0;
+
+		bool operator==(const cell_key& rhs) const
+		{
+			return x == rhs.x && y == rhs.y && z == rhs.z && level == rhs.level;
+		}
+	};
+
+	struct cell_key_hash
+	{
+		std::size_t operator()(const cell_key& key) const
+		{
+			std::size_t seed = std::hash<std::int32_t>()(key.x);
+			seed ^= std::hash<std::int32_t>()(key.y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			seed ^= std::hash<std::int32_t>()(key.z) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			seed ^= std::hash<std::uint32_t>()(key.level) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			return seed;
+		}
+	};
+
+	/// Per-entity bookkeeping: which cell it lives in and its exact bounds.
+	struct record
+	{
+		cell_key key;
+		math::bbox bounds;
+	};
+
+	void on_entity_destroyed(entity e);
+	void on_component_removed(entity e, chandle<component> c);
+
+	void insert(entity e, const math::bbox& bounds);
+	void remove(entity e);
+
+	static cell_key make_key(const math::bbox& bounds);
+	static float cell_size(std::uint32_t level);
+	static math::bbox loose_cell_bounds(const cell_key& key);
+
+	/// occupied cells -> entities bucketed in them
+	std::unordered_map<cell_key, std::vector<entity>, cell_key_hash> _cells;
+	/// indexed entities -> their cell and cached world bounds
+	std::unordered_map<entity, record> _records;
+	/// entities whose membership must be re-evaluated next frame_update
+	std::vector<entity> _pending_eval;
+};
+}
@@ -0,0 +1,91 @@
+#include "system_scheduler.h"
+#include "../../system/events.h"
+#include "core/system/subsystem.h"
+#include "core/tasks/task_system.h"
+
+namespace runtime
+{
+
+bool system_scheduler::conflicts(const system_desc& lhs, const system_desc& rhs) const
+{
+	if((lhs.writes & (rhs.reads | rhs.writes)).any())
+		return true;
+	if((rhs.writes & lhs.reads).any())
+		return true;
+	return false;
+}
+
+void system_scheduler::register_system(system_desc desc)
+{
+	_systems.push_back(std::move(desc));
+}
+
+void system_scheduler::unregister_system(const std::string& name)
+{
+	_systems.erase(std::remove_if(std::begin(_systems), std::end(_systems),
+								  [&name](const auto& desc) { return desc.name == name; }),
+				   std::end(_systems));
+}
+
+void system_scheduler::frame_update(std::chrono::duration<float> dt)
+{
+	auto& ts = core::get_subsystem<core::task_system>();
+
+	std::size_t batch_begin = 0;
+	while(batch_begin < _systems.size())
+	{
+		// Grow the batch while consecutive systems stay conflict-free
+		// against everything already in it. Only consecutive systems are
+		// merged so relative ordering across a conflict is never broken.
+		std::size_t batch_end = batch_begin + 1;
+		while(batch_end < _systems.size())
+		{
+			bool compatible = true;
+			for(std::size_t i = batch_begin; i < batch_end; ++i)
+			{
+				if(conflicts(_systems[i], _systems[batch_end]))
+				{
+					compatible = false;
+					break;
+				}
+			}
+			if(!compatible)
+				break;
+			++batch_end;
+		}
+
+		if(batch_end - batch_begin == 1)
+		{
+			_systems[batch_begin].on_update(dt);
+		}
+		else
+		{
+			std::vector<core::task_future<void>> futures;
+			futures.reserve(batch_end - batch_begin - 1);
+			for(std::size_t i = batch_begin + 1; i < batch_end; ++i)
+			{
+				futures.emplace_back(ts.push_on_worker_thread(_systems[i].on_update, dt));
+			}
+			// Run the first batch member on this thread while the rest
+			// are in flight.
+			_systems[batch_begin].on_update(dt);
+			for(auto& fut : futures)
+			{
+				fut.wait();
+			}
+		}
+
+		batch_begin = batch_end;
+	}
+}
+
+system_scheduler::system_scheduler()
+{
+	runtime::on_frame_update.connect(this, &system_scheduler::frame_update);
+}
+
+system_scheduler::~system_scheduler()
+{
+	runtime::on_frame_update.disconnect(this, &system_scheduler::frame_update);
+}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "../ecs.h"
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace runtime
+{
+/// Runs registered systems once per frame on core::task_system workers,
+/// batching together systems whose declared component access sets do not
+/// conflict. Two systems conflict when one writes a component type the
+/// other reads or writes. Batches preserve registration order; systems
+/// inside a batch run concurrently and the scheduler joins the whole
+/// batch before starting the next one. Systems that do not register here
+/// keep subscribing to runtime::on_frame_update directly - the signal
+/// remains the fallback path.
+class system_scheduler
+{
+public:
+	using update_func_t = std::function<void(std::chrono::duration<float>)>;
+
+	struct system_desc
+	{
+		/// Unique name, used for unregistration.
+		std::string name;
+		/// Component types the system only inspects.
+		entity_component_system::component_mask_t reads;
+		/// Component types the system mutates, assigns or removes.
+		entity_component_system::component_mask_t writes;
+		/// Per-frame entry point.
+		update_func_t on_update;
+	};
+
+	system_scheduler();
+	~system_scheduler();
+
+	//-----------------------------------------------------------------------------
+	//  Name : register_system ()
+	/// <summary>
+	/// Adds a system to the schedule. Registration order is preserved: a
+	/// system never runs before an earlier-registered one it conflicts with.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void register_system(system_desc desc);
+
+	//-----------------------------------------------------------------------------
+	//  Name : unregister_system ()
+	/// <summary>
+	/// Removes a previously registered system by name.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void unregister_system(const std::string& name);
+
+	//-----------------------------------------------------------------------------
+	//  Name : frame_update ()
+	/// <summary>
+	/// Dispatches all registered systems for this frame in conflict-free
+	/// concurrent batches.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void frame_update(std::chrono::duration<float> dt);
+
+	//-----------------------------------------------------------------------------
+	//  Name : make_mask ()
+	/// <summary>
+	/// Convenience for declaring read/write sets from component types.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	template <typename... Components>
+	static entity_component_system::component_mask_t make_mask()
+	{
+		entity_component_system::component_mask_t mask;
+		auto fill = {0, (mask.set(rtti::type_index_sequential_t::id<component, Components>()), 0)...};
+		(void)fill;
+		return mask;
+	}
+
+private:
+	bool conflicts(const system_desc& lhs, const system_desc& rhs) const;
+
+	/// Registered systems in registration order.
+	std::vector<system_desc> _systems;
+};
+}
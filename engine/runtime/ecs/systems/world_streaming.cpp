@@ -0,0 +1,173 @@
+#include "world_streaming.h"
+#include "../../assets/asset_manager.h"
+#include "../../system/events.h"
+#include "../components/camera_component.h"
+#include "../components/transform_component.h"
+#include "../constructs/scene.h"
+#include "core/system/subsystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace runtime
+{
+namespace
+{
+//-----------------------------------------------------------------------------
+//  Name : pack_cell () (Local)
+/// <summary>
+/// Packs a signed 2d grid cell into one hashable key.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::uint64_t pack_cell(std::int32_t x, std::int32_t z)
+{
+	return (std::uint64_t(std::uint32_t(x)) << 32) | std::uint64_t(std::uint32_t(z));
+}
+
+//-----------------------------------------------------------------------------
+//  Name : cell_scene_key () (Local)
+/// <summary>
+/// Asset key of one cell scene, matching the editor's split naming.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::string cell_scene_key(const std::string& scene_key, std::int32_t x, std::int32_t z)
+{
+	std::ostringstream key;
+	key << scene_key << ".cell_" << x << '_' << z;
+	return key.str();
+}
+}
+
+world_streaming::world_streaming()
+{
+	// Instantiation creates entities with arbitrary component types, so
+	// there is no write mask to declare; the system always runs as a plain
+	// frame-update callback outside the scheduler.
+	on_frame_update.connect(this, &world_streaming::frame_update);
+}
+
+world_streaming::~world_streaming()
+{
+	on_frame_update.disconnect(this, &world_streaming::frame_update);
+}
+
+void world_streaming::enable(const std::string& scene_key, float cell_size, std::int32_t radius)
+{
+	disable();
+
+	_scene_key = scene_key;
+	_cell_size = cell_size;
+	_radius = radius;
+}
+
+void world_streaming::disable()
+{
+	for(auto& pair : _cells)
+		retire_cell(pair.second);
+
+	_cells.clear();
+	_scene_key.clear();
+}
+
+void world_streaming::frame_update(std::chrono::duration<float>)
+{
+	if(_scene_key.empty())
+		return;
+
+	auto& ecs = core::get_subsystem<entity_component_system>();
+
+	// The first camera anchors the streaming window.
+	bool has_anchor = false;
+	math::vec3 anchor;
+	ecs.for_each<transform_component, camera_component>(
+		[&has_anchor, &anchor](entity, transform_component& transform_comp, camera_component&) {
+			if(!has_anchor)
+			{
+				anchor = transform_comp.get_transform().get_position();
+				has_anchor = true;
+			}
+		});
+	if(!has_anchor)
+		return;
+
+	const auto center_x = std::int32_t(std::floor(anchor.x / _cell_size));
+	const auto center_z = std::int32_t(std::floor(anchor.z / _cell_size));
+
+	auto& am = core::get_subsystem<asset_manager>();
+
+	// Kick async loads for cells entering the radius and promote arrived
+	// ones. Instantiation goes through the owner-thread queue so its cost
+	// is carved out of the frame budget instead of landing all at once.
+	for(std::int32_t x = center_x - _radius; x <= center_x + _radius; ++x)
+	{
+		for(std::int32_t z = center_z - _radius; z <= center_z + _radius; ++z)
+		{
+			const auto key = pack_cell(x, z);
+			auto it = _cells.find(key);
+			if(it == _cells.end())
+			{
+				auto& record = _cells[key];
+				record.state = cell_record::cell_state::loading;
+				record.request = am.load<::scene>(cell_scene_key(_scene_key, x, z), load_mode::async);
+				continue;
+			}
+
+			auto& record = it->second;
+			if(record.state != cell_record::cell_state::loading || !record.request.is_ready())
+				continue;
+
+			auto cell_scene = record.request.get();
+			record.request = {};
+			if(!cell_scene)
+			{
+				// No file at this coordinate - remember that so the cell is
+				// not re-requested every frame it stays in range.
+				record.state = cell_record::cell_state::missing;
+				continue;
+			}
+
+			record.state = cell_record::cell_state::instantiating;
+			auto& ts = core::get_subsystem<core::task_system>();
+			ts.push_on_owner_thread([this, key, cell_scene]() {
+				auto it_cell = _cells.find(key);
+				if(it_cell == _cells.end() ||
+				   it_cell->second.state != cell_record::cell_state::instantiating)
+					return;
+
+				it_cell->second.entities = cell_scene->instantiate(::scene::mode::additive);
+				it_cell->second.state = cell_record::cell_state::resident;
+			});
+		}
+	}
+
+	// Retire at most one cell per frame once it leaves the radius plus one
+	// cell of hysteresis, so crossing a boundary back and forth does not
+	// churn loads.
+	for(auto it = _cells.begin(); it != _cells.end();)
+	{
+		const auto x = std::int32_t(std::uint32_t(it->first >> 32));
+		const auto z = std::int32_t(std::uint32_t(it->first & 0xFFFFFFFFu));
+		const auto distance = std::max(std::abs(x - center_x), std::abs(z - center_z));
+		if(distance <= _radius + 1 || it->second.state == cell_record::cell_state::instantiating)
+		{
+			++it;
+			continue;
+		}
+
+		retire_cell(it->second);
+		it = _cells.erase(it);
+		break;
+	}
+}
+
+void world_streaming::retire_cell(cell_record& record)
+{
+	for(auto& e : record.entities)
+	{
+		if(e.valid())
+			e.destroy();
+	}
+	record.entities.clear();
+}
+}
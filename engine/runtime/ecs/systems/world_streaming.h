@@ -0,0 +1,103 @@
+#pragma once
+
+#include "../../assets/asset_handle.h"
+#include "../ecs.h"
+#include "core/tasks/task_system.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct scene;
+
+namespace runtime
+{
+//-----------------------------------------------------------------------------
+//  Name : world_streaming (Class)
+/// <summary>
+/// Streams a cell-partitioned scene in and out around the camera. The
+/// editor splits a world into independently serialized cell scenes
+/// ('<scene>.cell_<x>_<z>'); this system async-loads the
+/// cells inside the streaming radius through the asset manager and
+/// instantiates each one additively as an owner-thread task, so the
+/// budgeted drain slices entity creation across frames. Cells that leave
+/// the radius (plus one cell of hysteresis) are destroyed again, one
+/// cell per frame.
+/// </summary>
+//-----------------------------------------------------------------------------
+class world_streaming
+{
+public:
+	world_streaming();
+	~world_streaming();
+
+	//-----------------------------------------------------------------------------
+	//  Name : enable ()
+	/// <summary>
+	/// Starts streaming the given cell-partitioned scene. 'scene_key' is
+	/// the base scene asset key without extension; cells resolve as
+	/// '<scene_key>.cell_<x>_<z>' on the xz grid of
+	/// 'cell_size' meters. 'radius' is the ring of cells kept resident
+	/// around the camera cell.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void enable(const std::string& scene_key, float cell_size = 100.0f, std::int32_t radius = 1);
+
+	//-----------------------------------------------------------------------------
+	//  Name : disable ()
+	/// <summary>
+	/// Stops streaming and destroys all streamed-in cell entities.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void disable();
+
+	//-----------------------------------------------------------------------------
+	//  Name : frame_update ()
+	/// <summary>
+	/// Kicks loads for cells entering the radius, instantiates cells
+	/// whose data arrived and retires cells that left.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void frame_update(std::chrono::duration<float> dt);
+
+private:
+	/// Lifecycle of one streamed cell.
+	struct cell_record
+	{
+		enum class cell_state
+		{
+			/// async asset load in flight
+			loading,
+			/// instantiation task queued on the owner thread
+			instantiating,
+			/// entities live in the ecs
+			resident,
+			/// no cell file exists at this coordinate
+			missing,
+		};
+
+		cell_state state = cell_state::loading;
+		core::task_future<asset_handle<::scene>> request;
+		std::vector<entity> entities;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : retire_cell ()
+	/// <summary>
+	/// Destroys a resident cell's entities.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void retire_cell(cell_record& record);
+
+	/// Base scene key the cell keys derive from; empty while disabled.
+	std::string _scene_key;
+	/// Edge length of one streaming cell in meters.
+	float _cell_size = 100.0f;
+	/// Ring of cells kept resident around the camera cell.
+	std::int32_t _radius = 1;
+	/// Streamed cells by packed grid coordinate.
+	std::unordered_map<std::uint64_t, cell_record> _cells;
+};
+}
@@ -1,5 +1,6 @@
 #include "input.h"
 #include "../system/events.h"
+#include <algorithm>
 
 namespace runtime
 {
@@ -43,6 +44,80 @@ void input::handle_event(const mml::platform_event& event)
 		return;
 }
 
+void input::handle_events(const std::vector<mml::platform_event>& events)
+{
+	// Pending coalesced events: one slot for the cursor, one for the
+	// wheel, last-wins per joystick axis. Flushed before any discrete
+	// event so ordering stays observable.
+	bool has_move = false;
+	mml::platform_event move{};
+	bool has_wheel = false;
+	mml::platform_event wheel{};
+	std::vector<mml::platform_event> axes;
+
+	auto flush = [&]() {
+		if(has_move)
+		{
+			handle_event(move);
+			has_move = false;
+		}
+		if(has_wheel)
+		{
+			handle_event(wheel);
+			has_wheel = false;
+		}
+		for(const auto& axis : axes)
+		{
+			handle_event(axis);
+		}
+		axes.clear();
+	};
+
+	for(const auto& e : events)
+	{
+		switch(e.type)
+		{
+			case mml::platform_event::mouse_moved:
+				move = e;
+				has_move = true;
+				break;
+			case mml::platform_event::mouse_wheel_scrolled:
+				if(has_wheel)
+				{
+					wheel.mouse_wheel_scroll.delta += e.mouse_wheel_scroll.delta;
+				}
+				else
+				{
+					wheel = e;
+					has_wheel = true;
+				}
+				break;
+			case mml::platform_event::joystick_moved:
+			{
+				auto it = std::find_if(std::begin(axes), std::end(axes), [&e](const auto& pending) {
+					return pending.joystick_move.joystick_id == e.joystick_move.joystick_id &&
+						   pending.joystick_move.axis == e.joystick_move.axis;
+				});
+				if(it != std::end(axes))
+				{
+					*it = e;
+				}
+				else
+				{
+					axes.push_back(e);
+				}
+				break;
+			}
+			default:
+				flush();
+				handle_event(e);
+				break;
+		}
+	}
+
+	flush();
+}
+
 bool input::is_key_pressed(mml::keyboard::key key)
 {
 	return _keys_pressed[key];
@@ -290,10 +365,7 @@ void input::platform_events(const std::pair<std::uint32_t, bool>& info,
 {
 	if(info.second)
 	{
-		for(const auto& e : events)
-		{
-			handle_event(e);
-		}
+		handle_events(events);
 	}
 }
 }
@@ -110,6 +110,21 @@ public:
 	//-----------------------------------------------------------------------------
 	void handle_event(const mml::platform_event& event);
 
+	//-----------------------------------------------------------------------------
+	//  Name : handle_events ()
+	/// <summary>
+	/// Batched intake for one frame's worth of events. Runs of continuous
+	/// events - mouse moves, wheel scrolls, joystick axes - are coalesced
+	/// to a single state commit (wheel deltas summed, positions last-wins)
+	/// before dispatch, so an 8kHz mouse costs one update instead of
+	/// thousands. Discrete events keep their order: any pending coalesced
+	/// state is flushed before a press/release is processed. Queries like
+	/// is_key_down observe exactly the same end-of-frame state as the
+	/// per-event path.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void handle_events(const std::vector<mml::platform_event>& events);
+
 	//-----------------------------------------------------------------------------
 	//  Name : is_key_pressed ()
 	/// <summary>
@@ -35,6 +35,7 @@ LOAD(node_animation)
 	try_load(ar, cereal::make_nvp("post_state", obj.post_state));
 }
 LOAD_INSTANTIATE(node_animation, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(node_animation, serialization::memory_input_archive);
 
 SAVE(animation)
 {
@@ -53,4 +54,5 @@ LOAD(animation)
 	try_load(ar, cereal::make_nvp("ticks_per_second", obj.channels));
 }
 LOAD_INSTANTIATE(animation, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(animation, serialization::memory_input_archive);
 }
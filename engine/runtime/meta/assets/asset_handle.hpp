@@ -19,13 +19,16 @@ namespace cereal
 template <typename Archive, typename T>
 inline void SAVE_FUNCTION_NAME(Archive& ar, asset_link<T> const& obj)
 {
-	try_save(ar, cereal::make_nvp("id", obj.id));
+	try_save(ar, cereal::make_nvp("id", obj.id.str()));
 }
 
 template <typename Archive, typename T>
 inline void LOAD_FUNCTION_NAME(Archive& ar, asset_link<T>& obj)
 {
-	try_load(ar, cereal::make_nvp("id", obj.id));
+	// Keys travel as plain strings; interning happens on assignment.
+	std::string id;
+	try_load(ar, cereal::make_nvp("id", id));
+	obj.id = id;
 }
 
 template <typename Archive, typename T>
@@ -35,11 +35,13 @@ LOAD(sound_info)
 	try_load(ar, cereal::make_nvp("duration", obj.duration));
 }
 LOAD_INSTANTIATE(sound_info, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(sound_info, serialization::memory_input_archive);
 
 SAVE(sound_data)
 {
 	try_save(ar, cereal::make_nvp("info", obj.info));
 	try_save(ar, cereal::make_nvp("data", obj.data));
+	try_save(ar, cereal::make_nvp("encoded_data", obj.encoded_data));
 }
 SAVE_INSTANTIATE(sound_data, cereal::oarchive_binary_t);
 
@@ -47,6 +49,9 @@ LOAD(sound_data)
 {
 	try_load(ar, cereal::make_nvp("info", obj.info));
 	try_load(ar, cereal::make_nvp("data", obj.data));
+	// absent in assets compiled before streaming - try_load leaves it empty
+	try_load(ar, cereal::make_nvp("encoded_data", obj.encoded_data));
 }
 LOAD_INSTANTIATE(sound_data, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(sound_data, serialization::memory_input_archive);
 }
@@ -2,6 +2,7 @@
 #include "../../assets/asset_handle.hpp"
 #include "../../core/common/basetypes.hpp"
 #include "component.hpp"
+#include "component_serialization.h"
 #include "core/serialization/types/vector.hpp"
 
 REFLECT(audio_listener_component)
@@ -24,3 +25,6 @@ LOAD(audio_listener_component)
 }
 LOAD_INSTANTIATE(audio_listener_component, cereal::iarchive_associative_t);
 LOAD_INSTANTIATE(audio_listener_component, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(audio_listener_component, serialization::memory_input_archive);
+
+REGISTER_COMPONENT_SERIALIZATION(audio_listener_component);
@@ -2,6 +2,7 @@
 #include "../../assets/asset_handle.hpp"
 #include "../../core/common/basetypes.hpp"
 #include "component.hpp"
+#include "component_serialization.h"
 #include "core/serialization/types/vector.hpp"
 
 REFLECT(audio_source_component)
@@ -23,6 +24,13 @@ REFLECT(audio_source_component)
 				  &audio_source_component::set_volume_rolloff)(
 			rttr::metadata("pretty_name", "Volume Rolloff"), rttr::metadata("min", 0.0f),
 			rttr::metadata("max", 10.0f))
+		.property("priority", &audio_source_component::get_priority,
+				  &audio_source_component::set_priority)(
+			rttr::metadata("pretty_name", "Priority"),
+			rttr::metadata("tooltip",
+						   "Bias when competing for a real voice. Higher priority sources keep "
+						   "theirs over lower ones at the same distance."),
+			rttr::metadata("min", 0.0f), rttr::metadata("max", 1.0f))
 		.property("range", &audio_source_component::get_range,
 				  &audio_source_component::set_range)(rttr::metadata("pretty_name", "Range"))
 		.property("sound", &audio_source_component::get_sound,
@@ -38,6 +46,7 @@ SAVE(audio_source_component)
 	try_save(ar, cereal::make_nvp("volume", obj._volume));
 	try_save(ar, cereal::make_nvp("pitch", obj._pitch));
 	try_save(ar, cereal::make_nvp("volume_rolloff", obj._volume_rolloff));
+	try_save(ar, cereal::make_nvp("priority", obj._priority));
 	try_save(ar, cereal::make_nvp("range", obj._range));
 	try_save(ar, cereal::make_nvp("sound", obj._sound));
 }
@@ -52,6 +61,7 @@ LOAD(audio_source_component)
 	try_load(ar, cereal::make_nvp("volume", obj._volume));
 	try_load(ar, cereal::make_nvp("pitch", obj._pitch));
 	try_load(ar, cereal::make_nvp("volume_rolloff", obj._volume_rolloff));
+	try_load(ar, cereal::make_nvp("priority", obj._priority));
 	try_load(ar, cereal::make_nvp("range", obj._range));
 	try_load(ar, cereal::make_nvp("sound", obj._sound));
 
@@ -59,3 +69,6 @@ LOAD(audio_source_component)
 }
 LOAD_INSTANTIATE(audio_source_component, cereal::iarchive_associative_t);
 LOAD_INSTANTIATE(audio_source_component, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(audio_source_component, serialization::memory_input_archive);
+
+REGISTER_COMPONENT_SERIALIZATION(audio_source_component);
@@ -1,6 +1,7 @@
 #include "camera_component.hpp"
 #include "../../rendering/camera.hpp"
 #include "component.hpp"
+#include "component_serialization.h"
 
 REFLECT(camera_component)
 {
@@ -28,7 +29,11 @@ REFLECT(camera_component)
 		.property("far_clip_distance", &camera_component::get_far_clip,
 				  &camera_component::set_far_clip)(rttr::metadata("pretty_name", "Far Clip"))
 		.property("hdr", &camera_component::get_hdr,
-				  &camera_component::set_hdr)(rttr::metadata("pretty_name", "HDR"));
+				  &camera_component::set_hdr)(rttr::metadata("pretty_name", "HDR"))
+		.property("render_priority", &camera_component::get_render_priority,
+				  &camera_component::set_render_priority)(
+			rttr::metadata("pretty_name", "Render Priority"),
+			rttr::metadata("tooltip", "Render order among active cameras. Lower values render first."));
 }
 
 SAVE(camera_component)
@@ -36,6 +41,7 @@ SAVE(camera_component)
 	try_save(ar, cereal::make_nvp("base_type", cereal::base_class<runtime::component>(&obj)));
 	try_save(ar, cereal::make_nvp("camera", obj._camera));
 	try_save(ar, cereal::make_nvp("hdr", obj._hdr));
+	try_save(ar, cereal::make_nvp("render_priority", obj._render_priority));
 }
 SAVE_INSTANTIATE(camera_component, cereal::oarchive_associative_t);
 SAVE_INSTANTIATE(camera_component, cereal::oarchive_binary_t);
@@ -45,6 +51,10 @@ LOAD(camera_component)
 	try_load(ar, cereal::make_nvp("base_type", cereal::base_class<runtime::component>(&obj)));
 	try_load(ar, cereal::make_nvp("camera", obj._camera));
 	try_load(ar, cereal::make_nvp("hdr", obj._hdr));
+	try_load(ar, cereal::make_nvp("render_priority", obj._render_priority));
 }
 LOAD_INSTANTIATE(camera_component, cereal::iarchive_associative_t);
 LOAD_INSTANTIATE(camera_component, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(camera_component, serialization::memory_input_archive);
+
+REGISTER_COMPONENT_SERIALIZATION(camera_component);
@@ -25,4 +25,5 @@ LOAD(component)
 }
 LOAD_INSTANTIATE(component, cereal::iarchive_associative_t);
 LOAD_INSTANTIATE(component, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(component, serialization::memory_input_archive);
 }
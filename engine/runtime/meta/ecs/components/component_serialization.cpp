@@ -0,0 +1,45 @@
+#include "component_serialization.h"
+
+#include <unordered_map>
+
+namespace runtime
+{
+namespace
+{
+// Node based, so pointers into it stay valid as rows are added. Filled
+// during static initialization and read-only afterwards - lookups need
+// no lock.
+std::unordered_map<std::type_index, component_serializer>& get_table_by_type()
+{
+	static std::unordered_map<std::type_index, component_serializer> table;
+	return table;
+}
+
+std::unordered_map<std::string, const component_serializer*>& get_table_by_name()
+{
+	static std::unordered_map<std::string, const component_serializer*> table;
+	return table;
+}
+} // namespace
+
+void register_component_serializer(std::type_index type, const component_serializer& serializer)
+{
+	auto& row = get_table_by_type()[type];
+	row = serializer;
+	get_table_by_name()[serializer.name] = &row;
+}
+
+const component_serializer* find_component_serializer(std::type_index type)
+{
+	const auto& table = get_table_by_type();
+	auto it = table.find(type);
+	return it != table.end() ? &it->second : nullptr;
+}
+
+const component_serializer* find_component_serializer(const std::string& name)
+{
+	const auto& table = get_table_by_name();
+	auto it = table.find(name);
+	return it != table.end() ? it->second : nullptr;
+}
+} // namespace runtime
@@ -0,0 +1,68 @@
+#pragma once
+#include "../../../ecs/ecs.h"
+#include "core/serialization/binary_archive.h"
+#include "core/serialization/serialization.h"
+
+#include <memory>
+#include <string>
+#include <typeindex>
+
+namespace runtime
+{
+
+//-----------------------------------------------------------------------------
+//  Name : component_serializer (Struct)
+/// <summary>
+/// One row of the binary dispatch table - direct save/load entry points
+/// for a concrete component type. The table is built once at static
+/// registration, so serializing a component on the hot path is a table
+/// lookup and an indirect call with no per-object metadata resolution.
+/// </summary>
+//-----------------------------------------------------------------------------
+struct component_serializer
+{
+	/// Stable name the component is stored under.
+	const char* name = nullptr;
+	/// Writes the concrete component to the binary archive.
+	void (*save_binary)(cereal::oarchive_binary_t& ar, const component& obj) = nullptr;
+	/// Constructs and reads the concrete component from the binary archive.
+	std::shared_ptr<component> (*load_binary)(cereal::iarchive_binary_t& ar) = nullptr;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : register_component_serializer ()
+/// <summary>
+/// Adds a row to the dispatch table. Called from the static registrars
+/// the REGISTER_COMPONENT_SERIALIZATION macro emits.
+/// </summary>
+//-----------------------------------------------------------------------------
+void register_component_serializer(std::type_index type, const component_serializer& serializer);
+
+const component_serializer* find_component_serializer(std::type_index type);
+const component_serializer* find_component_serializer(const std::string& name);
+
+namespace detail
+{
+template <typename T>
+struct component_serializer_registrar
+{
+	component_serializer_registrar(const char* name)
+	{
+		component_serializer serializer;
+		serializer.name = name;
+		serializer.save_binary = [](cereal::oarchive_binary_t& ar, const component& obj) {
+			SAVE_FUNCTION_NAME(ar, static_cast<const T&>(obj));
+		};
+		serializer.load_binary = [](cereal::iarchive_binary_t& ar) -> std::shared_ptr<component> {
+			auto obj = std::make_shared<T>();
+			LOAD_FUNCTION_NAME(ar, *obj);
+			return obj;
+		};
+		register_component_serializer(std::type_index(typeid(T)), serializer);
+	}
+};
+} // namespace detail
+} // namespace runtime
+
+#define REGISTER_COMPONENT_SERIALIZATION(cls)                                                                \
+	static const runtime::detail::component_serializer_registrar<cls> s_##cls##_serializer_registrar{#cls}
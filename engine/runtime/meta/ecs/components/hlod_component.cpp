@@ -0,0 +1,44 @@
+#include "hlod_component.hpp"
+#include "../../core/math/vector.hpp"
+#include "../entity.hpp"
+#include "component.hpp"
+#include "component_serialization.h"
+#include "core/serialization/types/vector.hpp"
+
+REFLECT(hlod_component)
+{
+	rttr::registration::class_<hlod_component>("hlod_component")(
+		rttr::metadata("category", "RENDERING"), rttr::metadata("pretty_name", "HLOD Cluster"))
+		.constructor<>()(rttr::policy::ctor::as_std_shared_ptr)
+		.property("screen_size_threshold", &hlod_component::get_screen_size_threshold,
+				  &hlod_component::set_screen_size_threshold)(
+			rttr::metadata("pretty_name", "Screen Size Threshold"), rttr::metadata("min", 0.0f),
+			rttr::metadata("max", 1.0f),
+			rttr::metadata("tooltip", "Projected screen height fraction below which the merged proxy "
+									  "replaces the cluster's member entities."));
+}
+
+SAVE(hlod_component)
+{
+	try_save(ar, cereal::make_nvp("base_type", cereal::base_class<runtime::component>(&obj)));
+	try_save(ar, cereal::make_nvp("members", obj._members));
+	try_save(ar, cereal::make_nvp("cluster_bounds_min", obj._cluster_bounds.min));
+	try_save(ar, cereal::make_nvp("cluster_bounds_max", obj._cluster_bounds.max));
+	try_save(ar, cereal::make_nvp("screen_size_threshold", obj._screen_size_threshold));
+}
+SAVE_INSTANTIATE(hlod_component, cereal::oarchive_associative_t);
+SAVE_INSTANTIATE(hlod_component, cereal::oarchive_binary_t);
+
+LOAD(hlod_component)
+{
+	try_load(ar, cereal::make_nvp("base_type", cereal::base_class<runtime::component>(&obj)));
+	try_load(ar, cereal::make_nvp("members", obj._members));
+	try_load(ar, cereal::make_nvp("cluster_bounds_min", obj._cluster_bounds.min));
+	try_load(ar, cereal::make_nvp("cluster_bounds_max", obj._cluster_bounds.max));
+	try_load(ar, cereal::make_nvp("screen_size_threshold", obj._screen_size_threshold));
+}
+LOAD_INSTANTIATE(hlod_component, cereal::iarchive_associative_t);
+LOAD_INSTANTIATE(hlod_component, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(hlod_component, serialization::memory_input_archive);
+
+REGISTER_COMPONENT_SERIALIZATION(hlod_component);
@@ -0,0 +1,12 @@
+#pragma once
+#include "../../../ecs/components/hlod_component.h"
+#include "core/reflection/reflection.h"
+#include "core/serialization/serialization.h"
+
+REFLECT_EXTERN(hlod_component);
+SAVE_EXTERN(hlod_component);
+LOAD_EXTERN(hlod_component);
+
+#include "core/serialization/associative_archive.h"
+#include "core/serialization/binary_archive.h"
+CEREAL_REGISTER_TYPE(hlod_component)
@@ -3,6 +3,7 @@
 #include "../../core/math/vector.hpp"
 #include "../../rendering/light.hpp"
 #include "component.hpp"
+#include "component_serialization.h"
 
 REFLECT(light_component)
 {
@@ -26,3 +27,6 @@ LOAD(light_component)
 }
 LOAD_INSTANTIATE(light_component, cereal::iarchive_associative_t);
 LOAD_INSTANTIATE(light_component, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(light_component, serialization::memory_input_archive);
+
+REGISTER_COMPONENT_SERIALIZATION(light_component);
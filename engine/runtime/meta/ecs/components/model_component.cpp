@@ -3,6 +3,7 @@
 #include "../../rendering/mesh.hpp"
 #include "../../rendering/model.hpp"
 #include "component.hpp"
+#include "component_serialization.h"
 #include "core/serialization/types/vector.hpp"
 
 REFLECT(model_component)
@@ -43,3 +44,6 @@ LOAD(model_component)
 }
 LOAD_INSTANTIATE(model_component, cereal::iarchive_associative_t);
 LOAD_INSTANTIATE(model_component, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(model_component, serialization::memory_input_archive);
+
+REGISTER_COMPONENT_SERIALIZATION(model_component);
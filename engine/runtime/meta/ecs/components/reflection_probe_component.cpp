@@ -2,6 +2,7 @@
 #include "../../core/math/vector.hpp"
 #include "../../rendering/reflection_probe.hpp"
 #include "component.hpp"
+#include "component_serialization.h"
 
 REFLECT(reflection_probe_component)
 {
@@ -25,3 +26,6 @@ LOAD(reflection_probe_component)
 }
 LOAD_INSTANTIATE(reflection_probe_component, cereal::iarchive_associative_t);
 LOAD_INSTANTIATE(reflection_probe_component, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(reflection_probe_component, serialization::memory_input_archive);
+
+REGISTER_COMPONENT_SERIALIZATION(reflection_probe_component);
@@ -2,6 +2,7 @@
 #include "../../core/math/transform.hpp"
 #include "../../core/math/vector.hpp"
 #include "component.hpp"
+#include "component_serialization.h"
 #include "core/serialization/types/vector.hpp"
 
 REFLECT(transform_component)
@@ -50,3 +51,6 @@ LOAD(transform_component)
 }
 LOAD_INSTANTIATE(transform_component, cereal::iarchive_associative_t);
 LOAD_INSTANTIATE(transform_component, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(transform_component, serialization::memory_input_archive);
+
+REGISTER_COMPONENT_SERIALIZATION(transform_component);
@@ -1,24 +1,248 @@
 #include "entity.hpp"
+#include "components/component_serialization.h"
 #include "core/serialization/associative_archive.h"
 #include "core/serialization/binary_archive.h"
 #include "core/serialization/types/vector.hpp"
 #include "core/system/subsystem.h"
 
+#include <mutex>
+#include <typeindex>
+
 namespace runtime
 {
 std::map<std::uint64_t, runtime::entity>& get_serialization_map()
 {
-	/// Keep count of serialized entities
-	static std::map<std::uint64_t, runtime::entity> serialization_map;
+	/// Keep count of serialized entities. Thread local so that chunks of
+	/// a scene deserialized on worker threads each resolve their own
+	/// references - chunks are written to be self-contained.
+	static thread_local std::map<std::uint64_t, runtime::entity> serialization_map;
 	return serialization_map;
 }
 
+std::mutex& get_ecs_serialization_mutex()
+{
+	/// Guards ecs mutation (create/assign) while chunks deserialize in
+	/// parallel - the heavy per-entity work (parsing, reflection) stays
+	/// outside the lock.
+	static std::mutex ecs_mutex;
+	return ecs_mutex;
+}
+
+std::uint32_t& get_binary_component_format_version()
+{
+	/// Format the binary archive on this thread carries its entity data
+	/// in - 1 is the old cereal polymorphic encoding, 2 the fixed-width
+	/// dispatch table one, 3 the dispatch table with varint ids, counts
+	/// and string lengths. Writes always emit the current version; loads
+	/// set it from the artifact's format tag.
+	static thread_local std::uint32_t version = 3;
+	return version;
+}
+
+namespace
+{
+
+void save_binary_string(cereal::oarchive_binary_t& ar, const std::string& str)
+{
+	ar(serialization::varint(str.size()));
+	if(!str.empty())
+	{
+		ar(cereal::binary_data(str.data(), str.size()));
+	}
+}
+
+std::string load_binary_string(cereal::iarchive_binary_t& ar)
+{
+	serialization::varint length;
+	ar(length);
+	std::string str(static_cast<std::size_t>(length.value), '\0');
+	if(!str.empty())
+	{
+		ar(cereal::binary_data(&str[0], str.size()));
+	}
+	return str;
+}
+
+template <typename Archive>
+void save_entity_id(Archive& ar, std::uint64_t id)
+{
+	try_save(ar, cereal::make_nvp("entity_id", id));
+}
+
+void save_entity_id(cereal::oarchive_binary_t& ar, std::uint64_t id)
+{
+	ar(serialization::varint(id));
+}
+
+template <typename Archive>
+std::uint64_t load_entity_id(Archive& ar)
+{
+	std::uint64_t id = 0;
+	try_load(ar, cereal::make_nvp("entity_id", id));
+	return id;
+}
+
+std::uint64_t load_entity_id(cereal::iarchive_binary_t& ar)
+{
+	if(get_binary_component_format_version() >= 3)
+	{
+		serialization::varint id;
+		ar(id);
+		return id.value;
+	}
+
+	std::uint64_t id = 0;
+	try_load(ar, cereal::make_nvp("entity_id", id));
+	return id;
+}
+
+template <typename Archive>
+void save_entity_name(Archive& ar, const std::string& name)
+{
+	try_save(ar, cereal::make_nvp("name", name));
+}
+
+void save_entity_name(cereal::oarchive_binary_t& ar, const std::string& name)
+{
+	save_binary_string(ar, name);
+}
+
+template <typename Archive>
+std::string load_entity_name(Archive& ar)
+{
+	std::string name;
+	try_load(ar, cereal::make_nvp("name", name));
+	return name;
+}
+
+std::string load_entity_name(cereal::iarchive_binary_t& ar)
+{
+	if(get_binary_component_format_version() >= 3)
+	{
+		return load_binary_string(ar);
+	}
+
+	std::string name;
+	try_load(ar, cereal::make_nvp("name", name));
+	return name;
+}
+
+// The associative form keeps cereal's polymorphic encoding - source and
+// meta files must stay loadable by older builds and diffs.
+template <typename Archive>
+void save_components(Archive& ar, const entity& obj)
+{
+	try_save(ar, cereal::make_nvp("components", obj.all_components()));
+}
+
+// The binary form goes through the dispatch table instead - a lookup
+// and an indirect call per component, no polymorphic machinery.
+void save_components(cereal::oarchive_binary_t& ar, const entity& obj)
+{
+	auto components = obj.all_components_shared();
+	ar(serialization::varint(components.size()));
+	for(const auto& component_shared : components)
+	{
+		const component_serializer* serializer =
+			component_shared ? find_component_serializer(std::type_index(typeid(*component_shared)))
+							 : nullptr;
+		if(serializer == nullptr)
+		{
+			if(component_shared)
+			{
+				serialization::log_warning(std::string("no serializer registered for component type ") +
+										   typeid(*component_shared).name());
+			}
+			// keep the count honest - an empty name is skipped on load
+			save_binary_string(ar, std::string());
+			continue;
+		}
+
+		save_binary_string(ar, serializer->name);
+		serializer->save_binary(ar, *component_shared);
+	}
+}
+
+template <typename Archive>
+std::vector<std::shared_ptr<component>> load_components(Archive& ar)
+{
+	std::vector<chandle<component>> components;
+	try_load(ar, cereal::make_nvp("components", components));
+
+	std::vector<std::shared_ptr<component>> out;
+	out.reserve(components.size());
+	for(auto& component_handle : components)
+	{
+		auto component_shared = component_handle.lock();
+		if(component_shared)
+		{
+			out.push_back(std::move(component_shared));
+		}
+	}
+	return out;
+}
+
+std::vector<std::shared_ptr<component>> load_components(cereal::iarchive_binary_t& ar)
+{
+	const auto version = get_binary_component_format_version();
+	if(version < 2)
+	{
+		return load_components<cereal::iarchive_binary_t>(ar);
+	}
+
+	std::uint64_t count = 0;
+	if(version >= 3)
+	{
+		serialization::varint v;
+		ar(v);
+		count = v.value;
+	}
+	else
+	{
+		std::uint32_t fixed_count = 0;
+		ar(fixed_count);
+		count = fixed_count;
+	}
+
+	std::vector<std::shared_ptr<component>> out;
+	out.reserve(static_cast<std::size_t>(count));
+	for(std::uint64_t i = 0; i < count; ++i)
+	{
+		std::string name;
+		if(version >= 3)
+		{
+			name = load_binary_string(ar);
+		}
+		else
+		{
+			ar(name);
+		}
+		if(name.empty())
+		{
+			continue;
+		}
+
+		const component_serializer* serializer = find_component_serializer(name);
+		if(serializer == nullptr)
+		{
+			// the payload length is unknown without its serializer, so
+			// the rest of this entity's components cannot be recovered
+			serialization::log_warning("no serializer registered for component type " + name);
+			break;
+		}
+
+		out.push_back(serializer->load_binary(ar));
+	}
+	return out;
+}
+} // namespace
+
 SAVE(entity)
 {
 	// TODO check for validity
 
 	auto id = obj.id().id();
-	try_save(ar, cereal::make_nvp("entity_id", id));
+	save_entity_id(ar, id);
 
 	if(obj.valid())
 	{
@@ -28,8 +252,8 @@ SAVE(entity)
 		{
 			serialization_map[id] = obj;
 
-			try_save(ar, cereal::make_nvp("name", obj.get_name()));
-			try_save(ar, cereal::make_nvp("components", obj.all_components()));
+			save_entity_name(ar, obj.get_name());
+			save_components(ar, obj);
 		}
 	}
 }
@@ -38,11 +262,7 @@ SAVE_INSTANTIATE(entity, cereal::oarchive_binary_t);
 
 LOAD(entity)
 {
-	std::uint64_t id;
-	std::string name;
-	std::vector<chandle<component>> components;
-
-	try_load(ar, cereal::make_nvp("entity_id", id));
+	const std::uint64_t id = load_entity_id(ar);
 
 	if(id != entity::INVALID.id())
 	{
@@ -54,22 +274,22 @@ LOAD(entity)
 		}
 		else
 		{
-			auto& ecs = core::get_subsystem<entity_component_system>();
-			obj = ecs.create();
+			{
+				std::lock_guard<std::mutex> lock(get_ecs_serialization_mutex());
+				auto& ecs = core::get_subsystem<entity_component_system>();
+				obj = ecs.create();
+			}
 			serialization_map[id] = obj;
 
-			try_load(ar, cereal::make_nvp("name", name));
-			try_load(ar, cereal::make_nvp("components", components));
+			auto name = load_entity_name(ar);
+			auto components = load_components(ar);
 
+			std::lock_guard<std::mutex> lock(get_ecs_serialization_mutex());
 			obj.set_name(name);
-			for(auto component : components)
+			for(const auto& component_shared : components)
 			{
-				auto component_shared = component.lock();
-				if(component_shared)
-				{
-					obj.assign(component_shared);
-					component_shared->touch();
-				}
+				obj.assign(component_shared);
+				component_shared->touch();
 			}
 		}
 	}
@@ -77,4 +297,5 @@ LOAD(entity)
 
 LOAD_INSTANTIATE(entity, cereal::iarchive_associative_t);
 LOAD_INSTANTIATE(entity, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(entity, serialization::memory_input_archive);
 }
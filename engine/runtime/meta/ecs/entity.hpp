@@ -3,10 +3,14 @@
 #include "core/reflection/reflection.h"
 #include "core/serialization/serialization.h"
 
+#include <mutex>
+
 namespace runtime
 {
 
 std::map<std::uint64_t, runtime::entity>& get_serialization_map();
+std::mutex& get_ecs_serialization_mutex();
+std::uint32_t& get_binary_component_format_version();
 
 SAVE_EXTERN(entity);
 LOAD_EXTERN(entity);
@@ -8,6 +8,7 @@
 #include "ecs/components/audio_source_component.hpp"
 #include "ecs/components/camera_component.hpp"
 #include "ecs/components/component.hpp"
+#include "ecs/components/hlod_component.hpp"
 #include "ecs/components/light_component.hpp"
 #include "ecs/components/model_component.hpp"
 #include "ecs/components/reflection_probe_component.hpp"
@@ -17,6 +18,7 @@
 #include "rendering/camera.hpp"
 #include "rendering/light.hpp"
 #include "rendering/material.hpp"
+#include "rendering/material_instance.hpp"
 #include "rendering/mesh.hpp"
 #include "rendering/model.hpp"
 #include "rendering/program.hpp"
@@ -47,3 +47,4 @@ LOAD(camera)
 }
 LOAD_INSTANTIATE(camera, cereal::iarchive_associative_t);
 LOAD_INSTANTIATE(camera, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(camera, serialization::memory_input_archive);
@@ -97,3 +97,4 @@ LOAD(light)
 }
 LOAD_INSTANTIATE(light, cereal::iarchive_associative_t);
 LOAD_INSTANTIATE(light, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(light, serialization::memory_input_archive);
@@ -10,12 +10,15 @@ REFLECT(material)
 
 	rttr::registration::class_<material>("material")
 		.property("cull_type", &material::get_cull_type,
-				  &material::set_cull_type)(rttr::metadata("pretty_name", "Cull Type"));
+				  &material::set_cull_type)(rttr::metadata("pretty_name", "Cull Type"))
+		.property("transparent", &material::is_transparent,
+				  &material::set_transparent)(rttr::metadata("pretty_name", "Transparent"));
 }
 
 SAVE(material)
 {
 	try_save(ar, cereal::make_nvp("cull_type", obj._cull_type));
+	try_save(ar, cereal::make_nvp("transparent", obj._transparent));
 }
 SAVE_INSTANTIATE(material, cereal::oarchive_associative_t);
 SAVE_INSTANTIATE(material, cereal::oarchive_binary_t);
@@ -23,6 +26,8 @@ SAVE_INSTANTIATE(material, cereal::oarchive_binary_t);
 LOAD(material)
 {
 	try_load(ar, cereal::make_nvp("cull_type", obj._cull_type));
+	try_load(ar, cereal::make_nvp("transparent", obj._transparent));
 }
 LOAD_INSTANTIATE(material, cereal::iarchive_associative_t);
 LOAD_INSTANTIATE(material, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(material, serialization::memory_input_archive);
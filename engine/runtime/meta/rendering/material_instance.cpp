@@ -0,0 +1,82 @@
+#include "material_instance.hpp"
+#include "../assets/asset_handle.hpp"
+#include "../core/math/vector.hpp"
+#include "core/serialization/types/string.hpp"
+#include "core/serialization/types/unordered_map.hpp"
+#include "core/serialization/types/utility.hpp"
+#include "material.hpp"
+
+REFLECT(material_instance)
+{
+	rttr::registration::class_<material_instance>("material_instance")
+		.property("base_material", &material_instance::get_base_material,
+				  &material_instance::set_base_material)(rttr::metadata("pretty_name", "Base Material"))
+		.property("base_color", &material_instance::get_base_color,
+				  &material_instance::set_base_color)(rttr::metadata("pretty_name", "Base Color"))
+		.property("subsurface_color", &material_instance::get_subsurface_color,
+				  &material_instance::set_subsurface_color)(
+			rttr::metadata("pretty_name", "Subsurface Color"))
+		.property("emissive_color", &material_instance::get_emissive_color,
+				  &material_instance::set_emissive_color)(rttr::metadata("pretty_name", "Emissive Color"))
+		.property("roughness", &material_instance::get_roughness,
+				  &material_instance::set_roughness)(rttr::metadata("pretty_name", "Roughness"),
+													 rttr::metadata("min", 0.0f), rttr::metadata("max", 1.0f))
+		.property("metalness", &material_instance::get_metalness,
+				  &material_instance::set_metalness)(rttr::metadata("pretty_name", "Metalness"),
+													 rttr::metadata("min", 0.0f), rttr::metadata("max", 1.0f))
+		.property("bumpiness", &material_instance::get_bumpiness, &material_instance::set_bumpiness)(
+			rttr::metadata("pretty_name", "Bumpiness"), rttr::metadata("min", 0.0f),
+			rttr::metadata("max", 10.0f))
+		.property("alpha_test_value", &material_instance::get_alpha_test_value,
+				  &material_instance::set_alpha_test_value)(rttr::metadata("pretty_name", "Alpha Test Value"),
+															rttr::metadata("min", 0.0f),
+															rttr::metadata("max", 1.0f))
+		.property("tiling", &material_instance::get_tiling,
+				  &material_instance::set_tiling)(rttr::metadata("pretty_name", "Tiling"))
+		.property("dither_threshold", &material_instance::get_dither_threshold,
+				  &material_instance::set_dither_threshold)(
+			rttr::metadata("pretty_name", "Dither Threshold"))
+		.property("color_map", &material_instance::get_color_map,
+				  &material_instance::set_color_map)(rttr::metadata("pretty_name", "Color Map"))
+		.property("normal_map", &material_instance::get_normal_map,
+				  &material_instance::set_normal_map)(rttr::metadata("pretty_name", "Normal Map"))
+		.property("roughness_map", &material_instance::get_roughness_map,
+				  &material_instance::set_roughness_map)(rttr::metadata("pretty_name", "Roughness Map"))
+		.property("metalness_map", &material_instance::get_metalness_map,
+				  &material_instance::set_metalness_map)(rttr::metadata("pretty_name", "Metalness Map"))
+		.property("ao_map", &material_instance::get_ao_map,
+				  &material_instance::set_ao_map)(rttr::metadata("pretty_name", "AO Map"));
+}
+
+SAVE(material_instance)
+{
+	try_save(ar, cereal::make_nvp("base_type", cereal::base_class<material>(&obj)));
+	try_save(ar, cereal::make_nvp("base_material", obj._base));
+	try_save(ar, cereal::make_nvp("overrides", obj._overrides));
+	try_save(ar, cereal::make_nvp("base_color", obj._base_color));
+	try_save(ar, cereal::make_nvp("subsurface_color", obj._subsurface_color));
+	try_save(ar, cereal::make_nvp("emissive_color", obj._emissive_color));
+	try_save(ar, cereal::make_nvp("surface_data", obj._surface_data));
+	try_save(ar, cereal::make_nvp("tiling", obj._tiling));
+	try_save(ar, cereal::make_nvp("dither_threshold", obj._dither_threshold));
+	try_save(ar, cereal::make_nvp("maps", obj._maps));
+}
+SAVE_INSTANTIATE(material_instance, cereal::oarchive_associative_t);
+SAVE_INSTANTIATE(material_instance, cereal::oarchive_binary_t);
+
+LOAD(material_instance)
+{
+	try_load(ar, cereal::make_nvp("base_type", cereal::base_class<material>(&obj)));
+	try_load(ar, cereal::make_nvp("base_material", obj._base));
+	try_load(ar, cereal::make_nvp("overrides", obj._overrides));
+	try_load(ar, cereal::make_nvp("base_color", obj._base_color));
+	try_load(ar, cereal::make_nvp("subsurface_color", obj._subsurface_color));
+	try_load(ar, cereal::make_nvp("emissive_color", obj._emissive_color));
+	try_load(ar, cereal::make_nvp("surface_data", obj._surface_data));
+	try_load(ar, cereal::make_nvp("tiling", obj._tiling));
+	try_load(ar, cereal::make_nvp("dither_threshold", obj._dither_threshold));
+	try_load(ar, cereal::make_nvp("maps", obj._maps));
+}
+LOAD_INSTANTIATE(material_instance, cereal::iarchive_associative_t);
+LOAD_INSTANTIATE(material_instance, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(material_instance, serialization::memory_input_archive);
@@ -0,0 +1,13 @@
+#pragma once
+#include "../../rendering/material.h"
+#include "core/reflection/reflection.h"
+#include "core/serialization/serialization.h"
+
+REFLECT_EXTERN(material_instance);
+
+SAVE_EXTERN(material_instance);
+LOAD_EXTERN(material_instance);
+
+#include "core/serialization/associative_archive.h"
+#include "core/serialization/binary_archive.h"
+CEREAL_REGISTER_TYPE(material_instance)
@@ -33,6 +33,7 @@ LOAD(VertexDecl)
 	try_load(ar, cereal::make_nvp("attributes", obj.m_attributes));
 }
 LOAD_INSTANTIATE(VertexDecl, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(VertexDecl, serialization::memory_input_archive);
 }
 
 SAVE(mesh::triangle)
@@ -50,6 +51,7 @@ LOAD(mesh::triangle)
 	try_load(ar, cereal::make_nvp("flags", obj.flags));
 }
 LOAD_INSTANTIATE(mesh::triangle, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(mesh::triangle, serialization::memory_input_archive);
 
 SAVE(skin_bind_data::vertex_influence)
 {
@@ -64,6 +66,7 @@ LOAD(skin_bind_data::vertex_influence)
 	try_load(ar, cereal::make_nvp("weight", obj.weight));
 }
 LOAD_INSTANTIATE(skin_bind_data::vertex_influence, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(skin_bind_data::vertex_influence, serialization::memory_input_archive);
 
 SAVE(skin_bind_data::bone_influence)
 {
@@ -80,6 +83,7 @@ LOAD(skin_bind_data::bone_influence)
 	try_load(ar, cereal::make_nvp("influences", obj.influences));
 }
 LOAD_INSTANTIATE(skin_bind_data::bone_influence, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(skin_bind_data::bone_influence, serialization::memory_input_archive);
 
 SAVE(skin_bind_data)
 {
@@ -92,6 +96,7 @@ LOAD(skin_bind_data)
 	try_load(ar, cereal::make_nvp("bones", obj._bones));
 }
 LOAD_INSTANTIATE(skin_bind_data, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(skin_bind_data, serialization::memory_input_archive);
 
 SAVE(mesh::armature_node)
 {
@@ -108,6 +113,7 @@ LOAD(mesh::armature_node)
 	try_load(ar, cereal::make_nvp("children", obj.children));
 }
 LOAD_INSTANTIATE(mesh::armature_node, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(mesh::armature_node, serialization::memory_input_archive);
 
 SAVE(mesh::load_data)
 {
@@ -134,3 +140,4 @@ LOAD(mesh::load_data)
 	try_load(ar, cereal::make_nvp("root_node", obj.root_node));
 }
 LOAD_INSTANTIATE(mesh::load_data, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(mesh::load_data, serialization::memory_input_archive);
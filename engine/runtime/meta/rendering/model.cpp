@@ -46,3 +46,4 @@ LOAD(model)
 }
 LOAD_INSTANTIATE(model, cereal::iarchive_associative_t);
 LOAD_INSTANTIATE(model, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(model, serialization::memory_input_archive);
@@ -25,3 +25,4 @@ LOAD(gpu_program)
 }
 LOAD_INSTANTIATE(gpu_program, cereal::iarchive_associative_t);
 LOAD_INSTANTIATE(gpu_program, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(gpu_program, serialization::memory_input_archive);
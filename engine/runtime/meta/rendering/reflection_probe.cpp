@@ -42,3 +42,4 @@ LOAD(reflection_probe)
 }
 LOAD_INSTANTIATE(reflection_probe, cereal::iarchive_associative_t);
 LOAD_INSTANTIATE(reflection_probe, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(reflection_probe, serialization::memory_input_archive);
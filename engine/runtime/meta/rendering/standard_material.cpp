@@ -76,3 +76,4 @@ LOAD(standard_material)
 }
 LOAD_INSTANTIATE(standard_material, cereal::iarchive_associative_t);
 LOAD_INSTANTIATE(standard_material, cereal::iarchive_binary_t);
+LOAD_INSTANTIATE(standard_material, serialization::memory_input_archive);
@@ -118,6 +118,7 @@ void camera::set_aspect_ratio(float aspect, bool bLocked /* = false */)
 	_aspect_dirty = true;
 	_frustum_dirty = true;
 	_projection_dirty = true;
+	++_version;
 }
 
 bool camera::is_aspect_locked() const
@@ -199,23 +200,33 @@ void camera::look_at(const math::vec3& vEye, const math::vec3& vAt, const math::
 	touch();
 }
 
+const math::transform& camera::get_inverse_view() const
+{
+	if(_inverse_view_cache_version != _version)
+	{
+		_inverse_view = math::inverse(_view);
+		_inverse_view_cache_version = _version;
+	}
+	return _inverse_view;
+}
+
 math::vec3 camera::get_position() const
 {
-	return math::inverse(_view).get_position();
+	return get_inverse_view().get_position();
 }
 
 math::vec3 camera::x_unit_axis() const
 {
-	return math::inverse(_view).x_unit_axis();
+	return get_inverse_view().x_unit_axis();
 }
 math::vec3 camera::y_unit_axis() const
 {
-	return math::inverse(_view).y_unit_axis();
+	return get_inverse_view().y_unit_axis();
 }
 
 math::vec3 camera::z_unit_axis() const
 {
-	return math::inverse(_view).z_unit_axis();
+	return get_inverse_view().z_unit_axis();
 }
 
 const math::frustum& camera::get_frustum() const
@@ -620,6 +631,7 @@ void camera::set_aa_data(const usize& viewport_size, std::uint32_t current_subpi
 	}
 
 	_projection_dirty = true;
+	++_version;
 }
 
 void camera::touch()
@@ -629,6 +641,7 @@ void camera::touch()
 	_view_dirty = true;
 	_projection_dirty = true;
 	_frustum_dirty = true;
+	++_version;
 }
 
 camera camera::get_face_camera(uint32_t face, const math::transform& transform)
@@ -288,12 +288,40 @@ public:
 	//-----------------------------------------------------------------------------
 	//  Name : get_view_projection ()
 	/// <summary>
-	/// Return the current view-projection matrix.
+	/// Return the current view-projection matrix. Cached against the camera
+	/// version, so repeated reads within a frame cost nothing.
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	inline math::transform get_view_projection() const
+	inline const math::transform& get_view_projection() const
 	{
-		return get_projection() * get_view();
+		if(_view_proj_cache_version != _version)
+		{
+			_view_projection = get_projection() * get_view();
+			_view_proj_cache_version = _version;
+		}
+		return _view_projection;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_inverse_view ()
+	/// <summary>
+	/// Return the inverse of the current view matrix (the camera's world
+	/// transform). Cached against the camera version.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const math::transform& get_inverse_view() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_version ()
+	/// <summary>
+	/// Monotonic counter bumped by every modification that changes derived
+	/// data. Consumers caching per-camera results can compare versions
+	/// instead of comparing matrices.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline std::uint32_t get_version() const
+	{
+		return _version;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -615,4 +643,14 @@ protected:
 	bool _aspect_locked = false;
 	/// Is the frustum locked?
 	bool _frustum_locked = false;
+	/// Cached view-projection product.
+	mutable math::transform _view_projection;
+	/// Cached inverse view matrix (camera world transform).
+	mutable math::transform _inverse_view;
+	/// Bumped by every modification; derived caches compare against it.
+	std::uint32_t _version = 1;
+	/// Version the view-projection cache was built at (0 = never).
+	mutable std::uint32_t _view_proj_cache_version = 0;
+	/// Version the inverse-view cache was built at (0 = never).
+	mutable std::uint32_t _inverse_view_cache_version = 0;
 };
@@ -0,0 +1,187 @@
+#include "light_cluster.h"
+#include "camera.h"
+
+#include <functional>
+
+namespace
+{
+//-----------------------------------------------------------------------------
+//  Name : sphere_intersects_box ()
+/// <summary>
+/// Squared-distance test between a sphere and an axis aligned box.
+/// </summary>
+//-----------------------------------------------------------------------------
+bool sphere_intersects_box(const math::vec3& center, float radius, const math::vec3& box_min,
+						   const math::vec3& box_max)
+{
+	float distance_sq = 0.0f;
+	for(int axis = 0; axis < 3; ++axis)
+	{
+		const float v = center[axis];
+		if(v < box_min[axis])
+			distance_sq += (box_min[axis] - v) * (box_min[axis] - v);
+		else if(v > box_max[axis])
+			distance_sq += (v - box_max[axis]) * (v - box_max[axis]);
+	}
+	return distance_sq <= radius * radius;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : spot_bounding_sphere ()
+/// <summary>
+/// Conservative bounding sphere of a spot cone.
+/// </summary>
+//-----------------------------------------------------------------------------
+void spot_bounding_sphere(const math::vec3& position, const math::vec3& direction, float range,
+						  float outer_angle_degrees, math::vec3& out_center, float& out_radius)
+{
+	const float half_angle = math::radians(outer_angle_degrees * 0.5f);
+	if(half_angle > math::quarter_pi<float>())
+	{
+		out_center = position + direction * (range * math::cos(half_angle));
+		out_radius = range * math::sin(half_angle);
+	}
+	else
+	{
+		out_radius = range / (2.0f * math::cos(half_angle));
+		out_center = position + direction * out_radius;
+	}
+}
+}
+
+void light_cluster::rebuild_grid(const camera& cam)
+{
+	const auto& proj = cam.get_projection();
+	const float near_clip = cam.get_near_clip();
+	const float far_clip = cam.get_far_clip();
+
+	// Cheap change detection on the projection; the cluster boxes only
+	// depend on it and the clip range.
+	std::size_t hash = std::hash<float>()(near_clip) ^ (std::hash<float>()(far_clip) << 1);
+	const float* proj_data = &proj[0][0];
+	for(int i = 0; i < 16; ++i)
+		hash ^= std::hash<float>()(proj_data[i]) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	if(hash == _grid_hash && !_bounds.empty())
+		return;
+	_grid_hash = hash;
+
+	const auto inv_proj = math::inverse(proj);
+
+	// NDC tile borders and per-slice NDC depths. Slices are exponential so
+	// near clusters stay small where precision matters.
+	float ndc_x[grid_x + 1];
+	float ndc_y[grid_y + 1];
+	float ndc_z[grid_z + 1];
+	for(std::uint32_t i = 0; i <= grid_x; ++i)
+		ndc_x[i] = -1.0f + 2.0f * float(i) / float(grid_x);
+	for(std::uint32_t i = 0; i <= grid_y; ++i)
+		ndc_y[i] = -1.0f + 2.0f * float(i) / float(grid_y);
+	for(std::uint32_t i = 0; i <= grid_z; ++i)
+	{
+		const float t = float(i) / float(grid_z);
+		const float view_z = near_clip * math::pow(far_clip / near_clip, t);
+		const auto projected = proj * math::vec4(0.0f, 0.0f, view_z, 1.0f);
+		ndc_z[i] = projected.z / projected.w;
+	}
+
+	_bounds.resize(grid_x * grid_y * grid_z);
+	for(std::uint32_t z = 0; z < grid_z; ++z)
+	{
+		for(std::uint32_t y = 0; y < grid_y; ++y)
+		{
+			for(std::uint32_t x = 0; x < grid_x; ++x)
+			{
+				auto& bounds = _bounds[(z * grid_y + y) * grid_x + x];
+				bounds.min = math::vec3(math::infinity<float>());
+				bounds.max = math::vec3(-math::infinity<float>());
+
+				const float corner_x[2] = {ndc_x[x], ndc_x[x + 1]};
+				const float corner_y[2] = {ndc_y[y], ndc_y[y + 1]};
+				const float corner_z[2] = {ndc_z[z], ndc_z[z + 1]};
+				for(int cx = 0; cx < 2; ++cx)
+				{
+					for(int cy = 0; cy < 2; ++cy)
+					{
+						for(int cz = 0; cz < 2; ++cz)
+						{
+							auto corner =
+								inv_proj *
+								math::vec4(corner_x[cx], corner_y[cy], corner_z[cz], 1.0f);
+							const auto view_pos = math::vec3(corner) / corner.w;
+							bounds.min = math::min(bounds.min, view_pos);
+							bounds.max = math::max(bounds.max, view_pos);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void light_cluster::build(const camera& cam, const std::vector<bin_light>& lights)
+{
+	rebuild_grid(cam);
+
+	const std::uint32_t cluster_count = grid_x * grid_y * grid_z;
+	const auto& view = cam.get_view();
+
+	// Per-cluster scratch lists, flattened afterwards.
+	static thread_local std::vector<std::vector<std::uint32_t>> scratch;
+	scratch.resize(cluster_count);
+	for(auto& bucket : scratch)
+		bucket.clear();
+
+	_light_cluster_counts.assign(lights.size(), 0);
+
+	for(std::size_t light_index = 0; light_index < lights.size(); ++light_index)
+	{
+		const auto& entry = lights[light_index];
+
+		if(entry.data.type == light_type::directional)
+		{
+			// Directional lights influence everything.
+			for(std::uint32_t cluster = 0; cluster < cluster_count; ++cluster)
+				scratch[cluster].push_back(std::uint32_t(light_index));
+			_light_cluster_counts[light_index] = cluster_count;
+			continue;
+		}
+
+		math::vec3 world_center = entry.position;
+		float radius = 0.0f;
+		if(entry.data.type == light_type::point)
+		{
+			radius = entry.data.point_data.range;
+		}
+		else
+		{
+			spot_bounding_sphere(entry.position, entry.direction, entry.data.spot_data.get_range(),
+								 entry.data.spot_data.get_outer_angle(), world_center, radius);
+		}
+
+		const auto view_center_h = view * math::vec4(world_center, 1.0f);
+		const auto view_center = math::vec3(view_center_h);
+
+		std::uint32_t touched = 0;
+		for(std::uint32_t cluster = 0; cluster < cluster_count; ++cluster)
+		{
+			const auto& bounds = _bounds[cluster];
+			if(!sphere_intersects_box(view_center, radius, bounds.min, bounds.max))
+				continue;
+			scratch[cluster].push_back(std::uint32_t(light_index));
+			++touched;
+		}
+		_light_cluster_counts[light_index] = touched;
+	}
+
+	// Flatten into the packed (offset << 8) | count table. A cluster can
+	// hold at most 255 lights with this packing, plenty for our scenes.
+	_cluster_table.resize(cluster_count);
+	_light_list.clear();
+	for(std::uint32_t cluster = 0; cluster < cluster_count; ++cluster)
+	{
+		const auto& bucket = scratch[cluster];
+		const auto count = std::uint32_t(bucket.size() < 255 ? bucket.size() : 255);
+		_cluster_table[cluster] = (std::uint32_t(_light_list.size()) << 8) | count;
+		_light_list.insert(_light_list.end(), bucket.begin(), bucket.begin() + count);
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "core/math/math_includes.h"
+#include "light.h"
+#include <cstdint>
+#include <vector>
+
+class camera;
+
+//-----------------------------------------------------------------------------
+//  Name : light_cluster (Class)
+/// <summary>
+/// CPU-side clustered light binning. The camera frustum is partitioned into
+/// a grid of view-space clusters (screen tiles x exponential depth slices)
+/// and every punctual light is assigned to the clusters its bounding sphere
+/// touches. The packed cluster table and flattened light list are laid out
+/// ready for GPU upload; until the clustered lighting shader consumes them
+/// the per-cluster counts already let the lighting pass skip lights that
+/// cover no cluster at all.
+/// </summary>
+//-----------------------------------------------------------------------------
+class light_cluster
+{
+public:
+	/// grid dimensions: screen tiles in x/y, exponential depth slices in z
+	static const std::uint32_t grid_x = 16;
+	static const std::uint32_t grid_y = 8;
+	static const std::uint32_t grid_z = 24;
+
+	/// One light as the binner sees it: type/range data plus world placement.
+	struct bin_light
+	{
+		light data;
+		math::vec3 position = {0.0f, 0.0f, 0.0f};
+		math::vec3 direction = {0.0f, 0.0f, 1.0f};
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : build ()
+	/// <summary>
+	/// Rebuilds the cluster grid for the camera and assigns the given lights.
+	/// Directional lights touch every cluster; point and spot lights are
+	/// tested as view-space bounding spheres against the cluster boxes.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void build(const camera& cam, const std::vector<bin_light>& lights);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_cluster_table ()
+	/// <summary>
+	/// Per-cluster packed entry: (offset << 8) | count into the light list.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const std::vector<std::uint32_t>& get_cluster_table() const
+	{
+		return _cluster_table;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_light_list ()
+	/// <summary>
+	/// Flattened light indices referenced by the cluster table.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	const std::vector<std::uint32_t>& get_light_list() const
+	{
+		return _light_list;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_cluster_count ()
+	/// <summary>
+	/// How many clusters the light at the given index landed in; zero means
+	/// the light influences nothing this camera can see.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::uint32_t get_cluster_count(std::size_t light_index) const
+	{
+		if(light_index >= _light_cluster_counts.size())
+			return 0;
+		return _light_cluster_counts[light_index];
+	}
+
+private:
+	/// view-space min/max box of one cluster
+	struct cluster_bounds
+	{
+		math::vec3 min;
+		math::vec3 max;
+	};
+
+	void rebuild_grid(const camera& cam);
+
+	/// cached cluster boxes; recomputed when the camera projection changed
+	std::vector<cluster_bounds> _bounds;
+	/// hash of the projection the cached boxes were derived from
+	std::size_t _grid_hash = 0;
+	/// per-cluster (offset << 8) | count
+	std::vector<std::uint32_t> _cluster_table;
+	/// flattened per-cluster light indices
+	std::vector<std::uint32_t> _light_list;
+	/// per-light number of clusters touched
+	std::vector<std::uint32_t> _light_cluster_counts;
+};
@@ -4,9 +4,12 @@
 #include "core/system/subsystem.h"
 
 #include "gpu_program.h"
+#include "texture_residency.h"
 
 #include "../assets/asset_manager.h"
 
+#include <cstring>
+
 material::material()
 {
 	auto& am = core::get_subsystem<runtime::asset_manager>();
@@ -41,7 +44,15 @@ void material::set_uniform(const std::string& _name, const void* _value, std::ui
 
 gpu_program* material::get_program() const
 {
-	return skinned ? _program_skinned.get() : _program.get();
+	if(skinned)
+		return _program_skinned.get();
+	// Deliberately no fallback to the regular program here; callers probe
+	// this to decide whether the instanced submission paths are available.
+	if(instanced_array)
+		return _program_instanced_array.get();
+	if(instanced)
+		return _program_instanced.get();
+	return _program.get();
 }
 
 std::uint64_t material::get_render_states(bool apply_cull, bool depth_write, bool depth_test) const
@@ -73,7 +84,12 @@ standard_material::standard_material()
 	auto& am = core::get_subsystem<runtime::asset_manager>();
 	auto vs_deferred_geom = am.load<gfx::shader>("engine:/data/shaders/vs_deferred_geom.sc");
 	auto vs_deferred_geom_skinned = am.load<gfx::shader>("engine:/data/shaders/vs_deferred_geom_skinned.sc");
+	auto vs_deferred_geom_instanced =
+		am.load<gfx::shader>("engine:/data/shaders/vs_deferred_geom_instanced.sc");
+	auto vs_deferred_geom_instanced_array =
+		am.load<gfx::shader>("engine:/data/shaders/vs_deferred_geom_instanced_array.sc");
 	auto fs_deferred_geom = am.load<gfx::shader>("engine:/data/shaders/fs_deferred_geom.sc");
+	auto fs_deferred_geom_array = am.load<gfx::shader>("engine:/data/shaders/fs_deferred_geom_array.sc");
 
 	auto f = ts.push_or_execute_on_owner_thread(
 		[this](asset_handle<gfx::shader> vs, asset_handle<gfx::shader> fs) {
@@ -89,8 +105,24 @@ standard_material::standard_material()
 		},
 		vs_deferred_geom_skinned, fs_deferred_geom);
 
+	auto f2 = ts.push_or_execute_on_owner_thread(
+		[this](asset_handle<gfx::shader> vs, asset_handle<gfx::shader> fs) {
+			_program_instanced = std::make_unique<gpu_program>(vs, fs);
+
+		},
+		vs_deferred_geom_instanced, fs_deferred_geom);
+
+	auto f3 = ts.push_or_execute_on_owner_thread(
+		[this](asset_handle<gfx::shader> vs, asset_handle<gfx::shader> fs) {
+			_program_instanced_array = std::make_unique<gpu_program>(vs, fs);
+
+		},
+		vs_deferred_geom_instanced_array, fs_deferred_geom_array);
+
 	_futures.emplace_back(std::move(f));
 	_futures.emplace_back(std::move(f1));
+	_futures.emplace_back(std::move(f2));
+	_futures.emplace_back(std::move(f3));
 }
 
 standard_material::~standard_material()
@@ -101,17 +133,86 @@ standard_material::~standard_material()
 	}
 }
 
+namespace
+{
+/// Registry ids of the standard material uniforms. Resolved once on first
+/// submit (uniform creation needs the device up); after that binding is a
+/// plain registry index with the name hashes folded at compile time.
+struct standard_uniform_ids
+{
+	gfx::uniform_id base_color =
+		gfx::register_uniform(gfx::uniform_hash("u_base_color"), "u_base_color", gfx::uniform_type::Vec4);
+	gfx::uniform_id subsurface_color = gfx::register_uniform(gfx::uniform_hash("u_subsurface_color"),
+															 "u_subsurface_color", gfx::uniform_type::Vec4);
+	gfx::uniform_id emissive_color = gfx::register_uniform(gfx::uniform_hash("u_emissive_color"),
+														   "u_emissive_color", gfx::uniform_type::Vec4);
+	gfx::uniform_id surface_data =
+		gfx::register_uniform(gfx::uniform_hash("u_surface_data"), "u_surface_data", gfx::uniform_type::Vec4);
+	gfx::uniform_id tiling =
+		gfx::register_uniform(gfx::uniform_hash("u_tiling"), "u_tiling", gfx::uniform_type::Vec4);
+	gfx::uniform_id dither_threshold = gfx::register_uniform(gfx::uniform_hash("u_dither_threshold"),
+															 "u_dither_threshold", gfx::uniform_type::Vec4);
+
+	gfx::uniform_id tex_color =
+		gfx::register_uniform(gfx::uniform_hash("s_tex_color"), "s_tex_color", gfx::uniform_type::Int1);
+	gfx::uniform_id tex_normal =
+		gfx::register_uniform(gfx::uniform_hash("s_tex_normal"), "s_tex_normal", gfx::uniform_type::Int1);
+	gfx::uniform_id tex_roughness = gfx::register_uniform(gfx::uniform_hash("s_tex_roughness"),
+														  "s_tex_roughness", gfx::uniform_type::Int1);
+	gfx::uniform_id tex_metalness = gfx::register_uniform(gfx::uniform_hash("s_tex_metalness"),
+														  "s_tex_metalness", gfx::uniform_type::Int1);
+	gfx::uniform_id tex_ao =
+		gfx::register_uniform(gfx::uniform_hash("s_tex_ao"), "s_tex_ao", gfx::uniform_type::Int1);
+};
+
+const standard_uniform_ids& get_standard_uniform_ids()
+{
+	static const standard_uniform_ids ids;
+	return ids;
+}
+
+void set_registered_texture(std::uint8_t stage, gfx::uniform_id id, gfx::texture* tex)
+{
+	if(tex == nullptr)
+		return;
+
+	gfx::set_texture(stage, gfx::get_registered_uniform(id).native_handle(), tex->native_handle());
+}
+
+/// Last material binding submitted on this thread this frame. bgfx retains
+/// uniform values between submits recorded on the same thread, so a clean
+/// material that immediately follows itself only has to rebind its texture
+/// stages. Thread local because passes can record through per-thread
+/// encoders whose uniform streams are independent.
+thread_local const material* s_last_material = nullptr;
+thread_local const gpu_program* s_last_program = nullptr;
+thread_local std::uint64_t s_last_frame = std::uint64_t(-1);
+}
+
 void standard_material::submit()
 {
 	if(!is_valid())
 		return;
 
-	get_program()->set_uniform("u_base_color", &_base_color);
-	get_program()->set_uniform("u_subsurface_color", &_subsurface_color);
-	get_program()->set_uniform("u_emissive_color", &_emissive_color);
-	get_program()->set_uniform("u_surface_data", &_surface_data);
-	get_program()->set_uniform("u_tiling", &_tiling);
-	get_program()->set_uniform("u_dither_threshold", &_dither_threshold);
+	const auto frame = gfx::get_render_frame();
+	const bool skip_uniforms =
+		!_dirty && s_last_material == this && s_last_program == get_program() && s_last_frame == frame;
+	s_last_material = this;
+	s_last_program = get_program();
+	s_last_frame = frame;
+	_dirty = false;
+
+	const auto& uids = get_standard_uniform_ids();
+
+	if(!skip_uniforms)
+	{
+		gfx::set_registered_uniform(uids.base_color, &_base_color);
+		gfx::set_registered_uniform(uids.subsurface_color, &_subsurface_color);
+		gfx::set_registered_uniform(uids.emissive_color, &_emissive_color);
+		gfx::set_registered_uniform(uids.surface_data, &_surface_data);
+		gfx::set_registered_uniform(uids.tiling, &_tiling);
+		gfx::set_registered_uniform(uids.dither_threshold, &_dither_threshold);
+	}
 
 	const auto& color_map = _maps["color"];
 	const auto& normal_map = _maps["normal"];
@@ -125,9 +226,297 @@ void standard_material::submit()
 	auto metalness = metalness_map ? metalness_map : _default_color_map;
 	auto ao = ao_map ? ao_map : _default_color_map;
 
-	get_program()->set_texture(0, "s_tex_color", albedo.get());
-	get_program()->set_texture(1, "s_tex_normal", normal.get());
-	get_program()->set_texture(2, "s_tex_roughness", roughness.get());
-	get_program()->set_texture(3, "s_tex_metalness", metalness.get());
-	get_program()->set_texture(4, "s_tex_ao", ao.get());
+	// Stamp the assigned textures as rendered this frame; evicted ones
+	// kick off their async reload here and fall back to the defaults
+	// until it lands. The touch goes to the assigned maps rather than
+	// the substituted ones - an evicted map reads as empty and would
+	// otherwise never come back.
+	if(core::has_subsystems<runtime::texture_residency>())
+	{
+		auto& residency = core::get_subsystem<runtime::texture_residency>();
+		residency.touch(color_map);
+		residency.touch(normal_map);
+		residency.touch(roughness_map);
+		residency.touch(metalness_map);
+		residency.touch(ao_map);
+		residency.touch(_default_color_map);
+		residency.touch(_default_normal_map);
+	}
+
+	// On the array-instanced path the samplers are the shared layered
+	// arrays; the layer picking this material's maps rides per instance.
+	if(instanced_array && _array_slice.ready && _array_slice.set != nullptr)
+	{
+		const auto& arrays = _array_slice.set->arrays;
+		set_registered_texture(0, uids.tex_color, arrays[0].get());
+		set_registered_texture(1, uids.tex_normal, arrays[1].get());
+		set_registered_texture(2, uids.tex_roughness, arrays[2].get());
+		set_registered_texture(3, uids.tex_metalness, arrays[3].get());
+		set_registered_texture(4, uids.tex_ao, arrays[4].get());
+		return;
+	}
+
+	set_registered_texture(0, uids.tex_color, albedo.get());
+	set_registered_texture(1, uids.tex_normal, normal.get());
+	set_registered_texture(2, uids.tex_roughness, roughness.get());
+	set_registered_texture(3, uids.tex_metalness, metalness.get());
+	set_registered_texture(4, uids.tex_ao, ao.get());
+}
+
+const runtime::texture_array_pool::slice* standard_material::get_texture_array_slice()
+{
+	if(!core::has_subsystems<runtime::texture_array_pool>())
+		return nullptr;
+
+	const auto& color_map = _maps["color"];
+	const auto& normal_map = _maps["normal"];
+	const auto& roughness_map = _maps["roughness"];
+	const auto& metalness_map = _maps["metalness"];
+	const auto& ao_map = _maps["ao"];
+
+	const std::array<std::shared_ptr<gfx::texture>, runtime::texture_array_set::map_count> maps = {
+		{(color_map ? color_map : _default_color_map).get_asset(),
+		 (normal_map ? normal_map : _default_normal_map).get_asset(),
+		 (roughness_map ? roughness_map : _default_color_map).get_asset(),
+		 (metalness_map ? metalness_map : _default_color_map).get_asset(),
+		 (ao_map ? ao_map : _default_color_map).get_asset()}};
+
+	std::array<const gfx::texture*, runtime::texture_array_set::map_count> sources{};
+	for(std::size_t i = 0; i < maps.size(); ++i)
+		sources[i] = maps[i].get();
+
+	// Re-resolve when a map streamed in or was reassigned, and keep
+	// retrying while the upload of a fresh slice is still pending.
+	if(sources != _array_sources || !_array_slice.ready)
+	{
+		auto& pool = core::get_subsystem<runtime::texture_array_pool>();
+		_array_slice = pool.acquire(maps);
+		_array_sources = sources;
+	}
+
+	if(_array_slice.set == nullptr)
+		return nullptr;
+
+	return &_array_slice;
+}
+
+std::uint64_t standard_material::get_shading_hash() const
+{
+	auto fold = [](std::uint64_t& seed, std::uint64_t value) {
+		seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+	};
+	auto fold_float = [&fold](std::uint64_t& seed, float value) {
+		std::uint32_t bits = 0;
+		std::memcpy(&bits, &value, sizeof(bits));
+		fold(seed, bits);
+	};
+
+	std::uint64_t hash = 0;
+	for(int i = 0; i < 4; ++i)
+	{
+		fold_float(hash, _base_color.value[i]);
+		fold_float(hash, _subsurface_color.value[i]);
+		fold_float(hash, _emissive_color.value[i]);
+		fold_float(hash, _surface_data[i]);
+	}
+	fold_float(hash, _tiling.x);
+	fold_float(hash, _tiling.y);
+	fold_float(hash, _dither_threshold.x);
+	fold_float(hash, _dither_threshold.y);
+	fold(hash, std::uint64_t(get_cull_type()));
+	fold(hash, std::uint64_t(is_transparent()));
+	return hash;
+}
+
+material_instance::material_instance() = default;
+
+material_instance::~material_instance() = default;
+
+void material_instance::set_base_material(asset_handle<material> base)
+{
+	if(base.get() == this)
+	{
+		return;
+	}
+
+	_base = base;
+	if(auto* mat = _base.get())
+	{
+		_cull_type = mat->get_cull_type();
+		_transparent = mat->is_transparent();
+	}
+	_dirty = true;
+}
+
+gpu_program* material_instance::get_program() const
+{
+	auto* base = _base.get();
+	if(base == nullptr || base == this)
+		return nullptr;
+
+	// Pass the submission mode through so the probe answers for the path
+	// the caller is about to use.
+	base->skinned = skinned;
+	base->instanced = instanced;
+	base->instanced_array = instanced_array;
+	return base->get_program();
+}
+
+void material_instance::submit()
+{
+	auto* base = _base.get();
+	if(base == nullptr || base == this)
+		return;
+
+	// The render state routing (transparency pass, cull bits) reads the
+	// instance, so keep following the base when it gets edited live.
+	_cull_type = base->get_cull_type();
+	_transparent = base->is_transparent();
+
+	base->skinned = skinned;
+	base->instanced = instanced;
+	base->instanced_array = instanced_array;
+	base->submit();
+
+	if(_overrides == 0 && _maps.empty())
+		return;
+
+	const auto& uids = get_standard_uniform_ids();
+
+	// Only the overridden slots are re-uploaded on top of the base's
+	// values. The surface floats pack into one vec4, so any of them being
+	// overridden re-sends the whole slot composed through the read-through
+	// getters.
+	if(has_override(override_base_color))
+		gfx::set_registered_uniform(uids.base_color, &_base_color);
+	if(has_override(override_subsurface_color))
+		gfx::set_registered_uniform(uids.subsurface_color, &_subsurface_color);
+	if(has_override(override_emissive_color))
+		gfx::set_registered_uniform(uids.emissive_color, &_emissive_color);
+	if((_overrides & (override_roughness | override_metalness | override_bumpiness |
+					  override_alpha_test_value)) != 0)
+	{
+		const math::vec4 surface_data{get_roughness(), get_metalness(), get_bumpiness(),
+									  get_alpha_test_value()};
+		gfx::set_registered_uniform(uids.surface_data, &surface_data);
+	}
+	if(has_override(override_tiling))
+		gfx::set_registered_uniform(uids.tiling, &_tiling);
+	if(has_override(override_dither_threshold))
+		gfx::set_registered_uniform(uids.dither_threshold, &_dither_threshold);
+
+	// On the array-instanced path the samplers are the shared layered
+	// arrays - per-material map overrides cannot apply there (and
+	// get_texture_array_slice already refuses the path when any exist).
+	if(!instanced_array && !_maps.empty())
+	{
+		if(core::has_subsystems<runtime::texture_residency>())
+		{
+			auto& residency = core::get_subsystem<runtime::texture_residency>();
+			for(const auto& pair : _maps)
+			{
+				residency.touch(pair.second);
+			}
+		}
+
+		auto overridden = [this](const char* id) -> gfx::texture* {
+			auto it = _maps.find(id);
+			return it != _maps.end() ? it->second.get() : nullptr;
+		};
+
+		// set_registered_texture skips null, so non-overridden stages keep
+		// the base's binding.
+		set_registered_texture(0, uids.tex_color, overridden("color"));
+		set_registered_texture(1, uids.tex_normal, overridden("normal"));
+		set_registered_texture(2, uids.tex_roughness, overridden("roughness"));
+		set_registered_texture(3, uids.tex_metalness, overridden("metalness"));
+		set_registered_texture(4, uids.tex_ao, overridden("ao"));
+	}
+
+	// The uniform stream now holds the instance's values. Claim the
+	// retained-uniform skip slot so a clean base submitted right after
+	// does not skip its upload and inherit the overrides.
+	s_last_material = this;
+	s_last_program = base->get_program();
+	s_last_frame = gfx::get_render_frame();
+	_dirty = false;
+}
+
+const runtime::texture_array_pool::slice* material_instance::get_texture_array_slice()
+{
+	auto* base = _base.get();
+	// Overridden maps cannot ride the base's array slice.
+	if(base == nullptr || base == this || !_maps.empty())
+		return nullptr;
+
+	return base->get_texture_array_slice();
+}
+
+std::uint64_t material_instance::get_shading_hash() const
+{
+	auto* base = _base.get();
+	if(base == nullptr || base == this)
+		return material::get_shading_hash();
+
+	// An instance without overrides shades exactly like its base, so it
+	// hashes like it too and the two merge into one batch.
+	if(_overrides == 0)
+		return base->get_shading_hash();
+
+	auto fold = [](std::uint64_t& seed, std::uint64_t value) {
+		seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+	};
+	auto fold_float = [&fold](std::uint64_t& seed, float value) {
+		std::uint32_t bits = 0;
+		std::memcpy(&bits, &value, sizeof(bits));
+		fold(seed, bits);
+	};
+
+	std::uint64_t hash = base->get_shading_hash();
+	fold(hash, _overrides);
+	for(int i = 0; i < 4; ++i)
+	{
+		fold_float(hash, get_base_color().value[i]);
+		fold_float(hash, get_subsurface_color().value[i]);
+		fold_float(hash, get_emissive_color().value[i]);
+	}
+	fold_float(hash, get_roughness());
+	fold_float(hash, get_metalness());
+	fold_float(hash, get_bumpiness());
+	fold_float(hash, get_alpha_test_value());
+	fold_float(hash, get_tiling().x);
+	fold_float(hash, get_tiling().y);
+	fold_float(hash, get_dither_threshold().x);
+	fold_float(hash, get_dither_threshold().y);
+	return hash;
+}
+
+asset_handle<gfx::texture> material_instance::get_map(const std::string& id) const
+{
+	auto it = _maps.find(id);
+	if(it != _maps.end())
+		return it->second;
+
+	if(auto* base = get_base_standard())
+	{
+		const auto& maps = base->get_maps();
+		auto base_it = maps.find(id);
+		if(base_it != maps.end())
+			return base_it->second;
+	}
+
+	return {};
+}
+
+void material_instance::set_map(const std::string& id, asset_handle<gfx::texture> val)
+{
+	if(val)
+	{
+		_maps[id] = val;
+	}
+	else
+	{
+		_maps.erase(id);
+	}
+	_dirty = true;
 }
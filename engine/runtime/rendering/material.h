@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../assets/asset_handle.h"
+#include "texture_array_pool.h"
 #include "core/graphics/graphics.h"
 #include "core/math/math_includes.h"
 #include "core/reflection/registration.h"
@@ -95,14 +96,13 @@ public:
 	void set_uniform(const std::string& _name, const void* _value, std::uint16_t _num = 1);
 
 	//-----------------------------------------------------------------------------
-	//  Name : get_program ()
+	//  Name : get_program (virtual )
 	/// <summary>
-	///
-	///
-	///
+	/// Program for the current submission mode. Virtual so instance
+	/// materials can answer with their base material's programs.
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	gpu_program* get_program() const;
+	virtual gpu_program* get_program() const;
 
 	//-----------------------------------------------------------------------------
 	//  Name : submit (virtual )
@@ -116,6 +116,34 @@ public:
 	{
 	}
 
+	//-----------------------------------------------------------------------------
+	//  Name : get_texture_array_slice (virtual )
+	/// <summary>
+	/// This material's slice within the shared texture arrays, resolved
+	/// lazily through the texture_array_pool; null for material types
+	/// without array support. Draws whose materials share the same array
+	/// set can merge and carry the layer per instance.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	virtual const runtime::texture_array_pool::slice* get_texture_array_slice()
+	{
+		return nullptr;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_shading_hash (virtual )
+	/// <summary>
+	/// Hash over everything except the texture maps that must match for
+	/// two materials to shade identically. The base fallback is the
+	/// material's identity, so unaware types only ever merge with
+	/// themselves.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	virtual std::uint64_t get_shading_hash() const
+	{
+		return std::uint64_t(std::hash<const void*>()(this));
+	}
+
 	//-----------------------------------------------------------------------------
 	//  Name : get_cull_type ()
 	/// <summary>
@@ -142,6 +170,31 @@ public:
 		_cull_type = val;
 	}
 
+	//-----------------------------------------------------------------------------
+	//  Name : is_transparent ()
+	/// <summary>
+	/// Transparent materials are skipped by the g-buffer fill and drawn
+	/// back-to-front by the dedicated transparency pass instead.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline bool is_transparent() const
+	{
+		return _transparent;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_transparent ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline void set_transparent(bool transparent)
+	{
+		_transparent = transparent;
+	}
+
 	//-----------------------------------------------------------------------------
 	//  Name : get_render_states ()
 	/// <summary>
@@ -154,14 +207,27 @@ public:
 									bool depth_test = true) const;
 
 	bool skinned = false;
+	bool instanced = false;
+	/// instanced with the texture-array geometry programs; the per
+	/// instance data carries the material set's array layer
+	bool instanced_array = false;
 
 protected:
+	/// set by property setters; a clean material re-submitted right after
+	/// itself skips its uniform upload (values are retained between submits)
+	bool _dirty = true;
 	/// Program that is responsible for rendering.
 	std::unique_ptr<gpu_program> _program;
 	/// Program that is responsible for rendering.
 	std::unique_ptr<gpu_program> _program_skinned;
+	/// Program that is responsible for rendering.
+	std::unique_ptr<gpu_program> _program_instanced;
+	/// Program that is responsible for rendering.
+	std::unique_ptr<gpu_program> _program_instanced_array;
 	/// Cull type for this material.
 	cull_type _cull_type = cull_type::counter_clockwise;
+	/// Whether the material renders through the sorted transparency pass.
+	bool _transparent = false;
 	/// Default color texture
 	asset_handle<gfx::texture> _default_color_map;
 	/// Default normal texture
@@ -210,6 +276,7 @@ public:
 	inline void set_base_color(const math::color& val)
 	{
 		_base_color = val;
+		_dirty = true;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -236,6 +303,7 @@ public:
 	inline void set_subsurface_color(const math::color& val)
 	{
 		_subsurface_color = val;
+		_dirty = true;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -262,6 +330,7 @@ public:
 	inline void set_emissive_color(const math::color& val)
 	{
 		_emissive_color = val;
+		_dirty = true;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -288,6 +357,7 @@ public:
 	inline void set_roughness(float rougness)
 	{
 		_surface_data.x = rougness;
+		_dirty = true;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -314,6 +384,7 @@ public:
 	inline void set_metalness(float metalness)
 	{
 		_surface_data.y = metalness;
+		_dirty = true;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -340,6 +411,7 @@ public:
 	inline void set_bumpiness(float bumpiness)
 	{
 		_surface_data.z = bumpiness;
+		_dirty = true;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -366,6 +438,7 @@ public:
 	inline void set_alpha_test_value(float alphaTestValue)
 	{
 		_surface_data.w = alphaTestValue;
+		_dirty = true;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -392,6 +465,7 @@ public:
 	inline void set_tiling(const math::vec2& tiling)
 	{
 		_tiling = tiling;
+		_dirty = true;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -418,6 +492,7 @@ public:
 	inline void set_dither_threshold(const math::vec2& threshold)
 	{
 		_dither_threshold = threshold;
+		_dirty = true;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -550,6 +625,17 @@ public:
 		_maps["ao"] = val;
 	}
 
+	//-----------------------------------------------------------------------------
+	//  Name : get_maps ()
+	/// <summary>
+	/// All assigned texture maps keyed by slot id.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline const std::unordered_map<std::string, asset_handle<gfx::texture>>& get_maps() const
+	{
+		return _maps;
+	}
+
 	//-----------------------------------------------------------------------------
 	//  Name : submit (virtual )
 	/// <summary>
@@ -560,7 +646,30 @@ public:
 	//-----------------------------------------------------------------------------
 	virtual void submit();
 
+	//-----------------------------------------------------------------------------
+	//  Name : get_texture_array_slice (virtual )
+	/// <summary>
+	/// Resolves (and caches) this material's map set within the shared
+	/// texture arrays. Re-resolves when a map streamed in or was swapped;
+	/// returns null until the pool subsystem exists and a slice with a
+	/// matching layout is available.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	virtual const runtime::texture_array_pool::slice* get_texture_array_slice();
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_shading_hash (virtual )
+	/// <summary>
+	/// Hash of the uniform block and render state; textures excluded.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	virtual std::uint64_t get_shading_hash() const;
+
 private:
+	/// cached array slice and the source maps it was resolved for
+	runtime::texture_array_pool::slice _array_slice;
+	std::array<const gfx::texture*, runtime::texture_array_set::map_count> _array_sources{};
+
 	/// Base color
 	math::color _base_color{
 		1.0f, 1.0f, 1.0f, /// Color
@@ -596,3 +705,619 @@ private:
 	/// Texture maps
 	std::unordered_map<std::string, asset_handle<gfx::texture>> _maps;
 };
+
+class material_instance : public material
+{
+public:
+	SERIALIZABLE(material_instance)
+	REFLECTABLEV(material_instance, material)
+
+	/// Parameters the instance carries its own value for. Everything left
+	/// unset reads through to the base material, so an instance stays one
+	/// tint (or one map) of state instead of a full material clone.
+	enum override_bit : std::uint32_t
+	{
+		override_base_color = 1u << 0,
+		override_subsurface_color = 1u << 1,
+		override_emissive_color = 1u << 2,
+		override_roughness = 1u << 3,
+		override_metalness = 1u << 4,
+		override_bumpiness = 1u << 5,
+		override_alpha_test_value = 1u << 6,
+		override_tiling = 1u << 7,
+		override_dither_threshold = 1u << 8,
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : material_instance ()
+	/// <summary>
+	/// Unlike standard_material this creates no programs of its own - the
+	/// base material carries them, which is the point of instancing.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	material_instance();
+	~material_instance();
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_base_material ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline asset_handle<material> get_base_material() const
+	{
+		return _base;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_base_material ()
+	/// <summary>
+	/// Rebinds the instance to a base material and adopts its render state
+	/// (cull mode, transparency) for everything not overridden here.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_base_material(asset_handle<material> base);
+
+	//-----------------------------------------------------------------------------
+	//  Name : has_override ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline bool has_override(override_bit bit) const
+	{
+		return (_overrides & bit) != 0;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : clear_overrides ()
+	/// <summary>
+	/// Drops every override so the instance renders exactly as its base.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline void clear_overrides()
+	{
+		_overrides = 0;
+		_maps.clear();
+		_dirty = true;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_base_color ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline const math::color& get_base_color() const
+	{
+		if(!has_override(override_base_color))
+		{
+			if(auto* base = get_base_standard())
+				return base->get_base_color();
+		}
+		return _base_color;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_base_color ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline void set_base_color(const math::color& val)
+	{
+		_base_color = val;
+		_overrides |= override_base_color;
+		_dirty = true;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_subsurface_color ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline const math::color& get_subsurface_color() const
+	{
+		if(!has_override(override_subsurface_color))
+		{
+			if(auto* base = get_base_standard())
+				return base->get_subsurface_color();
+		}
+		return _subsurface_color;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_subsurface_color ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline void set_subsurface_color(const math::color& val)
+	{
+		_subsurface_color = val;
+		_overrides |= override_subsurface_color;
+		_dirty = true;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_emissive_color ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline const math::color& get_emissive_color() const
+	{
+		if(!has_override(override_emissive_color))
+		{
+			if(auto* base = get_base_standard())
+				return base->get_emissive_color();
+		}
+		return _emissive_color;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_emissive_color ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline void set_emissive_color(const math::color& val)
+	{
+		_emissive_color = val;
+		_overrides |= override_emissive_color;
+		_dirty = true;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_roughness ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline float get_roughness() const
+	{
+		if(!has_override(override_roughness))
+		{
+			if(auto* base = get_base_standard())
+				return base->get_roughness();
+		}
+		return _surface_data.x;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_roughness ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline void set_roughness(float roughness)
+	{
+		_surface_data.x = roughness;
+		_overrides |= override_roughness;
+		_dirty = true;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_metalness ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline float get_metalness() const
+	{
+		if(!has_override(override_metalness))
+		{
+			if(auto* base = get_base_standard())
+				return base->get_metalness();
+		}
+		return _surface_data.y;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_metalness ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline void set_metalness(float metalness)
+	{
+		_surface_data.y = metalness;
+		_overrides |= override_metalness;
+		_dirty = true;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_bumpiness ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline float get_bumpiness() const
+	{
+		if(!has_override(override_bumpiness))
+		{
+			if(auto* base = get_base_standard())
+				return base->get_bumpiness();
+		}
+		return _surface_data.z;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_bumpiness ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline void set_bumpiness(float bumpiness)
+	{
+		_surface_data.z = bumpiness;
+		_overrides |= override_bumpiness;
+		_dirty = true;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_alpha_test_value ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline float get_alpha_test_value() const
+	{
+		if(!has_override(override_alpha_test_value))
+		{
+			if(auto* base = get_base_standard())
+				return base->get_alpha_test_value();
+		}
+		return _surface_data.w;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_alpha_test_value ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline void set_alpha_test_value(float alpha_test_value)
+	{
+		_surface_data.w = alpha_test_value;
+		_overrides |= override_alpha_test_value;
+		_dirty = true;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_tiling ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline const math::vec2& get_tiling() const
+	{
+		if(!has_override(override_tiling))
+		{
+			if(auto* base = get_base_standard())
+				return base->get_tiling();
+		}
+		return _tiling;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_tiling ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline void set_tiling(const math::vec2& tiling)
+	{
+		_tiling = tiling;
+		_overrides |= override_tiling;
+		_dirty = true;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_dither_threshold ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline const math::vec2& get_dither_threshold() const
+	{
+		if(!has_override(override_dither_threshold))
+		{
+			if(auto* base = get_base_standard())
+				return base->get_dither_threshold();
+		}
+		return _dither_threshold;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_dither_threshold ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline void set_dither_threshold(const math::vec2& threshold)
+	{
+		_dither_threshold = threshold;
+		_overrides |= override_dither_threshold;
+		_dirty = true;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_color_map ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline asset_handle<gfx::texture> get_color_map() const
+	{
+		return get_map("color");
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_color_map ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline void set_color_map(asset_handle<gfx::texture> val)
+	{
+		set_map("color", val);
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_normal_map ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline asset_handle<gfx::texture> get_normal_map() const
+	{
+		return get_map("normal");
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_normal_map ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline void set_normal_map(asset_handle<gfx::texture> val)
+	{
+		set_map("normal", val);
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_roughness_map ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline asset_handle<gfx::texture> get_roughness_map() const
+	{
+		return get_map("roughness");
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_roughness_map ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline void set_roughness_map(asset_handle<gfx::texture> val)
+	{
+		set_map("roughness", val);
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_metalness_map ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline asset_handle<gfx::texture> get_metalness_map() const
+	{
+		return get_map("metalness");
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_metalness_map ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline void set_metalness_map(asset_handle<gfx::texture> val)
+	{
+		set_map("metalness", val);
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_ao_map ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline asset_handle<gfx::texture> get_ao_map() const
+	{
+		return get_map("ao");
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_ao_map ()
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline void set_ao_map(asset_handle<gfx::texture> val)
+	{
+		set_map("ao", val);
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_program (virtual )
+	/// <summary>
+	/// The base material's program for the current submission mode; the
+	/// instance never owns programs.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	virtual gpu_program* get_program() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : submit (virtual )
+	/// <summary>
+	/// Submits the base material, then applies the sparse override block
+	/// on top of it.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	virtual void submit();
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_texture_array_slice (virtual )
+	/// <summary>
+	/// The base material's slice while no map is overridden - instances
+	/// sharing a base then merge into the same array-instanced batches.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	virtual const runtime::texture_array_pool::slice* get_texture_array_slice();
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_shading_hash (virtual )
+	/// <summary>
+	/// The base material's hash while nothing is overridden, folded with
+	/// the override block otherwise.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	virtual std::uint64_t get_shading_hash() const;
+
+private:
+	//-----------------------------------------------------------------------------
+	//  Name : get_base_standard () (Private)
+	/// <summary>
+	/// The base as a standard_material when it is one; the parameter
+	/// read-through has nothing to read from other base types.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline standard_material* get_base_standard() const
+	{
+		return dynamic_cast<standard_material*>(_base.get());
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_map () (Private)
+	/// <summary>
+	///
+	///
+	///
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	asset_handle<gfx::texture> get_map(const std::string& id) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_map () (Private)
+	/// <summary>
+	/// An empty handle drops the override instead of storing it, reverting
+	/// the slot to the base material's map.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_map(const std::string& id, asset_handle<gfx::texture> val);
+
+	/// Base material carrying the programs and every non-overridden value.
+	asset_handle<material> _base;
+	/// Which of the parameter slots below are live - override_bit flags.
+	std::uint32_t _overrides = 0;
+
+	/// Base color
+	math::color _base_color{
+		1.0f, 1.0f, 1.0f, /// Color
+		1.0f			  /// Opacity
+	};
+	/// Subsurface color
+	math::color _subsurface_color{
+		0.0f, 0.0f, 0.0f, /// Color
+		0.8f			  /// Opacity
+	};
+	/// Emissive color
+	math::color _emissive_color{
+		0.0f, 0.0f, 0.0f, /// Color
+		0.0f			  /// HDR Scale
+	};
+	/// Surface data
+	math::vec4 _surface_data{
+		0.3f, /// Roughness
+		0.0f, /// Metalness
+		1.0f, /// Bumpiness
+		0.25f /// AlphaTestValue
+	};
+	/// Tiling data
+	math::vec2 _tiling{
+		1.0f, 1.0f /// Primary
+	};
+	/// Dithering data
+	math::vec2 _dither_threshold{
+		0.5f, /// Alpha threshold
+		0.0f  /// Distance threshold
+	};
+
+	/// Overridden texture maps only; slots absent here use the base's.
+	std::unordered_map<std::string, asset_handle<gfx::texture>> _maps;
+};
@@ -1,13 +1,21 @@
 #include "mesh.h"
+#include "core/memory/memory_tracker.h"
 #include "camera.h"
 #include "core/graphics/index_buffer.h"
+#include "core/graphics/transient_buffer_allocator.h"
 #include "core/graphics/vertex_buffer.h"
 #include "core/logging/logging.h"
 #include "core/memory/checked_delete.h"
+#include "core/system/subsystem.h"
+#include "core/tasks/task_system.h"
 #include "mesh_tools.h"
 #include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <functional>
+#include <limits>
+#include <ostream>
+#include <unordered_map>
 
 #define RMC_DEFINE_DATA                                                                                      \
 	std::vector<math::vec3> vertices;                                                                        \
@@ -37,6 +45,41 @@ const float ValenceBoostPower = 0.5f;
 const std::int32_t MaxVertexCacheSize = 32;
 };
 
+// On disk layout of the runtime mesh container produced by
+// mesh::save_prepared. The vertex and index blobs are stored aligned and
+// in their final, subset-sorted order so the runtime can alias them
+// straight out of a memory mapped file.
+namespace MeshContainer
+{
+struct header
+{
+	std::uint32_t magic = 0;
+	std::uint32_t version = 0;
+	std::uint32_t vertex_count = 0;
+	std::uint32_t face_count = 0;
+	std::uint32_t subset_count = 0;
+	std::uint32_t vertex_stride = 0;
+	float bbox_min[3] = {0.0f, 0.0f, 0.0f};
+	float bbox_max[3] = {0.0f, 0.0f, 0.0f};
+	std::uint32_t vertex_data_offset = 0;
+	std::uint32_t index_data_offset = 0;
+};
+// On disk subset record. Pinned separately from mesh::subset so the
+// runtime struct can grow transient fields (pool offsets etc.) without
+// changing the container format.
+struct disk_subset
+{
+	std::uint32_t data_group_id = 0;
+	std::int32_t vertex_start = -1;
+	std::uint32_t vertex_count = 0;
+	std::int32_t face_start = -1;
+	std::uint32_t face_count = 0;
+};
+const std::uint32_t Magic = 0x4853454D; // 'MESH'
+const std::uint32_t Version = 1;
+const std::uint32_t VertexDataAlignment = 16;
+};
+
 mesh::mesh()
 	: _hardware_vb(std::make_shared<gfx::vertex_buffer>())
 	, _hardware_ib(std::make_shared<gfx::index_buffer>())
@@ -77,13 +120,34 @@ void mesh::dispose()
 	_preparation_data.vertex_records.clear();
 	_preparation_data.triangle_data.clear();
 
-	// Release mesh data memory
-	checked_array_delete(_system_vb);
-	checked_array_delete(_system_ib);
+	// Release mesh data memory. When the buffers alias a memory mapped
+	// container, the backing mapping owns the storage instead.
+	if(_backing == nullptr)
+	{
+		checked_array_delete(_system_vb);
+		checked_array_delete(_system_ib);
+		if(_tracked_vb_size != 0)
+			memory::memory_tracker::get().record_free("assets/mesh", _tracked_vb_size);
+		if(_tracked_ib_size != 0)
+			memory::memory_tracker::get().record_free("assets/mesh", _tracked_ib_size);
+	}
+	_tracked_vb_size = 0;
+	_tracked_ib_size = 0;
+	_backing.reset();
+	_system_vb = nullptr;
+	_system_ib = nullptr;
 
 	_triangle_data.clear();
+	_clusters.clear();
+	_cluster_ranges.clear();
+	_bvh_nodes.clear();
+	_bvh_tris.clear();
 
 	// Release resources
+	gfx::get_static_buffer_pool().release(_pool_vb);
+	gfx::get_static_buffer_pool().release(_pool_ib);
+	_pool_vb = {};
+	_pool_ib = {};
 	_hardware_vb.reset();
 	_hardware_ib.reset();
 
@@ -189,6 +253,45 @@ bool mesh::bind_skin(const skin_bind_data& bind_data)
 
 	} // Next Face
 
+	// Cluster the combinations before attempting to pack them into palettes.
+	// On dense rigs a face's influence set is very often a strict subset of a
+	// neighbouring face's set (a forearm face is driven by a subset of the
+	// bones driving the adjacent hand faces), so fold those combinations
+	// straight into the larger one. This keeps faces with strong shared-bone
+	// affinity together when palettes are carved out below, and shrinks the
+	// search space for the packing loop.
+	auto bone_key_less = [](const bone_palette::bone_index_map_t::value_type& a,
+							const bone_palette::bone_index_map_t::value_type& b) {
+		return a.first < b.first;
+	};
+	for(auto it_outer = bone_combinations.begin(); it_outer != bone_combinations.end(); ++it_outer)
+	{
+		const auto& outer_bones = it_outer->first.influences->bones;
+		for(auto it_inner = bone_combinations.begin(); it_inner != bone_combinations.end();)
+		{
+			const auto& inner_bones = it_inner->first.influences->bones;
+			if(it_inner == it_outer || it_inner->first.data_group_id != it_outer->first.data_group_id ||
+			   inner_bones.size() > outer_bones.size() ||
+			   !std::includes(outer_bones.begin(), outer_bones.end(), inner_bones.begin(),
+							  inner_bones.end(), bone_key_less))
+			{
+				++it_inner;
+				continue;
+
+			} // End if not a subset
+
+			// Merge the subset's face list into the enclosing combination.
+			face_influences* influences_ptr = it_inner->first.influences;
+			std::vector<std::uint32_t>* face_list_ptr = it_inner->second;
+			it_outer->second->insert(it_outer->second->end(), face_list_ptr->begin(), face_list_ptr->end());
+			it_inner = bone_combinations.erase(it_inner);
+			checked_delete(influences_ptr);
+			checked_delete(face_list_ptr);
+
+		} // Next candidate subset
+
+	} // Next combination
+
 	// We now have a complete list of the unique combinations of bones that
 	// influence every face in the mesh. The next task is to combine these
 	// unique lists into as few combined bone "palettes" as possible, containing
@@ -206,7 +309,8 @@ bool mesh::bind_skin(const skin_bind_data& bind_data)
 			bone_combination_map_t::iterator it_combination;
 			bone_combination_map_t::iterator it_best_combination = bone_combinations.end();
 			bone_combination_map_t::iterator it_largest_combination = bone_combinations.end();
-			int max_common = -1, max_bones = -1;
+			std::int32_t max_score = std::numeric_limits<std::int32_t>::min();
+			int max_bones = -1;
 			int palette_id = -1;
 
 			// Search face influences for the next best combination to add to a palette.
@@ -256,10 +360,14 @@ bool mesh::bind_skin(const skin_bind_data& bind_data)
 					// idea to use this batch next (assuming it will fit at all).
 					if(additional_bones <= remaining_space)
 					{
-						// Does it have the most in common so far with this palette?
-						if(common_bones > max_common)
+						// Score the fit by shared-bone affinity; strongly favor
+						// combinations that overlap the palette and, among equal
+						// overlaps, the ones that consume the least free space.
+						std::int32_t score =
+							common_bones * static_cast<std::int32_t>(palette_size) - additional_bones;
+						if(score > max_score)
 						{
-							max_common = common_bones;
+							max_score = score;
 							it_best_combination = it_combination;
 							palette_id = static_cast<int>(i);
 
@@ -392,7 +500,7 @@ bool mesh::bind_skin(const skin_bind_data& bind_data)
 
 		new_format.end();
 		// Add to format database.
-		_vertex_format = new_format;
+		_vertex_format = gfx::get_canonical_layout(new_format);
 		// Vertex format was updated.
 
 	} // End if needs new format
@@ -482,6 +590,12 @@ bool mesh::bind_skin(const skin_bind_data& bind_data)
 
 	vertex_table.clear();
 
+	// Each palette beyond the subset count is an extra draw call and uniform
+	// upload per pass, so make the final partitioning visible in the log.
+	APPLOG_INFO("Packed {0} bone(s) into {1} palette(s) across {2} subset(s) ({3} vertices).",
+				_skin_bind_data.get_bones().size(), _bone_palettes.size(), _mesh_subsets.size(),
+				_preparation_data.vertex_count);
+
 	// Skin is now bound?
 	return true;
 }
@@ -523,6 +637,10 @@ bool mesh::prepare_mesh(const gfx::vertex_layout& format)
 		_triangle_data.clear();
 
 		// Release prior hardware buffers if they were constructed.
+		gfx::get_static_buffer_pool().release(_pool_vb);
+		gfx::get_static_buffer_pool().release(_pool_ib);
+		_pool_vb = {};
+		_pool_ib = {};
 		_hardware_vb.reset();
 		_hardware_ib.reset();
 
@@ -545,7 +663,14 @@ bool mesh::prepare_mesh(const gfx::vertex_layout& format)
 								_vertex_count);
 
 		// Clear out the vertex buffer
-		checked_array_delete(_system_vb);
+		if(_backing == nullptr)
+		{
+			checked_array_delete(_system_vb);
+			if(_tracked_vb_size != 0)
+				memory::memory_tracker::get().record_free("assets/mesh", _tracked_vb_size);
+		}
+		_tracked_vb_size = 0;
+		_system_vb = nullptr;
 		_vertex_count = 0;
 
 		// Iterate through each subset and extract triangle data.
@@ -565,7 +690,15 @@ bool mesh::prepare_mesh(const gfx::vertex_layout& format)
 		} // Next subset
 
 		// Release additional memory
-		checked_array_delete(_system_ib);
+		if(_backing == nullptr)
+		{
+			checked_array_delete(_system_ib);
+			if(_tracked_ib_size != 0)
+				memory::memory_tracker::get().record_free("assets/mesh", _tracked_ib_size);
+		}
+		_tracked_ib_size = 0;
+		_system_ib = nullptr;
+		_backing.reset();
 		_face_count = 0;
 
 		// Determine which components the original vertex data actually contained.
@@ -2940,6 +3073,8 @@ bool mesh::end_prepare(bool hardware_copy /* = true */, bool weld /* = true */,
 	// Allocate the system memory vertex buffer ready for population.
 	_vertex_count = _preparation_data.vertex_count;
 	_system_vb = new std::uint8_t[_vertex_count * _vertex_format.getStride()];
+	_tracked_vb_size = std::size_t(_vertex_count) * _vertex_format.getStride();
+	memory::memory_tracker::get().record_alloc("assets/mesh", _tracked_vb_size);
 
 	// Copy vertex data into the new buffer and dispose of the temporary data.
 	memcpy(_system_vb, &_preparation_data.vertex_data[0], _vertex_count * _vertex_format.getStride());
@@ -2950,6 +3085,8 @@ bool mesh::end_prepare(bool hardware_copy /* = true */, bool weld /* = true */,
 	// Allocate the memory for our system memory index buffer
 	_face_count = _preparation_data.triangle_count;
 	_system_ib = new std::uint32_t[_face_count * 3];
+	_tracked_ib_size = std::size_t(_face_count) * 3 * sizeof(std::uint32_t);
+	memory::memory_tracker::get().record_alloc("assets/mesh", _tracked_ib_size);
 
 	// math::transform triangle indices, material and data group information
 	// to the final triangle data arrays. We keep the latter two handy so
@@ -2988,10 +3125,90 @@ bool mesh::end_prepare(bool hardware_copy /* = true */, bool weld /* = true */,
 	_hardware_mesh = hardware_copy;
 	_optimize_mesh = optimize;
 
+	// Build the fine grained culling clusters over the final buffers.
+	generate_clusters();
+
 	// Success!
 	return true;
 }
 
+namespace
+{
+//-----------------------------------------------------------------------------
+//  Name : make_backed_ref () (Local)
+/// <summary>
+/// References buffer data that aliases a memory mapped container without
+/// copying it, handing the renderer a shared ownership stake in the
+/// mapping so it outlives any in-flight frames.
+/// </summary>
+//-----------------------------------------------------------------------------
+const gfx::memory_view* make_backed_ref(const void* data, std::uint32_t size,
+										const std::shared_ptr<void>& backing)
+{
+	auto keep_alive = new std::shared_ptr<void>(backing);
+	return gfx::make_ref(data, size,
+						 [](void* /*ptr*/, void* user_data) {
+							 delete static_cast<std::shared_ptr<void>*>(user_data);
+						 },
+						 keep_alive);
+}
+
+//-----------------------------------------------------------------------------
+//  Name : parallel_for_range () (Local)
+/// <summary>
+/// Splits [0, count) into contiguous chunks of roughly 'chunk_size'
+/// elements and invokes 'body(begin, end)' for each one, dispatching the
+/// tail chunks to worker threads when a task system is available. The
+/// first chunk runs on the calling thread while the workers chew the
+/// rest and the call returns once every chunk completed. The body must
+/// only write data owned by its own range.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename body_t>
+void parallel_for_range(std::uint32_t count, std::uint32_t chunk_size, const body_t& body)
+{
+	if(count == 0)
+		return;
+
+	// Below two chunks the dispatch overhead outweighs the work.
+	if(count < chunk_size * 2 || !core::has_subsystems<core::task_system>())
+	{
+		body(0u, count);
+		return;
+	}
+
+	auto& ts = core::get_subsystem<core::task_system>();
+	const std::uint32_t chunk_count = (count + chunk_size - 1) / chunk_size;
+	std::vector<core::task_future<void>> futures;
+	futures.reserve(chunk_count - 1);
+	for(std::uint32_t chunk = 1; chunk < chunk_count; ++chunk)
+	{
+		const std::uint32_t begin = chunk * chunk_size;
+		const std::uint32_t end = std::min(begin + chunk_size, count);
+		futures.emplace_back(ts.push_on_worker_thread([&body, begin, end]() { body(begin, end); }));
+	}
+	body(0u, std::min(chunk_size, count));
+	for(auto& fut : futures)
+	{
+		fut.wait();
+	}
+}
+}
+
+void mesh::update_subset_buffer_offsets()
+{
+	// Subset tables and pool allocations move independently (sorting
+	// rebuilds the former, buffer builds the latter), so the recorded
+	// offsets are refreshed from whichever changed last.
+	for(auto sub : _mesh_subsets)
+	{
+		sub->buffer_vertex_offset =
+			_pool_vb.base_vertex + static_cast<std::uint32_t>(std::max(0, sub->vertex_start));
+		sub->buffer_index_offset =
+			_pool_ib.base_index + static_cast<std::uint32_t>(std::max(0, sub->face_start)) * 3;
+	}
+}
+
 void mesh::build_vb(bool hardware_copy)
 {
 	// A video memory copy of the mesh was requested?
@@ -3000,8 +3217,19 @@ void mesh::build_vb(bool hardware_copy)
 		// Calculate the required size of the vertex buffer
 		std::uint32_t buffer_size = _vertex_count * _vertex_format.getStride();
 
-		const gfx::memory_view* mem = gfx::copy(_system_vb, static_cast<std::uint32_t>(buffer_size));
-		_hardware_vb = std::make_shared<gfx::vertex_buffer>(mem, _vertex_format);
+		const gfx::memory_view* mem =
+			_backing != nullptr ? make_backed_ref(_system_vb, buffer_size, _backing)
+								: gfx::copy(_system_vb, static_cast<std::uint32_t>(buffer_size));
+
+		// Static geometry suballocates from the shared per-layout pool so
+		// consecutive draws keep the same buffer bound; a dedicated buffer
+		// is only created when the pool cannot service the request.
+		gfx::get_static_buffer_pool().release(_pool_vb);
+		_pool_vb = gfx::get_static_buffer_pool().alloc_vertices(_vertex_format, mem, _vertex_count);
+		if(!_pool_vb.valid)
+			_hardware_vb = std::make_shared<gfx::vertex_buffer>(mem, _vertex_format);
+
+		update_subset_buffer_offsets();
 
 	} // End if video memory vertex buffer required
 }
@@ -3015,20 +3243,176 @@ void mesh::build_ib(bool hardware_copy)
 		std::uint32_t buffer_size = _face_count * 3 * sizeof(std::uint32_t);
 
 		// Allocate hardware buffer if required (i.e. it does not already exist).
-		if(!_hardware_ib)
+		if(!_pool_ib.valid && (!_hardware_ib || !_hardware_ib->is_valid()))
 		{
-			const gfx::memory_view* mem = gfx::copy(_system_ib, static_cast<std::uint32_t>(buffer_size));
-			_hardware_ib = std::make_shared<gfx::index_buffer>(mem, BGFX_BUFFER_INDEX32);
+			const gfx::memory_view* mem =
+				_backing != nullptr ? make_backed_ref(_system_ib, buffer_size, _backing)
+									: gfx::copy(_system_ib, static_cast<std::uint32_t>(buffer_size));
+
+			_pool_ib = gfx::get_static_buffer_pool().alloc_indices(mem, _face_count * 3);
+			if(!_pool_ib.valid)
+				_hardware_ib = std::make_shared<gfx::index_buffer>(mem, BGFX_BUFFER_INDEX32);
 		} // End if not allocated
-		else if(_hardware_ib && !_hardware_ib->is_valid())
-		{
-			const gfx::memory_view* mem = gfx::copy(_system_ib, static_cast<std::uint32_t>(buffer_size));
-			_hardware_ib = std::make_shared<gfx::index_buffer>(mem, BGFX_BUFFER_INDEX32);
-		}
+
+		update_subset_buffer_offsets();
 
 	} // End if hardware buffer required
 }
 
+bool mesh::save_prepared(std::ostream& stream) const
+{
+	// Only a fully prepared mesh has layout-final buffers worth persisting.
+	if(_prepare_status != mesh_status::prepared || _system_vb == nullptr || _system_ib == nullptr)
+		return false;
+
+	// Skinned meshes rebuild bone palettes when the skin is bound and still
+	// travel through the generic preparation path.
+	if(_skin_bind_data.has_bones())
+		return false;
+
+	const std::uint32_t subset_count = static_cast<std::uint32_t>(_mesh_subsets.size());
+	const std::uint32_t vertex_stride = _vertex_format.getStride();
+
+	MeshContainer::header header;
+	header.magic = MeshContainer::Magic;
+	header.version = MeshContainer::Version;
+	header.vertex_count = _vertex_count;
+	header.face_count = _face_count;
+	header.subset_count = subset_count;
+	header.vertex_stride = vertex_stride;
+	std::memcpy(header.bbox_min, &_bbox.min[0], sizeof(header.bbox_min));
+	std::memcpy(header.bbox_max, &_bbox.max[0], sizeof(header.bbox_max));
+
+	// Lay the sections out: header, vertex format, subset table, then the
+	// aligned bulk data blobs.
+	const std::uint32_t subsets_offset =
+		static_cast<std::uint32_t>(sizeof(MeshContainer::header) + sizeof(gfx::vertex_layout));
+	std::uint32_t vertex_data_offset =
+		subsets_offset + subset_count * sizeof(MeshContainer::disk_subset);
+	vertex_data_offset = (vertex_data_offset + (MeshContainer::VertexDataAlignment - 1)) &
+						 ~(MeshContainer::VertexDataAlignment - 1);
+	header.vertex_data_offset = vertex_data_offset;
+	// Keep the 32 bit indices naturally aligned whatever the vertex stride.
+	header.index_data_offset =
+		(vertex_data_offset + _vertex_count * vertex_stride + 3u) & ~3u;
+
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	stream.write(reinterpret_cast<const char*>(&_vertex_format), sizeof(gfx::vertex_layout));
+	for(const auto* sub : _mesh_subsets)
+	{
+		MeshContainer::disk_subset disk_sub;
+		disk_sub.data_group_id = sub->data_group_id;
+		disk_sub.vertex_start = sub->vertex_start;
+		disk_sub.vertex_count = sub->vertex_count;
+		disk_sub.face_start = sub->face_start;
+		disk_sub.face_count = sub->face_count;
+		stream.write(reinterpret_cast<const char*>(&disk_sub), sizeof(disk_sub));
+	}
+
+	const char padding[MeshContainer::VertexDataAlignment] = {0};
+	std::uint32_t written = subsets_offset + subset_count * sizeof(MeshContainer::disk_subset);
+	stream.write(padding, vertex_data_offset - written);
+
+	stream.write(reinterpret_cast<const char*>(_system_vb),
+				 static_cast<std::streamsize>(_vertex_count) * vertex_stride);
+	stream.write(padding,
+				 header.index_data_offset - (vertex_data_offset + _vertex_count * vertex_stride));
+	stream.write(reinterpret_cast<const char*>(_system_ib),
+				 static_cast<std::streamsize>(_face_count) * 3 * sizeof(std::uint32_t));
+
+	return !stream.fail();
+}
+
+bool mesh::is_prepared_format(const std::uint8_t* data, std::size_t size)
+{
+	std::uint32_t magic = 0;
+	if(data == nullptr || size < sizeof(magic))
+		return false;
+	std::memcpy(&magic, data, sizeof(magic));
+	return magic == MeshContainer::Magic;
+}
+
+bool mesh::bind_prepared(const std::shared_ptr<void>& backing, const std::uint8_t* data, std::size_t size)
+{
+	if(!is_prepared_format(data, size) || size < sizeof(MeshContainer::header))
+		return false;
+
+	MeshContainer::header header;
+	std::memcpy(&header, data, sizeof(header));
+	if(header.version != MeshContainer::Version)
+		return false;
+
+	// Validate that every section the header promises actually fits.
+	const std::uint64_t vertex_data_size =
+		static_cast<std::uint64_t>(header.vertex_count) * header.vertex_stride;
+	const std::uint64_t index_data_size =
+		static_cast<std::uint64_t>(header.face_count) * 3 * sizeof(std::uint32_t);
+	const std::uint64_t subsets_offset = sizeof(MeshContainer::header) + sizeof(gfx::vertex_layout);
+	if(header.index_data_offset % sizeof(std::uint32_t) != 0 ||
+	   subsets_offset +
+			   static_cast<std::uint64_t>(header.subset_count) * sizeof(MeshContainer::disk_subset) >
+		   header.vertex_data_offset ||
+	   header.vertex_data_offset + vertex_data_size > header.index_data_offset ||
+	   header.index_data_offset + index_data_size > size)
+		return false;
+
+	// Clear out anything which is currently loaded in the mesh.
+	dispose();
+
+	std::memcpy(&_vertex_format, data + sizeof(MeshContainer::header), sizeof(gfx::vertex_layout));
+	if(_vertex_format.getStride() != header.vertex_stride)
+	{
+		_vertex_format = {};
+		return false;
+	}
+
+	_vertex_count = header.vertex_count;
+	_face_count = header.face_count;
+	_bbox.min = math::vec3(header.bbox_min[0], header.bbox_min[1], header.bbox_min[2]);
+	_bbox.max = math::vec3(header.bbox_max[0], header.bbox_max[1], header.bbox_max[2]);
+
+	// Rebuild the subset tables. The table entries are tiny so these are
+	// copied out of the mapping; the bulk vertex/index data is aliased.
+	const std::uint8_t* subsets_ptr = data + subsets_offset;
+	_triangle_data.resize(_face_count);
+	for(std::uint32_t i = 0; i < header.subset_count; ++i)
+	{
+		MeshContainer::disk_subset disk_sub;
+		std::memcpy(&disk_sub, subsets_ptr + i * sizeof(disk_sub), sizeof(disk_sub));
+		subset* sub = new subset();
+		sub->data_group_id = disk_sub.data_group_id;
+		sub->vertex_start = disk_sub.vertex_start;
+		sub->vertex_count = disk_sub.vertex_count;
+		sub->face_start = disk_sub.face_start;
+		sub->face_count = disk_sub.face_count;
+		_mesh_subsets.push_back(sub);
+		_subset_lookup[mesh_subset_key(sub->data_group_id)] = sub;
+		_data_groups[sub->data_group_id].push_back(sub);
+
+		// Re-derive the per face data group records from the subset ranges.
+		const std::uint32_t face_start = static_cast<std::uint32_t>(sub->face_start);
+		for(std::uint32_t j = face_start; j < (face_start + sub->face_count); ++j)
+			_triangle_data[j].data_group_id = sub->data_group_id;
+
+	} // Next subset
+
+	// The system buffers alias the mapping directly - 'backing' keeps it
+	// alive for as long as they are referenced.
+	_system_vb = const_cast<std::uint8_t*>(data + header.vertex_data_offset);
+	_system_ib = reinterpret_cast<std::uint32_t*>(const_cast<std::uint8_t*>(data + header.index_data_offset));
+	_backing = backing;
+
+	_prepare_status = mesh_status::prepared;
+	_hardware_mesh = true;
+	_optimize_mesh = true;
+
+	// Cluster data is cheap to derive, so it is rebuilt here rather than
+	// stored in the container.
+	generate_clusters();
+
+	return true;
+}
+
 bool mesh::sort_mesh_data(bool optimize, bool hardware_copy, bool build_buffer)
 {
 	std::map<mesh_subset_key, std::uint32_t> subset_sizes;
@@ -3175,22 +3559,28 @@ bool mesh::sort_mesh_data(bool optimize, bool hardware_copy, bool build_buffer)
 		std::sort(it_data_group->second.begin(), it_data_group->second.end(), sort_predicate);
 
 	// Optimize the faces as we transfer to the final destination index buffer
-	// if requested. Otherwise, just copy them over directly.
+	// if requested. Otherwise, just copy them over directly. Work out each
+	// subset's source and destination ranges up front so the transfers can
+	// run concurrently below.
 	src_indices_ptr = dst_indices_ptr;
 	dst_indices_ptr = _system_ib;
 	counter = 0;
+	struct subset_transfer
+	{
+		subset* sub = nullptr;
+		/// face location within the temporary sorted buffer
+		std::uint32_t src_face_start = 0;
+		std::uint32_t* dst_ptr = nullptr;
+	};
+	std::vector<subset_transfer> transfers;
+	transfers.reserve(new_subsets.size());
 	for(auto subset : new_subsets)
 	{
-		// Note: Remember that at this stage, the subset's 'vertex_count' member
-		// still describes
-		// a 'max' vertex (not a count)... We're correcting this later.
-		if(optimize == true)
-			build_optimized_index_buffer(subset, src_indices_ptr + (subset->face_start * 3), dst_indices_ptr,
-										 static_cast<std::uint32_t>(subset->vertex_start),
-										 static_cast<std::uint32_t>(subset->vertex_count));
-		else
-			memcpy(dst_indices_ptr, src_indices_ptr + (subset->face_start * 3),
-				   static_cast<std::size_t>(subset->face_count) * 3 * sizeof(std::uint32_t));
+		subset_transfer transfer;
+		transfer.sub = subset;
+		transfer.src_face_start = static_cast<std::uint32_t>(subset->face_start);
+		transfer.dst_ptr = dst_indices_ptr;
+		transfers.push_back(transfer);
 
 		// This subset's starting face now refers to its location
 		// in the final destination buffer rather than the temporary one.
@@ -3202,6 +3592,49 @@ bool mesh::sort_mesh_data(bool optimize, bool hardware_copy, bool build_buffer)
 
 	} // Next subset
 
+	auto transfer_subset = [this, optimize, src_indices_ptr](const subset_transfer& transfer) {
+		// Note: Remember that at this stage, the subset's 'vertex_count' member
+		// still describes
+		// a 'max' vertex (not a count)... We're correcting this later.
+		if(optimize == true)
+			build_optimized_index_buffer(
+				transfer.sub, src_indices_ptr + (transfer.src_face_start * 3), transfer.dst_ptr,
+				static_cast<std::uint32_t>(transfer.sub->vertex_start),
+				static_cast<std::uint32_t>(transfer.sub->vertex_count));
+		else
+			memcpy(transfer.dst_ptr, src_indices_ptr + (transfer.src_face_start * 3),
+				   static_cast<std::size_t>(transfer.sub->face_count) * 3 * sizeof(std::uint32_t));
+	};
+
+	// The vertex cache optimizer walks each subset's faces independently and
+	// every transfer reads and writes disjoint ranges with its own scratch
+	// memory, so multi subset meshes can be optimized one subset per worker.
+	// Plain copies are memory bound and not worth the dispatch.
+	if(optimize && transfers.size() > 1 && core::has_subsystems<core::task_system>())
+	{
+		auto& ts = core::get_subsystem<core::task_system>();
+		std::vector<core::task_future<void>> futures;
+		futures.reserve(transfers.size() - 1);
+		for(std::size_t i = 1; i < transfers.size(); ++i)
+		{
+			futures.emplace_back(ts.push_on_worker_thread(
+				[&transfer_subset, &transfers, i]() { transfer_subset(transfers[i]); }));
+		}
+		// Optimize the first subset on this thread while workers chew the rest.
+		transfer_subset(transfers[0]);
+		for(auto& fut : futures)
+		{
+			fut.wait();
+		}
+	}
+	else
+	{
+		for(const auto& transfer : transfers)
+		{
+			transfer_subset(transfer);
+		}
+	}
+
 	// Clean up.
 	checked_array_delete(src_indices_ptr);
 
@@ -3241,6 +3674,7 @@ bool mesh::sort_mesh_data(bool optimize, bool hardware_copy, bool build_buffer)
 
 	// Use the new subset data.
 	_mesh_subsets = new_subsets;
+	update_subset_buffer_offsets();
 
 	// Success!
 	return true;
@@ -3571,6 +4005,182 @@ void mesh::bind_render_buffers_for_subset(std::uint32_t data_group_id)
 		bind_mesh_data(face_start, face_count, vertex_start, vertex_count);
 }
 
+void mesh::bind_render_buffers_for_range(std::uint32_t data_group_id, std::uint32_t face_start,
+										 std::uint32_t face_count)
+{
+	// Attempt to find a matching subset.
+	auto it = _subset_lookup.find(mesh_subset_key(data_group_id));
+	if(it == _subset_lookup.end())
+		return;
+
+	// The subset's full vertex window is used for every range; only the
+	// index window is narrowed to the requested run of faces.
+	subset* sub = it->second;
+	const std::uint32_t vertex_start = static_cast<std::uint32_t>(sub->vertex_start);
+	const std::uint32_t vertex_count = sub->vertex_count;
+
+	if(face_count > 0)
+		bind_mesh_data(face_start, face_count, vertex_start, vertex_count);
+}
+
+bool mesh::has_clusters() const
+{
+	return !_clusters.empty();
+}
+
+bool mesh::get_visible_cluster_ranges(std::uint32_t data_group_id, const math::frustum& frustum,
+									  const math::transform& world_transform, const math::vec3& eye,
+									  std::vector<std::pair<std::uint32_t, std::uint32_t>>& out_ranges) const
+{
+	auto it_range = _cluster_ranges.find(data_group_id);
+	if(it_range == _cluster_ranges.end())
+		return false;
+
+	const std::uint32_t first = it_range->second.first;
+	const std::uint32_t count = it_range->second.second;
+	if(count == 0)
+		return false;
+
+	// A single cluster covers the whole subset; skip the per cluster math
+	// and let the caller draw the full range.
+	if(count == 1)
+	{
+		const cluster& c = _clusters[first];
+		out_ranges.emplace_back(c.face_start, c.face_count);
+		return true;
+	}
+
+	// Move the frustum and the eye into object space once so each cluster
+	// test is a plain AABB / cone check.
+	const math::transform inv_world = math::inverse(world_transform);
+	math::frustum local_frustum = frustum;
+	local_frustum.mul(inv_world);
+	const math::vec3 local_eye = inv_world.transform_coord(eye);
+
+	bool any_visible = false;
+	for(std::uint32_t i = first; i < first + count; ++i)
+	{
+		const cluster& c = _clusters[i];
+
+		// Backface cone: the cluster can be dropped when every face points
+		// away from the eye. Conservative sphere-expanded test; a cutoff of
+		// one disables it (widely spread or degenerate normals).
+		bool visible = true;
+		if(c.cone_cutoff < 1.0f)
+		{
+			const math::vec3 center = c.bounds.get_center();
+			const float radius = math::length(c.bounds.get_extents());
+			const math::vec3 to_center = center - local_eye;
+			if(math::dot(to_center, c.cone_axis) >= c.cone_cutoff * math::length(to_center) + radius)
+				visible = false;
+		}
+
+		if(visible)
+			visible = local_frustum.test_aabb(c.bounds);
+
+		if(!visible)
+			continue;
+
+		any_visible = true;
+		// Merge runs of adjacent visible clusters into a single draw range.
+		if(!out_ranges.empty() &&
+		   out_ranges.back().first + out_ranges.back().second == c.face_start)
+		{
+			out_ranges.back().second += c.face_count;
+		}
+		else
+		{
+			out_ranges.emplace_back(c.face_start, c.face_count);
+		}
+	}
+
+	return any_visible;
+}
+
+void mesh::generate_clusters()
+{
+	_clusters.clear();
+	_cluster_ranges.clear();
+
+	if(_system_vb == nullptr || _system_ib == nullptr || _face_count == 0)
+		return;
+
+	// 128 triangles strikes a balance between culling granularity and the
+	// per cluster test / submission overhead.
+	const std::uint32_t max_cluster_faces = 128;
+
+	// Gather all referenced positions once; the per face loop below touches
+	// them repeatedly.
+	auto unpack_position = [this](std::uint32_t index) {
+		float unpacked[4];
+		gfx::vertex_unpack(unpacked, gfx::attribute::Position, _vertex_format, _system_vb, index);
+		return math::vec3(unpacked[0], unpacked[1], unpacked[2]);
+	};
+
+	std::vector<math::vec3> cluster_normals;
+	cluster_normals.reserve(max_cluster_faces);
+
+	for(const auto* sub : _mesh_subsets)
+	{
+		const std::uint32_t first_cluster = static_cast<std::uint32_t>(_clusters.size());
+		const std::uint32_t subset_face_start = static_cast<std::uint32_t>(sub->face_start);
+
+		for(std::uint32_t face = 0; face < sub->face_count; face += max_cluster_faces)
+		{
+			cluster c;
+			c.data_group_id = sub->data_group_id;
+			c.face_start = subset_face_start + face;
+			c.face_count = std::min(max_cluster_faces, sub->face_count - face);
+			c.bounds.reset();
+
+			// Accumulate bounds and face normals for the cone.
+			cluster_normals.clear();
+			math::vec3 axis(0.0f, 0.0f, 0.0f);
+			const std::uint32_t* indices_ptr = _system_ib + (c.face_start * 3);
+			for(std::uint32_t f = 0; f < c.face_count; ++f, indices_ptr += 3)
+			{
+				const math::vec3 v1 = unpack_position(indices_ptr[0]);
+				const math::vec3 v2 = unpack_position(indices_ptr[1]);
+				const math::vec3 v3 = unpack_position(indices_ptr[2]);
+				c.bounds.add_point(v1);
+				c.bounds.add_point(v2);
+				c.bounds.add_point(v3);
+
+				const math::vec3 face_normal = math::cross(v2 - v1, v3 - v1);
+				const float len = math::length(face_normal);
+				if(len > math::epsilon<float>())
+				{
+					cluster_normals.push_back(face_normal / len);
+					axis += cluster_normals.back();
+				}
+			}
+
+			// Derive the cone: the axis is the average normal and the cutoff
+			// follows from the widest deviation. When normals spread over
+			// more than a hemisphere the cone is useless and stays disabled.
+			const float axis_len = math::length(axis);
+			if(axis_len > math::epsilon<float>() && !cluster_normals.empty())
+			{
+				axis /= axis_len;
+				float min_dot = 1.0f;
+				for(const auto& normal : cluster_normals)
+					min_dot = math::min(min_dot, math::dot(axis, normal));
+
+				if(min_dot > 0.0f)
+				{
+					c.cone_axis = axis;
+					c.cone_cutoff = math::sqrt(1.0f - min_dot * min_dot);
+				}
+			}
+
+			_clusters.push_back(c);
+		}
+
+		_cluster_ranges[sub->data_group_id] = std::make_pair(
+			first_cluster, static_cast<std::uint32_t>(_clusters.size()) - first_cluster);
+	}
+}
+
 void mesh::bind_mesh_data(std::uint32_t face_start, std::uint32_t face_count, std::uint32_t vertex_start,
 						  std::uint32_t vertex_count)
 {
@@ -3580,28 +4190,40 @@ void mesh::bind_mesh_data(std::uint32_t face_start, std::uint32_t face_count, st
 	// Hardware or software rendering?
 	if(_hardware_mesh)
 	{
-		// Render using hardware streams
-		gfx::set_vertex_buffer(0, _hardware_vb->native_handle(), 0, vertex_count);
-		gfx::set_index_buffer(_hardware_ib->native_handle(), index_start, index_count);
+		// Render using hardware streams. Pool suballocations bind the
+		// shared block with this mesh's base offsets - index values stay
+		// mesh relative because the base vertex shifts the fetch.
+		if(_pool_vb.valid)
+			gfx::set_vertex_buffer(0, _pool_vb.handle, _pool_vb.base_vertex, vertex_count);
+		else
+			gfx::set_vertex_buffer(0, _hardware_vb->native_handle(), 0, vertex_count);
+
+		if(_pool_ib.valid)
+			gfx::set_index_buffer(_pool_ib.handle, _pool_ib.base_index + index_start, index_count);
+		else
+			gfx::set_index_buffer(_hardware_ib->native_handle(), index_start, index_count);
 
 	} // End if has hardware copy
 	else
 	{
 
-		if(vertex_count == gfx::get_avail_transient_vertex_buffer(vertex_count, _vertex_format))
+		// Software copies stream through the shared per-frame transient
+		// ring; failed slices are counted there rather than dropped
+		// silently with no trace.
+		auto& allocator = gfx::get_transient_buffer_allocator();
+
+		const auto vb = allocator.alloc_vertices(_vertex_format, vertex_count);
+		if(vb.valid)
 		{
-			gfx::transient_vertex_buffer vb;
-			gfx::alloc_transient_vertex_buffer(&vb, vertex_count, _vertex_format);
-			memcpy(vb.data, _system_vb, vb.size);
-			gfx::set_vertex_buffer(0, &vb, 0, vertex_count);
+			memcpy(vb.data(), _system_vb, std::size_t(vertex_count) * _vertex_format.getStride());
+			gfx::set_vertex_buffer(0, &vb.buffer, vb.start, vertex_count);
 		}
 
-		if(index_count == gfx::get_avail_transient_index_buffer(index_count))
+		const auto ib = allocator.alloc_indices(index_count);
+		if(ib.valid)
 		{
-			gfx::transient_index_buffer ib;
-			gfx::alloc_transient_index_buffer(&ib, index_count);
-			memcpy(ib.data, _system_ib, ib.size);
-			gfx::set_index_buffer(&ib, index_start, index_count);
+			memcpy(ib.data(), _system_ib, std::size_t(index_count) * sizeof(std::uint16_t));
+			gfx::set_index_buffer(&ib.buffer, ib.start + index_start, index_count);
 		}
 
 	} // End if software only copy
@@ -3688,7 +4310,7 @@ bool mesh::generate_vertex_normals(std::uint32_t* adjacency_ptr,
 								   std::vector<std::uint32_t>* remap_array_ptr /* = nullptr */)
 {
 	std::uint32_t start_tri, previous_tri, current_tri;
-	math::vec3 vec_edge1, vec_edge2, vec_normal;
+	math::vec3 vec_normal;
 	std::uint32_t i, j, k, index;
 
 	// Get access to useful data offset information.
@@ -3710,31 +4332,37 @@ bool mesh::generate_vertex_normals(std::uint32_t* adjacency_ptr,
 
 	} // End if supplied
 
-	// Pre-compute surface normals for each triangle
+	// Pre-compute surface normals for each triangle. Each face only reads
+	// shared data and writes its own slot, so the ranges run on worker
+	// threads.
 	std::uint8_t* src_vertices_ptr = &_preparation_data.vertex_data[0];
 	math::vec3* normals_ptr = new math::vec3[_preparation_data.triangle_count];
 	memset(normals_ptr, 0, _preparation_data.triangle_count * sizeof(math::vec3));
-	for(i = 0; i < _preparation_data.triangle_count; ++i)
-	{
-		// Retrieve positions of each referenced vertex.
-		const triangle& tri = _preparation_data.triangle_data[i];
-		const math::vec3* v1 = reinterpret_cast<const math::vec3*>(
-			src_vertices_ptr + (tri.indices[0] * vertex_stride) + position_offset);
-		const math::vec3* v2 = reinterpret_cast<const math::vec3*>(
-			src_vertices_ptr + (tri.indices[1] * vertex_stride) + position_offset);
-		const math::vec3* v3 = reinterpret_cast<const math::vec3*>(
-			src_vertices_ptr + (tri.indices[2] * vertex_stride) + position_offset);
-
-		// Compute the two edge vectors required for generating our normal
-		// We normalize here to prevent problems when the triangles are very small.
-		vec_edge1 = math::normalize(*v2 - *v1);
-		vec_edge2 = math::normalize(*v3 - *v1);
-
-		// Generate the normal
-		vec_normal = math::cross(vec_edge1, vec_edge2);
-		normals_ptr[i] = math::normalize(vec_normal);
-
-	} // Next Face
+	parallel_for_range(
+		_preparation_data.triangle_count, 16384,
+		[this, src_vertices_ptr, normals_ptr, position_offset,
+		 vertex_stride](std::uint32_t begin, std::uint32_t end) {
+			for(std::uint32_t f = begin; f < end; ++f)
+			{
+				// Retrieve positions of each referenced vertex.
+				const triangle& tri = _preparation_data.triangle_data[f];
+				const math::vec3* v1 = reinterpret_cast<const math::vec3*>(
+					src_vertices_ptr + (tri.indices[0] * vertex_stride) + position_offset);
+				const math::vec3* v2 = reinterpret_cast<const math::vec3*>(
+					src_vertices_ptr + (tri.indices[1] * vertex_stride) + position_offset);
+				const math::vec3* v3 = reinterpret_cast<const math::vec3*>(
+					src_vertices_ptr + (tri.indices[2] * vertex_stride) + position_offset);
+
+				// Compute the two edge vectors required for generating our normal
+				// We normalize here to prevent problems when the triangles are very
+				// small.
+				const math::vec3 edge1 = math::normalize(*v2 - *v1);
+				const math::vec3 edge2 = math::normalize(*v3 - *v1);
+
+				// Generate the normal
+				normals_ptr[f] = math::normalize(math::cross(edge1, edge2));
+			}
+		});
 
 	// Now compute the actual VERTEX normals using face adjacency information
 	for(i = 0; i < _preparation_data.triangle_count; ++i)
@@ -3954,7 +4582,6 @@ bool mesh::generate_vertex_tangents()
 {
 	math::vec3 *tangents = nullptr, *bitangents = nullptr;
 	std::uint32_t i, i1, i2, i3, num_faces, num_verts;
-	math::vec3 P, Q, T, B, cross_vec, normal_vec;
 
 	// Get access to useful data offset information.
 	std::uint16_t vertex_stride = _vertex_format.getStride();
@@ -3979,146 +4606,171 @@ bool mesh::generate_vertex_tangents()
 	memset(tangents, 0, sizeof(math::vec3) * num_verts);
 	memset(bitangents, 0, sizeof(math::vec3) * num_verts);
 
-	// Iterate through each triangle in the mesh
+	// Compute the raw tangent / bitangent contribution of every face. The
+	// attribute unpacking dominates this pass and each face writes only its
+	// own slots, so the ranges run on worker threads; the scatter into the
+	// shared per-vertex accumulators below stays serial.
 	std::uint8_t* src_vertices_ptr = &_preparation_data.vertex_data[0];
+	std::vector<math::vec3> face_tangents(num_faces, math::vec3(0.0f, 0.0f, 0.0f));
+	std::vector<math::vec3> face_bitangents(num_faces, math::vec3(0.0f, 0.0f, 0.0f));
+	parallel_for_range(
+		num_faces, 8192,
+		[this, src_vertices_ptr, &face_tangents, &face_bitangents](std::uint32_t begin, std::uint32_t end) {
+			for(std::uint32_t f = begin; f < end; ++f)
+			{
+				const triangle& tri = _preparation_data.triangle_data[f];
+
+				// Compute the three indices for the triangle
+				const std::uint32_t i1 = tri.indices[0];
+				const std::uint32_t i2 = tri.indices[1];
+				const std::uint32_t i3 = tri.indices[2];
+
+				// Retrieve references to the positions of the three vertices in the
+				// triangle.
+				math::vec3 E;
+				float fE[4];
+				gfx::vertex_unpack(fE, gfx::attribute::Position, _vertex_format, src_vertices_ptr, i1);
+				math::vec3 F;
+				float fF[4];
+				gfx::vertex_unpack(fF, gfx::attribute::Position, _vertex_format, src_vertices_ptr, i2);
+				math::vec3 G;
+				float fG[4];
+				gfx::vertex_unpack(fG, gfx::attribute::Position, _vertex_format, src_vertices_ptr, i3);
+				memcpy(&E[0], fE, 3 * sizeof(float));
+				memcpy(&F[0], fF, 3 * sizeof(float));
+				memcpy(&G[0], fG, 3 * sizeof(float));
+
+				// Retrieve references to the base texture coordinates of the three
+				// vertices in the triangle.
+				// TODO: Allow customization of which tex coordinates to generate from.
+				math::vec2 Et;
+				float fEt[4];
+				gfx::vertex_unpack(&fEt[0], gfx::attribute::TexCoord0, _vertex_format, src_vertices_ptr, i1);
+				math::vec2 Ft;
+				float fFt[4];
+				gfx::vertex_unpack(&fFt[0], gfx::attribute::TexCoord0, _vertex_format, src_vertices_ptr, i2);
+				math::vec2 Gt;
+				float fGt[4];
+				gfx::vertex_unpack(&fGt[0], gfx::attribute::TexCoord0, _vertex_format, src_vertices_ptr, i3);
+				memcpy(&Et[0], fEt, 2 * sizeof(float));
+				memcpy(&Ft[0], fFt, 2 * sizeof(float));
+				memcpy(&Gt[0], fGt, 2 * sizeof(float));
+
+				// Compute the known variables P & Q, where "P = F-E" and "Q = G-E"
+				// based on our original discussion of the tangent vector
+				// calculation.
+				const math::vec3 face_p = F - E;
+				const math::vec3 face_q = G - E;
+
+				// Also compute the know variables <s1,t1> and <s2,t2>. Recall that
+				// these are the texture coordinate deltas similarly for "F-E"
+				// and "G-E".
+				const float s1 = Ft.x - Et.x;
+				const float t1 = Ft.y - Et.y;
+				const float s2 = Gt.x - Et.x;
+				const float t2 = Gt.y - Et.y;
+
+				// Next we can pre-compute part of the equation we developed
+				// earlier: "1/(s1 * t2 - s2 * t1)". We do this in two separate
+				// stages here in order to ensure that the texture coordinates
+				// are not invalid.
+				float r = (s1 * t2 - s2 * t1);
+				if(math::abs(r) < math::epsilon<float>())
+					continue;
+				r = 1.0f / r;
+
+				// All that's left for us to do now is to run the matrix
+				// multiplication and multiply the result by the scalar portion
+				// we precomputed earlier.
+				math::vec3& face_t = face_tangents[f];
+				math::vec3& face_b = face_bitangents[f];
+				face_t.x = r * (t2 * face_p.x - t1 * face_q.x);
+				face_t.y = r * (t2 * face_p.y - t1 * face_q.y);
+				face_t.z = r * (t2 * face_p.z - t1 * face_q.z);
+				face_b.x = r * (s1 * face_q.x - s2 * face_p.x);
+				face_b.y = r * (s1 * face_q.y - s2 * face_p.y);
+				face_b.z = r * (s1 * face_q.z - s2 * face_p.z);
+			}
+		});
+
+	// Add the tangent and bitangent vectors (summed average) to
+	// any previous values computed for each vertex.
 	for(i = 0; i < num_faces; ++i)
 	{
-		triangle& tri = _preparation_data.triangle_data[i];
-
-		// Compute the three indices for the triangle
+		const triangle& tri = _preparation_data.triangle_data[i];
 		i1 = tri.indices[0];
 		i2 = tri.indices[1];
 		i3 = tri.indices[2];
-
-		// Retrieve references to the positions of the three vertices in the
-		// triangle.
-		math::vec3 E;
-		float fE[4];
-		gfx::vertex_unpack(fE, gfx::attribute::Position, _vertex_format, src_vertices_ptr, i1);
-		math::vec3 F;
-		float fF[4];
-		gfx::vertex_unpack(fF, gfx::attribute::Position, _vertex_format, src_vertices_ptr, i2);
-		math::vec3 G;
-		float fG[4];
-		gfx::vertex_unpack(fG, gfx::attribute::Position, _vertex_format, src_vertices_ptr, i3);
-		memcpy(&E[0], fE, 3 * sizeof(float));
-		memcpy(&F[0], fF, 3 * sizeof(float));
-		memcpy(&G[0], fG, 3 * sizeof(float));
-
-		// Retrieve references to the base texture coordinates of the three vertices
-		// in the triangle.
-		// TODO: Allow customization of which tex coordinates to generate from.
-		math::vec2 Et;
-		float fEt[4];
-		gfx::vertex_unpack(&fEt[0], gfx::attribute::TexCoord0, _vertex_format, src_vertices_ptr, i1);
-		math::vec2 Ft;
-		float fFt[4];
-		gfx::vertex_unpack(&fFt[0], gfx::attribute::TexCoord0, _vertex_format, src_vertices_ptr, i2);
-		math::vec2 Gt;
-		float fGt[4];
-		gfx::vertex_unpack(&fGt[0], gfx::attribute::TexCoord0, _vertex_format, src_vertices_ptr, i3);
-		memcpy(&Et[0], fEt, 2 * sizeof(float));
-		memcpy(&Ft[0], fFt, 2 * sizeof(float));
-		memcpy(&Gt[0], fGt, 2 * sizeof(float));
-
-		// Compute the known variables P & Q, where "P = F-E" and "Q = G-E"
-		// based on our original discussion of the tangent vector
-		// calculation.
-		P = F - E;
-		Q = G - E;
-
-		// Also compute the know variables <s1,t1> and <s2,t2>. Recall that
-		// these are the texture coordinate deltas similarly for "F-E"
-		// and "G-E".
-		float s1 = Ft.x - Et.x;
-		float t1 = Ft.y - Et.y;
-		float s2 = Gt.x - Et.x;
-		float t2 = Gt.y - Et.y;
-
-		// Next we can pre-compute part of the equation we developed
-		// earlier: "1/(s1 * t2 - s2 * t1)". We do this in two separate
-		// stages here in order to ensure that the texture coordinates
-		// are not invalid.
-		float r = (s1 * t2 - s2 * t1);
-		if(math::abs(r) < math::epsilon<float>())
-			continue;
-		r = 1.0f / r;
-
-		// All that's left for us to do now is to run the matrix
-		// multiplication and multiply the result by the scalar portion
-		// we precomputed earlier.
-		T.x = r * (t2 * P.x - t1 * Q.x);
-		T.y = r * (t2 * P.y - t1 * Q.y);
-		T.z = r * (t2 * P.z - t1 * Q.z);
-		B.x = r * (s1 * Q.x - s2 * P.x);
-		B.y = r * (s1 * Q.y - s2 * P.y);
-		B.z = r * (s1 * Q.z - s2 * P.z);
-
-		// Add the tangent and bitangent vectors (summed average) to
-		// any previous values computed for each vertex.
-		tangents[i1] += T;
-		tangents[i2] += T;
-		tangents[i3] += T;
-		bitangents[i1] += B;
-		bitangents[i2] += B;
-		bitangents[i3] += B;
+		tangents[i1] += face_tangents[i];
+		tangents[i2] += face_tangents[i];
+		tangents[i3] += face_tangents[i];
+		bitangents[i1] += face_bitangents[i];
+		bitangents[i2] += face_bitangents[i];
+		bitangents[i3] += face_bitangents[i];
 
 	} // Next triangle
 
-	// Generate final tangent vectors
-	for(i = 0; i < num_verts; i++, src_vertices_ptr += vertex_stride)
-	{
-		// Skip if the original imported data already provided a bitangent /
-		// tangent.
-		bool has_bitangent =
-			((_preparation_data.vertex_flags[i] & preparation_data::source_contains_binormal) != 0);
-		bool has_tangent =
-			((_preparation_data.vertex_flags[i] & preparation_data::source_contains_tangent) != 0);
-		if(!_force_tangent_generation && has_bitangent && has_tangent)
-			continue;
-
-		// Retrieve the normal vector from the vertex and the computed
-		// tangent vector.
-		float normal[4];
-		gfx::vertex_unpack(normal, gfx::attribute::Normal, _vertex_format, src_vertices_ptr);
-		memcpy(&normal_vec[0], normal, 3 * sizeof(float));
+	// Generate final tangent vectors. Every iteration reads and writes a
+	// single vertex, so the ranges run on worker threads too.
+	parallel_for_range(
+		num_verts, 16384,
+		[this, src_vertices_ptr, vertex_stride, requires_tangents, requires_bitangents, tangents,
+		 bitangents](std::uint32_t begin, std::uint32_t end) {
+			std::uint8_t* vertex_ptr = src_vertices_ptr + (begin * vertex_stride);
+			for(std::uint32_t v = begin; v < end; ++v, vertex_ptr += vertex_stride)
+			{
+				// Skip if the original imported data already provided a bitangent /
+				// tangent.
+				bool has_bitangent =
+					((_preparation_data.vertex_flags[v] & preparation_data::source_contains_binormal) != 0);
+				bool has_tangent =
+					((_preparation_data.vertex_flags[v] & preparation_data::source_contains_tangent) != 0);
+				if(!_force_tangent_generation && has_bitangent && has_tangent)
+					continue;
 
-		T = tangents[i];
+				// Retrieve the normal vector from the vertex and the computed
+				// tangent vector.
+				math::vec3 normal_vec;
+				float normal[4];
+				gfx::vertex_unpack(normal, gfx::attribute::Normal, _vertex_format, vertex_ptr);
+				memcpy(&normal_vec[0], normal, 3 * sizeof(float));
 
-		// GramSchmidt orthogonalize
-		T = T - (normal_vec * math::dot(normal_vec, T));
-		T = math::normalize(T);
+				math::vec3 tangent_vec = tangents[v];
 
-		// Store tangent if required
-		if(_force_tangent_generation || (!has_tangent && requires_tangents))
-			gfx::vertex_pack(&math::vec4(T, 1.0f)[0], true, gfx::attribute::Tangent, _vertex_format,
-							 src_vertices_ptr);
+				// GramSchmidt orthogonalize
+				tangent_vec = tangent_vec - (normal_vec * math::dot(normal_vec, tangent_vec));
+				tangent_vec = math::normalize(tangent_vec);
 
-		// Compute and store bitangent if required
-		if(_force_tangent_generation || (!has_bitangent && requires_bitangents))
-		{
-			// Calculate the new orthogonal bitangent
-			B = math::cross(normal_vec, T);
-			B = math::normalize(B);
-
-			// Compute the "handedness" of the tangent and bitangent. This
-			// ensures the inverted / mirrored texture coordinates still have
-			// an accurate matrix.
-			cross_vec = math::cross(normal_vec, T);
-			if(math::dot(cross_vec, bitangents[i]) < 0.0f)
-			{
-				// Flip the bitangent
-				B = -B;
+				// Store tangent if required
+				if(_force_tangent_generation || (!has_tangent && requires_tangents))
+					gfx::vertex_pack(&math::vec4(tangent_vec, 1.0f)[0], true, gfx::attribute::Tangent,
+									 _vertex_format, vertex_ptr);
 
-			} // End if coordinates inverted
+				// Compute and store bitangent if required
+				if(_force_tangent_generation || (!has_bitangent && requires_bitangents))
+				{
+					// Calculate the new orthogonal bitangent
+					math::vec3 bitangent_vec = math::cross(normal_vec, tangent_vec);
+					bitangent_vec = math::normalize(bitangent_vec);
+
+					// Compute the "handedness" of the tangent and bitangent. This
+					// ensures the inverted / mirrored texture coordinates still have
+					// an accurate matrix.
+					const math::vec3 cross_vec = math::cross(normal_vec, tangent_vec);
+					if(math::dot(cross_vec, bitangents[v]) < 0.0f)
+					{
+						// Flip the bitangent
+						bitangent_vec = -bitangent_vec;
 
-			// Store.
-			gfx::vertex_pack(&math::vec4(B, 1.0f)[0], true, gfx::attribute::Bitangent, _vertex_format,
-							 src_vertices_ptr);
+					} // End if coordinates inverted
 
-		} // End if requires bitangent
+					// Store.
+					gfx::vertex_pack(&math::vec4(bitangent_vec, 1.0f)[0], true, gfx::attribute::Bitangent,
+									 _vertex_format, vertex_ptr);
 
-	} // Next vertex
+				} // End if requires bitangent
+			}
+		});
 
 	// Cleanup
 	checked_array_delete(tangents);
@@ -4131,7 +4783,6 @@ bool mesh::generate_vertex_tangents()
 bool mesh::generate_adjacency(std::vector<std::uint32_t>& adjacency)
 {
 	std::map<adjacent_edge_key, std::uint32_t> edge_tree;
-	std::map<adjacent_edge_key, std::uint32_t>::iterator it_edge;
 
 	// What is the status of the mesh?
 	if(_prepare_status != mesh_status::prepared)
@@ -4183,57 +4834,63 @@ bool mesh::generate_adjacency(std::vector<std::uint32_t>& adjacency)
 		// Size the output array.
 		adjacency.resize(_preparation_data.triangle_count * 3, 0xFFFFFFFF);
 
-		// Now, find any adjacent edges for each triangle edge
-		for(std::uint32_t i = 0; i < _preparation_data.triangle_count; ++i)
-		{
-			adjacent_edge_key edge;
-
-			// Degenerate triangles cannot participate.
-			const triangle& tri = _preparation_data.triangle_data[i];
-			if(tri.flags & triangle_flags::degenerate)
-				continue;
-
-			// Retrieve positions of each referenced vertex.
-			const math::vec3* v1 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (tri.indices[0] * vertex_stride));
-			const math::vec3* v2 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (tri.indices[1] * vertex_stride));
-			const math::vec3* v3 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (tri.indices[2] * vertex_stride));
-
-			// Note: Notice below that the order of the edge vertices
-			//       is swapped. This is because we want to find the
-			//       matching ADJACENT edge, rather than simply finding
-			//       the same edge that we're currently processing.
-
-			// edge 1
-			edge.vertex2 = v1;
-			edge.vertex1 = v2;
-
-			// Find the matching adjacent edge
-			it_edge = edge_tree.find(edge);
-			if(it_edge != edge_tree.end())
-				adjacency[(i * 3)] = it_edge->second;
-
-			// edge 2
-			edge.vertex2 = v2;
-			edge.vertex1 = v3;
-
-			// Find the matching adjacent edge
-			it_edge = edge_tree.find(edge);
-			if(it_edge != edge_tree.end())
-				adjacency[(i * 3) + 1] = it_edge->second;
-
-			// edge 3
-			edge.vertex2 = v3;
-			edge.vertex1 = v1;
+		// Now, find any adjacent edges for each triangle edge. The edge tree
+		// is complete and only read from here on, so the lookups run on
+		// worker threads; each face writes only its own adjacency slots.
+		parallel_for_range(
+			_preparation_data.triangle_count, 8192,
+			[this, src_vertices_ptr, vertex_stride, &edge_tree,
+			 &adjacency](std::uint32_t begin, std::uint32_t end) {
+				for(std::uint32_t f = begin; f < end; ++f)
+				{
+					adjacent_edge_key edge;
 
-			// Find the matching adjacent edge
-			it_edge = edge_tree.find(edge);
-			if(it_edge != edge_tree.end())
-				adjacency[(i * 3) + 2] = it_edge->second;
+					// Degenerate triangles cannot participate.
+					const triangle& tri = _preparation_data.triangle_data[f];
+					if(tri.flags & triangle_flags::degenerate)
+						continue;
 
-		} // Next Face
+					// Retrieve positions of each referenced vertex.
+					const math::vec3* v1 = reinterpret_cast<const math::vec3*>(
+						src_vertices_ptr + (tri.indices[0] * vertex_stride));
+					const math::vec3* v2 = reinterpret_cast<const math::vec3*>(
+						src_vertices_ptr + (tri.indices[1] * vertex_stride));
+					const math::vec3* v3 = reinterpret_cast<const math::vec3*>(
+						src_vertices_ptr + (tri.indices[2] * vertex_stride));
+
+					// Note: Notice below that the order of the edge vertices
+					//       is swapped. This is because we want to find the
+					//       matching ADJACENT edge, rather than simply finding
+					//       the same edge that we're currently processing.
+
+					// edge 1
+					edge.vertex2 = v1;
+					edge.vertex1 = v2;
+
+					// Find the matching adjacent edge
+					auto it_adjacent = edge_tree.find(edge);
+					if(it_adjacent != edge_tree.end())
+						adjacency[(f * 3)] = it_adjacent->second;
+
+					// edge 2
+					edge.vertex2 = v2;
+					edge.vertex1 = v3;
+
+					// Find the matching adjacent edge
+					it_adjacent = edge_tree.find(edge);
+					if(it_adjacent != edge_tree.end())
+						adjacency[(f * 3) + 1] = it_adjacent->second;
+
+					// edge 3
+					edge.vertex2 = v3;
+					edge.vertex1 = v1;
+
+					// Find the matching adjacent edge
+					it_adjacent = edge_tree.find(edge);
+					if(it_adjacent != edge_tree.end())
+						adjacency[(f * 3) + 2] = it_adjacent->second;
+				}
+			});
 
 	} // End if not prepared
 	else
@@ -4281,53 +4938,59 @@ bool mesh::generate_adjacency(std::vector<std::uint32_t>& adjacency)
 		// Size the output array.
 		adjacency.resize(_face_count * 3, 0xFFFFFFFF);
 
-		// Now, find any adjacent edges for each triangle edge
-		src_indices_ptr = _system_ib;
-		for(std::uint32_t i = 0; i < _face_count; ++i, src_indices_ptr += 3)
-		{
-			adjacent_edge_key edge;
-
-			// Retrieve positions of each referenced vertex.
-			const math::vec3* v1 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (src_indices_ptr[0] * vertex_stride));
-			const math::vec3* v2 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (src_indices_ptr[1] * vertex_stride));
-			const math::vec3* v3 =
-				reinterpret_cast<const math::vec3*>(src_vertices_ptr + (src_indices_ptr[2] * vertex_stride));
-
-			// Note: Notice below that the order of the edge vertices
-			//       is swapped. This is because we want to find the
-			//       matching ADJACENT edge, rather than simply finding
-			//       the same edge that we're currently processing.
-
-			// edge 1
-			edge.vertex2 = v1;
-			edge.vertex1 = v2;
-
-			// Find the matching adjacent edge
-			it_edge = edge_tree.find(edge);
-			if(it_edge != edge_tree.end())
-				adjacency[(i * 3)] = it_edge->second;
-
-			// edge 2
-			edge.vertex2 = v2;
-			edge.vertex1 = v3;
-
-			// Find the matching adjacent edge
-			it_edge = edge_tree.find(edge);
-			if(it_edge != edge_tree.end())
-				adjacency[(i * 3) + 1] = it_edge->second;
-
-			// edge 3
-			edge.vertex2 = v3;
-			edge.vertex1 = v1;
-
-			// Find the matching adjacent edge
-			it_edge = edge_tree.find(edge);
-			if(it_edge != edge_tree.end())
-				adjacency[(i * 3) + 2] = it_edge->second;
-
-		} // Next Face
+		// Now, find any adjacent edges for each triangle edge. As above, the
+		// edge tree is immutable by this point so the lookups are spread over
+		// worker threads.
+		parallel_for_range(
+			_face_count, 8192,
+			[this, src_vertices_ptr, vertex_stride, &edge_tree,
+			 &adjacency](std::uint32_t begin, std::uint32_t end) {
+				const std::uint32_t* indices_ptr = _system_ib + (begin * 3);
+				for(std::uint32_t f = begin; f < end; ++f, indices_ptr += 3)
+				{
+					adjacent_edge_key edge;
+
+					// Retrieve positions of each referenced vertex.
+					const math::vec3* v1 = reinterpret_cast<const math::vec3*>(
+						src_vertices_ptr + (indices_ptr[0] * vertex_stride));
+					const math::vec3* v2 = reinterpret_cast<const math::vec3*>(
+						src_vertices_ptr + (indices_ptr[1] * vertex_stride));
+					const math::vec3* v3 = reinterpret_cast<const math::vec3*>(
+						src_vertices_ptr + (indices_ptr[2] * vertex_stride));
+
+					// Note: Notice below that the order of the edge vertices
+					//       is swapped. This is because we want to find the
+					//       matching ADJACENT edge, rather than simply finding
+					//       the same edge that we're currently processing.
+
+					// edge 1
+					edge.vertex2 = v1;
+					edge.vertex1 = v2;
+
+					// Find the matching adjacent edge
+					auto it_adjacent = edge_tree.find(edge);
+					if(it_adjacent != edge_tree.end())
+						adjacency[(f * 3)] = it_adjacent->second;
+
+					// edge 2
+					edge.vertex2 = v2;
+					edge.vertex1 = v3;
+
+					// Find the matching adjacent edge
+					it_adjacent = edge_tree.find(edge);
+					if(it_adjacent != edge_tree.end())
+						adjacency[(f * 3) + 1] = it_adjacent->second;
+
+					// edge 3
+					edge.vertex2 = v3;
+					edge.vertex1 = v1;
+
+					// Find the matching adjacent edge
+					it_adjacent = edge_tree.find(edge);
+					if(it_adjacent != edge_tree.end())
+						adjacency[(f * 3) + 2] = it_adjacent->second;
+				}
+			});
 
 	} // End if prepared
 
@@ -4337,9 +5000,6 @@ bool mesh::generate_adjacency(std::vector<std::uint32_t>& adjacency)
 
 bool mesh::weld_vertices(float tolerance, std::vector<std::uint32_t>* vertex_remap_ptr /* = nullptr */)
 {
-	weld_key key;
-	std::map<weld_key, std::uint32_t> vertex_tree;
-	std::map<weld_key, std::uint32_t>::const_iterator it_key;
 	byte_array_t new_vertex_data, new_vertex_flags;
 	std::uint32_t new_vertex_count = 0;
 
@@ -4350,28 +5010,77 @@ bool mesh::weld_vertices(float tolerance, std::vector<std::uint32_t>* vertex_rem
 
 	// Retrieve useful data offset information.
 	std::uint16_t vertex_stride = _vertex_format.getStride();
+	std::uint16_t position_offset = _vertex_format.getOffset(gfx::attribute::Position);
+
+	// Vertices are bucketed by their position quantized to the weld
+	// tolerance. Each lookup is then a single hash probe over a handful of
+	// candidates rather than a tree walk across the whole vertex cloud.
+	const float inv_cell_size = 1.0f / std::max(tolerance, 0.0000001f);
+	const float tolerance_sq = tolerance * tolerance;
+	std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> vertex_cells;
+	vertex_cells.reserve(_preparation_data.vertex_count);
+
+	auto quantize_position = [inv_cell_size](const math::vec3& p) {
+		const auto qx = static_cast<std::int64_t>(math::floor(p.x * inv_cell_size + 0.5f));
+		const auto qy = static_cast<std::int64_t>(math::floor(p.y * inv_cell_size + 0.5f));
+		const auto qz = static_cast<std::int64_t>(math::floor(p.z * inv_cell_size + 0.5f));
+		std::uint64_t hash = static_cast<std::uint64_t>(qx) * 73856093ull;
+		hash ^= static_cast<std::uint64_t>(qy) * 19349663ull;
+		hash ^= static_cast<std::uint64_t>(qz) * 83492791ull;
+		return hash;
+	};
+
+	// Every attribute except the position must match bit for bit; the
+	// position itself is matched against the distance tolerance instead.
+	// Duplicates from unindexed source data are bit identical, so this
+	// reduces to a couple of wide (vectorized) memory compares per candidate
+	// and, unlike a pure positional weld, it preserves UV seams and split
+	// normals.
+	auto attributes_equal = [vertex_stride, position_offset](const std::uint8_t* lhs,
+															 const std::uint8_t* rhs) {
+		const std::uint16_t position_end = position_offset + sizeof(float) * 3;
+		return std::memcmp(lhs, rhs, position_offset) == 0 &&
+			   std::memcmp(lhs + position_end, rhs + position_end,
+						   static_cast<std::size_t>(vertex_stride - position_end)) == 0;
+	};
 
 	// For each vertex to be welded.
 	for(std::uint32_t i = 0; i < _preparation_data.vertex_count; ++i)
 	{
-		// Build a new key structure for inserting
-		key.vertex = (&_preparation_data.vertex_data[0]) + (i * vertex_stride);
-		key.format = _vertex_format;
-		key.tolerance = tolerance;
-
-		// Does a vertex with matching details already exist in the tree.
-		it_key = vertex_tree.find(key);
-		if(it_key == vertex_tree.end())
+		const std::uint8_t* vertex_ptr = (&_preparation_data.vertex_data[0]) + (i * vertex_stride);
+		const math::vec3 position =
+			*reinterpret_cast<const math::vec3*>(vertex_ptr + position_offset);
+
+		// Does a vertex with matching details already exist in the cell?
+		auto& cell = vertex_cells[quantize_position(position)];
+		std::uint32_t matched_index = 0xFFFFFFFF;
+		for(auto candidate : cell)
 		{
-			// No matching vertex. Insert into the tree (value = NEW index of vertex).
-			vertex_tree[key] = new_vertex_count;
+			const std::uint8_t* candidate_ptr = &new_vertex_data[candidate * vertex_stride];
+			const math::vec3 candidate_position =
+				*reinterpret_cast<const math::vec3*>(candidate_ptr + position_offset);
+			if(math::distance2(position, candidate_position) <= tolerance_sq &&
+			   attributes_equal(vertex_ptr, candidate_ptr))
+			{
+				matched_index = candidate;
+				break;
+
+			} // End if within tolerance
+
+		} // Next candidate
+
+		if(matched_index == 0xFFFFFFFF)
+		{
+			// No matching vertex. Record it in the cell (value = NEW index of
+			// vertex).
+			cell.push_back(new_vertex_count);
 			collapse_map[i] = new_vertex_count;
 			if(vertex_remap_ptr)
 				(*vertex_remap_ptr)[i] = new_vertex_count;
 
 			// Store the vertex in the new buffer
 			new_vertex_data.resize((new_vertex_count + 1) * vertex_stride);
-			memcpy(&new_vertex_data[new_vertex_count * vertex_stride], key.vertex, vertex_stride);
+			memcpy(&new_vertex_data[new_vertex_count * vertex_stride], vertex_ptr, vertex_stride);
 			new_vertex_flags.push_back(_preparation_data.vertex_flags[i]);
 			new_vertex_count++;
 
@@ -4380,7 +5089,7 @@ bool mesh::weld_vertices(float tolerance, std::vector<std::uint32_t>* vertex_rem
 		{
 			// A vertex already existed at this location.
 			// Just mark the 'collapsed' index for this vertex in the remap array.
-			collapse_map[i] = it_key->second;
+			collapse_map[i] = matched_index;
 			if(vertex_remap_ptr)
 				(*vertex_remap_ptr)[i] = 0xFFFFFFFF;
 
@@ -4511,6 +5220,183 @@ irect mesh::calculate_screen_rect(const math::transform& world, const camera& ca
 				 irect::value_type(max.y));
 }
 
+void mesh::build_raycast_bvh()
+{
+	_bvh_nodes.clear();
+	_bvh_tris.clear();
+
+	if(_system_vb == nullptr || _system_ib == nullptr || _face_count == 0)
+		return;
+
+	auto unpack_position = [this](std::uint32_t index) {
+		float unpacked[4];
+		gfx::vertex_unpack(unpacked, gfx::attribute::Position, _vertex_format, _system_vb, index);
+		return math::vec3(unpacked[0], unpacked[1], unpacked[2]);
+	};
+
+	// Precompute per triangle bounds and centroids; the recursive split below
+	// touches them repeatedly.
+	std::vector<math::bbox> tri_bounds(_face_count);
+	std::vector<math::vec3> tri_centers(_face_count);
+	_bvh_tris.resize(_face_count);
+	for(std::uint32_t f = 0; f < _face_count; ++f)
+	{
+		const std::uint32_t* indices_ptr = _system_ib + (f * 3);
+		math::bbox& bounds = tri_bounds[f];
+		bounds.reset();
+		bounds.add_point(unpack_position(indices_ptr[0]));
+		bounds.add_point(unpack_position(indices_ptr[1]));
+		bounds.add_point(unpack_position(indices_ptr[2]));
+		tri_centers[f] = bounds.get_center();
+		_bvh_tris[f] = f;
+	}
+
+	// Leaves keep a handful of triangles; splitting all the way down to one
+	// costs more in node tests than it saves in triangle tests.
+	const std::uint32_t max_leaf_tris = 4;
+
+	// Median split at the centroid median of the widest axis. The left child
+	// always sits directly after its parent; the right child index is only
+	// known once the whole left subtree has been laid out.
+	std::function<void(std::uint32_t, std::uint32_t, std::uint32_t)> build_range =
+		[&](std::uint32_t node, std::uint32_t first, std::uint32_t count) {
+			math::bbox bounds;
+			bounds.reset();
+			for(std::uint32_t i = 0; i < count; ++i)
+			{
+				const math::bbox& tb = tri_bounds[_bvh_tris[first + i]];
+				bounds.add_point(tb.min);
+				bounds.add_point(tb.max);
+			}
+			_bvh_nodes[node].bounds = bounds;
+
+			if(count <= max_leaf_tris)
+			{
+				_bvh_nodes[node].first_tri = first;
+				_bvh_nodes[node].tri_count = count;
+				return;
+			}
+
+			const math::vec3 extents = bounds.get_extents();
+			int axis = 0;
+			if(extents.y > extents.x)
+				axis = 1;
+			if(extents.z > extents[axis])
+				axis = 2;
+
+			const std::uint32_t mid = first + count / 2;
+			std::nth_element(_bvh_tris.begin() + first, _bvh_tris.begin() + mid,
+							 _bvh_tris.begin() + first + count,
+							 [&](std::uint32_t lhs, std::uint32_t rhs) {
+								 return tri_centers[lhs][axis] < tri_centers[rhs][axis];
+							 });
+
+			const std::uint32_t left = static_cast<std::uint32_t>(_bvh_nodes.size());
+			_bvh_nodes.emplace_back();
+			build_range(left, first, count / 2);
+
+			const std::uint32_t right = static_cast<std::uint32_t>(_bvh_nodes.size());
+			_bvh_nodes.emplace_back();
+			_bvh_nodes[node].right = right;
+			build_range(right, mid, count - count / 2);
+		};
+
+	_bvh_nodes.emplace_back();
+	build_range(0, 0, _face_count);
+}
+
+bool mesh::raycast(const math::vec3& origin, const math::vec3& direction, float max_distance,
+				   float& distance_out, math::vec3& normal_out, std::uint32_t& face_out)
+{
+	if(_prepare_status != mesh_status::prepared || _system_vb == nullptr || _system_ib == nullptr ||
+	   _face_count == 0 || max_distance <= 0.0f)
+		return false;
+
+	if(_bvh_nodes.empty())
+		build_raycast_bvh();
+	if(_bvh_nodes.empty())
+		return false;
+
+	auto unpack_position = [this](std::uint32_t index) {
+		float unpacked[4];
+		gfx::vertex_unpack(unpacked, gfx::attribute::Position, _vertex_format, _system_vb, index);
+		return math::vec3(unpacked[0], unpacked[1], unpacked[2]);
+	};
+
+	// The query ray is parameterized over [0, 1] along direction * range so
+	// box and triangle tests share a comparable t.
+	const math::vec3 velocity = direction * max_distance;
+	float best_t = 1.0f;
+	bool hit = false;
+
+	// Depth is bounded by the balanced median split (log2 of the face
+	// count), so a small fixed stack suffices.
+	std::uint32_t node_stack[64];
+	std::uint32_t stack_size = 0;
+	node_stack[stack_size++] = 0;
+	while(stack_size != 0)
+	{
+		const std::uint32_t node_index = node_stack[--stack_size];
+		const bvh_node& node = _bvh_nodes[node_index];
+
+		float node_t = 0.0f;
+		if(!node.bounds.intersect(origin, velocity, node_t) || node_t >= best_t)
+			continue;
+
+		if(node.right != 0)
+		{
+			node_stack[stack_size++] = node.right;
+			node_stack[stack_size++] = node_index + 1;
+			continue;
+		}
+
+		// Leaf; Moller-Trumbore against each owned triangle. Both winding
+		// orders are accepted so back faces can be picked too.
+		for(std::uint32_t i = 0; i < node.tri_count; ++i)
+		{
+			const std::uint32_t face = _bvh_tris[node.first_tri + i];
+			const std::uint32_t* indices_ptr = _system_ib + (face * 3);
+			const math::vec3 v0 = unpack_position(indices_ptr[0]);
+			const math::vec3 edge1 = unpack_position(indices_ptr[1]) - v0;
+			const math::vec3 edge2 = unpack_position(indices_ptr[2]) - v0;
+
+			const math::vec3 pvec = math::cross(velocity, edge2);
+			const float det = math::dot(edge1, pvec);
+			if(math::abs(det) < math::epsilon<float>())
+				continue;
+
+			const float inv_det = 1.0f / det;
+			const math::vec3 tvec = origin - v0;
+			const float u = math::dot(tvec, pvec) * inv_det;
+			if(u < 0.0f || u > 1.0f)
+				continue;
+
+			const math::vec3 qvec = math::cross(tvec, edge1);
+			const float v = math::dot(velocity, qvec) * inv_det;
+			if(v < 0.0f || u + v > 1.0f)
+				continue;
+
+			const float t = math::dot(edge2, qvec) * inv_det;
+			if(t < 0.0f || t >= best_t)
+				continue;
+
+			best_t = t;
+			hit = true;
+			face_out = face;
+			normal_out = math::normalize(math::cross(edge1, edge2));
+		}
+	}
+
+	if(!hit)
+		return false;
+
+	distance_out = best_t * max_distance;
+	// Orient the geometric normal against the incoming ray.
+	if(math::dot(normal_out, direction) > 0.0f)
+		normal_out = -normal_out;
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // skin_bind_data Member Definitions
 ///////////////////////////////////////////////////////////////////////////////
@@ -4703,11 +5589,13 @@ bone_palette::get_skinning_matrices(const std::vector<math::transform>& node_tra
 		return node_transforms;
 
 	const std::uint32_t max_blend_transforms = gfx::get_max_blend_transforms();
+	// Only the bones actually referenced by the palette are computed and
+	// uploaded; vertices never index past them.
 	std::vector<math::transform> transforms;
-	transforms.resize(max_blend_transforms);
+	transforms.resize(std::min<std::size_t>(_bones.size(), max_blend_transforms));
 
 	// Compute transformation matrix for each bone in the palette
-	for(size_t i = 0; i < _bones.size(); ++i)
+	for(size_t i = 0; i < transforms.size(); ++i)
 	{
 		auto bone = _bones[i];
 		const auto& bone_transform = node_transforms[bone];
@@ -2,10 +2,12 @@
 
 #include "core/common/basetypes.hpp"
 #include "core/graphics/graphics.h"
+#include "core/graphics/static_buffer_pool.h"
 #include "core/math/math_includes.h"
 #include "core/reflection/registration.h"
 #include "core/serialization/serialization.h"
 
+#include <iosfwd>
 #include <map>
 #include <memory>
 #include <vector>
@@ -389,8 +391,37 @@ public:
 		std::int32_t face_start = -1;
 		/// Number of faces to render in this batch.
 		std::uint32_t face_count = 0;
+		/// First vertex of this batch within the shared static buffer
+		/// pool. Runtime only - rewritten whenever the hardware buffers
+		/// are (re)built and never serialized.
+		std::uint32_t buffer_vertex_offset = 0;
+		/// First index of this batch within the shared static buffer pool.
+		std::uint32_t buffer_index_offset = 0;
 	};
 
+	// Small cluster of triangles ("meshlet") within a subset, carrying its
+	// own bounds and normal cone so draws can cull at a much finer grain
+	// than the whole mesh. Clusters cover contiguous face ranges of the
+	// final index buffer and are regenerated whenever the buffers are
+	// (re)built, so they never need to be serialized.
+	struct cluster
+	{
+		/// Data group (subset) the cluster belongs to.
+		std::uint32_t data_group_id = 0;
+		/// First face of the cluster within the final index buffer.
+		std::uint32_t face_start = 0;
+		/// Number of faces in the cluster.
+		std::uint32_t face_count = 0;
+		/// Object space bounds of the cluster.
+		math::bbox bounds;
+		/// Average face normal; axis of the backface culling cone.
+		math::vec3 cone_axis = {0.0f, 0.0f, 0.0f};
+		/// Cone cutoff term; 1 disables the cone test (degenerate spread).
+		float cone_cutoff = 1.0f;
+	};
+
+	using cluster_array_t = std::vector<cluster>;
+
 	struct info
 	{
 		std::uint32_t vertices = 0;
@@ -473,6 +504,39 @@ public:
 	//-----------------------------------------------------------------------------
 	void bind_render_buffers_for_subset(std::uint32_t data_group_id);
 
+	//-----------------------------------------------------------------------------
+	//  Name : bind_render_buffers_for_range ()
+	/// <summary>
+	/// Binds the graphics buffers for an arbitrary face range of the
+	/// subset with the data group specified, e.g. a run of visible
+	/// clusters.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void bind_render_buffers_for_range(std::uint32_t data_group_id, std::uint32_t face_start,
+									   std::uint32_t face_count);
+
+	//-----------------------------------------------------------------------------
+	//  Name : has_clusters ()
+	/// <summary>
+	/// Whether cluster (meshlet) data is available for fine grained
+	/// culling.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool has_clusters() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_visible_cluster_ranges ()
+	/// <summary>
+	/// Culls the clusters of the given subset against the frustum and the
+	/// backface cones and appends the merged visible face ranges (start,
+	/// count pairs) to 'out_ranges'. Returns false when nothing is
+	/// visible. 'eye' is the world space camera position.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool get_visible_cluster_ranges(std::uint32_t data_group_id, const math::frustum& frustum,
+									const math::transform& world_transform, const math::vec3& eye,
+									std::vector<std::pair<std::uint32_t, std::uint32_t>>& out_ranges) const;
+
 	// mesh creation methods
 	//-----------------------------------------------------------------------------
 	//  Name : prepare_mesh ()
@@ -538,6 +602,37 @@ public:
 	//-----------------------------------------------------------------------------
 	void set_subset_count(std::uint32_t count);
 
+	//-----------------------------------------------------------------------------
+	//  Name : save_prepared ()
+	/// <summary>
+	/// Writes the fully prepared mesh (sorted vertex/index buffers, subset
+	/// table and bounds) to the stream in the layout-final runtime container
+	/// format that 'bind_prepared' consumes. Only valid for prepared,
+	/// non-skinned meshes; returns false otherwise.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool save_prepared(std::ostream& stream) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : bind_prepared ()
+	/// <summary>
+	/// Binds a memory mapped runtime container written by 'save_prepared'.
+	/// The system vertex/index buffers alias the mapped region directly and
+	/// 'backing' keeps the mapping alive for as long as they are referenced,
+	/// so no preparation or data copies happen at load time.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool bind_prepared(const std::shared_ptr<void>& backing, const std::uint8_t* data, std::size_t size);
+
+	//-----------------------------------------------------------------------------
+	//  Name : is_prepared_format ()
+	/// <summary>
+	/// Checks whether the supplied bytes start with the runtime container
+	/// magic written by 'save_prepared'.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	static bool is_prepared_format(const std::uint8_t* data, std::size_t size);
+
 	//-----------------------------------------------------------------------------
 	//  Name : create_cube ()
 	/// <summary>
@@ -687,6 +782,16 @@ public:
 	//-----------------------------------------------------------------------------
 	void build_ib(bool hardware_copy = true);
 
+	//-----------------------------------------------------------------------------
+	//  Name : update_subset_buffer_offsets ()
+	/// <summary>
+	/// Refreshes each subset's recorded offsets within the shared static
+	/// buffer pool. Run after the subset tables or the pool allocations
+	/// change.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void update_subset_buffer_offsets();
+
 	// Utility functions
 	//-----------------------------------------------------------------------------
 	//  Name : generate_adjacency ()
@@ -768,6 +873,20 @@ public:
 
 	const std::unique_ptr<armature_node>& get_armature() const;
 	irect calculate_screen_rect(const math::transform& world, const camera& cam) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : raycast ()
+	/// <summary>
+	/// Triangle-accurate ray intersection against the prepared mesh data,
+	/// in mesh local space. A BVH over the triangles is built on first
+	/// use and reused by every later query, so per-query cost is a tree
+	/// descent rather than a full triangle sweep. Returns the closest hit
+	/// within max_distance with its distance, geometric normal and face
+	/// index.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool raycast(const math::vec3& origin, const math::vec3& direction, float max_distance,
+				 float& distance_out, math::vec3& normal_out, std::uint32_t& face_out);
 	//-----------------------------------------------------------------------------
 	//  Name : get_subset ()
 	/// <summary>
@@ -1028,6 +1147,26 @@ protected:
 	void bind_mesh_data(std::uint32_t face_start, std::uint32_t face_count, std::uint32_t vertex_start,
 						std::uint32_t vertex_count);
 
+	//-----------------------------------------------------------------------------
+	//  Name : generate_clusters () (Private)
+	/// <summary>
+	/// Splits every subset of the final index buffer into small clusters
+	/// (meshlets) and computes their bounds and backface cones. Called
+	/// whenever the system buffers are (re)built.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void generate_clusters();
+
+	//-----------------------------------------------------------------------------
+	//  Name : build_raycast_bvh () (Private)
+	/// <summary>
+	/// Builds the local-space triangle BVH over the final system buffers by
+	/// median split on triangle centroids. Called lazily from the first
+	/// raycast query rather than during preparation.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void build_raycast_bvh();
+
 	//-------------------------------------------------------------------------
 	// Protected Static Functions
 	//-------------------------------------------------------------------------
@@ -1083,6 +1222,24 @@ protected:
 	gfx::vertex_layout _vertex_format;
 	/// The final system memory copy of the index buffer.
 	std::uint32_t* _system_ib = nullptr;
+	/// Bytes accounted to the memory tracker for the owned system buffers
+	/// (zero when the buffers alias a memory mapped container).
+	std::size_t _tracked_vb_size = 0;
+	std::size_t _tracked_ib_size = 0;
+	/// Node of the lazily built local-space triangle BVH used by raycast.
+	/// Children are stored as (this + 1, right); right == 0 marks a leaf
+	/// owning the [first_tri, first_tri + tri_count) slice of _bvh_tris.
+	struct bvh_node
+	{
+		math::bbox bounds;
+		std::uint32_t right = 0;
+		std::uint32_t first_tri = 0;
+		std::uint32_t tri_count = 0;
+	};
+	/// Flattened BVH nodes; empty until the first raycast.
+	std::vector<bvh_node> _bvh_nodes;
+	/// Triangle indices in BVH partition order.
+	std::vector<std::uint32_t> _bvh_tris;
 	/// Material and data group information for each triangle.
 	subset_key_array_t _triangle_data;
 	/// After constructing the mesh, this will contain the actual hardware vertex
@@ -1091,6 +1248,11 @@ protected:
 	/// After constructing the mesh, this will contain the actual hardware index
 	/// buffer resource
 	std::shared_ptr<gfx::index_buffer> _hardware_ib;
+	/// Suballocations within the shared static buffer pool. When valid
+	/// they replace the dedicated hardware buffers above, which remain as
+	/// the fallback when the pool cannot service a request.
+	gfx::static_vertex_alloc _pool_vb;
+	gfx::static_index_alloc _pool_ib;
 
 	// mesh data look up tables
 	/// The actual list of subsets maintained by this mesh.
@@ -1101,6 +1263,11 @@ protected:
 	/// Quick binary tree lookup of existing subsets based on material AND data
 	/// group id.
 	subset_key_map_t _subset_lookup;
+	/// Fine grained culling clusters covering the final index buffer, in
+	/// subset order.
+	cluster_array_t _clusters;
+	/// Maps a data group id to its [first cluster, cluster count] range.
+	std::map<std::uint32_t, std::pair<std::uint32_t, std::uint32_t>> _cluster_ranges;
 
 	// mesh properties
 	/// Does the mesh use a hardware vertex/index buffer?
@@ -1120,6 +1287,10 @@ protected:
 	/// Input data used for constructing the final mesh.
 	preparation_data _preparation_data;
 
+	/// Keeps the memory mapped container alive while the system buffers
+	/// alias it (null when the buffers are heap allocated).
+	std::shared_ptr<void> _backing;
+
 	// Skin binding information
 	/// Data that describes how the mesh should be bound as a skin with supplied
 	/// bone matrices.
@@ -1,6 +1,11 @@
 #include "mesh_tools.h"
 #include "core/math/math_includes.h"
 
+#include <algorithm>
+#include <array>
+#include <map>
+#include <queue>
+
 void convert_to_y_up(std::vector<math::vec3>& out_vertices)
 {
 	for(std::size_t i = 0; i < out_vertices.size(); ++i)
@@ -1808,3 +1813,270 @@ void triangle_mesh_tools::create_teapot(std::vector<math::vec3>& out_vertices,
 	if(y_up)
 		convert_to_y_up(out_vertices);
 }
+
+namespace
+{
+// Symmetric 4x4 error quadric stored as the 10 unique coefficients.
+using quadric_t = std::array<double, 10>;
+
+void quadric_add(quadric_t& q, const quadric_t& other)
+{
+	for(std::size_t i = 0; i < q.size(); ++i)
+		q[i] += other[i];
+}
+
+quadric_t quadric_from_plane(double a, double b, double c, double d, double weight)
+{
+	quadric_t q;
+	q[0] = a * a * weight;
+	q[1] = a * b * weight;
+	q[2] = a * c * weight;
+	q[3] = a * d * weight;
+	q[4] = b * b * weight;
+	q[5] = b * c * weight;
+	q[6] = b * d * weight;
+	q[7] = c * c * weight;
+	q[8] = c * d * weight;
+	q[9] = d * d * weight;
+	return q;
+}
+
+double quadric_evaluate(const quadric_t& q, const math::vec3& p)
+{
+	const double x = p.x;
+	const double y = p.y;
+	const double z = p.z;
+	return q[0] * x * x + 2.0 * q[1] * x * y + 2.0 * q[2] * x * z + 2.0 * q[3] * x + q[4] * y * y +
+		   2.0 * q[5] * y * z + 2.0 * q[6] * y + q[7] * z * z + 2.0 * q[8] * z + q[9];
+}
+
+struct collapse_candidate
+{
+	// error introduced by snapping 'from' onto 'to'
+	double cost = 0.0;
+	std::uint32_t from = 0;
+	std::uint32_t to = 0;
+	// versions the cost was computed against, for lazy heap invalidation
+	std::uint32_t from_version = 0;
+	std::uint32_t to_version = 0;
+};
+
+struct candidate_order
+{
+	bool operator()(const collapse_candidate& lhs, const collapse_candidate& rhs) const
+	{
+		return lhs.cost > rhs.cost;
+	}
+};
+}
+
+void triangle_mesh_tools::simplify(const std::vector<math::vec3>& vertices,
+								   const std::vector<std::uint32_t>& indices,
+								   std::size_t target_face_count, std::vector<std::uint32_t>& out_indices)
+{
+	out_indices.clear();
+	const std::size_t face_count = indices.size() / 3;
+	if(face_count <= target_face_count)
+	{
+		out_indices = indices;
+		return;
+	}
+
+	// Active face list and per vertex face adjacency.
+	std::vector<std::array<std::uint32_t, 3>> faces(face_count);
+	std::vector<bool> face_alive(face_count, true);
+	std::vector<std::vector<std::uint32_t>> vertex_faces(vertices.size());
+	for(std::size_t f = 0; f < face_count; ++f)
+	{
+		faces[f] = {{indices[f * 3], indices[f * 3 + 1], indices[f * 3 + 2]}};
+		for(auto index : faces[f])
+			vertex_faces[index].push_back(static_cast<std::uint32_t>(f));
+	}
+
+	auto face_normal = [&](std::uint32_t i0, std::uint32_t i1, std::uint32_t i2) {
+		return math::cross(vertices[i1] - vertices[i0], vertices[i2] - vertices[i0]);
+	};
+
+	// Accumulate the fundamental plane quadrics and count edge usage so
+	// boundary edges can be constrained.
+	std::vector<quadric_t> quadrics(vertices.size(), quadric_t{});
+	std::map<std::pair<std::uint32_t, std::uint32_t>, std::uint32_t> edge_faces;
+	for(std::size_t f = 0; f < face_count; ++f)
+	{
+		const auto& face = faces[f];
+		math::vec3 normal = face_normal(face[0], face[1], face[2]);
+		const float area_x2 = math::length(normal);
+		if(area_x2 > math::epsilon<float>())
+			normal /= area_x2;
+
+		const double d = -static_cast<double>(math::dot(normal, vertices[face[0]]));
+		// Weight by area so large faces dominate the error.
+		const auto q = quadric_from_plane(normal.x, normal.y, normal.z, d, area_x2 * 0.5);
+		for(auto index : face)
+			quadric_add(quadrics[index], q);
+
+		for(std::size_t e = 0; e < 3; ++e)
+		{
+			const auto v0 = face[e];
+			const auto v1 = face[(e + 1) % 3];
+			edge_faces[{std::min(v0, v1), std::max(v0, v1)}]++;
+		}
+	}
+
+	// Constrain boundary edges with a heavily weighted plane perpendicular
+	// to the face through the edge.
+	for(const auto& entry : edge_faces)
+	{
+		if(entry.second != 1)
+			continue;
+
+		const auto v0 = entry.first.first;
+		const auto v1 = entry.first.second;
+		for(auto f : vertex_faces[v0])
+		{
+			const auto& face = faces[f];
+			if(std::find(face.begin(), face.end(), v1) == face.end())
+				continue;
+
+			math::vec3 normal = face_normal(face[0], face[1], face[2]);
+			math::vec3 constraint = math::cross(vertices[v1] - vertices[v0], normal);
+			const float len = math::length(constraint);
+			if(len > math::epsilon<float>())
+			{
+				constraint /= len;
+				const double d = -static_cast<double>(math::dot(constraint, vertices[v0]));
+				const auto q =
+					quadric_from_plane(constraint.x, constraint.y, constraint.z, d, 1000.0);
+				quadric_add(quadrics[v0], q);
+				quadric_add(quadrics[v1], q);
+			}
+			break;
+		}
+	}
+
+	// Union-find over collapsed vertices. resolve() yields the vertex a
+	// collapsed one was ultimately snapped onto.
+	std::vector<std::uint32_t> parent(vertices.size());
+	for(std::uint32_t i = 0; i < parent.size(); ++i)
+		parent[i] = i;
+	auto resolve = [&parent](std::uint32_t v) {
+		while(parent[v] != v)
+		{
+			parent[v] = parent[parent[v]];
+			v = parent[v];
+		}
+		return v;
+	};
+
+	std::vector<std::uint32_t> versions(vertices.size(), 0);
+	std::priority_queue<collapse_candidate, std::vector<collapse_candidate>, candidate_order> heap;
+
+	auto push_candidates = [&](std::uint32_t from, std::uint32_t to) {
+		collapse_candidate candidate;
+		candidate.from = from;
+		candidate.to = to;
+		candidate.from_version = versions[from];
+		candidate.to_version = versions[to];
+		quadric_t combined = quadrics[from];
+		quadric_add(combined, quadrics[to]);
+		candidate.cost = quadric_evaluate(combined, vertices[to]);
+		heap.push(candidate);
+	};
+
+	for(const auto& entry : edge_faces)
+	{
+		push_candidates(entry.first.first, entry.first.second);
+		push_candidates(entry.first.second, entry.first.first);
+	}
+
+	std::size_t alive_count = face_count;
+	while(alive_count > target_face_count && !heap.empty())
+	{
+		const auto candidate = heap.top();
+		heap.pop();
+
+		const auto from = candidate.from;
+		const auto to = candidate.to;
+		if(resolve(from) != from || resolve(to) != to || from == to ||
+		   candidate.from_version != versions[from] || candidate.to_version != versions[to])
+			continue;
+
+		// Reject collapses that would flip any of the surviving faces.
+		bool flips = false;
+		for(auto f : vertex_faces[from])
+		{
+			if(!face_alive[f])
+				continue;
+			const auto& face = faces[f];
+			if(std::find(face.begin(), face.end(), to) != face.end())
+				continue;
+
+			std::array<std::uint32_t, 3> moved = face;
+			for(auto& index : moved)
+			{
+				if(index == from)
+					index = to;
+			}
+			const math::vec3 before = face_normal(face[0], face[1], face[2]);
+			const math::vec3 after = face_normal(moved[0], moved[1], moved[2]);
+			if(math::dot(before, after) <= 0.0f)
+			{
+				flips = true;
+				break;
+			}
+		}
+		if(flips)
+			continue;
+
+		// Perform the collapse.
+		parent[from] = to;
+		quadric_add(quadrics[to], quadrics[from]);
+		versions[to]++;
+
+		for(auto f : vertex_faces[from])
+		{
+			if(!face_alive[f])
+				continue;
+			auto& face = faces[f];
+			for(auto& index : face)
+			{
+				if(index == from)
+					index = to;
+			}
+			if(face[0] == face[1] || face[1] == face[2] || face[2] == face[0])
+			{
+				face_alive[f] = false;
+				alive_count--;
+			}
+			else
+			{
+				vertex_faces[to].push_back(f);
+			}
+		}
+		vertex_faces[from].clear();
+
+		// Refresh candidate costs around the surviving vertex.
+		for(auto f : vertex_faces[to])
+		{
+			if(!face_alive[f])
+				continue;
+			for(auto index : faces[f])
+			{
+				if(index != to)
+				{
+					push_candidates(index, to);
+					push_candidates(to, index);
+				}
+			}
+		}
+	}
+
+	out_indices.reserve(alive_count * 3);
+	for(std::size_t f = 0; f < face_count; ++f)
+	{
+		if(!face_alive[f])
+			continue;
+		for(auto index : faces[f])
+			out_indices.push_back(index);
+	}
+}
@@ -36,6 +36,15 @@ struct triangle_mesh_tools
 	static void create_teapot(std::vector<math::vec3>& out_vertices, std::vector<std::uint32_t>& out_indices,
 							  bool y_up = true);
 
+	// Simplifies the triangle list down to approximately target_face_count
+	// faces using iterative half-edge collapses ordered by quadric error.
+	// Collapses only ever snap a vertex onto one of its neighbours, so the
+	// caller's vertex buffer stays valid and only a new index list is
+	// produced. Boundary edges are penalized to keep open silhouettes and
+	// collapses that would flip a face are rejected.
+	static void simplify(const std::vector<math::vec3>& vertices, const std::vector<std::uint32_t>& indices,
+						 std::size_t target_face_count, std::vector<std::uint32_t>& out_indices);
+
 	template <typename VertexType>
 	static inline int add_vertex(std::vector<VertexType>& out_vertices, const VertexType& vert)
 	{
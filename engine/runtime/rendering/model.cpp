@@ -1,11 +1,23 @@
 #include "model.h"
 #include "../assets/asset_manager.h"
+#include "camera.h"
+#include "core/filesystem/filesystem.h"
 #include "core/math/math_includes.h"
 #include "core/system/subsystem.h"
 #include "gpu_program.h"
 #include "material.h"
 #include "mesh.h"
 
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+/// Sentinel for a palette that has not been uploaded to the renderer
+/// transform cache yet this frame.
+const std::uint32_t invalid_transform_cache = 0xFFFFFFFFu;
+}
+
 model::model()
 {
 	auto& am = core::get_subsystem<runtime::asset_manager>();
@@ -26,6 +38,14 @@ asset_handle<mesh> model::get_lod(std::uint32_t lod) const
 		if(lodMesh)
 			return lodMesh;
 
+		// Not resident yet - kick (or finish) its async load and serve the
+		// nearest resident level in the meantime.
+		stream_lod(lod);
+
+		lodMesh = _mesh_lods[lod];
+		if(lodMesh)
+			return lodMesh;
+
 		for(unsigned int i = lod; i < _mesh_lods.size(); ++i)
 		{
 			auto lodMesh = _mesh_lods[i];
@@ -55,6 +75,59 @@ void model::set_lod(asset_handle<mesh> mesh, std::uint32_t lod)
 	{
 		_materials.resize(mesh->get_subset_count(), _default_material);
 	}
+
+	// When the base level is assigned on its own, pick up any LOD chain the
+	// asset compiler generated alongside it ('<key>.lod1', '<key>.lod2'...).
+	// Only the keys are recorded here; the coarsest level is loaded up front
+	// (distant instances need it immediately and it is the smallest) while
+	// intermediate levels stream in on first request from get_lod().
+	if(lod == 0 && _mesh_lods.size() <= 1 && fs::has_known_protocol(mesh.id()))
+	{
+		for(std::uint32_t level = 1;; ++level)
+		{
+			const auto lod_key = mesh.id() + ".lod" + std::to_string(level);
+			const auto cache_key = fs::replace(lod_key, ":/data", ":/cache");
+			fs::error_code err;
+			if(!fs::exists(fs::resolve_protocol(cache_key).string() + ".asset", err))
+				break;
+
+			_mesh_lods.resize(level + 1);
+			_lod_keys.resize(level + 1);
+			_lod_keys[level] = lod_key;
+		}
+		if(_mesh_lods.size() > 1)
+		{
+			auto& am = core::get_subsystem<runtime::asset_manager>();
+			const auto coarsest = std::uint32_t(_mesh_lods.size() - 1);
+			_mesh_lods[coarsest] = am.load<::mesh>(_lod_keys[coarsest]).get();
+			recalulate_lod_limits();
+		}
+	}
+}
+
+void model::stream_lod(std::uint32_t lod) const
+{
+	if(lod >= _mesh_lods.size() || _mesh_lods[lod])
+		return;
+	if(lod >= _lod_keys.size() || _lod_keys[lod].empty())
+		return;
+
+	if(_lod_requests.size() < _mesh_lods.size())
+		_lod_requests.resize(_mesh_lods.size());
+
+	auto& request = _lod_requests[lod];
+	if(request.valid())
+	{
+		if(request.is_ready())
+		{
+			_mesh_lods[lod] = request.get();
+			request = {};
+		}
+		return;
+	}
+
+	auto& am = core::get_subsystem<runtime::asset_manager>();
+	request = am.load<::mesh>(_lod_keys[lod], runtime::load_mode::async);
 }
 
 void model::set_material(asset_handle<material> material, std::uint32_t index)
@@ -76,6 +149,8 @@ void model::set_lods(const std::vector<asset_handle<mesh>>& lods)
 	auto sz2 = _mesh_lods.size();
 
 	_mesh_lods = lods;
+	_lod_keys.clear();
+	_lod_requests.clear();
 
 	if(sz1 != sz2)
 		recalulate_lod_limits();
@@ -109,30 +184,56 @@ asset_handle<material> model::get_material_for_group(const size_t& group) const
 	return _materials[group];
 }
 
+bool model::has_transparency() const
+{
+	for(const auto& mat : _materials)
+	{
+		if(mat && mat->is_transparent())
+			return true;
+	}
+
+	return false;
+}
+
 void model::set_lod_limits(const std::vector<urange>& limits)
 {
 	_lod_limits = limits;
 }
 
-void model::render(gfx::view_id id, const math::transform& world_transform,
-				   const std::vector<math::transform>& bone_transforms, bool apply_cull, bool depth_write,
-				   bool depth_test, std::uint64_t extra_states, unsigned int lod, gpu_program* user_program,
-				   std::function<void(gpu_program&)> setup_params) const
+void model::render(gfx::view_id id, const math::transform& world_transform, skinning_data* skinning,
+				   bool apply_cull, bool depth_write, bool depth_test, std::uint64_t extra_states,
+				   unsigned int lod, gpu_program* user_program,
+				   std::function<void(gpu_program&)> setup_params,
+				   gfx::occlusion_query_handle occlusion_query /*= {gfx::invalid_handle}*/,
+				   const camera* cull_camera /*= nullptr*/,
+				   subset_filter filter /*= subset_filter::all*/) const
 {
 	const auto mesh = get_lod(lod);
 	if(!mesh)
 		return;
 
-	auto render_subset = [this, &mesh](gfx::view_id id, bool skinned, std::uint32_t group_id,
-									   const float* mtx, std::uint32_t count, bool apply_cull,
-									   bool depth_write, bool depth_test, std::uint64_t extra_states,
-									   gpu_program* user_program,
-									   std::function<void(gpu_program&)> setup_params) {
+	// bgfx allows one submission per query and frame; only the first subset
+	// carries it.
+	bool query_pending = occlusion_query.idx != gfx::invalid_handle;
+
+	auto render_subset = [this, &mesh, &occlusion_query, &query_pending,
+						  filter](gfx::view_id id, bool skinned, std::uint32_t group_id,
+									   const float* mtx, std::uint32_t count, std::uint32_t* cache_slot,
+									   bool apply_cull, bool depth_write, bool depth_test,
+									   std::uint64_t extra_states, gpu_program* user_program,
+									   std::function<void(gpu_program&)> setup_params,
+									   const std::vector<std::pair<std::uint32_t, std::uint32_t>>* ranges) {
 
 		bool valid_program = false;
 		gpu_program* program = user_program;
 		asset_handle<material> mat = get_material_for_group(group_id);
 
+		// Subsets of the wrong transparency class belong to another pass.
+		const bool transparent = mat && mat->is_transparent();
+		if((filter == subset_filter::opaque_only && transparent) ||
+		   (filter == subset_filter::transparent_only && !transparent))
+			return;
+
 		if(mat)
 		{
 			mat->skinned = skinned;
@@ -153,22 +254,62 @@ void model::render(gfx::view_id id, const math::transform& world_transform,
 		{
 			if(mat)
 			{
-				if(!user_program)
+				extra_states |= mat->get_render_states(apply_cull, depth_write, depth_test);
+			}
+
+			// When culled cluster ranges are provided the subset is drawn as
+			// one submission per visible run of faces; submit() discards all
+			// per draw state, so everything is re-issued for each range.
+			const bool ranged = ranges != nullptr && !ranges->empty();
+			const std::size_t draw_count = ranged ? ranges->size() : 1;
+			for(std::size_t draw = 0; draw < draw_count; ++draw)
+			{
+				if(draw > 0)
 				{
-					mat->submit();
+					setup_params(*program);
 				}
 
-				extra_states |= mat->get_render_states(apply_cull, depth_write, depth_test);
-			}
+				if(mat && !user_program)
+				{
+					mat->submit();
+				}
 
-			if(mtx != nullptr)
-				gfx::set_transform(mtx, static_cast<std::uint16_t>(count));
+				if(cache_slot != nullptr && *cache_slot != invalid_transform_cache)
+				{
+					// The transform already lives in this frame's cache;
+					// rebinding the entry costs nothing compared to
+					// re-uploading the matrix array for every submission.
+					gfx::set_transform(*cache_slot, static_cast<std::uint16_t>(count));
+				}
+				else if(mtx != nullptr)
+				{
+					const auto cache = gfx::set_transform(mtx, static_cast<std::uint16_t>(count));
+					if(cache_slot != nullptr)
+						*cache_slot = cache;
+				}
 
-			gfx::set_state(extra_states);
+				gfx::set_state(extra_states);
 
-			mesh->bind_render_buffers_for_subset(group_id);
+				if(ranged)
+				{
+					const auto& range = (*ranges)[draw];
+					mesh->bind_render_buffers_for_range(group_id, range.first, range.second);
+				}
+				else
+				{
+					mesh->bind_render_buffers_for_subset(group_id);
+				}
 
-			gfx::submit(id, program->native_handle());
+				if(query_pending)
+				{
+					query_pending = false;
+					gfx::submit(id, program->native_handle(), occlusion_query);
+				}
+				else
+				{
+					gfx::submit(id, program->native_handle());
+				}
+			}
 		}
 
 		if(program)
@@ -181,33 +322,275 @@ void model::render(gfx::view_id id, const math::transform& world_transform,
 	const auto& skin_data = mesh->get_skin_bind_data();
 
 	// Has skinning data?
-	if(skin_data.has_bones() && bone_transforms.empty() == false)
+	if(skin_data.has_bones() && skinning != nullptr && skinning->palettes.empty() == false)
 	{
-		// Process each palette in the skin with a matching attribute.
+		// Process each palette in the skin with a matching attribute. The
+		// matrices were resolved once this frame by the bone system; the first
+		// pass to draw them records their transform cache entries so every
+		// other pass can rebind instead of re-uploading.
 		const auto& palettes = mesh->get_bone_palettes();
-		for(const auto& palette : palettes)
+		const auto palette_count = std::min(palettes.size(), skinning->palettes.size());
+		if(skinning->transform_caches.size() != palette_count)
+			skinning->transform_caches.assign(palette_count, invalid_transform_cache);
+
+		for(std::size_t i = 0; i < palette_count; ++i)
 		{
-			// Apply the bone palette.
-			auto skinning_matrices = palette.get_skinning_matrices(bone_transforms, skin_data, false);
-			// auto max_blend_index = palette.get_maximum_blend_index();
+			auto& skinning_matrices = skinning->palettes[i];
+			if(skinning_matrices.empty())
+				continue;
 
-			auto data_group = palette.get_data_group();
+			auto data_group = palettes[i].get_data_group();
 			render_subset(id, true, data_group, reinterpret_cast<float*>(&skinning_matrices[0]),
-						  std::uint32_t(skinning_matrices.size()), apply_cull, depth_write, depth_test,
-						  extra_states, user_program, setup_params);
+						  std::uint32_t(skinning_matrices.size()), &skinning->transform_caches[i],
+						  apply_cull, depth_write, depth_test, extra_states, user_program, setup_params,
+						  nullptr);
 
 		} // Next Palette
 	}
 	else
 	{
+		// Cluster bounds describe the bind pose, so the fine grained culling
+		// only applies to rigid geometry.
+		const bool cluster_cull = cull_camera != nullptr && mesh->has_clusters();
+
+		// The world transform is shared by every subset (and range) of the
+		// mesh; upload it once and rebind the cache entry afterwards.
+		std::uint32_t world_cache = invalid_transform_cache;
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> visible_ranges;
 		for(std::size_t i = 0; i < mesh->get_subset_count(); ++i)
 		{
-			render_subset(id, false, std::uint32_t(i), world_transform, 1, apply_cull, depth_write,
-						  depth_test, extra_states, user_program, setup_params);
+			const std::vector<std::pair<std::uint32_t, std::uint32_t>>* ranges = nullptr;
+			if(cluster_cull)
+			{
+				visible_ranges.clear();
+				if(!mesh->get_visible_cluster_ranges(std::uint32_t(i), cull_camera->get_frustum(),
+													 world_transform, cull_camera->get_position(),
+													 visible_ranges))
+					continue;
+
+				ranges = &visible_ranges;
+			}
+
+			render_subset(id, false, std::uint32_t(i), world_transform, 1, &world_cache, apply_cull,
+						  depth_write, depth_test, extra_states, user_program, setup_params, ranges);
 		}
 	}
 }
 
+bool model::render_instanced(gfx::view_id id, const std::vector<math::transform>& world_transforms,
+							 bool apply_cull, bool depth_write, bool depth_test,
+							 std::uint64_t extra_states, unsigned int lod, gpu_program* user_program,
+							 std::function<void(gpu_program&)> setup_params) const
+{
+	const auto mesh = get_lod(lod);
+	if(!mesh)
+		return false;
+
+	// Bone palettes are per instance; skinned geometry keeps the per-draw path.
+	if(mesh->get_skin_bind_data().has_bones())
+		return false;
+
+	if((gfx::get_caps()->supported & BGFX_CAPS_INSTANCING) == 0)
+		return false;
+
+	const auto count = std::uint32_t(world_transforms.size());
+	if(count == 0)
+		return true;
+
+	const std::uint16_t instance_stride = sizeof(float) * 16;
+	const auto subset_count = std::uint32_t(mesh->get_subset_count());
+
+	// Probe up front so a failure cannot leave some subsets drawn instanced
+	// and the caller re-drawing all of them through the fallback.
+	if(gfx::get_avail_instance_data_buffer(count * subset_count, instance_stride) < count * subset_count)
+		return false;
+
+	if(!user_program)
+	{
+		for(std::uint32_t i = 0; i < subset_count; ++i)
+		{
+			asset_handle<material> mat = get_material_for_group(i);
+			if(!mat)
+				return false;
+
+			mat->skinned = false;
+			mat->instanced = true;
+			const bool usable = mat->get_program() != nullptr;
+			mat->instanced = false;
+			if(!usable)
+				return false;
+		}
+	}
+
+	for(std::uint32_t group_id = 0; group_id < subset_count; ++group_id)
+	{
+		bool valid_program = false;
+		gpu_program* program = user_program;
+		asset_handle<material> mat = get_material_for_group(group_id);
+
+		if(mat)
+		{
+			mat->skinned = false;
+			mat->instanced = true;
+			if(!user_program)
+			{
+				program = mat->get_program();
+			}
+		}
+
+		if(program)
+		{
+			valid_program = program->begin();
+			if(valid_program)
+				setup_params(*program);
+		}
+
+		if(valid_program)
+		{
+			auto states = extra_states;
+			if(mat)
+			{
+				if(!user_program)
+				{
+					mat->submit();
+				}
+
+				states |= mat->get_render_states(apply_cull, depth_write, depth_test);
+			}
+
+			gfx::instance_data_buffer idb;
+			gfx::alloc_instance_data_buffer(&idb, count, instance_stride);
+			std::memcpy(idb.data, world_transforms.data(), count * instance_stride);
+			gfx::set_instance_data_buffer(&idb);
+
+			gfx::set_state(states);
+
+			mesh->bind_render_buffers_for_subset(group_id);
+
+			gfx::submit(id, program->native_handle());
+		}
+
+		if(program)
+		{
+			program->end();
+		}
+
+		if(mat)
+		{
+			mat->instanced = false;
+		}
+	}
+
+	return true;
+}
+
+bool model::render_instanced_array(gfx::view_id id, const std::vector<math::transform>& world_transforms,
+								   const std::vector<const model*>& member_models, bool apply_cull,
+								   bool depth_write, bool depth_test, unsigned int lod,
+								   std::function<void(gpu_program&)> setup_params) const
+{
+	const auto mesh = get_lod(lod);
+	if(!mesh)
+		return false;
+
+	if(mesh->get_skin_bind_data().has_bones())
+		return false;
+
+	if((gfx::get_caps()->supported & BGFX_CAPS_INSTANCING) == 0)
+		return false;
+
+	const auto count = std::uint32_t(world_transforms.size());
+	if(count == 0 || member_models.size() != world_transforms.size())
+		return false;
+
+	// Matrix plus one vec4 of material set parameters (.x = array layer).
+	const std::uint16_t instance_stride = sizeof(float) * 20;
+	const auto subset_count = std::uint32_t(mesh->get_subset_count());
+
+	if(gfx::get_avail_instance_data_buffer(count * subset_count, instance_stride) < count * subset_count)
+		return false;
+
+	// Probe every subset of every member up front: all materials need a
+	// ready array slice and the array program, otherwise some subsets
+	// would draw merged and the rest per-draw on top of them.
+	for(std::uint32_t i = 0; i < subset_count; ++i)
+	{
+		asset_handle<material> mat = get_material_for_group(i);
+		if(!mat)
+			return false;
+
+		mat->skinned = false;
+		mat->instanced_array = true;
+		const bool usable = mat->get_program() != nullptr;
+		mat->instanced_array = false;
+		if(!usable)
+			return false;
+
+		for(const auto* member : member_models)
+		{
+			asset_handle<material> member_mat = member->get_material_for_group(i);
+			if(!member_mat)
+				return false;
+			const auto* slice = member_mat->get_texture_array_slice();
+			if(slice == nullptr || !slice->ready)
+				return false;
+		}
+	}
+
+	for(std::uint32_t group_id = 0; group_id < subset_count; ++group_id)
+	{
+		bool valid_program = false;
+		asset_handle<material> mat = get_material_for_group(group_id);
+
+		mat->skinned = false;
+		mat->instanced_array = true;
+
+		gpu_program* program = mat->get_program();
+		if(program)
+		{
+			valid_program = program->begin();
+			if(valid_program)
+				setup_params(*program);
+		}
+
+		if(valid_program)
+		{
+			mat->submit();
+
+			gfx::instance_data_buffer idb;
+			gfx::alloc_instance_data_buffer(&idb, count, instance_stride);
+			auto* data = reinterpret_cast<float*>(idb.data);
+			for(std::uint32_t i = 0; i < count; ++i)
+			{
+				std::memcpy(data, &world_transforms[i], sizeof(float) * 16);
+				asset_handle<material> member_mat = member_models[i]->get_material_for_group(group_id);
+				const auto* slice = member_mat->get_texture_array_slice();
+				data[16] = float(slice->layer);
+				data[17] = 0.0f;
+				data[18] = 0.0f;
+				data[19] = 0.0f;
+				data += 20;
+			}
+			gfx::set_instance_data_buffer(&idb);
+
+			gfx::set_state(mat->get_render_states(apply_cull, depth_write, depth_test));
+
+			mesh->bind_render_buffers_for_subset(group_id);
+
+			gfx::submit(id, program->native_handle());
+		}
+
+		if(program)
+		{
+			program->end();
+		}
+
+		mat->instanced_array = false;
+	}
+
+	return true;
+}
+
 void model::recalulate_lod_limits()
 {
 	float upper_limit = 100.0f;
@@ -2,6 +2,7 @@
 
 #include "../assets/asset_handle.h"
 #include "core/common/basetypes.hpp"
+#include "core/tasks/task_system.h"
 #include "core/graphics/graphics.h"
 #include "core/math/math_includes.h"
 #include "core/reflection/registration.h"
@@ -11,6 +12,26 @@
 class gpu_program;
 class mesh;
 class material;
+class camera;
+
+//-----------------------------------------------------------------------------
+//  Name : skinning_data (Struct)
+/// <summary>
+/// Per entity skinning state shared by every pass in a frame. The bone
+/// system resolves the final palette matrices once per frame; the render
+/// path uploads each palette to the renderer transform cache on first use
+/// and every later pass (shadow, reflection, camera) rebinds the cached
+/// copy instead of recomputing and re-uploading it.
+/// </summary>
+//-----------------------------------------------------------------------------
+struct skinning_data
+{
+	/// Final skinning matrices for each bone palette of the mesh.
+	std::vector<std::vector<math::transform>> palettes;
+	/// Transform cache entry per palette. Only valid for the frame the
+	/// palettes were uploaded on; cleared whenever 'palettes' is rewritten.
+	std::vector<std::uint32_t> transform_caches;
+};
 
 //-----------------------------------------------------------------------------
 //  Name : model (Class)
@@ -178,22 +199,100 @@ public:
 	/// <summary>
 	/// Draws a mesh with a given program. If program is nullptr then the
 	/// materials are used instead. Extra states can be added to the material
-	/// ones.
+	/// ones. Skinned geometry reads its palette matrices from 'skinning'
+	/// (resolved once per frame by the bone system) and reuses the transform
+	/// cache entries recorded there across passes; pass nullptr or empty
+	/// palettes to draw the mesh rigidly. When 'cull_camera' is provided,
+	/// rigid meshes with cluster data drop the triangle clusters that fall
+	/// outside its frustum or face away from it, submitting only the visible
+	/// index ranges of each subset.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	/// Restricts render() to a transparency class of the model's subsets;
+	/// the g-buffer fill draws opaque_only and the sorted transparency
+	/// pass draws transparent_only.
+	enum class subset_filter
+	{
+		all,
+		opaque_only,
+		transparent_only
+	};
+
+	void render(gfx::view_id id, const math::transform& world_transform, skinning_data* skinning,
+				bool apply_cull, bool depth_write, bool depth_test, std::uint64_t extra_states,
+				unsigned int lod, gpu_program* user_program, std::function<void(gpu_program&)> setup_params,
+				gfx::occlusion_query_handle occlusion_query = {gfx::invalid_handle},
+				const camera* cull_camera = nullptr, subset_filter filter = subset_filter::all) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : has_transparency ()
+	/// <summary>
+	/// True when any of the model's materials is transparent.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool has_transparency() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : render_instanced ()
+	/// <summary>
+	/// Draws the mesh once per subset with all given world transforms packed
+	/// into an instance data buffer. Returns false when the instanced path is
+	/// unavailable (skinned mesh, no renderer instancing support, material
+	/// without an instanced program or transient buffer exhaustion); callers
+	/// are expected to fall back to per-draw render() in that case.
 	/// </summary>
 	//-----------------------------------------------------------------------------
-	void render(gfx::view_id id, const math::transform& world_transform,
-				const std::vector<math::transform>& bone_transforms, bool apply_cull, bool depth_write,
-				bool depth_test, std::uint64_t extra_states, unsigned int lod, gpu_program* user_program,
-				std::function<void(gpu_program&)> setup_params) const;
+	bool render_instanced(gfx::view_id id, const std::vector<math::transform>& world_transforms,
+						  bool apply_cull, bool depth_write, bool depth_test, std::uint64_t extra_states,
+						  unsigned int lod, gpu_program* user_program,
+						  std::function<void(gpu_program&)> setup_params) const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : render_instanced_array ()
+	/// <summary>
+	/// Instanced draw merged ACROSS materials: every member model must use
+	/// materials that share this model's texture array sets and shading
+	/// hashes per subset (the caller's batch key guarantees it). Instance
+	/// data carries each member's transform plus its material set's array
+	/// layer, so one submission covers draws that previously broke on
+	/// sampler rebinds. Returns false when the array path is unavailable;
+	/// callers fall back to per-draw submission.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool render_instanced_array(gfx::view_id id, const std::vector<math::transform>& world_transforms,
+								const std::vector<const model*>& member_models, bool apply_cull,
+								bool depth_write, bool depth_test, unsigned int lod,
+								std::function<void(gpu_program&)> setup_params) const;
 
 private:
 	void recalulate_lod_limits();
+
+	//-----------------------------------------------------------------------------
+	//  Name : stream_lod ()
+	/// <summary>
+	/// Kicks (or completes) an async load for a discovered LOD chain level
+	/// that is not resident yet. Called from get_lod() so finer levels are
+	/// only fetched when a camera actually targets them; until the load
+	/// finishes, get_lod()'s fallback keeps serving the nearest resident
+	/// mesh. Const because the renderer only reaches the model through
+	/// const accessors - residency is a cache, not model state.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void stream_lod(std::uint32_t lod) const;
+
 	/// Collection of all materials for this model.
 	std::vector<asset_handle<material>> _materials;
 	/// Default material
 	asset_handle<material> _default_material;
-	/// Collection of all lods for this model.
-	std::vector<asset_handle<mesh>> _mesh_lods;
+	/// Collection of all lods for this model. Chain levels discovered next
+	/// to the base mesh stream in on demand, so entries may be empty until
+	/// first requested.
+	mutable std::vector<asset_handle<mesh>> _mesh_lods;
+	/// Asset key per LOD level for the streamable chain levels; empty for
+	/// levels assigned directly.
+	std::vector<std::string> _lod_keys;
+	/// In-flight async loads per LOD level.
+	mutable std::vector<core::task_future<asset_handle<mesh>>> _lod_requests;
 	///
 	std::vector<urange> _lod_limits;
 	/// Duration for a transition between two lods.
@@ -0,0 +1,137 @@
+#include "primitives.h"
+#include "../assets/asset_manager.h"
+#include "core/system/subsystem.h"
+
+#include <cstring>
+#include <initializer_list>
+#include <sstream>
+
+namespace primitives
+{
+namespace
+{
+//-----------------------------------------------------------------------------
+//  Name : bits () (Local)
+/// <summary>
+/// Raw bit pattern of a float, so cache keys distinguish parameters that
+/// would round to the same decimal representation.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::uint32_t bits(float value)
+{
+	std::uint32_t result = 0;
+	std::memcpy(&result, &value, sizeof(result));
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : make_key () (Local)
+/// <summary>
+/// Builds the asset key identifying one exact parameterization of a
+/// procedural shape. The vertex format hash participates so the same
+/// shape requested with different layouts is cached separately.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::string make_key(const char* shape, const gfx::vertex_layout& format,
+					 std::initializer_list<std::uint32_t> params)
+{
+	std::ostringstream key;
+	key << "embedded:/" << shape << '?' << std::hex << format.m_hash;
+	for(auto param : params)
+		key << '/' << param;
+	return key.str();
+}
+
+//-----------------------------------------------------------------------------
+//  Name : get_or_create () (Local)
+/// <summary>
+/// Resolves the key against the asset manager, building and registering
+/// the mesh instance only when no matching entry exists yet.
+/// </summary>
+//-----------------------------------------------------------------------------
+template <typename create_t>
+asset_handle<mesh> get_or_create(const std::string& key, const create_t& create)
+{
+	auto& am = core::get_subsystem<runtime::asset_manager>();
+	auto existing = am.find_asset_entry<mesh>(key);
+	if(existing.valid())
+		return existing.get();
+
+	auto instance = std::make_shared<mesh>();
+	create(*instance);
+	return am.load_asset_from_instance(key, instance).get();
+}
+}
+
+asset_handle<mesh> get_cube(const gfx::vertex_layout& format, float width, float height, float depth,
+							std::uint32_t width_segments, std::uint32_t height_segments,
+							std::uint32_t depth_segments, bool inverted, mesh_create_origin origin)
+{
+	const auto key =
+		make_key("cube", format,
+				 {bits(width), bits(height), bits(depth), width_segments, height_segments, depth_segments,
+				  inverted ? 1u : 0u, static_cast<std::uint32_t>(origin)});
+	return get_or_create(key, [&](mesh& instance) {
+		instance.create_cube(format, width, height, depth, width_segments, height_segments, depth_segments,
+							 inverted, origin);
+	});
+}
+
+asset_handle<mesh> get_sphere(const gfx::vertex_layout& format, float radius, std::uint32_t stacks,
+							  std::uint32_t slices, bool inverted, mesh_create_origin origin)
+{
+	const auto key = make_key(
+		"sphere", format, {bits(radius), stacks, slices, inverted ? 1u : 0u, static_cast<std::uint32_t>(origin)});
+	return get_or_create(key, [&](mesh& instance) {
+		instance.create_sphere(format, radius, stacks, slices, inverted, origin);
+	});
+}
+
+asset_handle<mesh> get_cylinder(const gfx::vertex_layout& format, float radius, float height,
+								std::uint32_t stacks, std::uint32_t slices, bool inverted,
+								mesh_create_origin origin)
+{
+	const auto key = make_key("cylinder", format,
+							  {bits(radius), bits(height), stacks, slices, inverted ? 1u : 0u,
+							   static_cast<std::uint32_t>(origin)});
+	return get_or_create(key, [&](mesh& instance) {
+		instance.create_cylinder(format, radius, height, stacks, slices, inverted, origin);
+	});
+}
+
+asset_handle<mesh> get_capsule(const gfx::vertex_layout& format, float radius, float height,
+							   std::uint32_t stacks, std::uint32_t slices, bool inverted,
+							   mesh_create_origin origin)
+{
+	const auto key = make_key("capsule", format,
+							  {bits(radius), bits(height), stacks, slices, inverted ? 1u : 0u,
+							   static_cast<std::uint32_t>(origin)});
+	return get_or_create(key, [&](mesh& instance) {
+		instance.create_capsule(format, radius, height, stacks, slices, inverted, origin);
+	});
+}
+
+asset_handle<mesh> get_cone(const gfx::vertex_layout& format, float radius, float radius_tip, float height,
+							std::uint32_t stacks, std::uint32_t slices, bool inverted,
+							mesh_create_origin origin)
+{
+	const auto key = make_key("cone", format,
+							  {bits(radius), bits(radius_tip), bits(height), stacks, slices,
+							   inverted ? 1u : 0u, static_cast<std::uint32_t>(origin)});
+	return get_or_create(key, [&](mesh& instance) {
+		instance.create_cone(format, radius, radius_tip, height, stacks, slices, inverted, origin);
+	});
+}
+
+asset_handle<mesh> get_torus(const gfx::vertex_layout& format, float outer_radius, float inner_radius,
+							 std::uint32_t bands, std::uint32_t sides, bool inverted,
+							 mesh_create_origin origin)
+{
+	const auto key = make_key("torus", format,
+							  {bits(outer_radius), bits(inner_radius), bands, sides, inverted ? 1u : 0u,
+							   static_cast<std::uint32_t>(origin)});
+	return get_or_create(key, [&](mesh& instance) {
+		instance.create_torus(format, outer_radius, inner_radius, bands, sides, inverted, origin);
+	});
+}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "../assets/asset_handle.h"
+#include "mesh.h"
+
+//-----------------------------------------------------------------------------
+// Parameter keyed cache over the procedural mesh builders. Identical
+// requests resolve to the same immutable mesh instance registered with the
+// asset manager, so repeat callers (gizmos, debug visuals, editing tools)
+// share the vertex / index buffers instead of rebuilding them per request.
+// The returned handles are refcounted like any other asset.
+//-----------------------------------------------------------------------------
+namespace primitives
+{
+//-----------------------------------------------------------------------------
+//  Name : get_cube ()
+/// <summary>
+/// Returns the shared cube mesh built with the specified parameters,
+/// creating and caching it on first request.
+/// </summary>
+//-----------------------------------------------------------------------------
+asset_handle<mesh> get_cube(const gfx::vertex_layout& format, float width, float height, float depth,
+							std::uint32_t width_segments, std::uint32_t height_segments,
+							std::uint32_t depth_segments, bool inverted, mesh_create_origin origin);
+
+//-----------------------------------------------------------------------------
+//  Name : get_sphere ()
+/// <summary>
+/// Returns the shared sphere mesh built with the specified parameters,
+/// creating and caching it on first request.
+/// </summary>
+//-----------------------------------------------------------------------------
+asset_handle<mesh> get_sphere(const gfx::vertex_layout& format, float radius, std::uint32_t stacks,
+							  std::uint32_t slices, bool inverted, mesh_create_origin origin);
+
+//-----------------------------------------------------------------------------
+//  Name : get_cylinder ()
+/// <summary>
+/// Returns the shared cylinder mesh built with the specified parameters,
+/// creating and caching it on first request.
+/// </summary>
+//-----------------------------------------------------------------------------
+asset_handle<mesh> get_cylinder(const gfx::vertex_layout& format, float radius, float height,
+								std::uint32_t stacks, std::uint32_t slices, bool inverted,
+								mesh_create_origin origin);
+
+//-----------------------------------------------------------------------------
+//  Name : get_capsule ()
+/// <summary>
+/// Returns the shared capsule mesh built with the specified parameters,
+/// creating and caching it on first request.
+/// </summary>
+//-----------------------------------------------------------------------------
+asset_handle<mesh> get_capsule(const gfx::vertex_layout& format, float radius, float height,
+							   std::uint32_t stacks, std::uint32_t slices, bool inverted,
+							   mesh_create_origin origin);
+
+//-----------------------------------------------------------------------------
+//  Name : get_cone ()
+/// <summary>
+/// Returns the shared cone mesh built with the specified parameters,
+/// creating and caching it on first request.
+/// </summary>
+//-----------------------------------------------------------------------------
+asset_handle<mesh> get_cone(const gfx::vertex_layout& format, float radius, float radius_tip, float height,
+							std::uint32_t stacks, std::uint32_t slices, bool inverted,
+							mesh_create_origin origin);
+
+//-----------------------------------------------------------------------------
+//  Name : get_torus ()
+/// <summary>
+/// Returns the shared torus mesh built with the specified parameters,
+/// creating and caching it on first request.
+/// </summary>
+//-----------------------------------------------------------------------------
+asset_handle<mesh> get_torus(const gfx::vertex_layout& format, float outer_radius, float inner_radius,
+							 std::uint32_t bands, std::uint32_t sides, bool inverted,
+							 mesh_create_origin origin);
+}
@@ -0,0 +1,40 @@
+#include "render_graph.h"
+
+#include <algorithm>
+
+void render_graph::add_pass(pass_desc desc)
+{
+	_passes.push_back(std::move(desc));
+}
+
+void render_graph::execute(const std::vector<std::string>& required_outputs)
+{
+	// Walk the passes in reverse declaration order: a pass is live when any
+	// of its outputs is needed, and a live pass needs all of its inputs.
+	std::vector<std::string> needed = required_outputs;
+	std::vector<bool> live(_passes.size(), false);
+	for(std::size_t i = _passes.size(); i > 0; --i)
+	{
+		const auto& pass = _passes[i - 1];
+		const bool any_needed =
+			std::any_of(std::begin(pass.outputs), std::end(pass.outputs), [&needed](const std::string& out) {
+				return std::find(std::begin(needed), std::end(needed), out) != std::end(needed);
+			});
+		if(!any_needed)
+			continue;
+
+		live[i - 1] = true;
+		needed.insert(std::end(needed), std::begin(pass.inputs), std::end(pass.inputs));
+	}
+
+	for(std::size_t i = 0; i < _passes.size(); ++i)
+	{
+		if(live[i] && _passes[i].on_execute)
+			_passes[i].on_execute();
+	}
+}
+
+void render_graph::clear()
+{
+	_passes.clear();
+}
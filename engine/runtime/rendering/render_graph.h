@@ -0,0 +1,62 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//  Name : render_graph (Class)
+/// <summary>
+/// Declarative frame composition. Passes register the resources they consume
+/// and produce; execution walks backwards from the requested outputs so
+/// passes whose products nobody asks for are culled before they run. Since
+/// render targets are allocated lazily inside each pass (through
+/// render_view), a culled pass also never pays for its targets. Transient
+/// target aliasing itself stays with render_view's keyed pools.
+/// </summary>
+//-----------------------------------------------------------------------------
+class render_graph
+{
+public:
+	struct pass_desc
+	{
+		/// pass name, for tooling and logging
+		std::string name;
+		/// resources this pass consumes (outputs of earlier passes)
+		std::vector<std::string> inputs;
+		/// resources this pass produces
+		std::vector<std::string> outputs;
+		/// records the pass; invoked only when the pass is live
+		std::function<void()> on_execute;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : add_pass ()
+	/// <summary>
+	/// Appends a pass. Declaration order is submission order for the passes
+	/// that survive culling.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void add_pass(pass_desc desc);
+
+	//-----------------------------------------------------------------------------
+	//  Name : execute ()
+	/// <summary>
+	/// Marks every pass reachable from the required outputs live and runs the
+	/// live ones in declaration order. Dead passes are skipped entirely.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void execute(const std::vector<std::string>& required_outputs);
+
+	//-----------------------------------------------------------------------------
+	//  Name : clear ()
+	/// <summary>
+	/// Drops all declared passes; the graph is rebuilt every frame.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void clear();
+
+private:
+	/// declared passes in declaration order
+	std::vector<pass_desc> _passes;
+};
@@ -7,7 +7,32 @@ static std::uint32_t s_next_id = 0;
 
 void render_window::on_resize()
 {
-	prepare_surface();
+	// Deferred to process_pending_resize - recreating the surface for
+	// every intermediate size of a drag-resize causes seconds of thrash.
+	_pending_surface_size = get_size();
+	_resize_settle_countdown = resize_settle_frames;
+}
+
+void render_window::process_pending_resize()
+{
+	if(_resize_settle_countdown == 0)
+	{
+		return;
+	}
+
+	const auto size = get_size();
+	if(size != _pending_surface_size)
+	{
+		// still moving - restart the settle window
+		_pending_surface_size = size;
+		_resize_settle_countdown = resize_settle_frames;
+		return;
+	}
+
+	if(--_resize_settle_countdown == 0)
+	{
+		prepare_surface();
+	}
 }
 
 render_window::render_window()
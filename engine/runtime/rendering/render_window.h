@@ -5,6 +5,7 @@
 ////////////////////////////////////////////////////////////
 #include "core/graphics/render_pass.h"
 #include "mml/window/window.hpp"
+#include <array>
 #include <memory>
 
 class render_window : public mml::window
@@ -58,6 +59,17 @@ public:
 	//-----------------------------------------------------------------------------
 	std::uint32_t get_id() const;
 
+	//-----------------------------------------------------------------------------
+	//  Name : process_pending_resize ()
+	/// <summary>
+	/// Per-frame tick of the resize debounce. The surface is recreated
+	/// only once the window size has held steady for a few frames; until
+	/// then the old-size surface keeps presenting (the OS stretches it),
+	/// so a drag-resize does not reallocate per intermediate size.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void process_pending_resize();
+
 protected:
 	//-----------------------------------------------------------------------------
 	//  Name : prepare_surface (virtual )
@@ -88,4 +100,10 @@ protected:
 	std::uint32_t _id = 0;
 	/// Render surface for this window.
 	std::shared_ptr<gfx::frame_buffer> _surface;
+	/// frames the size must hold steady before the surface is recreated
+	static const std::uint32_t resize_settle_frames = 8;
+	/// size the debounce is waiting on
+	std::array<std::uint32_t, 2> _pending_surface_size{{0, 0}};
+	/// frames left before the pending size is considered settled
+	std::uint32_t _resize_settle_countdown = 0;
 };
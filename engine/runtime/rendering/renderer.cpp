@@ -1,12 +1,17 @@
 #include "renderer.h"
+#include "../assets/impl/upload_queue.h"
 #include "../system/events.h"
 #include "core/common/assert.hpp"
+#include "core/common/platform.h"
+#include "core/system/subsystem.h"
+#include "core/filesystem/filesystem.h"
 #include "core/graphics/graphics.h"
 #include "core/graphics/render_pass.h"
 #include "core/logging/logging.h"
 #include "core/string_utils/string_utils.h"
 #include <algorithm>
 #include <cstdarg>
+#include <future>
 
 namespace runtime
 {
@@ -20,6 +25,11 @@ renderer::renderer(cmd_line::parser& parser)
 		return;
 	}
 
+	if(_headless)
+	{
+		return;
+	}
+
 	mml::video_mode desktop = mml::video_mode::get_desktop_mode();
 	desktop.width = 1280;
 	desktop.height = 720;
@@ -27,15 +37,51 @@ renderer::renderer(cmd_line::parser& parser)
 	window->request_focus();
 	register_window(std::move(window));
 	process_pending_windows();
+
+	bool use_pump_thread = false;
+	parser.try_get("pump-thread", use_pump_thread);
+#if $on($windows)
+	if(use_pump_thread)
+	{
+		// The OS delivers window messages only to the thread that created
+		// the window; a detached pump here would simply never see them.
+		// Fixing that means creating windows on the pump thread, which is a
+		// larger change than flipping where poll_event runs.
+		APPLOG_WARNING("Threaded event pump is unavailable on this platform; pumping inline.");
+		use_pump_thread = false;
+	}
+#endif
+	if(use_pump_thread)
+	{
+		_event_pump_thread = std::thread([this]() { pump_events(); });
+		platform::set_thread_name(_event_pump_thread, "event_pump");
+		APPLOG_INFO("Window event pump moved to a dedicated thread.");
+	}
 }
 
 renderer::~renderer()
 {
 	on_platform_events.disconnect(this, &renderer::platform_events);
 	on_frame_end.disconnect(this, &renderer::frame_end);
+
+	// stop the pump before the windows it sweeps go away
+	_event_pump_exit = true;
+	if(_event_pump_thread.joinable())
+	{
+		_event_pump_thread.join();
+	}
+
 	_windows.clear();
 	_windows_pending_addition.clear();
+
+	// shutdown blocks until the render thread consumes the remaining
+	// frames and render_frame returns Exiting, so join afterwards
 	gfx::shutdown();
+	_render_thread_exit = true;
+	if(_render_thread.joinable())
+	{
+		_render_thread.join();
+	}
 }
 
 render_window* renderer::get_focused_window() const
@@ -107,11 +153,69 @@ void renderer::show_all_secondary_windows()
 
 void renderer::process_pending_windows()
 {
+	std::lock_guard<std::mutex> window_lock(_window_mutex);
 	std::move(std::begin(_windows_pending_addition), std::end(_windows_pending_addition),
 			  std::back_inserter(_windows));
     _windows_pending_addition.clear();
 }
 
+void renderer::pump_events()
+{
+	using namespace std::literals;
+
+	while(!_event_pump_exit)
+	{
+		{
+			std::lock_guard<std::mutex> window_lock(_window_mutex);
+
+			std::uint32_t focused_id = 0;
+			std::map<std::uint32_t, std::vector<mml::platform_event>> collected;
+			for(const auto& window : _windows)
+			{
+				const auto id = window->get_id();
+				mml::platform_event e;
+				while(window->poll_event(e))
+				{
+					collected[id].emplace_back(std::move(e));
+				}
+
+				if(window->has_focus())
+				{
+					focused_id = id;
+				}
+			}
+
+			if(!collected.empty())
+			{
+				std::lock_guard<std::mutex> pumped_lock(_pumped_mutex);
+				for(auto& batch : collected)
+				{
+					auto& staged = _pumped_events[batch.first];
+					std::move(std::begin(batch.second), std::end(batch.second),
+							  std::back_inserter(staged));
+				}
+			}
+			_pumped_focused_id = focused_id;
+		}
+
+		// Far above any frame rate, far below the syscall rate an inline
+		// pump pays. OS dialogs and drags block only this thread now.
+		std::this_thread::sleep_for(2ms);
+	}
+}
+
+std::map<std::uint32_t, std::vector<mml::platform_event>>
+renderer::poll_pumped_events(std::uint32_t& focused_id)
+{
+	std::map<std::uint32_t, std::vector<mml::platform_event>> collected;
+	{
+		std::lock_guard<std::mutex> pumped_lock(_pumped_mutex);
+		collected.swap(_pumped_events);
+	}
+	focused_id = _pumped_focused_id;
+	return collected;
+}
+
 void renderer::platform_events(const std::pair<std::uint32_t, bool>& info,
 							   const std::vector<mml::platform_event>& events)
 {
@@ -119,6 +223,7 @@ void renderer::platform_events(const std::pair<std::uint32_t, bool>& info,
 	{
 		if(e.type == mml::platform_event::closed)
 		{
+			std::lock_guard<std::mutex> window_lock(_window_mutex);
 			_windows.erase(std::remove_if(std::begin(_windows), std::end(_windows),
 										  [window_id = info.first](const auto& window) {
 											  return window->get_id() == window_id;
@@ -131,6 +236,23 @@ void renderer::platform_events(const std::pair<std::uint32_t, bool>& info,
 
 bool renderer::init_backend(cmd_line::parser& parser)
 {
+	parser.try_get("headless", _headless);
+	if(_headless)
+	{
+		// Build-farm nodes have no GPU and no display. bgfx's Noop
+		// backend is a complete null implementation of the graphics API -
+		// every handle creates, every submit is accepted and dropped - so
+		// asset cooking and ECS-level work run unmodified without a
+		// window or platform data.
+		if(!gfx::init(gfx::renderer_type::Noop))
+		{
+			APPLOG_ERROR("Could not initialize null rendering backend!");
+			return false;
+		}
+
+		APPLOG_INFO("Running headless on the null rendering backend.");
+		return true;
+	}
 
 	mml::video_mode desktop = mml::video_mode::get_desktop_mode();
 	desktop.width = 100;
@@ -148,6 +270,29 @@ bool renderer::init_backend(cmd_line::parser& parser)
 
 	gfx::set_platform_data(pd);
 
+	bool use_render_thread = false;
+	parser.try_get("render-thread", use_render_thread);
+	if(use_render_thread)
+	{
+		// Claim backend processing for a dedicated submission thread. The
+		// first render_frame call must land before init - it marks its
+		// caller as the render thread - so init waits until the thread
+		// reports it has claimed the role. Each frame() call afterwards
+		// hands the thread a snapshot of the submitted commands and
+		// returns, instead of processing the backend inline.
+		std::promise<void> claimed;
+		_render_thread = std::thread([this, &claimed]() {
+			auto status = gfx::render_frame();
+			claimed.set_value();
+			while(status != gfx::render_frame_result::Exiting && !_render_thread_exit)
+			{
+				status = gfx::render_frame();
+			}
+		});
+		claimed.get_future().wait();
+		APPLOG_INFO("Backend processing moved to a dedicated render thread.");
+	}
+
 	// auto detect
 	auto preferred_renderer_type = gfx::renderer_type::Count;
 
@@ -172,11 +317,23 @@ bool renderer::init_backend(cmd_line::parser& parser)
 		}
 	}
 
+	// Persist backend shader/program binaries next to the compiled shader
+	// cache so repeat runs skip the first-use compile hitch per program.
+	fs::error_code err;
+	const auto binary_cache_dir = fs::resolve_protocol("engine:/cache/programs");
+	fs::create_directory(binary_cache_dir, err);
+	gfx::set_callback_cache_directory(binary_cache_dir.string());
+
 	if(!gfx::init(preferred_renderer_type))
 	{
 		APPLOG_ERROR("Could not initialize rendering backend!");
 		return false;
 	}
+
+#if defined(BGFX_DEBUG_PROFILER)
+	// per-view timer queries only run with the profiler debug flag on
+	gfx::set_debug(BGFX_DEBUG_PROFILER);
+#endif
 	if(gfx::get_renderer_type() == gfx::renderer_type::Direct3D9)
 	{
 		APPLOG_ERROR("Does not support dx9. Minimum supported is dx11.");
@@ -198,12 +355,29 @@ bool renderer::init_backend(cmd_line::parser& parser)
 
 void renderer::frame_end(std::chrono::duration<float>)
 {
+	// Hand staged asset uploads their slice of the frame before kicking
+	// it, so streaming costs a bounded amount every frame.
+	if(core::has_subsystems<upload_queue>())
+	{
+		core::get_subsystem<upload_queue>().drain();
+	}
+
+	// tick resize debounces; a settled size recreates its surface here,
+	// before the frame that will draw into it
+	for(const auto& window : _windows)
+	{
+		window->process_pending_resize();
+	}
+
 	gfx::render_pass pass("init_bb_update");
 	pass.bind();
 	pass.clear();
 
 	_render_frame = gfx::frame();
 
+	// pick up whichever per-view timer queries resolved this frame
+	gfx::render_pass::gather_gpu_timings();
+
 	gfx::render_pass::reset();
 }
 }
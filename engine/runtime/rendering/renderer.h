@@ -2,7 +2,11 @@
 
 #include "core/cmd_line/parser.hpp"
 #include "render_window.h"
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace runtime
@@ -79,12 +83,86 @@ struct renderer
 	render_window* get_focused_window() const;
 	void process_pending_windows();
 
+	//-----------------------------------------------------------------------------
+	//  Name : is_headless ()
+	/// <summary>
+	/// True when the renderer was brought up on the null backend without
+	/// a window - batch cooking and tests on machines with no GPU or
+	/// display. The embedder owns the application lifetime; the usual
+	/// all-windows-closed quit does not apply.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline bool is_headless() const
+	{
+		return _headless;
+	}
+
 	void platform_events(const std::pair<std::uint32_t, bool>& info,
 						 const std::vector<mml::platform_event>& events);
 
+	//-----------------------------------------------------------------------------
+	//  Name : is_event_pump_threaded ()
+	/// <summary>
+	/// True when window events are pumped continuously on a dedicated
+	/// thread. The main loop then consumes snapshots via
+	/// poll_pumped_events instead of making the pump syscalls itself.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline bool is_event_pump_threaded() const
+	{
+		return _event_pump_thread.joinable();
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : poll_pumped_events ()
+	/// <summary>
+	/// Drains everything the pump thread collected since the last call,
+	/// grouped per window, and reports which window held focus.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::map<std::uint32_t, std::vector<mml::platform_event>>
+	poll_pumped_events(std::uint32_t& focused_id);
+
 protected:
+	//-----------------------------------------------------------------------------
+	//  Name : pump_events ()
+	/// <summary>
+	/// Body of the event pump thread: sweeps every window's OS queue at a
+	/// fixed cadence and stages the results for the main loop.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void pump_events();
+
 	std::uint32_t _render_frame = 0;
 
+	/// Dedicated submission thread pumping the backend when the
+	/// render-thread mode is on. frame() then only snapshots the frame's
+	/// commands and kicks this thread, so simulation for frame N+1
+	/// overlaps backend work for frame N.
+	std::thread _render_thread;
+
+	/// Fallback exit signal for the submission thread, for the case where
+	/// the backend never initialized and Exiting would never come back.
+	std::atomic<bool> _render_thread_exit{false};
+
+	/// Running on the null backend without any window.
+	bool _headless = false;
+
+	/// Dedicated window event pump, when the pump-thread mode is on.
+	std::thread _event_pump_thread;
+	/// Exit signal for the pump thread.
+	std::atomic<bool> _event_pump_exit{false};
+	/// Serializes the pump thread's window sweep against main-thread
+	/// changes to the window list. Main-thread readers need no lock - the
+	/// list only mutates on the main thread.
+	mutable std::mutex _window_mutex;
+	/// Guards the staged event batches below.
+	std::mutex _pumped_mutex;
+	/// Events collected by the pump thread, per window, awaiting pickup.
+	std::map<std::uint32_t, std::vector<mml::platform_event>> _pumped_events;
+	/// Focused window as of the pump thread's latest sweep.
+	std::atomic<std::uint32_t> _pumped_focused_id{0};
+
 	/// engine windows
 	std::unique_ptr<mml::window> _init_window;
 	std::vector<std::unique_ptr<render_window>> _windows;
@@ -0,0 +1,179 @@
+#include "texture_array_pool.h"
+#include "core/graphics/render_pass.h"
+#include "core/graphics/texture.h"
+
+#include <algorithm>
+
+namespace runtime
+{
+namespace
+{
+//-----------------------------------------------------------------------------
+//  Name : hash_combine ()
+/// <summary>
+/// Folds a value into a running 64-bit hash.
+/// </summary>
+//-----------------------------------------------------------------------------
+void hash_combine(std::uint64_t& seed, std::uint64_t value)
+{
+	seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
+//-----------------------------------------------------------------------------
+//  Name : layout_hash_of ()
+/// <summary>
+/// Layout signature of a map set - dimensions, format and mip count of
+/// every map together. Sets sharing it can live in the same group.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::uint64_t layout_hash_of(const std::array<std::shared_ptr<gfx::texture>, texture_array_set::map_count>& maps)
+{
+	std::uint64_t hash = 0;
+	for(const auto& map : maps)
+	{
+		hash_combine(hash, map->info.width);
+		hash_combine(hash, map->info.height);
+		hash_combine(hash, std::uint64_t(map->info.format));
+		hash_combine(hash, map->info.numMips);
+	}
+	return hash;
+}
+
+//-----------------------------------------------------------------------------
+//  Name : identity_hash_of ()
+/// <summary>
+/// Identity of a concrete map set - the source texture pointers.
+/// </summary>
+//-----------------------------------------------------------------------------
+std::uint64_t
+identity_hash_of(const std::array<const gfx::texture*, texture_array_set::map_count>& sources)
+{
+	std::uint64_t hash = 0;
+	for(const auto* source : sources)
+	{
+		hash_combine(hash, std::uint64_t(std::hash<const void*>()(source)));
+	}
+	return hash;
+}
+}
+
+texture_array_pool::slice
+texture_array_pool::acquire(const std::array<std::shared_ptr<gfx::texture>, texture_array_set::map_count>& maps)
+{
+	const auto* caps = gfx::get_caps();
+	if((caps->supported & BGFX_CAPS_TEXTURE_2D_ARRAY) == 0 ||
+	   (caps->supported & BGFX_CAPS_TEXTURE_BLIT) == 0)
+	{
+		return {};
+	}
+
+	std::array<const gfx::texture*, texture_array_set::map_count> sources;
+	for(std::size_t i = 0; i < maps.size(); ++i)
+	{
+		if(!maps[i] || !maps[i]->is_valid())
+		{
+			return {};
+		}
+		sources[i] = maps[i].get();
+	}
+
+	const auto key = identity_hash_of(sources);
+	auto& bucket = _slices[key];
+	for(const auto& record : bucket)
+	{
+		if(record.sources == sources)
+		{
+			return record.result;
+		}
+	}
+
+	// Find (or open) a group matching the set's layout with a free layer.
+	const auto layout_hash = layout_hash_of(maps);
+	group* grp = nullptr;
+	for(auto& candidate : _groups)
+	{
+		if(candidate.layout_hash == layout_hash && candidate.used_layers < candidate.layer_capacity)
+		{
+			grp = &candidate;
+			break;
+		}
+	}
+
+	if(grp == nullptr)
+	{
+		const auto layer_capacity = std::uint16_t(
+			std::min<std::uint32_t>(std::max<std::uint32_t>(caps->limits.maxTextureLayers, 1u), 64u));
+		if(layer_capacity < 2)
+		{
+			return {};
+		}
+
+		_groups.emplace_back();
+		grp = &_groups.back();
+		grp->layout_hash = layout_hash;
+		grp->layer_capacity = layer_capacity;
+		for(std::size_t i = 0; i < maps.size(); ++i)
+		{
+			const auto& info = maps[i]->info;
+			grp->set.arrays[i] = std::make_shared<gfx::texture>(
+				info.width, info.height, info.numMips > 1, layer_capacity, info.format,
+				BGFX_TEXTURE_BLIT_DST);
+		}
+	}
+
+	const auto layer = grp->used_layers++;
+
+	pending_upload upload;
+	upload.grp = grp;
+	upload.layer = layer;
+	upload.key = key;
+	upload.sources = maps;
+	_pending.push_back(std::move(upload));
+
+	slice_record record;
+	record.sources = sources;
+	record.result.set = &grp->set;
+	record.result.layer = layer;
+	record.result.ready = false;
+	bucket.push_back(record);
+
+	return record.result;
+}
+
+void texture_array_pool::flush_uploads()
+{
+	if(_pending.empty())
+	{
+		return;
+	}
+
+	gfx::render_pass pass("texture_array_upload");
+	pass.bind();
+
+	for(auto& upload : _pending)
+	{
+		for(std::size_t i = 0; i < upload.sources.size(); ++i)
+		{
+			const auto& source = upload.sources[i];
+			const auto& destination = upload.grp->set.arrays[i];
+			const auto mips = std::min(source->info.numMips, destination->info.numMips);
+			for(std::uint8_t mip = 0; mip < std::max<std::uint8_t>(mips, 1); ++mip)
+			{
+				gfx::blit(pass.id, destination->native_handle(), mip, 0, 0, upload.layer,
+						  source->native_handle(), mip);
+			}
+		}
+
+		auto& bucket = _slices[upload.key];
+		for(auto& record : bucket)
+		{
+			if(record.result.set == &upload.grp->set && record.result.layer == upload.layer)
+			{
+				record.result.ready = true;
+			}
+		}
+	}
+
+	_pending.clear();
+}
+}
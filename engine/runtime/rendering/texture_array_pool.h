@@ -0,0 +1,110 @@
+#pragma once
+
+#include "core/common/basetypes.hpp"
+#include "core/graphics/graphics.h"
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace gfx
+{
+struct texture;
+}
+
+namespace runtime
+{
+/// One layered destination per standard material map; a material set that
+/// acquired a slice samples all of its maps at the same layer index.
+struct texture_array_set
+{
+	/// number of maps a standard material set packs (color, normal,
+	/// roughness, metalness, ao)
+	static const std::size_t map_count = 5;
+
+	/// layered array textures, one per material map
+	std::array<std::shared_ptr<gfx::texture>, map_count> arrays;
+};
+
+//-----------------------------------------------------------------------------
+//  Name : texture_array_pool (Class)
+/// <summary>
+/// Packs the texture sets of same-layout materials into shared layered
+/// array textures so draws that differ only in textures can bind one
+/// array set and merge, carrying a per-instance layer index instead of
+/// rebinding samplers. Sets group by the sizes/formats/mip counts of
+/// their maps; slices are copied in by flush_uploads at the frame start,
+/// so a freshly acquired slice only becomes usable the following frame.
+/// </summary>
+//-----------------------------------------------------------------------------
+class texture_array_pool
+{
+public:
+	/// A material set's location within the pool.
+	struct slice
+	{
+		const texture_array_set* set = nullptr;
+		std::uint16_t layer = 0;
+		/// false until flush_uploads copied the source maps in
+		bool ready = false;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : acquire ()
+	/// <summary>
+	/// Returns the slice holding the given map set, allocating one (and
+	/// queueing its upload) on first sight. Returns an empty slice when
+	/// the device lacks array textures or blitting, a map is not loaded
+	/// yet, or every compatible group is full.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	slice acquire(const std::array<std::shared_ptr<gfx::texture>, texture_array_set::map_count>& maps);
+
+	//-----------------------------------------------------------------------------
+	//  Name : flush_uploads ()
+	/// <summary>
+	/// Blits the source maps of every slice allocated since the last call
+	/// into their array layers. Runs in its own pass at the top of the
+	/// frame so the copies land before any geometry samples them.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void flush_uploads();
+
+private:
+	struct group
+	{
+		/// layout signature of the member map sets
+		std::uint64_t layout_hash = 0;
+		texture_array_set set;
+		std::uint16_t used_layers = 0;
+		std::uint16_t layer_capacity = 0;
+	};
+
+	struct pending_upload
+	{
+		group* grp = nullptr;
+		std::uint16_t layer = 0;
+		/// bucket of the slice to flag ready once the copy flushed
+		std::uint64_t key = 0;
+		/// keeps the sources alive until the copy flushed
+		std::array<std::shared_ptr<gfx::texture>, texture_array_set::map_count> sources;
+	};
+
+	struct slice_record
+	{
+		/// identity of the source maps the slice was allocated for
+		std::array<const gfx::texture*, texture_array_set::map_count> sources;
+		slice result;
+	};
+
+	/// stable storage - materials hold pointers into the sets
+	std::deque<group> _groups;
+	/// allocated slices keyed by a hash of the source map pointers;
+	/// buckets hold the full identity to resolve collisions
+	std::unordered_map<std::uint64_t, std::vector<slice_record>> _slices;
+	std::vector<pending_upload> _pending;
+};
+}
@@ -0,0 +1,122 @@
+#include "texture_residency.h"
+#include "../assets/asset_manager.h"
+#include "core/graphics/graphics.h"
+#include "core/logging/logging.h"
+#include "core/system/subsystem.h"
+
+namespace runtime
+{
+
+void texture_residency::on_loaded(const std::string& key, std::uint64_t bytes)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		auto& tracked = _entries[key];
+		if(tracked.resident)
+			_usage -= tracked.bytes;
+
+		tracked.bytes = bytes;
+		tracked.resident = true;
+		tracked.reload_pending = false;
+		tracked.last_used_frame = gfx::get_render_frame();
+
+		_usage += bytes;
+	}
+
+	enforce_budget();
+}
+
+void texture_residency::touch(const asset_handle<gfx::texture>& texture)
+{
+	const auto& key = texture.id();
+	if(key.empty())
+		return;
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	auto it = _entries.find(key);
+	if(it == _entries.end())
+		return;
+
+	it->second.last_used_frame = gfx::get_render_frame();
+
+	if(it->second.resident || it->second.reload_pending)
+		return;
+
+	it->second.reload_pending = true;
+	lock.unlock();
+
+	// The texture was evicted earlier but is wanted on screen again;
+	// bring it back through the regular async path.
+	auto& am = core::get_subsystem<asset_manager>();
+	am.load<gfx::texture>(key, load_mode::async, load_flags::reload);
+}
+
+void texture_residency::set_memory_budget(std::uint64_t bytes)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_budget = bytes;
+	}
+
+	enforce_budget();
+}
+
+std::uint64_t texture_residency::get_memory_budget() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _budget;
+}
+
+std::uint64_t texture_residency::get_memory_usage() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _usage;
+}
+
+void texture_residency::enforce_budget()
+{
+	auto& am = core::get_subsystem<asset_manager>();
+	const auto frame = gfx::get_render_frame();
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	while(_budget != 0 && _usage > _budget)
+	{
+		// Pick the least recently rendered resident texture. Anything
+		// bound this frame is off limits - evicting it would flicker.
+		auto lru = _entries.end();
+		for(auto it = _entries.begin(); it != _entries.end(); ++it)
+		{
+			if(!it->second.resident || it->second.last_used_frame >= frame)
+				continue;
+
+			if(lru == _entries.end() || it->second.last_used_frame < lru->second.last_used_frame)
+				lru = it;
+		}
+
+		if(lru == _entries.end())
+			break;
+
+		const auto key = lru->first;
+		const auto bytes = lru->second.bytes;
+		lru->second.resident = false;
+		_usage -= bytes;
+
+		lock.unlock();
+
+		// Drop the GPU storage but keep the link id intact, so a later
+		// touch can reload the texture into the same link and every
+		// holder sees it again.
+		auto future = am.find_asset_entry<gfx::texture>(key);
+		if(future.is_ready())
+		{
+			auto handle = future.get();
+			handle.link->asset.reset();
+		}
+
+		APPLOG_INFO("Evicted texture {0} ({1} bytes) to fit the {2} byte budget.", key, bytes, _budget);
+
+		lock.lock();
+	}
+}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "../assets/asset_handle.h"
+#include "core/graphics/texture.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace runtime
+{
+
+class texture_residency
+{
+public:
+	texture_residency() = default;
+	~texture_residency() = default;
+
+	//-----------------------------------------------------------------------------
+	//  Name : on_loaded ()
+	/// <summary>
+	/// Records the GPU storage a freshly loaded texture occupies and
+	/// enforces the budget, evicting the least recently rendered textures
+	/// when it is exceeded. Called by the reader once the resource exists.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void on_loaded(const std::string& key, std::uint64_t bytes);
+
+	//-----------------------------------------------------------------------------
+	//  Name : touch ()
+	/// <summary>
+	/// Stamps the texture as rendered this frame. If it was evicted
+	/// earlier the regular async load path is kicked to bring it back;
+	/// the shared link repopulates in place so every holder picks the
+	/// texture up when the reload lands.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void touch(const asset_handle<gfx::texture>& texture);
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_memory_budget ()
+	/// <summary>
+	/// Sets the GPU texture memory budget in bytes. 0 disables eviction.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_memory_budget(std::uint64_t bytes);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_memory_budget ()
+	/// <summary>
+	/// Returns the configured budget in bytes.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::uint64_t get_memory_budget() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_memory_usage ()
+	/// <summary>
+	/// Returns the bytes currently occupied by resident tracked textures.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::uint64_t get_memory_usage() const;
+
+private:
+	struct entry
+	{
+		/// GPU storage the texture occupies.
+		std::uint64_t bytes = 0;
+		/// Render frame the texture was last bound on.
+		std::uint64_t last_used_frame = 0;
+		/// Whether the texture currently holds its GPU storage.
+		bool resident = false;
+		/// An async reload was already issued for an evicted texture.
+		bool reload_pending = false;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : enforce_budget ()
+	/// <summary>
+	/// Evicts least recently rendered resident textures until usage fits
+	/// the budget. Textures bound this frame are never evicted.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void enforce_budget();
+
+	/// Guards the entry map and the usage counter.
+	mutable std::mutex _mutex;
+	/// Tracked textures by asset key.
+	std::unordered_map<std::string, entry> _entries;
+	/// Bytes occupied by resident entries.
+	std::uint64_t _usage = 0;
+	/// Budget in bytes; 0 disables eviction. Defaults to 1 GiB which is
+	/// comfortable on any hardware the engine targets.
+	std::uint64_t _budget = 1024ull * 1024ull * 1024ull;
+};
+}
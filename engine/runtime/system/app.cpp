@@ -1,5 +1,9 @@
 #include "app.h"
 #include "../assets/asset_manager.h"
+#include "../assets/asset_manifest.h"
+#include "../assets/asset_pack.h"
+#include "../assets/impl/load_queue.h"
+#include "../assets/impl/upload_queue.h"
 #include "../ecs/ecs.h"
 #include "../ecs/systems/audio_system.h"
 #include "../ecs/systems/bone_system.h"
@@ -7,12 +11,20 @@
 #include "../ecs/systems/deferred_rendering.h"
 #include "../ecs/systems/reflection_probe_system.h"
 #include "../ecs/systems/scene_graph.h"
+#include "../ecs/systems/spatial_index.h"
+#include "../ecs/systems/system_scheduler.h"
+#include "../ecs/systems/world_streaming.h"
 #include "../input/input.h"
 #include "../rendering/render_window.h"
 #include "../rendering/renderer.h"
+#include "../rendering/texture_array_pool.h"
+#include "../rendering/texture_residency.h"
 #include "app_setup.h"
+#include "hitch_detector.h"
+#include "telemetry_recorder.h"
 #include "core/audio/library.h"
 #include "core/logging/logging.h"
+#include "core/profiler/profiler.h"
 #include "core/serialization/serialization.h"
 #include "core/simulation/simulation.h"
 #include "core/tasks/task_system.h"
@@ -28,7 +40,9 @@ void app::setup(cmd_line::parser& parser)
 	logging_container->add_sink(std::make_shared<logging::sinks::platform_sink_mt>());
 	logging_container->add_sink(std::make_shared<logging::sinks::daily_file_sink_mt>("Log", 23, 59));
 
-	auto logger = logging::create(APPLOG, logging_container);
+	// route through the bounded async front - call sites only enqueue,
+	// formatting and sink IO happen on the logging worker
+	auto logger = logging::create(APPLOG, logging::get_async_logging_container());
 
 	serialization::set_warning_logger([](const std::string& msg) { APPLOG_WARNING(msg); });
 
@@ -42,25 +56,87 @@ void app::setup(cmd_line::parser& parser)
 	ecs::set_frame_getter([]() { return core::get_subsystem<core::simulation>().get_frame(); });
 
 	parser.set_optional<std::string>("r", "renderer", "auto", "Select preferred renderer.");
-    parser.set_optional<bool>("n", "novsync", false, "Disable vsync.");  
+    parser.set_optional<bool>("n", "novsync", false, "Disable vsync.");
+	parser.set_optional<bool>("t", "render-thread", false,
+							  "Run backend processing on a dedicated render thread.");
+	parser.set_optional<bool>("l", "headless", false,
+							  "Run without a window on the null rendering backend.");
+	parser.set_optional<bool>("p", "pump-thread", false,
+							  "Pump window events on a dedicated thread.");
+	parser.set_optional<std::string>("y", "telemetry", "",
+									 "Record per-frame telemetry to the given file (.csv or binary).");
 }
 
 void app::start(cmd_line::parser& parser)
 {
 	core::add_subsystem<core::simulation>();
 	core::add_subsystem<core::task_system>();
+	core::add_subsystem<hitch_detector>();
+	auto& telemetry = core::add_subsystem<telemetry_recorder>();
+
+	// soak runs start recording from the command line; interactive runs use
+	// the telemetry_start/telemetry_stop console commands instead
+	std::string telemetry_file;
+	if(parser.try_get("telemetry", telemetry_file) && !telemetry_file.empty())
+	{
+		if(telemetry.start(telemetry_file))
+			APPLOG_INFO("Recording telemetry to {0}.", telemetry_file);
+		else
+			APPLOG_ERROR("Could not open telemetry file {0}.", telemetry_file);
+	}
+
 	core::add_subsystem<renderer>(parser);
 	core::add_subsystem<input>();
-	core::add_subsystem<audio::device>();
+	core::add_subsystem<load_queue>();
+	core::add_subsystem<upload_queue>();
+
+	{
+		// No ordering dependency between these three and each does real
+		// work up front - the audio device open alone runs ~100ms - so
+		// they construct concurrently and register together. The renderer
+		// and upload_queue stay sequential above: both capture the
+		// registering thread.
+		core::subsystem_batch batch;
+		batch.add<audio::device>();
+		batch.add_with<asset_pack>([]() {
+			// Shipped builds bundle the compiled asset cache into a single
+			// archive next to the binary; when it is present the readers
+			// serve every asset out of one mapping instead of thousands of
+			// files.
+			auto pack = std::make_shared<asset_pack>();
+			const auto pack_path = fs::resolve_protocol("binary:/assets.pack");
+			fs::error_code err;
+			if(fs::exists(pack_path, err))
+				pack->mount(pack_path);
+			return pack;
+		});
+		batch.add_with<asset_manifest>([]() {
+			// A cooked manifest answers compiled-asset resolution out of
+			// one in-memory index; without it the readers stat the
+			// filesystem per key, which crawls on network mounts.
+			auto manifest = std::make_shared<asset_manifest>();
+			const auto manifest_path = fs::resolve_protocol("app:/cache/assets.manifest");
+			fs::error_code err;
+			if(fs::exists(manifest_path, err))
+				manifest->load(manifest_path);
+			return manifest;
+		});
+		batch.commit();
+	}
 	auto& am = core::add_subsystem<asset_manager>();
 	setup_asset_manager(am);
+	core::add_subsystem<texture_residency>();
+	core::add_subsystem<texture_array_pool>();
 	core::add_subsystem<entity_component_system>();
+	core::add_subsystem<system_scheduler>();
 	core::add_subsystem<scene_graph>();
+	core::add_subsystem<spatial_index>();
 	core::add_subsystem<bone_system>();
 	core::add_subsystem<camera_system>();
 	core::add_subsystem<reflection_probe_system>();
 	core::add_subsystem<deferred_rendering>();
 	core::add_subsystem<audio_system>();
+	core::add_subsystem<world_streaming>();
 }
 
 void app::stop()
@@ -70,28 +146,38 @@ void app::stop()
 void poll_events()
 {
 	auto& renderer = core::get_subsystem<runtime::renderer>();
-	const auto& windows = renderer.get_windows();
 
 	std::uint32_t focused_id = 0;
 	std::map<std::uint32_t, std::vector<mml::platform_event>> collected_events;
-	for(const auto& window : windows)
+	if(renderer.is_event_pump_threaded())
 	{
-		const auto id = window->get_id();
-		std::vector<mml::platform_event> events;
-		mml::platform_event e;
-		while(window->poll_event(e))
-		{
-			events.emplace_back(std::move(e));
-		}
-
-		if(window->has_focus())
-		{
-			focused_id = id;
-		}
-
-		if(!events.empty())
+		// The pump thread already paid the syscalls; this is a snapshot
+		// swap. Dispatch below still happens here - handlers are
+		// main-thread code.
+		collected_events = renderer.poll_pumped_events(focused_id);
+	}
+	else
+	{
+		const auto& windows = renderer.get_windows();
+		for(const auto& window : windows)
 		{
-			collected_events.emplace(id, std::move(events));
+			const auto id = window->get_id();
+			std::vector<mml::platform_event> events;
+			mml::platform_event e;
+			while(window->poll_event(e))
+			{
+				events.emplace_back(std::move(e));
+			}
+
+			if(window->has_focus())
+			{
+				focused_id = id;
+			}
+
+			if(!events.empty())
+			{
+				collected_events.emplace(id, std::move(events));
+			}
 		}
 	}
 
@@ -121,8 +207,11 @@ void app::run_one_frame()
 
 	renderer.process_pending_windows();
 
+	// Headless runs have no windows at all; their embedder decides when
+	// to quit.
 	const auto& windows = renderer.get_windows();
-	bool should_quit = std::all_of(std::begin(windows), std::end(windows),
+	bool should_quit = !renderer.is_headless() &&
+					   std::all_of(std::begin(windows), std::end(windows),
 								   [](const auto& window) { return !window->is_visible(); });
 	if(should_quit)
 	{
@@ -130,13 +219,45 @@ void app::run_one_frame()
 		return;
 	}
 
-	on_frame_begin(dt);
+	{
+		PROFILE_SCOPE("frame/begin");
+		on_frame_begin(dt);
+	}
+
+	{
+		PROFILE_SCOPE("frame/fixed_update");
+		const auto fixed_dt = sim.get_fixed_delta_time();
+		for(std::uint32_t i = 0; i < sim.get_fixed_updates(); ++i)
+		{
+			on_frame_fixed_update(fixed_dt);
+		}
+	}
+
+	{
+		PROFILE_SCOPE("frame/update");
+		on_frame_update(dt);
+	}
+
+	{
+		PROFILE_SCOPE("frame/render");
+		on_frame_render(dt);
+	}
+
+	{
+		PROFILE_SCOPE("frame/end");
+		on_frame_end(dt);
+	}
+
+	core::profiler::get_instance().collect();
 
-	on_frame_update(dt);
+	// judge the finished frame now that its profiler tree is available
+	core::get_subsystem<hitch_detector>().on_frame_complete(sim.get_frame());
 
-	on_frame_render(dt);
+	core::get_subsystem<telemetry_recorder>().on_frame_complete(sim.get_frame(), dt);
 
-	on_frame_end(dt);
+	// explicit per-frame flush point - signals the logging worker, does
+	// not wait for sink IO
+	logging::get_async_logging_container()->flush();
 }
 
 int app::run(int argc, char* argv[])
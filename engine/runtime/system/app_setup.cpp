@@ -60,6 +60,16 @@ void setup_asset_manager(asset_manager& manager)
 		storage.load_from_instance = asset_reader::load_from_instance<scene>;
 	}
 
+	// Map key extensions to their storage types so the dependency lists
+	// the compiler records can fan out as typed parallel loads.
+	manager.register_prefetch<gfx::texture>(ex::get_suported_texture_formats());
+	manager.register_prefetch<mesh>(ex::get_suported_mesh_formats());
+	manager.register_prefetch<audio::sound>(ex::get_suported_sound_formats());
+	manager.register_prefetch<material>(ex::get_suported_material_formats());
+	manager.register_prefetch<animation>(ex::get_suported_animation_formats());
+	manager.register_prefetch<prefab>(ex::get_suported_prefab_formats());
+	manager.register_prefetch<scene>(ex::get_suported_scene_formats());
+
 	{
 		const auto id = "embedded:/sphere";
 		auto instance = std::make_shared<mesh>();
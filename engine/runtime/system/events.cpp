@@ -3,6 +3,7 @@
 namespace runtime
 {
 event<void(std::chrono::duration<float>)> on_frame_begin;
+event<void(std::chrono::duration<float>)> on_frame_fixed_update;
 event<void(std::chrono::duration<float>)> on_frame_update;
 event<void(std::chrono::duration<float>)> on_frame_render;
 event<void(std::chrono::duration<float>)> on_frame_end;
@@ -8,7 +8,15 @@
 namespace runtime
 {
 /// engine loop events
+
 extern event<void(std::chrono::duration<float>)> on_frame_begin;
+
+/// Fired zero or more times per frame when core::simulation runs in
+/// fixed-timestep mode, once per accumulated fixed tick, always with the
+/// fixed delta. Gameplay that should not scale with display refresh
+/// subscribes here instead of on_frame_update.
+extern event<void(std::chrono::duration<float>)> on_frame_fixed_update;
+
 extern event<void(std::chrono::duration<float>)> on_frame_update;
 extern event<void(std::chrono::duration<float>)> on_frame_render;
 extern event<void(std::chrono::duration<float>)> on_frame_end;
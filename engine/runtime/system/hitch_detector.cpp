@@ -0,0 +1,128 @@
+#include "hitch_detector.h"
+#include "core/logging/logging.h"
+#include "core/system/subsystem.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace runtime
+{
+namespace
+{
+// enough frames for a stable median, small enough to adapt when the
+// scene changes
+const std::size_t history_capacity = 128;
+// do not judge anything until the window is reasonably warm
+const std::size_t history_warmup = 32;
+// recent captures kept around for dumping
+const std::size_t capture_capacity = 8;
+
+double rolling_median(const std::deque<double>& history)
+{
+	std::vector<double> sorted(history.begin(), history.end());
+	auto middle = sorted.begin() + sorted.size() / 2;
+	std::nth_element(sorted.begin(), middle, sorted.end());
+	return *middle;
+}
+}
+
+void hitch_detector::on_frame_complete(std::uint64_t frame)
+{
+	const auto now = clock_t::now();
+	const double frame_ms =
+		std::chrono::duration<double, std::milli>(now - _last_frame_end).count();
+	_last_frame_end = now;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	const bool warm = _history.size() >= history_warmup;
+	const double median_ms = warm ? rolling_median(_history) : 0.0;
+
+	_history.push_back(frame_ms);
+	if(_history.size() > history_capacity)
+		_history.pop_front();
+
+	const bool hitched = warm && median_ms > 0.0 && frame_ms > median_ms * double(_threshold);
+	if(hitched)
+	{
+		capture snapshot;
+		snapshot.frame = frame;
+		snapshot.frame_ms = frame_ms;
+		snapshot.median_ms = median_ms;
+		snapshot.samples = core::profiler::get_instance().get_last_frame_samples();
+		if(core::has_subsystems<core::task_system>())
+			snapshot.tasks = core::get_subsystem<core::task_system>().get_info();
+		snapshot.asset_events = _frame_asset_events;
+
+		_captures.push_back(std::move(snapshot));
+		if(_captures.size() > capture_capacity)
+			_captures.pop_front();
+
+		APPLOG_WARNING("Hitch detected: frame {0} took {1:.2f} ms (rolling median {2:.2f} ms).", frame,
+					   frame_ms, median_ms);
+	}
+
+	_frame_asset_events.clear();
+}
+
+void hitch_detector::note_asset_event(const std::string& description)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	// cap the per-frame list so a pathological frame cannot balloon it
+	if(_frame_asset_events.size() < 256)
+		_frame_asset_events.push_back(description);
+}
+
+void hitch_detector::set_threshold(float multiple_of_median)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_threshold = std::max(multiple_of_median, 1.0f);
+}
+
+std::vector<hitch_detector::capture> hitch_detector::get_captures() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return std::vector<capture>(_captures.begin(), _captures.end());
+}
+
+std::string hitch_detector::dump() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	std::ostringstream out;
+	if(_captures.empty())
+	{
+		out << "hitch detector: no captures.";
+		return out.str();
+	}
+
+	out << "hitch detector: " << _captures.size() << " capture(s)\n";
+	for(const auto& snapshot : _captures)
+	{
+		out << "frame " << snapshot.frame << ": " << snapshot.frame_ms << " ms (median "
+			<< snapshot.median_ms << " ms)\n";
+
+		out << "  profiler:\n";
+		for(const auto& sample : snapshot.samples)
+		{
+			out << "    " << std::string((sample.depth + 1) * 2, ' ') << sample.name << "  "
+				<< sample.total_ms << " ms  x" << sample.call_count << "\n";
+		}
+
+		out << "  tasks: " << snapshot.tasks.pending_tasks << " pending\n";
+		for(std::size_t i = 0; i < snapshot.tasks.queue_infos.size(); ++i)
+		{
+			out << "    queue " << i << ": " << snapshot.tasks.queue_infos[i].pending_tasks
+				<< " pending, " << snapshot.tasks.queue_infos[i].executed_tasks << " executed\n";
+		}
+
+		if(!snapshot.asset_events.empty())
+		{
+			out << "  asset events:\n";
+			for(const auto& event : snapshot.asset_events)
+				out << "    " << event << "\n";
+		}
+	}
+	return out.str();
+}
+}
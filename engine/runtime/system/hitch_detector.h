@@ -0,0 +1,105 @@
+#pragma once
+
+#include "core/profiler/profiler.h"
+#include "core/tasks/task_system.h"
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace runtime
+{
+//-----------------------------------------------------------------------------
+//  Name : hitch_detector (Class)
+/// <summary>
+/// Watches per-frame wall time against a rolling median and, when a
+/// frame blows past a configurable multiple of it, snapshots that
+/// frame's profiler tree, task queue state and asset events into a ring
+/// of recent captures. The ring can be dumped on demand, so the
+/// 1-in-10000 spike of a soak run is explained without external tracing
+/// attached the whole time.
+/// </summary>
+//-----------------------------------------------------------------------------
+class hitch_detector
+{
+public:
+	struct capture
+	{
+		/// frame number the hitch occurred on
+		std::uint64_t frame = 0;
+		/// wall time of the offending frame
+		double frame_ms = 0.0;
+		/// rolling median at the time of the hitch
+		double median_ms = 0.0;
+		/// the frame's aggregated profiler call tree
+		std::vector<core::profiler::sample> samples;
+		/// task system queue state right after the frame
+		core::task_system::system_info tasks;
+		/// asset activity noted during the frame
+		std::vector<std::string> asset_events;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : on_frame_complete ()
+	/// <summary>
+	/// Call once per frame from the main loop, after the profiler has
+	/// collected. Measures the wall time since the previous call and
+	/// captures the frame when it qualifies as a hitch.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void on_frame_complete(std::uint64_t frame);
+
+	//-----------------------------------------------------------------------------
+	//  Name : note_asset_event ()
+	/// <summary>
+	/// Records a line of asset activity for the current frame. Safe to
+	/// call from any thread - loads note themselves from workers.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void note_asset_event(const std::string& description);
+
+	//-----------------------------------------------------------------------------
+	//  Name : set_threshold ()
+	/// <summary>
+	/// A frame counts as a hitch when it exceeds this multiple of the
+	/// rolling median frame time.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void set_threshold(float multiple_of_median);
+
+	//-----------------------------------------------------------------------------
+	//  Name : get_captures ()
+	/// <summary>
+	/// Copy of the recent capture ring, oldest first.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::vector<capture> get_captures() const;
+
+	//-----------------------------------------------------------------------------
+	//  Name : dump ()
+	/// <summary>
+	/// Human readable report of the capture ring.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::string dump() const;
+
+private:
+	using clock_t = std::chrono::steady_clock;
+
+	/// guards everything below - note_asset_event is cross-thread
+	mutable std::mutex _mutex;
+	/// wall times of the most recent frames, newest last
+	std::deque<double> _history;
+	/// asset events noted since the last frame boundary
+	std::vector<std::string> _frame_asset_events;
+	/// recent hitch captures, oldest first
+	std::deque<capture> _captures;
+	/// hitch threshold as a multiple of the rolling median
+	float _threshold = 3.0f;
+	/// end of the previous frame
+	clock_t::time_point _last_frame_end = clock_t::now();
+};
+}
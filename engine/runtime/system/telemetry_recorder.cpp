@@ -0,0 +1,238 @@
+#include "telemetry_recorder.h"
+#include "../assets/impl/load_queue.h"
+#include "../assets/impl/upload_queue.h"
+#include "core/graphics/graphics.h"
+#include "core/memory/memory_tracker.h"
+#include "core/profiler/profiler.h"
+#include "core/string_utils/string_utils.h"
+#include "core/system/subsystem.h"
+
+#include <iomanip>
+#include <utility>
+
+namespace runtime
+{
+namespace
+{
+// rows buffered before a chunk is handed to the background writer
+const std::size_t chunk_capacity = 512;
+
+// binary layout markers - "TELM" followed by a format version
+const std::uint32_t telemetry_magic = 0x4d4c4554;
+const std::uint32_t telemetry_version = 1;
+
+// column order must match the sampling in on_frame_complete
+const std::array<const char*, telemetry_recorder::column_count> column_names = {
+	{"frame_ms", "gpu_ms", "cpu_profiled_ms", "draw_calls", "triangles", "memory_live_kib",
+	 "tasks_pending", "asset_loads", "asset_uploads"}};
+
+void write_u32(std::ostream& out, std::uint32_t value)
+{
+	out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void write_u64(std::ostream& out, std::uint64_t value)
+{
+	out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void write_f64(std::ostream& out, double value)
+{
+	out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void write_string(std::ostream& out, const std::string& value)
+{
+	write_u32(out, std::uint32_t(value.size()));
+	out.write(value.data(), std::streamsize(value.size()));
+}
+}
+
+telemetry_recorder::~telemetry_recorder()
+{
+	stop();
+}
+
+bool telemetry_recorder::start(const std::string& file)
+{
+	if(_recording)
+		return false;
+
+	std::lock_guard<std::mutex> file_lock(_file_mutex);
+	_file.open(file, std::ios::binary | std::ios::trunc);
+	if(!_file.is_open())
+		return false;
+
+	_csv = file.size() >= 4 && string_utils::icompare(file.substr(file.size() - 4), ".csv") == 0;
+
+	if(_csv)
+	{
+		_file << "frame";
+		for(const auto* name : column_names)
+			_file << "," << name;
+		_file << "\n";
+	}
+	else
+	{
+		write_u32(_file, telemetry_magic);
+		write_u32(_file, telemetry_version);
+		write_u32(_file, std::uint32_t(column_count + 1));
+		write_string(_file, "frame");
+		for(const auto* name : column_names)
+			write_string(_file, name);
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_current = chunk();
+	_pending.clear();
+	_rows_recorded = 0;
+	_recording = true;
+	return true;
+}
+
+std::uint64_t telemetry_recorder::stop()
+{
+	if(!_recording)
+		return 0;
+
+	core::task_future<void> writer;
+	std::uint64_t rows = 0;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_recording = false;
+		rows = _rows_recorded;
+		if(!_current.frames.empty())
+			queue_chunk(std::move(_current));
+		_current = chunk();
+		writer = _writer;
+	}
+
+	// the drain task sees everything queued above; once it finishes the
+	// pending list is empty and the file is quiescent
+	if(writer.valid())
+		writer.wait();
+
+	std::lock_guard<std::mutex> file_lock(_file_mutex);
+	_file.close();
+	return rows;
+}
+
+void telemetry_recorder::on_frame_complete(std::uint64_t frame, std::chrono::duration<float> dt)
+{
+	if(!_recording)
+		return;
+
+	std::array<double, column_count> row{};
+	row[0] = double(dt.count()) * 1000.0;
+
+	const auto* stats = gfx::get_stats();
+	if(stats != nullptr)
+	{
+		if(stats->gpuTimerFreq != 0)
+			row[1] = double(stats->gpuTimeEnd - stats->gpuTimeBegin) * 1000.0 /
+					 double(stats->gpuTimerFreq);
+		row[3] = double(stats->numDraw);
+		row[4] = double(stats->numPrims[0]);
+	}
+
+	// the roots already include their children - summing depth 0 gives the
+	// total profiled main-path time without double counting
+	for(const auto& sample : core::profiler::get_instance().get_last_frame_samples())
+	{
+		if(sample.depth == 0)
+			row[2] += sample.total_ms;
+	}
+
+	for(const auto& tag : memory::memory_tracker::get().get_stats())
+		row[5] += double(tag.second.live_bytes) / 1024.0;
+
+	if(core::has_subsystems<core::task_system>())
+		row[6] = double(core::get_subsystem<core::task_system>().get_info().pending_tasks);
+
+	if(core::has_subsystems<load_queue>())
+		row[7] = double(core::get_subsystem<load_queue>().get_pending_count());
+
+	if(core::has_subsystems<upload_queue>())
+		row[8] = double(core::get_subsystem<upload_queue>().get_pending_count());
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if(!_recording)
+		return;
+
+	_current.frames.push_back(frame);
+	for(std::size_t i = 0; i < column_count; ++i)
+		_current.columns[i].push_back(row[i]);
+	++_rows_recorded;
+
+	if(_current.frames.size() >= chunk_capacity)
+	{
+		queue_chunk(std::move(_current));
+		_current = chunk();
+	}
+}
+
+void telemetry_recorder::queue_chunk(chunk&& rows)
+{
+	_pending.push_back(std::move(rows));
+	if(_writer_active)
+		return;
+
+	_writer_active = true;
+	auto& ts = core::get_subsystem<core::task_system>();
+	_writer = ts.push_on_worker_thread([this]() { write_pending(); });
+}
+
+void telemetry_recorder::write_pending()
+{
+	for(;;)
+	{
+		chunk rows;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if(_pending.empty())
+			{
+				_writer_active = false;
+				return;
+			}
+			rows = std::move(_pending.front());
+			_pending.pop_front();
+		}
+
+		std::lock_guard<std::mutex> file_lock(_file_mutex);
+		write_chunk(rows);
+	}
+}
+
+void telemetry_recorder::write_chunk(const chunk& rows)
+{
+	if(!_file.is_open())
+		return;
+
+	if(_csv)
+	{
+		_file << std::fixed << std::setprecision(3);
+		for(std::size_t row = 0; row < rows.frames.size(); ++row)
+		{
+			_file << rows.frames[row];
+			for(const auto& column : rows.columns)
+				_file << "," << column[row];
+			_file << "\n";
+		}
+	}
+	else
+	{
+		// chunks stay columnar on disk: the row count, the frame indices,
+		// then each metric column contiguously
+		write_u32(_file, std::uint32_t(rows.frames.size()));
+		for(const auto frame : rows.frames)
+			write_u64(_file, frame);
+		for(const auto& column : rows.columns)
+		{
+			for(const auto value : column)
+				write_f64(_file, value);
+		}
+	}
+
+	_file.flush();
+}
+}
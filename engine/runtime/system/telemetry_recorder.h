@@ -0,0 +1,135 @@
+#pragma once
+
+#include "core/tasks/task_system.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace runtime
+{
+//-----------------------------------------------------------------------------
+//  Name : telemetry_recorder (Class)
+/// <summary>
+/// Records a fixed set of per-frame metrics - frame and gpu time, the
+/// profiler's root totals, draw stats, tracked memory, task and asset
+/// queue depths - into a columnar in-memory buffer and streams filled
+/// chunks to disk from a worker thread, so soak runs get machine
+/// readable data without the sampled frame ever paying for file IO.
+/// Writes CSV when the target file ends in .csv and a compact binary
+/// layout otherwise. Started either from the command line or through
+/// the console commands registered by the application.
+/// </summary>
+//-----------------------------------------------------------------------------
+class telemetry_recorder
+{
+public:
+	/// metric columns recorded next to the frame index
+	static const std::size_t column_count = 9;
+
+	~telemetry_recorder();
+
+	//-----------------------------------------------------------------------------
+	//  Name : start ()
+	/// <summary>
+	/// Opens the output file, writes the format header and begins
+	/// sampling. Returns false when already recording or the file could
+	/// not be opened.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	bool start(const std::string& file);
+
+	//-----------------------------------------------------------------------------
+	//  Name : stop ()
+	/// <summary>
+	/// Stops sampling, waits for the background writer to drain the
+	/// remaining chunks and closes the file. Returns the number of frames
+	/// recorded. Safe to call when not recording.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	std::uint64_t stop();
+
+	//-----------------------------------------------------------------------------
+	//  Name : is_recording ()
+	/// <summary>
+	/// Whether a recording is currently in progress.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	inline bool is_recording() const
+	{
+		return _recording;
+	}
+
+	//-----------------------------------------------------------------------------
+	//  Name : on_frame_complete ()
+	/// <summary>
+	/// Call once per frame from the main loop after the profiler has
+	/// collected. Samples the frame's metrics into the current chunk; a
+	/// near free early-out when not recording.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void on_frame_complete(std::uint64_t frame, std::chrono::duration<float> dt);
+
+private:
+	/// one in-memory batch of rows, column per metric
+	struct chunk
+	{
+		std::vector<std::uint64_t> frames;
+		std::array<std::vector<double>, column_count> columns;
+	};
+
+	//-----------------------------------------------------------------------------
+	//  Name : queue_chunk (Private)
+	/// <summary>
+	/// Hands a filled chunk to the background writer, spawning the drain
+	/// task when none is in flight. Caller must hold _mutex.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void queue_chunk(chunk&& rows);
+
+	//-----------------------------------------------------------------------------
+	//  Name : write_pending (Private)
+	/// <summary>
+	/// Worker-side drain loop - pops pending chunks in order and writes
+	/// them out until the queue is empty. Only one instance runs at a
+	/// time, which keeps the rows ordered on disk.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void write_pending();
+
+	//-----------------------------------------------------------------------------
+	//  Name : write_chunk (Private)
+	/// <summary>
+	/// Serializes one chunk to the open file in the active format.
+	/// </summary>
+	//-----------------------------------------------------------------------------
+	void write_chunk(const chunk& rows);
+
+	/// guards the sampling state - current chunk, pending queue, counters
+	std::mutex _mutex;
+	/// guards the file - held only by the writer task and stop()
+	std::mutex _file_mutex;
+	/// the output stream, open while recording
+	std::ofstream _file;
+	/// cheap cross-thread gate for the per-frame early-out
+	std::atomic<bool> _recording{false};
+	/// write text rows instead of the binary layout
+	bool _csv = false;
+	/// a drain task is in flight
+	bool _writer_active = false;
+	/// rows accumulated since the last flush
+	chunk _current;
+	/// filled chunks awaiting the writer, oldest first
+	std::deque<chunk> _pending;
+	/// frames recorded since start
+	std::uint64_t _rows_recorded = 0;
+	/// the last spawned drain task, waited on by stop()
+	core::task_future<void> _writer;
+};
+}
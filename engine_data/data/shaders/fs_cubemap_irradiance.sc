@@ -0,0 +1,77 @@
+$input v_texcoord0
+
+#include "common.sh"
+
+SAMPLERCUBE(s_tex_cube, 0);
+
+uniform vec4 u_filter_data0;
+
+#define u_face u_filter_data0.x
+#define u_source_mips u_filter_data0.w
+
+#define IRRADIANCE_PI 3.14159265359f
+
+// Direction through the center of the given texel of the given cubemap face,
+// uv in [0,1].
+vec3 cubemapFaceDirection(float face, vec2 uv)
+{
+	vec2 st = uv * 2.0f - 1.0f;
+
+	vec3 dir = vec3(1.0f, -st.y, -st.x);
+	if (face > 0.5f && face < 1.5f) dir = vec3(-1.0f, -st.y, st.x);
+	if (face > 1.5f && face < 2.5f) dir = vec3(st.x, 1.0f, st.y);
+	if (face > 2.5f && face < 3.5f) dir = vec3(st.x, -1.0f, -st.y);
+	if (face > 3.5f && face < 4.5f) dir = vec3(st.x, -st.y, 1.0f);
+	if (face > 4.5f) dir = vec3(-st.x, -st.y, -1.0f);
+
+	return normalize(dir);
+}
+
+vec3 sampleEnvironment(vec3 dir, float lod)
+{
+	#if BGFX_SHADER_LANGUAGE_GLSL
+		dir.y = -dir.y;
+	#endif
+	return textureCubeLod(s_tex_cube, dir, lod).xyz;
+}
+
+void main()
+{
+	// Cosine convolution of the environment around the texel direction. The
+	// result lives in the cubemap's bottom mip, which the probe shaders hit
+	// at full roughness, so diffuse lookups come through the existing
+	// textureCubeLod path.
+	vec3 N = cubemapFaceDirection(u_face, v_texcoord0);
+
+	vec3 up = abs(N.z) < 0.999f ? vec3(0.0f, 0.0f, 1.0f) : vec3(1.0f, 0.0f, 0.0f);
+	vec3 tangentX = normalize(cross(up, N));
+	vec3 tangentY = cross(N, tangentX);
+
+	// Fixed grid over the hemisphere; the lower source mips are already
+	// band limited so a modest grid converges without fireflies.
+	float sourceLod = max(u_source_mips - 3.0f, 0.0f);
+	float deltaPhi = 2.0f * IRRADIANCE_PI / 32.0f;
+	float deltaTheta = 0.5f * IRRADIANCE_PI / 8.0f;
+
+	vec3 irradiance = vec3_splat(0.0f);
+	float sample_count = 0.0f;
+
+	for (int p = 0; p < 32; ++p)
+	{
+		float phi = float(p) * deltaPhi;
+		for (int t = 0; t < 8; ++t)
+		{
+			float theta = (float(t) + 0.5f) * deltaTheta;
+
+			vec3 tangentDir = vec3(sin(theta) * cos(phi), sin(theta) * sin(phi), cos(theta));
+			vec3 L = tangentX * tangentDir.x + tangentY * tangentDir.y + N * tangentDir.z;
+
+			// cos(theta) weights the contribution, sin(theta) accounts for
+			// the shrinking rings towards the pole.
+			irradiance += sampleEnvironment(L, sourceLod) * cos(theta) * sin(theta);
+			sample_count += 1.0f;
+		}
+	}
+
+	gl_FragColor = vec4(IRRADIANCE_PI * irradiance / sample_count, 1.0f);
+}
@@ -0,0 +1,99 @@
+$input v_texcoord0
+
+#include "common.sh"
+
+SAMPLERCUBE(s_tex_cube, 0);
+
+uniform vec4 u_filter_data0;
+
+#define u_face u_filter_data0.x
+#define u_roughness u_filter_data0.y
+#define u_source_size u_filter_data0.z
+#define u_source_mips u_filter_data0.w
+
+#define PREFILTER_SAMPLES 64
+#define PREFILTER_PI 3.14159265359f
+
+// Direction through the center of the given texel of the given cubemap face,
+// uv in [0,1].
+vec3 cubemapFaceDirection(float face, vec2 uv)
+{
+	vec2 st = uv * 2.0f - 1.0f;
+
+	vec3 dir = vec3(1.0f, -st.y, -st.x);
+	if (face > 0.5f && face < 1.5f) dir = vec3(-1.0f, -st.y, st.x);
+	if (face > 1.5f && face < 2.5f) dir = vec3(st.x, 1.0f, st.y);
+	if (face > 2.5f && face < 3.5f) dir = vec3(st.x, -1.0f, -st.y);
+	if (face > 3.5f && face < 4.5f) dir = vec3(st.x, -st.y, 1.0f);
+	if (face > 4.5f) dir = vec3(-st.x, -st.y, -1.0f);
+
+	return normalize(dir);
+}
+
+vec3 sampleEnvironment(vec3 dir, float lod)
+{
+	#if BGFX_SHADER_LANGUAGE_GLSL
+		dir.y = -dir.y;
+	#endif
+	return textureCubeLod(s_tex_cube, dir, lod).xyz;
+}
+
+vec3 importanceSampleGGX(vec2 Xi, float roughness, vec3 N, vec3 tangentX, vec3 tangentY)
+{
+	float a = roughness * roughness;
+
+	float phi = 2.0f * PREFILTER_PI * Xi.x;
+	float cosTheta = sqrt((1.0f - Xi.y) / (1.0f + (a * a - 1.0f) * Xi.y));
+	float sinTheta = sqrt(1.0f - cosTheta * cosTheta);
+
+	vec3 H = vec3(sinTheta * cos(phi), sinTheta * sin(phi), cosTheta);
+	return tangentX * H.x + tangentY * H.y + N * H.z;
+}
+
+void main()
+{
+	// Split-sum prefilter (N = V = R): convolve the environment with the GGX
+	// lobe of this mip's roughness around the texel direction.
+	vec3 N = cubemapFaceDirection(u_face, v_texcoord0);
+
+	vec3 up = abs(N.z) < 0.999f ? vec3(0.0f, 0.0f, 1.0f) : vec3(1.0f, 0.0f, 0.0f);
+	vec3 tangentX = normalize(cross(up, N));
+	vec3 tangentY = cross(N, tangentX);
+
+	float a = u_roughness * u_roughness;
+	float texelSolidAngle = 4.0f * PREFILTER_PI / (6.0f * u_source_size * u_source_size);
+
+	vec3 color = vec3_splat(0.0f);
+	float total_weight = 0.0f;
+
+	for (int i = 0; i < PREFILTER_SAMPLES; ++i)
+	{
+		// Golden-ratio sequence; cheap and well distributed without any
+		// integer bit tricks.
+		vec2 Xi = vec2((float(i) + 0.5f) / float(PREFILTER_SAMPLES), fract(float(i) * 0.618034f));
+
+		vec3 H = importanceSampleGGX(Xi, u_roughness, N, tangentX, tangentY);
+		vec3 L = normalize(2.0f * dot(N, H) * H - N);
+
+		float NoL = saturate(dot(N, L));
+		if (NoL > 0.0f)
+		{
+			// Filtered importance sampling: pick the source lod whose texel
+			// solid angle matches this sample's footprint to kill fireflies.
+			float NoH = saturate(dot(N, H));
+			float d = (NoH * a * a - NoH) * NoH + 1.0f;
+			float D = (a * a) / (PREFILTER_PI * d * d);
+			float pdf = max(D * NoH / 4.0f, 0.0001f);
+
+			float sampleSolidAngle = 1.0f / (float(PREFILTER_SAMPLES) * pdf);
+			float lod = u_roughness <= 0.0f
+							? 0.0f
+							: clamp(0.5f * log2(sampleSolidAngle / texelSolidAngle), 0.0f, u_source_mips - 1.0f);
+
+			color += sampleEnvironment(L, lod) * NoL;
+			total_weight += NoL;
+		}
+	}
+
+	gl_FragColor = vec4(color / max(total_weight, 0.001f), 1.0f);
+}
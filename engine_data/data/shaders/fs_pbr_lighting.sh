@@ -11,12 +11,36 @@ SAMPLER2D(s_tex3, 3);
 SAMPLER2D(s_tex4, 4);
 SAMPLER2D(s_tex5, 5); // reflection data
 SAMPLER2D(s_tex6, 6); // ibl_brdf_lut
+#if SHADOWED
+SAMPLER2D(s_tex7, 7); // shadow atlas depth
+#endif
 
 uniform vec4 u_light_position;
 uniform vec4 u_light_direction;
 uniform vec4 u_light_color_intensity;
 uniform vec4 u_light_data;
 uniform vec4 u_camera_position;
+#if SHADOWED
+uniform mat4 u_light_shadow_matrix;
+// normalized slot of this light within the shadow atlas: xy offset, zw scale
+uniform vec4 u_shadow_rect;
+// x: depth bias
+uniform vec4 u_shadow_params;
+
+float sample_shadow(vec3 world_position)
+{
+	vec4 shadow_clip = mul(u_light_shadow_matrix, vec4(world_position, 1.0));
+	vec3 shadow_ndc = clipTransform(shadow_clip.xyz / shadow_clip.w);
+	vec2 uv = shadow_ndc.xy * 0.5 + 0.5;
+	if(uv.x < 0.0 || uv.x > 1.0 || uv.y < 0.0 || uv.y > 1.0)
+	{
+		return 1.0;
+	}
+	vec2 atlas_uv = u_shadow_rect.xy + uv * u_shadow_rect.zw;
+	float occluder_depth = toClipSpaceDepth(texture2D(s_tex7, atlas_uv).x);
+	return step(shadow_ndc.z - u_shadow_params.x, occluder_depth);
+}
+#endif
 
 vec4 pbr_light(vec2 texcoord0)
 {
@@ -57,8 +81,13 @@ vec4 pbr_light(vec2 texcoord0)
 	float spot_falloff = 1.0f;
 #endif
 	
+#if SHADOWED
+	float surface_shadow = sample_shadow(world_position);
+	float subsurface_shadow = surface_shadow;
+#else
 	float surface_shadow = 1.0f;
 	float subsurface_shadow = 1.0f;
+#endif
 	float surface_attenuation = (intensity * distance_attenuation * light_radius_mask * spot_falloff) * surface_shadow;
 	float subsurface_attenuation = (distance_attenuation * light_radius_mask * spot_falloff) * subsurface_shadow;
 	
@@ -0,0 +1,41 @@
+$input a_position, a_normal, a_tangent, a_bitangent, a_texcoord0, i_data0, i_data1, i_data2, i_data3
+$output v_wpos, v_pos, v_wnormal, v_wtangent, v_wbitangent, v_texcoord0
+
+#include "common.sh"
+
+void main()
+{
+	mat4 model;
+	model[0] = i_data0;
+	model[1] = i_data1;
+	model[2] = i_data2;
+	model[3] = i_data3;
+
+	vec3 wpos = instMul(model, vec4(a_position, 1.0)).xyz;
+	gl_Position = mul(u_viewProj, vec4(wpos, 1.0) );
+
+	vec4 normal = a_normal * 2.0 - 1.0;
+	vec4 tangent = a_tangent * 2.0 - 1.0;
+	vec4 bitangent = a_bitangent * 2.0 - 1.0;
+
+	//instanced transforms are assumed uniformly scaled; the normalize below
+	//absorbs uniform scale without a full inverse transpose per instance
+	mat3 model3;
+	model3[0] = i_data0.xyz;
+	model3[1] = i_data1.xyz;
+	model3[2] = i_data2.xyz;
+
+	vec3 wnormal = normalize(instMul(model3, normal.xyz));
+	vec3 wtangent = normalize(instMul(model3, tangent.xyz));
+	vec3 wbitangent = normalize(instMul(model3, bitangent.xyz));
+
+	v_wpos = wpos;
+	v_pos = gl_Position.xyz/gl_Position.w;
+
+	v_wnormal   = wnormal;
+	v_wtangent   = wtangent;
+	v_wbitangent = wbitangent;
+
+	v_texcoord0 = a_texcoord0;
+
+}